@@ -7,19 +7,22 @@
 #include "ConexionWifi.h" // Para configWiFi
 #include "Configuracion.h"// Para los parámetros de configuración
 #include "TelegramServicio.h" // Para telegramBot
+#include "Arbitro.h"       // Para Arbitro
+#include "Reloj.h"         // Para Reloj::HoraLocal
 
 
     /**
      * @brief Ejecuta una secuencia específica de campanadas identificada por su ID
      * 
      * @details Función principal para ejecutar secuencias programadas de campanadas.
-     *          Verifica automáticamente si el campanario está ocupado antes de
-     *          proceder con la ejecución para evitar interferencias entre secuencias.
+     *          Presenta la secuencia al árbitro con prioridad de alarma: suena si
+     *          el campanario está libre, interrumpe un toque de reloj o espera en
+     *          la cola hasta su plazo si suena algo de igual o mayor prioridad.
      *          
-     *          **VERIFICACIONES REALIZADAS:**
-     *          - Estado del campanario (ocupado/libre)
+     *          **VERIFICACIONES REALIZADAS (en el árbitro):**
+     *          - Estado y prioridad del toque en curso
      *          - Validez del ID de secuencia
-     *          - Disponibilidad del sistema de campanadas
+     *          - Plazo de espera Config::Arbitro::PLAZO_ALARMA_MS
      *          
      *          **SECUENCIAS TÍPICAS:**
      *          - ID 1: Secuencia de Difuntos
@@ -28,15 +31,15 @@
      * 
      * @param seqId Identificador único de la secuencia a ejecutar (1-255)
      * 
-     * @note **VERIFICACIÓN AUTOMÁTICA:** Comprueba campanario ocupado antes de ejecutar
-     * @note **NO BLOQUEANTE:** Retorna inmediatamente si campanario ocupado
+     * @note **ARBITRADA:** Nunca se pierde en silencio; la decisión queda en el registro del árbitro
+     * @note **NO BLOQUEANTE:** Retorna inmediatamente tras presentar la petición
      * @note **INTEGRACIÓN:** Compatible con sistema de alarmas como función callback
      * 
      * @warning **ID VÁLIDO:** Verificar que seqId corresponde a secuencia existente
      * @warning **CAMPANARIO:** Requiere objeto Campanario inicializado globalmente
      * 
-     * @see EjecutaSecuencia() - Función subyacente que ejecuta la secuencia
-     * @see Campanario.GetEstadoSecuencia() - Verificación de estado utilizada
+     * @see ARBITRO::Solicita() - Petición al árbitro de toques
+     * @see EjecutaSecuencia() - Función que ejecuta la secuencia aceptada
      * 
      * @example
      * @code
@@ -52,14 +55,8 @@
      */
     void accionSecuencia(uint16_t seqId) 
     {
-        if (Campanario.GetEstadoSecuencia()) {
-            DBG_ACCIONES_PRINTF("Secuencia %u bloqueada - campanario ocupado", seqId);
-            return;                                                                     // Salir sin ejecutar
-        }
-        EjecutaSecuencia(seqId, Config::Telegram::METODO_ACTIVACION_ALARMA_PROGRAMADA); // Ejecutar secuencia con método de activación alarma
-       
-        DBG_ACCIONES_PRINTF("Secuencia %u ejecutada", seqId);
-
+        Arbitro.Solicita(TOQUE_SECUENCIA, PRIO_ALARMA, seqId, Config::Telegram::METODO_ACTIVACION_ALARMA_PROGRAMADA);  // El árbitro decide si suena, espera o interrumpe
+        DBG_ACCIONES_PRINTF("Secuencia %u solicitada", seqId);
     }
 
     /**
@@ -72,7 +69,7 @@
      *          **FUNCIONALIDADES:**
      *          - Conversión automática 24h → 12h (15:00 = 3 campanadas)
      *          - Protección horario nocturno configurable
-     *          - Verificación de campanario ocupado
+     *          - Petición al árbitro con prioridad de reloj (espera o es interrumpida)
      *          - Notificación web automática tras ejecución
      *          - Actualización DNS automática si hay internet
      *          
@@ -88,7 +85,7 @@
      * @warning **RTC REQUERIDO:** Necesita RTC sincronizado para obtener hora actual
      * @warning **CAMPANARIO:** Requiere campanario inicializado y con campanas añadidas
      * 
-     * @see Campanario.TocaHoraSinCuartos() - Función subyacente utilizada
+     * @see ejecutaToqueHora() - Toque que lanza el árbitro
      * @see Config::Time::NOCHE_INICIO_HORA - Configuración horario nocturno
      * 
      * @example
@@ -102,12 +99,8 @@
      */
     void accionTocaHora(void) {
         // Obtener tiempo actual
-        if (Campanario.GetEstadoSecuencia()) {
-            DBG_ACCIONES("Toque de hora bloqueado - campanario ocupado");
-            return;
-        }
         struct tm timeinfo;
-        if (!getLocalTime(&timeinfo)) return;
+        if (!Reloj::HoraLocal(&timeinfo)) return;
 
         // Verificar horario nocturno
         int hora = timeinfo.tm_hour;
@@ -115,23 +108,44 @@
                            hora < Config::Time::NOCHE_FIN_HORA);
         
         if (!esNocturno) {
-            Campanario.TocaHoraSinCuartos(hora);
-            DBG_ACCIONES_PRINTF("Toque de hora ejecutado a las %02d:00", hora);
-            ws.textAll("REDIRECT:/Campanas.html");
-
-            // ✅ NOTIFICACIÓN TELEGRAM toque de hora
-            if (telegramBot.isEnabled() && Config::Telegram::NOTIFICACION_HORA) {
-                telegramBot.sendHoraNotification( String(hora % 12 == 0 ? 12 : hora % 12));
-            }
-
-            // Actualizar DNS si hay internet
-            if (hayInternet()) {
-                ActualizaDNSSiNecesario();
-            }
+            Arbitro.Solicita(TOQUE_HORA, PRIO_RELOJ, (uint16_t)hora, Config::Telegram::METODO_ACTIVACION_ALARMA_PROGRAMADA);
+            DBG_ACCIONES_PRINTF("Toque de hora solicitado a las %02d:00", hora);
         }else{
             DBG_ACCIONES_PRINTF("No se ha ejecutado el toque de hora a las %02d:00 por horario nocturno", hora);
         }
     }
+
+    /**
+     * @brief Toca ya las campanadas de una hora aceptada por el árbitro
+     * 
+     * @details Ejecuta el toque de hora con la hora de la petición, no con la
+     *          del reloj: si la petición esperó en la cola, suena la hora que
+     *          se pidió. Después notifica a la web y a Telegram y actualiza el DNS.
+     * 
+     * @param hora Hora 0-23 de la petición
+     * 
+     * @warning **ÁRBITRO:** Solo la llama ARBITRO desde loop()
+     * 
+     * @see accionTocaHora() - Presenta la petición al árbitro
+     * 
+     * @since v1.7
+     * @author Julian Salas Bartolomé
+     */
+    void ejecutaToqueHora(int hora) {
+        Campanario.TocaHoraSinCuartos(hora);
+        DBG_ACCIONES_PRINTF("Toque de hora ejecutado a las %02d:00", hora);
+        ws.textAll("REDIRECT:/Campanas.html");
+
+        // ✅ NOTIFICACIÓN TELEGRAM toque de hora
+        if (telegramBot.isEnabled() && Config::Telegram::NOTIFICACION_HORA) {
+            telegramBot.sendHoraNotification( String(hora % 12 == 0 ? 12 : hora % 12));
+        }
+
+        // Actualizar DNS si hay internet
+        if (hayInternet()) {
+            ActualizaDNSSiNecesario();
+        }
+    }
     /**
      * @brief Toca la campanada de media hora (:30)
      * 
@@ -142,14 +156,14 @@
      *          **CARACTERÍSTICAS:**
      *          - Una sola campanada a los 30 minutos
      *          - Misma protección nocturna que toque de hora
-     *          - Verificación de campanario ocupado
+     *          - Petición al árbitro con prioridad de reloj
      *          - Notificación web y DNS automáticas
      * 
      * @note **CAMPANADA ÚNICA:** Solo una campanada, no secuencia completa
      * @note **PROTECCIÓN:** Mismas verificaciones que accionTocaHora()
      * @note **CAMPANA:** Utiliza campana de cuartos si está disponible
      * 
-     * @see Campanario.TocaMediaHora() - Función subyacente utilizada
+     * @see ejecutaToqueMedia() - Toque que lanza el árbitro
      * @see accionTocaHora() - Función hermana para toques de hora completa
      * 
      * @example
@@ -162,13 +176,9 @@
      * @author Julian Salas Bartolomé
      */
     void accionTocaMedia(void) {
-            if (Campanario.GetEstadoSecuencia()) {
-                DBG_ACCIONES("Toque de media bloqueado - campanario ocupado");
-            return;
-        }
         // Obtener tiempo actual
         struct tm timeinfo;
-        if (!getLocalTime(&timeinfo)) return;
+        if (!Reloj::HoraLocal(&timeinfo)) return;
 
         // Verificar horario nocturno
         int hora = timeinfo.tm_hour;
@@ -176,18 +186,35 @@
                            hora < Config::Time::NOCHE_FIN_HORA);
         
         if (!esNocturno) {
-            Campanario.TocaMediaHora();
-            DBG_ACCIONES_PRINTF("Toque de media ejecutado a las %02d:30", hora);
-            ws.textAll("REDIRECT:/Campanas.html");
+            Arbitro.Solicita(TOQUE_MEDIA, PRIO_RELOJ, (uint16_t)hora, Config::Telegram::METODO_ACTIVACION_ALARMA_PROGRAMADA);
+            DBG_ACCIONES_PRINTF("Toque de media solicitado a las %02d:30", hora);
+        }
+    }
 
-            // ✅ NOTIFICACIÓN TELEGRAM toque de media hora
-            if (telegramBot.isEnabled() && Config::Telegram::NOTIFICACION_MEDIAHORA) {
-                telegramBot.sendMediaHoraNotification( String(hora) + ":30");
-            }
+    /**
+     * @brief Toca ya la media hora aceptada por el árbitro
+     * 
+     * @param hora Hora 0-23 de la petición
+     * 
+     * @warning **ÁRBITRO:** Solo la llama ARBITRO desde loop()
+     * 
+     * @see accionTocaMedia() - Presenta la petición al árbitro
+     * 
+     * @since v1.7
+     * @author Julian Salas Bartolomé
+     */
+    void ejecutaToqueMedia(int hora) {
+        Campanario.TocaMediaHora();
+        DBG_ACCIONES_PRINTF("Toque de media ejecutado a las %02d:30", hora);
+        ws.textAll("REDIRECT:/Campanas.html");
 
-            if (hayInternet()) {
-                ActualizaDNSSiNecesario();
-            }
+        // ✅ NOTIFICACIÓN TELEGRAM toque de media hora
+        if (telegramBot.isEnabled() && Config::Telegram::NOTIFICACION_MEDIAHORA) {
+            telegramBot.sendMediaHoraNotification( String(hora) + ":30");
+        }
+
+        if (hayInternet()) {
+            ActualizaDNSSiNecesario();
         }
     }
 
@@ -327,3 +354,46 @@
         }
     }
 
+    /**
+     * @brief Callback y parámetro que corresponden a un tipo de acción web
+     * 
+     * @details Traducción única del campo "accion" de las alarmas y excepciones
+     *          web, usada al crearlas desde Servidor.cpp y al restaurar sus
+     *          callbacks tras cargarlas de SPIFFS.
+     *          
+     *          **TIPOS:**
+     *          - "MISA", "DIFUNTOS", "FIESTA": accionSecuencia con su estado I2C
+     *          - "CALEFACCION": accionEnciendeCalefaccion con la duración
+     *          - Nombre de una secuencia de la biblioteca: accionSecuencia con su ID
+     * 
+     * @param tipo Tipo de acción ("MISA", "CALEFACCION", ...)
+     * @param duracion Minutos de calefacción (solo "CALEFACCION")
+     * @param callback Recibe la función a ejecutar
+     * @param parametro Recibe su parámetro
+     * @return false si el tipo no existe (callback y parámetro no se tocan)
+     * 
+     * @since v2.2
+     * @author Julian Salas Bartolomé
+     */
+    bool ResuelveAccionAlarma(const char* tipo, uint16_t duracion, void (*&callback)(uint16_t), uint16_t& parametro) {
+        if (strcmp(tipo, "MISA") == 0) {
+            callback = accionSecuencia;
+            parametro = Config::States::I2CState::MISA;
+        } else if (strcmp(tipo, "DIFUNTOS") == 0) {
+            callback = accionSecuencia;
+            parametro = Config::States::I2CState::DIFUNTOS;
+        } else if (strcmp(tipo, "FIESTA") == 0) {
+            callback = accionSecuencia;
+            parametro = Config::States::I2CState::FIESTA;
+        } else if (strcmp(tipo, "CALEFACCION") == 0) {
+            callback = accionEnciendeCalefaccion;
+            parametro = duracion;
+        } else if (Campanario.BuscaSecuencia(CAMPANARIO::IdSecuencia(tipo)) >= 0) {
+            callback = accionSecuencia;
+            parametro = CAMPANARIO::IdSecuencia(tipo);                          // Secuencia de la biblioteca por ID
+        } else {
+            return false;
+        }
+        return true;
+    }
+
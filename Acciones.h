@@ -9,7 +9,7 @@
  *          verificaciones inteligentes de estado y condiciones.
  *          
  *          **TIPOS DE ACCIONES DEFINIDAS:**
- *          - Secuencias de campanadas (con verificación de campanario ocupado)
+ *          - Secuencias de campanadas (presentadas al árbitro de prioridades)
  *          - Toques de hora y media hora (con protección horario nocturno)
  *          - Mantenimiento del sistema (sincronización NTP, DNS)
  *          - Acciones que siempre se ejecutan (sin verificaciones de campanario)
@@ -59,6 +59,12 @@
     void accionTocaHora(void);                                                          // Ejecuta toque de hora
     void accionTocaMedia(void);                                                         // Ejecuta toque de media hora
     void accionEnciendeCalefaccion(uint16_t minutos);                                   // Enciende calefacción por X minutos
+    bool ResuelveAccionAlarma(const char* tipo, uint16_t duracion,
+                              void (*&callback)(uint16_t), uint16_t& parametro);        // Callback y parámetro de un tipo de acción web
+
+    // Toques de reloj aceptados por el árbitro
+    void ejecutaToqueHora(int hora);                                                    // Toca ya la hora pedida
+    void ejecutaToqueMedia(int hora);                                                   // Toca ya la media hora pedida
 
 
     void SincronizaNTP( void );                                                        // Sincroniza reloj con servidor NTP    
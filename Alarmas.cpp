@@ -1,4 +1,52 @@
 #include "Alarmas.h"
+#include "Reloj.h"
+#include "HoraLocal.h"
+#include <esp_rom_crc.h>
+#include <algorithm>
+#include <type_traits>
+
+// Instantánea binaria de las alarmas personalizables, leída en cada arranque (ver _guardaInstantanea)
+static const char* const ARCHIVO_INSTANTANEA     = "/alarmas.bin";
+static const char* const ARCHIVO_INSTANTANEA_TMP = "/alarmas.bin.tmp";
+static constexpr uint32_t MARCA_INSTANTANEA   = 0x4E424C41;                 // "ALBN"
+static constexpr uint16_t VERSION_INSTANTANEA = 1;
+static constexpr size_t   MAX_TEXTOS_ALARMA   = ALARMA_TAM_NOMBRE + ALARMA_TAM_DESCRIPCION + ALARMA_TAM_TIPO + CRON_MAX_TEXTO;
+
+static_assert(std::is_trivially_copyable<Alarm>::value, "La instantánea copia Alarm byte a byte");
+
+struct CabeceraInstantanea {
+    uint32_t nMarca       = MARCA_INSTANTANEA;
+    uint16_t nVersion     = VERSION_INSTANTANEA;
+    uint16_t nTamAlarma   = sizeof(Alarm);                                  // Otro firmware con otro Alarm invalida el archivo
+    uint16_t nAlarmas     = 0;
+    uint16_t reservado    = 0;
+    uint32_t nBytesTextos = 0;                                              // Bloques "nombre\0descripcion\0tipo\0cron\0" seguidos
+    uint32_t nCrc         = 0;                                              // CRC32 de las alarmas y los textos
+};
+
+// Cambios web posteriores a la última instantánea, una línea JSON por cambio (ver guardarPendientes)
+static const char* const ARCHIVO_CAMBIOS = "/alarmas_cambios.log";
+
+// Estado para recuperar disparos perdidos (ver _guardaEstado)
+static const char* const ARCHIVO_ESTADO = "/alarmas_estado.bin";
+static constexpr uint32_t MARCA_ESTADO   = 0x54534C41;                      // "ALST"
+static constexpr uint16_t VERSION_ESTADO = 1;
+
+struct CabeceraEstado {
+    uint32_t nMarca    = MARCA_ESTADO;
+    uint16_t nVersion  = VERSION_ESTADO;
+    uint16_t nEntradas = 0;
+    int64_t  tRevision = 0;                                                 // Epoch del último check() guardado
+};
+
+struct EntradaEstado {
+    int32_t  idWeb = -1;
+    int32_t  reservado = 0;
+    int64_t  ultimaEjecucion = 0;
+};
+
+// Excepciones por fecha (ver _guardaExcepciones)
+static const char* const ARCHIVO_EXCEPCIONES = "/alarmas_excepciones.json";
 
 
 
@@ -14,10 +62,14 @@
  *          de alarmas predeterminadas para el funcionamiento básico del campanario.
  *          
  *          **PROCESO DE INICIALIZACIÓN:**
- *          1. Llama a clear() para limpiar alarmas existentes
- *          2. Si cargarPorDefecto == true: ejecuta initDefaults()
- *          3. Inicializa variables internas del sistema
- *          4. Prepara estructuras para verificación temporal
+ *          1. Escribe los cambios web pendientes (se llama también al reconectar)
+ *          2. Llama a clear() para limpiar alarmas existentes
+ *          3. Lee la instantánea binaria /alarmas.bin; si no existe, no es
+ *             válida o se ha pedido una importación, lee el JSON
+ *          4. Aplica /alarmas_cambios.log y, si se leyó el JSON, escribe la
+ *             instantánea para el próximo arranque
+ *          5. Si cargarPorDefecto == true: ejecuta initDefaults()
+ *          6. Inicializa variables internas del sistema
  * 
  * @param cargarPorDefecto Si true, carga alarmas predeterminadas del sistema
  * @return true siempre (inicialización exitosa garantizada)
@@ -25,6 +77,7 @@
  * @note **ALARMAS POR DEFECTO:** Incluyen misas dominicales, toques de horas y sincronización
  * @note **LLAMADA ÚNICA:** Debe llamarse una sola vez durante el arranque del sistema
  * @note **ORDEN:** Llamar después de inicializar RTC pero antes del loop principal
+ * @note **TIEMPO:** La duración de la carga queda en obtenerEstadisticasJSON() ("arranque")
  * 
  * @see clear() - Función que limpia las alarmas existentes
  * @see initDefaults() - Función que carga configuración predeterminada
@@ -43,11 +96,44 @@
  * @author Julian Salas Bartolomé
  */
 bool AlarmScheduler::begin(bool cargarPorDefecto) {
+    bool lImportar = _lImportarJSON;
+    _lImportarJSON = false;
+    if (lImportar) {
+        _nCambios = 0;                                                      // Lo anotado se refiere a las alarmas que se sustituyen
+        _lCompactar = false;
+    } else {
+        _vuelcaCambios();                                                   // Sin esperar al retardo: clear() los perdería
+    }
     clear();
     
-    // ✅ CARGAR ALARMAS PERSONALIZABLES DESDE JSON ANTES DE LAS POR DEFECTO
+    // ✅ CARGAR ALARMAS PERSONALIZABLES ANTES DE LAS POR DEFECTO
     DBG_ALM("[ALARM] Cargando alarmas personalizables desde SPIFFS...");
-    cargarPersonalizablesDesdeJSON();
+    uint32_t nInicioUs = micros();
+    _lCargaBinaria = !lImportar &&
+                     (_cargaInstantanea(ARCHIVO_INSTANTANEA) || _cargaInstantanea(ARCHIVO_INSTANTANEA_TMP));
+    bool lCargado = _lCargaBinaria;
+    if (!_lCargaBinaria) {
+        lCargado = cargarPersonalizablesDesdeJSON();                        // Primer arranque tras actualizar, instantánea dañada o importación
+    }
+    if (!lCargado && lImportar) {
+        DBG_ALM("⚠️ JSON subido no válido, se mantienen las alarmas anteriores");
+        lImportar = false;
+        clear();
+        _lCargaBinaria = _cargaInstantanea(ARCHIVO_INSTANTANEA) || _cargaInstantanea(ARCHIVO_INSTANTANEA_TMP);
+        lCargado = _lCargaBinaria;
+    }
+    if (!lImportar) {
+        _aplicaRegistroCambios();                                           // Cambios posteriores a la última instantánea
+    }
+    _invalidaIndice();
+    _nUsCarga = micros() - nInicioUs;
+    DBG_ALM_PRINTF("[ALARM] %u alarmas personalizables cargadas desde %s en %lu us",
+                   _num, _lCargaBinaria ? "instantánea" : "JSON", (unsigned long)_nUsCarga);
+    if (!_lCargaBinaria && lCargado) {
+        _guardaInstantanea();                                               // El próximo arranque ya lee el binario
+    }
+    _cargaEstado();                                                         // Última revisión y ejecuciones de antes del reinicio
+    _cargaExcepciones();                                                    // Después de las alarmas: descarta las huérfanas
     
     // ✅ SOLO CARGAR POR DEFECTO SI NO HAY NINGUNA ALARMA
     if (cargarPorDefecto && _num == 0) {
@@ -85,7 +171,7 @@ bool AlarmScheduler::begin(bool cargarPorDefecto) {
  * @note **ACCESO PRIVADO:** El método puede acceder a miembros privados de la clase
  * @note **CONTEXTO:** Se ejecuta en el contexto del objeto AlarmScheduler
  * 
- * @warning **LÍMITE:** Máximo 16 alarmas simultáneas (MAX_ALARMAS)
+ * @warning **LÍMITE:** Máximo MAX_ALARMAS (128) alarmas simultáneas
  * @warning **PUNTERO VÁLIDO:** Verificar que el método existe y es accesible
  * 
  * @see addExternal() - Para funciones externas con parámetro
@@ -94,19 +180,19 @@ bool AlarmScheduler::begin(bool cargarPorDefecto) {
  * @example
  * @code
  * // Añadir alarma que ejecuta método interno cada día a las 12:00
- * uint8_t idx = add(DOW_TODOS, 12, 0, 0, &AlarmScheduler::metodoInterno, 123);
+ * uint16_t idx = add(DOW_TODOS, 12, 0, 0, &AlarmScheduler::metodoInterno, 123);
  * @endcode
  * 
  * @since v1.0
  * @author Julian Salas Bartolomé
  */
-uint8_t AlarmScheduler::add(uint8_t mascaraDias,
-                            uint8_t hora,
-                            uint8_t minuto,
-                            uint16_t intervaloMin,
-                            void (AlarmScheduler::*accion)(uint16_t),
-                            uint16_t parametro,
-                            bool habilitada)
+uint16_t AlarmScheduler::add(uint8_t mascaraDias,
+                             uint8_t hora,
+                             uint8_t minuto,
+                             uint16_t intervaloMin,
+                             void (AlarmScheduler::*accion)(uint16_t),
+                             uint16_t parametro,
+                             bool habilitada)
 {
     if (_num >= MAX_ALARMAS) {
         DBG_ALM_PRINTF("[ALARM] Error: Máximo de alarmas alcanzado (%u)\n", MAX_ALARMAS);
@@ -114,13 +200,14 @@ uint8_t AlarmScheduler::add(uint8_t mascaraDias,
     }
     
     Alarm &oAlarma = _alarmas[_num];
+    oAlarma = Alarm();                                                                                      // El hueco puede conservar una personalizable anterior a clear()
     oAlarma.habilitada        = habilitada;
     oAlarma.mascaraDias       = (mascaraDias ? mascaraDias : DOW_TODOS);
     oAlarma.hora              = hora;
     oAlarma.minuto            = minuto;
     oAlarma.intervaloMin      = intervaloMin;
-    oAlarma.ultimoDiaAno      = -1;
-    oAlarma.ultimoMinuto      = 255;
+    oAlarma.esCron            = false;
+    oAlarma.fiesta            = FIESTA_NINGUNA;
     oAlarma.ultimaEjecucion   = 0;
     oAlarma.accion            = accion;
     oAlarma.accionExt         = nullptr;
@@ -130,6 +217,7 @@ uint8_t AlarmScheduler::add(uint8_t mascaraDias,
     DBG_ALM_PRINTF("[ALARM] Añadida alarma método idx=%u, dias=0x%02X, %02u:%02u, intervalo=%u min, param=%u\n",
                    _num, mascaraDias, hora, minuto, intervaloMin, parametro);
     
+    _marcaPendiente(_num);                                                                                  // Entra en el índice en el próximo check()
     return _num++;
 }
 
@@ -164,19 +252,19 @@ uint8_t AlarmScheduler::add(uint8_t mascaraDias,
  * @example
  * @code
  * // Añadir alarma que ejecuta secuencia de misa los domingos
- * uint8_t idx = addExternal(DOW_DOMINGO, 11, 30, 0, accionSecuencia, Config::States::MISA);
+ * uint16_t idx = addExternal(DOW_DOMINGO, 11, 30, 0, accionSecuencia, Config::States::MISA);
  * @endcode
  * 
  * @since v1.0
  * @author Julian Salas Bartolomé
  */
-uint8_t AlarmScheduler::addExternal(uint8_t mascaraDias,
-                                    uint8_t hora,
-                                    uint8_t minuto,
-                                    uint16_t intervaloMin,
-                                    void (*ext)(uint16_t),
-                                    uint16_t parametro,
-                                    bool habilitada)
+uint16_t AlarmScheduler::addExternal(uint8_t mascaraDias,
+                                     uint8_t hora,
+                                     uint8_t minuto,
+                                     uint16_t intervaloMin,
+                                     void (*ext)(uint16_t),
+                                     uint16_t parametro,
+                                     bool habilitada)
 {
     if (_num >= MAX_ALARMAS) {
         DBG_ALM_PRINTF("[ALARM] Error: Máximo de alarmas alcanzado (%u)\n", MAX_ALARMAS);
@@ -184,13 +272,14 @@ uint8_t AlarmScheduler::addExternal(uint8_t mascaraDias,
     }
     
     Alarm &oAlarma = _alarmas[_num];
+    oAlarma = Alarm();                                                                                      // El hueco puede conservar una personalizable anterior a clear()
     oAlarma.habilitada        = habilitada;
     oAlarma.mascaraDias       = (mascaraDias ? mascaraDias : DOW_TODOS);
     oAlarma.hora              = hora;
     oAlarma.minuto            = minuto;
     oAlarma.intervaloMin      = intervaloMin;
-    oAlarma.ultimoDiaAno      = -1;
-    oAlarma.ultimoMinuto      = 255;
+    oAlarma.esCron            = false;
+    oAlarma.fiesta            = FIESTA_NINGUNA;
     oAlarma.ultimaEjecucion   = 0;
     oAlarma.accion            = nullptr;
     oAlarma.accionExt         = ext;
@@ -200,6 +289,7 @@ uint8_t AlarmScheduler::addExternal(uint8_t mascaraDias,
     DBG_ALM_PRINTF("[ALARM] Añadida alarma externa idx=%u, dias=0x%02X, %02u:%02u, intervalo=%u min, param=%u\n",
                    _num, mascaraDias, hora, minuto, intervaloMin, parametro);
     
+    _marcaPendiente(_num);                                                                                  // Entra en el índice en el próximo check()
     return _num++;
 }
 
@@ -234,21 +324,21 @@ uint8_t AlarmScheduler::addExternal(uint8_t mascaraDias,
  * @example
  * @code
  * // Sincronización NTP diaria al mediodía
- * uint8_t idx = addExternal0(DOW_TODOS, 12, 0, 0, SincronizaNTP);
+ * uint16_t idx = addExternal0(DOW_TODOS, 12, 0, 0, SincronizaNTP);
  * 
  * // Tocar horas en punto (wildcard para todas las horas)
- * uint8_t idx2 = addExternal0(DOW_TODOS, ALARMA_WILDCARD, 0, 0, accionTocaHora);
+ * uint16_t idx2 = addExternal0(DOW_TODOS, ALARMA_WILDCARD, 0, 0, accionTocaHora);
  * @endcode
  * 
  * @since v2.0
  * @author Julian Salas Bartolomé
  */
-uint8_t AlarmScheduler::addExternal0(uint8_t mascaraDias,
-                                     uint8_t hora,
-                                     uint8_t minuto,
-                                     uint16_t intervaloMin,
-                                     void (*ext0)(),
-                                     bool habilitada)
+uint16_t AlarmScheduler::addExternal0(uint8_t mascaraDias,
+                                      uint8_t hora,
+                                      uint8_t minuto,
+                                      uint16_t intervaloMin,
+                                      void (*ext0)(),
+                                      bool habilitada)
 {
     if (_num >= MAX_ALARMAS) {
         DBG_ALM_PRINTF("[ALARM] Error: Máximo de alarmas alcanzado (%u)\n", MAX_ALARMAS);
@@ -256,13 +346,14 @@ uint8_t AlarmScheduler::addExternal0(uint8_t mascaraDias,
     }
     
     Alarm &oAlarma = _alarmas[_num];
+    oAlarma = Alarm();                                                                                      // El hueco puede conservar una personalizable anterior a clear()
     oAlarma.habilitada        = habilitada;
     oAlarma.mascaraDias       = (mascaraDias ? mascaraDias : DOW_TODOS);
     oAlarma.hora              = hora;
     oAlarma.minuto            = minuto;
     oAlarma.intervaloMin      = intervaloMin;
-    oAlarma.ultimoDiaAno      = -1;
-    oAlarma.ultimoMinuto      = 255;
+    oAlarma.esCron            = false;
+    oAlarma.fiesta            = FIESTA_NINGUNA;
     oAlarma.ultimaEjecucion   = 0;
     oAlarma.accion            = nullptr;
     oAlarma.accionExt         = nullptr;
@@ -272,6 +363,7 @@ uint8_t AlarmScheduler::addExternal0(uint8_t mascaraDias,
     DBG_ALM_PRINTF("[ALARM] Añadida alarma externa0 idx=%u, dias=0x%02X, %02u:%02u, intervalo=%u min\n",
                    _num, mascaraDias, hora, minuto, intervaloMin);
     
+    _marcaPendiente(_num);                                                                                  // Entra en el índice en el próximo check()
     return _num++;
 }
 
@@ -283,22 +375,27 @@ uint8_t AlarmScheduler::addExternal0(uint8_t mascaraDias,
  *          Implementa lógica compleja de verificación temporal y prevención de duplicados.
  *          
  *          **ALGORITMO DE VERIFICACIÓN:**
- *          1. Obtiene tiempo actual del RTC via getLocalTime()
- *          2. Para cada alarma habilitada:
- *             - Verifica máscara de días de la semana
- *             - Aplica lógica de horario (fijo vs wildcard vs intervalo)
+ *          1. Camino rápido: compara Reloj::Epoch() con la raíz del índice de
+ *             próximos disparos y retorna si aún no vence nada (sin getLocalTime)
+ *          2. Obtiene tiempo actual del RTC via Reloj::HoraLocal()
+ *          3. Reconstruye el índice si hace falta, o recalcula solo las alarmas
+ *             editadas desde el último check()
+ *          4. Para cada alarma vencida de la raíz del índice:
+ *             - Las de horario solo se disparan dentro de su minuto
  *             - Previene ejecuciones duplicadas con cache temporal
- *             - Verifica que no hay secuencia activa en Campanario
- *          3. Ejecuta acción apropiada (método, función externa con/sin parámetro)
- *          4. Actualiza cache temporal para prevenir re-ejecución
+ *             - Ejecuta acción apropiada (método, función externa con/sin parámetro)
+ *             - Actualiza cache y recalcula solo el próximo disparo de esa alarma
  *          
  *          **TIPOS DE HORARIOS SOPORTADOS:**
  *          - **Fijo:** Hora y minuto específicos (ej: 12:30)
  *          - **Wildcard:** ALARMA_WILDCARD para cualquier hora/minuto
  *          - **Intervalo:** Repetición cada X minutos desde punto de anclaje
+ *          - **Cron:** Expresión de 5 campos compilada (ver CronAlarma.h)
+ *          - **Litúrgico:** Fiesta + desplazamiento en días, tabla anual (ver Calendario.h)
  *          
  *          **PREVENCIÓN DE DUPLICADOS:**
- *          - ultimoDiaAno + ultimoMinuto: Evita ejecución múltiple en mismo minuto
+ *          - ultimaEjecucion >= próximo disparo: ese instante UTC ya sonó, sin
+ *            depender de la hora local (la hora repetida de octubre no duplica)
  *          - ultimaEjecucion: Timestamp epoch para control de intervalos
  *          - Verificación de secuencia activa: No ejecuta si campanario ocupado
  * 
@@ -306,6 +403,8 @@ uint8_t AlarmScheduler::addExternal0(uint8_t mascaraDias,
  * @note **RESOLUCIÓN:** Resolución mínima de 1 minuto (verificación por minuto)
  * @note **RTC REQUERIDO:** Falla silenciosamente si getLocalTime() falla
  * @note **DEBUG PERIÓDICO:** Logging cada 5 segundos si DebugAlarma habilitado
+ * @note **HUECOS:** Tras un reinicio o más de UMBRAL_HUECO_S sin llamarse, recupera
+ *       los disparos perdidos según Alarm::recuperacion (ver _recuperaHueco())
  * 
  * @warning **RTC DEPENDENCY:** Requiere sincronización NTP previa para funcionar
  * @warning **BLOCKING PREVENTION:** No ejecuta si Campanario.GetEstadoSecuencia() == true
@@ -313,7 +412,7 @@ uint8_t AlarmScheduler::addExternal0(uint8_t mascaraDias,
  * 
  * @see getLocalTime() - Función ESP32 para obtener tiempo actual
  * @see Campanario.GetEstadoSecuencia() - Verificación de estado del sistema
- * @see ultimoDiaAno, ultimoMinuto, ultimaEjecucion - Variables de cache
+ * @see ultimaEjecucion - Cache de ejecución en epoch UTC
  * 
  * @example
  * @code
@@ -327,585 +426,1920 @@ uint8_t AlarmScheduler::addExternal0(uint8_t mascaraDias,
  * 
  * @since v1.0 - Verificación básica de horarios
  * @since v2.0 - Intervalos, wildcards y prevención avanzada de duplicados
+ * @since v2.2 - Índice de próximos disparos: coste constante mientras no vence nada
+ * @since v2.2 - Recuperación de disparos perdidos y estado persistido en /alarmas_estado.bin
+ * @since v2.2 - Disparos y duplicados en epoch UTC; cambio de hora según HoraLocal.h
  * 
  * @author Julian Salas Bartolomé
  */
 void AlarmScheduler::check() {
 
-    if (!getLocalTime(&t)) return;                                                                      // Verificar que se obtiene tiempo válido del RTC
+    time_t ahora = Reloj::Epoch();                                                                          // Tiempo actual en epoch
+    time_t tAnterior = _tUltimaRevision;
+    bool   hayHueco  = (_tRecuperarDesde != 0) ||                                                           // Reinicio o check() sin llamar (NTP perdido)
+                       (tAnterior != 0 && ahora - tAnterior > (time_t)Config::Alarmas::UMBRAL_HUECO_S);
+    if (!hayHueco && _lIndiceValido && !_hayPendientes() && ahora >= _tUltimaRevision && ahora < _tFinDia) {  // Camino rápido: índice al día, mismo día y reloj sin retrocesos
+        _tUltimaRevision = ahora;
+        if (ahora - _tEstadoGuardado >= (time_t)Config::Alarmas::PERIODO_ESTADO_S) _guardaEstado(ahora);
+        if (_nHeap == 0 || ahora < _aProximo[_aHeap[0]]) return;                                            // Nada vence todavía
+    }
+
+    if (!Reloj::HoraLocal(&t)) return;                                                                      // Verificar que se obtiene tiempo válido del RTC
     
-    uint8_t horaActual        = t.tm_hour;                                                              // Hora actual (0-23)
-    uint8_t minutoActual      = t.tm_min;                                                                // Minuto actual (0-59)
-    uint8_t mascaraDiaActual  = mascaraDesdeDiaSemana(t.tm_wday);                                       // Máscara de día actual
-    int     diaAnoActual      = t.tm_yday;                                                              // Día del año actual
-    time_t  ahora             = time(nullptr);                                                          // Tiempo actual en epoch
+    time_t  inicioMinuto      = ahora - (ahora % 60);                                                   // Comienzo del minuto actual
 
     #ifdef DEBUGALARMAS
         static uint32_t lastDbg = 0;
         if (millis() - lastDbg > 5000) {
-            DBG_ALM_PRINTF("AlarmScheduler::check -> %02u:%02u DOW=%d YDay=%d, Alarmas=%u\n",
-                      horaActual, minutoActual, t.tm_wday, diaAnoActual, this->_num);
+            DBG_ALM_PRINTF("AlarmScheduler::check -> %02u:%02u DOW=%d YDay=%d, Alarmas=%u, Proxima en %ld s\n",
+                      t.tm_hour, t.tm_min, t.tm_wday, t.tm_yday, this->_num, (long)segundosHastaProximo());
             lastDbg = millis();
         }
     #endif
 
-    for (uint8_t i = 0; i < _num; ++i) {                                                                    // Iterar sobre todas las alarmas registradas
-        Alarm &oAlarma = _alarmas[i];                                                                       // Referencia a la alarma actual                     
-        if (!oAlarma.habilitada) continue;                                                                  // Saltar si la alarma está deshabilitada          
-        if (!(oAlarma.mascaraDias & mascaraDiaActual)) continue;                                            // Saltar si el día actual no está en la máscara
-
-        bool disparar = false;                                                                              // Flag para indicar si se debe disparar la alarma             
-
-        // Lógica para alarmas de intervalo 
-        if (oAlarma.intervaloMin > 0) {                                                                     // Si es una alarma de intervalo            
-            if (oAlarma.ultimaEjecucion == 0) {                                                             // Primera ejecución: verificar ancla de hora/minuto
-                bool anclaOk = true;                                                                        // Asumir ancla válida 
-                if (oAlarma.hora   != ALARMA_WILDCARD && oAlarma.hora   != horaActual)   anclaOk = false;   // Verificar hora
-                if (oAlarma.minuto != ALARMA_WILDCARD && oAlarma.minuto != minutoActual) anclaOk = false;   // Verificar minuto
-                if (anclaOk) disparar = true;                                                               // Si ancla válida, disparar alarma    
-            } else if ((ahora - oAlarma.ultimaEjecucion) >= (time_t)(oAlarma.intervaloMin * 60)) {          // Ejecuciones posteriores: verificar intervalo transcurrido
-                disparar = true;
+    if (hayHueco) {                                                                                         // Disparos perdidos según la política de cada alarma
+        time_t tDesde = (_tRecuperarDesde != 0) ? _tRecuperarDesde : tAnterior;
+        _tRecuperarDesde = 0;
+        if (tDesde < inicioMinuto) _recuperaHueco(tDesde, inicioMinuto);
+        _invalidaIndice();                                                                                  // Lo que quedaba en el índice es del hueco
+    }
+
+    if (_lIndiceValido && ahora >= _tFinDia) {                                                              // Medianoche: excepciones del nuevo día
+        _preparaDia(ahora);
+        for (uint8_t p = 0; p < PALABRAS_PENDIENTES; ++p) {
+            uint32_t nHoy = _aExcepcionHoy[p];
+            while (nHoy) {
+                _marcaPendiente(p * 32 + __builtin_ctz(nHoy));
+                nHoy &= nHoy - 1;
             }
-        } 
-        // Lógica para alarmas de horario fijo/wildcard
-        else {
-            bool coincideHora = (oAlarma.hora == ALARMA_WILDCARD || oAlarma.hora == horaActual);
-            bool coincideMinuto = (oAlarma.minuto == ALARMA_WILDCARD || oAlarma.minuto == minutoActual);
-
-           if (coincideHora && coincideMinuto) {               
-                bool yaEjecutadaEstaHora = false;
-                
-                if (oAlarma.hora == ALARMA_WILDCARD) {
-                     yaEjecutadaEstaHora = (oAlarma.ultimoDiaAno == diaAnoActual && 
-                                          oAlarma.ultimoMinuto == minutoActual &&
-                                          oAlarma.ultimaHora == horaActual);  // ← NUEVA VARIABLE NECESARIA
-                } else {
-                    yaEjecutadaEstaHora = (oAlarma.ultimoDiaAno == diaAnoActual && 
-                                          oAlarma.ultimoMinuto == minutoActual);
-                }
-                
-                if (!yaEjecutadaEstaHora) {
-                    disparar = true;
-                }
-            }        
         }
+    }
 
-        if (!disparar) continue;
-        
- 
-        // Ejecutar acción apropiada según tipo
-        if (oAlarma.accion) {
-            (this->*oAlarma.accion)(oAlarma.parametro);
-            DBG_ALM_PRINTF("[ALARM] idx=%u ejecutada - método miembro, param=%u\n", i, oAlarma.parametro);
-        } else if (oAlarma.accionExt) {
-            oAlarma.accionExt(oAlarma.parametro);
-            DBG_ALM_PRINTF("[ALARM] idx=%u ejecutada - función externa, param=%u\n", i, oAlarma.parametro);
-        } else if (oAlarma.accionExt0) {
-            oAlarma.accionExt0();
-            DBG_ALM_PRINTF("[ALARM] idx=%u ejecutada - función externa sin parámetros\n", i);
+    if (!_lIndiceValido || ahora < _tUltimaRevision) {                                                      // Primera vez, cambio estructural o reloj atrasado
+        _reconstruyeIndice(inicioMinuto);
+    } else if (_hayPendientes()) {                                                                          // Solo las alarmas editadas
+        for (uint8_t p = 0; p < PALABRAS_PENDIENTES; ++p) {
+            uint32_t nPendientes = _aPendientes[p];
+            _aPendientes[p] = 0;
+            while (nPendientes) {
+                uint16_t i = p * 32 + __builtin_ctz(nPendientes);
+                nPendientes &= nPendientes - 1;
+                if (i < _num) _actualizaIndice(i, inicioMinuto);
+            }
         }
+    }
+    _tUltimaRevision = ahora;
+
+    while (_nHeap > 0 && _aProximo[_aHeap[0]] <= ahora) {                                                  // Alarmas vencidas, de la más antigua a la más reciente
+        uint16_t i = _aHeap[0];
+        Alarm &oAlarma = _alarmas[i];                                                                       // Referencia a la alarma actual                     
+
+        bool disparar;
+        if (oAlarma.intervaloMin > 0 && oAlarma.ultimaEjecucion != 0) {                                     // Intervalo en curso: se dispara aunque llegue tarde
+            disparar = true;
+        } else {
+            disparar = (_aProximo[i] >= inicioMinuto);                                                      // Horario: solo dentro de su minuto
+            if (oAlarma.ultimaEjecucion >= _aProximo[i]) disparar = false;                                  // Ese instante UTC ya sonó (p.ej. tras atrasar el reloj)
+        }
+
+        if (disparar) {
+            if (_excepcionHoy(i)) {                                                                         // Un bit: la tabla solo se consulta si hay excepción
+                _ejecutaExcepcion(i, _fechaHoy);
+            } else {
+                _ejecutaAccion(i);
+            }
 
-        // Actualizar cache para prevenir re-ejecución
-        oAlarma.ultimoDiaAno     = diaAnoActual;
-        oAlarma.ultimoMinuto     = minutoActual;
-        oAlarma.ultimaHora       = horaActual;
-        oAlarma.ultimaEjecucion  = ahora;
+            oAlarma.ultimaEjecucion  = ahora;                                                               // Evita repetir este disparo
+            if (oAlarma.recuperacion != RECUP_OMITIR) _lEstadoSucio = true;                                 // Su última ejecución debe sobrevivir a un corte
+        } else {
+            DBG_ALM_PRINTF("[ALARM] idx=%u no disparada (minuto ya pasado o ya ejecutada)\n", i);
+        }
+
+        _actualizaIndice(i, inicioMinuto + 60);                                                             // Solo se recalcula la alarma atendida
+    }
+
+    if (_lEstadoSucio || ahora - _tEstadoGuardado >= (time_t)Config::Alarmas::PERIODO_ESTADO_S) {
+        _guardaEstado(ahora);
     }
 }
 
 /**
- * @brief Deshabilita una alarma específica sin eliminarla del sistema
- * 
- * @details Marca una alarma como inactiva temporalmente, manteniéndola en
- *          el array pero evitando que se ejecute durante las verificaciones.
- *          Útil para desactivación temporal sin perder la configuración.
- * 
- * @param idx Índice de la alarma a deshabilitar (0-15)
+ * @brief Ejecuta la acción de una alarma según su tipo de callback
  * 
- * @note La alarma permanece en memoria con su configuración intacta
- * @note Puede ser reactivada posteriormente con enable()
- * @note Índices inválidos son ignorados silenciosamente
+ * @param idx Índice de la alarma
  * 
- * @see enable() - Para reactivar la alarma
- * @see get() - Para verificar estado de una alarma
+ * @note No toca la caché de ejecución: lo hace quien llama
  * 
- * @since v1.0
+ * @since v2.2
  * @author Julian Salas Bartolomé
  */
-void AlarmScheduler::disable(uint8_t idx) { 
-    if (idx < _num) {
-        _alarmas[idx].habilitada = false;
-        DBG_ALM_PRINTF("[ALARM] Alarma idx=%u deshabilitada\n", idx);
+void AlarmScheduler::_ejecutaAccion(uint16_t idx) {
+    Alarm &oAlarma = _alarmas[idx];
+    if (oAlarma.accion) {
+        (this->*oAlarma.accion)(oAlarma.parametro);
+        DBG_ALM_PRINTF("[ALARM] idx=%u ejecutada - método miembro, param=%u\n", idx, oAlarma.parametro);
+    } else if (oAlarma.accionExt) {
+        oAlarma.accionExt(oAlarma.parametro);
+        DBG_ALM_PRINTF("[ALARM] idx=%u ejecutada - función externa, param=%u\n", idx, oAlarma.parametro);
+    } else if (oAlarma.accionExt0) {
+        oAlarma.accionExt0();
+        DBG_ALM_PRINTF("[ALARM] idx=%u ejecutada - función externa sin parámetros\n", idx);
     }
 }
 
 /**
- * @brief Habilita una alarma específica previamente deshabilitada
- * 
- * @details Marca una alarma como activa para que sea considerada durante
- *          las verificaciones de check(). Útil para reactivar alarmas
- *          temporalmente deshabilitadas.
+ * @brief Dispara las alarmas que debían sonar durante un hueco sin check()
  * 
- * @param idx Índice de la alarma a habilitar (0-15)
+ * @details Se llama tras un reinicio (hueco desde la última revisión guardada)
+ *          o cuando check() vuelve a llamarse tras más de UMBRAL_HUECO_S, por
+ *          ejemplo al recuperar el NTP.
+ *          
+ *          **POLÍTICAS (Alarm::recuperacion):**
+ *          - RECUP_OMITIR: el disparo se pierde (toques de hora, tareas de sistema)
+ *          - RECUP_TARDE: se dispara el último si no han pasado más de margenRecuperacionMin
+ *          - RECUP_ULTIMA: se dispara el último del hueco, sea cual sea el retraso
+ *          
+ *          **COSTE:**
+ *          - Por alarma se busca solo el último disparo perdido con _ultimaOcurrencia()
+ *          - Nunca se repite el hueco minuto a minuto
+ *          - Los disparos recuperados se ejecutan en orden cronológico, de modo
+ *            que si dos secuencias se pisan queda la más reciente
  * 
- * @note La alarma debe existir en el array para ser habilitada
- * @note Índices inválidos son ignorados silenciosamente
- * @note No resetea el cache temporal (ultimaEjecucion, etc.)
+ * @param tIni Epoch de la última revisión conocida
+ * @param tFin Comienzo del minuto actual (los disparos de este minuto los atiende check())
  * 
- * @see disable() - Para desactivar la alarma
- * @see get() - Para verificar estado de una alarma
+ * @note **INTERVALOS:** Se excluyen; check() ya los dispara tarde por sí mismo
+ * @note **LÍMITE:** Solo se miran las últimas HUECO_MAXIMO_S
  * 
- * @since v1.0
+ * @since v2.2
  * @author Julian Salas Bartolomé
  */
-void AlarmScheduler::enable(uint8_t idx) { 
-    if (idx < _num) {
-        _alarmas[idx].habilitada = true;
-        DBG_ALM_PRINTF("[ALARM] Alarma idx=%u habilitada\n", idx);
+void AlarmScheduler::_recuperaHueco(time_t tIni, time_t tFin) {
+    if (tFin - tIni > (time_t)Config::Alarmas::HUECO_MAXIMO_S) tIni = tFin - Config::Alarmas::HUECO_MAXIMO_S;
+    tIni -= tIni % 60;
+    DBG_ALM_PRINTF("[ALARM] Hueco de %ld min sin revisar alarmas", (long)((tFin - tIni) / 60));
+
+    time_t  aPerdido[MAX_ALARMAS];                                          // Último disparo perdido, ordenado por tiempo
+    uint16_t aIdx[MAX_ALARMAS];
+    uint16_t nPerdidas = 0;
+    for (uint16_t i = 0; i < _num; ++i) {
+        const Alarm &oAlarma = _alarmas[i];
+        if (!oAlarma.habilitada || oAlarma.recuperacion == RECUP_OMITIR || oAlarma.intervaloMin > 0) continue;
+
+        time_t tDesde = tIni;
+        if (oAlarma.recuperacion == RECUP_TARDE) {                          // Solo cuenta lo que aún está dentro del margen
+            time_t tMargen = tFin - (time_t)oAlarma.margenRecuperacionMin * 60;
+            if (tMargen > tDesde) tDesde = tMargen;
+        }
+        time_t tPerdido = _ultimaOcurrencia(i, tDesde, tFin);
+        if (tPerdido == 0 || tPerdido <= oAlarma.ultimaEjecucion) continue;
+        ExcepcionAlarma excepcion;
+        if (_buscaExcepcion(oAlarma.idWeb, _fechaDe(tPerdido), excepcion) && excepcion.tipo == EXCEPCION_OMITIR) continue;
+
+        uint16_t p = nPerdidas++;
+        while (p > 0 && aPerdido[p - 1] > tPerdido) {
+            aPerdido[p] = aPerdido[p - 1];
+            aIdx[p] = aIdx[p - 1];
+            --p;
+        }
+        aPerdido[p] = tPerdido;
+        aIdx[p] = i;
+    }
+
+    time_t ahora = Reloj::Epoch();
+    for (uint16_t n = 0; n < nPerdidas; ++n) {
+        DBG_ALM_PRINTF("[ALARM] idx=%u recuperada con %ld min de retraso", aIdx[n], (long)((ahora - aPerdido[n]) / 60));
+        _ejecutaExcepcion(aIdx[n], _fechaDe(aPerdido[n]));                 // Acción normal si ese día no tiene excepción
+        _alarmas[aIdx[n]].ultimaEjecucion = ahora;
+        _lEstadoSucio = true;
     }
 }
 
 /**
- * @brief Elimina todas las alarmas del sistema
+ * @brief Último disparo de una alarma dentro de [tDesde, tFin)
  * 
- * @details Resetea completamente el array de alarmas, eliminando todas
- *          las configuraciones programadas y liberando espacio para
- *          nuevas alarmas.
+ * @details Recorre la línea de próximos disparos con _calculaProximo() en
+ *          ventanas crecientes que terminan en tFin (10 min, 1 h, 6 h y el
+ *          intervalo completo). La primera ventana con algún disparo da el
+ *          último, así que una alarma de cada minuto no recorre un día entero
+ *          y una diaria solo necesita unos pocos pasos.
  * 
- * @note No libera memoria (array es estático), solo resetea contador
- * @note Todas las alarmas se pierden irreversiblemente
- * @note Llamada automáticamente por begin()
+ * @param idx Índice de la alarma
+ * @param tDesde Epoch alineado a minuto (incluido)
+ * @param tFin Epoch alineado a minuto (excluido)
+ * @return Epoch del último disparo en el intervalo, o 0 si no hay
  * 
- * @see begin() - Función que llama automáticamente a clear()
- * @see count() - Para verificar número de alarmas antes de limpiar
+ * @note **ACOTADO:** Como mucho MAX_PASOS_RECUPERACION disparos por ventana;
+ *       si se agotan se toma el último encontrado
  * 
- * @since v1.0
+ * @since v2.2
  * @author Julian Salas Bartolomé
  */
-void AlarmScheduler::clear() { 
-    _num = 0; 
-    DBG_ALM_PRINTF("[ALARM] Todas las alarmas eliminadas\n");
+time_t AlarmScheduler::_ultimaOcurrencia(uint16_t idx, time_t tDesde, time_t tFin) const {
+    static const uint32_t aVentanas[] = { 10 * 60, 3600, 6 * 3600 };
+    for (uint8_t v = 0; ; ++v) {
+        time_t tVentana = tDesde;
+        if (v < sizeof(aVentanas) / sizeof(aVentanas[0]) && tFin - (time_t)aVentanas[v] > tDesde) {
+            tVentana = tFin - aVentanas[v];
+        }
+
+        time_t tUltimo = 0;
+        time_t tProximo = _calculaProximo(idx, tVentana);
+        for (uint8_t nPasos = 0; tProximo != 0 && tProximo < tFin && nPasos < Config::Alarmas::MAX_PASOS_RECUPERACION; ++nPasos) {
+            tUltimo = tProximo;
+            tProximo = _calculaProximo(idx, tProximo - (tProximo % 60) + 60);
+        }
+        if (tUltimo != 0) return tUltimo;
+        if (tVentana == tDesde) return 0;
+    }
 }
 
 /**
- * @brief Obtiene el número actual de alarmas configuradas
- * 
- * @details Retorna la cantidad de alarmas actualmente registradas
- *          en el sistema, tanto habilitadas como deshabilitadas.
+ * @brief Guarda en flash la última revisión y las ejecuciones recuperables
  * 
- * @return Número de alarmas configuradas (0-16)
+ * @details Archivo binario /alarmas_estado.bin con una cabecera (marca,
+ *          versión, número de entradas, epoch de la revisión) y una entrada
+ *          {idWeb, ultimaEjecucion} por alarma personalizable con política de
+ *          recuperación. Se escribe cada PERIODO_ESTADO_S y cuando se dispara
+ *          una alarma recuperable, no en cada check(), para no gastar la flash.
  * 
- * @note Incluye alarmas habilitadas y deshabilitadas
- * @note Máximo posible es MAX_ALARMAS (16)
- * @note Útil para verificar espacio disponible antes de añadir nuevas
+ * @param tRevision Epoch de la revisión que se guarda
+ * @return true si se escribió el archivo completo
  * 
- * @see MAX_ALARMAS - Constante con límite máximo
- * @see add(), addExternal(), addExternal0() - Funciones que incrementan este valor
+ * @note Las alarmas de sistema no se guardan: se crean en cada arranque con RECUP_OMITIR
  * 
- * @since v1.0
+ * @since v2.2
  * @author Julian Salas Bartolomé
  */
-uint8_t AlarmScheduler::count() const { 
-    return _num; 
+bool AlarmScheduler::_guardaEstado(time_t tRevision) {
+    _tEstadoGuardado = tRevision;                                          // Aunque falle, no reintentar en cada check()
+    _lEstadoSucio = false;
+
+    CabeceraEstado cabecera;
+    cabecera.tRevision = (int64_t)tRevision;
+    for (uint16_t i = 0; i < _num; ++i) {
+        if (_alarmas[i].esPersonalizable && _alarmas[i].recuperacion != RECUP_OMITIR && _alarmas[i].ultimaEjecucion != 0) {
+            cabecera.nEntradas++;
+        }
+    }
+
+    File file = SPIFFS.open(ARCHIVO_ESTADO, "w");
+    if (!file) {
+        DBG_ALM("❌ Error al crear archivo de estado de alarmas");
+        return false;
+    }
+    size_t nEscrito = file.write((const uint8_t*)&cabecera, sizeof(cabecera));
+    size_t nEsperado = sizeof(cabecera);
+    for (uint16_t i = 0; i < _num; ++i) {
+        const Alarm &oAlarma = _alarmas[i];
+        if (!oAlarma.esPersonalizable || oAlarma.recuperacion == RECUP_OMITIR || oAlarma.ultimaEjecucion == 0) continue;
+        EntradaEstado entrada;
+        entrada.idWeb = oAlarma.idWeb;
+        entrada.ultimaEjecucion = (int64_t)oAlarma.ultimaEjecucion;
+        nEscrito += file.write((const uint8_t*)&entrada, sizeof(entrada));
+        nEsperado += sizeof(entrada);
+    }
+    file.close();
+    _cuentaEscritura(nEscrito);
+
+    if (nEscrito != nEsperado) {
+        DBG_ALM("❌ Error al escribir archivo de estado de alarmas");
+        return false;
+    }
+    return true;
 }
 
 /**
- * @brief Obtiene acceso de solo lectura a una alarma específica
- * 
- * @details Proporciona acceso de solo lectura a la configuración de una
- *          alarma específica para inspección o debug. No permite modificación
- *          directa de los datos.
- * 
- * @param idx Índice de la alarma a consultar (0-15)
- * @return Puntero constante a la alarma o nullptr si índice inválido
- * 
- * @note Retorna nullptr para índices fuera de rango
- * @note Solo permite lectura, no modificación de la alarma
- * @note Útil para debug e inspección de configuración
+ * @brief Lee el estado guardado antes del reinicio
  * 
- * @see count() - Para verificar rango válido de índices
- * @see struct Alarm - Estructura de datos retornada
+ * @details Restaura ultimaEjecucion de las alarmas personalizables (por idWeb)
+ *          y deja en _tRecuperarDesde la última revisión, para que el primer
+ *          check() con hora válida recupere los disparos perdidos.
  * 
- * @example
- * @code
- * const Alarm* alarma = scheduler.get(0);
- * if (alarma) {
- *     Serial.printf("Alarma 0: %02u:%02u, habilitada=%u\n", 
- *                   alarma->hora, alarma->minuto, alarma->habilitada);
- * }
- * @endcode
+ * @note Un archivo ausente, de otra versión o truncado se ignora: no se recupera nada
  * 
- * @since v1.0
+ * @since v2.2
  * @author Julian Salas Bartolomé
  */
-const Alarm* AlarmScheduler::get(uint8_t idx) const { 
-    return (idx < _num) ? &_alarmas[idx] : nullptr; 
+void AlarmScheduler::_cargaEstado() {
+    _tRecuperarDesde = 0;
+    if (!SPIFFS.exists(ARCHIVO_ESTADO)) return;
+
+    File file = SPIFFS.open(ARCHIVO_ESTADO, "r");
+    if (!file) return;
+
+    CabeceraEstado cabecera;
+    if (file.read((uint8_t*)&cabecera, sizeof(cabecera)) != sizeof(cabecera) ||
+        cabecera.nMarca != MARCA_ESTADO || cabecera.nVersion != VERSION_ESTADO) {
+        DBG_ALM("⚠️ Archivo de estado de alarmas no válido, se ignora");
+        file.close();
+        return;
+    }
+    for (uint16_t n = 0; n < cabecera.nEntradas; ++n) {
+        EntradaEstado entrada;
+        if (file.read((uint8_t*)&entrada, sizeof(entrada)) != sizeof(entrada)) break;
+        uint16_t idx = _buscarIndicePorIdWeb(entrada.idWeb);
+        if (idx < MAX_ALARMAS) _alarmas[idx].ultimaEjecucion = (time_t)entrada.ultimaEjecucion;
+    }
+    file.close();
+
+    _tRecuperarDesde = (time_t)cabecera.tRevision;
+    DBG_ALM_PRINTF("[ALARM] Estado cargado: última revisión %ld, %u ejecuciones", (long)_tRecuperarDesde, cabecera.nEntradas);
 }
 
 /**
- * @brief Obtiene acceso mutable a una alarma específica por índice
- * 
- * @details Devuelve puntero no-const para permitir modificar alarmas existentes.
- *          Útil para restaurar callbacks después de cargar desde JSON.
+ * @brief Nombre de una política de recuperación para JSON y web
  * 
- * @param idx Índice de la alarma (0 a count()-1)
- * @return Alarm* Puntero a la alarma o nullptr si índice inválido
- * 
- * @warning Usar con precaución - permite modificar alarmas directamente
+ * @since v2.2
  */
-Alarm* AlarmScheduler::getMutable(uint8_t idx) { 
-    return (idx < _num) ? &_alarmas[idx] : nullptr; 
+const char* AlarmScheduler::nombreRecuperacion(uint8_t recuperacion) {
+    switch (recuperacion) {
+        case RECUP_TARDE:  return "TARDE";
+        case RECUP_ULTIMA: return "ULTIMA";
+        default:           return "OMITIR";
+    }
 }
 
 /**
- * @brief Determina si la hora actual está en horario nocturno
- * 
- * @details Evalúa si la hora actual del sistema está dentro del rango
- *          considerado como horario nocturno según la configuración del
- *          proyecto. Maneja correctamente el cambio de día.
- * 
- * @return true si está en horario nocturno, false en caso contrario
- * 
- * @note Horario nocturno típico: 22:00 - 07:00 (configurable)
- * @note Utiliza t.tm_hour (debe llamarse después de getLocalTime())
- * @note Maneja correctamente el cambio de día (ej: 23:00 - 06:00)
- * 
- * @warning Requiere llamada previa a getLocalTime() para actualizar t
+ * @brief Política de recuperación a partir de su nombre
  * 
- * @see Config::Time::NOCHE_INICIO_HORA - Hora de inicio de la noche
- * @see Config::Time::NOCHE_FIN_HORA - Hora de fin de la noche
- * @see check() - Función que actualiza t.tm_hour
+ * @return RecuperacionAlarma, o 255 si el nombre no existe
  * 
- * @since v2.0
- * @author Julian Salas Bartolomé
+ * @since v2.2
  */
-bool AlarmScheduler::esHorarioNocturno() const {
-    return (t.tm_hour >= Config::Time::NOCHE_INICIO_HORA || 
-            t.tm_hour < Config::Time::NOCHE_FIN_HORA);
+uint8_t AlarmScheduler::recuperacionDesdeNombre(const char* nombre) {
+    if (nombre == nullptr) return 255;
+    if (strcmp(nombre, "OMITIR") == 0) return RECUP_OMITIR;
+    if (strcmp(nombre, "TARDE") == 0)  return RECUP_TARDE;
+    if (strcmp(nombre, "ULTIMA") == 0) return RECUP_ULTIMA;
+    return 255;
 }
 
 // ============================================================================
-// IMPLEMENTACIÓN DE MÉTODOS PRIVADOS
+// EXCEPCIONES POR FECHA
 // ============================================================================
+/**
+ * @brief Nombre de un tipo de excepción para JSON y web
+ * 
+ * @since v2.2
+ */
+const char* AlarmScheduler::nombreExcepcion(uint8_t tipo) {
+    switch (tipo) {
+        case EXCEPCION_SUSTITUIR: return "SUSTITUIR";
+        case EXCEPCION_DESPLAZAR: return "DESPLAZAR";
+        default:                  return "OMITIR";
+    }
+}
 
 /**
- * @brief Convierte día de la semana (0-6) a máscara de bits
+ * @brief Tipo de excepción a partir de su nombre
  * 
- * @details Función utilitaria estática que convierte el día de la semana
- *          del sistema (donde 0=Domingo, 1=Lunes, ..., 6=Sábado) a una
- *          máscara de bits compatible con el sistema de alarmas.
+ * @return TipoExcepcion, o 255 si el nombre no existe
  * 
- * @param diaSemana Día de la semana (0=Domingo, 1=Lunes, ..., 6=Sábado)
- * @return Máscara de bits correspondiente (bit 0=Domingo, bit 1=Lunes, etc.)
- *         o 0 si el día está fuera del rango válido
+ * @since v2.2
+ */
+uint8_t AlarmScheduler::excepcionDesdeNombre(const char* nombre) {
+    if (nombre == nullptr) return 255;
+    if (strcmp(nombre, "OMITIR") == 0)    return EXCEPCION_OMITIR;
+    if (strcmp(nombre, "SUSTITUIR") == 0) return EXCEPCION_SUSTITUIR;
+    if (strcmp(nombre, "DESPLAZAR") == 0) return EXCEPCION_DESPLAZAR;
+    return 255;
+}
+
+/**
+ * @brief Fecha AAAAMMDD a partir de un texto "AAAA-MM-DD"
  * 
- * @note Utilizada internamente por check() para comparar con mascaraDias
- * @note Convierte formato tm_wday a formato DOW_* del sistema
- * @note Función estática - no requiere instancia de la clase
+ * @return 0 si el texto no es una fecha válida
  * 
- * @see DOW_DOMINGO, DOW_LUNES, etc. - Constantes de días definidas
- * @see struct tm - Estructura que contiene tm_wday
- * @see check() - Función que utiliza esta conversión
+ * @since v2.2
+ */
+uint32_t AlarmScheduler::fechaDesdeTexto(const char* texto) {
+    unsigned nAno, nMes, nDia;
+    if (texto == nullptr || sscanf(texto, "%4u-%2u-%2u", &nAno, &nMes, &nDia) != 3) return 0;
+    if (nAno < 2000 || nMes < 1 || nMes > 12 || nDia < 1 || nDia > 31) return 0;
+    return nAno * 10000 + nMes * 100 + nDia;
+}
+
+/**
+ * @brief Día local (AAAAMMDD) de un instante
  * 
- * @since v2.0
- * @author Julian Salas Bartolomé
+ * @since v2.2
  */
-uint8_t AlarmScheduler::mascaraDesdeDiaSemana(int diaSemana) {
-    return (diaSemana >= 0 && diaSemana <= 6) ? (1 << diaSemana) : 0;
+uint32_t AlarmScheduler::_fechaDe(time_t tEpoch) {
+    struct tm local;
+    localtime_r(&tEpoch, &local);
+    return (uint32_t)(local.tm_year + 1900) * 10000 + (local.tm_mon + 1) * 100 + local.tm_mday;
 }
 
 /**
- * @brief Resetea el cache temporal de todas las alarmas
+ * @brief Crea o sustituye la excepción de una alarma en una fecha
  * 
- * @details Función utilitaria que limpia el cache de prevención de duplicados
- *          de todas las alarmas registradas. Útil después de cambios de hora
- *          del sistema, reinicializaciones o cuando se detectan problemas
- *          de ejecución de alarmas.
- *          
- *          **VARIABLES RESETEADAS:**
- *          - ultimoDiaAno: Se establece a -1 (valor inicial)
- *          - ultimoMinuto: Se establece a 255 (valor inicial)  
- *          - ultimaHora: Se establece a 255 (valor inicial)
- *          - ultimaEjecucion: Se establece a 0 (timestamp inicial)
+ * @details **TIPOS:**
+ *          - EXCEPCION_OMITIR: ese día la alarma no suena
+ *          - EXCEPCION_SUSTITUIR: suena a su hora con accionExt(parametro)
+ *          - EXCEPCION_DESPLAZAR: suena desplazamientoMin minutos después
+ *            (negativo = antes), con su acción de siempre
  *          
- *          Esto permite que las alarmas se ejecuten nuevamente sin esperar
- *          al cambio natural de día o configuración temporal.
- * 
- * @note **USO TÍPICO:** Después de sincronización NTP o ajustes de sistema
- * @note **EFECTO:** Permite re-ejecución inmediata de alarmas en el minuto actual
- * @note **SEGURIDAD:** No afecta configuración de alarmas, solo cache temporal
- * @note **DEBUG:** Util para depuración de problemas de ejecución de alarmas
- * 
- * @warning **DUPLICADOS:** Puede causar ejecución múltiple si se llama repetidamente
- * @warning **USO MODERADO:** Solo llamar cuando sea realmente necesario
+ *          Se aplica a todos los disparos de la alarma en esa fecha. El
+ *          índice se reconstruye en el próximo check() y la tabla se guarda
+ *          en /alarmas_excepciones.json.
  * 
- * @see check() - Función que utiliza el cache para prevenir duplicados
- * @see ultimoDiaAno, ultimoMinuto, ultimaEjecucion - Variables afectadas
- * @see begin() - Inicialización que resetea automáticamente el cache
- * 
- * @example
- * @code
- * // Después de sincronización manual
- * if (RTC::beginConMultiplesServidores()) {
- *     Alarmas.resetCache();  // Permitir nuevas ejecuciones
- * }
+ * @param excepcion Excepción con idWeb, fecha y tipo (accionExt ya resuelta si sustituye)
+ * @return false si la alarma no existe, los datos no son válidos o la tabla está llena
  * 
- * // Para debug de alarmas que no se ejecutan
- * Alarmas.resetCache();
- * Serial.println("Cache de alarmas reseteado para debug");
- * @endcode
+ * @note **EJEMPLO:** {idWeb 3, 20261227, EXCEPCION_OMITIR}: sin la misa del domingo 27
  * 
- * @since v2.1 - Función añadida para depuración y mantenimiento
+ * @since v2.2
  * @author Julian Salas Bartolomé
  */
-void AlarmScheduler::resetCache() {
-    for (uint8_t i = 0; i < _num; ++i) {
-        _alarmas[i].ultimoDiaAno = -1;
-        _alarmas[i].ultimoMinuto = 255;
-        _alarmas[i].ultimaHora = 255;
-        _alarmas[i].ultimaEjecucion = 0;
+bool AlarmScheduler::addExcepcion(const ExcepcionAlarma& excepcion) {
+    uint16_t idx = _buscarIndicePorIdWeb(excepcion.idWeb);
+    if (idx >= MAX_ALARMAS || !_alarmas[idx].esPersonalizable) return false;
+    if (excepcion.fecha == 0 || excepcion.tipo > EXCEPCION_DESPLAZAR) return false;
+    if (excepcion.tipo == EXCEPCION_DESPLAZAR &&
+        (excepcion.desplazamientoMin == 0 ||
+         excepcion.desplazamientoMin > Config::Alarmas::DESPLAZAMIENTO_MAXIMO_MIN ||
+         excepcion.desplazamientoMin < -Config::Alarmas::DESPLAZAMIENTO_MAXIMO_MIN)) return false;
+    if (excepcion.tipo == EXCEPCION_SUSTITUIR && excepcion.accionExt == nullptr) return false;
+
+    bool lOk = true;
+    uint8_t n = 0;
+    while (n < _nExcepciones && (_aExcepciones[n].idWeb != excepcion.idWeb || _aExcepciones[n].fecha != excepcion.fecha)) ++n;
+    if (n < _nExcepciones) {
+        _aExcepciones[n] = excepcion;
+    } else if (_nExcepciones < Config::Alarmas::MAX_EXCEPCIONES) {
+        _aExcepciones[_nExcepciones++] = excepcion;
+    } else {
+        lOk = false;
     }
-    DBG_ALM_PRINTF("[ALARM] Cache de %u alarmas reseteado\n", _num);
-}
+    if (!lOk) return false;
 
+    DBG_ALM_PRINTF("📅 Excepción %s para la alarma %d el %lu", nombreExcepcion(excepcion.tipo),
+                   excepcion.idWeb, (unsigned long)excepcion.fecha);
+    _invalidaIndice();                                                      // Recalcula el bitmap del día y los disparos
+    _guardaExcepciones();
+    return true;
+}
 
 /**
- * @brief Carga configuración de alarmas predeterminadas del sistema
- * 
- * @details Función privada que configura un conjunto básico de alarmas
- *          necesarias para el funcionamiento estándar del campanario.
- *          Incluye misas dominicales, toques de horas y tareas de mantenimiento.
- *          
- *          **ALARMAS PREDETERMINADAS:**
- *          - Misas dominicales a las 11:05 y 11:25
- *          - Toques de horas en punto (wildcard para todas las horas)
- *          - Toques de medias horas (:30)
- *          - Sincronización NTP diaria (12:02)
- *          - Actualización DNS (12:05)
- * 
- * @note Llamada automáticamente por begin() si cargarPorDefecto == true
- * @note Todas las alarmas se crean habilitadas por defecto
- * @note Utiliza funciones de Acciones.h para las implementaciones
- * 
- * @see begin() - Función que llama a initDefaults()
- * @see Acciones.h - Funciones utilizadas (accionSecuencia, accionTocaHora, etc.)
- * @see Config::States::MISA - Constante para secuencias de misa
+ * @brief Elimina la excepción de una alarma en una fecha
  * 
- * @since v1.0 - Configuración básica
- * @since v2.0 - Añadidas funciones de mantenimiento (NTP, DNS)
+ * @return false si no existía
  * 
+ * @since v2.2
  * @author Julian Salas Bartolomé
  */
-void AlarmScheduler::initDefaults() {
-    DBG_ALM_PRINTF("[ALARM] Cargando configuración por defecto...\n");
-    
-    // ===== MISAS DOMINICALES =====
-    //addExternal(DOW_DOMINGO, 11, 5,  0, accionSecuencia, Config::States::MISA, true);
-    //addExternal(DOW_DOMINGO, 11, 25, 0, accionSecuencia, Config::States::MISA, true);
+bool AlarmScheduler::eliminarExcepcion(int idWeb, uint32_t fecha) {
+    bool lEncontrada = false;
+    for (uint8_t n = 0; n < _nExcepciones; ++n) {
+        if (_aExcepciones[n].idWeb == idWeb && _aExcepciones[n].fecha == fecha) {
+            _aExcepciones[n] = _aExcepciones[--_nExcepciones];
+            lEncontrada = true;
+            break;
+        }
+    }
+    if (!lEncontrada) return false;
 
-    // ===== CUARTOS Y MEDIAS (FUNCIONALIDAD MIGRADA DE TIMEMANAGER) =====
-    // Tocar horas en punto (wildcards = todas las horas)
-    addExternal0(DOW_TODOS, ALARMA_WILDCARD, 0, 0, accionTocaHora, true);
-    
-    // Tocar medias horas
-    addExternal0(DOW_TODOS, ALARMA_WILDCARD, 30, 0, accionTocaMedia, true);
+    _invalidaIndice();
+    _guardaExcepciones();
+    return true;
+}
 
-    // ===== FUNCIONES DE MANTENIMIENTO DEL SISTEMA =====
-    // Sincronización NTP al mediodía
-    addExternal0(DOW_TODOS, 12, 2, 0, SincronizaNTP, true);
-    
-    // Actualización DNS dinámica
-    addExternal0(DOW_TODOS, 12, 5, 0, ActualizaDNSSiNecesario, true);
+/**
+ * @brief Elimina todas las excepciones de una alarma (al eliminar la alarma)
+ * 
+ * @since v2.2
+ * @author Julian Salas Bartolomé
+ */
+void AlarmScheduler::_eliminaExcepcionesDe(int idWeb) {
+    bool lCambio = false;
+    for (uint8_t n = 0; n < _nExcepciones; ) {
+        if (_aExcepciones[n].idWeb == idWeb) {
+            _aExcepciones[n] = _aExcepciones[--_nExcepciones];
+            lCambio = true;
+        } else {
+            ++n;
+        }
+    }
+    if (lCambio) _guardaExcepciones();
+}
 
-    DBG_ALM_PRINTF("[ALARM] Configuración por defecto cargada: %u alarmas\n", _num);
+uint8_t AlarmScheduler::countExcepciones() const {
+    return _nExcepciones;
+}
+
+ExcepcionAlarma* AlarmScheduler::getExcepcionMutable(uint8_t n) {
+    return (n < _nExcepciones) ? &_aExcepciones[n] : nullptr;
 }
 
-// ============================================================================
-// IMPLEMENTACIÓN DE GESTIÓN WEB DE ALARMAS PERSONALIZABLES
-// ============================================================================
 /**
- * @brief Añade una nueva alarma personalizable editable vía web
+ * @brief Copia la excepción de una alarma en una fecha
  * 
- * @details Crea una alarma completamente configurable desde la interfaz web
- *          con persistencia en JSON y callback proporcionado externamente.
- *          La alarma se marca como personalizable y recibe un ID único para 
- *          gestión web independiente del índice del array.
- *          
- *          **PROCESO DE CREACIÓN:**
- *          1. Verifica espacio disponible en array de alarmas
- *          2. Crea nueva estructura Alarm con datos proporcionados
- *          3. Configura callback externo (debe ser válido)
- *          4. Asigna ID web único incremental
- *          5. Marca alarma como personalizable (esPersonalizable = true)
- *          6. Guarda automáticamente en JSON para persistencia
- *          7. Incrementa contador de alarmas y retorna índice
+ * @return false si no hay ninguna
  * 
- * @param nombre Nombre descriptivo de la alarma (máx 49 caracteres)
- * @param descripcion Descripción opcional de la alarma (máx 99 caracteres)
- * @param mascaraDias Máscara de bits para días de la semana (DOW_DOMINGO, DOW_LUNES, etc.)
- * @param hora Hora de ejecución (0-23)
- * @param minuto Minuto de ejecución (0-59)
- * @param tipoString Tipo de acción como string libre: "MISA", "DIFUNTOS", "FIESTA", etc.
- * @param parametro Parámetro uint16_t a pasar al callback durante ejecución
- * @param callback Puntero a función externa que se ejecutará: void (*func)(uint16_t)
- * @param habilitada Estado inicial de la alarma (true por defecto)
+ * @since v2.2
+ * @author Julian Salas Bartolomé
+ */
+bool AlarmScheduler::_buscaExcepcion(int idWeb, uint32_t fecha, ExcepcionAlarma& excepcion) {
+    bool lEncontrada = false;
+    for (uint8_t n = 0; n < _nExcepciones; ++n) {
+        if (_aExcepciones[n].idWeb == idWeb && _aExcepciones[n].fecha == fecha) {
+            excepcion = _aExcepciones[n];
+            lEncontrada = true;
+            break;
+        }
+    }
+    return lEncontrada;
+}
+
+/**
+ * @brief Calcula los límites del día actual y el bitmap de excepciones de hoy
  * 
- * @retval uint8_t Índice de la alarma en el array (0 a MAX_ALARMAS-1) si creación exitosa
- * @retval MAX_ALARMAS Si no hay espacio disponible o error en parámetros
+ * @details Se llama al reconstruir el índice y al pasar la medianoche. Es el
+ *          único sitio que recorre la tabla de excepciones en el camino de
+ *          check(); el resto solo prueba el bit de la alarma. De paso
+ *          descarta las excepciones de días ya pasados (en memoria; el
+ *          archivo se actualiza en el siguiente cambio).
  * 
- * @note **CALLBACK EXTERNO:** El callback debe ser proporcionado desde código externo
- * @note **ID WEB ÚNICO:** Cada alarma recibe ID incremental para gestión web
- * @note **PERSISTENCIA:** Se guarda automáticamente en JSON tras la creación
- * @note **GENÉRICO:** Esta función no interpreta tipos - es completamente genérica
- * @note **TRUNCAMIENTO:** Los strings se truncan silenciosamente si exceden límites
+ * @param ahora Epoch actual
  * 
- * @warning **LÍMITE GLOBAL:** Máximo MAX_ALARMAS alarmas simultáneas (incluye sistema)
- * @warning **CALLBACK VÁLIDO:** El puntero de función debe ser válido y persistente
- * @warning **THREAD SAFETY:** No es thread-safe, usar desde hilo principal únicamente
- * @warning **SPIFFS REQUERIDO:** Requiere sistema de archivos montado para persistencia
+ * @since v2.2
+ * @author Julian Salas Bartolomé
+ */
+void AlarmScheduler::_preparaDia(time_t ahora) {
+    struct tm dia;
+    localtime_r(&ahora, &dia);
+    dia.tm_hour = 0;
+    dia.tm_min = 0;
+    dia.tm_sec = 0;
+    time_t tInicio = EpochLocal(dia, 0);
+    dia.tm_mday += 1;
+    time_t tFin = EpochLocal(dia, 0);
+    _tInicioDia = (tInicio != (time_t)-1 && tInicio <= ahora) ? tInicio : ahora - (ahora % 60);
+    _tFinDia = (tFin != (time_t)-1 && tFin > ahora) ? tFin : ahora - (ahora % 3600) + 3600;
+    _fechaHoy = _fechaDe(ahora);
+
+    int aIdHoy[Config::Alarmas::MAX_EXCEPCIONES];
+    uint8_t nHoy = 0;
+    uint8_t nVigentes = 0;
+    for (uint8_t n = 0; n < _nExcepciones; ++n) {
+        if (_aExcepciones[n].fecha < _fechaHoy) continue;                   // Ya pasada
+        if (_aExcepciones[n].fecha == _fechaHoy) aIdHoy[nHoy++] = _aExcepciones[n].idWeb;
+        _aExcepciones[nVigentes++] = _aExcepciones[n];
+    }
+    _nExcepciones = nVigentes;
+
+    for (uint8_t p = 0; p < sizeof(_aExcepcionHoy) / sizeof(_aExcepcionHoy[0]); ++p) {
+        _aExcepcionHoy[p] = 0;
+    }
+    for (uint8_t n = 0; n < nHoy; ++n) {
+        uint16_t idx = _buscarIndicePorIdWeb(aIdHoy[n]);
+        if (idx < MAX_ALARMAS) _aExcepcionHoy[idx / 32] |= 1UL << (idx % 32);
+    }
+    DBG_ALM_PRINTF("[ALARM] Día %lu: %u excepciones", (unsigned long)_fechaHoy, nHoy);
+}
+
+/**
+ * @brief Indica si la alarma tiene una excepción hoy (un bit)
  * 
- * @see modificarPersonalizable() - Para editar alarma existente
- * @see eliminarPersonalizable() - Para eliminar alarma
- * @see habilitarPersonalizable() - Para cambiar estado
- * @see guardarPersonalizablesEnJSON() - Función de persistencia utilizada
+ * @since v2.2
+ */
+bool AlarmScheduler::_excepcionHoy(uint16_t idx) const {
+    return (_aExcepcionHoy[idx / 32] & (1UL << (idx % 32))) != 0;
+}
+
+/**
+ * @brief Próximo disparo de una alarma con excepción hoy
  * 
- * @example
- * @code
- * // Crear misa dominical desde código externo (ej: Servidor.cpp)
- * uint8_t idx = Alarmas.addPersonalizable(
- *     "Misa Domingo",           // nombre
- *     "Primera llamada",        // descripcion  
- *     DOW_DOMINGO,              // solo domingos
- *     11, 5,                    // 11:05
- *     "MISA",                   // tipo
- *     Config::States::MISA,     // parámetro
- *     accionSecuencia,          // callback
- *     true                      // habilitada
- * );
+ * @details Recorre los disparos normales con _calculaProximo(): los de hoy
+ *          se omiten o se desplazan y el primero que cae en tDesde o después
+ *          es el próximo. Con un desplazamiento positivo se empieza antes de
+ *          tDesde, porque un disparo de hace unos minutos puede sonar todavía.
  * 
- * if (idx < MAX_ALARMAS) {
- *     Serial.println("Alarma creada exitosamente");
- * } else {
- *     Serial.println("Error: No hay espacio para más alarmas");
- * }
- * @endcode
+ * @param idx Índice de la alarma
+ * @param tDesde Epoch alineado a minuto (incluido)
+ * @return Epoch del próximo disparo, o 0 si no hay
  * 
- * @since v2.1 - Sistema de alarmas personalizables vía web
+ * @since v2.2
  * @author Julian Salas Bartolomé
  */
-uint8_t AlarmScheduler::addPersonalizable(const char* nombre, const char* descripcion,
-                                         uint8_t mascaraDias, uint8_t hora, uint8_t minuto,
-                                         const char* tipoString, uint16_t parametro,
-                                         void (*callback)(uint16_t), bool habilitada) {
-    DBG_ALM("🔔 Añadiendo alarma personalizable");
-    DBG_ALM_PRINTF("  Nombre: %s", nombre);
-    DBG_ALM_PRINTF("  Tipo: %s", tipoString);
-    DBG_ALM_PRINTF("  Horario: %s %02d:%02d", 
-                   mascaraDias == DOW_TODOS ? "Diario" : "Específico", hora, minuto);
-    
-    if (_num >= MAX_ALARMAS) {
-        DBG_ALM("❌ Error: Máximo de alarmas alcanzado");
-        return MAX_ALARMAS;
+time_t AlarmScheduler::_proximoConExcepcion(uint16_t idx, time_t tDesde) {
+    ExcepcionAlarma excepcion;
+    if (!_buscaExcepcion(_alarmas[idx].idWeb, _fechaHoy, excepcion) || excepcion.tipo == EXCEPCION_SUSTITUIR) {
+        return _calculaProximo(idx, tDesde);                                // Sustituir no cambia la hora
     }
-    
-    // Crear nueva alarma
-    Alarm& alarma = _alarmas[_num];
-    alarma.habilitada = habilitada;
-    alarma.mascaraDias = mascaraDias;
-    alarma.hora = hora;
-    alarma.minuto = minuto;
-    alarma.intervaloMin = 0;  // Las personalizables no usan intervalo
-    alarma.parametro = parametro;
-    
-    // Asignar callback (ya viene como parámetro)
-    alarma.accionExt = callback;
-    alarma.accion = nullptr;     // Limpiar otros callbacks
-    alarma.accionExt0 = nullptr;
-    
-    // Campos web
-    strncpy(alarma.nombre, nombre, sizeof(alarma.nombre) - 1);
-    alarma.nombre[sizeof(alarma.nombre) - 1] = '\0';
-    
-    strncpy(alarma.descripcion, descripcion, sizeof(alarma.descripcion) - 1);
-    alarma.descripcion[sizeof(alarma.descripcion) - 1] = '\0';
-    
-    strncpy(alarma.tipoString, tipoString, sizeof(alarma.tipoString) - 1);
-    alarma.tipoString[sizeof(alarma.tipoString) - 1] = '\0';
-    
-    alarma.esPersonalizable = true;
-    alarma.idWeb = _generarNuevoIdWeb();
-    
-    uint8_t idx = _num;
-    _num++;
-    
-    DBG_ALM_PRINTF("✅ Alarma personalizable creada - Índice: %d, ID Web: %d", idx, alarma.idWeb);
-    
-    // Guardar en JSON
-    guardarPersonalizablesEnJSON();
-    
-    return idx;
+
+    time_t nDesplazamiento = (excepcion.tipo == EXCEPCION_DESPLAZAR) ? (time_t)excepcion.desplazamientoMin * 60 : 0;
+    time_t tProximo = _calculaProximo(idx, (nDesplazamiento > 0) ? tDesde - nDesplazamiento : tDesde);
+    for (uint16_t nPasos = 0; tProximo != 0 && nPasos <= 2 * Config::Alarmas::DESPLAZAMIENTO_MAXIMO_MIN; ++nPasos) {
+        bool lHoy = tProximo >= _tInicioDia && tProximo < _tFinDia;
+        if (lHoy && excepcion.tipo == EXCEPCION_OMITIR) {
+            tProximo = _calculaProximo(idx, _tFinDia);                      // Ningún disparo hoy
+            continue;
+        }
+        time_t tReal = lHoy ? tProximo + nDesplazamiento : tProximo;
+        if (tReal >= tDesde) return tReal;
+        tProximo = _calculaProximo(idx, tProximo - (tProximo % 60) + 60);   // Desplazado a antes de tDesde: ya pasó
+    }
+    return 0;
 }
+
 /**
- * @brief Modifica una alarma personalizable existente por su ID web
+ * @brief Ejecuta una alarma cuyo día tiene excepción
  * 
- * @details Actualiza todos los campos de una alarma personalizable identificada
- *          por su ID web único. Mantiene el callback existente sin modificarlo.
- *          Actualiza automáticamente el archivo JSON de persistencia.
- *          Resetea el cache temporal para forzar reevaluación en próxima verificación.
+ * @details EXCEPCION_SUSTITUIR ejecuta la acción de la excepción; si no tiene
+ *          callback (p.ej. tras cargar sin restaurarlo) usa el de la alarma
+ *          con el parámetro de la excepción. Los otros tipos ya se aplicaron
+ *          al calcular el disparo, así que se ejecuta la acción normal.
  * 
- * @param idWeb ID único web de la alarma a modificar
- * @param nombre Nuevo nombre descriptivo (máx 49 caracteres)
- * @param descripcion Nueva descripción opcional (máx 99 caracteres)
- * @param mascaraDias Nueva máscara de días de la semana
- * @param hora Nueva hora de ejecución (0-23)
- * @param minuto Nuevo minuto de ejecución (0-59)
- * @param tipoString Nuevo tipo como string libre: "MISA", "DIFUNTOS", "FIESTA", etc.
- * @param habilitada Nuevo estado de habilitación
+ * @param idx Índice de la alarma
+ * @param fecha Día (AAAAMMDD) del disparo
  * 
- * @return bool true si la modificación fue exitosa, false en caso de error
+ * @since v2.2
+ * @author Julian Salas Bartolomé
+ */
+void AlarmScheduler::_ejecutaExcepcion(uint16_t idx, uint32_t fecha) {
+    ExcepcionAlarma excepcion;
+    if (_buscaExcepcion(_alarmas[idx].idWeb, fecha, excepcion) && excepcion.tipo == EXCEPCION_SUSTITUIR) {
+        void (*accion)(uint16_t) = excepcion.accionExt ? excepcion.accionExt : _alarmas[idx].accionExt;
+        if (accion) {
+            accion(excepcion.parametro);
+            DBG_ALM_PRINTF("[ALARM] idx=%u ejecutada con excepción: %s, param=%u\n", idx, excepcion.accion, excepcion.parametro);
+            return;
+        }
+    }
+    _ejecutaAccion(idx);
+}
+
+/**
+ * @brief Devuelve las excepciones en JSON para la web
  * 
- * @note Solo se pueden modificar alarmas con esPersonalizable = true
- * @note MANTIENE el callback existente - no lo reasigna
- * @note Los cambios se guardan inmediatamente en JSON
- * @note Cache temporal se resetea para evitar conflictos
+ * @details Formato: {"excepciones":[{"id","fecha":"AAAA-MM-DD","tipo",
+ *          "accion","parametro","desplazamiento"}],"maximo":N}
  * 
- * @warning El idWeb debe existir y pertenecer a una alarma personalizable
- * @warning Para cambiar callback, eliminar y recrear la alarma
+ * @since v2.2
+ * @author Julian Salas Bartolomé
+ */
+String AlarmScheduler::obtenerExcepcionesJSON() {
+    ExcepcionAlarma aCopia[Config::Alarmas::MAX_EXCEPCIONES];
+    uint8_t nExcepciones = _nExcepciones;
+    for (uint8_t n = 0; n < nExcepciones; ++n) aCopia[n] = _aExcepciones[n];
+
+    JsonDocument doc;
+    JsonArray array = doc.createNestedArray("excepciones");
+    for (uint8_t n = 0; n < nExcepciones; ++n) {
+        const ExcepcionAlarma& e = aCopia[n];
+        char sFecha[16];                                                // AAAA-MM-DD; 16 cubre cualquier valor de fecha
+        snprintf(sFecha, sizeof(sFecha), "%04lu-%02lu-%02lu", (unsigned long)(e.fecha / 10000),
+                 (unsigned long)(e.fecha / 100 % 100), (unsigned long)(e.fecha % 100));
+        JsonObject obj = array.createNestedObject();
+        obj["id"] = e.idWeb;
+        obj["fecha"] = sFecha;
+        obj["tipo"] = nombreExcepcion(e.tipo);
+        if (e.tipo == EXCEPCION_SUSTITUIR) {
+            obj["accion"] = e.accion;
+            obj["parametro"] = e.parametro;
+        }
+        if (e.tipo == EXCEPCION_DESPLAZAR) {
+            obj["desplazamiento"] = e.desplazamientoMin;
+        }
+    }
+    doc["maximo"] = Config::Alarmas::MAX_EXCEPCIONES;
+
+    String resultado;
+    serializeJson(doc, resultado);
+    return resultado;
+}
+
+/**
+ * @brief Guarda la tabla de excepciones en /alarmas_excepciones.json
  * 
- * @see addPersonalizable(), eliminarPersonalizable(), habilitarPersonalizable()
+ * @details Mismo formato que obtenerExcepcionesJSON(). Las excepciones
+ *          cambian pocas veces, así que se reescribe entera en cada cambio.
  * 
- * @since v2.1 - Sistema de alarmas personalizables vía web
+ * @since v2.2
+ * @author Julian Salas Bartolomé
  */
-bool AlarmScheduler::modificarPersonalizable(int idWeb, const char* nombre, const char* descripcion,
-                                           uint8_t mascaraDias, uint8_t hora, uint8_t minuto,
-                                           const char* tipoString, bool habilitada,
-                                           void (*callback)(uint16_t), uint16_t parametro) {  // ✅ NUEVOS parámetros
-    DBG_ALM_PRINTF("✏️ Modificando alarma personalizable ID Web: %d", idWeb);
-    
-    uint8_t idx = _buscarIndicePorIdWeb(idWeb);
-    if (idx >= MAX_ALARMAS) {
-        DBG_ALM("❌ Error: Alarma no encontrada");
+bool AlarmScheduler::_guardaExcepciones() {
+    String contenido = obtenerExcepcionesJSON();
+    File file = SPIFFS.open(ARCHIVO_EXCEPCIONES, "w");
+    if (!file) {
+        DBG_ALM("❌ Error al crear el archivo de excepciones");
         return false;
     }
-    
-    Alarm& alarma = _alarmas[idx];
-    
-    if (!alarma.esPersonalizable) {
-        DBG_ALM("❌ Error: Alarma no es personalizable");
-        return false;
+    size_t nEscrito = file.print(contenido);
+    file.close();
+    _cuentaEscritura(nEscrito);
+    return nEscrito == contenido.length();
+}
+
+/**
+ * @brief Lee /alarmas_excepciones.json
+ * 
+ * @details Las excepciones de alarmas que ya no existen se descartan. El
+ *          callback de las de tipo SUSTITUIR queda a nullptr hasta que
+ *          RestaurarCallbacksAlarmas() lo resuelve por su campo "accion".
+ * 
+ * @since v2.2
+ * @author Julian Salas Bartolomé
+ */
+void AlarmScheduler::_cargaExcepciones() {
+    _nExcepciones = 0;
+    if (!SPIFFS.exists(ARCHIVO_EXCEPCIONES)) return;
+    File file = SPIFFS.open(ARCHIVO_EXCEPCIONES, "r");
+    if (!file) return;
+    JsonDocument doc;
+    DeserializationError error = deserializeJson(doc, file);
+    file.close();
+    if (error) {
+        DBG_ALM_PRINTF("⚠️ Archivo de excepciones no válido: %s", error.c_str());
+        return;
     }
-    
-    // ✅ VERIFICAR que el callback no es NULL
-    if (callback == nullptr) {
-        DBG_ALM("❌ Error: Callback es NULL");
-        return false;
+
+    ExcepcionAlarma aLeidas[Config::Alarmas::MAX_EXCEPCIONES];
+    uint8_t nLeidas = 0;
+    for (JsonObject obj : doc["excepciones"].as<JsonArray>()) {
+        if (nLeidas >= Config::Alarmas::MAX_EXCEPCIONES) break;
+        ExcepcionAlarma e;
+        e.idWeb = obj["id"] | -1;
+        e.fecha = fechaDesdeTexto(obj["fecha"] | "");
+        e.tipo = excepcionDesdeNombre(obj["tipo"] | "");
+        e.desplazamientoMin = obj["desplazamiento"] | 0;
+        e.parametro = obj["parametro"] | 0;
+        strlcpy(e.accion, obj["accion"] | "", sizeof(e.accion));
+        if (_buscarIndicePorIdWeb(e.idWeb) >= MAX_ALARMAS || e.fecha == 0 || e.tipo > EXCEPCION_DESPLAZAR) continue;
+        aLeidas[nLeidas++] = e;
     }
-    
-    // Actualizar TODOS los campos incluyendo callback
+
+    for (uint8_t n = 0; n < nLeidas; ++n) _aExcepciones[n] = aLeidas[n];
+    _nExcepciones = nLeidas;
+    DBG_ALM_PRINTF("[ALARM] %u excepciones cargadas", nLeidas);
+}
+
+// ============================================================================
+// AGENDA (VISTA PREVIA)
+// ============================================================================
+namespace {
+    // Próximo disparo de una alarma en la agenda; el montículo se ordena por tEfectivo
+    struct DisparoAgenda {
+        time_t  tEfectivo;                                                  // Con el desplazamiento de su excepción
+        time_t  tNominal;                                                   // Según la programación de la alarma
+        uint16_t idx;
+    };
+    bool _posteriorAgenda(const DisparoAgenda& a, const DisparoAgenda& b) {
+        return a.tEfectivo > b.tEfectivo;                                   // std::*_heap con el menor arriba
+    }
+
+    struct EventoAgenda {
+        time_t   t;
+        int16_t  idWeb;                                                     // -1 en los toques de reloj
+        uint16_t parametro;                                                 // Hora del toque de reloj
+        uint8_t  clase;                                                     // ClaseAgenda
+        uint8_t  marca;                                                     // MarcaAgenda
+        char     accion[ALARMA_TAM_TIPO];
+    };
+
+    enum ClaseAgenda : uint8_t { AGENDA_ALARMA = 0, AGENDA_HORA, AGENDA_MEDIA, AGENDA_NINGUNA };
+    enum MarcaAgenda : uint8_t { MARCA_NORMAL = 0, MARCA_OMITIDA, MARCA_SUSTITUIDA, MARCA_DESPLAZADA, MARCA_ESPERA };
+    const char* const NOMBRES_MARCA[] = { "", "OMITIDA", "SUSTITUIDA", "DESPLAZADA", "ESPERA" };
+}
+
+/**
+ * @brief Próxima ocurrencia nominal de una alarma para la agenda
+ * 
+ * @details Igual que _calculaProximo() pero sin anclar los intervalos a la
+ *          última ejecución real: se avanza desde la ocurrencia anterior.
+ * 
+ * @since v2.2
+ */
+time_t AlarmScheduler::_siguienteAgenda(uint16_t idx, time_t tAnterior) const {
+    const Alarm &oAlarma = _alarmas[idx];
+    if (oAlarma.intervaloMin > 0 && !oAlarma.esCron && oAlarma.fiesta == FIESTA_NINGUNA) {
+        time_t tIntervalo = tAnterior + (time_t)oAlarma.intervaloMin * 60;
+        struct tm info;
+        localtime_r(&tIntervalo, &info);
+        if (oAlarma.mascaraDias & mascaraDesdeDiaSemana(info.tm_wday)) return tIntervalo;
+        return _buscaMinuto(oAlarma.mascaraDias, ALARMA_WILDCARD, ALARMA_WILDCARD, tIntervalo - (tIntervalo % 60) + 60);
+    }
+    return _calculaProximo(idx, tAnterior - (tAnterior % 60) + 60);
+}
+
+/**
+ * @brief Proyecta lo que tocará la torre en los próximos días
+ * 
+ * @details No simula minuto a minuto: recorre el índice de próximos
+ *          disparos. Cada alarma que suena (personalizables y toques de hora y
+ *          media) entra en un montículo con su próximo disparo; se saca el más
+ *          temprano, se anota y se vuelve a meter con el siguiente.
+ *          
+ *          **FILTROS Y MARCAS:**
+ *          - Toques de hora y media: se quitan los de Config::Time::NOCHE_*
+ *          - Excepciones por fecha: OMITIDA, SUSTITUIDA (con su acción) o
+ *            DESPLAZADA (en su hora real)
+ *          - Conflictos: si en el mismo minuto coinciden varios toques, solo
+ *            suena ya el de mayor prioridad (alarma sobre reloj, como en el
+ *            árbitro); los demás se marcan ESPERA: quedan en la cola hasta su
+ *            plazo o los corta el primero
+ *          - Las tareas de sistema sin campanas (NTP, DNS) no aparecen
+ *          
+ *          **FORMATO (compacto):**
+ *          {"desde":epoch,"dias":N,"campos":["t","id","accion","param","marca"],
+ *           "eventos":[[epoch,idWeb,"MISA",param,""],[epoch,-1,"HORA",12,""],...],
+ *           "nombres":{"idWeb":"nombre"},"truncada":false}
+ * 
+ * @param nDias Días a proyectar desde ahora (1..Config::Alarmas::DIAS_AGENDA_MAX)
+ * @return String JSON con los eventos en orden cronológico
+ * 
+ * @note **LÍMITE:** Como mucho Config::Alarmas::MAX_EVENTOS_AGENDA eventos y
+ *       4 × MAX_EVENTOS_AGENDA pasos por el montículo; si se agota cualquiera
+ *       de los dos, "truncada":true
+ * @note **MEMORIA:** Cada minuto se escribe en cuanto se cierra; solo crecen el
+ *       montículo (≤ 24 B por alarma que suena, 12 KB con MAX_ALARMAS) y el texto
+ *       (~30 B por evento: ~18 KB con 600). Pico en un ESP32 de 320 KB: unos
+ *       50 KB sumando las copias de Servidor ("AGENDA:" + ...) y del WebSocket
+ * @note **DURACIÓN:** El árbitro decide con la duración real de cada toque; la
+ *       agenda solo marca coincidencias en el mismo minuto
+ * 
+ * @since v2.2
+ * @author Julian Salas Bartolomé
+ */
+String AlarmScheduler::obtenerAgendaJSON(uint8_t nDias) {
+    if (nDias < 1) nDias = 1;
+    if (nDias > Config::Alarmas::DIAS_AGENDA_MAX) nDias = Config::Alarmas::DIAS_AGENDA_MAX;
+    time_t ahora = Reloj::Epoch();
+    time_t tDesde = ahora - (ahora % 60);
+    time_t tHasta = tDesde + (time_t)nDias * 86400;
+
+    uint32_t aConExcepcion[(MAX_ALARMAS + 31) / 32] = {};                  // Un bit por alarma con alguna excepción
+    for (uint8_t n = 0; n < _nExcepciones; ++n) {
+        uint16_t idx = _buscarIndicePorIdWeb(_aExcepciones[n].idWeb);
+        if (idx < MAX_ALARMAS) aConExcepcion[idx / 32] |= 1UL << (idx % 32);
+    }
+    auto desplazado = [&](uint16_t i, time_t tNominal) -> time_t {             // Hora real con una excepción DESPLAZAR ese día
+        ExcepcionAlarma excepcion;
+        if ((aConExcepcion[i / 32] & (1UL << (i % 32))) &&
+            _buscaExcepcion(_alarmas[i].idWeb, _fechaDe(tNominal), excepcion) && excepcion.tipo == EXCEPCION_DESPLAZAR) {
+            return tNominal + (time_t)excepcion.desplazamientoMin * 60;
+        }
+        return tNominal;
+    };
+
+    std::vector<DisparoAgenda> aHeap;                                      // Solo las alarmas que suenan, no MAX_ALARMAS en la pila de loop()
+    aHeap.reserve(_num);
+    uint8_t aClase[MAX_ALARMAS];
+    for (uint16_t i = 0; i < _num; ++i) {
+        const Alarm &oAlarma = _alarmas[i];
+        aClase[i] = oAlarma.esPersonalizable           ? AGENDA_ALARMA
+                  : oAlarma.accionExt0 == accionTocaHora  ? AGENDA_HORA
+                  : oAlarma.accionExt0 == accionTocaMedia ? AGENDA_MEDIA
+                  : AGENDA_NINGUNA;
+        if (aClase[i] == AGENDA_NINGUNA) continue;
+        bool lExcepciones = aConExcepcion[i / 32] & (1UL << (i % 32));     // Un desplazamiento puede traer uno ya pasado
+        time_t tNominal = _calculaProximo(i, lExcepciones ? tDesde - Config::Alarmas::DESPLAZAMIENTO_MAXIMO_MIN * 60 : tDesde);
+        if (tNominal != 0) aHeap.push_back({ desplazado(i, tNominal), tNominal, i });
+    }
+    uint16_t nHeap = aHeap.size();
+    std::make_heap(aHeap.begin(), aHeap.end(), _posteriorAgenda);
+
+    // El texto se escribe según se cierra cada minuto: sin lista de eventos ni JsonDocument con toda la agenda
+    String resultado;
+    unsigned int nReservado = 0;
+    auto anade = [&](const char* sTexto) {
+        unsigned int nLongitud = resultado.length() + strlen(sTexto);
+        if (nLongitud > nReservado) {                                      // A saltos de 1 KB: pocos realloc mientras crece
+            nReservado = nLongitud + 1024;
+            resultado.reserve(nReservado);
+        }
+        resultado += sTexto;
+    };
+    char sFila[128];                                                        // Fila más larga: ~80 caracteres (acción de ALARMA_TAM_TIPO)
+    snprintf(sFila, sizeof(sFila), "{\"desde\":%lld,\"dias\":%u,\"campos\":[\"t\",\"id\",\"accion\",\"param\",\"marca\"],\"eventos\":[",
+             (long long)tDesde, nDias);
+    anade(sFila);
+
+    std::vector<EventoAgenda> aMinuto;                                      // Toques del minuto en curso, para marcar conflictos
+    aMinuto.reserve(4);
+    uint32_t aNombrada[(MAX_ALARMAS + 31) / 32] = {};                       // Alarmas cuyo nombre va en "nombres"
+    uint16_t nEventos = 0;
+    bool lPrimera = true;
+    JsonDocument fila;                                                      // ArduinoJson escapa los textos de cada fila
+    auto cierraMinuto = [&]() {
+        // Conflictos: en cada minuto suena ya el de mayor prioridad; los demás esperan al árbitro
+        size_t nPrimero = SIZE_MAX;
+        for (size_t k = 0; k < aMinuto.size(); ++k) {
+            const EventoAgenda &e = aMinuto[k];
+            if (e.marca != MARCA_OMITIDA &&
+                (nPrimero == SIZE_MAX || (e.clase == AGENDA_ALARMA && aMinuto[nPrimero].clase != AGENDA_ALARMA))) {
+                nPrimero = k;                                               // PRIO_ALARMA sobre PRIO_RELOJ; a igualdad, el primero
+            }
+        }
+        for (size_t k = 0; k < aMinuto.size(); ++k) {
+            EventoAgenda &e = aMinuto[k];
+            if (k != nPrimero && e.marca != MARCA_OMITIDA) e.marca = MARCA_ESPERA;
+            JsonArray aFila = fila.to<JsonArray>();
+            aFila.add((long long)e.t);
+            aFila.add(e.idWeb);
+            aFila.add(e.accion);
+            aFila.add(e.parametro);
+            aFila.add(NOMBRES_MARCA[e.marca]);
+            serializeJson(fila, sFila, sizeof(sFila));
+            if (!lPrimera) anade(",");
+            anade(sFila);
+            lPrimera = false;
+        }
+        aMinuto.clear();
+    };
+
+    bool lTruncada = false;
+    uint32_t nPasos = 0;
+    while (nHeap > 0 && aHeap[0].tEfectivo < tHasta) {
+        std::pop_heap(aHeap.begin(), aHeap.begin() + nHeap, _posteriorAgenda);
+        DisparoAgenda &disparo = aHeap[nHeap - 1];
+        uint16_t i = disparo.idx;
+        const Alarm &oAlarma = _alarmas[i];
+
+        bool lAnotar = disparo.tEfectivo >= tDesde;
+        EventoAgenda evento = {};
+        evento.t = disparo.tEfectivo;
+        evento.idWeb = (aClase[i] == AGENDA_ALARMA) ? oAlarma.idWeb : -1;
+        evento.clase = aClase[i];
+        if (aClase[i] == AGENDA_ALARMA) {
+            strlcpy(evento.accion, getTipo(i), sizeof(evento.accion));
+            evento.parametro = oAlarma.parametro;
+        } else {
+            struct tm local;
+            localtime_r(&evento.t, &local);
+            evento.parametro = local.tm_hour;
+            strlcpy(evento.accion, (aClase[i] == AGENDA_HORA) ? "HORA" : "MEDIA", sizeof(evento.accion));
+            lAnotar = lAnotar && !(local.tm_hour >= Config::Time::NOCHE_INICIO_HORA ||
+                                   local.tm_hour < Config::Time::NOCHE_FIN_HORA);   // Silencio nocturno, como accionTocaHora()
+        }
+
+        ExcepcionAlarma excepcion;
+        if (lAnotar && (aConExcepcion[i / 32] & (1UL << (i % 32))) &&
+            _buscaExcepcion(oAlarma.idWeb, _fechaDe(disparo.tNominal), excepcion)) {
+            if (excepcion.tipo == EXCEPCION_OMITIR) {
+                evento.marca = MARCA_OMITIDA;
+            } else if (excepcion.tipo == EXCEPCION_SUSTITUIR) {
+                evento.marca = MARCA_SUSTITUIDA;
+                strlcpy(evento.accion, excepcion.accion, sizeof(evento.accion));
+                evento.parametro = excepcion.parametro;
+            } else {
+                evento.marca = MARCA_DESPLAZADA;
+            }
+        }
+
+        if (lAnotar) {
+            if (nEventos >= Config::Alarmas::MAX_EVENTOS_AGENDA) {
+                lTruncada = true;
+                break;
+            }
+            if (!aMinuto.empty() && aMinuto[0].t / 60 != evento.t / 60) cierraMinuto();
+            aMinuto.push_back(evento);
+            if (evento.idWeb >= 0) aNombrada[i / 32] |= 1UL << (i % 32);
+            ++nEventos;
+        }
+
+        time_t tSiguiente = _siguienteAgenda(i, disparo.tNominal);
+        if (tSiguiente <= disparo.tNominal) {
+            --nHeap;                                                        // Sin más disparos
+        } else if (++nPasos >= 4UL * Config::Alarmas::MAX_EVENTOS_AGENDA) {
+            lTruncada = true;                                               // Presupuesto de pasos agotado: lo que queda no se ha mirado
+            break;
+        } else {
+            disparo = { desplazado(i, tSiguiente), tSiguiente, i };
+            std::push_heap(aHeap.begin(), aHeap.begin() + nHeap, _posteriorAgenda);
+        }
+    }
+    cierraMinuto();
+
+    anade("],\"nombres\":{");
+    lPrimera = true;
+    for (uint16_t i = 0; i < _num; ++i) {
+        if (!(aNombrada[i / 32] & (1UL << (i % 32)))) continue;
+        char sId[8];
+        snprintf(sId, sizeof(sId), "%d", _alarmas[i].idWeb);
+        JsonObject oNombre = fila.to<JsonObject>();
+        oNombre[sId] = getNombre(i);
+        String sNombre;
+        serializeJson(fila, sNombre);                                       // {"id":"nombre"}: se copia sin las llaves
+        if (!lPrimera) anade(",");
+        anade(sNombre.substring(1, sNombre.length() - 1).c_str());
+        lPrimera = false;
+    }
+    anade(lTruncada ? "},\"truncada\":true}" : "},\"truncada\":false}");
+
+    DBG_ALM_PRINTF("📅 Agenda de %u días: %u eventos (%u chars)", nDias, nEventos, resultado.length());
+    return resultado;
+}
+
+/**
+ * @brief Segundos que faltan para el próximo disparo de alguna alarma
+ * 
+ * @details Consulta la raíz del índice de próximos disparos sin recorrer las
+ *          alarmas. loop() lo usa para no lanzar comprobaciones de red que
+ *          pueden bloquear (TestInternet, OTA) justo antes de un toque.
+ * 
+ * @return Segundos hasta el próximo disparo (0 si ya vence), o -1 si no hay
+ *         ninguna alarma programada o el índice aún no se ha construido
+ * 
+ * @note Las ediciones pendientes de recalcular no se reflejan hasta el siguiente check()
+ * @note loop() no duerme hasta el próximo disparo: sigue girando por las
+ *       secuencias, el árbitro y la cola de órdenes. Este valor solo aplaza
+ *       TestInternet() y OTA.checkAutoUpdate()
+ * 
+ * @since v2.2
+ * @author Julian Salas Bartolomé
+ */
+int32_t AlarmScheduler::segundosHastaProximo() const {
+    if (!_lIndiceValido || _nHeap == 0) return -1;
+    time_t ahora = Reloj::Epoch();
+    time_t proximo = _aProximo[_aHeap[0]];
+    return (proximo > ahora) ? (int32_t)(proximo - ahora) : 0;
+}
+
+/**
+ * @brief Busca el primer minuto local que cumple día, hora y minuto
+ * 
+ * @details Recorre como mucho ocho días desde tDesde. En cada día permitido por
+ *          la máscara prueba solo las horas y minutos candidatos (uno si son
+ *          fijos, el rango restante si son ALARMA_WILDCARD) y convierte con
+ *          EpochLocal() para respetar la zona horaria y el horario de verano.
+ * 
+ * @param mascaraDias Máscara DOW_* de días permitidos
+ * @param hora Hora 0-23 o ALARMA_WILDCARD
+ * @param minuto Minuto 0-59 o ALARMA_WILDCARD
+ * @param tDesde Epoch de inicio de la búsqueda, alineado a minuto (incluido)
+ * @return Epoch del primer minuto que cumple, o 0 si no hay ninguno
+ * 
+ * @note **CAMBIO DE HORA:** Horas repetidas o inexistentes según Config::Alarmas::HORA_AMBIGUA
+ *       y HORA_INEXISTENTE (ver HoraLocal.h)
+ * 
+ * @since v2.2
+ * @author Julian Salas Bartolomé
+ */
+time_t AlarmScheduler::_buscaMinuto(uint8_t mascaraDias, uint8_t hora, uint8_t minuto, time_t tDesde) {
+    struct tm base;
+    localtime_r(&tDesde, &base);
+    for (int d = 0; d <= 7; ++d) {
+        struct tm dia = base;
+        if (d > 0) {
+            dia.tm_mday += d;
+            dia.tm_hour = 0;
+            dia.tm_min = 0;
+        }
+        dia.tm_sec = 0;
+        dia.tm_isdst = -1;
+        if (mktime(&dia) == (time_t)-1) continue;                                                           // Normaliza fecha y calcula tm_wday
+        if (!(mascaraDias & mascaraDesdeDiaSemana(dia.tm_wday))) continue;
+
+        int hIni = (hora == ALARMA_WILDCARD) ? dia.tm_hour : hora;
+        int hFin = (hora == ALARMA_WILDCARD) ? 23 : hora;
+        for (int h = hIni; h <= hFin; ++h) {
+            if (h < dia.tm_hour) continue;
+            int mDesde = (h == dia.tm_hour) ? dia.tm_min : 0;
+            int m = (minuto == ALARMA_WILDCARD) ? mDesde : minuto;
+            if (m < mDesde) continue;
+            struct tm candidato = dia;
+            candidato.tm_hour = h;
+            candidato.tm_min = m;
+            time_t tCandidato = EpochLocal(candidato, tDesde);
+            if (tCandidato != (time_t)-1) return tCandidato;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Calcula el próximo disparo de una alarma a partir de un instante
+ * 
+ * @details **REGLAS:**
+ *          - Deshabilitada o sin días: sin disparo (0)
+ *          - Intervalo ya iniciado: ultimaEjecucion + intervalo, o el primer
+ *            minuto de un día permitido si ese instante cae fuera de la máscara
+ *          - Horario fijo, wildcard o intervalo sin iniciar: primer minuto que
+ *            cumple hora, minuto y día desde tDesde
+ * 
+ * @param idx Índice de la alarma
+ * @param tDesde Epoch alineado a minuto desde el que buscar (incluido)
+ * @return Epoch del próximo disparo, o 0 si no hay
+ * 
+ * @since v2.2
+ * @author Julian Salas Bartolomé
+ */
+time_t AlarmScheduler::_calculaProximo(uint16_t idx, time_t tDesde) const {
+    const Alarm &oAlarma = _alarmas[idx];
+    if (!oAlarma.habilitada) return 0;
+    if (oAlarma.esCron) return SiguienteCron(oAlarma.cron, tDesde);
+    if (oAlarma.fiesta != FIESTA_NINGUNA) {
+        return Calendario.Siguiente((FiestaLiturgica)oAlarma.fiesta, oAlarma.desplazamientoDias,
+                                    oAlarma.hora, oAlarma.minuto, tDesde);
+    }
+    if (!(oAlarma.mascaraDias & DOW_TODOS)) return 0;
+
+    if (oAlarma.intervaloMin > 0 && oAlarma.ultimaEjecucion != 0) {
+        time_t tIntervalo = oAlarma.ultimaEjecucion + (time_t)oAlarma.intervaloMin * 60;
+        if (tIntervalo < tDesde) tIntervalo = tDesde;
+        struct tm info;
+        localtime_r(&tIntervalo, &info);
+        if (oAlarma.mascaraDias & mascaraDesdeDiaSemana(info.tm_wday)) return tIntervalo;
+        return _buscaMinuto(oAlarma.mascaraDias, ALARMA_WILDCARD, ALARMA_WILDCARD, tIntervalo - (tIntervalo % 60) + 60);
+    }
+    return _buscaMinuto(oAlarma.mascaraDias, oAlarma.hora, oAlarma.minuto, tDesde);
+}
+
+/**
+ * @brief Reconstruye el índice completo de próximos disparos
+ * 
+ * @details Se usa al arrancar, tras cambios que desplazan índices (eliminar,
+ *          cargar, clear) y si el reloj retrocede. Con MAX_ALARMAS alarmas es
+ *          un coste puntual; el resto de checks solo consultan la raíz.
+ * 
+ * @param tDesde Epoch alineado a minuto desde el que calcular
+ * 
+ * @since v2.2
+ * @author Julian Salas Bartolomé
+ */
+void AlarmScheduler::_reconstruyeIndice(time_t tDesde) {
+    memset(_aPendientes, 0, sizeof(_aPendientes));
+    _nHeap = 0;
+    _preparaDia(tDesde);                                                                                    // Bitmap de excepciones de hoy
+    for (uint16_t i = 0; i < MAX_ALARMAS; ++i) {
+        _aPosHeap[i] = NO_EN_INDICE;
+        _aProximo[i] = 0;
+    }
+    _lIndiceValido = true;
+    for (uint16_t i = 0; i < _num; ++i) {
+        _actualizaIndice(i, tDesde);
+    }
+    DBG_ALM_PRINTF("[ALARM] Índice reconstruido: %u alarmas programadas\n", _nHeap);
+}
+
+/**
+ * @brief Recalcula el próximo disparo de una sola alarma y la recoloca
+ * 
+ * @param idx Índice de la alarma
+ * @param tDesde Epoch alineado a minuto desde el que calcular
+ * 
+ * @warning **LOOP:** Solo desde check(); las ediciones usan _marcaPendiente()
+ * 
+ * @since v2.2
+ * @author Julian Salas Bartolomé
+ */
+void AlarmScheduler::_actualizaIndice(uint16_t idx, time_t tDesde) {
+    if (!_lIndiceValido || idx >= _num) return;
+
+    uint16_t pos = _aPosHeap[idx];
+    if (pos != NO_EN_INDICE) {                                                                              // Sacar del montículo
+        uint16_t ultimo = _aHeap[--_nHeap];
+        _aPosHeap[idx] = NO_EN_INDICE;
+        if (pos < _nHeap) {
+            _aHeap[pos] = ultimo;
+            _aPosHeap[ultimo] = pos;
+            _subeHeap(pos);
+            _bajaHeap(_aPosHeap[ultimo]);
+        }
+    }
+
+    _aProximo[idx] = _excepcionHoy(idx) ? _proximoConExcepcion(idx, tDesde) : _calculaProximo(idx, tDesde);
+    if (_aProximo[idx] != 0) {                                                                              // Volver a meter con su nuevo disparo
+        _aHeap[_nHeap] = idx;
+        _aPosHeap[idx] = _nHeap;
+        _subeHeap(_nHeap++);
+    }
+}
+
+/**
+ * @brief Marca una alarma editada para recalcularla en el próximo check()
+ * 
+ * @details Las ediciones se aplican desde loop() (órdenes de ColaComandos)
+ *          entre dos check(); aquí basta con activar el bit de la alarma.
+ * 
+ * @param idx Índice de la alarma editada
+ * 
+ * @since v2.2
+ * @author Julian Salas Bartolomé
+ */
+void AlarmScheduler::_marcaPendiente(uint16_t idx) {
+    if (idx < MAX_ALARMAS) {
+        _aPendientes[idx / 32] |= 1UL << (idx % 32);
+    }
+}
+
+/**
+ * @brief Fuerza la reconstrucción completa del índice en el próximo check()
+ * 
+ * @since v2.2
+ * @author Julian Salas Bartolomé
+ */
+void AlarmScheduler::_invalidaIndice() {
+    _lIndiceValido = false;
+}
+
+/**
+ * @brief Indica si alguna alarma editada espera a ser recalculada
+ * 
+ * @since v2.2
+ * @author Julian Salas Bartolomé
+ */
+bool AlarmScheduler::_hayPendientes() const {
+    for (uint8_t p = 0; p < PALABRAS_PENDIENTES; ++p) {
+        if (_aPendientes[p] != 0) return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Sube una entrada del montículo hasta su sitio
+ * 
+ * @param pos Posición en _aHeap
+ * 
+ * @since v2.2
+ * @author Julian Salas Bartolomé
+ */
+void AlarmScheduler::_subeHeap(uint16_t pos) {
+    while (pos > 0) {
+        uint16_t padre = (pos - 1) / 2;
+        if (_aProximo[_aHeap[padre]] <= _aProximo[_aHeap[pos]]) break;
+        uint16_t tmp = _aHeap[padre];
+        _aHeap[padre] = _aHeap[pos];
+        _aHeap[pos] = tmp;
+        _aPosHeap[_aHeap[padre]] = padre;
+        _aPosHeap[_aHeap[pos]] = pos;
+        pos = padre;
+    }
+}
+
+/**
+ * @brief Baja una entrada del montículo hasta su sitio
+ * 
+ * @param pos Posición en _aHeap
+ * 
+ * @since v2.2
+ * @author Julian Salas Bartolomé
+ */
+void AlarmScheduler::_bajaHeap(uint16_t pos) {
+    for (;;) {
+        uint16_t menor = pos;
+        uint16_t izq = 2 * pos + 1;
+        uint16_t der = izq + 1;
+        if (izq < _nHeap && _aProximo[_aHeap[izq]] < _aProximo[_aHeap[menor]]) menor = izq;
+        if (der < _nHeap && _aProximo[_aHeap[der]] < _aProximo[_aHeap[menor]]) menor = der;
+        if (menor == pos) break;
+        uint16_t tmp = _aHeap[menor];
+        _aHeap[menor] = _aHeap[pos];
+        _aHeap[pos] = tmp;
+        _aPosHeap[_aHeap[menor]] = menor;
+        _aPosHeap[_aHeap[pos]] = pos;
+        pos = menor;
+    }
+}
+
+/**
+ * @brief Asigna (o quita) la expresión cron de una alarma
+ * 
+ * @details Compila la expresión antes de tocar la alarma, de modo que una
+ *          expresión no válida no deja la alarma a medio modificar.
+ * 
+ * @param alarma Alarma a modificar
+ * @param cron Expresión de 5 campos; nullptr o "" deja la alarma con día/hora/minuto
+ * @return true si se asignó, false si la expresión no es válida
+ * 
+ * @since v2.2
+ * @author Julian Salas Bartolomé
+ */
+bool AlarmScheduler::_asignaCron(Alarm& alarma, const char* cron) {
+    if (cron == nullptr || cron[0] == '\0') {
+        alarma.esCron = false;
+        return true;
+    }
+    CronAlarma compilada;
+    if (!CompilaCron(cron, compilada)) return false;
+    alarma.esCron = true;
+    alarma.cron = compilada;
+    return true;
+}
+
+/**
+ * @brief Guarda los textos web de una alarma en su bloque de la tabla aparte
+ * 
+ * @details Reserva un único bloque con "nombre\0descripcion\0tipo\0cron\0"
+ *          del tamaño justo, truncando cada texto a su límite de siempre
+ *          (ALARMA_TAM_*, CRON_MAX_TEXTO). El bloque anterior se libera.
+ * 
+ * @param idx Índice de la alarma
+ * @return false si no hay memoria (la alarma conserva sus textos anteriores)
+ * 
+ * @since v2.2
+ * @author Julian Salas Bartolomé
+ */
+bool AlarmScheduler::_asignaTextos(uint16_t idx, const char* nombre, const char* descripcion,
+                                   const char* tipo, const char* cron) {
+    const char* aTextos[4] = { nombre, descripcion, tipo, cron };
+    const size_t aLimites[4] = { ALARMA_TAM_NOMBRE, ALARMA_TAM_DESCRIPCION, ALARMA_TAM_TIPO, CRON_MAX_TEXTO };
+    size_t aLong[4];
+    size_t nTotal = 0;
+    for (uint8_t c = 0; c < 4; ++c) {
+        aLong[c] = aTextos[c] ? strnlen(aTextos[c], aLimites[c] - 1) : 0;
+        nTotal += aLong[c] + 1;
+    }
+
+    char* pBloque = (char*)malloc(nTotal);
+    if (pBloque == nullptr) {
+        DBG_ALM("❌ Error: Sin memoria para los textos de la alarma");
+        return false;
+    }
+    char* p = pBloque;
+    for (uint8_t c = 0; c < 4; ++c) {
+        if (aLong[c]) memcpy(p, aTextos[c], aLong[c]);
+        p[aLong[c]] = '\0';
+        p += aLong[c] + 1;
+    }
+
+    free(_aTextos[idx]);
+    _aTextos[idx] = pBloque;
+    return true;
+}
+
+/**
+ * @brief Libera el bloque de textos de una alarma
+ * 
+ * @since v2.2
+ * @author Julian Salas Bartolomé
+ */
+void AlarmScheduler::_liberaTextos(uint16_t idx) {
+    free(_aTextos[idx]);
+    _aTextos[idx] = nullptr;
+}
+
+/**
+ * @brief Devuelve un texto del bloque de una alarma
+ * 
+ * @param idx Índice de la alarma
+ * @param campo 0 = nombre, 1 = descripción, 2 = tipo, 3 = cron
+ * @return Puntero al texto, o nullptr si la alarma no tiene bloque
+ * 
+ * @since v2.2
+ * @author Julian Salas Bartolomé
+ */
+const char* AlarmScheduler::_texto(uint16_t idx, uint8_t campo) const {
+    if (idx >= _num || _aTextos[idx] == nullptr) return nullptr;
+    const char* p = _aTextos[idx];
+    for (uint8_t c = 0; c < campo; ++c) {
+        p += strlen(p) + 1;
+    }
+    return p;
+}
+
+const char* AlarmScheduler::getNombre(uint16_t idx) const {
+    const char* p = _texto(idx, 0);
+    return p ? p : "";
+}
+
+const char* AlarmScheduler::getDescripcion(uint16_t idx) const {
+    const char* p = _texto(idx, 1);
+    return p ? p : "";
+}
+
+const char* AlarmScheduler::getTipo(uint16_t idx) const {
+    const char* p = _texto(idx, 2);
+    return p ? p : "SISTEMA";
+}
+
+const char* AlarmScheduler::getCron(uint16_t idx) const {
+    const char* p = _texto(idx, 3);
+    return p ? p : "";
+}
+
+/**
+ * @brief Deshabilita una alarma específica sin eliminarla del sistema
+ * 
+ * @details Marca una alarma como inactiva temporalmente, manteniéndola en
+ *          el array pero evitando que se ejecute durante las verificaciones.
+ *          Útil para desactivación temporal sin perder la configuración.
+ * 
+ * @param idx Índice de la alarma a deshabilitar (0-15)
+ * 
+ * @note La alarma permanece en memoria con su configuración intacta
+ * @note Puede ser reactivada posteriormente con enable()
+ * @note Índices inválidos son ignorados silenciosamente
+ * 
+ * @see enable() - Para reactivar la alarma
+ * @see get() - Para verificar estado de una alarma
+ * 
+ * @since v1.0
+ * @author Julian Salas Bartolomé
+ */
+void AlarmScheduler::disable(uint16_t idx) { 
+    if (idx < _num) {
+        _alarmas[idx].habilitada = false;
+        _marcaPendiente(idx);
+        DBG_ALM_PRINTF("[ALARM] Alarma idx=%u deshabilitada\n", idx);
+    }
+}
+
+/**
+ * @brief Habilita una alarma específica previamente deshabilitada
+ * 
+ * @details Marca una alarma como activa para que sea considerada durante
+ *          las verificaciones de check(). Útil para reactivar alarmas
+ *          temporalmente deshabilitadas.
+ * 
+ * @param idx Índice de la alarma a habilitar (0-15)
+ * 
+ * @note La alarma debe existir en el array para ser habilitada
+ * @note Índices inválidos son ignorados silenciosamente
+ * @note No resetea el cache temporal (ultimaEjecucion, etc.)
+ * 
+ * @see disable() - Para desactivar la alarma
+ * @see get() - Para verificar estado de una alarma
+ * 
+ * @since v1.0
+ * @author Julian Salas Bartolomé
+ */
+void AlarmScheduler::enable(uint16_t idx) { 
+    if (idx < _num) {
+        _alarmas[idx].habilitada = true;
+        _marcaPendiente(idx);
+        DBG_ALM_PRINTF("[ALARM] Alarma idx=%u habilitada\n", idx);
+    }
+}
+
+/**
+ * @brief Elimina todas las alarmas del sistema
+ * 
+ * @details Resetea completamente el array de alarmas, eliminando todas
+ *          las configuraciones programadas y liberando espacio para
+ *          nuevas alarmas.
+ * 
+ * @note No libera memoria (array es estático), solo resetea contador
+ * @note Todas las alarmas se pierden irreversiblemente
+ * @note Llamada automáticamente por begin()
+ * 
+ * @see begin() - Función que llama automáticamente a clear()
+ * @see count() - Para verificar número de alarmas antes de limpiar
+ * 
+ * @since v1.0
+ * @author Julian Salas Bartolomé
+ */
+void AlarmScheduler::clear() { 
+    for (uint16_t i = 0; i < _num; ++i) {
+        _liberaTextos(i);
+    }
+    _num = 0; 
+    _invalidaIndice();
+    DBG_ALM_PRINTF("[ALARM] Todas las alarmas eliminadas\n");
+}
+
+/**
+ * @brief Obtiene el número actual de alarmas configuradas
+ * 
+ * @details Retorna la cantidad de alarmas actualmente registradas
+ *          en el sistema, tanto habilitadas como deshabilitadas.
+ * 
+ * @return Número de alarmas configuradas (0-MAX_ALARMAS)
+ * 
+ * @note Incluye alarmas habilitadas y deshabilitadas
+ * @note Máximo posible es MAX_ALARMAS (128)
+ * @note Útil para verificar espacio disponible antes de añadir nuevas
+ * 
+ * @see MAX_ALARMAS - Constante con límite máximo
+ * @see add(), addExternal(), addExternal0() - Funciones que incrementan este valor
+ * 
+ * @since v1.0
+ * @author Julian Salas Bartolomé
+ */
+uint16_t AlarmScheduler::count() const { 
+    return _num; 
+}
+
+/**
+ * @brief Obtiene acceso de solo lectura a una alarma específica
+ * 
+ * @details Proporciona acceso de solo lectura a la configuración de una
+ *          alarma específica para inspección o debug. No permite modificación
+ *          directa de los datos.
+ * 
+ * @param idx Índice de la alarma a consultar (0-15)
+ * @return Puntero constante a la alarma o nullptr si índice inválido
+ * 
+ * @note Retorna nullptr para índices fuera de rango
+ * @note Solo permite lectura, no modificación de la alarma
+ * @note Útil para debug e inspección de configuración
+ * 
+ * @see count() - Para verificar rango válido de índices
+ * @see struct Alarm - Estructura de datos retornada
+ * 
+ * @example
+ * @code
+ * const Alarm* alarma = scheduler.get(0);
+ * if (alarma) {
+ *     Serial.printf("Alarma 0: %02u:%02u, habilitada=%u\n", 
+ *                   alarma->hora, alarma->minuto, alarma->habilitada);
+ * }
+ * @endcode
+ * 
+ * @since v1.0
+ * @author Julian Salas Bartolomé
+ */
+const Alarm* AlarmScheduler::get(uint16_t idx) const { 
+    return (idx < _num) ? &_alarmas[idx] : nullptr; 
+}
+
+/**
+ * @brief Obtiene acceso mutable a una alarma específica por índice
+ * 
+ * @details Devuelve puntero no-const para permitir modificar alarmas existentes.
+ *          Útil para restaurar callbacks después de cargar desde JSON.
+ * 
+ * @param idx Índice de la alarma (0 a count()-1)
+ * @return Alarm* Puntero a la alarma o nullptr si índice inválido
+ * 
+ * @warning Usar con precaución - permite modificar alarmas directamente
+ */
+Alarm* AlarmScheduler::getMutable(uint16_t idx) { 
+    if (idx >= _num) return nullptr;
+    _marcaPendiente(idx);                                                   // El llamador puede cambiar su horario
+    return &_alarmas[idx];
+}
+
+/**
+ * @brief Determina si la hora actual está en horario nocturno
+ * 
+ * @details Evalúa si la hora actual del sistema está dentro del rango
+ *          considerado como horario nocturno según la configuración del
+ *          proyecto. Maneja correctamente el cambio de día.
+ * 
+ * @return true si está en horario nocturno, false en caso contrario
+ * 
+ * @note Horario nocturno típico: 22:00 - 07:00 (configurable)
+ * @note Utiliza t.tm_hour (debe llamarse después de getLocalTime())
+ * @note Maneja correctamente el cambio de día (ej: 23:00 - 06:00)
+ * 
+ * @warning Requiere llamada previa a getLocalTime() para actualizar t
+ * 
+ * @see Config::Time::NOCHE_INICIO_HORA - Hora de inicio de la noche
+ * @see Config::Time::NOCHE_FIN_HORA - Hora de fin de la noche
+ * @see check() - Función que actualiza t.tm_hour
+ * 
+ * @since v2.0
+ * @author Julian Salas Bartolomé
+ */
+bool AlarmScheduler::esHorarioNocturno() const {
+    return (t.tm_hour >= Config::Time::NOCHE_INICIO_HORA || 
+            t.tm_hour < Config::Time::NOCHE_FIN_HORA);
+}
+
+// ============================================================================
+// IMPLEMENTACIÓN DE MÉTODOS PRIVADOS
+// ============================================================================
+
+/**
+ * @brief Convierte día de la semana (0-6) a máscara de bits
+ * 
+ * @details Función utilitaria estática que convierte el día de la semana
+ *          del sistema (donde 0=Domingo, 1=Lunes, ..., 6=Sábado) a una
+ *          máscara de bits compatible con el sistema de alarmas.
+ * 
+ * @param diaSemana Día de la semana (0=Domingo, 1=Lunes, ..., 6=Sábado)
+ * @return Máscara de bits correspondiente (bit 0=Domingo, bit 1=Lunes, etc.)
+ *         o 0 si el día está fuera del rango válido
+ * 
+ * @note Utilizada internamente por check() para comparar con mascaraDias
+ * @note Convierte formato tm_wday a formato DOW_* del sistema
+ * @note Función estática - no requiere instancia de la clase
+ * 
+ * @see DOW_DOMINGO, DOW_LUNES, etc. - Constantes de días definidas
+ * @see struct tm - Estructura que contiene tm_wday
+ * @see check() - Función que utiliza esta conversión
+ * 
+ * @since v2.0
+ * @author Julian Salas Bartolomé
+ */
+uint8_t AlarmScheduler::mascaraDesdeDiaSemana(int diaSemana) {
+    return (diaSemana >= 0 && diaSemana <= 6) ? (1 << diaSemana) : 0;
+}
+
+/**
+ * @brief Resetea el cache temporal de todas las alarmas
+ * 
+ * @details Función utilitaria que limpia el cache de prevención de duplicados
+ *          de todas las alarmas registradas. Útil después de cambios de hora
+ *          del sistema, reinicializaciones o cuando se detectan problemas
+ *          de ejecución de alarmas.
+ *          
+ *          **VARIABLES RESETEADAS:**
+ *          - ultimaEjecucion: Se establece a 0 (timestamp inicial)
+ *          
+ *          Esto permite que las alarmas se ejecuten nuevamente sin esperar
+ *          al cambio natural de día o configuración temporal.
+ * 
+ * @note **USO TÍPICO:** Después de sincronización NTP o ajustes de sistema
+ * @note **EFECTO:** Permite re-ejecución inmediata de alarmas en el minuto actual
+ * @note **SEGURIDAD:** No afecta configuración de alarmas, solo cache temporal
+ * @note **DEBUG:** Util para depuración de problemas de ejecución de alarmas
+ * 
+ * @warning **DUPLICADOS:** Puede causar ejecución múltiple si se llama repetidamente
+ * @warning **USO MODERADO:** Solo llamar cuando sea realmente necesario
+ * 
+ * @see check() - Función que utiliza el cache para prevenir duplicados
+ * @see ultimaEjecucion - Variable afectada
+ * @see begin() - Inicialización que resetea automáticamente el cache
+ * 
+ * @example
+ * @code
+ * // Después de sincronización manual
+ * if (RTC::beginConMultiplesServidores()) {
+ *     Alarmas.resetCache();  // Permitir nuevas ejecuciones
+ * }
+ * 
+ * // Para debug de alarmas que no se ejecutan
+ * Alarmas.resetCache();
+ * Serial.println("Cache de alarmas reseteado para debug");
+ * @endcode
+ * 
+ * @since v2.1 - Función añadida para depuración y mantenimiento
+ * @author Julian Salas Bartolomé
+ */
+void AlarmScheduler::resetCache() {
+    for (uint16_t i = 0; i < _num; ++i) {
+        _alarmas[i].ultimaEjecucion = 0;
+    }
+    _invalidaIndice();
+    DBG_ALM_PRINTF("[ALARM] Cache de %u alarmas reseteado\n", _num);
+}
+
+
+/**
+ * @brief Carga configuración de alarmas predeterminadas del sistema
+ * 
+ * @details Función privada que configura un conjunto básico de alarmas
+ *          necesarias para el funcionamiento estándar del campanario.
+ *          Incluye misas dominicales, toques de horas y tareas de mantenimiento.
+ *          
+ *          **ALARMAS PREDETERMINADAS:**
+ *          - Misas dominicales a las 11:05 y 11:25
+ *          - Toques de horas en punto (wildcard para todas las horas)
+ *          - Toques de medias horas (:30)
+ *          - Sincronización NTP diaria (12:02)
+ *          - Actualización DNS (12:05)
+ * 
+ * @note Llamada automáticamente por begin() si cargarPorDefecto == true
+ * @note Todas las alarmas se crean habilitadas por defecto
+ * @note Utiliza funciones de Acciones.h para las implementaciones
+ * 
+ * @see begin() - Función que llama a initDefaults()
+ * @see Acciones.h - Funciones utilizadas (accionSecuencia, accionTocaHora, etc.)
+ * @see Config::States::MISA - Constante para secuencias de misa
+ * 
+ * @since v1.0 - Configuración básica
+ * @since v2.0 - Añadidas funciones de mantenimiento (NTP, DNS)
+ * 
+ * @author Julian Salas Bartolomé
+ */
+void AlarmScheduler::initDefaults() {
+    DBG_ALM_PRINTF("[ALARM] Cargando configuración por defecto...\n");
+    
+    // ===== MISAS DOMINICALES =====
+    //addExternal(DOW_DOMINGO, 11, 5,  0, accionSecuencia, Config::States::MISA, true);
+    //addExternal(DOW_DOMINGO, 11, 25, 0, accionSecuencia, Config::States::MISA, true);
+
+    // ===== CUARTOS Y MEDIAS (FUNCIONALIDAD MIGRADA DE TIMEMANAGER) =====
+    // Tocar horas en punto (wildcards = todas las horas)
+    addExternal0(DOW_TODOS, ALARMA_WILDCARD, 0, 0, accionTocaHora, true);
+    
+    // Tocar medias horas
+    addExternal0(DOW_TODOS, ALARMA_WILDCARD, 30, 0, accionTocaMedia, true);
+
+    // ===== FUNCIONES DE MANTENIMIENTO DEL SISTEMA =====
+    // Sincronización NTP al mediodía
+    addExternal0(DOW_TODOS, 12, 2, 0, SincronizaNTP, true);
+    
+    // Actualización DNS dinámica
+    addExternal0(DOW_TODOS, 12, 5, 0, ActualizaDNSSiNecesario, true);
+
+    DBG_ALM_PRINTF("[ALARM] Configuración por defecto cargada: %u alarmas\n", _num);
+}
+
+// ============================================================================
+// IMPLEMENTACIÓN DE GESTIÓN WEB DE ALARMAS PERSONALIZABLES
+// ============================================================================
+/**
+ * @brief Añade una nueva alarma personalizable editable vía web
+ * 
+ * @details Crea una alarma completamente configurable desde la interfaz web
+ *          con persistencia en JSON y callback proporcionado externamente.
+ *          La alarma se marca como personalizable y recibe un ID único para 
+ *          gestión web independiente del índice del array.
+ *          
+ *          **PROCESO DE CREACIÓN:**
+ *          1. Verifica espacio disponible en array de alarmas
+ *          2. Crea nueva estructura Alarm con datos proporcionados
+ *          3. Configura callback externo (debe ser válido)
+ *          4. Asigna ID web único incremental
+ *          5. Marca alarma como personalizable (esPersonalizable = true)
+ *          6. Guarda automáticamente en JSON para persistencia
+ *          7. Incrementa contador de alarmas y retorna índice
+ * 
+ * @param nombre Nombre descriptivo de la alarma (máx 49 caracteres)
+ * @param descripcion Descripción opcional de la alarma (máx 99 caracteres)
+ * @param mascaraDias Máscara de bits para días de la semana (DOW_DOMINGO, DOW_LUNES, etc.)
+ * @param hora Hora de ejecución (0-23)
+ * @param minuto Minuto de ejecución (0-59)
+ * @param tipoString Tipo de acción como string libre: "MISA", "DIFUNTOS", "FIESTA", etc.
+ * @param parametro Parámetro uint16_t a pasar al callback durante ejecución
+ * @param callback Puntero a función externa que se ejecutará: void (*func)(uint16_t)
+ * @param habilitada Estado inicial de la alarma (true por defecto)
+ * @param cron Expresión cron opcional; si no es nullptr ni "" sustituye a mascaraDias/hora/minuto
+ * @param fiesta FiestaLiturgica de referencia; si no es FIESTA_NINGUNA sustituye a mascaraDias
+ * @param desplazamientoDias Días desde la fiesta (p.ej. PASCUA +60 = Corpus)
+ * @param recuperacion RecuperacionAlarma si el disparo se pierde por un corte (RECUP_TARDE por defecto)
+ * @param margenRecuperacionMin Retraso máximo en minutos con RECUP_TARDE
+ * 
+ * @retval uint16_t Índice de la alarma en el array (0 a MAX_ALARMAS-1) si creación exitosa
+ * @retval MAX_ALARMAS Si no hay espacio disponible, error en parámetros o expresión cron no válida
+ * 
+ * @note **CALLBACK EXTERNO:** El callback debe ser proporcionado desde código externo
+ * @note **ID WEB ÚNICO:** Cada alarma recibe ID incremental para gestión web
+ * @note **PERSISTENCIA:** Se guarda automáticamente en JSON tras la creación
+ * @note **GENÉRICO:** Esta función no interpreta tipos - es completamente genérica
+ * @note **TRUNCAMIENTO:** Los strings se truncan silenciosamente si exceden límites
+ * 
+ * @warning **LÍMITE GLOBAL:** Máximo MAX_ALARMAS alarmas simultáneas (incluye sistema)
+ * @warning **CALLBACK VÁLIDO:** El puntero de función debe ser válido y persistente
+ * @warning **THREAD SAFETY:** No es thread-safe, usar desde hilo principal únicamente
+ * @warning **SPIFFS REQUERIDO:** Requiere sistema de archivos montado para persistencia
+ * 
+ * @see modificarPersonalizable() - Para editar alarma existente
+ * @see eliminarPersonalizable() - Para eliminar alarma
+ * @see habilitarPersonalizable() - Para cambiar estado
+ * @see guardarPersonalizablesEnJSON() - Función de persistencia utilizada
+ * 
+ * @example
+ * @code
+ * // Crear misa dominical desde código externo (ej: Servidor.cpp)
+ * uint16_t idx = Alarmas.addPersonalizable(
+ *     "Misa Domingo",           // nombre
+ *     "Primera llamada",        // descripcion  
+ *     DOW_DOMINGO,              // solo domingos
+ *     11, 5,                    // 11:05
+ *     "MISA",                   // tipo
+ *     Config::States::MISA,     // parámetro
+ *     accionSecuencia,          // callback
+ *     true                      // habilitada
+ * );
+ * 
+ * if (idx < MAX_ALARMAS) {
+ *     Serial.println("Alarma creada exitosamente");
+ * } else {
+ *     Serial.println("Error: No hay espacio para más alarmas");
+ * }
+ * @endcode
+ * 
+ * @since v2.1 - Sistema de alarmas personalizables vía web
+ * @author Julian Salas Bartolomé
+ */
+uint16_t AlarmScheduler::addPersonalizable(const char* nombre, const char* descripcion,
+                                          uint8_t mascaraDias, uint8_t hora, uint8_t minuto,
+                                          const char* tipoString, uint16_t parametro,
+                                          void (*callback)(uint16_t), bool habilitada,
+                                          const char* cron, uint8_t fiesta, int16_t desplazamientoDias,
+                                          uint8_t recuperacion, uint8_t margenRecuperacionMin) {
+    DBG_ALM("🔔 Añadiendo alarma personalizable");
+    DBG_ALM_PRINTF("  Nombre: %s", nombre);
+    DBG_ALM_PRINTF("  Tipo: %s", tipoString);
+    DBG_ALM_PRINTF("  Horario: %s %02d:%02d", 
+                   mascaraDias == DOW_TODOS ? "Diario" : "Específico", hora, minuto);
+    
+    if (_num >= MAX_ALARMAS) {
+        DBG_ALM("❌ Error: Máximo de alarmas alcanzado");
+        return MAX_ALARMAS;
+    }
+    
+    // Crear nueva alarma
+    Alarm& alarma = _alarmas[_num];
+    if (!_asignaCron(alarma, cron)) {
+        DBG_ALM_PRINTF("❌ Error: Expresión cron no válida: %s", cron);
+        return MAX_ALARMAS;
+    }
+    if (!_asignaTextos(_num, nombre, descripcion, tipoString, cron)) {     // Campos web, en la tabla de textos
+        return MAX_ALARMAS;
+    }
+    alarma.habilitada = habilitada;
+    alarma.mascaraDias = mascaraDias;
+    alarma.hora = hora;
+    alarma.minuto = minuto;
+    alarma.intervaloMin = 0;  // Las personalizables no usan intervalo
+    alarma.fiesta = (fiesta < NUM_FIESTAS) ? fiesta : FIESTA_NINGUNA;
+    alarma.desplazamientoDias = desplazamientoDias;
+    alarma.recuperacion = (recuperacion <= RECUP_ULTIMA) ? recuperacion : RECUP_TARDE;
+    alarma.margenRecuperacionMin = margenRecuperacionMin;
+    alarma.parametro = parametro;
+    
+    // Asignar callback (ya viene como parámetro)
+    alarma.accionExt = callback;
+    alarma.accion = nullptr;     // Limpiar otros callbacks
+    alarma.accionExt0 = nullptr;
+    
+    alarma.esPersonalizable = true;
+    alarma.idWeb = _generarNuevoIdWeb();
+    
+    uint16_t idx = _num;
+    _num++;
+    _marcaPendiente(idx);
+    
+    DBG_ALM_PRINTF("✅ Alarma personalizable creada - Índice: %d, ID Web: %d", idx, alarma.idWeb);
+    
+    _anotaCambio(alarma.idWeb, CAMBIO_COMPLETO);                           // Se guarda desde loop(), agrupado
+    
+    return idx;
+}
+/**
+ * @brief Modifica una alarma personalizable existente por su ID web
+ * 
+ * @details Actualiza todos los campos de una alarma personalizable identificada
+ *          por su ID web único. Mantiene el callback existente sin modificarlo.
+ *          Actualiza automáticamente el archivo JSON de persistencia.
+ *          Resetea el cache temporal para forzar reevaluación en próxima verificación.
+ * 
+ * @param idWeb ID único web de la alarma a modificar
+ * @param nombre Nuevo nombre descriptivo (máx 49 caracteres)
+ * @param descripcion Nueva descripción opcional (máx 99 caracteres)
+ * @param mascaraDias Nueva máscara de días de la semana
+ * @param hora Nueva hora de ejecución (0-23)
+ * @param minuto Nuevo minuto de ejecución (0-59)
+ * @param tipoString Nuevo tipo como string libre: "MISA", "DIFUNTOS", "FIESTA", etc.
+ * @param habilitada Nuevo estado de habilitación
+ * @param callback Función externa a ejecutar
+ * @param parametro Parámetro para el callback
+ * @param cron Expresión cron opcional; nullptr o "" vuelve al horario por día/hora/minuto
+ * @param fiesta FiestaLiturgica de referencia (FIESTA_NINGUNA = por día de la semana)
+ * @param desplazamientoDias Días desde la fiesta
+ * @param recuperacion RecuperacionAlarma si el disparo se pierde por un corte
+ * @param margenRecuperacionMin Retraso máximo en minutos con RECUP_TARDE
+ * 
+ * @return bool true si la modificación fue exitosa, false en caso de error o cron no válido
+ * 
+ * @note Solo se pueden modificar alarmas con esPersonalizable = true
+ * @note MANTIENE el callback existente - no lo reasigna
+ * @note Los cambios se guardan inmediatamente en JSON
+ * @note Cache temporal se resetea para evitar conflictos
+ * 
+ * @warning El idWeb debe existir y pertenecer a una alarma personalizable
+ * @warning Para cambiar callback, eliminar y recrear la alarma
+ * 
+ * @see addPersonalizable(), eliminarPersonalizable(), habilitarPersonalizable()
+ * 
+ * @since v2.1 - Sistema de alarmas personalizables vía web
+ */
+bool AlarmScheduler::modificarPersonalizable(int idWeb, const char* nombre, const char* descripcion,
+                                           uint8_t mascaraDias, uint8_t hora, uint8_t minuto,
+                                           const char* tipoString, bool habilitada,
+                                           void (*callback)(uint16_t), uint16_t parametro,
+                                           const char* cron, uint8_t fiesta, int16_t desplazamientoDias,
+                                           uint8_t recuperacion, uint8_t margenRecuperacionMin) {
+    DBG_ALM_PRINTF("✏️ Modificando alarma personalizable ID Web: %d", idWeb);
+    
+    uint16_t idx = _buscarIndicePorIdWeb(idWeb);
+    if (idx >= MAX_ALARMAS) {
+        DBG_ALM("❌ Error: Alarma no encontrada");
+        return false;
+    }
+    
+    Alarm& alarma = _alarmas[idx];
+    
+    if (!alarma.esPersonalizable) {
+        DBG_ALM("❌ Error: Alarma no es personalizable");
+        return false;
+    }
+    
+    // ✅ VERIFICAR que el callback no es NULL
+    if (callback == nullptr) {
+        DBG_ALM("❌ Error: Callback es NULL");
+        return false;
+    }
+    
+    CronAlarma cronAnterior = alarma.cron;
+    bool esCronAnterior = alarma.esCron;
+    if (!_asignaCron(alarma, cron)) {
+        DBG_ALM_PRINTF("❌ Error: Expresión cron no válida: %s", cron);
+        return false;
+    }
+    if (!_asignaTextos(idx, nombre, descripcion, tipoString, cron)) {     // Actualizar strings
+        alarma.cron = cronAnterior;
+        alarma.esCron = esCronAnterior;
+        return false;
+    }
+    
+    // Actualizar TODOS los campos incluyendo callback
     alarma.habilitada = habilitada;
     alarma.mascaraDias = mascaraDias;
     alarma.hora = hora;
     alarma.minuto = minuto;
+    alarma.fiesta = (fiesta < NUM_FIESTAS) ? fiesta : FIESTA_NINGUNA;
+    alarma.desplazamientoDias = desplazamientoDias;
+    alarma.recuperacion = (recuperacion <= RECUP_ULTIMA) ? recuperacion : RECUP_TARDE;
+    alarma.margenRecuperacionMin = margenRecuperacionMin;
     
     // ✅ ASIGNAR NUEVO CALLBACK Y PARÁMETRO (esto era lo que faltaba)
     alarma.accionExt = callback;
@@ -913,329 +2347,757 @@ bool AlarmScheduler::modificarPersonalizable(int idWeb, const char* nombre, cons
     alarma.accion = nullptr;      // Limpiar otros callbacks
     alarma.accionExt0 = nullptr;
     
-    // Actualizar strings
-    strncpy(alarma.nombre, nombre, sizeof(alarma.nombre) - 1);
-    alarma.nombre[sizeof(alarma.nombre) - 1] = '\0';
-    
-    strncpy(alarma.descripcion, descripcion, sizeof(alarma.descripcion) - 1);
-    alarma.descripcion[sizeof(alarma.descripcion) - 1] = '\0';
-    
-    strncpy(alarma.tipoString, tipoString, sizeof(alarma.tipoString) - 1);
-    alarma.tipoString[sizeof(alarma.tipoString) - 1] = '\0';
-    
     // Reset cache
-    alarma.ultimoDiaAno = -1;
-    alarma.ultimoMinuto = 255;
-    alarma.ultimaHora = 255;
     alarma.ultimaEjecucion = 0;
+    _marcaPendiente(idx);
     
     DBG_ALM_PRINTF("✅ Callback reasignado: %p, Parámetro: %d", alarma.accionExt, alarma.parametro);
     
-    // Guardar en JSON
-    guardarPersonalizablesEnJSON();
+    _anotaCambio(idWeb, CAMBIO_COMPLETO);                                   // Se guarda desde loop(), agrupado
+    
+    return true;
+}
+/**
+ * @brief Elimina permanentemente una alarma personalizable por su ID web
+ * 
+ * @details Elimina completamente una alarma personalizable del sistema,
+ *          ocupando su hueco con la última alarma del array (sin desplazar
+ *          las demás) y actualizando el contador de alarmas. La operación es
+ *          irreversible y actualiza
+ *          automáticamente la persistencia JSON.
+ * 
+ * @param idWeb ID único web de la alarma a eliminar
+ * 
+ * @return bool true si la eliminación fue exitosa, false si no se encontró
+ * 
+ * @note Solo se pueden eliminar alarmas con esPersonalizable = true
+ * @note Reorganiza automáticamente el array moviendo alarmas posteriores
+ * @note Los cambios se guardan inmediatamente en JSON
+ * @note Operación irreversible - no hay papelera de reciclaje
+ * 
+ * @warning Las alarmas de sistema (esPersonalizable = false) no se pueden eliminar
+ * @warning Los índices de array pueden cambiar tras eliminación
+ * 
+ * @see addPersonalizable(), modificarPersonalizable()
+ * 
+ * @since v2.1 - Sistema de alarmas personalizables vía web
+ */
+bool AlarmScheduler::eliminarPersonalizable(int idWeb) {
+    DBG_ALM_PRINTF("🗑️ Eliminando alarma personalizable ID Web: %d", idWeb);
+    
+    uint16_t idx = _buscarIndicePorIdWeb(idWeb);
+    if (idx >= MAX_ALARMAS) {
+        DBG_ALM("❌ Error: Alarma no encontrada");
+        return false;
+    }
+    
+    if (!_alarmas[idx].esPersonalizable) {
+        DBG_ALM("❌ Error: Alarma no es personalizable");
+        return false;
+    }
+    
+    _quitaAlarma(idx);
+    _eliminaExcepcionesDe(idWeb);
+    
+    DBG_ALM("✅ Alarma personalizable eliminada");
+    
+    _anotaCambio(idWeb, CAMBIO_COMPLETO);                                   // Ya no existe: se anota como borrada
+    
+    return true;
+}
+/**
+ * @brief Habilita o deshabilita una alarma personalizable sin eliminarla
+ * 
+ * @details Cambia el estado de habilitación de una alarma personalizable,
+ *          permitiendo pausar/reanudar su ejecución sin perder la configuración.
+ *          Al habilitar, resetea el cache temporal para asegurar evaluación inmediata.
+ * 
+ * @param idWeb ID único web de la alarma a modificar
+ * @param estado true para habilitar, false para deshabilitar
+ * 
+ * @return bool true si el cambio fue exitoso, false si no se encontró la alarma
+ * 
+ * @note Solo aplica a alarmas con esPersonalizable = true
+ * @note Al habilitar se resetea cache para evaluación inmediata
+ * @note Los cambios se guardan automáticamente en JSON
+ * @note Alarma deshabilitada no se ejecuta pero conserva configuración
+ * 
+ * @warning El idWeb debe existir y pertenecer a una alarma personalizable
+ * 
+ * @see modificarPersonalizable(), eliminarPersonalizable()
+ * 
+ * @since v2.1 - Sistema de alarmas personalizables vía web
+ */
+bool AlarmScheduler::habilitarPersonalizable(int idWeb, bool estado) {
+    DBG_ALM_PRINTF("🔄 %s alarma personalizable ID Web: %d", 
+                   estado ? "Habilitando" : "Deshabilitando", idWeb);
+    
+    uint16_t idx = _buscarIndicePorIdWeb(idWeb);
+    if (idx >= MAX_ALARMAS) {
+        DBG_ALM("❌ Error: Alarma no encontrada");
+        return false;
+    }
+    
+    if (!_alarmas[idx].esPersonalizable) {
+        DBG_ALM("❌ Error: Alarma no es personalizable");
+        return false;
+    }
+    
+    _alarmas[idx].habilitada = estado;
+    
+    // Reset cache si se habilita
+    if (estado) {
+        _alarmas[idx].ultimaEjecucion = 0;
+    }
+    _marcaPendiente(idx);
+    
+    DBG_ALM_PRINTF("✅ Alarma personalizable %s", estado ? "habilitada" : "deshabilitada");
+    
+    _anotaCambio(idWeb, CAMBIO_HABILITADA);                                 // Registro de pocos bytes, no la alarma entera
     
     return true;
 }
+
+
+
+// ============================================================================
+// MÉTODOS AUXILIARES PRIVADOS
+// ============================================================================
+
+/**
+ * @brief Busca el índice de array de una alarma por su ID web único
+ * 
+ * @details Función auxiliar privada que itera sobre todas las alarmas del sistema
+ *          buscando una coincidencia de ID web en alarmas personalizables.
+ *          Utilizada internamente por todas las operaciones web (modificar,
+ *          eliminar, habilitar/deshabilitar) que reciben ID web como parámetro.
+ *          
+ *          **ALGORITMO DE BÚSQUEDA:**
+ *          1. Itera secuencialmente por array de alarmas (0 a _num-1)
+ *          2. Para cada alarma verifica:
+ *             - Que sea personalizable (esPersonalizable == true)
+ *             - Que el idWeb coincida con el buscado
+ *          3. Retorna índice de la primera coincidencia encontrada
+ *          4. Si no encuentra coincidencia, retorna MAX_ALARMAS (valor error)
+ * 
+ * @param idWeb ID único web de la alarma a buscar (entero positivo)
+ * 
+ * @retval uint16_t Índice de la alarma en el array (0 a MAX_ALARMAS-1) si encontrada
+ * @retval MAX_ALARMAS Si no se encontró alarma con ese ID web
+ * 
+ * @note **SOLO PERSONALIZABLES:** Ignora alarmas de sistema (esPersonalizable = false)
+ * @note **PRIMERA COINCIDENCIA:** Retorna el primer índice encontrado
+ * @note **COMPLEJIDAD:** O(n) lineal - solo en ediciones web, nunca desde check()
+ * @note **FUNCIÓN PRIVADA:** Solo accesible internamente por la clase
+ * @note **VALIDACIÓN:** MAX_ALARMAS es valor de error universalmente reconocido
+ * 
+ * @warning **IDs ÚNICOS:** Asume que no hay IDs web duplicados en el sistema
+ * @warning **RANGO VÁLIDO:** Solo busca en rango [0, _num), no en todo el array
+ * @warning **NO VALIDA ENTRADA:** No verifica si idWeb es válido (>0)
+ * 
+ * @see _generarNuevoIdWeb() - Función que garantiza IDs únicos
+ * @see modificarPersonalizable() - Usuario principal de esta función
+ * @see eliminarPersonalizable() - Usuario principal de esta función
+ * @see habilitarPersonalizable() - Usuario principal de esta función
+ * 
+ * @example
+ * @code
+ * // Uso interno típico en funciones de la clase
+ * uint8_t AlarmScheduler::modificarPersonalizable(int idWeb, ...) {
+ *     uint16_t idx = _buscarIndicePorIdWeb(idWeb);
+ *     if (idx >= MAX_ALARMAS) {
+ *         DBG_ALM("❌ Error: Alarma no encontrada");
+ *         return false;
+ *     }
+ *     
+ *     Alarm& alarma = _alarmas[idx];
+ *     // ... modificar alarma ...
+ * }
+ * @endcode
+ * 
+ * @since v2.1 - Sistema de alarmas personalizables vía web
+ * @author Julian Salas Bartolomé
+ */
+uint16_t AlarmScheduler::_buscarIndicePorIdWeb(int idWeb) {
+    for (uint16_t i = 0; i < _num; i++) {
+        if (_alarmas[i].esPersonalizable && _alarmas[i].idWeb == idWeb) {
+            return i;
+        }
+    }
+    return MAX_ALARMAS; // No encontrado
+}
+/**
+ * @brief Genera un nuevo ID web único para alarma personalizable
+ * 
+ * @details Función auxiliar privada que calcula el próximo ID web disponible
+ *          analizando todas las alarmas personalizables existentes. Garantiza
+ *          unicidad de identificadores para evitar conflictos en la interfaz web.
+ *          
+ *          **ALGORITMO DE GENERACIÓN:**
+ *          1. Inicializa maxId a 0 (ID mínimo será 1)
+ *          2. Itera por todas las alarmas del sistema
+ *          3. Para cada alarma personalizable:
+ *             - Compara su idWeb con maxId actual
+ *             - Actualiza maxId si encuentra ID mayor
+ *          4. Retorna maxId + 1 como nuevo ID único
+ *          
+ *          **CARACTERÍSTICAS:**
+ *          - IDs siempre crecientes y únicos
+ *          - No reutiliza IDs de alarmas eliminadas
+ *          - Resistente a eliminación/creación desordenada
+ *          - Mínimo ID generado es 1 (nunca 0)
+ * 
+ * @retval int Nuevo ID web único (entero positivo >= 1)
+ * @retval 1 Si no hay alarmas personalizables existentes
+ * 
+ * @note **ÚNICA INSTANCIA:** Solo busca en alarmas personalizables existentes
+ * @note **CRECIMIENTO:** IDs solo crecen, nunca decrecen
+ * @note **REINICIO:** Solo resetea si se elimina el archivo JSON y se reinicia
+ * @note **FUNCIÓN PRIVADA:** Solo accesible internamente por la clase
+ * @note **SIN LÍMITE:** No impone límite máximo (depende de int máximo)
+ * 
+ * @warning **NO REUTILIZA:** IDs eliminados no se reutilizan (por diseño)
+ * @warning **OVERFLOW:** Teóricamente puede overflow tras ~2 mil millones de alarmas
+ * @warning **DEPENDENCIA:** Requiere que idWeb esté correctamente inicializado
+ * 
+ * @see _buscarIndicePorIdWeb() - Función complementaria para búsqueda
+ * @see addPersonalizable() - Principal usuario de esta función
+ * @see cargarPersonalizablesDesdeJSON() - Actualiza _siguienteIdWeb al cargar
+ * 
+ * @example
+ * @code
+ * // Uso interno típico
+ * uint16_t AlarmScheduler::addPersonalizable(...) {
+ *     // ... validaciones ...
+ *     
+ *     Alarm& alarma = _alarmas[_num];
+ *     alarma.idWeb = _generarNuevoIdWeb();  // Asignar ID único
+ *     
+ *     // ... resto de configuración ...
+ * }
+ * 
+ * // Ejemplo de secuencia de IDs generados:
+ * // Primera alarma: ID = 1
+ * // Segunda alarma: ID = 2  
+ * // Eliminar primera: maxId sigue siendo 2
+ * // Tercera alarma: ID = 3 (no reutiliza 1)
+ * @endcode
+ * 
+ * @since v2.1 - Sistema de alarmas personalizables vía web
+ * @author Julian Salas Bartolomé
+ */
+int AlarmScheduler::_generarNuevoIdWeb() {
+    // Buscar el ID más alto existente
+    int maxId = 0;
+    for (uint16_t i = 0; i < _num; i++) {
+        if (_alarmas[i].esPersonalizable && _alarmas[i].idWeb > maxId) {
+            maxId = _alarmas[i].idWeb;
+        }
+    }
+    return maxId + 1;
+}
+
+// ============================================================================
+// IMPLEMENTACIÓN DE FUNCIONES JSON Y PERSISTENCIA
+// ============================================================================
 /**
- * @brief Elimina permanentemente una alarma personalizable por su ID web
- * 
- * @details Elimina completamente una alarma personalizable del sistema,
- *          reorganizando el array para evitar huecos y actualizando el
- *          contador de alarmas. La operación es irreversible y actualiza
- *          automáticamente la persistencia JSON.
+ * @brief Genera JSON con todas las alarmas personalizables para interfaz web
  * 
- * @param idWeb ID único web de la alarma a eliminar
+ * @details Construye una estructura JSON completa conteniendo únicamente las
+ *          alarmas marcadas como personalizables (esPersonalizable = true),
+ *          incluyendo metadatos, estadísticas y formato optimizado para consumo web.
+ *          
+ *          **ESTRUCTURA JSON GENERADA:**
+ *          - version: Versión del formato JSON (2.1)
+ *          - timestamp: Timestamp de generación en millis()
+ *          - total: Número de alarmas personalizables
+ *          - alarmas[]: Array con datos de cada alarma personalizable
+ *            - id: ID web único para identificación
+ *            - nombre: Nombre descriptivo de la alarma
+ *            - descripcion: Descripción opcional
+ *            - dia: Día de la semana (0=todos, 1-7=dom-sab)
+ *            - diaNombre: Nombre legible del día
+ *            - hora/minuto: Horario de ejecución
+ *            - accion: Tipo de acción (valor de tipoString del struct)
+ *            - habilitada: Estado de activación
+ *            - horaTexto: Hora formateada (ej: "11:05")
+ *            - indiceArray: Índice en array (para debug)
  * 
- * @return bool true si la eliminación fue exitosa, false si no se encontró
+ * @return String JSON estructurado con alarmas personalizables y metadatos
  * 
- * @note Solo se pueden eliminar alarmas con esPersonalizable = true
- * @note Reorganiza automáticamente el array moviendo alarmas posteriores
- * @note Los cambios se guardan inmediatamente en JSON
- * @note Operación irreversible - no hay papelera de reciclaje
+ * @note **FILTRADO:** Solo incluye alarmas con esPersonalizable = true
+ * @note **CONVERSIÓN:** Convierte máscaras de días a números (0-7)
+ * @note **FORMATO WEB:** Incluye campos calculados para mostrar en UI
+ * @note **GENÉRICO:** No interpreta tipos - solo los copia como strings
  * 
- * @warning Las alarmas de sistema (esPersonalizable = false) no se pueden eliminar
- * @warning Los índices de array pueden cambiar tras eliminación
+ * @warning **TAMAÑO:** JSON puede ser grande con muchas alarmas - considerar paginación
+ * @warning **MEMORIA:** Usa JsonDocument que consume RAM durante generación
  * 
- * @see addPersonalizable(), modificarPersonalizable()
+ * @see obtenerEstadisticasJSON(), guardarPersonalizablesEnJSON()
+ * @see _diaToString() - Conversión de números a nombres de días
  * 
  * @since v2.1 - Sistema de alarmas personalizables vía web
  */
-bool AlarmScheduler::eliminarPersonalizable(int idWeb) {
-    DBG_ALM_PRINTF("🗑️ Eliminando alarma personalizable ID Web: %d", idWeb);
+String AlarmScheduler::obtenerPersonalizablesJSON() {
+    DBG_ALM("📋 Generando JSON con alarmas personalizables...");
     
-    uint8_t idx = _buscarIndicePorIdWeb(idWeb);
-    if (idx >= MAX_ALARMAS) {
-        DBG_ALM("❌ Error: Alarma no encontrada");
-        return false;
-    }
+    JsonDocument doc;
+    doc["version"] = "2.1";
+    doc["timestamp"] = millis();
     
-    if (!_alarmas[idx].esPersonalizable) {
-        DBG_ALM("❌ Error: Alarma no es personalizable");
-        return false;
+    // Contar alarmas personalizables
+    uint16_t personalizables = 0;
+    for (uint16_t i = 0; i < _num; i++) {
+        if (_alarmas[i].esPersonalizable) {
+            personalizables++;
+        }
     }
     
-    // Mover todas las alarmas posteriores una posición hacia atrás
-    for (uint8_t i = idx; i < _num - 1; i++) {
-        _alarmas[i] = _alarmas[i + 1];
-    }
+    doc["total"] = personalizables;
     
-    // Limpiar la última posición
-    _alarmas[_num - 1] = Alarm();
-    _num--;
+    JsonArray alarmasArray = doc.createNestedArray("alarmas");
     
-    DBG_ALM("✅ Alarma personalizable eliminada");
+    // Añadir cada alarma personalizable al JSON
+    for (uint16_t i = 0; i < _num; i++) {
+        const Alarm& alarma = _alarmas[i];
+        
+        if (!alarma.esPersonalizable) continue; // Solo personalizables
+        
+        JsonObject alarmaObj = alarmasArray.createNestedObject();
+        
+        alarmaObj["id"] = alarma.idWeb;
+        alarmaObj["nombre"] = getNombre(i);
+        alarmaObj["descripcion"] = getDescripcion(i);
+        
+        // Convertir máscara de días a número de día (0-7)
+        int dia = 0;
+        if (alarma.mascaraDias == DOW_TODOS) {
+            dia = 0; // Todos los días
+        } else {
+            // Buscar primer bit activo
+            for (int d = 0; d < 7; d++) {
+                if (alarma.mascaraDias & (1 << d)) {
+                    dia = d + 1; // 1=Domingo, 2=Lunes, etc.
+                    break;
+                }
+            }
+        }
+        
+        alarmaObj["dia"] = dia;
+        alarmaObj["diaNombre"] = _diaToString(dia);
+        alarmaObj["hora"] = alarma.hora;
+        alarmaObj["minuto"] = alarma.minuto;
+        alarmaObj["accion"] = getTipo(i);
+        alarmaObj["parametro"] = alarma.parametro;  // Parámetro genérico
+        alarmaObj["duracion"] = alarma.parametro;   // Alias para alarmas de calefacción
+        alarmaObj["habilitada"] = alarma.habilitada;
+        
+        alarmaObj["cron"] = getCron(i);             // "" si usa día/hora/minuto
+        alarmaObj["fiesta"] = CALENDARIO::Nombre((FiestaLiturgica)alarma.fiesta);  // "" si usa día de la semana
+        alarmaObj["desplazamiento"] = alarma.desplazamientoDias;
+        alarmaObj["recuperacion"] = nombreRecuperacion(alarma.recuperacion);
+        alarmaObj["margenRecuperacion"] = alarma.margenRecuperacionMin;
+        
+        // Formatear hora para mostrar (ej: "11:05" o la expresión cron)
+        char horaFormateada[8];
+        sprintf(horaFormateada, "%02d:%02d", alarma.hora, alarma.minuto);
+        if (alarma.esCron) {
+            alarmaObj["horaTexto"] = getCron(i);
+        } else {
+            alarmaObj["horaTexto"] = horaFormateada;
+        }
+        
+        // Información de estado
+        alarmaObj["indiceArray"] = i; // Para debug
+    }
     
-    // Guardar en JSON
-    guardarPersonalizablesEnJSON();
+    String resultado;
+    serializeJson(doc, resultado);
     
-    return true;
+    DBG_ALM_PRINTF("📋 JSON generado con %d alarmas (%d chars)", personalizables, resultado.length());
+    return resultado;
 }
 /**
- * @brief Habilita o deshabilita una alarma personalizable sin eliminarla
+ * @brief Genera JSON con estadísticas completas del sistema de alarmas
  * 
- * @details Cambia el estado de habilitación de una alarma personalizable,
- *          permitiendo pausar/reanudar su ejecución sin perder la configuración.
- *          Al habilitar, resetea el cache temporal para asegurar evaluación inmediata.
+ * @details Construye estructura JSON con información estadística detallada
+ *          del sistema de alarmas, incluyendo conteos por categoría, estado de
+ *          callbacks, información de memoria y configuración actual del módulo.
+ *          Ideal para monitoreo, debug y dashboards administrativos.
+ *          
+ *          **ESTADÍSTICAS INCLUIDAS:**
+ *          - Información general: módulo, versión, timestamp
+ *          - Contadores: total, sistema, personalizables, habilitadas, deshabilitadas
+ *          - Capacidad: espacioLibre, maxAlarmas, siguienteIdWeb
+ *          - Estados: (sin callbacks específicos - módulo genérico)
+ *          - Persistencia: archivoJSON, archivoExiste
+ *          - Tiempo actual: hora, minuto, diaSemana, diaAno (si RTC válido)
  * 
- * @param idWeb ID único web de la alarma a modificar
- * @param estado true para habilitar, false para deshabilitar
+ * @return String JSON con estadísticas completas del sistema
  * 
- * @return bool true si el cambio fue exitoso, false si no se encontró la alarma
+ * @note **CONTADORES:** Diferencia alarmas de sistema vs personalizables
+ * @note **CALLBACKS:** Indica si están configurados (no null)
+ * @note **TIEMPO:** Incluye estado actual del RTC si está sincronizado
+ * @note **ARCHIVOS:** Verifica existencia del archivo de persistencia
  * 
- * @note Solo aplica a alarmas con esPersonalizable = true
- * @note Al habilitar se resetea cache para evaluación inmediata
- * @note Los cambios se guardan automáticamente en JSON
- * @note Alarma deshabilitada no se ejecuta pero conserva configuración
+ * @warning **RTC DEPENDENCY:** Campos de tiempo solo válidos si getLocalTime() funciona
+ * @warning **SPIFFS:** Verificación de archivo requiere SPIFFS montado
  * 
- * @warning El idWeb debe existir y pertenecer a una alarma personalizable
+ * @see obtenerPersonalizablesJSON(), cargarPersonalizablesDesdeJSON()
+ * @see getLocalTime() - Función para obtener tiempo actual
  * 
- * @see modificarPersonalizable(), eliminarPersonalizable()
+ * @example
+ * @code
+ * String stats = Alarmas.obtenerEstadisticasJSON(); 
+ * Serial.println("Stats: " + stats);
+ * ws.textAll("STATS_ALARMAS_WEB:" + stats);
+ * @endcode
  * 
  * @since v2.1 - Sistema de alarmas personalizables vía web
+ * @author Julian Salas Bartolomé
  */
-bool AlarmScheduler::habilitarPersonalizable(int idWeb, bool estado) {
-    DBG_ALM_PRINTF("🔄 %s alarma personalizable ID Web: %d", 
-                   estado ? "Habilitando" : "Deshabilitando", idWeb);
+String AlarmScheduler::obtenerEstadisticasJSON() {
+    DBG_ALM("📊 Generando estadísticas del sistema...");
     
-    uint8_t idx = _buscarIndicePorIdWeb(idWeb);
-    if (idx >= MAX_ALARMAS) {
-        DBG_ALM("❌ Error: Alarma no encontrada");
-        return false;
-    }
+    JsonDocument doc;
     
-    if (!_alarmas[idx].esPersonalizable) {
-        DBG_ALM("❌ Error: Alarma no es personalizable");
-        return false;
+    // Información general
+    doc["modulo"] = "AlarmScheduler";
+    doc["version"] = "2.1";
+    doc["timestamp"] = millis();
+    
+    // Contadores de alarmas
+    uint16_t sistema = 0, personalizables = 0, habilitadas = 0, deshabilitadas = 0;
+    
+    for (uint16_t i = 0; i < _num; i++) {
+        if (_alarmas[i].esPersonalizable) {
+            personalizables++;
+        } else {
+            sistema++;
+        }
+        
+        if (_alarmas[i].habilitada) {
+            habilitadas++;
+        } else {
+            deshabilitadas++;
+        }
     }
     
-    _alarmas[idx].habilitada = estado;
+    doc["totalAlarmas"] = _num;
+    doc["sistema"] = sistema;
+    doc["personalizables"] = personalizables;
+    doc["habilitadas"] = habilitadas;
+    doc["deshabilitadas"] = deshabilitadas;
+    doc["espacioLibre"] = MAX_ALARMAS - _num;
+    doc["maxAlarmas"] = MAX_ALARMAS;
+        
+    // Información del sistema
+    doc["siguienteIdWeb"] = _siguienteIdWeb;
+    doc["archivoJSON"] = "/alarmas_personalizadas.json";
+    doc["archivoExiste"] = SPIFFS.exists("/alarmas_personalizadas.json");
     
-    // Reset cache si se habilita
-    if (estado) {
-        _alarmas[idx].ultimoDiaAno = -1;
-        _alarmas[idx].ultimoMinuto = 255;
-        _alarmas[idx].ultimaHora = 255;
-        _alarmas[idx].ultimaEjecucion = 0;
+    // Escrituras en flash (JSON, registro de cambios y estado)
+    doc["flash"]["bytes24h"] = _nBytesFlash24h;
+    doc["flash"]["bytes24hAnterior"] = _nBytesFlashAnterior;
+    doc["flash"]["bytesTotal"] = _nBytesFlashTotal;
+    doc["flash"]["registroBytes"] = _nBytesRegistro;
+    doc["flash"]["instantaneaBytes"] = _nBytesBase;
+    doc["flash"]["cambiosPendientes"] = _nCambios;
+    
+    // Última carga de las alarmas personalizables en begin()
+    doc["arranque"]["origen"] = _lCargaBinaria ? "instantanea" : "json";
+    doc["arranque"]["cargaUs"] = _nUsCarga;
+    
+    // Estado actual del tiempo
+    struct tm timeinfo;
+    if (Reloj::HoraLocal(&timeinfo)) {
+        doc["tiempoActual"]["valido"] = true;
+        doc["tiempoActual"]["hora"] = timeinfo.tm_hour;
+        doc["tiempoActual"]["minuto"] = timeinfo.tm_min;
+        doc["tiempoActual"]["diaSemana"] = timeinfo.tm_wday;
+        doc["tiempoActual"]["diaAno"] = timeinfo.tm_yday;
+    } else {
+        doc["tiempoActual"]["valido"] = false;
     }
     
-    DBG_ALM_PRINTF("✅ Alarma personalizable %s", estado ? "habilitada" : "deshabilitada");
-    
-    // Guardar en JSON
-    guardarPersonalizablesEnJSON();
+    String resultado;
+    serializeJson(doc, resultado);
     
-    return true;
+    DBG_ALM_PRINTF("📊 Estadísticas generadas (%d chars)", resultado.length());
+    return resultado;
 }
-
-
-
-// ============================================================================
-// MÉTODOS AUXILIARES PRIVADOS
-// ============================================================================
-
 /**
- * @brief Busca el índice de array de una alarma por su ID web único
+ * @brief Carga alarmas personalizables desde archivo JSON en SPIFFS
  * 
- * @details Función auxiliar privada que itera sobre todas las alarmas del sistema
- *          buscando una coincidencia de ID web en alarmas personalizables.
- *          Utilizada internamente por todas las operaciones web (modificar,
- *          eliminar, habilitar/deshabilitar) que reciben ID web como parámetro.
+ * @details Lee el archivo JSON de persistencia y recrea todas las alarmas
+ *          personalizables en el sistema, validando integridad de datos y
+ *          asignando callbacks según configuración. Si el archivo no existe,
+ *          crea alarmas por defecto automáticamente.
  *          
- *          **ALGORITMO DE BÚSQUEDA:**
- *          1. Itera secuencialmente por array de alarmas (0 a _num-1)
- *          2. Para cada alarma verifica:
- *             - Que sea personalizable (esPersonalizable == true)
- *             - Que el idWeb coincida con el buscado
- *          3. Retorna índice de la primera coincidencia encontrada
- *          4. Si no encuentra coincidencia, retorna MAX_ALARMAS (valor error)
- * 
- * @param idWeb ID único web de la alarma a buscar (entero positivo)
+ *          **PROCESO DE CARGA:**
+ *          1. Verifica existencia del archivo JSON en SPIFFS
+ *          2. Si no existe: crea alarmas por defecto (begin() guarda la instantánea)
+ *          3. Si existe: lee contenido y parsea JSON
+ *          4. Elimina alarmas personalizables existentes (mantiene sistema)
+ *          5. Para cada alarma en JSON:
+ *             - Valida datos básicos (nombre, hora, minuto, idWeb)
+ *             - Convierte día (0-7) a máscara de bits
+ *             - Crea alarma en array con todos los campos
+ *             - Actualiza siguienteIdWeb si es necesario
+ *          6. Actualiza contador total de alarmas
  * 
- * @retval uint8_t Índice de la alarma en el array (0 a MAX_ALARMAS-1) si encontrada
- * @retval MAX_ALARMAS Si no se encontró alarma con ese ID web
+ * @return bool true si la carga fue exitosa, false si error o archivo corrupto
  * 
- * @note **SOLO PERSONALIZABLES:** Ignora alarmas de sistema (esPersonalizable = false)
- * @note **PRIMERA COINCIDENCIA:** Retorna el primer índice encontrado
- * @note **COMPLEJIDAD:** O(n) lineal - aceptable para arrays pequeños (max 16)
- * @note **FUNCIÓN PRIVADA:** Solo accesible internamente por la clase
- * @note **VALIDACIÓN:** MAX_ALARMAS es valor de error universalmente reconocido
+ * @note **IMPORTACIÓN:** begin() solo lee el JSON si no hay instantánea válida
+ *       (/alarmas.bin) o tras subirlo por /upload (solicitarImportacion())
+ * @note **PRESERVACIÓN:** Mantiene alarmas de sistema intactas
+ * @note **VALIDACIÓN:** Descarta alarmas con datos inválidos
+ * @note **CALLBACKS:** Requiere callbacks configurados previamente con setCallback*()
+ * @note **AUTO-CREACIÓN:** Crea alarmas por defecto si archivo no existe
+ * @note **ID MANAGEMENT:** Actualiza siguienteIdWeb para evitar duplicados
  * 
- * @warning **IDs ÚNICOS:** Asume que no hay IDs web duplicados en el sistema
- * @warning **RANGO VÁLIDO:** Solo busca en rango [0, _num), no en todo el array
- * @warning **NO VALIDA ENTRADA:** No verifica si idWeb es válido (>0)
+ * @warning **ARCHIVO CORRUPTO:** JSON malformado puede causar pérdida de alarmas
+ * @warning **CALLBACKS NULL:** Alarmas sin callback válido no se ejecutarán
+ * @warning **SPIFFS:** Requiere sistema de archivos montado
  * 
- * @see _generarNuevoIdWeb() - Función que garantiza IDs únicos
- * @see modificarPersonalizable() - Usuario principal de esta función
- * @see eliminarPersonalizable() - Usuario principal de esta función
- * @see habilitarPersonalizable() - Usuario principal de esta función
+ * @see guardarPersonalizablesEnJSON(), addPersonalizable()
+ * @see _crearAlarmasPersonalizablesPorDefecto() - Alarmas por defecto
  * 
  * @example
  * @code
- * // Uso interno típico en funciones de la clase
- * uint8_t AlarmScheduler::modificarPersonalizable(int idWeb, ...) {
- *     uint8_t idx = _buscarIndicePorIdWeb(idWeb);
- *     if (idx >= MAX_ALARMAS) {
- *         DBG_ALM("❌ Error: Alarma no encontrada");
- *         return false;
- *     }
+ * void setup() {
+ *     // Configurar callbacks antes de cargar
+ *     Alarmas.setCallbackMisa(&accionSecuencia);
+ *     Alarmas.setCallbackDifuntos(&accionSecuencia);  
+ *     Alarmas.setCallbackFiesta(&accionSecuencia);
  *     
- *     Alarm& alarma = _alarmas[idx];
- *     // ... modificar alarma ...
+ *     // Cargar alarmas persistidas
+ *     if (Alarmas.cargarPersonalizablesDesdeJSON()) {
+ *         Serial.println("Alarmas cargadas correctamente");
+ *     }
  * }
  * @endcode
  * 
  * @since v2.1 - Sistema de alarmas personalizables vía web
  * @author Julian Salas Bartolomé
  */
-uint8_t AlarmScheduler::_buscarIndicePorIdWeb(int idWeb) {
-    for (uint8_t i = 0; i < _num; i++) {
-        if (_alarmas[i].esPersonalizable && _alarmas[i].idWeb == idWeb) {
-            return i;
+bool AlarmScheduler::cargarPersonalizablesDesdeJSON() {
+    DBG_ALM("📂 Cargando alarmas personalizables desde JSON...");
+    
+    const char* archivo = "/alarmas_personalizadas.json";
+    
+    if (!SPIFFS.exists(archivo)) {
+        DBG_ALM("📄 Archivo de alarmas no existe, creando alarmas por defecto");
+        _crearAlarmasPersonalizablesPorDefecto();
+        return true;                                                        // begin() guarda la instantánea
+    }
+    
+    File file = SPIFFS.open(archivo, "r");
+    if (!file) {
+        DBG_ALM("❌ Error al abrir archivo de alarmas");
+        return false;
+    }
+    
+    String contenido = file.readString();
+    file.close();
+    
+    DBG_ALM_PRINTF("📄 Contenido leído (%d bytes)", contenido.length());
+    
+    JsonDocument doc;
+    DeserializationError error = deserializeJson(doc, contenido);
+    
+    if (error) {
+        DBG_ALM_PRINTF("❌ Error parseando JSON: %s", error.c_str());
+        return false;
+    }
+    
+    // Eliminar alarmas personalizables existentes (manteniendo las de sistema)
+    // Compactación en una pasada: cada alarma de sistema se mueve como mucho una vez
+    uint16_t nDestino = 0;
+    for (uint16_t i = 0; i < _num; i++) {
+        if (_alarmas[i].esPersonalizable) {
+            _liberaTextos(i);
+            continue;
         }
+        if (nDestino != i) {
+            _alarmas[nDestino] = _alarmas[i];
+            _aTextos[nDestino] = _aTextos[i];
+            _aTextos[i] = nullptr;
+        }
+        nDestino++;
     }
-    return MAX_ALARMAS; // No encontrado
+    _num = nDestino;
+    
+    // Cargar alarmas del JSON
+    JsonArray alarmasArray = doc["alarmas"];
+    int cargadas = 0;
+    
+    for (JsonObject alarmaObj : alarmasArray) {
+        if (_num >= MAX_ALARMAS) {
+            DBG_ALM("⚠️ Máximo de alarmas alcanzado, ignorando restantes");
+            break;
+        }
+        
+        if (_leeAlarmaJSON(alarmaObj, _num)) {
+            _num++;
+            cargadas++;
+        }
+    }
+    
+    _invalidaIndice();                                                      // Los índices se han desplazado al recargar
+    DBG_ALM_PRINTF("✅ Alarmas personalizables cargadas: %d", cargadas);
+    return true;
 }
 /**
- * @brief Genera un nuevo ID web único para alarma personalizable
+ * @brief Guarda alarmas personalizables en archivo JSON en SPIFFS
  * 
- * @details Función auxiliar privada que calcula el próximo ID web disponible
- *          analizando todas las alarmas personalizables existentes. Garantiza
- *          unicidad de identificadores para evitar conflictos en la interfaz web.
- *          
- *          **ALGORITMO DE GENERACIÓN:**
- *          1. Inicializa maxId a 0 (ID mínimo será 1)
- *          2. Itera por todas las alarmas del sistema
- *          3. Para cada alarma personalizable:
- *             - Compara su idWeb con maxId actual
- *             - Actualiza maxId si encuentra ID mayor
- *          4. Retorna maxId + 1 como nuevo ID único
+ * @details Serializa únicamente las alarmas personalizables a formato JSON
+ *          estructurado y las persiste en SPIFFS para supervivencia a reinicios.
+ *          Incluye validación de escritura y manejo de errores de filesystem.
  *          
- *          **CARACTERÍSTICAS:**
- *          - IDs siempre crecientes y únicos
- *          - No reutiliza IDs de alarmas eliminadas
- *          - Resistente a eliminación/creación desordenada
- *          - Mínimo ID generado es 1 (nunca 0)
+ *          **PROCESO DE GUARDADO:**
+ *          1. Crea documento JSON con metadatos (versión, timestamp)
+ *          2. Cuenta alarmas personalizables en el sistema
+ *          3. Crea array JSON con datos de cada alarma personalizable:
+ *             - Convierte máscaras de días a números (0-7)
+ *             - Incluye todos los campos web necesarios
+ *             - Excluye campos internos (cache, callbacks)
+ *          4. Abre archivo en modo escritura (sobreescribe)
+ *          5. Serializa JSON directamente al archivo
+ *          6. Valida bytes escritos antes de confirmar éxito
  * 
- * @retval int Nuevo ID web único (entero positivo >= 1)
- * @retval 1 Si no hay alarmas personalizables existentes
+ * @return bool true si el guardado fue exitoso, false si error de escritura
  * 
- * @note **ÚNICA INSTANCIA:** Solo busca en alarmas personalizables existentes
- * @note **CRECIMIENTO:** IDs solo crecen, nunca decrecen
- * @note **REINICIO:** Solo resetea si se elimina el archivo JSON y se reinicia
- * @note **FUNCIÓN PRIVADA:** Solo accesible internamente por la clase
- * @note **SIN LÍMITE:** No impone límite máximo (depende de int máximo)
+ * @note **FILTRADO:** Solo guarda alarmas con esPersonalizable = true
+ * @note **FORMATO:** JSON compatible con cargarPersonalizablesDesdeJSON()
+ * @note **SOBREESCRITURA:** Reemplaza archivo existente completamente
+ * @note **EXPORTACIÓN:** El JSON ya no es el almacenamiento de trabajo: las
+ *       alarmas se guardan en /alarmas.bin y /alarmas_cambios.log. Este
+ *       archivo solo sirve para copias de seguridad y otras herramientas
+ * @note **VALIDACIÓN:** Verifica operación de escritura antes de confirmar
+ * @note **METADATOS:** Incluye versión y timestamp para control de versiones
  * 
- * @warning **NO REUTILIZA:** IDs eliminados no se reutilizan (por diseño)
- * @warning **OVERFLOW:** Teóricamente puede overflow tras ~2 mil millones de alarmas
- * @warning **DEPENDENCIA:** Requiere que idWeb esté correctamente inicializado
+ * @warning **ESPACIO DISCO:** Requiere SPIFFS montado y espacio suficiente
+ * @warning **OPERACIÓN SÍNCRONA:** Puede bloquear temporalmente (ms) durante escritura
+ * @warning **PÉRDIDA DATOS:** Error de escritura puede corromper archivo existente
  * 
- * @see _buscarIndicePorIdWeb() - Función complementaria para búsqueda
- * @see addPersonalizable() - Principal usuario de esta función
- * @see cargarPersonalizablesDesdeJSON() - Actualiza _siguienteIdWeb al cargar
+ * @see cargarPersonalizablesDesdeJSON(), obtenerPersonalizablesJSON()
+ * @see SPIFFS.open(), serializeJson() - Funciones utilizadas internamente
  * 
  * @example
  * @code
- * // Uso interno típico
- * uint8_t AlarmScheduler::addPersonalizable(...) {
- *     // ... validaciones ...
- *     
- *     Alarm& alarma = _alarmas[_num];
- *     alarma.idWeb = _generarNuevoIdWeb();  // Asignar ID único
- *     
- *     // ... resto de configuración ...
+ * // Guardar después de modificar alarma
+ * if (Alarmas.modificarPersonalizable(id, "Nueva Misa", "", DOW_DOMINGO, 12, 0, "MISA", true)) {
+ *     // El guardado se hace automáticamente, pero se puede verificar:
+ *     Serial.println("Alarma modificada y guardada");
  * }
  * 
- * // Ejemplo de secuencia de IDs generados:
- * // Primera alarma: ID = 1
- * // Segunda alarma: ID = 2  
- * // Eliminar primera: maxId sigue siendo 2
- * // Tercera alarma: ID = 3 (no reutiliza 1)
+ * // Guardado manual explícito
+ * if (Alarmas.guardarPersonalizablesEnJSON()) {
+ *     Serial.println("Alarmas guardadas en SPIFFS");
+ * } else {
+ *     Serial.println("Error guardando alarmas");
+ * }
  * @endcode
  * 
  * @since v2.1 - Sistema de alarmas personalizables vía web
  * @author Julian Salas Bartolomé
  */
-int AlarmScheduler::_generarNuevoIdWeb() {
-    // Buscar el ID más alto existente
-    int maxId = 0;
-    for (uint8_t i = 0; i < _num; i++) {
-        if (_alarmas[i].esPersonalizable && _alarmas[i].idWeb > maxId) {
-            maxId = _alarmas[i].idWeb;
+bool AlarmScheduler::guardarPersonalizablesEnJSON() {
+    DBG_ALM("💾 Guardando alarmas personalizables en JSON...");
+    
+    const char* archivo = "/alarmas_personalizadas.json";
+    
+    JsonDocument doc;
+    [[maybe_unused]] uint16_t personalizables = _documentoJSON(doc);
+    
+    // Escribir archivo
+    File file = SPIFFS.open(archivo, "w");
+    if (!file) {
+        DBG_ALM("❌ Error al crear archivo JSON");
+        return false;
+    }
+    
+    // ✅ PARTE FALTANTE - ESCRIBIR Y CERRAR ARCHIVO
+    size_t bytesEscritos = serializeJson(doc, file);
+    file.close();
+    
+    if (bytesEscritos == 0) {
+        DBG_ALM("❌ Error escribiendo JSON - 0 bytes escritos");
+        return false;
+    }
+    
+    DBG_ALM_PRINTF("✅ JSON guardado exitosamente: %d alarmas, %d bytes", personalizables, bytesEscritos);
+    _cuentaEscritura(bytesEscritos);
+    
+    // ✅ VERIFICACIÓN OPCIONAL - Comprobar que el archivo se escribió
+    if (SPIFFS.exists(archivo)) {
+        File verificacion = SPIFFS.open(archivo, "r");
+        if (verificacion) {
+            [[maybe_unused]] size_t tamanoArchivo = verificacion.size();
+            verificacion.close();
+            DBG_ALM_PRINTF("✅ Archivo verificado: %d bytes en disco", tamanoArchivo);
         }
+    } else {
+        DBG_ALM("⚠️ Advertencia: Archivo no encontrado tras guardado");
     }
-    return maxId + 1;
+    
+    return true;
 }
 
-// ============================================================================
-// IMPLEMENTACIÓN DE FUNCIONES JSON Y PERSISTENCIA
-// ============================================================================
 /**
- * @brief Genera JSON con todas las alarmas personalizables para interfaz web
+ * @brief Devuelve las alarmas personalizables en el formato de /alarmas_personalizadas.json
  * 
- * @details Construye una estructura JSON completa conteniendo únicamente las
- *          alarmas marcadas como personalizables (esPersonalizable = true),
- *          incluyendo metadatos, estadísticas y formato optimizado para consumo web.
- *          
- *          **ESTRUCTURA JSON GENERADA:**
- *          - version: Versión del formato JSON (2.1)
- *          - timestamp: Timestamp de generación en millis()
- *          - total: Número de alarmas personalizables
- *          - alarmas[]: Array con datos de cada alarma personalizable
- *            - id: ID web único para identificación
- *            - nombre: Nombre descriptivo de la alarma
- *            - descripcion: Descripción opcional
- *            - dia: Día de la semana (0=todos, 1-7=dom-sab)
- *            - diaNombre: Nombre legible del día
- *            - hora/minuto: Horario de ejecución
- *            - accion: Tipo de acción (valor de tipoString del struct)
- *            - habilitada: Estado de activación
- *            - horaTexto: Hora formateada (ej: "11:05")
- *            - indiceArray: Índice en array (para debug)
+ * @details Se genera desde memoria, sin escribir en flash. Es lo que sirve
+ *          /download?file=alarmas_personalizadas.json.
  * 
- * @return String JSON estructurado con alarmas personalizables y metadatos
+ * @return String con el JSON completo (versión, total y array "alarmas")
  * 
- * @note **FILTRADO:** Solo incluye alarmas con esPersonalizable = true
- * @note **CONVERSIÓN:** Convierte máscaras de días a números (0-7)
- * @note **FORMATO WEB:** Incluye campos calculados para mostrar en UI
- * @note **GENÉRICO:** No interpreta tipos - solo los copia como strings
+ * @since v2.2
+ * @author Julian Salas Bartolomé
+ */
+String AlarmScheduler::exportarJSON() {
+    JsonDocument doc;
+    _documentoJSON(doc);
+    String resultado;
+    serializeJson(doc, resultado);
+    return resultado;
+}
+
+/**
+ * @brief Pide que el próximo begin() importe /alarmas_personalizadas.json
  * 
- * @warning **TAMAÑO:** JSON puede ser grande con muchas alarmas - considerar paginación
- * @warning **MEMORIA:** Usa JsonDocument que consume RAM durante generación
+ * @details La llama /upload tras subir el archivo. La importación no se hace
+ *          en la tarea del servidor web: loop() ve importacionSolicitada() y
+ *          llama a IniciaAlarmas(), que restaura callbacks y alarmas de sistema.
+ *          El registro de cambios y la instantánea anteriores se sustituyen.
  * 
- * @see obtenerEstadisticasJSON(), guardarPersonalizablesEnJSON()
- * @see _diaToString() - Conversión de números a nombres de días
+ * @since v2.2
+ * @author Julian Salas Bartolomé
+ */
+void AlarmScheduler::solicitarImportacion() {
+    _lImportarJSON = true;
+}
+
+bool AlarmScheduler::importacionSolicitada() const {
+    return _lImportarJSON;
+}
+
+/**
+ * @brief Rellena un documento con metadatos y alarmas personalizables
  * 
- * @since v2.1 - Sistema de alarmas personalizables vía web
+ * @return Número de alarmas personalizables
+ * 
+ * @since v2.2
+ * @author Julian Salas Bartolomé
  */
-String AlarmScheduler::obtenerPersonalizablesJSON() {
-    DBG_ALM("📋 Generando JSON con alarmas personalizables...");
-    
-    JsonDocument doc;
+uint16_t AlarmScheduler::_documentoJSON(JsonDocument& doc) {
     doc["version"] = "2.1";
     doc["timestamp"] = millis();
     
-    // Contar alarmas personalizables
-    uint8_t personalizables = 0;
-    for (uint8_t i = 0; i < _num; i++) {
+    // Contar personalizables
+    uint16_t personalizables = 0;
+    for (uint16_t i = 0; i < _num; i++) {
         if (_alarmas[i].esPersonalizable) {
             personalizables++;
         }
@@ -1245,464 +3107,566 @@ String AlarmScheduler::obtenerPersonalizablesJSON() {
     
     JsonArray alarmasArray = doc.createNestedArray("alarmas");
     
-    // Añadir cada alarma personalizable al JSON
-    for (uint8_t i = 0; i < _num; i++) {
-        const Alarm& alarma = _alarmas[i];
-        
-        if (!alarma.esPersonalizable) continue; // Solo personalizables
-        
-        JsonObject alarmaObj = alarmasArray.createNestedObject();
-        
-        alarmaObj["id"] = alarma.idWeb;
-        alarmaObj["nombre"] = alarma.nombre;
-        alarmaObj["descripcion"] = alarma.descripcion;
-        
-        // Convertir máscara de días a número de día (0-7)
-        int dia = 0;
-        if (alarma.mascaraDias == DOW_TODOS) {
-            dia = 0; // Todos los días
-        } else {
-            // Buscar primer bit activo
-            for (int d = 0; d < 7; d++) {
-                if (alarma.mascaraDias & (1 << d)) {
-                    dia = d + 1; // 1=Domingo, 2=Lunes, etc.
-                    break;
-                }
-            }
-        }
-        
-        alarmaObj["dia"] = dia;
-        alarmaObj["diaNombre"] = _diaToString(dia);
-        alarmaObj["hora"] = alarma.hora;
-        alarmaObj["minuto"] = alarma.minuto;
-        alarmaObj["accion"] = alarma.tipoString;
-        alarmaObj["parametro"] = alarma.parametro;  // Parámetro genérico
-        alarmaObj["duracion"] = alarma.parametro;   // Alias para alarmas de calefacción
-        alarmaObj["habilitada"] = alarma.habilitada;
-        
-        // Formatear hora para mostrar (ej: "11:05")
-        char horaFormateada[8];
-        sprintf(horaFormateada, "%02d:%02d", alarma.hora, alarma.minuto);
-        alarmaObj["horaTexto"] = horaFormateada;
-        
-        // Información de estado
-        alarmaObj["indiceArray"] = i; // Para debug
+    // Guardar solo alarmas personalizables
+    for (uint16_t i = 0; i < _num; i++) {
+        if (!_alarmas[i].esPersonalizable) continue;
+        _serializaAlarma(i, alarmasArray.createNestedObject());
     }
-    
-    String resultado;
-    serializeJson(doc, resultado);
-    
-    DBG_ALM_PRINTF("📋 JSON generado con %d alarmas (%d chars)", personalizables, resultado.length());
-    return resultado;
+    return personalizables;
 }
+
+// ============================================================================
+// INSTANTÁNEA BINARIA
+// ============================================================================
 /**
- * @brief Genera JSON con estadísticas completas del sistema de alarmas
- * 
- * @details Construye estructura JSON con información estadística detallada
- *          del sistema de alarmas, incluyendo conteos por categoría, estado de
- *          callbacks, información de memoria y configuración actual del módulo.
- *          Ideal para monitoreo, debug y dashboards administrativos.
+ * @brief Guarda las alarmas personalizables en /alarmas.bin
+ * 
+ * @details **FORMATO:**
+ *          - CabeceraInstantanea: marca, versión, sizeof(Alarm), número de
+ *            alarmas, bytes de textos y CRC32 de todo lo que sigue
+ *          - Las Alarm tal cual están en memoria, seguidas, sin callbacks
+ *            ni ultimaEjecucion (esa va en /alarmas_estado.bin)
+ *          - Los bloques de textos "nombre\0descripcion\0tipo\0cron\0"
  *          
- *          **ESTADÍSTICAS INCLUIDAS:**
- *          - Información general: módulo, versión, timestamp
- *          - Contadores: total, sistema, personalizables, habilitadas, deshabilitadas
- *          - Capacidad: espacioLibre, maxAlarmas, siguienteIdWeb
- *          - Estados: (sin callbacks específicos - módulo genérico)
- *          - Persistencia: archivoJSON, archivoExiste
- *          - Tiempo actual: hora, minuto, diaSemana, diaAno (si RTC válido)
+ *          Se escribe en /alarmas.bin.tmp y después se renombra, de modo que
+ *          un corte a mitad deja siempre una de las dos copias completa. Al
+ *          terminar borra /alarmas_cambios.log, que ya está incluido.
  * 
- * @return String JSON con estadísticas completas del sistema
+ * @return true si la instantánea quedó escrita y renombrada
  * 
- * @note **CONTADORES:** Diferencia alarmas de sistema vs personalizables
- * @note **CALLBACKS:** Indica si están configurados (no null)
- * @note **TIEMPO:** Incluye estado actual del RTC si está sincronizado
- * @note **ARCHIVOS:** Verifica existencia del archivo de persistencia
+ * @note **COMPACTACIÓN:** La llama guardarPendientes() cuando el registro crece
  * 
- * @warning **RTC DEPENDENCY:** Campos de tiempo solo válidos si getLocalTime() funciona
- * @warning **SPIFFS:** Verificación de archivo requiere SPIFFS montado
+ * @since v2.2
+ * @author Julian Salas Bartolomé
+ */
+bool AlarmScheduler::_guardaInstantanea() {
+    static const char aVacio[4] = {};                                       // Textos de una alarma sin bloque
+    CabeceraInstantanea cabecera;
+    uint32_t nCrc = 0;
+    for (uint16_t i = 0; i < _num; ++i) {                                    // Primera pasada: tamaños y CRC para la cabecera
+        if (!_alarmas[i].esPersonalizable) continue;
+        Alarm copia;
+        _alarmaInstantanea(i, copia);
+        nCrc = esp_rom_crc32_le(nCrc, (const uint8_t*)&copia, sizeof(copia));
+        cabecera.nAlarmas++;
+    }
+    for (uint16_t i = 0; i < _num; ++i) {
+        if (!_alarmas[i].esPersonalizable) continue;
+        size_t nTextos = _bytesTextos(i);
+        const char* pTextos = nTextos ? _aTextos[i] : aVacio;
+        if (!nTextos) nTextos = sizeof(aVacio);
+        nCrc = esp_rom_crc32_le(nCrc, (const uint8_t*)pTextos, nTextos);
+        cabecera.nBytesTextos += nTextos;
+    }
+    cabecera.nCrc = nCrc;
+
+    File file = SPIFFS.open(ARCHIVO_INSTANTANEA_TMP, "w");
+    if (!file) {
+        DBG_ALM("❌ Error al crear la instantánea de alarmas");
+        return false;
+    }
+    size_t nEscrito = file.write((const uint8_t*)&cabecera, sizeof(cabecera));
+    for (uint16_t i = 0; i < _num; ++i) {
+        if (!_alarmas[i].esPersonalizable) continue;
+        Alarm copia;
+        _alarmaInstantanea(i, copia);
+        nEscrito += file.write((const uint8_t*)&copia, sizeof(copia));
+    }
+    for (uint16_t i = 0; i < _num; ++i) {
+        if (!_alarmas[i].esPersonalizable) continue;
+        size_t nTextos = _bytesTextos(i);
+        if (nTextos) {
+            nEscrito += file.write((const uint8_t*)_aTextos[i], nTextos);
+        } else {
+            nEscrito += file.write((const uint8_t*)aVacio, sizeof(aVacio));
+        }
+    }
+    file.close();
+    _cuentaEscritura(nEscrito);
+
+    size_t nEsperado = sizeof(cabecera) + cabecera.nAlarmas * sizeof(Alarm) + cabecera.nBytesTextos;
+    if (nEscrito != nEsperado) {
+        DBG_ALM_PRINTF("❌ Instantánea de alarmas incompleta: %u de %u bytes", (unsigned)nEscrito, (unsigned)nEsperado);
+        SPIFFS.remove(ARCHIVO_INSTANTANEA_TMP);
+        return false;
+    }
+    SPIFFS.remove(ARCHIVO_INSTANTANEA);                                     // SPIFFS no renombra sobre un archivo existente
+    if (!SPIFFS.rename(ARCHIVO_INSTANTANEA_TMP, ARCHIVO_INSTANTANEA)) {
+        DBG_ALM("❌ Error al renombrar la instantánea de alarmas");
+        return false;                                                       // begin() la leerá igualmente del .tmp
+    }
+    _nBytesBase = nEscrito;
+
+    // La instantánea ya incluye todo lo anotado en el registro de cambios
+    if (SPIFFS.exists(ARCHIVO_CAMBIOS)) {
+        SPIFFS.remove(ARCHIVO_CAMBIOS);
+    }
+    _nBytesRegistro = 0;
+    DBG_ALM_PRINTF("💾 Instantánea de alarmas guardada: %u alarmas, %u bytes", cabecera.nAlarmas, (unsigned)nEscrito);
+    return true;
+}
+
+/**
+ * @brief Lee una instantánea binaria en el array de alarmas
  * 
- * @see obtenerPersonalizablesJSON(), cargarPersonalizablesDesdeJSON()
- * @see getLocalTime() - Función para obtener tiempo actual
+ * @details Las Alarm se leen con una sola lectura contigua directamente en
+ *          _alarmas[0..n); los textos, con otra a un búfer temporal que se
+ *          reparte en bloques. La instantánea se rechaza entera si la
+ *          cabecera, el tamaño o el CRC32 no coinciden.
  * 
- * @example
- * @code
- * String stats = Alarmas.obtenerEstadisticasJSON(); 
- * Serial.println("Stats: " + stats);
- * ws.textAll("STATS_ALARMAS_WEB:" + stats);
- * @endcode
+ * @param archivo /alarmas.bin o /alarmas.bin.tmp
+ * @return true si se cargó; false deja el array vacío para leer el JSON
  * 
- * @since v2.1 - Sistema de alarmas personalizables vía web
+ * @note **PRECONDICIÓN:** Solo desde begin(), tras clear() (_num == 0)
+ * @note **CALLBACKS:** Quedan a nullptr; los asigna RestaurarCallbacksAlarmas()
+ * 
+ * @since v2.2
  * @author Julian Salas Bartolomé
  */
-String AlarmScheduler::obtenerEstadisticasJSON() {
-    DBG_ALM("📊 Generando estadísticas del sistema...");
-    
-    JsonDocument doc;
-    
-    // Información general
-    doc["modulo"] = "AlarmScheduler";
-    doc["version"] = "2.1";
-    doc["timestamp"] = millis();
-    
-    // Contadores de alarmas
-    uint8_t sistema = 0, personalizables = 0, habilitadas = 0, deshabilitadas = 0;
-    
-    for (uint8_t i = 0; i < _num; i++) {
-        if (_alarmas[i].esPersonalizable) {
-            personalizables++;
-        } else {
-            sistema++;
+bool AlarmScheduler::_cargaInstantanea(const char* archivo) {
+    if (!SPIFFS.exists(archivo)) return false;
+    File file = SPIFFS.open(archivo, "r");
+    if (!file) return false;
+
+    CabeceraInstantanea cabecera;
+    bool lOk = file.read((uint8_t*)&cabecera, sizeof(cabecera)) == sizeof(cabecera) &&
+               cabecera.nMarca == MARCA_INSTANTANEA && cabecera.nVersion == VERSION_INSTANTANEA &&
+               cabecera.nTamAlarma == sizeof(Alarm) && cabecera.nAlarmas <= MAX_ALARMAS &&
+               cabecera.nBytesTextos <= cabecera.nAlarmas * MAX_TEXTOS_ALARMA;
+    uint16_t nTocadas = 0;                                                   // Ranuras que hay que limpiar si falla
+    char* pTextos = nullptr;
+    if (lOk) {
+        size_t nBytesAlarmas = cabecera.nAlarmas * sizeof(Alarm);
+        nTocadas = cabecera.nAlarmas;
+        lOk = file.read((uint8_t*)_alarmas, nBytesAlarmas) == nBytesAlarmas;   // Una lectura, directa al array
+        if (lOk) {
+            pTextos = (char*)malloc(cabecera.nBytesTextos + 1);
+            lOk = pTextos != nullptr &&
+                  file.read((uint8_t*)pTextos, cabecera.nBytesTextos) == cabecera.nBytesTextos;
         }
-        
-        if (_alarmas[i].habilitada) {
-            habilitadas++;
-        } else {
-            deshabilitadas++;
+        if (lOk) {
+            uint32_t nCrc = esp_rom_crc32_le(0, (const uint8_t*)_alarmas, nBytesAlarmas);
+            nCrc = esp_rom_crc32_le(nCrc, (const uint8_t*)pTextos, cabecera.nBytesTextos);
+            lOk = nCrc == cabecera.nCrc;
         }
     }
-    
-    doc["totalAlarmas"] = _num;
-    doc["sistema"] = sistema;
-    doc["personalizables"] = personalizables;
-    doc["habilitadas"] = habilitadas;
-    doc["deshabilitadas"] = deshabilitadas;
-    doc["espacioLibre"] = MAX_ALARMAS - _num;
-    doc["maxAlarmas"] = MAX_ALARMAS;
-        
-    // Información del sistema
-    doc["siguienteIdWeb"] = _siguienteIdWeb;
-    doc["archivoJSON"] = "/alarmas_personalizadas.json";
-    doc["archivoExiste"] = SPIFFS.exists("/alarmas_personalizadas.json");
-    
-    // Estado actual del tiempo
-    struct tm timeinfo;
-    if (getLocalTime(&timeinfo)) {
-        doc["tiempoActual"]["valido"] = true;
-        doc["tiempoActual"]["hora"] = timeinfo.tm_hour;
-        doc["tiempoActual"]["minuto"] = timeinfo.tm_min;
-        doc["tiempoActual"]["diaSemana"] = timeinfo.tm_wday;
-        doc["tiempoActual"]["diaAno"] = timeinfo.tm_yday;
-    } else {
-        doc["tiempoActual"]["valido"] = false;
+    file.close();
+
+    const char* p = pTextos;
+    const char* pFin = pTextos + (lOk ? cabecera.nBytesTextos : 0);
+    for (uint16_t i = 0; lOk && i < cabecera.nAlarmas; ++i) {
+        const char* aTextos[4];
+        for (uint8_t c = 0; lOk && c < 4; ++c) {
+            const char* pCero = (const char*)memchr(p, '\0', pFin - p);
+            lOk = pCero != nullptr;
+            aTextos[c] = p;
+            p = lOk ? pCero + 1 : p;
+        }
+        lOk = lOk && _asignaTextos(i, aTextos[0], aTextos[1], aTextos[2], aTextos[3]);
+        Alarm& alarma = _alarmas[i];
+        alarma.accion = nullptr;                                            // Punteros de otro arranque: no valen
+        alarma.accionExt = nullptr;
+        alarma.accionExt0 = nullptr;
+        alarma.ultimaEjecucion = 0;
+        lOk = lOk && alarma.esPersonalizable && alarma.idWeb > 0;
     }
-    
-    String resultado;
-    serializeJson(doc, resultado);
-    
-    DBG_ALM_PRINTF("📊 Estadísticas generadas (%d chars)", resultado.length());
-    return resultado;
+    free(pTextos);
+
+    if (!lOk) {
+        for (uint16_t i = 0; i < nTocadas; ++i) {
+            _liberaTextos(i);
+            _alarmas[i] = Alarm();
+        }
+        DBG_ALM_PRINTF("⚠️ Instantánea %s no válida, se ignora", archivo);
+        return false;
+    }
+    _num = cabecera.nAlarmas;
+    _nBytesBase = sizeof(cabecera) + cabecera.nAlarmas * sizeof(Alarm) + cabecera.nBytesTextos;
+    for (uint16_t i = 0; i < _num; ++i) {
+        if (_alarmas[i].idWeb >= _siguienteIdWeb) _siguienteIdWeb = _alarmas[i].idWeb + 1;
+    }
+    return true;
 }
+
 /**
- * @brief Carga alarmas personalizables desde archivo JSON en SPIFFS
+ * @brief Copia de una alarma tal como se guarda en la instantánea
  * 
- * @details Lee el archivo JSON de persistencia y recrea todas las alarmas
- *          personalizables en el sistema, validando integridad de datos y
- *          asignando callbacks según configuración. Si el archivo no existe,
- *          crea alarmas por defecto automáticamente.
- *          
- *          **PROCESO DE CARGA:**
- *          1. Verifica existencia del archivo JSON en SPIFFS
- *          2. Si no existe: crea alarmas por defecto y guarda JSON
- *          3. Si existe: lee contenido y parsea JSON
- *          4. Elimina alarmas personalizables existentes (mantiene sistema)
- *          5. Para cada alarma en JSON:
- *             - Valida datos básicos (nombre, hora, minuto, idWeb)
- *             - Convierte día (0-7) a máscara de bits
- *             - Crea alarma en array con todos los campos
- *             - Actualiza siguienteIdWeb si es necesario
- *          6. Actualiza contador total de alarmas
+ * @details Sin punteros a funciones ni ultimaEjecucion, para que el CRC solo
+ *          dependa de la configuración de la alarma. Se copia con memcpy para
+ *          que el relleno de la estructura sea el mismo al calcular el CRC y
+ *          al escribir.
  * 
- * @return bool true si la carga fue exitosa, false si error o archivo corrupto
+ * @since v2.2
+ * @author Julian Salas Bartolomé
+ */
+void AlarmScheduler::_alarmaInstantanea(uint16_t idx, Alarm& copia) const {
+    memcpy(&copia, &_alarmas[idx], sizeof(Alarm));
+    copia.accion = nullptr;
+    copia.accionExt = nullptr;
+    copia.accionExt0 = nullptr;
+    copia.ultimaEjecucion = 0;
+}
+
+/**
+ * @brief Tamaño del bloque de textos de una alarma, con los cuatro terminadores
  * 
- * @note **PRESERVACIÓN:** Mantiene alarmas de sistema intactas
- * @note **VALIDACIÓN:** Descarta alarmas con datos inválidos
- * @note **CALLBACKS:** Requiere callbacks configurados previamente con setCallback*()
- * @note **AUTO-CREACIÓN:** Crea alarmas por defecto si archivo no existe
- * @note **ID MANAGEMENT:** Actualiza siguienteIdWeb para evitar duplicados
+ * @return 0 si la alarma no tiene bloque
  * 
- * @warning **ARCHIVO CORRUPTO:** JSON malformado puede causar pérdida de alarmas
- * @warning **CALLBACKS NULL:** Alarmas sin callback válido no se ejecutarán
- * @warning **SPIFFS:** Requiere sistema de archivos montado
+ * @since v2.2
+ * @author Julian Salas Bartolomé
+ */
+size_t AlarmScheduler::_bytesTextos(uint16_t idx) const {
+    if (_aTextos[idx] == nullptr) return 0;
+    const char* pCron = _texto(idx, 3);
+    return (size_t)(pCron + strlen(pCron) + 1 - _aTextos[idx]);
+}
+
+// ============================================================================
+// PERSISTENCIA INCREMENTAL
+// ============================================================================
+/**
+ * @brief Escribe los campos web de una alarma personalizable en un objeto JSON
  * 
- * @see guardarPersonalizablesEnJSON(), addPersonalizable()
- * @see _crearAlarmasPersonalizablesPorDefecto() - Alarmas por defecto
+ * @details Formato común del JSON de exportación y de los registros "set" de
+ *          /alarmas_cambios.log, de modo que ambos se leen con _leeAlarmaJSON().
  * 
- * @example
- * @code
- * void setup() {
- *     // Configurar callbacks antes de cargar
- *     Alarmas.setCallbackMisa(&accionSecuencia);
- *     Alarmas.setCallbackDifuntos(&accionSecuencia);  
- *     Alarmas.setCallbackFiesta(&accionSecuencia);
- *     
- *     // Cargar alarmas persistidas
- *     if (Alarmas.cargarPersonalizablesDesdeJSON()) {
- *         Serial.println("Alarmas cargadas correctamente");
- *     }
- * }
- * @endcode
+ * @param idx Índice de la alarma
+ * @param alarmaObj Objeto JSON de destino
  * 
- * @since v2.1 - Sistema de alarmas personalizables vía web
+ * @since v2.2
  * @author Julian Salas Bartolomé
  */
-bool AlarmScheduler::cargarPersonalizablesDesdeJSON() {
-    DBG_ALM("📂 Cargando alarmas personalizables desde JSON...");
+void AlarmScheduler::_serializaAlarma(uint16_t idx, JsonObject alarmaObj) {
+    const Alarm& alarma = _alarmas[idx];
     
-    const char* archivo = "/alarmas_personalizadas.json";
+    alarmaObj["id"] = alarma.idWeb;
+    alarmaObj["nombre"] = getNombre(idx);
+    alarmaObj["descripcion"] = getDescripcion(idx);
     
-    if (!SPIFFS.exists(archivo)) {
-        DBG_ALM("📄 Archivo de alarmas no existe, creando alarmas por defecto");
-        _crearAlarmasPersonalizablesPorDefecto();
-        return guardarPersonalizablesEnJSON();
+    // Convertir máscara a día
+    int dia = 0;
+    if (alarma.mascaraDias == DOW_TODOS) {
+        dia = 0;
+    } else {
+        for (int d = 0; d < 7; d++) {
+            if (alarma.mascaraDias & (1 << d)) {
+                dia = d + 1;
+                break;
+            }
+        }
     }
     
-    File file = SPIFFS.open(archivo, "r");
-    if (!file) {
-        DBG_ALM("❌ Error al abrir archivo de alarmas");
+    alarmaObj["dia"] = dia;
+    alarmaObj["hora"] = alarma.hora;
+    alarmaObj["minuto"] = alarma.minuto;
+    alarmaObj["accion"] = getTipo(idx);
+    alarmaObj["habilitada"] = alarma.habilitada;
+    alarmaObj["parametro"] = alarma.parametro;      // ✅ Guardar parámetro (duración para CALEFACCION)
+    alarmaObj["duracion"] = alarma.parametro;       // ✅ Alias para compatibilidad con frontend
+    if (alarma.esCron) {
+        alarmaObj["cron"] = getCron(idx);           // Solo si la alarma usa expresión cron
+    }
+    if (alarma.fiesta != FIESTA_NINGUNA) {
+        alarmaObj["fiesta"] = CALENDARIO::Nombre((FiestaLiturgica)alarma.fiesta);
+        alarmaObj["desplazamiento"] = alarma.desplazamientoDias;
+    }
+    alarmaObj["recuperacion"] = nombreRecuperacion(alarma.recuperacion);
+    alarmaObj["margenRecuperacion"] = alarma.margenRecuperacionMin;
+}
+
+/**
+ * @brief Crea o sustituye la alarma personalizable idx a partir de un objeto JSON
+ * 
+ * @details Valida todos los campos antes de tocar _alarmas[idx]: si la alarma
+ *          no es válida, la ranura queda como estaba.
+ * 
+ * @param alarmaObj Objeto con el formato de _serializaAlarma()
+ * @param idx Ranura de destino (_num para añadir, o la de la alarma con ese idWeb)
+ * @return true si la alarma se ha escrito en la ranura
+ * 
+ * @note **CALLBACK:** Queda a nullptr; lo asigna RestaurarCallbacksAlarmas()
+ * 
+ * @since v2.2
+ * @author Julian Salas Bartolomé
+ */
+bool AlarmScheduler::_leeAlarmaJSON(JsonObject alarmaObj, uint16_t idx) {
+    // Leer datos del JSON
+    const char* nombre = alarmaObj["nombre"] | "";
+    const char* descripcion = alarmaObj["descripcion"] | "";
+    int dia = alarmaObj["dia"] | 0;
+    uint8_t hora = alarmaObj["hora"] | 0;
+    uint8_t minuto = alarmaObj["minuto"] | 0;
+    const char* tipoString = alarmaObj["accion"] | "SISTEMA";
+    bool habilitada = alarmaObj["habilitada"] | true;
+    int idWeb = alarmaObj["id"] | -1;
+    const char* cron = alarmaObj["cron"] | "";
+    bool conCron = cron[0] != '\0';
+    const char* nombreFiesta = alarmaObj["fiesta"] | "";
+    FiestaLiturgica fiesta = CALENDARIO::DesdeNombre(nombreFiesta);
+    int16_t desplazamientoDias = alarmaObj["desplazamiento"] | 0;
+    uint8_t recuperacion = recuperacionDesdeNombre(alarmaObj["recuperacion"] | "TARDE");
+    uint8_t margenRecuperacion = alarmaObj["margenRecuperacion"] | Config::Alarmas::MARGEN_RECUPERACION_MIN;
+    if (nombreFiesta[0] != '\0' && fiesta == FIESTA_NINGUNA) {
+        DBG_ALM_PRINTF("⚠️ Fiesta desconocida, alarma ignorada: %s (%s)", nombre, nombreFiesta);
         return false;
     }
     
-    String contenido = file.readString();
-    file.close();
-    
-    DBG_ALM_PRINTF("📄 Contenido leído (%d bytes)", contenido.length());
-    
-    JsonDocument doc;
-    DeserializationError error = deserializeJson(doc, contenido);
-    
-    if (error) {
-        DBG_ALM_PRINTF("❌ Error parseando JSON: %s", error.c_str());
+    // Validar datos básicos (con cron, hora y minuto no se usan)
+    if (strlen(nombre) == 0 || (!conCron && (hora > 23 || minuto > 59)) || idWeb <= 0) {
+        DBG_ALM_PRINTF("⚠️ Alarma inválida ignorada: %s", nombre);
         return false;
     }
     
-    // Eliminar alarmas personalizables existentes (manteniendo las de sistema)
-    for (int i = _num - 1; i >= 0; i--) {
-        if (_alarmas[i].esPersonalizable) {
-            // Mover alarmas posteriores hacia atrás
-            for (uint8_t j = i; j < _num - 1; j++) {
-                _alarmas[j] = _alarmas[j + 1];
-            }
-            _num--;
-        }
+    // Crear alarma
+    Alarm alarma;                                                           // Cachés y callbacks a cero
+    if (!_asignaCron(alarma, cron)) {
+        DBG_ALM_PRINTF("⚠️ Expresión cron no válida, alarma ignorada: %s (%s)", nombre, cron);
+        return false;
     }
-    
-    // Cargar alarmas del JSON
-    JsonArray alarmasArray = doc["alarmas"];
-    int cargadas = 0;
-    
-    for (JsonObject alarmaObj : alarmasArray) {
-        if (_num >= MAX_ALARMAS) {
-            DBG_ALM("⚠️ Máximo de alarmas alcanzado, ignorando restantes");
-            break;
-        }
-        
-        // Leer datos del JSON
-        const char* nombre = alarmaObj["nombre"] | "";
-        const char* descripcion = alarmaObj["descripcion"] | "";
-        int dia = alarmaObj["dia"] | 0;
-        uint8_t hora = alarmaObj["hora"] | 0;
-        uint8_t minuto = alarmaObj["minuto"] | 0;
-        const char* tipoString = alarmaObj["accion"] | "SISTEMA";
-        bool habilitada = alarmaObj["habilitada"] | true;
-        int idWeb = alarmaObj["id"] | -1;
-        
-        // Validar datos básicos
-        if (strlen(nombre) == 0 || hora > 23 || minuto > 59 || idWeb <= 0) {
-            DBG_ALM_PRINTF("⚠️ Alarma inválida ignorada: %s", nombre);
-            continue;
-        }
-        
-        // Convertir día a máscara
-        uint8_t mascaraDias;
-        if (dia == 0) {
-            mascaraDias = DOW_TODOS;
-        } else {
-            mascaraDias = 1 << (dia - 1); // dia 1-7 -> bit 0-6
-        }
-        
-        // Crear alarma
-        Alarm& alarma = _alarmas[_num];
-        alarma.habilitada = habilitada;
-        alarma.mascaraDias = mascaraDias;
-        alarma.hora = hora;
-        alarma.minuto = minuto;
-        alarma.intervaloMin = 0;
-        alarma.parametro = 0;
-        
-        // Campos web
-        strncpy(alarma.nombre, nombre, sizeof(alarma.nombre) - 1);
-        alarma.nombre[sizeof(alarma.nombre) - 1] = '\0';
-        
-        strncpy(alarma.descripcion, descripcion, sizeof(alarma.descripcion) - 1);
-        alarma.descripcion[sizeof(alarma.descripcion) - 1] = '\0';
-        
-        strncpy(alarma.tipoString, tipoString, sizeof(alarma.tipoString) - 1);
-        alarma.tipoString[sizeof(alarma.tipoString) - 1] = '\0';
-            
-        alarma.esPersonalizable = true;
-        alarma.idWeb = idWeb;
-        
-        // Leer parámetro desde JSON (se usará para callback específico)
-        uint16_t parametroJson = alarmaObj["parametro"] | 0;
-        alarma.parametro = parametroJson;
-        
-        // ⚠️ CALLBACK se asigna DESPUÉS mediante restaurarCallbacksAlarmas()
-        // No se puede asignar aquí porque sería dependiente del proyecto
-        alarma.accionExt = nullptr;
-         
-        // Actualizar siguiente ID si es necesario
-        if (idWeb >= _siguienteIdWeb) {
-            _siguienteIdWeb = idWeb + 1;
-        }
-        
-        _num++;
-        cargadas++;
-        
-        DBG_ALM_PRINTF("✅ Alarma cargada: %s (%s %02d:%02d)", 
-                      nombre, _diaToString(dia).c_str(), hora, minuto);
+    if (!_asignaTextos(idx, nombre, descripcion, tipoString, cron)) {       // Campos web, en la tabla de textos
+        return false;
+    }
+    alarma.habilitada = habilitada;
+    alarma.mascaraDias = (dia == 0) ? DOW_TODOS : (uint8_t)(1 << (dia - 1));  // dia 1-7 -> bit 0-6
+    alarma.hora = hora;
+    alarma.minuto = minuto;
+    alarma.intervaloMin = 0;
+    alarma.fiesta = fiesta;
+    alarma.desplazamientoDias = desplazamientoDias;
+    alarma.recuperacion = (recuperacion <= RECUP_ULTIMA) ? recuperacion : RECUP_TARDE;
+    alarma.margenRecuperacionMin = margenRecuperacion;
+    alarma.parametro = alarmaObj["parametro"] | 0;                          // Se usará para el callback específico
+    alarma.esPersonalizable = true;
+    alarma.idWeb = idWeb;
+    _alarmas[idx] = alarma;
+     
+    // Actualizar siguiente ID si es necesario
+    if (idWeb >= _siguienteIdWeb) {
+        _siguienteIdWeb = idWeb + 1;
     }
     
-    DBG_ALM_PRINTF("✅ Alarmas personalizables cargadas: %d", cargadas);
+    DBG_ALM_PRINTF("✅ Alarma cargada: %s (%s %02d:%02d)", 
+                  nombre, _diaToString(dia).c_str(), hora, minuto);
     return true;
 }
+
 /**
- * @brief Guarda alarmas personalizables en archivo JSON en SPIFFS
+ * @brief Quita una alarma ocupando su hueco con la última del array
  * 
- * @details Serializa únicamente las alarmas personalizables a formato JSON
- *          estructurado y las persiste en SPIFFS para supervivencia a reinicios.
- *          Incluye validación de escritura y manejo de errores de filesystem.
- *          
- *          **PROCESO DE GUARDADO:**
- *          1. Crea documento JSON con metadatos (versión, timestamp)
- *          2. Cuenta alarmas personalizables en el sistema
- *          3. Crea array JSON con datos de cada alarma personalizable:
- *             - Convierte máscaras de días a números (0-7)
- *             - Incluye todos los campos web necesarios
- *             - Excluye campos internos (cache, callbacks)
- *          4. Abre archivo en modo escritura (sobreescribe)
- *          5. Serializa JSON directamente al archivo
- *          6. Valida bytes escritos antes de confirmar éxito
+ * @details Un solo movimiento, sin desplazar el resto. Invalida el índice
+ *          porque la última alarma cambia de posición.
  * 
- * @return bool true si el guardado fue exitoso, false si error de escritura
+ * @since v2.2
+ * @author Julian Salas Bartolomé
+ */
+void AlarmScheduler::_quitaAlarma(uint16_t idx) {
+    uint16_t ultima = _num - 1;
+    _liberaTextos(idx);
+    if (idx != ultima) {
+        _alarmas[idx] = _alarmas[ultima];
+        _aTextos[idx] = _aTextos[ultima];
+        _aTextos[ultima] = nullptr;
+    }
+    _alarmas[ultima] = Alarm();
+    _num--;
+    _invalidaIndice();
+}
+
+/**
+ * @brief Anota que una alarma personalizable ha cambiado
  * 
- * @note **FILTRADO:** Solo guarda alarmas con esPersonalizable = true
- * @note **FORMATO:** JSON compatible con cargarPersonalizablesDesdeJSON()
- * @note **SOBREESCRITURA:** Reemplaza archivo existente completamente
- * @note **VALIDACIÓN:** Verifica operación de escritura antes de confirmar
- * @note **METADATOS:** Incluye versión y timestamp para control de versiones
+ * @details Varios cambios de la misma alarma se agrupan en una sola entrada;
+ *          un cambio completo prevalece sobre uno de habilitación. Si la lista
+ *          se llena, el próximo guardado reescribe la instantánea completa.
  * 
- * @warning **ESPACIO DISCO:** Requiere SPIFFS montado y espacio suficiente
- * @warning **OPERACIÓN SÍNCRONA:** Puede bloquear temporalmente (ms) durante escritura
- * @warning **PÉRDIDA DATOS:** Error de escritura puede corromper archivo existente
+ * @param idWeb ID web de la alarma (puede ya no existir si se ha borrado)
+ * @param tipo CAMBIO_HABILITADA o CAMBIO_COMPLETO
  * 
- * @see cargarPersonalizablesDesdeJSON(), obtenerPersonalizablesJSON()
- * @see SPIFFS.open(), serializeJson() - Funciones utilizadas internamente
+ * @note Las ediciones web llegan por ColaComandos y se aplican en loop(), como guardarPendientes()
  * 
- * @example
- * @code
- * // Guardar después de modificar alarma
- * if (Alarmas.modificarPersonalizable(id, "Nueva Misa", "", DOW_DOMINGO, 12, 0, "MISA", true)) {
- *     // El guardado se hace automáticamente, pero se puede verificar:
- *     Serial.println("Alarma modificada y guardada");
- * }
+ * @since v2.2
+ * @author Julian Salas Bartolomé
+ */
+void AlarmScheduler::_anotaCambio(int idWeb, uint8_t tipo) {
+    uint32_t nAhora = millis();
+    if (_nCambios == 0 && !_lCompactar) _nPrimerCambioMs = nAhora;
+    _nUltimoCambioMs = nAhora;
+    uint8_t i = 0;
+    while (i < _nCambios && _aCambios[i].idWeb != idWeb) ++i;
+    if (i < _nCambios) {
+        if (tipo > _aCambios[i].tipo) _aCambios[i].tipo = tipo;
+    } else if (_nCambios < MAX_CAMBIOS_PENDIENTES) {
+        _aCambios[_nCambios].idWeb = idWeb;
+        _aCambios[_nCambios].tipo = tipo;
+        _nCambios++;
+    } else {
+        _lCompactar = true;
+    }
+}
+
+/**
+ * @brief Guarda en flash los cambios web anotados, agrupados y con retardo
  * 
- * // Guardado manual explícito
- * if (Alarmas.guardarPersonalizablesEnJSON()) {
- *     Serial.println("Alarmas guardadas en SPIFFS");
- * } else {
- *     Serial.println("Error guardando alarmas");
- * }
- * @endcode
+ * @details Espera RETARDO_GUARDADO_MS sin cambios nuevos (o RETARDO_MAXIMO_MS
+ *          desde el primero) para que una ráfaga de interruptores en la web
+ *          acabe en una sola escritura.
+ *          
+ *          **ESCRITURA (_vuelcaCambios):**
+ *          - Normal: una línea por alarma cambiada al final de /alarmas_cambios.log
+ *          - Compactación: instantánea /alarmas.bin y registro borrado, cuando
+ *            el registro supera REGISTRO_MINIMO_BYTES y el tamaño de la propia
+ *            instantánea, si la lista de cambios se llenó o si falló la
+ *            escritura en el registro
+ *          
+ *          Con el umbral igual al tamaño de la instantánea, cada byte de cambio
+ *          se escribe como mucho dos veces (registro y compactación).
  * 
- * @since v2.1 - Sistema de alarmas personalizables vía web
+ * @note **LLAMADA:** Desde loop(), aunque no haya hora válida
+ * @note **CORTE:** Los cambios de los últimos segundos antes de un corte se pierden
+ * 
+ * @since v2.2
  * @author Julian Salas Bartolomé
  */
-bool AlarmScheduler::guardarPersonalizablesEnJSON() {
-    DBG_ALM("💾 Guardando alarmas personalizables en JSON...");
-    
-    const char* archivo = "/alarmas_personalizadas.json";
-    
-    JsonDocument doc;
-    doc["version"] = "2.1";
-    doc["timestamp"] = millis();
-    
-    // Contar personalizables
-    uint8_t personalizables = 0;
-    for (uint8_t i = 0; i < _num; i++) {
-        if (_alarmas[i].esPersonalizable) {
-            personalizables++;
-        }
-    }
-    
-    doc["total"] = personalizables;
-    
-    JsonArray alarmasArray = doc.createNestedArray("alarmas");
-    
-    // Guardar solo alarmas personalizables
-    for (uint8_t i = 0; i < _num; i++) {
-        const Alarm& alarma = _alarmas[i];
-        
-        if (!alarma.esPersonalizable) continue;
-        
-        JsonObject alarmaObj = alarmasArray.createNestedObject();
-        
-        alarmaObj["id"] = alarma.idWeb;
-        alarmaObj["nombre"] = alarma.nombre;
-        alarmaObj["descripcion"] = alarma.descripcion;
-        
-        // Convertir máscara a día
-        int dia = 0;
-        if (alarma.mascaraDias == DOW_TODOS) {
-            dia = 0;
-        } else {
-            for (int d = 0; d < 7; d++) {
-                if (alarma.mascaraDias & (1 << d)) {
-                    dia = d + 1;
-                    break;
-                }
-            }
-        }
-        
-        alarmaObj["dia"] = dia;
-        alarmaObj["hora"] = alarma.hora;
-        alarmaObj["minuto"] = alarma.minuto;
-        alarmaObj["accion"] = alarma.tipoString;
-        alarmaObj["habilitada"] = alarma.habilitada;
-        alarmaObj["parametro"] = alarma.parametro;  // ✅ Guardar parámetro (duración para CALEFACCION)
-        alarmaObj["duracion"] = alarma.parametro;   // ✅ Alias para compatibilidad con frontend
+void AlarmScheduler::guardarPendientes() {
+    if (_nCambios == 0 && !_lCompactar) return;
+    uint32_t nAhora = millis();
+    if (nAhora - _nUltimoCambioMs < Config::Alarmas::RETARDO_GUARDADO_MS &&
+        nAhora - _nPrimerCambioMs < Config::Alarmas::RETARDO_MAXIMO_MS) return;
+    _vuelcaCambios();
+}
+
+/**
+ * @brief Escribe ya los cambios anotados, sin esperar al retardo
+ * 
+ * @since v2.2
+ * @author Julian Salas Bartolomé
+ */
+void AlarmScheduler::_vuelcaCambios() {
+    if (_nCambios == 0 && !_lCompactar) return;
+
+    CambioPendiente aCambios[MAX_CAMBIOS_PENDIENTES];
+    uint8_t nCambios = _nCambios;
+    bool lCompactar = _lCompactar;
+    memcpy(aCambios, _aCambios, nCambios * sizeof(CambioPendiente));
+    _nCambios = 0;
+    _lCompactar = false;
+
+    uint32_t nUmbral = (_nBytesBase > Config::Alarmas::REGISTRO_MINIMO_BYTES) ? _nBytesBase : Config::Alarmas::REGISTRO_MINIMO_BYTES;
+    if (lCompactar || _nBytesRegistro > nUmbral || !_anadeCambios(aCambios, nCambios)) {
+        DBG_ALM_PRINTF("🗜️ Compactando alarmas (registro %u bytes)", _nBytesRegistro);
+        _guardaInstantanea();
     }
-    
-    // Escribir archivo
-    File file = SPIFFS.open(archivo, "w");
+}
+
+/**
+ * @brief Añade al registro una línea JSON por cambio anotado
+ * 
+ * @details **REGISTROS:**
+ *          - {"op":"set", ...}: alarma completa, formato de _serializaAlarma()
+ *          - {"op":"hab","id":N,"habilitada":b}: solo el estado
+ *          - {"op":"del","id":N}: la alarma ya no existe
+ * 
+ * @return true si todas las líneas se escribieron completas
+ * 
+ * @since v2.2
+ * @author Julian Salas Bartolomé
+ */
+bool AlarmScheduler::_anadeCambios(const CambioPendiente* aCambios, uint8_t nCambios) {
+    File file = SPIFFS.open(ARCHIVO_CAMBIOS, "a");
     if (!file) {
-        DBG_ALM("❌ Error al crear archivo JSON");
+        DBG_ALM("❌ Error al abrir el registro de cambios de alarmas");
         return false;
     }
-    
-    // ✅ PARTE FALTANTE - ESCRIBIR Y CERRAR ARCHIVO
-    size_t bytesEscritos = serializeJson(doc, file);
-    file.close();
-    
-    if (bytesEscritos == 0) {
-        DBG_ALM("❌ Error escribiendo JSON - 0 bytes escritos");
-        return false;
+    bool lOk = true;
+    size_t nEscrito = 0;
+    for (uint8_t c = 0; c < nCambios; ++c) {
+        JsonDocument doc;
+        uint16_t idx = _buscarIndicePorIdWeb(aCambios[c].idWeb);
+        if (idx >= MAX_ALARMAS) {
+            doc["op"] = "del";
+            doc["id"] = aCambios[c].idWeb;
+        } else if (aCambios[c].tipo == CAMBIO_HABILITADA) {
+            doc["op"] = "hab";
+            doc["id"] = aCambios[c].idWeb;
+            doc["habilitada"] = _alarmas[idx].habilitada;
+        } else {
+            _serializaAlarma(idx, doc.to<JsonObject>());
+            doc["op"] = "set";
+        }
+        size_t nLinea = serializeJson(doc, file);
+        nLinea += file.write('\n');
+        if (nLinea != measureJson(doc) + 1) lOk = false;
+        nEscrito += nLinea;
     }
-    
-    DBG_ALM_PRINTF("✅ JSON guardado exitosamente: %d alarmas, %d bytes", personalizables, bytesEscritos);
-    
-    // ✅ VERIFICACIÓN OPCIONAL - Comprobar que el archivo se escribió
-    if (SPIFFS.exists(archivo)) {
-        File verificacion = SPIFFS.open(archivo, "r");
-        if (verificacion) {
-            size_t tamanoArchivo = verificacion.size();
-            verificacion.close();
-            DBG_ALM_PRINTF("✅ Archivo verificado: %d bytes en disco", tamanoArchivo);
+    file.close();
+    _cuentaEscritura(nEscrito);
+    _nBytesRegistro += nEscrito;
+    DBG_ALM_PRINTF("💾 %u cambios de alarmas añadidos al registro (%u bytes)", nCambios, (unsigned)nEscrito);
+    return lOk;
+}
+
+/**
+ * @brief Aplica /alarmas_cambios.log sobre las alarmas cargadas de la instantánea
+ * 
+ * @details Las líneas se aplican en orden y son idempotentes (por idWeb), así
+ *          que un corte durante la compactación no duplica nada. Una última
+ *          línea truncada por un corte se ignora.
+ * 
+ * @since v2.2
+ * @author Julian Salas Bartolomé
+ */
+void AlarmScheduler::_aplicaRegistroCambios() {
+    _nBytesRegistro = 0;
+    if (!SPIFFS.exists(ARCHIVO_CAMBIOS)) return;
+
+    File file = SPIFFS.open(ARCHIVO_CAMBIOS, "r");
+    if (!file) return;
+    _nBytesRegistro = file.size();
+
+    int nAplicados = 0;
+    while (file.available()) {
+        String linea = file.readStringUntil('\n');
+        JsonDocument doc;
+        if (linea.length() == 0 || deserializeJson(doc, linea)) continue;
+
+        const char* op = doc["op"] | "";
+        int idWeb = doc["id"] | -1;
+        uint16_t idx = _buscarIndicePorIdWeb(idWeb);
+        if (strcmp(op, "del") == 0) {
+            if (idx < MAX_ALARMAS) _quitaAlarma(idx);
+        } else if (strcmp(op, "hab") == 0) {
+            if (idx < MAX_ALARMAS) _alarmas[idx].habilitada = doc["habilitada"] | true;
+        } else if (strcmp(op, "set") == 0) {
+            if (idx >= MAX_ALARMAS) {
+                if (_num >= MAX_ALARMAS) continue;
+                if (_leeAlarmaJSON(doc.as<JsonObject>(), _num)) _num++;
+            } else {
+                _leeAlarmaJSON(doc.as<JsonObject>(), idx);
+            }
+        } else {
+            continue;
         }
-    } else {
-        DBG_ALM("⚠️ Advertencia: Archivo no encontrado tras guardado");
+        nAplicados++;
     }
-    
-    return true;
+    file.close();
+    DBG_ALM_PRINTF("📜 Registro de cambios aplicado: %d cambios, %u bytes", nAplicados, _nBytesRegistro);
+}
+
+/**
+ * @brief Suma bytes escritos en flash a los contadores de 24 h y total
+ * 
+ * @since v2.2
+ * @author Julian Salas Bartolomé
+ */
+void AlarmScheduler::_cuentaEscritura(size_t nBytes) {
+    uint32_t nAhora = millis();
+    if (nAhora - _nInicioVentanaMs >= 24UL * 3600 * 1000) {                 // Ventana nueva cada 24 h de funcionamiento
+        _nBytesFlashAnterior = _nBytesFlash24h;
+        _nBytesFlash24h = 0;
+        _nInicioVentanaMs = nAhora;
+    }
+    _nBytesFlash24h += nBytes;
+    _nBytesFlashTotal += nBytes;
 }
 
 // ============================================================================
@@ -1826,16 +3790,16 @@ void AlarmScheduler::imprimirTodasLasAlarmas() {
         return;
     }
     
-    for (uint8_t i = 0; i < _num; i++) {
+    for (uint16_t i = 0; i < _num; i++) {
         const Alarm& alarma = _alarmas[i];
         
         Serial.printf("📋 ========== ALARMA ÍNDICE: %u ==========\n", i);
         
         // === IDENTIFICACIÓN ===
         Serial.printf("🆔 ID Web: %d\n", alarma.idWeb);
-        Serial.printf("📛 Nombre: '%s'\n", alarma.nombre);
-        Serial.printf("📝 Descripción: '%s'\n", alarma.descripcion);
-        Serial.printf("🎯 Tipo String: '%s'\n", alarma.tipoString);
+        Serial.printf("📛 Nombre: '%s'\n", getNombre(i));
+        Serial.printf("📝 Descripción: '%s'\n", getDescripcion(i));
+        Serial.printf("🎯 Tipo String: '%s'\n", getTipo(i));
         Serial.printf("⚙️ Es Personalizable: %s\n", alarma.esPersonalizable ? "SÍ" : "NO");
         
         // === HORARIO ===
@@ -1897,9 +3861,6 @@ void AlarmScheduler::imprimirTodasLasAlarmas() {
         Serial.printf("🔗 Acción Externa 0: %s\n", alarma.accionExt0 ? "CONFIGURADO" : "NULL");
         
         // === CACHE TEMPORAL ===
-        Serial.printf("📅 Último Día Año: %d\n", alarma.ultimoDiaAno);
-        Serial.printf("🕐 Último Minuto: %u\n", alarma.ultimoMinuto);
-        Serial.printf("🕐 Última Hora: %u\n", alarma.ultimaHora);
         Serial.printf("⏰ Última Ejecución: %lu\n", (unsigned long)alarma.ultimaEjecucion);
         
         // === HORARIO FORMATEADO ===
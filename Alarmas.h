@@ -27,6 +27,8 @@
  *          4. **Días múltiples:** Máscara de bits para días de la semana
  *          5. **PERSONALIZABLES:** Alarmas editables vía web con persistencia
  *          6. **SISTEMA:** Alarmas predefinidas no editables por usuario
+ *          7. **CRON:** Expresión de 5 campos compilada a bitsets (CronAlarma.h)
+ *          8. **LITÚRGICAS:** Fiesta (fija o móvil desde Pascua) + días + hora (Calendario.h)
  *          
  *          **GESTIÓN WEB DE ALARMAS PERSONALIZABLES:**
  *          - Creación dinámica con nombre, descripción y tipo de acción
@@ -46,13 +48,15 @@
  *          - **EXTENSIBLE:** Fácil añadir nuevos tipos de acción
  *          
  *          **PREVENCIÓN DE DUPLICADOS:**
- *          - Cache por día del año (ultimoDiaAno) para alarmas diarias
- *          - Cache por minuto (ultimoMinuto) para alarmas en mismo día
+ *          - Epoch del último disparo (ultimaEjecucion) frente al próximo disparo en UTC,
+ *            así la hora repetida del cambio de horario no suena dos veces
  *          - Timestamp epoch (ultimaEjecucion) para alarmas de intervalo
  *          - Verificación de estado de secuencia para evitar solapamientos
  *          
  *          **ARQUITECTURA DE PERSISTENCIA:**
- *          - Archivo JSON: /alarmas_personalizadas.json en SPIFFS
+ *          - Instantánea binaria con CRC32: /alarmas.bin, leída en cada arranque
+ *          - Registro de cambios web: /alarmas_cambios.log, compactado en la instantánea
+ *          - Archivo JSON: /alarmas_personalizadas.json, solo para importar y exportar
  *          - Estructura versionada con metadatos de configuración
  *          - Separación clara entre alarmas de sistema y personalizables
  *          - Backup automático y validación de integridad
@@ -80,6 +84,7 @@
  *       - TOGGLE_ALARMA_WEB: Habilitar/deshabilitar alarma
  *       - GET_ALARMAS_WEB: Obtener lista completa JSON
  *       - GET_STATS_ALARMAS_WEB: Obtener estadísticas del sistema
+ *       - GET_AGENDA: Toques previstos de los próximos días (obtenerAgendaJSON)
  * 
  * @warning **DEPENDENCIAS CRÍTICAS:**
  *          - time.h: Funciones de tiempo del sistema (getLocalTime, time_t)
@@ -91,7 +96,7 @@
  *          - **Servidor.cpp:** Configuración de callbacks para alarmas web
  * 
  * @warning **LIMITACIONES:**
- *          - Máximo 16 alarmas simultáneas total (sistema + personalizables)
+ *          - Máximo MAX_ALARMAS (512) alarmas simultáneas total (sistema + personalizables)
  *          - Resolución mínima de 1 minuto (no soporta segundos)
  *          - Cache no persistente (se pierde en reinicios)
  *          - Verificación de RTC requerida para funcionamiento
@@ -131,7 +136,7 @@
  * @example **EJEMPLO DE USO - ALARMA DE SISTEMA:**
  * @code
  * // Crear alarma de sistema básica (no editable por web)
- * uint8_t idx = Alarmas.add(
+ * uint16_t idx = Alarmas.add(
  *     DOW_TODOS,                    // Todos los días
  *     ALARMA_WILDCARD, 0,          // Cada hora en punto
  *     0,                           // No intervalo
@@ -144,7 +149,7 @@
  * @example **EJEMPLO DE USO - ALARMA PERSONALIZABLE VÍA WEB:**
  * @code
  * // Desde Servidor.cpp - procesamiento de comando ADD_ALARMA_WEB
- * uint8_t idx = Alarmas.addPersonalizable(
+ * uint16_t idx = Alarmas.addPersonalizable(
  *     "Misa Domingo",              // Nombre descriptivo
  *     "Primera llamada dominical", // Descripción
  *     DOW_DOMINGO,                 // Solo domingos
@@ -176,10 +181,13 @@
 #include <ArduinoJson.h>
 #include <SPIFFS.h>
 #include <vector>
+#include <freertos/FreeRTOS.h>
 #include "Acciones.h"
 #include "Configuracion.h"
 #include "Debug.h"
 #include "DNSServicio.h"
+#include "CronAlarma.h"
+#include "Calendario.h"
 
 //#define DebugAlarma
 
@@ -197,108 +205,264 @@ enum : uint8_t {
 
 #define ALARMA_WILDCARD 255   // wildcard (*)
 
+// Qué hacer con los disparos perdidos por un corte de luz o de NTP
+enum RecuperacionAlarma : uint8_t {
+    RECUP_OMITIR = 0,                                           // Se pierden (toques de hora, tareas de sistema)
+    RECUP_TARDE,                                                // Se dispara el último si no han pasado más de margenRecuperacionMin
+    RECUP_ULTIMA                                                // Se dispara solo el último, con cualquier retraso dentro del hueco
+};
+
+// Cambio puntual de una alarma personalizable en una fecha concreta
+enum TipoExcepcion : uint8_t {
+    EXCEPCION_OMITIR = 0,                                       // Ese día no suena
+    EXCEPCION_SUSTITUIR,                                        // Suena a su hora con otra acción
+    EXCEPCION_DESPLAZAR                                         // Suena con la misma acción, desplazamientoMin más tarde (o antes)
+};
+
 class AlarmScheduler; // forward
 
+// Solo datos de programación: check() y el índice no leen textos. Campos
+// ordenados de mayor a menor alineación para no dejar huecos de relleno.
 struct Alarm {
-    bool     habilitada          = false;                       // Si la alarma está habilitada
-    uint8_t  mascaraDias         = DOW_TODOS;                   // Máscara de días (bit0=Domingo ... bit6=Sábado)
-    uint8_t  hora                = 0;                           // Hora (0-23 o ALARMA_WILDCARD)
-    uint8_t  minuto              = 0;                           // Minuto (0-59 o ALARMA_WILDCARD)
-    uint16_t intervaloMin        = 0;                           // Intervalo (minutos)
-    int16_t  ultimoDiaAno        = -1;                          // Último día del año
-    uint8_t  ultimoMinuto        = 255;                         // Último minuto  
-    uint8_t  ultimaHora          = 255;                         // Última hora ejecutada (255 inicial)
     time_t   ultimaEjecucion     = 0;                           // Acciones a ejecutar
     void     (AlarmScheduler::*accion)(uint16_t) = nullptr;     // Método miembro
     void     (*accionExt)(uint16_t) = nullptr;                  // Función externa con parámetro
     void     (*accionExt0)() = nullptr;                         // Función externa sin parámetro
+    CronAlarma cron;                                            // Expresión cron compilada (si esCron)
+    int      idWeb               = -1;                          // ID único para interfaz web (-1 si no aplica)  
+    int16_t  desplazamientoDias  = 0;                           // Días desde la fiesta (negativo = antes)
+    uint16_t intervaloMin        = 0;                           // Intervalo (minutos)
     uint16_t parametro           = 0;                           // Parámetro para la acción  
-    //Campos para la personalizacion via web
-    char     nombre[50];                                        // Nombre descriptivo
-    char     descripcion[100];                                  // Descripción opcional  
-    char     tipoString[20];                                    // "MISA", "DIFUNTOS", "FIESTA", "SISTEMA"
-    bool     esPersonalizable;                                  // true = editable vía web, false = sistema
-    int      idWeb = -1;                                        // ID único para interfaz web (-1 si no aplica)  
-    
-   // Constructor para inicializar nuevos campos
-    Alarm() : esPersonalizable(false), idWeb(-1) {
-        nombre[0] = '\0';
-        descripcion[0] = '\0';
-        strcpy(tipoString, "SISTEMA");
-    }    
+    uint8_t  mascaraDias         = DOW_TODOS;                   // Máscara de días (bit0=Domingo ... bit6=Sábado)
+    uint8_t  hora                = 0;                           // Hora (0-23 o ALARMA_WILDCARD)
+    uint8_t  minuto              = 0;                           // Minuto (0-59 o ALARMA_WILDCARD)
+    uint8_t  fiesta              = FIESTA_NINGUNA;              // FiestaLiturgica de referencia (sustituye a mascaraDias)
+    uint8_t  recuperacion        = RECUP_OMITIR;                // RecuperacionAlarma tras un hueco sin check()
+    uint8_t  margenRecuperacionMin = 0;                         // Retraso máximo con RECUP_TARDE (minutos)
+    bool     habilitada          = false;                       // Si la alarma está habilitada
+    bool     esCron              = false;                       // true = programada por expresión cron (sustituye a día/hora/minuto)
+    bool     esPersonalizable    = false;                       // true = editable vía web, false = sistema
+};
+
+// Límites de los textos web (con terminador); se guardan fuera de Alarm, solo con su longitud real
+constexpr size_t ALARMA_TAM_NOMBRE      = 50;                   // Nombre descriptivo
+constexpr size_t ALARMA_TAM_DESCRIPCION = 100;                  // Descripción opcional
+constexpr size_t ALARMA_TAM_TIPO        = 20;                   // "MISA", "DIFUNTOS", "FIESTA", "SISTEMA"
+
+struct ExcepcionAlarma {
+    void     (*accionExt)(uint16_t) = nullptr;                  // EXCEPCION_SUSTITUIR: acción (la asigna ResuelveAccionAlarma)
+    int      idWeb               = -1;                          // Alarma personalizable afectada
+    uint32_t fecha               = 0;                           // Día local como AAAAMMDD (20261227)
+    int16_t  desplazamientoMin   = 0;                           // EXCEPCION_DESPLAZAR
+    uint16_t parametro           = 0;                           // EXCEPCION_SUSTITUIR: parámetro de la acción
+    uint8_t  tipo                = EXCEPCION_OMITIR;            // TipoExcepcion
+    char     accion[ALARMA_TAM_TIPO] = "";                      // EXCEPCION_SUSTITUIR: tipo web ("FIESTA", ...)
 };
 
 class AlarmScheduler {
 public:
-    static constexpr uint8_t MAX_ALARMAS = 16;
+    static constexpr uint16_t MAX_ALARMAS = Config::Alarmas::MAX_ALARMAS;
     struct tm t;
 
     bool begin(bool cargarPorDefecto = true);
     void check();
-    uint8_t add(uint8_t mascaraDias,
+    uint16_t add(uint8_t mascaraDias,
                     uint8_t hora,
                     uint8_t minuto,
                     uint16_t intervaloMin,
                     void (AlarmScheduler::*accion)(uint16_t),
                     uint16_t parametro = 0,
                     bool habilitada = true);
-    uint8_t addExternal(uint8_t mascaraDias,
+    uint16_t addExternal(uint8_t mascaraDias,
                          uint8_t hora,
                          uint8_t minuto,
                          uint16_t intervaloMin,
                          void (*ext)(uint16_t),
                          uint16_t parametro = 0,
                          bool habilitada = true);      
-    uint8_t addExternal0(uint8_t mascaraDias,
+    uint16_t addExternal0(uint8_t mascaraDias,
                          uint8_t hora,
                          uint8_t minuto,
                          uint16_t intervaloMin,
                          void (*ext0)(),
                          bool habilitada = true);                     
-    void disable(uint8_t idx);
-    void enable(uint8_t idx);
+    void disable(uint16_t idx);
+    void enable(uint16_t idx);
     void clear();
-    uint8_t count() const;
-    const Alarm* get(uint8_t idx) const;
-    Alarm* getMutable(uint8_t idx);  // Permite modificar alarmas (para restaurar callbacks)
+    uint16_t count() const;
+    const Alarm* get(uint16_t idx) const;
+    Alarm* getMutable(uint16_t idx);  // Permite modificar alarmas (para restaurar callbacks)
+    const char* getNombre(uint16_t idx) const;       // Textos web (tabla aparte, "" si no tiene)
+    const char* getDescripcion(uint16_t idx) const;
+    const char* getTipo(uint16_t idx) const;         // "SISTEMA" si no tiene
+    const char* getCron(uint16_t idx) const;         // Expresión cron original ("" si no usa cron)
     bool esHorarioNocturno() const;
     void resetCache();
+    int32_t segundosHastaProximo() const;   // Segundos hasta el próximo disparo (-1 si no hay o el índice no está listo); loop() no duerme con él
+    void guardarPendientes();               // Escribe los cambios web agrupados (llamar desde loop)
 
     // === GESTIÓN WEB DE ALARMAS PERSONALIZABLES ===
-    uint8_t addPersonalizable(const char* nombre, const char* descripcion,
+    uint16_t addPersonalizable(const char* nombre, const char* descripcion,
                          uint8_t mascaraDias, uint8_t hora, uint8_t minuto,
                          const char* tipoString, uint16_t parametro,
-                         void (*callback)(uint16_t), bool habilitada = true);
+                         void (*callback)(uint16_t), bool habilitada = true,
+                         const char* cron = nullptr,
+                         uint8_t fiesta = FIESTA_NINGUNA, int16_t desplazamientoDias = 0,
+                         uint8_t recuperacion = RECUP_TARDE,
+                         uint8_t margenRecuperacionMin = Config::Alarmas::MARGEN_RECUPERACION_MIN);
     
     bool modificarPersonalizable(int idWeb, const char* nombre, const char* descripcion,
                            uint8_t mascaraDias, uint8_t hora, uint8_t minuto,
                            const char* tipoString, bool habilitada,
-                           void (*callback)(uint16_t), uint16_t parametro); 
+                           void (*callback)(uint16_t), uint16_t parametro,
+                           const char* cron = nullptr,
+                           uint8_t fiesta = FIESTA_NINGUNA, int16_t desplazamientoDias = 0,
+                           uint8_t recuperacion = RECUP_TARDE,
+                           uint8_t margenRecuperacionMin = Config::Alarmas::MARGEN_RECUPERACION_MIN); 
     
     bool    eliminarPersonalizable(int idWeb);
     bool    habilitarPersonalizable(int idWeb, bool estado);
     
+    static const char* nombreRecuperacion(uint8_t recuperacion);             // "OMITIR", "TARDE", "ULTIMA"
+    static uint8_t recuperacionDesdeNombre(const char* nombre);             // 255 si no existe
+    
+    // === EXCEPCIONES POR FECHA ===
+    bool    addExcepcion(const ExcepcionAlarma& excepcion);                 // Crea o sustituye la de (idWeb, fecha)
+    bool    eliminarExcepcion(int idWeb, uint32_t fecha);
+    uint8_t countExcepciones() const;
+    ExcepcionAlarma* getExcepcionMutable(uint8_t n);                         // Para restaurar callbacks
+    String  obtenerExcepcionesJSON();
+    static const char* nombreExcepcion(uint8_t tipo);                       // "OMITIR", "SUSTITUIR", "DESPLAZAR"
+    static uint8_t excepcionDesdeNombre(const char* nombre);                // 255 si no existe
+    static uint32_t fechaDesdeTexto(const char* texto);                     // "AAAA-MM-DD" -> AAAAMMDD (0 si no es válida)
+    
+    // === AGENDA ===
+    String  obtenerAgendaJSON(uint8_t nDias);                               // Toques de los próximos nDias (GET_AGENDA)
+    
     String  obtenerPersonalizablesJSON();
     String  obtenerEstadisticasJSON();
     
     bool    cargarPersonalizablesDesdeJSON();
     bool    guardarPersonalizablesEnJSON();
+    String  exportarJSON();                         // JSON de /download, generado desde memoria
+    void    solicitarImportacion();                 // /upload: el próximo begin() lee el JSON
+    bool    importacionSolicitada() const;
     
      void imprimirTodasLasAlarmas();
 
 
 private:
     Alarm  _alarmas[MAX_ALARMAS];
-    uint8_t _num = 0;
+    uint16_t _num = 0;
 
     static uint8_t mascaraDesdeDiaSemana(int diaSemana);
     void initDefaults(); 
 
+    // === TEXTOS WEB (fuera de la ruta de check) ===
+    // Un bloque por alarma con "nombre\0descripcion\0tipo\0cron\0", reservado a su tamaño justo
+    char*   _aTextos[MAX_ALARMAS] = {};
+    bool    _asignaTextos(uint16_t idx, const char* nombre, const char* descripcion,
+                          const char* tipo, const char* cron);
+    void    _liberaTextos(uint16_t idx);
+    const char* _texto(uint16_t idx, uint8_t campo) const;
+
+    // === PERSISTENCIA INCREMENTAL ===
+    // Los cambios web se anotan por idWeb y loop() los añade a /alarmas_cambios.log;
+    // la instantánea /alarmas.bin solo se reescribe al compactar
+    enum : uint8_t { CAMBIO_HABILITADA = 0, CAMBIO_COMPLETO = 1 };
+    struct CambioPendiente {
+        int     idWeb;
+        uint8_t tipo;                       // CAMBIO_HABILITADA o CAMBIO_COMPLETO
+    };
+    static constexpr uint8_t MAX_CAMBIOS_PENDIENTES = 16;
+    CambioPendiente _aCambios[MAX_CAMBIOS_PENDIENTES];
+    uint8_t  _nCambios = 0;
+    bool     _lCompactar = false;           // Demasiados cambios o fallo al añadir: reescribir la instantánea
+    uint32_t _nPrimerCambioMs = 0;
+    uint32_t _nUltimoCambioMs = 0;
+    uint32_t _nBytesRegistro = 0;           // Tamaño actual de /alarmas_cambios.log
+    uint32_t _nBytesBase = 0;               // Tamaño de la última instantánea
+    uint32_t _nBytesFlash24h = 0;           // Bytes escritos en flash en la ventana de 24 h actual
+    uint32_t _nBytesFlashAnterior = 0;      // ... y en la ventana anterior completa
+    uint32_t _nBytesFlashTotal = 0;         // ... desde el arranque
+    uint32_t _nInicioVentanaMs = 0;
+    void    _anotaCambio(int idWeb, uint8_t tipo);
+    void    _vuelcaCambios();
+    bool    _anadeCambios(const CambioPendiente* aCambios, uint8_t nCambios);
+    void    _aplicaRegistroCambios();
+    void    _cuentaEscritura(size_t nBytes);
+    void    _serializaAlarma(uint16_t idx, JsonObject alarmaObj);
+    bool    _leeAlarmaJSON(JsonObject alarmaObj, uint16_t idx);
+    void    _quitaAlarma(uint16_t idx);
+
+    // === INSTANTÁNEA BINARIA ===
+    // /alarmas.bin se lee en cada arranque; el JSON solo se importa y exporta
+    volatile bool _lImportarJSON = false;   // /upload ha subido un JSON nuevo
+    bool     _lCargaBinaria = false;        // El último begin() leyó la instantánea
+    uint32_t _nUsCarga = 0;                 // Duración de la última carga en begin() (us)
+    bool    _guardaInstantanea();
+    bool    _cargaInstantanea(const char* archivo);
+    void    _alarmaInstantanea(uint16_t idx, Alarm& copia) const;
+    size_t  _bytesTextos(uint16_t idx) const;
+    uint16_t _documentoJSON(JsonDocument& doc);
+
+    // === EXCEPCIONES POR FECHA ===
+    // La tabla solo se recorre al cambiar de día o de excepciones; check() mira un bit por alarma
+    ExcepcionAlarma _aExcepciones[Config::Alarmas::MAX_EXCEPCIONES];
+    uint8_t  _nExcepciones = 0;
+    uint32_t _fechaHoy = 0;                 // AAAAMMDD del día de _aExcepcionHoy
+    time_t   _tInicioDia = 0;               // Epoch de las 00:00 de hoy
+    time_t   _tFinDia = 0;                  // Epoch de las 00:00 de mañana (0 = sin calcular)
+    uint32_t _aExcepcionHoy[(MAX_ALARMAS + 31) / 32] = {};  // Alarmas con excepción hoy (un bit por índice)
+    void    _preparaDia(time_t ahora);
+    bool    _excepcionHoy(uint16_t idx) const;
+    bool    _buscaExcepcion(int idWeb, uint32_t fecha, ExcepcionAlarma& excepcion);
+    time_t  _proximoConExcepcion(uint16_t idx, time_t tDesde);
+    void    _ejecutaExcepcion(uint16_t idx, uint32_t fecha);
+    void    _eliminaExcepcionesDe(int idWeb);
+    bool    _guardaExcepciones();
+    void    _cargaExcepciones();
+    static uint32_t _fechaDe(time_t tEpoch);
+    time_t  _siguienteAgenda(uint16_t idx, time_t tAnterior) const;
+
+    // === RECUPERACIÓN DE DISPAROS PERDIDOS ===
+    time_t  _tRecuperarDesde = 0;           // Última revisión guardada antes del reinicio (0 = nada que recuperar)
+    time_t  _tEstadoGuardado = 0;           // Epoch de la última escritura de /alarmas_estado.bin
+    bool    _lEstadoSucio = false;          // Alguna alarma recuperable se ha disparado desde la última escritura
+    void    _ejecutaAccion(uint16_t idx);
+    void    _recuperaHueco(time_t tIni, time_t tFin);
+    time_t  _ultimaOcurrencia(uint16_t idx, time_t tDesde, time_t tFin) const;
+    bool    _guardaEstado(time_t tRevision);
+    void    _cargaEstado();
+
+    // === ÍNDICE DE PRÓXIMOS DISPAROS ===
+    static constexpr uint16_t NO_EN_INDICE = 0xFFFF;
+    static_assert(MAX_ALARMAS < NO_EN_INDICE, "Los índices del montículo son uint16_t");
+    static constexpr uint8_t PALABRAS_PENDIENTES = (MAX_ALARMAS + 31) / 32;
+    time_t   _aProximo[MAX_ALARMAS] = {};   // Próximo disparo (epoch) de cada alarma, 0 = ninguno
+    uint16_t _aHeap[MAX_ALARMAS];           // Montículo mínimo de índices ordenado por _aProximo
+    uint16_t _aPosHeap[MAX_ALARMAS];        // Posición de cada alarma en _aHeap (NO_EN_INDICE si no está)
+    uint16_t _nHeap = 0;                    // Alarmas en el montículo
+    bool     _lIndiceValido = false;        // false = reconstruir en el próximo check()
+    time_t   _tUltimaRevision = 0;          // Epoch del último check() (detecta retrocesos del reloj)
+    uint32_t _aPendientes[PALABRAS_PENDIENTES] = {};          // Alarmas editadas pendientes de recalcular (un bit por índice)
+
+    static time_t _buscaMinuto(uint8_t mascaraDias, uint8_t hora, uint8_t minuto, time_t tDesde);
+    time_t  _calculaProximo(uint16_t idx, time_t tDesde) const;
+    void    _reconstruyeIndice(time_t tDesde);
+    void    _actualizaIndice(uint16_t idx, time_t tDesde);
+    void    _marcaPendiente(uint16_t idx);
+    void    _invalidaIndice();
+    bool    _hayPendientes() const;
+    void    _subeHeap(uint16_t pos);
+    void    _bajaHeap(uint16_t pos);
+    static bool _asignaCron(Alarm& alarma, const char* cron);
+
     // === VARIABLES PARA GESTIÓN WEB ===
     int     _siguienteIdWeb;
     
     // === MÉTODOS AUXILIARES ===
-    uint8_t _buscarIndicePorIdWeb(int idWeb);
+    uint16_t _buscarIndicePorIdWeb(int idWeb);
     int     _generarNuevoIdWeb();
      
     String  _diaToString(int dia);
@@ -0,0 +1,316 @@
+#include "Arbitro.h"
+#include <ArduinoJson.h>
+#include "Auxiliar.h"     // Para EjecutaSecuencia
+#include "Acciones.h"     // Para ejecutaToqueHora y ejecutaToqueMedia
+#include "Campanario.h"   // Para Campanario
+
+ARBITRO Arbitro;
+
+static const char* const NOMBRES_DECISION[] = { "ejecutada", "interrumpida", "encolada", "caducada", "descartada", "cancelada" };
+static const char* const NOMBRES_TIPO[]     = { "secuencia", "hora", "media", "parar" };
+static const char* const NOMBRES_PRIORIDAD[] = { "reloj", "alarma", "manual", "emergencia" };
+
+    /**
+     * @brief Presenta una petición de toque al árbitro
+     *
+     * @details Copia la petición al buffer de entrada con su marca de tiempo y
+     *          su plazo. No decide nada: la decisión se toma en Atiende(), en
+     *          el mismo orden de llegada, desde loop().
+     *
+     * @param tipo Qué se quiere tocar
+     * @param prioridad Prioridad de la petición
+     * @param nParametro Secuencia (TOQUE_SECUENCIA) u hora 0-23 (TOQUE_HORA, TOQUE_MEDIA)
+     * @param nMetodo Config::Telegram::METODO_ACTIVACION_* para las notificaciones
+     * @return true si la petición entró en el buffer, false si estaba lleno
+     *
+     * @note **TAREAS:** Segura desde la tarea del servidor web y desde loop()
+     *
+     * @since v1.7
+     * @author Julian Salas Bartolomé
+     */
+    bool ARBITRO::Solicita(TipoToque tipo, PrioridadToque prioridad, uint16_t nParametro, uint8_t nMetodo) {
+        PeticionToque peticion = { tipo, prioridad, nParametro, nMetodo, (uint32_t)millis(), _PlazoMs(prioridad) };
+        bool lOk = this->_entrada.Encola(peticion);
+        if (!lOk) {
+            this->_nEntradaPerdidas.fetch_add(1, std::memory_order_relaxed);
+            DBG_ARB_PRINTF("Entrada llena: rechazada %s/%s %u", NOMBRES_TIPO[tipo], NOMBRES_PRIORIDAD[prioridad], nParametro);
+        }
+        return lOk;
+    }
+
+    /**
+     * @brief Decide y ejecuta las peticiones pendientes
+     *
+     * @details **PROCESO EN CADA LLAMADA:**
+     *          1. Da por terminado el toque en curso si el campanario ya está libre
+     *          2. Decide, en orden de llegada, sobre las peticiones de la entrada
+     *          3. Caduca las peticiones vencidas de la cola y, si el campanario
+     *             está libre, lanza la de mayor prioridad (la más antigua a igualdad)
+     *
+     * @warning **LOOP:** Llamar solo desde loop(); ejecuta los toques
+     *
+     * @since v1.7
+     * @author Julian Salas Bartolomé
+     */
+    void ARBITRO::Atiende(void) {
+        if (this->_lActual && !Campanario.GetEstadoSecuencia()) {
+            this->_lActual = false;
+        }
+        PeticionToque peticion;
+        while (this->_entrada.Saca(peticion)) {                             // En orden de llegada
+            this->_Decide(peticion);
+        }
+        this->_AtiendeCola();
+    }
+
+    /**
+     * @brief Devuelve el estado del árbitro en JSON
+     *
+     * @details Formato:
+     *          {"actual":{...}|null,"decisiones":n,"perdidas":n,
+     *           "cola":[{tipo,prioridad,parametro,espera}],
+     *           "registro":[{t,decision,tipo,prioridad,parametro}]}
+     *
+     *          El registro va de la decisión más antigua a la más reciente;
+     *          "t" y "espera" son milisegundos desde millis().
+     *
+     * @return Cadena JSON para el comando GET_ARBITRO
+     *
+     * @since v1.7
+     * @author Julian Salas Bartolomé
+     */
+    String ARBITRO::GetEstadoJSON(void) {
+        JsonDocument doc;
+        uint32_t tAhora = millis();
+        if (this->_lActual) {
+            JsonObject actual = doc.createNestedObject("actual");
+            actual["tipo"] = NOMBRES_TIPO[this->_actual.tipo];
+            actual["prioridad"] = NOMBRES_PRIORIDAD[this->_actual.prioridad];
+            actual["parametro"] = this->_actual.parametro;
+        } else {
+            doc["actual"] = nullptr;
+        }
+        doc["decisiones"] = this->_nDecisiones;
+        doc["perdidas"] = this->_nEntradaPerdidas.load(std::memory_order_relaxed);
+
+        JsonArray cola = doc.createNestedArray("cola");
+        for (uint8_t i = 0; i < this->_nCola; ++i) {
+            JsonObject obj = cola.createNestedObject();
+            obj["tipo"] = NOMBRES_TIPO[this->_aCola[i].tipo];
+            obj["prioridad"] = NOMBRES_PRIORIDAD[this->_aCola[i].prioridad];
+            obj["parametro"] = this->_aCola[i].parametro;
+            obj["espera"] = tAhora - this->_aCola[i].tSolicitud;
+        }
+
+        JsonArray registro = doc.createNestedArray("registro");
+        uint32_t nEntradas = (this->_nDecisiones < (uint32_t)Config::Arbitro::TAM_REGISTRO) ? this->_nDecisiones : Config::Arbitro::TAM_REGISTRO;
+        for (uint32_t i = 0; i < nEntradas; ++i) {
+            uint8_t nPos = (uint8_t)((this->_nRegistro + Config::Arbitro::TAM_REGISTRO - nEntradas + i) % Config::Arbitro::TAM_REGISTRO);
+            const DecisionRegistrada& d = this->_aRegistro[nPos];
+            JsonObject obj = registro.createNestedObject();
+            obj["t"] = d.t;
+            obj["decision"] = NOMBRES_DECISION[d.decision];
+            obj["tipo"] = NOMBRES_TIPO[d.tipo];
+            obj["prioridad"] = NOMBRES_PRIORIDAD[d.prioridad];
+            obj["parametro"] = d.parametro;
+        }
+
+        String salida;
+        serializeJson(doc, salida);
+        return salida;
+    }
+
+    /**
+     * @brief Decide sobre una petición recién llegada
+     *
+     * @details **REGLAS:**
+     *          - Parar: cancela la cola, corta lo que suene y para el campanario
+     *          - Campanario libre: la petición suena ya
+     *          - Prioridad mayor que la del toque en curso: lo interrumpe
+     *          - En otro caso: espera en la cola hasta su plazo
+     *
+     * @param peticion Petición sacada del buffer de entrada
+     *
+     * @since v1.7
+     * @author Julian Salas Bartolomé
+     */
+    void ARBITRO::_Decide(const PeticionToque& peticion) {
+        if (peticion.tipo == TOQUE_PARAR) {
+            this->_VaciaCola(DEC_CANCELADA);
+            if (this->_lActual) {
+                this->_Registra(DEC_INTERRUMPIDA, this->_actual);
+                this->_lActual = false;
+            }
+            this->_Registra(DEC_EJECUTADA, peticion);
+            EjecutaSecuencia(Config::States::STOP, peticion.metodo);
+            return;
+        }
+        if (!Campanario.GetEstadoSecuencia()) {
+            this->_Ejecuta(peticion);
+            return;
+        }
+        PrioridadToque prioridadActual = this->_lActual ? this->_actual.prioridad : PRIO_RELOJ;
+        if (peticion.prioridad > prioridadActual) {
+            if (this->_lActual) {
+                this->_Registra(DEC_INTERRUMPIDA, this->_actual);
+                this->_lActual = false;
+            }
+            Campanario.ParaSecuencia();
+            this->_Ejecuta(peticion);
+            return;
+        }
+        this->_Encola(peticion);
+    }
+
+    /**
+     * @brief Hace sonar una petición aceptada
+     *
+     * @details Las secuencias pasan por EjecutaSecuencia() para conservar la
+     *          redirección web y las notificaciones de Telegram; las horas y
+     *          medias usan las acciones de reloj con la hora de la petición.
+     *
+     * @param peticion Petición que pasa a sonar
+     *
+     * @since v1.7
+     * @author Julian Salas Bartolomé
+     */
+    void ARBITRO::_Ejecuta(const PeticionToque& peticion) {
+        this->_Registra(DEC_EJECUTADA, peticion);
+        this->_actual = peticion;
+        this->_lActual = true;
+        switch (peticion.tipo) {
+            case TOQUE_SECUENCIA:
+                EjecutaSecuencia(peticion.parametro, peticion.metodo);
+                break;
+            case TOQUE_HORA:
+                ejecutaToqueHora(peticion.parametro);
+                break;
+            case TOQUE_MEDIA:
+                ejecutaToqueMedia(peticion.parametro);
+                break;
+            default:
+                break;
+        }
+    }
+
+    /**
+     * @brief Guarda una petición en la cola de espera
+     *
+     * @details Con la cola llena se expulsa la petición de menor prioridad (la
+     *          más reciente a igualdad). Si la que llega no supera a ninguna,
+     *          es ella la descartada. Ambos casos quedan en el registro.
+     *
+     * @param peticion Petición que debe esperar
+     *
+     * @since v1.7
+     * @author Julian Salas Bartolomé
+     */
+    void ARBITRO::_Encola(const PeticionToque& peticion) {
+        if (this->_nCola >= Config::Arbitro::TAM_COLA) {
+            uint8_t nPeor = 0;
+            for (uint8_t i = 1; i < this->_nCola; ++i) {
+                const PeticionToque& p = this->_aCola[i];
+                const PeticionToque& peor = this->_aCola[nPeor];
+                if (p.prioridad < peor.prioridad ||
+                    (p.prioridad == peor.prioridad && (int32_t)(p.tSolicitud - peor.tSolicitud) > 0)) {
+                    nPeor = i;
+                }
+            }
+            if (peticion.prioridad <= this->_aCola[nPeor].prioridad) {
+                this->_Registra(DEC_DESCARTADA, peticion);
+                return;
+            }
+            this->_Registra(DEC_DESCARTADA, this->_aCola[nPeor]);
+            this->_aCola[nPeor] = this->_aCola[--this->_nCola];
+        }
+        this->_aCola[this->_nCola++] = peticion;
+        this->_Registra(DEC_ENCOLADA, peticion);
+    }
+
+    /**
+     * @brief Caduca las peticiones vencidas y lanza la siguiente si hay hueco
+     *
+     * @since v1.7
+     * @author Julian Salas Bartolomé
+     */
+    void ARBITRO::_AtiendeCola(void) {
+        uint32_t tAhora = millis();
+        for (uint8_t i = 0; i < this->_nCola; ) {
+            if (tAhora - this->_aCola[i].tSolicitud > this->_aCola[i].nPlazoMs) {
+                this->_Registra(DEC_CADUCADA, this->_aCola[i]);
+                this->_aCola[i] = this->_aCola[--this->_nCola];
+            } else {
+                ++i;
+            }
+        }
+        if (this->_nCola == 0 || Campanario.GetEstadoSecuencia()) {
+            return;
+        }
+        uint8_t nMejor = 0;
+        for (uint8_t i = 1; i < this->_nCola; ++i) {
+            const PeticionToque& p = this->_aCola[i];
+            const PeticionToque& mejor = this->_aCola[nMejor];
+            if (p.prioridad > mejor.prioridad ||
+                (p.prioridad == mejor.prioridad && (int32_t)(p.tSolicitud - mejor.tSolicitud) < 0)) {
+                nMejor = i;
+            }
+        }
+        PeticionToque peticion = this->_aCola[nMejor];
+        this->_aCola[nMejor] = this->_aCola[--this->_nCola];
+        this->_Ejecuta(peticion);
+    }
+
+    /**
+     * @brief Elimina todas las peticiones de la cola anotando la decisión
+     *
+     * @param decision Decisión que se registra para cada petición eliminada
+     *
+     * @since v1.7
+     * @author Julian Salas Bartolomé
+     */
+    void ARBITRO::_VaciaCola(DecisionArbitro decision) {
+        for (uint8_t i = 0; i < this->_nCola; ++i) {
+            this->_Registra(decision, this->_aCola[i]);
+        }
+        this->_nCola = 0;
+    }
+
+    /**
+     * @brief Anota una decisión en el registro circular y en el debug
+     *
+     * @param decision Decisión tomada
+     * @param peticion Petición afectada
+     *
+     * @since v1.7
+     * @author Julian Salas Bartolomé
+     */
+    void ARBITRO::_Registra(DecisionArbitro decision, const PeticionToque& peticion) {
+        DecisionRegistrada& d = this->_aRegistro[this->_nRegistro];
+        d.t = millis();
+        d.decision = decision;
+        d.tipo = peticion.tipo;
+        d.prioridad = peticion.prioridad;
+        d.parametro = peticion.parametro;
+        this->_nRegistro = (uint8_t)((this->_nRegistro + 1) % Config::Arbitro::TAM_REGISTRO);
+        this->_nDecisiones++;
+        DBG_ARB_PRINTF("%s: %s/%s %u (cola %u)", NOMBRES_DECISION[decision], NOMBRES_TIPO[peticion.tipo],
+                       NOMBRES_PRIORIDAD[peticion.prioridad], peticion.parametro, this->_nCola);
+    }
+
+    /**
+     * @brief Plazo máximo de espera en la cola según la prioridad
+     *
+     * @param prioridad Prioridad de la petición
+     * @return Milisegundos de Config::Arbitro
+     *
+     * @since v1.7
+     * @author Julian Salas Bartolomé
+     */
+    uint32_t ARBITRO::_PlazoMs(PrioridadToque prioridad) {
+        switch (prioridad) {
+            case PRIO_RELOJ:      return Config::Arbitro::PLAZO_RELOJ_MS;
+            case PRIO_ALARMA:     return Config::Arbitro::PLAZO_ALARMA_MS;
+            case PRIO_MANUAL:     return Config::Arbitro::PLAZO_MANUAL_MS;
+            default:              return Config::Arbitro::PLAZO_EMERGENCIA_MS;
+        }
+    }
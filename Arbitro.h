@@ -0,0 +1,141 @@
+/**
+ * @file Arbitro.h
+ * @brief Árbitro de prioridades entre toques de reloj, alarmas y toques manuales
+ *
+ * @details Todas las peticiones de toque del campanario (horas, medias,
+ *          alarmas programadas, web, DialCampanario por I2C y parada) pasan
+ *          por este módulo. El árbitro decide en un único punto, desde loop(),
+ *          si cada petición se toca, espera, interrumpe a la que suena o se
+ *          descarta, y deja constancia de cada decisión.
+ *
+ *          **PRIORIDADES (de menor a mayor):**
+ *          - PRIO_RELOJ: toques de hora y media hora
+ *          - PRIO_ALARMA: secuencias litúrgicas de las alarmas programadas
+ *          - PRIO_MANUAL: toques pedidos desde la web o el DialCampanario
+ *          - PRIO_EMERGENCIA: rebato y parada
+ *
+ *          **DECISIONES:**
+ *          - EJECUTADA: el campanario estaba libre y la petición suena ya
+ *          - INTERRUMPIDA: una petición de mayor prioridad corta la que suena
+ *          - ENCOLADA: espera a que el campanario quede libre, con un plazo
+ *          - CADUCADA: venció su plazo en la cola sin llegar a sonar
+ *          - DESCARTADA: la cola estaba llena y tenía la menor prioridad
+ *          - CANCELADA: una parada vació la cola
+ *
+ *          **CONCURRENCIA:**
+ *          - Solicita() puede llamarse desde cualquier tarea (WebSocket, loop)
+ *          - Solo copia la petición a un buffer de entrada sin cerrojos (ColaMPSC)
+ *          - Atiende() decide y ejecuta siempre desde loop()
+ *
+ * @note **TRAZA:** Las últimas decisiones se guardan en un registro circular (GET_ARBITRO)
+ * @note **PLAZOS:** Cada prioridad tiene su plazo máximo de espera en Config::Arbitro
+ *
+ * @warning **ÚNICO CAMINO:** Los toques no deben llamar a EjecutaSecuencia() directamente
+ *
+ * @author Julian Salas Bartolomé
+ * @date 2025-10-16
+ * @version 1.0
+ *
+ * @see Acciones.h - Las alarmas presentan sus toques como peticiones
+ * @see Auxiliar.h - EjecutaSecuencia() ejecuta las peticiones aceptadas
+ * @see Configuracion.h - Config::Arbitro con tamaños y plazos
+ */
+#ifndef ARBITRO_H
+	#define ARBITRO_H
+
+        #include <Arduino.h>
+        #include <freertos/FreeRTOS.h>
+        #include "Debug.h"
+        #include "Configuracion.h"
+        #include "ColaMPSC.h"
+
+        /**
+         * @brief Prioridad de una petición de toque
+         */
+        enum PrioridadToque : uint8_t {
+            PRIO_RELOJ = 0,                                                 //!< Horas y medias
+            PRIO_ALARMA,                                                    //!< Alarmas programadas
+            PRIO_MANUAL,                                                    //!< Web y DialCampanario
+            PRIO_EMERGENCIA                                                 //!< Rebato y parada
+        };
+
+        /**
+         * @brief Tipo de una petición de toque
+         */
+        enum TipoToque : uint8_t {
+            TOQUE_SECUENCIA = 0,                                            //!< Secuencia (Config::States o ID de la biblioteca)
+            TOQUE_HORA,                                                     //!< Toque de hora (parámetro = hora 0-23)
+            TOQUE_MEDIA,                                                    //!< Toque de media hora (parámetro = hora 0-23)
+            TOQUE_PARAR                                                     //!< Parada de la secuencia en curso
+        };
+
+        /**
+         * @brief Decisión del árbitro sobre una petición
+         */
+        enum DecisionArbitro : uint8_t {
+            DEC_EJECUTADA = 0,                                              //!< Suena ya
+            DEC_INTERRUMPIDA,                                               //!< Cortada por otra de mayor prioridad
+            DEC_ENCOLADA,                                                   //!< Espera en la cola
+            DEC_CADUCADA,                                                   //!< Venció su plazo en la cola
+            DEC_DESCARTADA,                                                 //!< Expulsada con la cola llena
+            DEC_CANCELADA                                                   //!< Eliminada por una parada
+        };
+
+        /**
+         * @brief Petición de toque pendiente de decisión
+         */
+        struct PeticionToque {
+            TipoToque tipo;                                                 //!< Qué se quiere tocar
+            PrioridadToque prioridad;                                       //!< Prioridad de la petición
+            uint16_t parametro;                                             //!< Secuencia u hora según el tipo
+            uint8_t metodo;                                                 //!< Config::Telegram::METODO_ACTIVACION_*
+            uint32_t tSolicitud;                                            //!< millis() al presentar la petición
+            uint32_t nPlazoMs;                                              //!< Espera máxima en la cola
+        };
+
+        /**
+         * @brief Entrada del registro de decisiones
+         */
+        struct DecisionRegistrada {
+            uint32_t t;                                                     //!< millis() de la decisión
+            DecisionArbitro decision;                                       //!< Qué se decidió
+            TipoToque tipo;                                                 //!< Tipo de la petición afectada
+            PrioridadToque prioridad;                                       //!< Prioridad de la petición afectada
+            uint16_t parametro;                                             //!< Parámetro de la petición afectada
+        };
+
+        class ARBITRO
+        {
+            public:
+
+                bool Solicita (TipoToque tipo, PrioridadToque prioridad, uint16_t nParametro, uint8_t nMetodo);  //!< Presenta una petición (cualquier tarea)
+                void Atiende (void);                                        //!< Decide y ejecuta las peticiones (desde loop)
+                String GetEstadoJSON (void);                                //!< Toque en curso, cola y registro de decisiones en JSON
+
+            private:
+
+                void _Decide (const PeticionToque& peticion);               //!< Decide sobre una petición recién llegada
+                void _Ejecuta (const PeticionToque& peticion);              //!< Hace sonar una petición aceptada
+                void _Encola (const PeticionToque& peticion);               //!< Guarda una petición en la cola
+                void _AtiendeCola (void);                                   //!< Caduca y lanza las peticiones de la cola
+                void _VaciaCola (DecisionArbitro decision);                 //!< Elimina todas las peticiones de la cola
+                void _Registra (DecisionArbitro decision, const PeticionToque& peticion);  //!< Anota una decisión
+                static uint32_t _PlazoMs (PrioridadToque prioridad);        //!< Plazo de espera de una prioridad
+
+                ColaMPSC<PeticionToque, Config::Arbitro::TAM_ENTRADA> _entrada;  //!< Buffer de entrada entre tareas
+                std::atomic<uint32_t> _nEntradaPerdidas{0};                 //!< Peticiones rechazadas con la entrada llena
+
+                PeticionToque _aCola[Config::Arbitro::TAM_COLA];            //!< Peticiones en espera (sin orden)
+                uint8_t _nCola = 0;                                         //!< Peticiones en la cola
+
+                PeticionToque _actual;                                      //!< Última petición que sonó
+                bool _lActual = false;                                      //!< _actual sigue sonando
+
+                DecisionRegistrada _aRegistro[Config::Arbitro::TAM_REGISTRO];  //!< Registro circular de decisiones
+                uint8_t _nRegistro = 0;                                     //!< Siguiente posición del registro
+                uint32_t _nDecisiones = 0;                                  //!< Decisiones tomadas desde el arranque
+        };
+
+        extern ARBITRO Arbitro;                                             //!< Árbitro único del campanario
+
+#endif
@@ -3,6 +3,7 @@
 #include "ConexionWifi.h"
 #include "DNSServicio.h"  // Para ActualizaDNS
 #include "TelegramServicio.h"  // Para notificaciones Telegram
+#include "Reloj.h"             // Para Reloj::HoraLocal
 
 
 
@@ -25,8 +26,8 @@ double nSegundosTemporizacion = 0;                                      // Tempo
      * 
      * @details Esta función llama al método ActualizarSecuenciaCampanadas() del objeto global
      *          Campanario para verificar si hay una campana que debe sonar en la secuencia actual.
-     *          Si una campana ha sonado, envía un mensaje a todos los clientes WebSocket conectados
-     *          notificando qué campana ha sonado. Si la secuencia de campanadas ha finalizado,
+     *          Si han sonado campanas, lo notifica con notificaToque(): una trama binaria a los clientes
+     *          que la han negociado y un mensaje CAMPANA:n por campana del tiempo a los demás. Si la secuencia de campanadas ha finalizado,
      *          detiene la secuencia y envía una redirección a la página principal.
      *          Se llama desde loop() para testear el estado de las campanas
      * 
@@ -45,8 +46,9 @@ double nSegundosTemporizacion = 0;                                      // Tempo
         nCampanaTocada = Campanario.ActualizarSecuenciaCampanadas();
         if (nCampanaTocada > 0) {
             DBG_AUX_PRINTF("Campana tocada: %d\n", nCampanaTocada);
+            uint8_t nMascara = Campanario.GetMascaraTocada();
             Campanario.ResetCampanaTocada();
-            ws.textAll("CAMPANA:"+String(nCampanaTocada));
+            notificaToque(nMascara);                                            // Trama binaria o "CAMPANA:n" por campana, sin String
             if (!Campanario.GetEstadoSecuencia()) {
                 DBG_AUX_PRINTF("Secuencia de campanadas finalizada.\n");
                 Campanario.ParaSecuencia();
@@ -88,6 +90,8 @@ double nSegundosTemporizacion = 0;                                      // Tempo
      *          - ID Config::States::CALEFACCION_OFF: Apagar calefacción
      *          - ID Config::States::PROTECCION_CAMPANADAS: Activar/Desactivar protección de campanadas
      *         - ID Config::States::SET_TEMPORIZADOR: Configurar temporizador de calefacción (requiere parámetro)
+     *          - ID Config::States::SECUENCIA_REGISTRADA: Secuencia de la biblioteca por índice (requiere parámetro)
+     *          - ID >= Config::Campanario::ID_SECUENCIA_BASE: Secuencia de la biblioteca por ID (CAMPANARIO::IdSecuencia())
      *          
      *          **PROCESO DE EJECUCIÓN:**
      *          1. Verifica validez del ID de secuencia
@@ -208,7 +212,22 @@ double nSegundosTemporizacion = 0;                                      // Tempo
                 }
                 break;
 
+            case Config::States::SECUENCIA_REGISTRADA:
+                EjecutaSecuencia(Campanario.GetIdSecuencia(nParametro), nMetodo);   // Índice de la biblioteca (I2C) -> ID
+                break;
+
             default:
+                if (nSecuencia >= Config::Campanario::ID_SECUENCIA_BASE) {          // ID de la biblioteca de secuencias
+                    int idx = Campanario.BuscaSecuencia((uint16_t)nSecuencia);
+                    if (idx >= 0 && Campanario.TocaSecuencia((uint16_t)nSecuencia)) {
+                        ws.textAll("REDIRECT:/Campanas.html");
+                        DBG_AUX_PRINTF("EjecutaSecuencia -> Iniciando secuencia %s", Campanario.GetNombreSecuencia(idx));
+                        if (telegramBot.isEnabled() && nMetodo != Config::Telegram::METODO_ACTIVACION_OFF) {
+                            telegramBot.sendSequenceNotification(Campanario.GetNombreSecuencia(idx), nMetodo);
+                        }
+                        break;
+                    }
+                }
                 DBG_AUX_PRINTF("EjecutaSecuencia -> Secuencia no reconocida: %d", nSecuencia);
                 break;
         }
@@ -359,13 +378,13 @@ double nSegundosTemporizacion = 0;                                      // Tempo
      * @author Julian Salas Bartolomé
      */
     bool EsPeriodoToqueCampanas(void) {
-        if (!RTC::isNtpSync()) {
+        if (!Reloj::Sincronizado()) {
             DBG_AUX("EsPeriodoToqueCampanas -> RTC no sincronizado con NTP.");
             return false; // Sin sync NTP = sin protección
         }
         
         struct tm localTime;
-        if (!getLocalTime(&localTime)) {
+        if (!Reloj::HoraLocal(&localTime)) {
             DBG_AUX("EsPeriodoToqueCampanas -> Error obteniendo hora del RTC");
             return false; // Sin hora = sin protección
         }
@@ -466,7 +485,9 @@ void IniciaAlarmas (void)
  * @brief Restaura los callbacks de las alarmas personalizables después de cargarlas desde JSON
  * 
  * @details Esta función recorre todas las alarmas cargadas y asigna los callbacks correctos
- *          según el tipo de alarma (MISA, DIFUNTOS, FIESTA, CALEFACCION).
+ *          según el tipo de alarma (MISA, DIFUNTOS, FIESTA, CALEFACCION o una secuencia
+ *          de la biblioteca) con ResuelveAccionAlarma(), igual que al crearlas desde la web.
+ *          También resuelve la acción de las excepciones de tipo SUSTITUIR.
  *          Debe llamarse después de Alarmas.begin() para que las alarmas estén cargadas.
  * 
  * @note Esta función es específica del proyecto y mantiene Alarmas.cpp genérico
@@ -475,39 +496,31 @@ void RestaurarCallbacksAlarmas(void)
 {
     DBG_AUX("🔧 Restaurando callbacks de alarmas personalizables...");
     
-    for (uint8_t i = 0; i < Alarmas.count(); i++) {
+    for (uint16_t i = 0; i < Alarmas.count(); i++) {
         Alarm* alarma = Alarmas.getMutable(i);
         
         if (alarma && alarma->esPersonalizable && alarma->accionExt == nullptr) {
             // La alarma fue cargada desde JSON y necesita su callback
-            
-            if (strcmp(alarma->tipoString, "MISA") == 0) {
-                alarma->accionExt = accionSecuencia;
-                alarma->parametro = Config::States::I2CState::MISA;
-                DBG_AUX_PRINTF("  ✅ Callback MISA restaurado para '%s'", alarma->nombre);
-                
-            } else if (strcmp(alarma->tipoString, "DIFUNTOS") == 0) {
-                alarma->accionExt = accionSecuencia;
-                alarma->parametro = Config::States::I2CState::DIFUNTOS;
-                DBG_AUX_PRINTF("  ✅ Callback DIFUNTOS restaurado para '%s'", alarma->nombre);
-                
-            } else if (strcmp(alarma->tipoString, "FIESTA") == 0) {
-                alarma->accionExt = accionSecuencia;
-                alarma->parametro = Config::States::I2CState::FIESTA;
-                DBG_AUX_PRINTF("  ✅ Callback FIESTA restaurado para '%s'", alarma->nombre);
-                
-            } else if (strcmp(alarma->tipoString, "CALEFACCION") == 0) {
-                alarma->accionExt = accionEnciendeCalefaccion;
-                // El parámetro ya está cargado desde JSON (duración en minutos)
-                DBG_AUX_PRINTF("  ✅ Callback CALEFACCION restaurado para '%s' (%d min)", 
-                              alarma->nombre, alarma->parametro);
-                              
+            // El parámetro de CALEFACCION ya está cargado desde JSON (duración en minutos)
+            if (ResuelveAccionAlarma(Alarmas.getTipo(i), alarma->parametro, alarma->accionExt, alarma->parametro)) {
+                DBG_AUX_PRINTF("  ✅ Callback %s restaurado para '%s' (param=%d)", 
+                              Alarmas.getTipo(i), Alarmas.getNombre(i), alarma->parametro);
             } else {
                 DBG_AUX_PRINTF("  ⚠️ Tipo '%s' desconocido para alarma '%s'", 
-                              alarma->tipoString, alarma->nombre);
+                              Alarmas.getTipo(i), Alarmas.getNombre(i));
             }
         }
     }
+
+    for (uint8_t n = 0; n < Alarmas.countExcepciones(); n++) {
+        ExcepcionAlarma* excepcion = Alarmas.getExcepcionMutable(n);
+        
+        if (excepcion && excepcion->tipo == EXCEPCION_SUSTITUIR && excepcion->accionExt == nullptr &&
+            !ResuelveAccionAlarma(excepcion->accion, excepcion->parametro, excepcion->accionExt, excepcion->parametro)) {
+            DBG_AUX_PRINTF("  ⚠️ Tipo '%s' desconocido para la excepción de la alarma %d", 
+                          excepcion->accion, excepcion->idWeb);
+        }
+    }
     
     DBG_AUX("✅ Callbacks restaurados");
 }
@@ -1,4 +1,5 @@
 #include "Calefaccion.h"
+#include "Reloj.h"
 
     /**
      * @brief Constructor que inicializa el sistema de calefacción con pin específico
@@ -92,7 +93,7 @@
  */
     void CALEFACCION::Enciende(int nMinutos) {
         
-        if (getLocalTime(&this->_tiempoEncendido)) {
+        if (Reloj::HoraLocal(&this->_tiempoEncendido)) {
             this->_nMinutosOn = nMinutos;      // Establece el tiempo solicitado para la calefacción
             this->_lCalefaccion = true;         // Actualiza el estado de la calefacción
             digitalWrite(this->_nPin, HIGH);    // Activa el pin de la calefacción
@@ -238,7 +239,7 @@
         double seconds = 0;
         if (this->_lCalefaccion) {                                                                  // Si la calefacción está encendida
             struct tm tiempoActual;                                                                 // Estructura para obtener el tiempo actual
-            if (getLocalTime(&tiempoActual)) {                                                      // Obtener el tiempo actual del RTC                
+            if (Reloj::HoraLocal(&tiempoActual)) {                                                      // Obtener el tiempo actual del RTC                
                 time_t tiempoEncendido = mktime(&this->_tiempoEncendido);                           // Convertir tiempo de encendido a time_t
                 time_t ahora = mktime(&tiempoActual);                                               // Convertir tiempo actual a time_t
                 seconds = difftime(ahora, tiempoEncendido);                                         // Calcular segundos transcurridos desde el encendido
@@ -255,4 +256,28 @@
             return 0;                                                                               // Si la calefacción está apagada, retorna 0
         }
         
-    }
\ No newline at end of file
+    }
+
+    /**
+     * @brief Segundos que faltan para el apagado automático
+     * 
+     * @details Mismo cálculo que VerificarTemporizador() pero sin apagar la
+     *          calefacción al vencer: el apagado queda para loop(), que es
+     *          quien lo notifica a los clientes y a Telegram.
+     * 
+     * @return Segundos restantes (0 si está apagada, vencida o sin hora)
+     * 
+     * @note **TAREAS:** Apta para consultas desde la tarea del servidor web
+     * 
+     * @since v2.2
+     * @author Julian Salas Bartolomé
+     */
+    double CALEFACCION::SegundosRestantes(void) {
+        if (!this->_lCalefaccion) return 0;
+        struct tm tiempoActual;
+        if (!Reloj::HoraLocal(&tiempoActual)) return 0;
+        struct tm tiempoEncendido = this->_tiempoEncendido;
+        double seconds = difftime(mktime(&tiempoActual), mktime(&tiempoEncendido));
+        double restantes = (this->_nMinutosOn * 60) - seconds;
+        return (restantes > 0) ? restantes : 0;
+    }
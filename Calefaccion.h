@@ -64,6 +64,7 @@
                 void Apaga(void);                                                       //!< Apaga la calefacción
                 bool GetEstado(void);                                                   //!< Devuelve el estado de la calefacción (true si está encendida, false si está apagada)
                 double VerificarTemporizador(void);                                     //!< Verifica si debe apagarse automáticamente por temporizador y devuelve los segundos que faltan para apagarse
+                double SegundosRestantes(void);                                         //!< Segundos que faltan para apagarse, sin apagarla (consultas desde otras tareas)
            private:
 
                 int _nPin;                                                              //!< Pin de la campana    
@@ -0,0 +1,208 @@
+#include "Calendario.h"
+#include "HoraLocal.h"
+#include "Debug.h"
+
+CALENDARIO Calendario;
+
+static const char* const NOMBRES_FIESTA[NUM_FIESTAS] = {
+    "", "CENIZA", "RAMOS", "JUEVES_SANTO", "VIERNES_SANTO", "PASCUA", "ASCENSION",
+    "PENTECOSTES", "TRINIDAD", "CORPUS", "EPIFANIA", "SAN_JOSE", "ASUNCION",
+    "TODOS_SANTOS", "INMACULADA", "NAVIDAD", "PATRON"
+};
+
+static constexpr int MAX_DIAS_BUSQUEDA = 366 + 40;                          // Un año más la oscilación de la Pascua
+
+    static bool _EsBisiesto(int nAno) {
+        return (nAno % 4 == 0 && nAno % 100 != 0) || (nAno % 400 == 0);
+    }
+
+    static int _DiasAno(int nAno) {
+        return _EsBisiesto(nAno) ? 366 : 365;
+    }
+
+    /**
+     * @brief Día del año (0 = 1 de enero) de una fecha
+     */
+    static int _DiaDelAno(int nAno, int nMes, int nDia) {
+        static const uint16_t aAcumulado[12] = { 0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334 };
+        int nDiaAno = aAcumulado[nMes - 1] + nDia - 1;
+        if (nMes > 2 && _EsBisiesto(nAno)) nDiaAno++;
+        return nDiaAno;
+    }
+
+    /**
+     * @brief Calcula el Domingo de Pascua de un año
+     *
+     * @details Algoritmo anónimo gregoriano (Meeus/Jones/Butcher), válido para
+     *          cualquier año del calendario gregoriano. Solo usa aritmética entera.
+     *
+     * @param nAno Año completo (p.ej. 2026)
+     * @param nMes Mes de Pascua (3 o 4)
+     * @param nDia Día del mes de Pascua
+     *
+     * @since v2.2
+     * @author Julian Salas Bartolomé
+     */
+    void CALENDARIO::Pascua(int nAno, int& nMes, int& nDia) {
+        int a = nAno % 19;
+        int b = nAno / 100;
+        int c = nAno % 100;
+        int d = b / 4;
+        int e = b % 4;
+        int f = (b + 8) / 25;
+        int g = (b - f + 1) / 3;
+        int h = (19 * a + b - d - g + 15) % 30;
+        int i = c / 4;
+        int k = c % 4;
+        int l = (32 + 2 * e + 2 * i - h - k) % 7;
+        int m = (a + 11 * h + 22 * l) / 451;
+        nMes = (h + l - 7 * m + 114) / 31;
+        nDia = ((h + l - 7 * m + 114) % 31) + 1;
+    }
+
+    /**
+     * @brief Nombre de una fiesta para JSON y web
+     *
+     * @return "" para FIESTA_NINGUNA o valores fuera de rango
+     */
+    const char* CALENDARIO::Nombre(FiestaLiturgica fiesta) {
+        return (fiesta < NUM_FIESTAS) ? NOMBRES_FIESTA[fiesta] : "";
+    }
+
+    /**
+     * @brief Fiesta a partir de su nombre
+     *
+     * @return FIESTA_NINGUNA si el nombre es vacío o desconocido
+     */
+    FiestaLiturgica CALENDARIO::DesdeNombre(const char* sNombre) {
+        if (sNombre == nullptr || sNombre[0] == '\0') return FIESTA_NINGUNA;
+        for (uint8_t i = 1; i < NUM_FIESTAS; ++i) {
+            if (strcmp(sNombre, NOMBRES_FIESTA[i]) == 0) return (FiestaLiturgica)i;
+        }
+        return FIESTA_NINGUNA;
+    }
+
+    /**
+     * @brief Calcula la tabla de fiestas de un año
+     *
+     * @details Solo recalcula si el año pedido no es el de la tabla actual.
+     *          El coste es un Computus y unas veinte anotaciones.
+     *
+     * @param nAno Año completo
+     *
+     * @since v2.2
+     * @author Julian Salas Bartolomé
+     */
+    void CALENDARIO::_Prepara(int nAno) {
+        if (nAno == this->_nAno) return;
+
+        memset(this->_aDias, 0, sizeof(this->_aDias));
+        this->_nAno = nAno;
+
+        int nMes, nDia;
+        Pascua(nAno, nMes, nDia);
+        int nPascua = _DiaDelAno(nAno, nMes, nDia);                         // Entre 80 y 115: todas caen dentro del año
+
+        this->_Marca(nPascua - 46, FIESTA_CENIZA);
+        this->_Marca(nPascua - 7,  FIESTA_RAMOS);
+        this->_Marca(nPascua - 3,  FIESTA_JUEVES_SANTO);
+        this->_Marca(nPascua - 2,  FIESTA_VIERNES_SANTO);
+        this->_Marca(nPascua,      FIESTA_PASCUA);
+        this->_Marca(nPascua + 39, FIESTA_ASCENSION);
+        this->_Marca(nPascua + 49, FIESTA_PENTECOSTES);
+        this->_Marca(nPascua + 56, FIESTA_TRINIDAD);
+        this->_Marca(nPascua + 60, FIESTA_CORPUS);
+
+        this->_Marca(_DiaDelAno(nAno, 1, 6),   FIESTA_EPIFANIA);
+        this->_Marca(_DiaDelAno(nAno, 3, 19),  FIESTA_SAN_JOSE);
+        this->_Marca(_DiaDelAno(nAno, 8, 15),  FIESTA_ASUNCION);
+        this->_Marca(_DiaDelAno(nAno, 11, 1),  FIESTA_TODOS_SANTOS);
+        this->_Marca(_DiaDelAno(nAno, 12, 8),  FIESTA_INMACULADA);
+        this->_Marca(_DiaDelAno(nAno, 12, 25), FIESTA_NAVIDAD);
+        if (Config::Calendario::PATRON_MES != 2 || Config::Calendario::PATRON_DIA != 29 || _EsBisiesto(nAno)) {
+            this->_Marca(_DiaDelAno(nAno, Config::Calendario::PATRON_MES, Config::Calendario::PATRON_DIA), FIESTA_PATRON);
+        }
+
+        DBG_ALM_PRINTF("[CALENDARIO] Año %d: Pascua %02d/%02d (día %d)", nAno, nDia, nMes, nPascua);
+    }
+
+    void CALENDARIO::_Marca(int nDiaAno, FiestaLiturgica fiesta) {
+        if (nDiaAno < 0 || nDiaAno >= 366) return;
+        this->_aDias[nDiaAno] |= (1UL << fiesta);
+    }
+
+    /**
+     * @brief Fiestas de un día del año
+     *
+     * @param nAno Año completo
+     * @param nDiaAno Día del año (0 = 1 de enero)
+     * @return Bits (1 << FiestaLiturgica) de las fiestas de ese día
+     */
+    uint32_t CALENDARIO::GetFiestas(int nAno, int nDiaAno) {
+        this->_Prepara(nAno);
+        if (nDiaAno < 0 || nDiaAno >= 366) return 0;
+        return this->_aDias[nDiaAno];
+    }
+
+    bool CALENDARIO::EsFiesta(int nAno, int nDiaAno, FiestaLiturgica fiesta) {
+        return (this->GetFiestas(nAno, nDiaAno) & (1UL << fiesta)) != 0;
+    }
+
+    /**
+     * @brief Próximo disparo de una alarma referida a una fiesta
+     *
+     * @details Recorre los días a partir de tDesde con aritmética entera de
+     *          (año, día del año): el día de referencia es el día de disparo
+     *          menos el desplazamiento, y cada comprobación es un acceso a la
+     *          tabla. Solo se convierte a epoch (EpochLocal) el día que coincide.
+     *
+     *          **EJEMPLOS:**
+     *          - FIESTA_PASCUA, +60, 12:00: Corpus Christi a mediodía
+     *          - FIESTA_NAVIDAD, -1, 23:30: Nochebuena antes de la Misa del Gallo
+     *
+     * @param fiesta Fiesta de referencia
+     * @param nDesplazamiento Días desde la fiesta (negativo = antes)
+     * @param nHora Hora local (0-23)
+     * @param nMinuto Minuto (0-59)
+     * @param tDesde Epoch desde el que buscar (incluido)
+     * @return Epoch del próximo disparo, o 0 si la fiesta no es válida
+     *
+     * @note **AÑOS:** Una referencia en otro año (p.ej. NAVIDAD +10) recalcula la tabla una vez
+     *
+     * @since v2.2
+     * @author Julian Salas Bartolomé
+     */
+    time_t CALENDARIO::Siguiente(FiestaLiturgica fiesta, int16_t nDesplazamiento,
+                                 uint8_t nHora, uint8_t nMinuto, time_t tDesde) {
+        if (fiesta == FIESTA_NINGUNA || fiesta >= NUM_FIESTAS || nHora > 23 || nMinuto > 59) return 0;
+
+        struct tm base;
+        localtime_r(&tDesde, &base);
+
+        int nAnoRef = base.tm_year + 1900;                                  // Día de referencia = día de disparo - desplazamiento
+        int nDiaRef = base.tm_yday - nDesplazamiento;
+        while (nDiaRef < 0) {
+            nAnoRef--;
+            nDiaRef += _DiasAno(nAnoRef);
+        }
+        while (nDiaRef >= _DiasAno(nAnoRef)) {
+            nDiaRef -= _DiasAno(nAnoRef);
+            nAnoRef++;
+        }
+
+        for (int nDias = 0; nDias < MAX_DIAS_BUSQUEDA; ++nDias) {
+            if (this->EsFiesta(nAnoRef, nDiaRef, fiesta)) {
+                struct tm candidato = base;
+                candidato.tm_mday += nDias;
+                candidato.tm_hour = nHora;
+                candidato.tm_min = nMinuto;
+                time_t tCandidato = EpochLocal(candidato, tDesde);         // Aplica las reglas del cambio de hora
+                if (tCandidato != (time_t)-1) return tCandidato;
+            }
+            if (++nDiaRef >= _DiasAno(nAnoRef)) {
+                nDiaRef = 0;
+                nAnoRef++;
+            }
+        }
+        return 0;
+    }
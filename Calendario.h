@@ -0,0 +1,91 @@
+/**
+ * @file Calendario.h
+ * @brief Calendario litúrgico con fiestas móviles calculadas a partir de la Pascua
+ *
+ * @details Calcula cada año el Domingo de Pascua (Computus gregoriano) y
+ *          deriva de él las fiestas móviles. Junto con las solemnidades fijas
+ *          y la fiesta patronal local se guardan en una tabla de un entero por
+ *          día del año, de modo que saber si un día es una fiesta cuesta un
+ *          acceso a la tabla.
+ *
+ *          **FIESTAS MÓVILES (desde el Domingo de Pascua):**
+ *          - Miércoles de Ceniza (-46), Domingo de Ramos (-7)
+ *          - Jueves Santo (-3), Viernes Santo (-2), Pascua (0)
+ *          - Ascensión (+39), Pentecostés (+49), Trinidad (+56), Corpus Christi (+60)
+ *
+ *          **FIESTAS FIJAS:**
+ *          - Epifanía, San José, Asunción, Todos los Santos, Inmaculada, Navidad
+ *          - Patrón local: Config::Calendario::PATRON_MES / PATRON_DIA
+ *
+ *          **USO EN ALARMAS:**
+ *          - Una alarma guarda una fiesta y un desplazamiento en días, por
+ *            ejemplo PASCUA +60 a las 12:00 o PATRON +0 a las 11:00
+ *          - Siguiente() da el próximo disparo para el índice de AlarmScheduler
+ *
+ * @note **TABLA:** Se calcula una vez por año (366 enteros); cambiar de año la recalcula
+ * @note **DÍAS:** El día del año empieza en 0 (1 de enero), como tm_yday
+ *
+ * @author Julian Salas Bartolomé
+ * @date 2025-10-17
+ * @version 1.0
+ *
+ * @see Alarmas.h - Alarm::fiesta y Alarm::desplazamientoDias
+ * @see Configuracion.h - Config::Calendario con la fiesta patronal
+ */
+#ifndef CALENDARIO_H
+	#define CALENDARIO_H
+
+        #include <Arduino.h>
+        #include <time.h>
+        #include "Configuracion.h"
+
+        /**
+         * @brief Fiestas que puede referenciar una alarma
+         */
+        enum FiestaLiturgica : uint8_t {
+            FIESTA_NINGUNA = 0,                                             //!< Alarma por día de la semana
+            FIESTA_CENIZA,                                                  //!< Miércoles de Ceniza
+            FIESTA_RAMOS,                                                   //!< Domingo de Ramos
+            FIESTA_JUEVES_SANTO,                                            //!< Jueves Santo
+            FIESTA_VIERNES_SANTO,                                           //!< Viernes Santo
+            FIESTA_PASCUA,                                                  //!< Domingo de Pascua
+            FIESTA_ASCENSION,                                               //!< Ascensión (jueves)
+            FIESTA_PENTECOSTES,                                             //!< Pentecostés
+            FIESTA_TRINIDAD,                                                //!< Santísima Trinidad
+            FIESTA_CORPUS,                                                  //!< Corpus Christi (jueves)
+            FIESTA_EPIFANIA,                                                //!< 6 de enero
+            FIESTA_SAN_JOSE,                                                //!< 19 de marzo
+            FIESTA_ASUNCION,                                                //!< 15 de agosto
+            FIESTA_TODOS_SANTOS,                                            //!< 1 de noviembre
+            FIESTA_INMACULADA,                                              //!< 8 de diciembre
+            FIESTA_NAVIDAD,                                                 //!< 25 de diciembre
+            FIESTA_PATRON,                                                  //!< Fiesta patronal local
+            NUM_FIESTAS                                                     //!< Número de entradas (no es una fiesta)
+        };
+        static_assert(NUM_FIESTAS <= 32, "La tabla usa un bit por fiesta en un uint32_t");
+
+        class CALENDARIO
+        {
+            public:
+
+                static void Pascua (int nAno, int& nMes, int& nDia);        //!< Domingo de Pascua (mes 1-12, día 1-31)
+                static const char* Nombre (FiestaLiturgica fiesta);         //!< Nombre para JSON y web ("PASCUA", ...)
+                static FiestaLiturgica DesdeNombre (const char* sNombre);   //!< Fiesta por nombre (FIESTA_NINGUNA si no existe)
+
+                uint32_t GetFiestas (int nAno, int nDiaAno);                //!< Bits (1 << FiestaLiturgica) del día
+                bool EsFiesta (int nAno, int nDiaAno, FiestaLiturgica fiesta);  //!< El día es esa fiesta
+                time_t Siguiente (FiestaLiturgica fiesta, int16_t nDesplazamiento,
+                                  uint8_t nHora, uint8_t nMinuto, time_t tDesde);  //!< Próximo disparo (0 si ninguno)
+
+            private:
+
+                void _Prepara (int nAno);                                   //!< Calcula la tabla del año si no es la actual
+                void _Marca (int nDiaAno, FiestaLiturgica fiesta);          //!< Anota una fiesta en la tabla
+
+                uint32_t _aDias[366] = {};                                  //!< Fiestas de cada día del año en curso
+                int _nAno = -1;                                             //!< Año de la tabla (-1 = sin calcular)
+        };
+
+        extern CALENDARIO Calendario;                                       //!< Calendario único del campanario
+
+#endif
@@ -15,6 +15,7 @@
      *          4. Log de inicialización para debug
      * 
      * @param nPin Número del pin GPIO para controlar la campana (0-39 en ESP32)
+     * @param nPulsoMs Duración del pulso del badajo en milisegundos (TiempoBadajoOn por defecto)
      * 
      * @note **CONFIGURACIÓN AUTOMÁTICA:** El pin se configura como OUTPUT automáticamente
      * @note **ESTADO INICIAL:** La campana inicia siempre inactiva (LOW)
@@ -41,11 +42,45 @@
      * @since v1.0
      * @author Julian Salas Bartolomé
      */
-    CAMPANA::CAMPANA (int nPin) {
-        // Constructor por defecto
-        this->_nPin = nPin;                     // Asignar el pin de la campana
-        pinMode(this->_nPin, OUTPUT);           // Configurar el pin como salida
-        DBG_CAMPANA_PRINTF("[CAMPANA] Inicializada en pin %d - Estado: INACTIVA\n", _nPin);
+    CAMPANA::CAMPANA (int nPin, uint16_t nPulsoMs)
+        : CAMPANA(Config::Campanario::DefCampana{ (int8_t)nPin, Config::Campanario::SIN_EXPANSOR, 0, nPulsoMs, 0, 0 }) {
+    }
+
+    /**
+     * @brief Constructor a partir de una entrada del banco de campanas
+     * 
+     * @details Toma de Config::Campanario::BANCO_CAMPANAS la dirección física
+     *          del badajo (pin GPIO o canal de expansor), su pulso, su reposo
+     *          mínimo y sus roles, y deja la salida en reposo a través de la
+     *          capa de salida agrupada.
+     * 
+     * @param def Definición de la campana en el banco
+     * 
+     * @note **EXPANSOR:** Salidas.Inicia() debe llamarse antes para que el canal quede en reposo
+     * 
+     * @see SALIDASCAMPANAS::ConfiguraSalida() - Configuración de la salida
+     * 
+     * @since v1.3
+     * @author Julian Salas Bartolomé
+     */
+    CAMPANA::CAMPANA (const Config::Campanario::DefCampana& def) {
+        this->_salida = { def.pin, def.expansor, def.canal };   // Dirección física del badajo
+        this->_nPin = def.pin;                                  // -1 si la campana está en un expansor
+        this->_nPulsoMs = def.pulsoMs;                          // Duración del pulso propia de esta campana
+        this->_nReposoMs = def.reposoMs;                        // Tiempo mínimo entre toques
+        this->_nRoles = def.roles;                              // Horas / cuartos
+        Salidas.ConfiguraSalida(this->_salida);                 // Salida configurada y en reposo
+
+        esp_timer_create_args_t args = {};      // Temporizador one-shot para liberar el badajo
+        args.callback = &CAMPANA::_LiberaBadajo;
+        args.arg = this;
+        args.dispatch_method = ESP_TIMER_TASK;
+        args.name = "badajo";
+        if (esp_timer_create(&args, &this->_hTimerBadajo) != ESP_OK) {
+            this->_hTimerBadajo = nullptr;
+            DBG_CAMPANA_PRINTF("[CAMPANA] ERROR: No se pudo crear el temporizador del pin %d\n", _nPin);
+        }
+        DBG_CAMPANA_PRINTF("[CAMPANA] Inicializada en pin %d (expansor %d canal %d) - Estado: INACTIVA\n", _nPin, def.expansor, def.canal);
     }
 
     /**
@@ -56,9 +91,9 @@
      *          destruido, evitando que quede activado accidentalmente.
      *          
      *          **PROCESO DE DESTRUCCIÓN:**
-     *          1. Establece el pin en estado LOW (inactivo)
-     *          2. Log de destrucción para debug
-     *          3. Liberación automática de recursos
+     *          1. Detiene y libera el temporizador del badajo
+     *          2. Establece el pin en estado LOW (inactivo)
+     *          3. Log de destrucción para debug
      * 
      * @note **SEGURIDAD:** Apagado automático garantizado
      * @note **CLEANUP:** No requiere intervención manual
@@ -71,78 +106,294 @@
      */
 
     CAMPANA::~CAMPANA() {
-        digitalWrite(_nPin, LOW);
+        if (this->_hTimerBadajo != nullptr) {
+            esp_timer_stop(this->_hTimerBadajo);
+            esp_timer_delete(this->_hTimerBadajo);
+            this->_hTimerBadajo = nullptr;
+        }
+        Salidas.Escribe(this->_salida, false);
         DBG_CAMPANA_PRINTF("[CAMPANA] Destructor - Pin %d desactivado por seguridad\n", _nPin);
 
     }
     /**
-     * @brief Activa la campana durante el tiempo especificado (badajo)
+     * @brief Activa la campana y programa la liberación del badajo sin bloquear
      * 
      * @details Método principal que simula el toque de una campana real mediante
-     *          la activación temporal del pin de control. Activa el pin durante
-     *          TiempoBadajoOn milisegundos y luego lo desactiva automáticamente.
+     *          la activación temporal del pin de control. Pone el pin en HIGH y
+     *          arma un esp_timer one-shot de _nPulsoMs milisegundos que lo
+     *          devuelve a LOW desde la tarea de temporizadores, de modo que el
+     *          loop() principal no se detiene durante el golpe.
      *          
      *          **SECUENCIA DE ACTIVACIÓN:**
-     *          1. Establece pin en HIGH (activar relé/solenoide)
-     *          2. Espera TiempoBadajoOn milisegundos (200ms por defecto)
-     *          3. Establece pin en LOW (desactivar relé/solenoide)
-     *          4. Log de la operación para debug
+     *          1. Descarta el toque si el badajo sigue activo o en reposo (el campanario lo difiere)
+     *          2. Registra la marca esp_timer_get_time() y el intervalo desde el toque previo
+     *          3. Establece pin en HIGH (activar relé/solenoide)
+     *          4. Arma el temporizador one-shot de _nPulsoMs ms
+     *          5. _LiberaBadajo() pone el pin en LOW y mide el pulso real
      *          
-     *          **SIMULACIÓN DEL BADAJO:**
-     *          - HIGH: Badajo golpea la campana (activación electromagnética)
-     *          - Delay: Tiempo de contacto y resonancia
-     *          - LOW: Badajo se retira (desactivación electromagnética)
+     *          **MEDICIÓN DE JITTER:**
+     *          - GetUltimoPulsoUs(): duración real del último pulso
+     *          - GetErrorMaxPulsoUs(): peor desviación respecto al pulso programado
+     *          - GetUltimoIntervaloUs(): separación real entre los dos últimos toques
      * 
-     * @note **TIEMPO FIJO:** Utiliza constante TiempoBadajoOn (200ms)
-     * @note **BLOQUEO TEMPORAL:** El hilo se bloquea durante la activación
-     * @note **AUTOMÁTICO:** Desactivación automática tras el delay
+     * @note **NO BLOQUEANTE:** Retorna en microsegundos, sin delay()
+     * @note **SIN TEMPORIZADOR:** Si el esp_timer no pudo crearse se recurre al delay() original
      * 
-     * @warning **FUNCIÓN BLOQUEANTE:** Bloquea ejecución durante 200ms
-     * @warning **NO REENTRANTE:** No llamar mientras está ejecutándose
-     * @warning **THREADING:** En aplicaciones multi-hilo, considerar sincronización
+     * @warning **SOLAPAMIENTO:** Un toque con el badajo activo o en reposo se descarta; CAMPANARIO lo difiere y lo repite
+     * @warning **CONTEXTO:** La liberación se ejecuta en la tarea esp_timer, no en loop()
      * 
      * @see TiempoBadajoOn - Constante que define duración del toque
-     * @see delay() - Función Arduino utilizada para temporización
+     * @see _LiberaBadajo() - Callback que libera el pin
      * 
-     * @example
-     * @code
-     * CAMPANA campanaMayor(12);
+     * @since v1.1
+     * @author Julian Salas Bartolomé
+     */
+    void CAMPANA::Toca(void) {
+        if (this->_hTimerBadajo == nullptr) {                           // Sin temporizador: comportamiento bloqueante original
+            int64_t ahora = esp_timer_get_time();
+            Salidas.Escribe(this->_salida, true);
+            delay(this->_nPulsoMs);
+            Salidas.Escribe(this->_salida, false);
+            this->_nUltimoPulsoUs = (uint32_t)(esp_timer_get_time() - ahora);
+            return;
+        }
+        if (!this->PreparaToque(esp_timer_get_time())) {                // El golpe anterior aún no ha terminado
+            return;
+        }
+        Salidas.Escribe(this->_salida, true);                           // Activar el badajo de la campana
+        this->ArmaLiberacion();                                         // Liberación programada
+        DBG_CAMPANA_PRINTF("[CAMPANA] Toque iniciado en pin %d\n", _nPin);
+    }
+
+    /**
+     * @brief Reserva un toque sin modificar el pin
      * 
-     * // Tocar campana una vez
-     * campanaMayor.Toca();
+     * @details Primera mitad de un disparo agrupado: comprueba que el badajo
+     *          esté libre y fuera de su reposo mínimo, registra la marca temporal común del disparo y el
+     *          intervalo desde el toque previo, y marca el badajo como activo.
+     *          El llamador pone el pin en HIGH (junto con el resto de campanas
+     *          del mismo tiempo) y después invoca ArmaLiberacion().
      * 
-     * // Secuencia de toques (ej: 3 campanadas)
-     * for(int i = 0; i < 3; i++) {
-     *     campanaMayor.Toca();
-     *     delay(1000);  // Pausa entre toques
-     * }
-     * @endcode
+     * @param tAhoraUs Marca esp_timer_get_time() común a todas las campanas del disparo
+     * @return true si el toque queda reservado, false si el badajo sigue activo, en reposo o no hay temporizador
      * 
-     * @example
-     * @code
-     * // Uso en función de acción para alarmas
-     * void accionTocaHora() {
-     *     struct tm t;
-     *     if (getLocalTime(&t)) {
-     *         // Tocar tantas veces como la hora actual
-     *         int hora = t.tm_hour;
-     *         if (hora > 12) hora -= 12;  // Formato 12h
-     *         if (hora == 0) hora = 12;   // Medianoche = 12 toques
-     *         
-     *         for(int i = 0; i < hora; i++) {
-     *             campanaMayor.Toca();
-     *             if (i < hora - 1) delay(800);  // Pausa entre toques
-     *         }
-     *     }
-     * }
-     * @endcode
+     * @see CAMPANARIO::_DisparaMascara() - Único usuario del disparo agrupado
      * 
-     * @since v1.0
+     * @since v1.2
      * @author Julian Salas Bartolomé
      */
-    void CAMPANA::Toca(void) {
-        digitalWrite(this->_nPin, HIGH);                                // Activar el pin de la campana
-        delay(TiempoBadajoOn);                                          // Mantenerlo activo durante 1 segundo
-        digitalWrite(this->_nPin, LOW);                                 // Desactivar el pin de la campana
-        DBG_CAMPANA_PRINTF("[CAMPANA] Toque completado en pin %d\n", _nPin);
+    bool CAMPANA::PreparaToque(int64_t tAhoraUs) {
+        if (this->_hTimerBadajo == nullptr) {
+            return false;
+        }
+        if (this->EnReposo(tAhoraUs)) {
+            DBG_CAMPANA_PRINTF("[CAMPANA] Toque rechazado en pin %d: badajo activo o en reposo\n", _nPin);
+            return false;
+        }
+        if (this->_tInicioToqueUs != 0) {
+            this->_nUltimoIntervaloUs = (uint32_t)(tAhoraUs - this->_tInicioToqueUs);
+        }
+        this->_tInicioToqueUs = tAhoraUs;
+        this->_lBadajoActivo = true;
+        return true;
+    }
+
+    /**
+     * @brief Arma el temporizador que liberará el badajo
+     * 
+     * @details Segunda mitad del disparo agrupado. Se llama inmediatamente
+     *          después de poner el pin en HIGH y programa su vuelta a LOW
+     *          al cabo de nPulsoMs milisegundos, o de _nPulsoMs si es 0.
+     * 
+     * @param nPulsoMs Pulso específico del paso de secuencia (0 = pulso propio de la campana)
+     * 
+     * @since v1.2
+     * @author Julian Salas Bartolomé
+     */
+    void CAMPANA::ArmaLiberacion(uint16_t nPulsoMs) {
+        this->_nPulsoEnCursoMs = (nPulsoMs > 0) ? nPulsoMs : this->_nPulsoMs;
+        esp_timer_start_once(this->_hTimerBadajo, (uint64_t)this->_nPulsoEnCursoMs * 1000ULL);
+    }
+
+    /**
+     * @brief Devuelve el pin GPIO de la campana
+     * 
+     * @return Número de pin configurado en el constructor (-1 si está en un expansor)
+     * 
+     * @since v1.2
+     * @author Julian Salas Bartolomé
+     */
+    int CAMPANA::GetPin(void) {
+        return this->_nPin;
+    }
+
+    /**
+     * @brief Devuelve la dirección física del badajo
+     * 
+     * @return Pin GPIO o canal de expansor de la campana
+     * 
+     * @see SALIDASCAMPANAS::Prepara() - Uso en el disparo agrupado
+     * 
+     * @since v1.3
+     * @author Julian Salas Bartolomé
+     */
+    const SalidaCampana& CAMPANA::GetSalida(void) {
+        return this->_salida;
+    }
+
+    /**
+     * @brief Devuelve los roles de la campana en el banco
+     * 
+     * @return Combinación de Config::Campanario::ROL_HORAS y ROL_CUARTOS
+     * 
+     * @since v1.3
+     * @author Julian Salas Bartolomé
+     */
+    uint8_t CAMPANA::GetRoles(void) {
+        return this->_nRoles;
+    }
+
+    /**
+     * @brief Devuelve el tiempo mínimo entre dos toques de la campana
+     * 
+     * @return Reposo en milisegundos (0 = sin límite)
+     * 
+     * @since v1.3
+     * @author Julian Salas Bartolomé
+     */
+    uint16_t CAMPANA::GetReposoMs(void) {
+        return this->_nReposoMs;
+    }
+
+    /**
+     * @brief Devuelve la duración del pulso de esta campana
+     * 
+     * @return Milisegundos que el badajo permanece activo en cada toque
+     * 
+     * @since v1.2
+     * @author Julian Salas Bartolomé
+     */
+    uint16_t CAMPANA::GetPulsoMs(void) {
+        return this->_nPulsoMs;
+    }
+
+    /**
+     * @brief Ajusta en caliente la duración del pulso de esta campana
+     * 
+     * @details Permite calibrar desde la web el pulso de cada solenoide. El
+     *          valor se limita a Config::Campanario::PULSO_MIN_MS..PULSO_MAX_MS
+     *          y se aplica a partir del siguiente toque.
+     * 
+     * @param nPulsoMs Nueva duración del pulso en milisegundos
+     * @return Pulso finalmente aplicado
+     * 
+     * @note **VOLÁTIL:** El ajuste no se guarda; al reiniciar vuelve a BANCO_CAMPANAS
+     * 
+     * @since v1.4
+     * @author Julian Salas Bartolomé
+     */
+    uint16_t CAMPANA::SetPulsoMs(uint16_t nPulsoMs) {
+        if (nPulsoMs < Config::Campanario::PULSO_MIN_MS) nPulsoMs = Config::Campanario::PULSO_MIN_MS;
+        if (nPulsoMs > Config::Campanario::PULSO_MAX_MS) nPulsoMs = Config::Campanario::PULSO_MAX_MS;
+        this->_nPulsoMs = nPulsoMs;
+        DBG_CAMPANA_PRINTF("[CAMPANA] Pulso del pin %d ajustado a %u ms\n", _nPin, nPulsoMs);
+        return nPulsoMs;
+    }
+
+    /**
+     * @brief Indica si la campana no admite todavía un nuevo toque
+     * 
+     * @details Una campana está en reposo mientras su badajo sigue activo o
+     *          mientras no ha pasado su tiempo mínimo entre toques (_nReposoMs,
+     *          contado desde el inicio del toque anterior).
+     * 
+     * @param tAhoraUs Marca esp_timer_get_time() actual
+     * @return true si un toque ahora debe esperar
+     * 
+     * @see CAMPANARIO::_DisparaMascara() - Difiere los toques de campanas en reposo
+     * 
+     * @since v1.4
+     * @author Julian Salas Bartolomé
+     */
+    bool CAMPANA::EnReposo(int64_t tAhoraUs) {
+        if (this->_lBadajoActivo) return true;
+        if (this->_tInicioToqueUs == 0 || this->_nReposoMs == 0) return false;
+        return (tAhoraUs - this->_tInicioToqueUs) < (int64_t)this->_nReposoMs * 1000;
+    }
+
+    /**
+     * @brief Callback del temporizador que libera el badajo
+     * 
+     * @details Se ejecuta en la tarea esp_timer al vencer el pulso programado.
+     *          Devuelve el pin a LOW, mide la duración real del pulso y
+     *          actualiza la desviación máxima observada.
+     * 
+     * @param pArg Puntero a la instancia CAMPANA que armó el temporizador
+     * 
+     * @warning **CONTEXTO:** No usar Serial ni operaciones largas aquí
+     * 
+     * @since v1.1
+     * @author Julian Salas Bartolomé
+     */
+    void CAMPANA::_LiberaBadajo(void* pArg) {
+        CAMPANA* pCampana = static_cast<CAMPANA*>(pArg);
+        Salidas.Escribe(pCampana->_salida, false);                      // Desactivar el badajo de la campana
+        uint32_t pulso = (uint32_t)(esp_timer_get_time() - pCampana->_tInicioToqueUs);
+        uint32_t objetivo = (uint32_t)pCampana->_nPulsoEnCursoMs * 1000UL;
+        uint32_t error = (pulso > objetivo) ? (pulso - objetivo) : (objetivo - pulso);
+        pCampana->_nUltimoPulsoUs = pulso;
+        if (error > pCampana->_nErrorMaxPulsoUs) {
+            pCampana->_nErrorMaxPulsoUs = error;
+        }
+        pCampana->_lBadajoActivo = false;
+    }
+
+    /**
+     * @brief Indica si el badajo de la campana está activo
+     * 
+     * @return true mientras el pin permanece en HIGH esperando su liberación
+     * 
+     * @since v1.1
+     * @author Julian Salas Bartolomé
+     */
+    bool CAMPANA::GetBadajoActivo(void) {
+        return this->_lBadajoActivo;
+    }
+
+    /**
+     * @brief Devuelve la duración real medida del último pulso
+     * 
+     * @return Microsegundos que el pin estuvo en HIGH en el último toque
+     * 
+     * @since v1.1
+     * @author Julian Salas Bartolomé
+     */
+    uint32_t CAMPANA::GetUltimoPulsoUs(void) {
+        return this->_nUltimoPulsoUs;
+    }
+
+    /**
+     * @brief Devuelve el intervalo real entre los dos últimos toques
+     * 
+     * @return Microsegundos entre el inicio de los dos últimos toques (0 si solo hubo uno)
+     * 
+     * @note **JITTER:** Compararlo con el intervalo programado da el jitter toque a toque
+     * 
+     * @since v1.1
+     * @author Julian Salas Bartolomé
+     */
+    uint32_t CAMPANA::GetUltimoIntervaloUs(void) {
+        return this->_nUltimoIntervaloUs;
+    }
+
+    /**
+     * @brief Devuelve la máxima desviación del pulso respecto al programado
+     * 
+     * @return Microsegundos de error absoluto máximo desde el arranque
+     * 
+     * @since v1.1
+     * @author Julian Salas Bartolomé
+     */
+    uint32_t CAMPANA::GetErrorMaxPulsoUs(void) {
+        return this->_nErrorMaxPulsoUs;
     }
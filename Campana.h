@@ -13,12 +13,14 @@
  *          - Activación/desactivación controlada por software
  *          - Constructor con inicialización automática del pin
  *          - Destructor con apagado seguro
+ *          - Badajo en pin GPIO propio o en canal de expansor I2C (SalidasCampanas.h)
  *          
  *          **CARACTERÍSTICAS TÉCNICAS:**
  *          - Tiempo de activación configurable via TiempoBadajoOn
  *          - Pin configurado automáticamente como OUTPUT
  *          - Estado inicial siempre LOW (campana inactiva)
- *          - Bloqueo durante la activación para evitar solapamientos
+ *          - Liberación del badajo por temporizador esp_timer (no bloqueante)
+ *          - Medición en microsegundos del pulso real y del intervalo entre toques
  *          
  *          **INTEGRACIÓN SISTEMA:**
  *          - Compatible con sistema de secuencias (Campanario.h)
@@ -27,10 +29,10 @@
  *          - Debug integrado para monitorización
  * 
  * @note **HARDWARE:** Diseñado para relés, solenoides o drivers de campana
- * @note **TIMING:** Utiliza delay() para simplicidad - no bloqueante en uso normal
+ * @note **TIMING:** Toca() retorna inmediatamente, el pin se libera desde un esp_timer one-shot
  * @note **SEGURIDAD:** Pin se apaga automáticamente en destructor
  * 
- * @warning **BLOQUEO TEMPORAL:** Durante Toca() el hilo se bloquea 200ms
+ * @warning **SOLAPAMIENTO:** Un Toca() con el badajo activo o en reposo se descarta (el campanario lo difiere)
  * @warning **PIN ÚNICO:** Cada instancia debe usar un pin GPIO diferente
  * @warning **VOLTAJE:** Verificar que el pin soporta el voltaje del relé/solenoide
  * 
@@ -42,29 +44,55 @@
  * @see Campanario.h - Sistema que utiliza múltiples instancias de esta clase
  * @see Acciones.h - Funciones que pueden utilizar campanas individuales
  * 
- * @todo Implementar versión no-bloqueante con timer/interrupt
- * @todo Añadir soporte para diferentes tiempos de badajo por campana
  * @todo Integrar sensor de vibración para feedback del golpe real
  */
 #ifndef CAMPANA_H
 	#define CAMPANA_H
 
         #include <Arduino.h>
+        #include <esp_timer.h>
         #include "Debug.h"
         #include "Configuracion.h"
+        #include "SalidasCampanas.h"
 
-        #define TiempoBadajoOn 200                                          //!< Tiempo que se mantiene el pin de la campana activo (1 segundo)
+        #define TiempoBadajoOn 200                                          //!< Tiempo que se mantiene el pin de la campana activo en milisegundos
 
 
         class CAMPANA 
         {
             public:
 
-                CAMPANA(int nPin );                                         //!< Constructor con pin 
+                CAMPANA(int nPin, uint16_t nPulsoMs = TiempoBadajoOn);      //!< Constructor con pin y duración de pulso propia
+                CAMPANA(const Config::Campanario::DefCampana& def);        //!< Constructor desde una entrada del banco de campanas
                 ~CAMPANA();                                                 //!< Destructor por defecto
-                void Toca (void);                                           //!< Activa la campana durante un tiempo predeterminado
+                void Toca (void);                                           //!< Activa la campana y programa su liberación sin bloquear
+                bool PreparaToque (int64_t tAhoraUs);                       //!< Reserva un toque sin tocar el pin (disparo agrupado por registro)
+                void ArmaLiberacion (uint16_t nPulsoMs = 0);                //!< Arma la liberación del badajo tras un disparo agrupado (0 = pulso propio)
+                int GetPin (void);                                          //!< Devuelve el pin GPIO de la campana (-1 si está en un expansor)
+                const SalidaCampana& GetSalida (void);                      //!< Devuelve la dirección física del badajo
+                uint8_t GetRoles (void);                                    //!< Devuelve los roles de la campana (horas, cuartos)
+                uint16_t GetReposoMs (void);                                //!< Devuelve el tiempo mínimo entre toques
+                uint16_t GetPulsoMs (void);                                 //!< Devuelve la duración del pulso de esta campana
+                uint16_t SetPulsoMs (uint16_t nPulsoMs);                    //!< Ajusta en caliente la duración del pulso (calibración)
+                bool EnReposo (int64_t tAhoraUs);                           //!< true si el badajo está activo o dentro del reposo mínimo
+                bool GetBadajoActivo (void);                                //!< Devuelve true mientras el pin de la campana está en HIGH
+                uint32_t GetUltimoPulsoUs (void);                           //!< Duración real medida del último pulso en microsegundos
+                uint32_t GetUltimoIntervaloUs (void);                       //!< Tiempo entre los dos últimos toques en microsegundos
+                uint32_t GetErrorMaxPulsoUs (void);                         //!< Máxima desviación observada del pulso respecto al programado
            private:
+                static void _LiberaBadajo (void* pArg);                     //!< Callback del esp_timer que devuelve el pin a LOW
                 int _nPin;                                                  //!< Pin de la campana    
+                SalidaCampana _salida;                                      //!< Pin GPIO o canal de expansor del badajo
+                uint16_t _nReposoMs = 0;                                    //!< Tiempo mínimo entre toques en milisegundos
+                uint8_t _nRoles = 0;                                        //!< Roles de la campana en el banco
+                uint16_t _nPulsoMs = TiempoBadajoOn;                        //!< Duración del pulso de esta campana en milisegundos
+                volatile uint16_t _nPulsoEnCursoMs = TiempoBadajoOn;        //!< Pulso programado para el toque en curso
+                esp_timer_handle_t _hTimerBadajo = nullptr;                 //!< Temporizador one-shot que libera el badajo
+                volatile bool _lBadajoActivo = false;                       //!< Pin en HIGH pendiente de liberación
+                volatile int64_t _tInicioToqueUs = 0;                       //!< Marca esp_timer_get_time() del último toque
+                volatile uint32_t _nUltimoPulsoUs = 0;                      //!< Duración medida del último pulso
+                volatile uint32_t _nErrorMaxPulsoUs = 0;                    //!< Máxima desviación absoluta del pulso
+                uint32_t _nUltimoIntervaloUs = 0;                           //!< Intervalo entre los dos últimos toques
         };
 
 #endif
\ No newline at end of file
@@ -1,6 +1,8 @@
 #include "Campanario.h"
 #include <SPIFFS.h>
 #include <FS.h>
+#include "SalidasCampanas.h"
+#include <ArduinoJson.h>
 
     /**
      * @brief Constructor que inicializa el sistema de campanario
@@ -33,12 +35,18 @@
             this->_pCampanas[i] = nullptr;
         }
         this->_nNumCampanas = 0;
+        this->_nMascaraHoras = 0;
+        this->_nMascaraCuartos = 0;
+        this->_DescartaDiferidos();
 
         // Inicializar sistema de secuencias
-        this->_LimpiaraCampanadas();
-        this->_indiceCampanadaActual = 0;
-        this->_ultimoToqueMs = 0;
+        this->_CargaPrograma(nullptr);
+        this->_tInicioSecuenciaUs = 0;
+        this->_nOffsetSiguienteMs = 0;
         this->_tocandoSecuencia = false;
+        this->_nInstrucciones = 0;
+        this->_nSecuencias = 0;
+        memset(this->_aTablaSecuencias, 0, sizeof(this->_aTablaSecuencias));
 
         // Inicializar variables de estado
         this->_nCampanaTocada = 0;
@@ -65,47 +73,33 @@
     CAMPANARIO::~CAMPANARIO() {
         this->ParaSecuencia();
         
-        // Liberar memoria de secuencias dinámicas
-        if (_secuenciaDifuntos) {
-            delete[] _secuenciaDifuntos;
-            _secuenciaDifuntos = nullptr;
-        }
-        if (_secuenciaMisa) {
-            delete[] _secuenciaMisa;
-            _secuenciaMisa = nullptr;
-        }
-        if (_secuenciaFiesta) {
-            delete[] _secuenciaFiesta;
-            _secuenciaFiesta = nullptr;
-        }
-        
         DBG_CAM("[CAMPANARIO] Destructor - Sistema limpiado\n");        
     }
 
     /**
      * @brief Carga las secuencias de campanadas desde archivo JSON
      * 
-     * @details Lee el archivo Secuencias.json desde SPIFFS y carga las tres
-     *          secuencias (Difuntos, Misa, Fiesta) en memoria dinámica.
-     *          Si el archivo no existe, crea uno con valores por defecto.
+     * @details Lee el archivo Secuencias.json desde SPIFFS con un analizador
+     *          de una sola pasada que procesa el archivo por bloques y escribe
+     *          cada paso directamente en el pool preasignado de instrucciones.
+     *          Admite cualquier número de secuencias con nombre, no solo
+     *          difuntos/misa/fiesta.
      *          
      *          **PROCESO DE CARGA:**
      *          1. Verifica existencia del archivo Secuencias.json
-     *          2. Si no existe, crea archivo con secuencias por defecto
-     *          3. Parsea el JSON manualmente (sin ArduinoJson)
-     *          4. Asigna memoria dinámica para cada secuencia
-     *          5. Carga los pasos de cada secuencia
+     *          2. Detiene cualquier secuencia en curso (el pool se reescribe)
+     *          3. Analiza el archivo en streaming con _ParseaSecuencias()
+     *          4. Registra cada secuencia con su nombre, inicio y número de pasos
      * 
      * @return true si las secuencias se cargaron correctamente, false si hubo error
      * 
      * @note **SPIFFS:** Requiere que SPIFFS esté inicializado previamente
-     * @note **MEMORIA:** Asigna memoria dinámica que se libera en el destructor
-     * @note **JSON SIMPLE:** Parseo manual optimizado, sin librerías externas
+     * @note **MEMORIA:** Sin String ni memoria dinámica: bloque de lectura en pila y pool fijo
+     * @note **LÍMITES:** MAX_SECUENCIAS secuencias y MAX_INSTRUCCIONES instrucciones en total
      * 
-     * @warning **MEMORIA LIMITADA:** Verifica que hay suficiente heap antes de cargar
-     * @warning **ARCHIVO CORRUPTO:** Si el JSON está mal formado, usa valores por defecto
+     * @warning **ARCHIVO CORRUPTO:** Si el JSON está mal formado se conservan las secuencias completas leídas hasta el error
      * 
-     * @see CrearSecuenciasPorDefecto() - Crea archivo si no existe
+     * @see _ParseaSecuencias() - Analizador por bloques
      * 
      * @since v1.0.14
      * @author Julian Salas Bartolomé
@@ -121,9 +115,7 @@
         
         // Verificar si existe el archivo
         if (!SPIFFS.exists("/Secuencias.json")) {
-            DBG_CAM("[CAMPANARIO] Secuencias.json no existe, usando valores por defecto hardcodeados");
-            // Por ahora retornamos false para usar las secuencias hardcodeadas
-            // En el futuro se puede crear el archivo automáticamente
+            DBG_CAM("[CAMPANARIO] Secuencias.json no existe, no hay secuencias cargadas");
             return false;
         }
         
@@ -134,208 +126,393 @@
             return false;
         }
         
-        // Leer contenido completo
-        String jsonContent = file.readString();
-        file.close();
+        this->ParaSecuencia();                                                  // El programa en curso apunta al pool que se va a reescribir
+        this->_nSecuencias = 0;
+        this->_nInstrucciones = 0;
+        memset(this->_aTablaSecuencias, 0, sizeof(this->_aTablaSecuencias));
         
-        DBG_CAM_PRINTF("[CAMPANARIO] JSON leído: %d bytes\n", jsonContent.length());
-        
-        // Parsear JSON manualmente (formato simple y conocido)
-        // Buscar cada secuencia y cargarla
-        
-        // Liberar memoria anterior si existe
-        if (_secuenciaDifuntos) delete[] _secuenciaDifuntos;
-        if (_secuenciaMisa) delete[] _secuenciaMisa;
-        if (_secuenciaFiesta) delete[] _secuenciaFiesta;
+        [[maybe_unused]] unsigned long tInicio = micros();
+        bool lOk = this->_ParseaSecuencias(file);
+        file.close();
         
-        // Cargar secuencia de Difuntos
-        int startDifuntos = jsonContent.indexOf("\"difuntos\"");
-        if (startDifuntos > 0) {
-            int startPasos = jsonContent.indexOf("\"pasos\"", startDifuntos);
-            int startArray = jsonContent.indexOf("[", startPasos);
-            int endArray = jsonContent.indexOf("]", startArray);
-            
-            if (startArray > 0 && endArray > startArray) {
-                String pasosStr = jsonContent.substring(startArray + 1, endArray);
-                _numPasosDifuntos = 0;
-                
-                // Contar número de objetos {}
-                int count = 0;
-                for (int i = 0; i < pasosStr.length(); i++) {
-                    if (pasosStr[i] == '{') count++;
+        DBG_CAM_PRINTF("[CAMPANARIO] %d secuencias, %d instrucciones en %lu us\n",
+                       this->_nSecuencias, this->_nInstrucciones, micros() - tInicio);
+        for (int i = 0; i < this->_nSecuencias; ++i) {
+            DBG_CAM_PRINTF("[CAMPANARIO]   %s: %d pasos\n", this->_aSecuencias[i].nombre, this->_aSecuencias[i].numPasos);
+        }
+        if (!lOk) {
+            DBG_CAM("[CAMPANARIO] ERROR: Secuencias.json incompleto o mal formado");
+            return false;
+        }
+        DBG_CAM("[CAMPANARIO] Secuencias cargadas correctamente desde SPIFFS");
+        return true;
+    }
+
+    /**
+     * @brief Analiza Secuencias.json en una sola pasada y por bloques
+     * 
+     * @details Tokenizador JSON mínimo que lee el archivo en bloques de 64
+     *          bytes y mantiene solo una pila de niveles y la última clave.
+     *          Cualquier objeto que contenga un array "pasos" define una
+     *          secuencia cuyo nombre es su campo "id" o, si no lo tiene, la
+     *          clave bajo la que aparece.
+     *          
+     *          **FORMATOS ACEPTADOS:**
+     *          - `{"difuntos": {"pasos": [...]}, "misa": {...}}`
+     *          - `{"secuencias": {"angelus": {"pasos": [...]}}}`
+     *          - `{"secuencias": [{"id": "gloria", "pasos": [...]}]}`
+     *          
+     *          **CAMPOS DE CADA PASO:**
+     *          - Toque: "campana" o "campanas": [..], "repeticiones", "intervalo", "pulso"
+     *          - Salto: "salto" (paso destino) y "veces" (0 = indefinidamente)
+     * 
+     * @param file Archivo abierto en modo lectura
+     * @return true si el archivo se analizó completo y cupo en el pool
+     * 
+     * @note **STREAMING:** Ningún String temporal; los pasos van directos a _aInstrucciones
+     * @note **SALTOS:** Un destino fuera de la secuencia se convierte en paso vacío
+     * @note **RANGOS:** Igual con repeticiones o veces fuera de 0..65535, intervalo
+     *       fuera de 0..INTERVALO_MAX_MS o pulso fuera de 0..PULSO_MAX_MS
+     * 
+     * @since v1.5
+     * @author Julian Salas Bartolomé
+     */
+    bool CAMPANARIO::_ParseaSecuencias(File& file) {
+        constexpr int MAX_NIVELES = 8;
+        constexpr int LONG_NOMBRE = Config::Campanario::MAX_NOMBRE_SECUENCIA;
+        constexpr long MAX_NUMERO = 99999999L;                                  // Mayor que cualquier campo admitido
+        struct Nivel { bool esObjeto; char clave[LONG_NOMBRE]; };              // Clave con la que se abrió cada nivel
+        Nivel aNiveles[MAX_NIVELES];
+        int nNivel = -1;
+        char clave[LONG_NOMBRE] = "";                                           // Última clave del objeto actual
+        char texto[LONG_NOMBRE];                                                // Último string leído
+        char idSecuencia[LONG_NOMBRE] = "";                                     // Campo "id" del objeto candidato
+        bool lEsperaClave = false;
+        int nNivelPasos = -1;                                                   // Nivel del array "pasos" en curso
+        int nNivelCampanas = -1;                                                // Nivel del array "campanas" del paso
+        int nSecuencia = -1;                                                    // Secuencia en construcción (-1 = se descarta)
+        bool lError = false;
+        struct { uint8_t mascara; long repeticiones, intervalo, pulso, salto, veces; } paso = {};
+
+        uint8_t bloque[64];                                                     // Lectura por bloques
+        int nLen = 0, nPos = 0;
+        auto siguiente = [&]() -> int {
+            if (nPos >= nLen) {
+                nLen = file.read(bloque, sizeof(bloque));
+                nPos = 0;
+                if (nLen <= 0) return -1;
+            }
+            return bloque[nPos++];
+        };
+
+        int c = siguiente();
+        while (c >= 0 && !lError) {
+            if (c == '{' || c == '[') {
+                if (nNivel + 1 >= MAX_NIVELES) { lError = true; break; }
+                bool esObjeto = (c == '{');
+                bool padreObjeto = (nNivel >= 0 && aNiveles[nNivel].esObjeto);
+                nNivel++;
+                aNiveles[nNivel].esObjeto = esObjeto;
+                strlcpy(aNiveles[nNivel].clave, padreObjeto ? clave : "", LONG_NOMBRE);
+                if (!esObjeto && padreObjeto && nNivelPasos < 0 && strcmp(clave, "pasos") == 0) {
+                    const char* nombre = idSecuencia[0] ? idSecuencia : aNiveles[nNivel - 1].clave;  // Inicio de secuencia
+                    nNivelPasos = nNivel;
+                    nSecuencia = -1;
+                    if (nombre[0] == '\0' || this->_nSecuencias >= Config::Campanario::MAX_SECUENCIAS) {
+                        DBG_CAM("[CAMPANARIO] Secuencia sin nombre o sin hueco, descartada");
+                    } else {
+                        nSecuencia = this->_nSecuencias;
+                        SecuenciaRegistrada& sec = this->_aSecuencias[nSecuencia];
+                        strlcpy(sec.nombre, nombre, LONG_NOMBRE);
+                        sec.inicio = this->_nInstrucciones;
+                        sec.numPasos = 0;
+                    }
+                } else if (esObjeto && nNivelPasos >= 0 && nNivel == nNivelPasos + 1) {
+                    paso = { 0, 1, 0, 0, -1, 1 };                               // Nuevo paso con valores por defecto
+                } else if (!esObjeto && nNivelPasos >= 0 && nNivel == nNivelPasos + 2 && strcmp(clave, "campanas") == 0) {
+                    nNivelCampanas = nNivel;
+                } else if (esObjeto && nNivelPasos < 0) {
+                    idSecuencia[0] = '\0';                                      // Nuevo objeto candidato a secuencia
                 }
-                
-                _numPasosDifuntos = count;
-                _secuenciaDifuntos = new PasoSecuencia[_numPasosDifuntos];
-                
-                // Parsear cada paso
-                int currentPaso = 0;
-                int pos = 0;
-                while (currentPaso < _numPasosDifuntos && pos < pasosStr.length()) {
-                    int objStart = pasosStr.indexOf("{", pos);
-                    int objEnd = pasosStr.indexOf("}", objStart);
-                    
-                    if (objStart < 0 || objEnd < 0) break;
-                    
-                    String obj = pasosStr.substring(objStart, objEnd + 1);
-                    
-                    // Extraer campana
-                    int campanaIdx = obj.indexOf("\"campana\"");
-                    int campanaValStart = obj.indexOf(":", campanaIdx) + 1;
-                    int campanaValEnd = obj.indexOf(",", campanaValStart);
-                    if (campanaValEnd < 0) campanaValEnd = obj.indexOf("}", campanaValStart);
-                    String campanaStr = obj.substring(campanaValStart, campanaValEnd);
-                    campanaStr.trim();
-                    
-                    // Extraer repeticiones
-                    int repIdx = obj.indexOf("\"repeticiones\"");
-                    int repValStart = obj.indexOf(":", repIdx) + 1;
-                    int repValEnd = obj.indexOf(",", repValStart);
-                    if (repValEnd < 0) repValEnd = obj.indexOf("}", repValStart);
-                    String repStr = obj.substring(repValStart, repValEnd);
-                    repStr.trim();
-                    
-                    // Extraer intervalo
-                    int intIdx = obj.indexOf("\"intervalo\"");
-                    int intValStart = obj.indexOf(":", intIdx) + 1;
-                    int intValEnd = obj.indexOf(",", intValStart);
-                    if (intValEnd < 0) intValEnd = obj.indexOf("}", intValStart);
-                    String intStr = obj.substring(intValStart, intValEnd);
-                    intStr.trim();
-                    
-                    _secuenciaDifuntos[currentPaso].indiceCampana = campanaStr.toInt();
-                    _secuenciaDifuntos[currentPaso].repeticiones = repStr.toInt();
-                    _secuenciaDifuntos[currentPaso].intervaloMs = intStr.toInt();
-                    
-                    currentPaso++;
-                    pos = objEnd + 1;
+                lEsperaClave = esObjeto;
+                clave[0] = '\0';
+            } else if (c == '}' || c == ']') {
+                if (nNivel < 0) { lError = true; break; }
+                if (c == ']' && nNivel == nNivelCampanas) {
+                    nNivelCampanas = -1;
+                } else if (c == '}' && nNivelPasos >= 0 && nNivel == nNivelPasos + 1 && nSecuencia >= 0) {
+                    if (this->_nInstrucciones + 1 >= Config::Campanario::MAX_INSTRUCCIONES) {  // Reserva hueco para OP_FIN
+                        DBG_CAM("[CAMPANARIO] ERROR: Pool de instrucciones lleno");
+                        lError = true;
+                        break;
+                    }
+                    InstruccionToque& ins = this->_aInstrucciones[this->_nInstrucciones++];
+                    SecuenciaRegistrada& sec = this->_aSecuencias[nSecuencia];
+                    if (paso.repeticiones < 0 || paso.repeticiones > UINT16_MAX || paso.veces < 0 || paso.veces > UINT16_MAX ||
+                        paso.intervalo < 0 || paso.intervalo > (long)Config::Campanario::INTERVALO_MAX_MS ||
+                        paso.pulso < 0 || paso.pulso > Config::Campanario::PULSO_MAX_MS || paso.salto > UINT16_MAX) {
+                        DBG_CAM_PRINTF("[CAMPANARIO] Paso %d de %s fuera de rango, ignorado", sec.numPasos, sec.nombre);
+                        ins = { OP_TOQUE, 0, 0, 0, 0, 0 };                      // Paso vacío: los saltos siguen apuntando al mismo índice
+                    } else if (paso.salto >= 0) {
+                        ins = { OP_SALTO, 0, (uint16_t)paso.veces, 0, (uint16_t)paso.salto, 0 };
+                    } else {
+                        ins = { OP_TOQUE, paso.mascara, (uint16_t)paso.repeticiones, (uint16_t)paso.pulso, 0, (uint32_t)paso.intervalo };
+                    }
+                    sec.numPasos++;
+                } else if (c == ']' && nNivel == nNivelPasos) {
+                    if (nSecuencia >= 0) {                                      // Cierre de la secuencia
+                        SecuenciaRegistrada& sec = this->_aSecuencias[nSecuencia];
+                        for (int i = 0; i < sec.numPasos; ++i) {
+                            InstruccionToque& ins = this->_aInstrucciones[sec.inicio + i];
+                            if (ins.opcode == OP_SALTO && ins.destino >= sec.numPasos) {
+                                DBG_CAM_PRINTF("[CAMPANARIO] Salto a paso %d fuera de %s, ignorado", ins.destino, sec.nombre);
+                                ins = { OP_TOQUE, 0, 0, 0, 0, 0 };
+                            }
+                        }
+                        this->_aInstrucciones[this->_nInstrucciones++] = { OP_FIN, 0, 0, 0, 0, 0 };
+                        sec.id = IdSecuencia(sec.nombre);
+                        if (this->_RegistraSecuencia(nSecuencia)) {
+                            this->_nSecuencias++;
+                        } else {                                                // Nombre repetido: se libera su espacio del pool
+                            DBG_CAM_PRINTF("[CAMPANARIO] Secuencia %s duplicada, ignorada", sec.nombre);
+                            this->_nInstrucciones = sec.inicio;
+                        }
+                    }
+                    nNivelPasos = -1;
+                    nSecuencia = -1;
+                    idSecuencia[0] = '\0';
                 }
-                
-                DBG_CAM_PRINTF("[CAMPANARIO] Secuencia Difuntos cargada: %d pasos\n", _numPasosDifuntos);
-            }
-        }
-        
-        // Cargar secuencia de Misa (mismo proceso)
-        int startMisa = jsonContent.indexOf("\"misa\"");
-        if (startMisa > 0) {
-            int startPasos = jsonContent.indexOf("\"pasos\"", startMisa);
-            int startArray = jsonContent.indexOf("[", startPasos);
-            int endArray = jsonContent.indexOf("]", startArray);
-            
-            if (startArray > 0 && endArray > startArray) {
-                String pasosStr = jsonContent.substring(startArray + 1, endArray);
-                int count = 0;
-                for (int i = 0; i < pasosStr.length(); i++) {
-                    if (pasosStr[i] == '{') count++;
+                nNivel--;
+                lEsperaClave = false;
+            } else if (c == ':') {
+                lEsperaClave = false;
+            } else if (c == ',') {
+                lEsperaClave = (nNivel >= 0 && aNiveles[nNivel].esObjeto);
+            } else if (c == '"') {
+                int n = 0;
+                while ((c = siguiente()) >= 0 && c != '"') {
+                    if (c == '\\') c = siguiente();                             // Carácter escapado
+                    if (c >= 0 && n < LONG_NOMBRE - 1) texto[n++] = (char)c;
                 }
-                
-                _numPasosMisa = count;
-                _secuenciaMisa = new PasoSecuencia[_numPasosMisa];
-                
-                int currentPaso = 0;
-                int pos = 0;
-                while (currentPaso < _numPasosMisa && pos < pasosStr.length()) {
-                    int objStart = pasosStr.indexOf("{", pos);
-                    int objEnd = pasosStr.indexOf("}", objStart);
-                    if (objStart < 0 || objEnd < 0) break;
-                    
-                    String obj = pasosStr.substring(objStart, objEnd + 1);
-                    
-                    int campanaIdx = obj.indexOf("\"campana\"");
-                    int campanaValStart = obj.indexOf(":", campanaIdx) + 1;
-                    int campanaValEnd = obj.indexOf(",", campanaValStart);
-                    if (campanaValEnd < 0) campanaValEnd = obj.indexOf("}", campanaValStart);
-                    String campanaStr = obj.substring(campanaValStart, campanaValEnd);
-                    campanaStr.trim();
-                    
-                    int repIdx = obj.indexOf("\"repeticiones\"");
-                    int repValStart = obj.indexOf(":", repIdx) + 1;
-                    int repValEnd = obj.indexOf(",", repValStart);
-                    if (repValEnd < 0) repValEnd = obj.indexOf("}", repValStart);
-                    String repStr = obj.substring(repValStart, repValEnd);
-                    repStr.trim();
-                    
-                    int intIdx = obj.indexOf("\"intervalo\"");
-                    int intValStart = obj.indexOf(":", intIdx) + 1;
-                    int intValEnd = obj.indexOf(",", intValStart);
-                    if (intValEnd < 0) intValEnd = obj.indexOf("}", intValStart);
-                    String intStr = obj.substring(intValStart, intValEnd);
-                    intStr.trim();
-                    
-                    _secuenciaMisa[currentPaso].indiceCampana = campanaStr.toInt();
-                    _secuenciaMisa[currentPaso].repeticiones = repStr.toInt();
-                    _secuenciaMisa[currentPaso].intervaloMs = intStr.toInt();
-                    
-                    currentPaso++;
-                    pos = objEnd + 1;
+                texto[n] = '\0';
+                if (lEsperaClave) {
+                    strlcpy(clave, texto, LONG_NOMBRE);
+                } else if (nNivelPasos < 0 && strcmp(clave, "id") == 0) {
+                    strlcpy(idSecuencia, texto, LONG_NOMBRE);
                 }
-                
-                DBG_CAM_PRINTF("[CAMPANARIO] Secuencia Misa cargada: %d pasos\n", _numPasosMisa);
-            }
-        }
-        
-        // Cargar secuencia de Fiesta
-        int startFiesta = jsonContent.indexOf("\"fiesta\"");
-        if (startFiesta > 0) {
-            int startPasos = jsonContent.indexOf("\"pasos\"", startFiesta);
-            int startArray = jsonContent.indexOf("[", startPasos);
-            int endArray = jsonContent.indexOf("]", startArray);
-            
-            if (startArray > 0 && endArray > startArray) {
-                String pasosStr = jsonContent.substring(startArray + 1, endArray);
-                int count = 0;
-                for (int i = 0; i < pasosStr.length(); i++) {
-                    if (pasosStr[i] == '{') count++;
+            } else if (c == '-' || (c >= '0' && c <= '9')) {
+                bool lNegativo = (c == '-');
+                long nValor = lNegativo ? 0 : (c - '0');
+                while ((c = siguiente()) >= '0' && c <= '9') {
+                    if (nValor <= MAX_NUMERO) nValor = nValor * 10 + (c - '0');  // Más allá ya está fuera de rango; no desborda long
+                }
+                while (c == '.' || c == 'e' || c == 'E' || c == '+' || (c >= '0' && c <= '9')) {
+                    c = siguiente();                                            // Descarta decimales y exponente
                 }
-                
-                _numPasosFiesta = count;
-                _secuenciaFiesta = new PasoSecuencia[_numPasosFiesta];
-                
-                int currentPaso = 0;
-                int pos = 0;
-                while (currentPaso < _numPasosFiesta && pos < pasosStr.length()) {
-                    int objStart = pasosStr.indexOf("{", pos);
-                    int objEnd = pasosStr.indexOf("}", objStart);
-                    if (objStart < 0 || objEnd < 0) break;
-                    
-                    String obj = pasosStr.substring(objStart, objEnd + 1);
-                    
-                    int campanaIdx = obj.indexOf("\"campana\"");
-                    int campanaValStart = obj.indexOf(":", campanaIdx) + 1;
-                    int campanaValEnd = obj.indexOf(",", campanaValStart);
-                    if (campanaValEnd < 0) campanaValEnd = obj.indexOf("}", campanaValStart);
-                    String campanaStr = obj.substring(campanaValStart, campanaValEnd);
-                    campanaStr.trim();
-                    
-                    int repIdx = obj.indexOf("\"repeticiones\"");
-                    int repValStart = obj.indexOf(":", repIdx) + 1;
-                    int repValEnd = obj.indexOf(",", repValStart);
-                    if (repValEnd < 0) repValEnd = obj.indexOf("}", repValStart);
-                    String repStr = obj.substring(repValStart, repValEnd);
-                    repStr.trim();
-                    
-                    int intIdx = obj.indexOf("\"intervalo\"");
-                    int intValStart = obj.indexOf(":", intIdx) + 1;
-                    int intValEnd = obj.indexOf(",", intValStart);
-                    if (intValEnd < 0) intValEnd = obj.indexOf("}", intValStart);
-                    String intStr = obj.substring(intValStart, intValEnd);
-                    intStr.trim();
-                    
-                    _secuenciaFiesta[currentPaso].indiceCampana = campanaStr.toInt();
-                    _secuenciaFiesta[currentPaso].repeticiones = repStr.toInt();
-                    _secuenciaFiesta[currentPaso].intervaloMs = intStr.toInt();
-                    
-                    currentPaso++;
-                    pos = objEnd + 1;
+                if (lNegativo) nValor = -nValor;
+                if (nNivelCampanas >= 0) {
+                    if (nValor >= 0 && nValor < Config::Campanario::MAX_CAMPANAS) paso.mascara |= MascaraCampana(nValor);
+                } else if (nNivelPasos >= 0 && nNivel == nNivelPasos + 1) {
+                    if      (strcmp(clave, "campana") == 0)      { if (nValor >= 0 && nValor < Config::Campanario::MAX_CAMPANAS) paso.mascara |= MascaraCampana(nValor); }
+                    else if (strcmp(clave, "repeticiones") == 0) paso.repeticiones = nValor;
+                    else if (strcmp(clave, "intervalo") == 0)    paso.intervalo = nValor;
+                    else if (strcmp(clave, "pulso") == 0)        paso.pulso = nValor;
+                    else if (strcmp(clave, "salto") == 0)        paso.salto = nValor;
+                    else if (strcmp(clave, "veces") == 0)        paso.veces = nValor;
                 }
-                
-                DBG_CAM_PRINTF("[CAMPANARIO] Secuencia Fiesta cargada: %d pasos\n", _numPasosFiesta);
+                continue;                                                       // c ya contiene el siguiente carácter
             }
+            c = siguiente();
         }
-        
-        DBG_CAM("[CAMPANARIO] Secuencias cargadas correctamente desde SPIFFS");
+        return !lError && nNivel < 0 && nNivelPasos < 0;
+    }
+
+    /**
+     * @brief Calcula el ID de registro de una secuencia a partir de su nombre
+     * 
+     * @details Hash FNV-1a de 32 bits sobre el nombre en minúsculas, plegado
+     *          a 15 bits y marcado con ID_SECUENCIA_BASE. El ID cabe en el
+     *          parámetro uint16_t de las alarmas y nunca coincide con los
+     *          códigos de Config::States, por lo que WebSocket, I2C y
+     *          AlarmScheduler pueden usarlo directamente con EjecutaSecuencia().
+     * 
+     * @param nombre Nombre de la secuencia (no distingue mayúsculas)
+     * @return ID de la secuencia (siempre >= ID_SECUENCIA_BASE)
+     * 
+     * @note **ESTABLE:** El ID solo depende del nombre, se puede guardar en Alarmas.json
+     * 
+     * @since v1.6
+     * @author Julian Salas Bartolomé
+     */
+    uint16_t CAMPANARIO::IdSecuencia(const char* nombre) {
+        uint32_t h = 2166136261u;                                               // Base FNV-1a
+        for (const char* p = nombre; *p; ++p) {
+            h ^= (uint8_t)tolower((unsigned char)*p);
+            h *= 16777619u;                                                     // Primo FNV
+        }
+        return (uint16_t)(((h ^ (h >> 15)) & 0x7FFF) | Config::Campanario::ID_SECUENCIA_BASE);
+    }
+
+    /**
+     * @brief Inserta una secuencia recién cargada en la tabla hash
+     * 
+     * @details Direccionamiento abierto con sondeo lineal sobre
+     *          _aTablaSecuencias. Cada hueco guarda el índice de la
+     *          secuencia más uno (0 = hueco libre).
+     * 
+     * @param nIndice Índice de la secuencia en _aSecuencias (su id ya calculado)
+     * @return true si se insertó, false si el ID ya estaba registrado
+     * 
+     * @warning **DUPLICADOS:** Dos nombres con el mismo ID no pueden coexistir; se conserva el primero
+     * 
+     * @since v1.6
+     * @author Julian Salas Bartolomé
+     */
+    bool CAMPANARIO::_RegistraSecuencia(int nIndice) {
+        constexpr uint16_t MASCARA = Config::Campanario::TAM_TABLA_SECUENCIAS - 1;
+        uint16_t nId = this->_aSecuencias[nIndice].id;
+        for (uint16_t i = 0, h = nId & MASCARA; i < Config::Campanario::TAM_TABLA_SECUENCIAS; ++i, h = (h + 1) & MASCARA) {
+            uint8_t n = this->_aTablaSecuencias[h];
+            if (n == 0) {
+                this->_aTablaSecuencias[h] = (uint8_t)(nIndice + 1);
+                return true;
+            }
+            if (this->_aSecuencias[n - 1].id == nId) return false;
+        }
+        return false;
+    }
+
+    /**
+     * @brief Busca una secuencia cargada por su ID
+     * 
+     * @param nId ID calculado con IdSecuencia()
+     * @return Índice de la secuencia o -1 si no existe
+     * 
+     * @note **O(1):** Acceso directo a la tabla hash, sin comparar nombres
+     * 
+     * @since v1.6
+     * @author Julian Salas Bartolomé
+     */
+    int CAMPANARIO::BuscaSecuencia(uint16_t nId) {
+        constexpr uint16_t MASCARA = Config::Campanario::TAM_TABLA_SECUENCIAS - 1;
+        for (uint16_t i = 0, h = nId & MASCARA; i < Config::Campanario::TAM_TABLA_SECUENCIAS; ++i, h = (h + 1) & MASCARA) {
+            uint8_t n = this->_aTablaSecuencias[h];
+            if (n == 0) return -1;
+            if (this->_aSecuencias[n - 1].id == nId) return n - 1;
+        }
+        return -1;
+    }
+
+    /**
+     * @brief Inicia una secuencia cargada desde Secuencias.json por su ID
+     * 
+     * @details Selecciona el programa compilado de la secuencia y lo arranca.
+     *          Es el camino común de TocaDifuntos(), TocaMisa(), TocaFiesta()
+     *          y de cualquier secuencia adicional definida en el archivo,
+     *          ya llegue la orden por WebSocket, I2C o una alarma.
+     * 
+     * @param nId ID de la secuencia (ver IdSecuencia())
+     * @return true si la secuencia existe y se ha iniciado
+     * 
+     * @note **ESTADO:** Solo si se inicia, marca la secuencia activa como PERSONALIZADA; las secuencias clásicas la sobrescriben
+     * 
+     * @since v1.6
+     * @author Julian Salas Bartolomé
+     */
+    bool CAMPANARIO::TocaSecuencia(uint16_t nId) {
+        int idx = this->BuscaSecuencia(nId);
+        if (idx < 0) {
+            DBG_CAM_PRINTF("Secuencia 0x%04X no cargada", nId);
+            return false;
+        }
+        DBG_CAM_PRINTF("Tocando secuencia %s (%d pasos)", this->_aSecuencias[idx].nombre, this->_aSecuencias[idx].numPasos);
+        this->_CargaPrograma(&this->_aInstrucciones[this->_aSecuencias[idx].inicio]);
+        this->IniciarSecuenciaCampanadas();
+        if (!this->_tocandoSecuencia) return false;                         // Programa sin campanadas: el estado no cambia
+        this->secuenciaActiva = Config::Secuencia::PERSONALIZADA;
+        this->_nEstadoCampanario |= Config::States::BIT_SECUENCIA;
         return true;
     }
+
+    /**
+     * @brief Inicia una secuencia cargada desde Secuencias.json por su nombre
+     * 
+     * @param nombre Nombre de la secuencia (no distingue mayúsculas)
+     * @return true si la secuencia existe y se ha iniciado
+     * 
+     * @see TocaSecuencia(uint16_t) - Implementación por ID
+     * 
+     * @since v1.5
+     * @author Julian Salas Bartolomé
+     */
+    bool CAMPANARIO::TocaSecuencia(const char* nombre) {
+        return this->TocaSecuencia(IdSecuencia(nombre));
+    }
+
+    /**
+     * @brief Devuelve el número de secuencias cargadas
+     * 
+     * @since v1.5
+     * @author Julian Salas Bartolomé
+     */
+    int CAMPANARIO::GetNumSecuencias(void) {
+        return this->_nSecuencias;
+    }
+
+    /**
+     * @brief Devuelve el nombre de una secuencia cargada
+     * 
+     * @param nIndice Índice entre 0 y GetNumSecuencias() - 1
+     * @return Nombre de la secuencia o "" si el índice no es válido
+     * 
+     * @since v1.5
+     * @author Julian Salas Bartolomé
+     */
+    const char* CAMPANARIO::GetNombreSecuencia(int nIndice) {
+        if (nIndice < 0 || nIndice >= this->_nSecuencias) return "";
+        return this->_aSecuencias[nIndice].nombre;
+    }
+
+    /**
+     * @brief Devuelve el ID de una secuencia cargada
+     * 
+     * @param nIndice Índice entre 0 y GetNumSecuencias() - 1
+     * @return ID de la secuencia o 0 si el índice no es válido
+     * 
+     * @since v1.6
+     * @author Julian Salas Bartolomé
+     */
+    uint16_t CAMPANARIO::GetIdSecuencia(int nIndice) {
+        if (nIndice < 0 || nIndice >= this->_nSecuencias) return 0;
+        return this->_aSecuencias[nIndice].id;
+    }
+
+    /**
+     * @brief Devuelve la biblioteca de secuencias cargadas en formato JSON
+     * 
+     * @details Formato: `{"total":n,"secuencias":[{"id":32769,"nombre":"angelus","pasos":12}, ...]}`.
+     *          El id es el que aceptan SECUENCIA:, las alarmas y el comando
+     *          I2C SECUENCIA_REGISTRADA (este último por índice en la lista).
+     * 
+     * @return String JSON con las secuencias
+     * 
+     * @since v1.6
+     * @author Julian Salas Bartolomé
+     */
+    String CAMPANARIO::GetSecuenciasJSON(void) {
+        JsonDocument doc;
+        doc["total"] = this->_nSecuencias;
+        JsonArray lista = doc.createNestedArray("secuencias");
+        for (int i = 0; i < this->_nSecuencias; ++i) {
+            JsonObject sec = lista.createNestedObject();
+            sec["id"] = this->_aSecuencias[i].id;
+            sec["nombre"] = this->_aSecuencias[i].nombre;
+            sec["pasos"] = this->_aSecuencias[i].numPasos;
+        }
+        String json;
+        serializeJson(doc, json);
+        return json;
+    }
     
     /**
      * @brief Añade una campana al sistema de campanario
@@ -370,6 +547,8 @@
      */
     void CAMPANARIO::AddCampana(CAMPANA* pCampana) {
         if (this->_nNumCampanas < Config::Campanario::MAX_CAMPANAS) {           // Verifica que no se exceda el número máximo de campanas
+            if (pCampana->GetRoles() & Config::Campanario::ROL_HORAS)   this->_nMascaraHoras |= MascaraCampana(this->_nNumCampanas);
+            if (pCampana->GetRoles() & Config::Campanario::ROL_CUARTOS) this->_nMascaraCuartos |= MascaraCampana(this->_nNumCampanas);
             this->_pCampanas[_nNumCampanas++] = pCampana;                       // Añade la campana al array y aumenta el contador
             DBG_CAM_PRINTF("Campana añadida. Total campanas: %d", this->_nNumCampanas);
         }else {
@@ -382,12 +561,12 @@
      * @brief Inicia la secuencia tradicional de campanadas para difuntos
      * 
      * @details Activa la secuencia de campanadas específica para ceremonias
-     *          de difuntos. Utiliza la secuencia predefinida almacenada en
-     *          PROGMEM y genera las campanadas planas para ejecución.
+     *          de difuntos. Utiliza el programa compilado desde Secuencias.json,
+     *          que el motor recorre en su sitio sin expandirlo.
      *          
      *          **PROCESO DE INICIO:**
      *          1. Verifica que no hay otra secuencia activa
-     *          2. Genera campanadas planas desde secuenciaDifuntos
+     *          2. Selecciona el programa compilado de difuntos
      *          3. Establece flag BitDifuntos en el estado
      *          4. Inicia la ejecución de secuencia
      * 
@@ -406,12 +585,9 @@
      */
     void CAMPANARIO::TocaDifuntos(void) {
         DBG_CAM("Tocando campanas para difuntos...");
-        DBG_CAM_PRINT ("numPasosDifuntos: ");
-        DBG_CAM(_numPasosDifuntos);
-        this->secuenciaActiva = Config::Secuencia::DIFUNTOS;                        // Indica que la secuencia activa es Difuntos
-        this->_GeneraraCampanadas(_secuenciaDifuntos, _numPasosDifuntos);           // Genera la secuencia plana de campanadas para difuntos
-        this->IniciarSecuenciaCampanadas();                                         // Inicia la secuencia de toque de campanadas
-        this->_nEstadoCampanario |= Config::States::BIT_SECUENCIA;                  // Marca el estado del campanario como tocando difuntos
+        if (this->TocaSecuencia("difuntos")) {                                       // Programa compilado desde Secuencias.json
+            this->secuenciaActiva = Config::Secuencia::DIFUNTOS;                     // Solo si ha arrancado: si no, se conserva la anterior
+        }
     }
 
     /**
@@ -443,12 +619,9 @@
     void CAMPANARIO::TocaMisa(void) {
 
         DBG_CAM ("Tocando campanas para misa...");
-        DBG_CAM_PRINT ("numPasosMisa: ");
-        DBG_CAM(_numPasosMisa);
-        this->secuenciaActiva = Config::Secuencia::MISA;                            // Indica que la secuencia activa es Misa
-        this->_GeneraraCampanadas(_secuenciaMisa, _numPasosMisa);
-        this->IniciarSecuenciaCampanadas(); // Inicia la secuencia de campanadas
-        this->_nEstadoCampanario |= Config::States::BIT_SECUENCIA;
+        if (this->TocaSecuencia("misa")) {                                           // Programa compilado desde Secuencias.json
+            this->secuenciaActiva = Config::Secuencia::MISA;                         // Solo si ha arrancado: si no, se conserva la anterior
+        }
     }
     /**
      * @brief Inicia la secuencia festiva de campanadas para celebraciones
@@ -490,108 +663,129 @@
     void CAMPANARIO::TocaFiesta(void) {
 
         DBG_CAM ("Tocando campanas para fiesta...");
-        DBG_CAM_PRINT ("numPasosFiesta: ");
-        DBG_CAM(_numPasosFiesta);
-        this->secuenciaActiva = Config::Secuencia::FIESTA;                          // Indica que la secuencia activa es Fiesta
-        this->_GeneraraCampanadas(_secuenciaFiesta, _numPasosFiesta);
-        this->IniciarSecuenciaCampanadas(); // Inicia la secuencia de campanadas
-        this->_nEstadoCampanario |= Config::States::BIT_SECUENCIA;
+        if (this->TocaSecuencia("fiesta")) {                                         // Programa compilado desde Secuencias.json
+            this->secuenciaActiva = Config::Secuencia::FIESTA;                       // Solo si ha arrancado: si no, se conserva la anterior
+        }
     }
     /**
-     * @brief Genera secuencia de campanadas planas desde pasos definidos
+     * @brief Selecciona el programa de toques a ejecutar
      * 
-     * @details Convierte una secuencia de pasos (que incluyen repeticiones e
-     *          intervalos) en un array plano de campanadas individuales para
-     *          optimizar la ejecución posterior.
-     *          
-     *          **PROCESO DE GENERACIÓN:**
-     *          1. Lee cada paso de la secuencia desde PROGMEM
-     *          2. Expande las repeticiones en campanadas individuales
-     *          3. Aplica intervalos específicos a cada campanada
-     *          4. Almacena en array plano para ejecución secuencial
-     * 
-     * @param secuencia Puntero a array de PasoSecuencia en PROGMEM
-     * @param numPasos Número de pasos en la secuencia
+     * @details Apunta el motor al programa compilado indicado y reinicia el
+     *          contador de programa, las repeticiones pendientes y la pila de
+     *          saltos. El programa no se copia ni se expande: el motor lo
+     *          recorre en su sitio, por lo que el coste es O(1) con
+     *          independencia del número de toques.
      * 
-     * @note **PROGMEM:** Lee secuencias desde memoria de programa para optimización
-     * @note **EXPANSIÓN:** Convierte pasos con repeticiones en campanadas individuales
-     * @note **LÍMITE:** Máximo MAX_CAMPANADAS_SECUENCIA campanadas en array plano
+     * @param pPrograma Programa terminado en OP_FIN, o nullptr para descartar el actual
      * 
-     * @warning **MEMORIA:** Puede consumir hasta 1.6KB de RAM para secuencias grandes
-     * @warning **OVERFLOW:** Verifica que no se exceda el límite de campanadas
+     * @note **SIN COPIA:** El programa debe seguir vivo mientras se ejecuta
+     * @note **RÁPIDO:** Sustituye a la expansión y limpieza del antiguo array plano de 200 toques
      * 
-     * @see ToquePlano - Estructura utilizada para campanadas individuales
-     * @see PasoSecuencia - Estructura de entrada leída desde PROGMEM
+     * @see InstruccionToque - Formato de cada instrucción
+     * @see IniciarSecuenciaCampanadas() - Arranca el programa seleccionado
      * 
-     * @since v1.0
+     * @since v1.4
      * @author Julian Salas Bartolomé
      */
-    void CAMPANARIO::_GeneraraCampanadas(const PasoSecuencia* secuencia, int numPasos) {
-        int idx = 0;
-        this->_LimpiaraCampanadas(); // Limpia las campanadas antes de generar nuevas
-        for (int i = 0; i < numPasos; ++i) {
-            for (int r = 0; r < secuencia[i].repeticiones; ++r) {
-                this->_aCampanadas[idx].indiceCampana = secuencia[i].indiceCampana;
-                this->_aCampanadas[idx].intervaloMs = secuencia[i].intervaloMs;
-                idx++;
-            }
-        }
-        this->_nCampanadas = idx;
-        
-        DBG_CAM("Campanadas generadas:");
-        DBG_CAM_PRINT ("Numero de campanadas: ");
-        DBG_CAM(this->_nCampanadas);
-        
-
+    void CAMPANARIO::_CargaPrograma(const InstruccionToque* pPrograma) {
+        this->_pPrograma = pPrograma;
+        this->_nPC = 0;
+        this->_nRepeticionesRestantes = 0;
+        this->_nBucles = 0;
     }
 
     /**
-     * @brief Limpia el array de campanadas y reinicia contadores
+     * @brief Avanza el contador de programa hasta el siguiente toque
      * 
-     * @details Resetea el array de campanadas planas y el contador para
-     *          preparar el sistema para una nueva secuencia.
+     * @details Ejecuta las instrucciones que no producen toques a partir de
+     *          _nPC hasta encontrar un OP_TOQUE con repeticiones o el final.
+     *          
+     *          **INSTRUCCIONES:**
+     *          - OP_TOQUE con repeticiones: se detiene y carga el contador de repeticiones
+     *          - OP_TOQUE sin repeticiones: se salta
+     *          - OP_SALTO: vuelve a destino tantas veces como indique repeticiones
+     *            (0 = indefinidamente, hasta ParaSecuencia())
+     *          - OP_FIN: termina el programa
      * 
-     * @note **LIMPIEZA:** Solo resetea contador, no borra memoria por eficiencia
-     * @note **RÁPIDO:** Operación O(1) para máximo rendimiento
+     * @return true si _nPC queda en un toque, false si el programa ha terminado
      * 
-     * @since v1.0
+     * @note **ANIDAMIENTO:** Hasta MAX_BUCLES_ANIDADOS saltos con repetición simultáneos
+     * @warning **PROTECCIÓN:** Un bucle sin toques se corta tras 256 instrucciones
+     * 
+     * @since v1.4
      * @author Julian Salas Bartolomé
      */
-    void CAMPANARIO::_LimpiaraCampanadas(void) {
-       this->_nCampanadas = 0; // Resetea el contador de campanadas
-        for (int i = 0; i < 200; ++i) {
-            this->_aCampanadas[i].indiceCampana = -1; // Resetea el índice de la campana
-            this->_aCampanadas[i].intervaloMs = 0; // Resetea el intervalo en milisegundos
+    bool CAMPANARIO::_BuscaToque(void) {
+        if (this->_pPrograma == nullptr) return false;
+        for (int nInstrucciones = 0; nInstrucciones < 256; ++nInstrucciones) {         // Protección frente a bucles sin toques
+            const InstruccionToque& ins = this->_pPrograma[this->_nPC];
+            switch (ins.opcode) {
+                case OP_TOQUE:
+                    if (ins.repeticiones > 0) {
+                        this->_nRepeticionesRestantes = ins.repeticiones;
+                        return true;
+                    }
+                    this->_nPC++;
+                    break;
+                case OP_SALTO:
+                    if (ins.repeticiones == 0) {                                        // Salto indefinido
+                        this->_nPC = ins.destino;
+                    } else if (this->_nBucles > 0 && this->_aBucles[this->_nBucles - 1].pc == this->_nPC) {
+                        MarcoBucle& marco = this->_aBucles[this->_nBucles - 1];         // Bucle ya en curso
+                        if (--marco.restantes > 0) {
+                            this->_nPC = ins.destino;
+                        } else {
+                            this->_nBucles--;
+                            this->_nPC++;
+                        }
+                    } else if (this->_nBucles < Config::Campanario::MAX_BUCLES_ANIDADOS) {
+                        this->_aBucles[this->_nBucles++] = { this->_nPC, ins.repeticiones };  // Primer paso por el salto
+                        this->_nPC = ins.destino;
+                    } else {
+                        DBG_CAM("Demasiados bucles anidados, salto ignorado");
+                        this->_nPC++;
+                    }
+                    break;
+                default:                                                                // OP_FIN
+                    return false;
+            }
         }
-        DBG_CAM("Campanadas limpiadas.");
+        DBG_CAM("Programa de toques sin campanadas en el bucle, detenido");
+        return false;
     }
 
     /**
      * @brief Inicia la ejecución de la secuencia de campanadas generada
      * 
      * @details Inicializa las variables de control para comenzar la ejecución
-     *          de una secuencia de campanadas previamente generada. Resetea
-     *          contadores y establece el estado de ejecución activa.
+     *          del programa de toques previamente seleccionado. Sitúa el
+     *          contador de programa en el primer OP_TOQUE y establece el
+     *          estado de ejecución activa.
      * 
-     * @note **PRERREQUISITO:** Debe llamarse después de generar campanadas con _GeneraraCampanadas()
-     * @note **CONTROL:** Resetea índice actual y timestamp para nueva secuencia
+     * @note **PRERREQUISITO:** Debe llamarse después de seleccionar el programa con _CargaPrograma()
+     * @note **CONTROL:** Resetea índice actual y fija el origen absoluto de la línea temporal
+     * @note **SIN DERIVA:** Cada toque se programa como origen + suma de intervalos, no desde el toque anterior real
      * @note **ESTADO:** Establece _tocandoSecuencia = true
      * 
-     * @see _GeneraraCampanadas() - Debe llamarse antes de esta función
+     * @see _CargaPrograma() - Debe llamarse antes de esta función
      * @see ActualizarSecuenciaCampanadas() - Debe llamarse periódicamente después
      * 
      * @since v1.0
      * @author Julian Salas Bartolomé
      */
     void CAMPANARIO::IniciarSecuenciaCampanadas(void) {
-        if (this->_nCampanadas == 0) {
-            DBG_CAM("Error: No hay campanadas generadas");
+        this->_nPC = 0;                                                  // Programa desde el principio
+        this->_nBucles = 0;
+        if (!this->_BuscaToque()) {                                      // Sitúa el contador en el primer toque
+            this->_tocandoSecuencia = false;
+            DBG_CAM("Error: El programa no contiene campanadas");
             return;
         }
-         
-        this->_indiceCampanadaActual = 0;
-        this->_ultimoToqueMs = 0;
-        this->_tocandoSecuencia = (this->_nCampanadas > 0);
+        this->_tInicioSecuenciaUs = esp_timer_get_time();                // Origen absoluto de la línea temporal
+        this->_nOffsetSiguienteMs = 0;                                   // El primer toque suena inmediatamente
+        this->_nIndiceToque = 0;
+        this->_lFinPrograma = false;
+        this->_tocandoSecuencia = true;
         DBG_CAM("Secuencia de campanadas iniciada");
     }
 
@@ -604,15 +798,21 @@
      *          
      *          **ALGORITMO DE EJECUCIÓN:**
      *          1. Verifica si hay secuencia activa
-     *          2. Comprueba si ha transcurrido el intervalo necesario
-     *          3. Toca la campana correspondiente al paso actual
-     *          4. Avanza al siguiente paso de la secuencia
-     *          5. Si termina la secuencia: limpia estado y flags
+     *          2. Comprueba si se ha alcanzado el instante absoluto del toque
+     *          3. Dispara a la vez todas las campanas de la máscara del paso actual
+     *          4. Registra el retraso real en el histograma de jitter
+     *          5. Avanza al siguiente paso sumando su intervalo al instante programado
+     *          6. Si termina la secuencia: guarda la deriva final y limpia estado
+     *          
+     *          **LÍNEA TEMPORAL ABSOLUTA:**
+     *          El instante de cada toque es origen + suma de intervalos previos,
+     *          de modo que el retraso de un toque (loop() ocupado, WiFi, etc.)
+     *          no se acumula sobre los siguientes.
      * 
      * @return 1 si la secuencia continúa activa, 0 si ha terminado o no hay secuencia
      * 
      * @note **LLAMADA PERIÓDICA:** Debe llamarse cada pocos milisegundos desde loop()
-     * @note **NO BLOQUEANTE:** Utiliza millis() para control temporal no-bloqueante
+     * @note **NO BLOQUEANTE:** Utiliza esp_timer_get_time() para control temporal no-bloqueante
      * @note **AUTO-LIMPIEZA:** Se limpia automáticamente al terminar la secuencia
      * 
      * @warning **FRECUENCIA:** Llamar con suficiente frecuencia para precisión temporal
@@ -636,26 +836,48 @@
      * @author Julian Salas Bartolomé
      */
     int CAMPANARIO::ActualizarSecuenciaCampanadas(void) {
-        if (!this->_tocandoSecuencia || this->_indiceCampanadaActual >= this->_nCampanadas)                                                 // Si no se está tocando una secuencia o no hay campanadas, retorna 0   
+        int64_t ahora = esp_timer_get_time();                                                                                               // Obtiene el tiempo actual en microsegundos
+        uint8_t nDiferidas = this->_AtiendeDiferidos(ahora);                                                                                // Toques que esperaban al reposo de su campana
+        if (!this->_tocandoSecuencia || this->_pPrograma == nullptr)                                                                        // Si no se está tocando una secuencia o no hay programa, retorna 0   
         {
             return 0;   
         }    
-        unsigned long ahora = millis();                                                                                                     // Obtiene el tiempo actual en milisegundos
-        if (this->_ultimoToqueMs == 0 || (ahora - this->_ultimoToqueMs) >= this->_aCampanadas[this->_indiceCampanadaActual].intervaloMs) {  // Si es el primer toque o ha pasado el intervalo definido
-            int idxCampana = this->_aCampanadas[this->_indiceCampanadaActual].indiceCampana;                                                // Obtiene el índice de la campana a tocar
-            if (idxCampana >= 0 && idxCampana < this->_nNumCampanas) {                                                                      // Verifica que el índice de campana esté dentro del rango válido   
-                this->_pCampanas[idxCampana]->Toca();                                                                                       // Llama al método Toca de la campana correspondiente para hacerla sonar
-                this->_nCampanaTocada = 1 + idxCampana;                                                                                     // Actualiza el número de campanada tocada ( el 1 es poruq e la campana 1 esta en un indice 0)
-                    DBG_CAM_PRINT("Tocando campana: ");
-                    DBG_CAM(this->_nCampanaTocada);
+        if (nDiferidas != 0) {
+            this->_nMascaraTocada |= nDiferidas;
+            this->_nCampanaTocada = 1 + __builtin_ctz(this->_nMascaraTocada);
+        }
+        if (this->_lFinPrograma) {                                                                                                          // Programa terminado: solo faltan toques diferidos
+            if (this->_nMascaraDiferida == 0) {
+                this->_tocandoSecuencia = false;
+                DBG_CAM("Secuencia de campanadas finalizada tras los toques diferidos.");
+            }
+            return this->_nCampanaTocada;
+        }
+        int64_t tObjetivo = this->_tInicioSecuenciaUs + (int64_t)this->_nOffsetSiguienteMs * 1000;                                          // Instante absoluto programado para este toque
+        if (ahora >= tObjetivo) {                                                                                                           // Si ha llegado el instante programado
+            const InstruccionToque& ins = this->_pPrograma[this->_nPC];                                                                     // Instrucción OP_TOQUE en curso
+            uint8_t nTocadas = this->_DisparaMascara(ins.mascaraCampanas, ins.pulsoMs);                                                     // Dispara todas a la vez
+            this->_RegistraRetraso(ahora - tObjetivo);                                                                                      // Mide el retraso respecto al instante absoluto
+            if (nTocadas != 0) {
+                this->_nMascaraTocada = nTocadas;                                                                                           // Guarda la máscara para notificar a los clientes
+                this->_nCampanaTocada = 1 + __builtin_ctz(nTocadas);                                                                        // Primera campana tocada ( el 1 es porque la campana 1 esta en un indice 0)
+                this->_nIndiceToque++;                                                                                                      // Tiempos tocados, para la trama binaria del WebSocket
+                    DBG_CAM_PRINTF("Tocando campanas máscara 0x%02X", nTocadas);
             } else {
                     DBG_CAM("Índice de campana fuera de rango.");
             }
-            this->_ultimoToqueMs = ahora;                                                                                                   // Actualiza la marca de tiempo del último toque
-            this->_indiceCampanadaActual++;                                                                                                 // Incrementa el índice de la campanada actual    
-            if (this->_indiceCampanadaActual >= this->_nCampanadas) {                                                                       // Si se han tocado todas las campanadas de la secuencia plana
-                this->_tocandoSecuencia = false;                                                                                            // Marca la secuencia como no activa    
+            bool lHayMas = true;
+            if (--this->_nRepeticionesRestantes == 0) {                                                                                     // Instrucción agotada
+                this->_nPC++;                                                                                                               // Pasa a la siguiente instrucción
+                lHayMas = this->_BuscaToque();                                                                                              // Ejecuta saltos hasta el siguiente toque
+            }
+            if (!lHayMas) {                                                                                                                 // Si el programa ha llegado a OP_FIN
+                this->_lFinPrograma = true;
+                this->_tocandoSecuencia = (this->_nMascaraDiferida != 0);                                                                   // Sigue activa mientras queden toques diferidos
+                this->_nDerivaFinalUs = (uint32_t)(ahora - tObjetivo);                                                                      // Deriva acumulada al final de la secuencia
                 DBG_CAM("Secuencia de campanadas finalizada.");
+            } else {
+                this->_nOffsetSiguienteMs += this->_pPrograma[this->_nPC].intervaloMs;                                                      // El siguiente instante se cuenta desde el programado, no desde el real
             }
         }
         return this->_nCampanaTocada;                                                                                                       // Retorna el número de campana tocada en la última secuencia
@@ -675,9 +897,274 @@
      */
     void CAMPANARIO::ResetCampanaTocada(void) {
         this->_nCampanaTocada = 0; // Resetea el número de campana tocada
+        this->_nMascaraTocada = 0; // Resetea la máscara de campanas tocadas
         DBG_CAM("Número de campana tocada reseteado.");
     }
 
+    /**
+     * @brief Devuelve la máscara de campanas tocadas en el último tiempo
+     * 
+     * @details Complementa a ActualizarSecuenciaCampanadas(), que solo devuelve
+     *          la primera campana tocada, cuando un paso hace sonar varias
+     *          campanas simultáneamente.
+     * 
+     * @return Máscara de bits (bit 0 = campana 1) o 0 si no se ha tocado ninguna
+     * 
+     * @see ResetCampanaTocada() - Limpia también esta máscara
+     * 
+     * @since v1.2
+     * @author Julian Salas Bartolomé
+     */
+    uint8_t CAMPANARIO::GetMascaraTocada(void) {
+        return this->_nMascaraTocada;
+    }
+
+    /**
+     * @brief Devuelve los tiempos tocados desde el inicio de la secuencia
+     * 
+     * @details Cuenta los pasos que han hecho sonar alguna campana (un paso
+     *          polifónico cuenta una vez). Se reinicia en IniciarSecuenciaCampanadas().
+     * 
+     * @return Número de tiempos tocados; el último toque notificado es el índice - 1
+     * 
+     * @since v2.2
+     * @author Julian Salas Bartolomé
+     */
+    uint16_t CAMPANARIO::GetIndiceToque(void) {
+        return this->_nIndiceToque;
+    }
+
+    /**
+     * @brief Máscara de las campanas que tocan las horas
+     * 
+     * @details Campanas del banco con ROL_HORAS. Si ninguna lo tiene se usa
+     *          la primera campana, como en el campanario de dos campanas.
+     * 
+     * @return Máscara de campanas de horas
+     * 
+     * @see Config::Campanario::BANCO_CAMPANAS - Roles de cada campana
+     * 
+     * @since v1.3
+     * @author Julian Salas Bartolomé
+     */
+    uint8_t CAMPANARIO::_MascaraHoras(void) {
+        return this->_nMascaraHoras ? this->_nMascaraHoras : MascaraCampana(0);
+    }
+
+    /**
+     * @brief Máscara de las campanas que tocan cuartos y medias
+     * 
+     * @details Campanas del banco con ROL_CUARTOS. Si ninguna lo tiene se usa
+     *          la segunda campana o, si solo hay una, la primera.
+     * 
+     * @return Máscara de campanas de cuartos
+     * 
+     * @since v1.3
+     * @author Julian Salas Bartolomé
+     */
+    uint8_t CAMPANARIO::_MascaraCuartos(void) {
+        if (this->_nMascaraCuartos) return this->_nMascaraCuartos;
+        return (this->_nNumCampanas > 1) ? MascaraCampana(1) : MascaraCampana(0);
+    }
+
+    /**
+     * @brief Dispara simultáneamente todas las campanas de una máscara
+     * 
+     * @details Reserva el toque en cada campana de la máscara y acumula su
+     *          salida en una transacción de la capa de salida agrupada, de
+     *          modo que todos los pines GPIO pasan a HIGH con una única
+     *          escritura por banco y cada expansor I2C recibe un único byte.
+     *          Después cada campana arma su propio temporizador, por lo que
+     *          cada una se libera con su pulso.
+     *          
+     *          **PROCESO:**
+     *          1. Marca temporal común para todas las campanas del tiempo
+     *          2. Las campanas en reposo se difieren con _DifiereToque()
+     *          3. PreparaToque() en cada campana válida y libre
+     *          4. Salidas.Prepara() por campana y un único Salidas.Aplica()
+     *          5. ArmaLiberacion() en cada campana disparada
+     * 
+     * @param nMascara Máscara de campanas a tocar (bit 0 = campana 1)
+     * @param nPulsoMs Pulso del paso (0 = pulso propio de cada campana)
+     * @return Máscara de campanas realmente disparadas (sin las diferidas)
+     * 
+     * @note **REPOSO:** Ningún toque se descarta por llegar antes del reposo mínimo de su campana
+     * @note **SIMULTANEIDAD:** Todas las salidas de un tiempo se escriben en la misma transacción
+     * @note **SIN TEMPORIZADOR:** Las campanas sin esp_timer usan Toca() tras el disparo agrupado
+     * 
+     * @see CAMPANA::PreparaToque() - Reserva del toque
+     * @see CAMPANA::ArmaLiberacion() - Liberación individual del badajo
+     * @see SALIDASCAMPANAS::Aplica() - Escritura agrupada
+     * 
+     * @since v1.2
+     * @author Julian Salas Bartolomé
+     */
+    uint8_t CAMPANARIO::_DisparaMascara(uint8_t nMascara, uint16_t nPulsoMs) {
+        uint8_t nPreparadas = 0;
+        uint8_t nSinTimer = 0;
+        int64_t ahora = esp_timer_get_time();                                   // Marca común a todo el tiempo
+        for (int i = 0; i < this->_nNumCampanas; ++i) {
+            if (!(nMascara & MascaraCampana(i)) || this->_pCampanas[i] == nullptr) continue;
+            if (this->_pCampanas[i]->EnReposo(ahora)) {
+                this->_DifiereToque(i, nPulsoMs);                               // Demasiado pronto: se encola, no se pierde
+                continue;
+            }
+            if (this->_pCampanas[i]->PreparaToque(ahora)) {
+                Salidas.Prepara(this->_pCampanas[i]->GetSalida(), true);        // Se acumula en la transacción del tiempo
+                nPreparadas |= MascaraCampana(i);
+            } else {
+                nSinTimer |= MascaraCampana(i);                                 // Sin temporizador: toque clásico
+            }
+        }
+        if (nPreparadas) Salidas.Aplica();                                      // Una sola escritura por banco GPIO y por expansor
+        for (int i = 0; i < this->_nNumCampanas; ++i) {
+            if (nPreparadas & MascaraCampana(i)) this->_pCampanas[i]->ArmaLiberacion(nPulsoMs);
+        }
+        for (int i = 0; i < this->_nNumCampanas; ++i) {
+            if (nSinTimer & MascaraCampana(i)) this->_pCampanas[i]->Toca();
+        }
+        return nPreparadas | nSinTimer;
+    }
+
+    /**
+     * @brief Encola un toque que ha llegado antes del reposo de su campana
+     * 
+     * @details Cada campana tiene hasta MAX_TOQUES_DIFERIDOS toques en espera,
+     *          que _AtiendeDiferidos() dispara en cuanto termina su reposo. El
+     *          pulso del paso original se conserva.
+     * 
+     * @param nIndice Índice de la campana
+     * @param nPulsoMs Pulso del paso (0 = pulso propio de la campana)
+     * 
+     * @warning **SATURACIÓN:** Si la cola de la campana está llena el toque se registra como perdido
+     * 
+     * @since v1.4
+     * @author Julian Salas Bartolomé
+     */
+    void CAMPANARIO::_DifiereToque(int nIndice, uint16_t nPulsoMs) {
+        if (this->_aToquesDiferidos[nIndice] >= Config::Campanario::MAX_TOQUES_DIFERIDOS) {
+            this->_nToquesPerdidos++;
+            DBG_CAM_PRINTF("Cola de la campana %d llena, toque perdido", nIndice + 1);
+            return;
+        }
+        this->_aToquesDiferidos[nIndice]++;
+        this->_aPulsoDiferido[nIndice] = nPulsoMs;
+        this->_nMascaraDiferida |= MascaraCampana(nIndice);
+        DBG_CAM_PRINTF("Campana %d en reposo, toque diferido (%d en cola)", nIndice + 1, this->_aToquesDiferidos[nIndice]);
+    }
+
+    /**
+     * @brief Dispara los toques diferidos cuyas campanas ya han descansado
+     * 
+     * @details Recorre las campanas con toques en cola y dispara a la vez, en
+     *          una sola transacción de salida, las que ya no están en reposo.
+     *          Se llama en cada ActualizarSecuenciaCampanadas(), haya o no
+     *          secuencia, para que también se atiendan los toques de prueba.
+     * 
+     * @param tAhoraUs Marca esp_timer_get_time() actual
+     * @return Máscara de campanas disparadas
+     * 
+     * @since v1.4
+     * @author Julian Salas Bartolomé
+     */
+    uint8_t CAMPANARIO::_AtiendeDiferidos(int64_t tAhoraUs) {
+        if (this->_nMascaraDiferida == 0) return 0;
+        uint8_t nDisparadas = 0;
+        for (int i = 0; i < this->_nNumCampanas; ++i) {
+            if (!(this->_nMascaraDiferida & MascaraCampana(i))) continue;
+            if (this->_pCampanas[i]->PreparaToque(tAhoraUs)) {
+                Salidas.Prepara(this->_pCampanas[i]->GetSalida(), true);
+                nDisparadas |= MascaraCampana(i);
+            }
+        }
+        if (nDisparadas == 0) return 0;
+        Salidas.Aplica();
+        for (int i = 0; i < this->_nNumCampanas; ++i) {
+            if (!(nDisparadas & MascaraCampana(i))) continue;
+            this->_pCampanas[i]->ArmaLiberacion(this->_aPulsoDiferido[i]);
+            if (--this->_aToquesDiferidos[i] == 0) this->_nMascaraDiferida &= ~MascaraCampana(i);
+        }
+        return nDisparadas;
+    }
+
+    /**
+     * @brief Vacía todas las colas de toques diferidos
+     * 
+     * @since v1.4
+     * @author Julian Salas Bartolomé
+     */
+    void CAMPANARIO::_DescartaDiferidos(void) {
+        for (int i = 0; i < Config::Campanario::MAX_CAMPANAS; ++i) {
+            this->_aToquesDiferidos[i] = 0;
+        }
+        this->_nMascaraDiferida = 0;
+    }
+
+    /**
+     * @brief Ajusta en caliente el pulso de una campana
+     * 
+     * @param nCampana Número de campana (1 = primera)
+     * @param nPulsoMs Nuevo pulso en milisegundos
+     * @return Pulso aplicado o 0 si la campana no existe
+     * 
+     * @see CAMPANA::SetPulsoMs() - Límites del ajuste
+     * 
+     * @since v1.4
+     * @author Julian Salas Bartolomé
+     */
+    uint16_t CAMPANARIO::SetPulsoCampana(int nCampana, uint16_t nPulsoMs) {
+        if (nCampana < 1 || nCampana > this->_nNumCampanas) return 0;
+        return this->_pCampanas[nCampana - 1]->SetPulsoMs(nPulsoMs);
+    }
+
+    /**
+     * @brief Toque de prueba de una campana con su pulso actual
+     * 
+     * @details Pasa por el mismo camino que los toques de secuencia, por lo
+     *          que respeta el reposo mínimo: si llega demasiado pronto queda
+     *          diferido. Pensado para calibrar el pulso desde la web.
+     * 
+     * @param nCampana Número de campana (1 = primera)
+     * @return true si la campana existe
+     * 
+     * @warning **PROTECCIÓN:** No se permite mientras suena una secuencia
+     * 
+     * @since v1.4
+     * @author Julian Salas Bartolomé
+     */
+    bool CAMPANARIO::ProbarCampana(int nCampana) {
+        if (nCampana < 1 || nCampana > this->_nNumCampanas || this->_tocandoSecuencia) return false;
+        this->_DisparaMascara(MascaraCampana(nCampana - 1));
+        return true;
+    }
+
+    /**
+     * @brief Devuelve la calibración de las campanas en formato JSON
+     * 
+     * @details Formato: `{"perdidos":n,"campanas":[{"campana":1,"pulso":200,"reposo":0,"medidoUs":200123,"diferidos":0}, ...]}`
+     * 
+     * @return String JSON con pulso, reposo y último pulso medido de cada campana
+     * 
+     * @since v1.4
+     * @author Julian Salas Bartolomé
+     */
+    String CAMPANARIO::GetCampanasJSON(void) {
+        JsonDocument doc;
+        doc["perdidos"] = this->_nToquesPerdidos;
+        JsonArray lista = doc.createNestedArray("campanas");
+        for (int i = 0; i < this->_nNumCampanas; ++i) {
+            JsonObject campana = lista.createNestedObject();
+            campana["campana"] = i + 1;
+            campana["pulso"] = this->_pCampanas[i]->GetPulsoMs();
+            campana["reposo"] = this->_pCampanas[i]->GetReposoMs();
+            campana["medidoUs"] = this->_pCampanas[i]->GetUltimoPulsoUs();
+            campana["diferidos"] = this->_aToquesDiferidos[i];
+        }
+        String json;
+        serializeJson(doc, json);
+        return json;
+    }
+
     /**
      * @brief Detiene inmediatamente cualquier secuencia de campanadas activa
      * 
@@ -687,7 +1174,7 @@
      *          
      *          **ACCIONES REALIZADAS:**
      *          1. Marca secuencia como inactiva (_tocandoSecuencia = false)
-     *          2. Limpia array de campanadas planas
+     *          2. Descarta el programa de toques en curso
      *          3. Resetea contadores de secuencia
      *          4. Limpia flags de estado (BitDifuntos, BitMisa, etc.)
      *          5. Establece estado de reposo (_tocando = false)
@@ -704,7 +1191,8 @@
      */
     void CAMPANARIO::ParaSecuencia(void) {
         this->_tocandoSecuencia = false;                                                                // Detiene la secuencia de campanadas
-        this->_LimpiaraCampanadas();                                                                    // Limpia las campanadas
+        this->_CargaPrograma(nullptr);                                                                  // Descarta el programa en curso
+        this->_DescartaDiferidos();                                                                     // Un STOP no deja toques pendientes
         this -> secuenciaActiva = Config::Secuencia::NINGUNA;                                           // Resetea la secuencia activa
         DBG_CAM("Secuencia de campanadas detenida.");
         this->_nEstadoCampanario &= ~((Config::States::BIT_CALEFACCION - 1));                           // Limpia los bits de estado del campanario relacionados con las campanadas                     
@@ -730,12 +1218,9 @@
      * @author Julian Salas Bartolomé
      */
     void CAMPANARIO::TocaCuarto(int nCuarto) {
-        this->_LimpiaraCampanadas();                                                                    // Limpia las campanadas antes de tocar la hora
-        for (int i = 0; i < nCuarto; ++i) {                                                             // Itera sobre el número de cuartos a tocar                           
-            this->_aCampanadas[i].indiceCampana = 1;                                                    // Toca la campana 2
-            this->_aCampanadas[i].intervaloMs = 1000;                                                   // espaciado 1000 ms
-        }
-        this->_nCampanadas = nCuarto;                                                                   // Actualiza el número de campanadas a tocar
+        this->_aProgramaFijo[0] = { OP_TOQUE, this->_MascaraCuartos(), (uint16_t)nCuarto, 0, 0, 1000 };      // nCuarto toques de las campanas de cuartos espaciados 1000 ms
+        this->_aProgramaFijo[1] = { OP_FIN, 0, 0, 0, 0, 0 };
+        this->_CargaPrograma(this->_aProgramaFijo);                                                     // Selecciona el programa de cuartos
         this->_nEstadoCampanario |= Config::States::BIT_CUARTOS;                                        // Actualiza el estado del campanario para indicar que se están tocando cuartos
         this->IniciarSecuenciaCampanadas();                                                             // Inicia la secuencia de campanadas
         DBG_CAM_PRINT("Tocando cuarto: ");
@@ -774,20 +1259,13 @@
      * @author Julian Salas Bartolomé
      */
     void CAMPANARIO::TocaHorayCuartos(int nHora) {
-        this->_LimpiaraCampanadas();                                // Limpia las campanadas antes de tocar la hora
-        int i = 0;                                                  // Itera para los 4 cuartos
-        for ( i = 0; i < 4; ++i) {
-            this->_aCampanadas[i].indiceCampana = 1;                // Toca la campana 2 los cuatro cuartos
-            this->_aCampanadas[i].intervaloMs = 1000;               // espaciado 1000 ms
-        }
-
         int nHoraReal = nHora % 12;                                 // Asegura que la hora esté en el rango de 0 a 11
         int nHoraTocada = (nHoraReal == 0) ? 12 : nHoraReal;        // Si es 0, se toca la campana 12
-        for ( int i = 0; i < nHoraTocada; ++i) {
-            this->_aCampanadas[i+4].indiceCampana = 0;              // Toca la campana 2 para la hora
-            this->_aCampanadas[i+4].intervaloMs = ( i== 0) ? 3000 : 1000;       // espaciados 1000 ms o 3000 en el primer toque de hora
-        }    
-        this->_nCampanadas = nHoraTocada + 4;                       // Actualiza el número de campanadas a tocar (4 cuartos + hora)
+        this->_aProgramaFijo[0] = { OP_TOQUE, this->_MascaraCuartos(), 4, 0, 0, 1000 };                          // Cuatro cuartos espaciados 1000 ms
+        this->_aProgramaFijo[1] = { OP_TOQUE, this->_MascaraHoras(), 1, 0, 0, 3000 };                          // Primer toque de hora a 3000 ms
+        this->_aProgramaFijo[2] = { OP_TOQUE, this->_MascaraHoras(), (uint16_t)(nHoraTocada - 1), 0, 0, 1000 }; // Resto de la hora espaciado 1000 ms
+        this->_aProgramaFijo[3] = { OP_FIN, 0, 0, 0, 0, 0 };
+        this->_CargaPrograma(this->_aProgramaFijo);                 // Selecciona el programa de hora y cuartos
         this->_nEstadoCampanario |= Config::States::BIT_HORA;       // Actualiza el estado del campanario para indicar que se está tocando la hora
         this->IniciarSecuenciaCampanadas();                         // Inicia la secuencia de campanadas
         DBG_CAM_PRINTF("Tocando hora %d (%dh) con cuartos\n", nHoraTocada, nHora);
@@ -811,14 +1289,12 @@
      * @author Julian Salas Bartolomé
      */
     void CAMPANARIO::TocaHoraSinCuartos(int nHora) {
-        this->_LimpiaraCampanadas();                            // Limpia las campanadas antes de tocar la hora
         int nHoraReal = nHora % 12;                             // Asegura que la hora esté en el rango de 0 a 11
         int nHoraTocada = (nHoraReal == 0) ? 12 : nHoraReal;    // Si es 0, se toca la campana 12
-        for (int i = 0; i < nHoraTocada; ++i) {
-            this->_aCampanadas[i].indiceCampana = 0;            // Toca la campana 2 para la hora
-            this->_aCampanadas[i].intervaloMs = (i == 0) ? 3000 : 2000; // espaciados 1000 ms o 3000 en el primer toque de hora
-        }
-        this->_nCampanadas = nHoraTocada;                       // Actualiza el número de campanadas a tocar (solo la hora)
+        this->_aProgramaFijo[0] = { OP_TOQUE, this->_MascaraHoras(), 1, 0, 0, 3000 };                          // Primer toque de hora
+        this->_aProgramaFijo[1] = { OP_TOQUE, this->_MascaraHoras(), (uint16_t)(nHoraTocada - 1), 0, 0, 2000 }; // Resto de la hora espaciado 2000 ms
+        this->_aProgramaFijo[2] = { OP_FIN, 0, 0, 0, 0, 0 };
+        this->_CargaPrograma(this->_aProgramaFijo);             // Selecciona el programa de hora
         this->_nEstadoCampanario |= Config::States::BIT_HORA;       // Actualiza el estado del campanario para indicar que se está tocando la hora
         this->IniciarSecuenciaCampanadas();                         // Inicia la secuencia de campanadas
         DBG_CAM_PRINTF("Tocando hora %d (%dh) sin cuartos\n", nHoraTocada, nHora);
@@ -838,10 +1314,9 @@
      * @author Julian Salas Bartolomé
      */
     void CAMPANARIO::TocaMediaHora(void) {
-        this->_LimpiaraCampanadas();                                    // Limpia las campanadas antes de tocar la media hora
-        this->_aCampanadas[0].indiceCampana = 1;                        // Toca la campana 2 para la media hora
-        this->_aCampanadas[0].intervaloMs = 1000;                       // espaciado 1000 ms
-        this->_nCampanadas = 1;                                         // Actualiza el número de campanadas a tocar (1 para media hora)
+        this->_aProgramaFijo[0] = { OP_TOQUE, this->_MascaraCuartos(), 1, 0, 0, 1000 };  // Un toque de las campanas de cuartos para la media hora
+        this->_aProgramaFijo[1] = { OP_FIN, 0, 0, 0, 0, 0 };
+        this->_CargaPrograma(this->_aProgramaFijo);                     // Selecciona el programa de media hora
         this->_nEstadoCampanario |= Config::States::BIT_HORA;           // Actualiza el estado del campanario para indicar que se está tocando la media hora
         this->IniciarSecuenciaCampanadas();                             // Inicia la secuencia de campanadas
         DBG_CAM("Tocando media hora\n");
@@ -996,6 +1471,22 @@
             return -1;                                                      // Si no hay calefacción, retorna false
         }
     }
+
+    /**
+     * @brief Segundos restantes de calefacción, sin efectos
+     * 
+     * @details Para las consultas de la web (GET_TIEMPOCALEFACCION y la trama
+     *          binaria de estado): a diferencia de TestTemporizacionCalefaccion()
+     *          no apaga la calefacción si el temporizador ha vencido.
+     * 
+     * @return Segundos restantes, o -1 si no hay calefacción
+     * 
+     * @since v2.2
+     * @author Julian Salas Bartolomé
+     */
+    double CAMPANARIO::GetSegundosCalefaccion(void) {
+        return (this->_pCalefaccion != nullptr) ? this->_pCalefaccion->SegundosRestantes() : -1;
+    }
     /**
      * @brief Establece el flag de conexión a Internet
      * 
@@ -1093,4 +1584,84 @@
 
     uint8_t CAMPANARIO::GetSecuenciaActiva(void) {
         return this->secuenciaActiva;
-    }
\ No newline at end of file
+    }
+
+    /**
+     * @brief Añade una medida de retraso al histograma de jitter
+     * 
+     * @details Clasifica el retraso de un toque respecto a su instante absoluto
+     *          programado en las cubetas definidas por Config::Campanario::LIMITES_JITTER_US
+     *          y actualiza máximo y suma para la media.
+     * 
+     * @param nRetrasoUs Microsegundos transcurridos desde el instante programado
+     * 
+     * @since v1.3
+     * @author Julian Salas Bartolomé
+     */
+    void CAMPANARIO::_RegistraRetraso(int64_t nRetrasoUs) {
+        uint32_t nRetraso = (nRetrasoUs < 0) ? 0 : (uint32_t)nRetrasoUs;
+        int nCubeta = 0;
+        while (nCubeta < Config::Campanario::NUM_CUBETAS_JITTER - 1 && nRetraso >= Config::Campanario::LIMITES_JITTER_US[nCubeta]) {
+            nCubeta++;
+        }
+        this->_aHistogramaJitter[nCubeta]++;
+        this->_nToquesMedidos++;
+        this->_nSumaRetrasoUs += nRetraso;
+        if (nRetraso > this->_nMaxRetrasoUs) this->_nMaxRetrasoUs = nRetraso;
+    }
+
+    /**
+     * @brief Devuelve el histograma de retraso de los toques en formato JSON
+     * 
+     * @details Resume la precisión temporal del motor de secuencias desde el
+     *          arranque o desde el último ResetJitter().
+     *          
+     *          **CAMPOS:**
+     *          - toques: número de toques medidos
+     *          - mediaUs / maxUs: retraso medio y máximo respecto al instante absoluto
+     *          - derivaFinalUs: retraso del último toque de la última secuencia terminada
+     *          - limitesUs: límite superior de cada cubeta (la última es abierta)
+     *          - cubetas: número de toques en cada cubeta
+     * 
+     * @return String JSON con el histograma
+     * 
+     * @see Servidor.cpp - Comando WebSocket GET_JITTER_CAMPANARIO
+     * 
+     * @since v1.3
+     * @author Julian Salas Bartolomé
+     */
+    String CAMPANARIO::GetJitterJSON(void) {
+        JsonDocument doc;
+        doc["toques"] = this->_nToquesMedidos;
+        doc["mediaUs"] = (this->_nToquesMedidos > 0) ? (uint32_t)(this->_nSumaRetrasoUs / this->_nToquesMedidos) : 0;
+        doc["maxUs"] = this->_nMaxRetrasoUs;
+        doc["derivaFinalUs"] = this->_nDerivaFinalUs;
+        JsonArray limites = doc.createNestedArray("limitesUs");
+        for (int i = 0; i < Config::Campanario::NUM_CUBETAS_JITTER - 1; ++i) {
+            limites.add(Config::Campanario::LIMITES_JITTER_US[i]);
+        }
+        JsonArray cubetas = doc.createNestedArray("cubetas");
+        for (int i = 0; i < Config::Campanario::NUM_CUBETAS_JITTER; ++i) {
+            cubetas.add(this->_aHistogramaJitter[i]);
+        }
+        String resultado;
+        serializeJson(doc, resultado);
+        return resultado;
+    }
+
+    /**
+     * @brief Reinicia el histograma de retraso de los toques
+     * 
+     * @since v1.3
+     * @author Julian Salas Bartolomé
+     */
+    void CAMPANARIO::ResetJitter(void) {
+        for (int i = 0; i < Config::Campanario::NUM_CUBETAS_JITTER; ++i) {
+            this->_aHistogramaJitter[i] = 0;
+        }
+        this->_nToquesMedidos = 0;
+        this->_nMaxRetrasoUs = 0;
+        this->_nSumaRetrasoUs = 0;
+        this->_nDerivaFinalUs = 0;
+        DBG_CAM("Histograma de jitter reiniciado");
+    }
@@ -31,7 +31,7 @@
  *          
  *          **ARQUITECTURA MODULAR:**
  *          - Separación clara entre lógica de secuencias y ejecución
- *          - Sistema de generación de campanadas planas para optimización
+ *          - Secuencias compiladas a un programa run-length recorrido en su sitio
  *          - Control independiente de cada subsistema
  *          - Debug modular activable por compilación
  * 
@@ -39,7 +39,7 @@
  * @note **TIMING:** Utiliza millis() para control temporal no-bloqueante
  * @note **ESCALABILIDAD:** Diseñado para hasta MAX_CAMPANAS campanas
  * 
- * @warning **MEMORIA RAM:** Array de campanadas consume ~1.6KB (200 elementos)
+ * @warning **MEMORIA RAM:** 12 bytes por paso de secuencia, independiente del número de toques
  * @warning **CONCURRENCIA:** No thread-safe - usar desde un solo hilo
  * @warning **PUNTEROS:** Verificar validez de punteros antes de asignar
  * 
@@ -57,6 +57,7 @@
 	#define CAMPANARIO_H
     #include <stdint.h>
     #include <Arduino.h>  
+    #include <FS.h>
     #include "Campana.h"
     #include "Calefaccion.h"
     #include "Debug.h"
@@ -65,15 +66,23 @@
 
     
 
-    struct PasoSecuencia {                                      // Estructura que representa un paso en una secuencia de campanadas
-        int indiceCampana;                                      //!< Índice de la campana a tocar (0 para la primera, 1 para la segunda, etc.)    
-        int repeticiones;                                       //!< Número de veces que se repite el toque de la campana en este paso
-        int intervaloMs;                                        //!< Intervalo en milisegundos entre toques
+    inline uint8_t MascaraCampana(int nIndice) {                // Máscara de bit de la campana nIndice (0 para la primera, 1 para la segunda, etc.)
+        return (uint8_t)(1u << nIndice);
+    }
+
+    enum OpToque : uint8_t {                                    // Códigos de operación del programa de toques compilado
+        OP_FIN   = 0,                                           //!< Fin del programa
+        OP_TOQUE = 1,                                           //!< Toca mascaraCampanas repeticiones veces separadas intervaloMs
+        OP_SALTO = 2                                            //!< Vuelve a la instrucción destino repeticiones veces (0 = indefinidamente)
     };
 
-    struct ToquePlano {                                         // Estructura que representa un toque de campana en una secuencia
-        int indiceCampana;                                      //!< Índice de la campana a tocar
-        int intervaloMs;                                        //!< Intervalo en milisegundos entre toques
+    struct InstruccionToque {                                   // Instrucción run-length del programa de toques (12 bytes)
+        uint8_t opcode;                                         //!< Código de operación (OpToque)
+        uint8_t mascaraCampanas;                                //!< Máscara de campanas que suenan a la vez (bit 0 = primera campana)
+        uint16_t repeticiones;                                  //!< Toques del paso (OP_TOQUE) o vueltas del salto (OP_SALTO)
+        uint16_t pulsoMs;                                       //!< Pulso del badajo para este paso (0 = pulso propio de cada campana)
+        uint16_t destino;                                       //!< Índice de la instrucción de destino (OP_SALTO)
+        uint32_t intervaloMs;                                   //!< Intervalo en milisegundos antes de cada toque del paso
     };
 
 
@@ -91,6 +100,8 @@
             void IniciarSecuenciaCampanadas(void);                      //!< Inicia la secuencia de campanadas
             int ActualizarSecuenciaCampanadas(void);                    //!< Actualiza la secuencia de campanadas, tocando las campanas según el intervalo definido
             void ResetCampanaTocada(void);                              //!< Resetea el número de campana tocada
+            uint8_t GetMascaraTocada(void);                             //!< Devuelve la máscara de campanas tocadas en el último tiempo
+            uint16_t GetIndiceToque(void);                              //!< Devuelve los tiempos tocados desde el inicio de la secuencia
             void ParaSecuencia(void);                                   //!< Detiene la secuencia de campanadas
             void TocaHorayCuartos(int nHora);                           //!< Toca la campana 4 cuartos y la hora
             void TocaHoraSinCuartos(int nHora);                         //!< Toca la campana de la hora sin cuartos
@@ -101,6 +112,7 @@
             void EnciendeCalefaccion(int nMinutos);                     //!< Enciende la calefacción del campanario
             void ApagaCalefaccion(void);                                //!< Apaga la calefacción del campanario
             double TestTemporizacionCalefaccion(void);                  //!< Testea la temporización de la calefacción del campanario
+            double GetSegundosCalefaccion(void);                        //!< Segundos restantes de calefacción sin apagarla (-1 si no hay calefacción)
             bool GetEstadoCalefaccion(void);                            //!< Devuelve el estado de la calefacción del campanario (true si está encendida, false si está apagada)
             int GetEstadoCampanario(void);                              //!< Devuelve el estado del campanario
             void SetInternetConectado(void);                            //!< Establece el estado de conexión a Internet del campanario
@@ -108,30 +120,78 @@
             void SetProteccionCampanadas(void);                         //!< Establece el estado de protección de campanadas
             void ClearProteccionCampanadas(void);                       //!< Limpia el estado de protección de campanadas        
            uint8_t GetSecuenciaActiva(void);                           //!< Devuelve la secuencia activa actualmente (Difuntos, Misa, Horas, Cuartos, Ninguna)
+            String GetJitterJSON(void);                                 //!< Devuelve el histograma de retraso de los toques respecto a su instante absoluto
+            void ResetJitter(void);                                     //!< Reinicia el histograma de retraso
+            bool TocaSecuencia(const char* nombre);                     //!< Inicia una secuencia cargada por su nombre
+            bool TocaSecuencia(uint16_t nId);                           //!< Inicia una secuencia cargada por su ID
+            static uint16_t IdSecuencia(const char* nombre);            //!< ID hash de una secuencia a partir de su nombre
+            int BuscaSecuencia(uint16_t nId);                           //!< Índice de una secuencia por ID o -1 (O(1))
+            uint16_t GetIdSecuencia(int nIndice);                       //!< Devuelve el ID de la secuencia nIndice
+            String GetSecuenciasJSON(void);                             //!< Devuelve la lista de secuencias cargadas en JSON
+            uint16_t SetPulsoCampana(int nCampana, uint16_t nPulsoMs);  //!< Ajusta en caliente el pulso de una campana (1 = primera)
+            bool ProbarCampana(int nCampana);                           //!< Toque de prueba de una campana con su pulso actual
+            String GetCampanasJSON(void);                               //!< Devuelve pulso, reposo y medida de cada campana en JSON
+            int GetNumSecuencias(void);                                 //!< Devuelve el número de secuencias cargadas
+            const char* GetNombreSecuencia(int nIndice);                //!< Devuelve el nombre de la secuencia nIndice
 
          private:
 
             CAMPANA* _pCampanas[Config::Campanario::MAX_CAMPANAS];      //!< Array de punteros a las campanas del campanario
             int _nNumCampanas = 0;                                      //!< Número de campanas en el campanario
+            uint8_t _nMascaraHoras = 0;                                 //!< Campanas con ROL_HORAS
+            uint8_t _nMascaraCuartos = 0;                               //!< Campanas con ROL_CUARTOS
+            uint8_t _MascaraHoras(void);                                //!< Máscara de horas (primera campana si no hay roles)
+            uint8_t _MascaraCuartos(void);                              //!< Máscara de cuartos (segunda campana si no hay roles)
+
+            uint8_t _aToquesDiferidos[Config::Campanario::MAX_CAMPANAS]; //!< Toques en espera del reposo de cada campana
+            uint16_t _aPulsoDiferido[Config::Campanario::MAX_CAMPANAS]; //!< Pulso del último toque diferido de cada campana
+            uint8_t _nMascaraDiferida = 0;                              //!< Campanas con toques diferidos
+            uint32_t _nToquesPerdidos = 0;                              //!< Toques descartados por cola llena
+            bool _lFinPrograma = false;                                 //!< Programa en OP_FIN, esperando los toques diferidos
+            void _DifiereToque(int nIndice, uint16_t nPulsoMs);         //!< Encola un toque que llegó antes del reposo de su campana
+            uint8_t _AtiendeDiferidos(int64_t tAhoraUs);                //!< Dispara los toques diferidos que ya pueden sonar
+            void _DescartaDiferidos(void);                              //!< Vacía las colas de toques diferidos
             
-            ToquePlano _aCampanadas[200];                               //!< Array de campanadas a tocar en formato plano, un elemento por campanada, con un máximo de 200 elementos
-            int _nCampanadas = 0;                                       //!< Número de campanadas a tocar en la secuencia actual   
-            void _GeneraraCampanadas(const PasoSecuencia* secuencia, int numPasos); // Genera una secuencia de campanadas planas a partir de una secuencia de pasos definida
-            void _LimpiaraCampanadas(void) ;                            //!< Limpia el array de campanadas y reinicia el contador.    
+            const InstruccionToque* _pPrograma = nullptr;               //!< Programa compilado en ejecución (no se copia, se recorre en su sitio)
+            InstruccionToque _aProgramaFijo[4];                         //!< Programa de los toques horarios (hora, cuartos, media)
+            uint16_t _nPC = 0;                                          //!< Instrucción actual del programa
+            uint16_t _nRepeticionesRestantes = 0;                       //!< Toques pendientes de la instrucción actual
+            struct MarcoBucle { uint16_t pc; uint16_t restantes; };     //!< Estado de un salto con repetición en curso
+            MarcoBucle _aBucles[Config::Campanario::MAX_BUCLES_ANIDADOS]; //!< Pila de saltos con repetición
+            uint8_t _nBucles = 0;                                       //!< Saltos activos en la pila
+            void _CargaPrograma(const InstruccionToque* pPrograma);     //!< Selecciona el programa a ejecutar
+            bool _BuscaToque(void);                                     //!< Avanza el contador de programa hasta el siguiente OP_TOQUE
+            uint8_t _DisparaMascara(uint8_t nMascara, uint16_t nPulsoMs = 0); //!< Pone en HIGH todas las campanas de la máscara con una escritura de registro
     
-            // Arrays dinámicos para secuencias cargadas desde JSON
-            PasoSecuencia* _secuenciaDifuntos = nullptr;                //!< Array dinámico para secuencia de difuntos
-            int _numPasosDifuntos = 0;                                  //!< Número de pasos en secuencia de difuntos
-            PasoSecuencia* _secuenciaMisa = nullptr;                    //!< Array dinámico para secuencia de misa
-            int _numPasosMisa = 0;                                      //!< Número de pasos en secuencia de misa
-            PasoSecuencia* _secuenciaFiesta = nullptr;                  //!< Array dinámico para secuencia de fiesta
-            int _numPasosFiesta = 0;                                    //!< Número de pasos en secuencia de fiesta
-
-            int _indiceCampanadaActual = 0;                             //!< Índice de la campanada actual en la secuencia
-            unsigned long _ultimoToqueMs = 0;                           //!< Marca de tiempo del último toque de campana en milisegundos
+            // Secuencias cargadas desde Secuencias.json (pool preasignado)
+            struct SecuenciaRegistrada {
+                char nombre[Config::Campanario::MAX_NOMBRE_SECUENCIA];  //!< Nombre de la secuencia (clave o "id" en el JSON)
+                uint16_t id;                                            //!< ID hash del nombre (ver IdSecuencia())
+                uint16_t inicio;                                        //!< Primera instrucción en _aInstrucciones
+                uint16_t numPasos;                                      //!< Pasos de la secuencia (sin contar OP_FIN)
+            };
+            InstruccionToque _aInstrucciones[Config::Campanario::MAX_INSTRUCCIONES]; //!< Pool de instrucciones de todas las secuencias
+            uint16_t _nInstrucciones = 0;                               //!< Instrucciones ocupadas en el pool
+            SecuenciaRegistrada _aSecuencias[Config::Campanario::MAX_SECUENCIAS]; //!< Secuencias cargadas
+            int _nSecuencias = 0;                                       //!< Número de secuencias cargadas
+            bool _ParseaSecuencias(File& file);                         //!< Analiza Secuencias.json por bloques sobre el pool
+            uint8_t _aTablaSecuencias[Config::Campanario::TAM_TABLA_SECUENCIAS]; //!< Tabla hash id -> índice de secuencia + 1 (0 = libre)
+            bool _RegistraSecuencia(int nIndice);                       //!< Inserta una secuencia en la tabla hash
+
+            int64_t _tInicioSecuenciaUs = 0;                            //!< Origen absoluto (esp_timer_get_time) de la secuencia en curso
+            uint32_t _nOffsetSiguienteMs = 0;                           //!< Instante del siguiente toque respecto al origen, acumulado sin deriva
+            void _RegistraRetraso(int64_t nRetrasoUs);                  //!< Añade una medida de retraso al histograma
+
+            uint32_t _aHistogramaJitter[Config::Campanario::NUM_CUBETAS_JITTER] = {0};  //!< Número de toques por cubeta de retraso
+            uint32_t _nToquesMedidos = 0;                               //!< Toques incluidos en el histograma
+            uint32_t _nMaxRetrasoUs = 0;                                //!< Peor retraso observado
+            uint64_t _nSumaRetrasoUs = 0;                               //!< Suma de retrasos para la media
+            uint32_t _nDerivaFinalUs = 0;                               //!< Retraso del último toque de la última secuencia terminada
             bool _tocandoSecuencia = false;                             //!< Indica si se está tocando una secuencia de campanadas
 
             int _nCampanaTocada = 0;                                    //!< Número de campana tocada en la última secuencia
+            uint8_t _nMascaraTocada = 0;                                //!< Máscara de campanas tocadas en el último tiempo
+            uint16_t _nIndiceToque = 0;                                 //!< Tiempos tocados desde el inicio de la secuencia
             bool _lCalefaccion = false;                                 //!< Estado de la calefacción del campanario
             
             CALEFACCION* _pCalefaccion = nullptr;                       //!< Puntero a la calefacción del campanario
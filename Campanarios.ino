@@ -58,6 +58,9 @@
   #include "Acciones.h"
   #include "I2CServicio.h"
   #include "TelegramServicio.h"
+  #include "Arbitro.h"
+  #include "ColaComandos.h"
+  #include "Reloj.h"
   #include "Debug.h"
 
   //#include "Acciones.h"
@@ -82,16 +85,17 @@
       } else {
         cargarConfigWiFi();                                                           // Carga la configuración guardada
         DBG_INO("Iniciando Campanario...");
-        DBG_INO_PRINTF("📤 Versión actual: %s", Config::OTA::FIRMWARE_VERSION);
+        DBG_INO_PRINTF("📤 Versión actual: %s", Config::OTA::FIRMWARE_VERSION.c_str());
         initI2C();                                                                    // Inicializa el bus I2C como esclavo
 
-        CAMPANA* campana1 = new CAMPANA(Config::Pins::CAMPANA1);                      // Crea una nueva instancia de la clase CAMPANA para la campana 1
-        CAMPANA* campana2 = new CAMPANA(Config::Pins::CAMPANA2);                      // Crea una nueva instancia de la clase CAMPANA para la campana 2
+        if (!Salidas.Inicia()) {                                                      // Inicia la capa de salida (y los expansores I2C si los hay)
+            DBG_INO("[WARN] Algún expansor de relés no responde");
+        }
+        for (const auto& def : Config::Campanario::BANCO_CAMPANAS) {                  // Crea las campanas descritas en el banco de Configuracion.h
+            Campanario.AddCampana(new CAMPANA(def));                                  // Añade la campana al campanario en el orden del banco
+        }
 
         CALEFACCION* calefaccion = new CALEFACCION(Config::Pins::CALEFACCION);        // Crea una nueva instancia de la clase CALEFACCION
-
-        Campanario.AddCampana(campana1);                                              // Añade la campana 1 al campanario
-        Campanario.AddCampana(campana2);                                              // Añade la campana 2 al campanario
         Campanario.AddCalefaccion(calefaccion);                                       // Añade la calefacción al campanario  
 
         // Cargar secuencias de campanadas desde SPIFFS
@@ -131,19 +135,25 @@
   }
   void loop() {
 
-    if (!Campanario.GetEstadoSecuencia()) {                                 // Si no hay secuencia de campanadas en curso
-      if (RTC::isNtpSync()) {                                               // Si el RTC está sincronizado por NTP
-        Alarmas.check();                                                    // Llama a la función para buscar las alarmas programadas
-      }
+    if (Reloj::Sincronizado()) {                                            // Si hay hora válida (NTP o reloj virtual)
+      Alarmas.check();                                                      // Busca las alarmas programadas (sus toques pasan por el árbitro aunque suene otra secuencia)
+    }
+    Alarmas.guardarPendientes();                                            // Escribe en SPIFFS los cambios web de alarmas, agrupados y con retardo
+    if (Alarmas.importacionSolicitada()) {                                  // Si se ha subido un JSON de alarmas por /upload
+      IniciaAlarmas();                                                      // Lo importa y restaura callbacks y alarmas de sistema
+    }
 
+    if (!Campanario.GetEstadoSecuencia()) {                                 // Si no hay secuencia de campanadas en curso
       ActualizaEstadoProteccionCampanadas();                                // Llama a la función para comprobar si estamos en el período de proteccion de toque de campanas
-      if (millis() - ultimoCheckInternet > Config::Network::INTERNET_CHECK_INTERVAL_MS) {      // Comprueba si ha pasado el intervalo de tiempo para verificar la conexión a Internet
+      int32_t nProximaAlarma = Alarmas.segundosHastaProximo();              // Las comprobaciones de red pueden bloquear hasta WIFI_CONNECT_TIMEOUT_MS
+      bool lHayMargen = (nProximaAlarma < 0 || nProximaAlarma > Config::Network::MARGEN_PROXIMA_ALARMA_S);
+      if (lHayMargen && millis() - ultimoCheckInternet > Config::Network::INTERNET_CHECK_INTERVAL_MS) {      // Comprueba si ha pasado el intervalo de tiempo para verificar la conexión a Internet
           ultimoCheckInternet = millis();
           TestInternet();                                                   // Llama a la función para comprobar la conexión a Internet y actualizar el DNS si es necesario
       }
       
-      // Comprobar actualizaciones OTA automáticas
-      OTA.checkAutoUpdate();
+      // Comprobar actualizaciones OTA automáticas (tampoco justo antes de una alarma)
+      if (lHayMargen) OTA.checkAutoUpdate();
       
       // Verificar mensajes de Telegram    
 //      if (telegramBot.isEnabled()) {
@@ -151,24 +161,14 @@
 //      }
     }  
   
-    if (secuenciaI2C > 0) {                                                 // Si se ha recibido orden por I2C
-      if (secuenciaI2C == Config::States::SET_TEMPORIZADOR) {
-          // Secuencias que SÍ necesitan parámetro:
-          EjecutaSecuencia(secuenciaI2C, ParametroI2C, Config::Telegram::METODO_ACTIVACION_MANUAL);                     // Con parámetro I2C
-          DBG_INO_PRINTF("I2C -> EjecutaSecuencia(%d, %d, %d)", secuenciaI2C, ParametroI2C, Config::Telegram::METODO_ACTIVACION_MANUAL  );
-      } else {
-          // Secuencias que NO necesitan parámetro:
-          EjecutaSecuencia(secuenciaI2C, Config::Telegram::METODO_ACTIVACION_MANUAL);                                   // Sin parámetro
-          DBG_INO_PRINTF("I2C -> EjecutaSecuencia(%d,  %d)", secuenciaI2C, Config::Telegram::METODO_ACTIVACION_MANUAL);
-      }
-      secuenciaI2C = 0;                                                     // Resetea para esperar la siguiente orden
-      nToque = 0;                                                           // Resetea el numero de la secuencia a tocar
-    }
-    if (nToque > 0) {                                                       // Si la orden se ha recibido por websocket
+    if (nToque > 0) {                                                       // Orden diferida desde el propio loop() (apagado automático de la calefacción)
       EjecutaSecuencia(nToque, Config::Telegram::METODO_ACTIVACION_WEB);                                              // Llama a la función para ejecutar la orden recibida de inernet
       nToque = 0;                                                           // Resetea el numero de la secuencia a tocar
     }
   
+    ColaComandos.Atiende();                                                 // Ejecuta las órdenes de WebSocket e I2C (único dueño de Campanario)
+    Arbitro.Atiende();                                                      // Decide y lanza los toques pedidos (reloj, alarmas, web, I2C)
+
     TestCampanadas();                                                     // Llama a la función para probar las campanadas y enviar el número de campana tocada a los clientes conectados
   
     if ( Campanario.GetEstadoCalefaccion())
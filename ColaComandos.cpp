@@ -0,0 +1,190 @@
+#include "ColaComandos.h"
+#include <ArduinoJson.h>
+#include <esp_timer.h>
+#include "Auxiliar.h"     // Para Campanario y EjecutaSecuencia
+#include "Arbitro.h"      // Para Arbitro
+#include "Servidor.h"     // Para ws, ejecutaOrdenAlarma y ejecutaConsulta
+
+COLA_COMANDOS ColaComandos;
+
+static const char* const NOMBRES_ORIGEN[NUM_ORIGENES] = { "web", "i2c" };
+
+    /**
+     * @brief Presenta una orden para loop()
+     *
+     * @details Copia la orden con su marca de tiempo en la ColaMPSC. No toca
+     *          ningún estado del campanario: se ejecuta en Atiende().
+     *
+     * @param tipo Qué hacer
+     * @param origen Tarea que lo pide (para las estadísticas de latencia)
+     * @param nParametro Según el tipo (minutos, campana, orden I2C)
+     * @param nValor Según el tipo (pulso en ms, parámetro I2C, idWeb)
+     * @param pDatos OrdenAlarma o ExcepcionAlarma reservado con new; la cola se queda con él
+     * @param nCliente Id del WebSocket que espera la respuesta (0 = todos)
+     * @return false si la cola estaba llena y la orden se ha perdido (pDatos ya liberado)
+     *
+     * @note **TAREAS:** Sin cerrojos; segura desde async_tcp, el callback I2C y loop()
+     *
+     * @since v2.2
+     * @author Julian Salas Bartolomé
+     */
+    bool COLA_COMANDOS::Encola(TipoComando tipo, OrigenComando origen, uint16_t nParametro, uint32_t nValor,
+                               void* pDatos, uint32_t nCliente) {
+        Comando comando = { tipo, origen, nParametro, nValor, pDatos, nCliente, esp_timer_get_time() };
+        if (this->_cola.Encola(comando)) return true;
+        _LiberaDatos(comando);
+        this->_aPerdidas[origen].fetch_add(1, std::memory_order_relaxed);
+        DBG_COLA_PRINTF("Cola llena: perdida orden %u de %s", tipo, NOMBRES_ORIGEN[origen]);
+        return false;
+    }
+
+    /**
+     * @brief Ejecuta las órdenes pendientes en orden de llegada
+     *
+     * @details Antes de ejecutar cada orden anota cuánto esperó en la cola.
+     *          Se llama al principio de loop(), antes de Arbitro.Atiende(), para
+     *          que una orden I2C de toque llegue al árbitro en la misma vuelta.
+     *
+     * @warning **LOOP:** Llamar solo desde loop(); es el único consumidor de la cola
+     *
+     * @since v2.2
+     * @author Julian Salas Bartolomé
+     */
+    void COLA_COMANDOS::Atiende(void) {
+        Comando comando;
+        while (this->_cola.Saca(comando)) {
+            int64_t nEsperaUs = esp_timer_get_time() - comando.tEncoladoUs;
+            Latencia& latencia = this->_aLatencia[comando.origen];
+            uint32_t nEspera = (nEsperaUs < 0) ? 0 : (uint32_t)nEsperaUs;
+            latencia.nComandos++;
+            latencia.nSumaUs += nEspera;
+            if (nEspera > latencia.nMaxUs) latencia.nMaxUs = nEspera;
+            DBG_COLA_PRINTF("Orden %u de %s tras %u us", comando.tipo, NOMBRES_ORIGEN[comando.origen], nEspera);
+            this->_Ejecuta(comando);
+            _LiberaDatos(comando);
+        }
+    }
+
+    void COLA_COMANDOS::_Ejecuta(const Comando& comando) {
+        switch (comando.tipo) {
+            case CMD_CALEFACCION_ON:
+                Campanario.EnciendeCalefaccion(comando.parametro);
+                break;
+            case CMD_CALEFACCION_OFF:
+                Campanario.ApagaCalefaccion();
+                break;
+            case CMD_PULSO_CAMPANA: {
+                [[maybe_unused]] uint16_t nAplicado = Campanario.SetPulsoCampana(comando.parametro, (uint16_t)comando.valor);
+                DBG_COLA_PRINTF("Pulso campana %u -> %u ms", comando.parametro, nAplicado);
+                ws.textAll("CAMPANAS:" + Campanario.GetCampanasJSON());    // Con el pulso ya aplicado (y limitado)
+                break;
+            }
+            case CMD_PROBAR_CAMPANA:
+                if (!Campanario.ProbarCampana(comando.parametro)) {
+                    DBG_COLA_PRINTF("Toque de prueba rechazado: campana %u", comando.parametro);
+                }
+                break;
+            case CMD_RESET_JITTER:
+                Campanario.ResetJitter();
+                ws.textAll("JITTER_CAMPANARIO:" + Campanario.GetJitterJSON());
+                break;
+            case CMD_CARGA_SECUENCIAS:
+                Campanario.CargarSecuencias();
+                break;
+            case CMD_I2C:
+                this->_EjecutaI2C((uint8_t)comando.parametro, (uint8_t)comando.valor);
+                break;
+            case CMD_ALARMA_ADD:
+            case CMD_ALARMA_EDIT:
+            case CMD_ALARMA_DELETE:
+            case CMD_ALARMA_HABILITA:
+            case CMD_ALARMA_CONSULTA:
+            case CMD_EXCEPCION_ADD:
+            case CMD_EXCEPCION_DELETE:
+                ejecutaOrdenAlarma(comando);                                // Servidor.cpp: aplica la orden y responde al cliente
+                break;
+            case CMD_CONSULTA:
+                ejecutaConsulta(comando);                                   // Servidor.cpp: responde con el estado leído aquí
+                break;
+        }
+    }
+
+    /**
+     * @brief Libera los datos que acompañan a una orden de alarma
+     *
+     * @param comando Orden ya ejecutada o rechazada por la cola llena
+     */
+    void COLA_COMANDOS::_LiberaDatos(const Comando& comando) {
+        switch (comando.tipo) {
+            case CMD_ALARMA_ADD:
+            case CMD_ALARMA_EDIT:
+                delete static_cast<OrdenAlarma*>(comando.pDatos);
+                break;
+            case CMD_EXCEPCION_ADD:
+            case CMD_EXCEPCION_DELETE:
+                delete static_cast<ExcepcionAlarma*>(comando.pDatos);
+                break;
+            default:
+                break;
+        }
+    }
+
+    /**
+     * @brief Ejecuta una orden del DialCampanario
+     *
+     * @details Los toques y la parada van al árbitro con prioridad manual o de
+     *          emergencia; el resto (calefacción, protección) se ejecuta directamente.
+     *
+     * @param nOrden Config::States recibido por I2C
+     * @param nParametro Segundo byte I2C (índice de secuencia o minutos)
+     */
+    void COLA_COMANDOS::_EjecutaI2C(uint8_t nOrden, uint8_t nParametro) {
+        if (nOrden == Config::States::STOP) {
+            Arbitro.Solicita(TOQUE_PARAR, PRIO_EMERGENCIA, 0, Config::Telegram::METODO_ACTIVACION_MANUAL);                // La parada corta cualquier toque
+            DBG_COLA("I2C -> Parada solicitada al árbitro");
+        } else if (nOrden == Config::States::DIFUNTOS || nOrden == Config::States::MISA || nOrden == Config::States::FIESTA) {
+            Arbitro.Solicita(TOQUE_SECUENCIA, PRIO_MANUAL, nOrden, Config::Telegram::METODO_ACTIVACION_MANUAL);           // Toque manual desde el DialCampanario
+            DBG_COLA_PRINTF("I2C -> Secuencia %d solicitada al árbitro", nOrden);
+        } else if (nOrden == Config::States::SECUENCIA_REGISTRADA) {
+            Arbitro.Solicita(TOQUE_SECUENCIA, PRIO_MANUAL, Campanario.GetIdSecuencia(nParametro), Config::Telegram::METODO_ACTIVACION_MANUAL);  // Índice de la biblioteca -> ID
+            DBG_COLA_PRINTF("I2C -> Secuencia registrada %d solicitada al árbitro", nParametro);
+        } else if (nOrden == Config::States::SET_TEMPORIZADOR) {
+            EjecutaSecuencia(nOrden, nParametro, Config::Telegram::METODO_ACTIVACION_MANUAL);                           // Con parámetro I2C
+            DBG_COLA_PRINTF("I2C -> EjecutaSecuencia(%d, %d)", nOrden, nParametro);
+        } else {
+            EjecutaSecuencia(nOrden, Config::Telegram::METODO_ACTIVACION_MANUAL);                                       // Sin parámetro
+            DBG_COLA_PRINTF("I2C -> EjecutaSecuencia(%d)", nOrden);
+        }
+    }
+
+    /**
+     * @brief Devuelve las estadísticas de la cola en JSON
+     *
+     * @details Formato:
+     *          {"tam":n,"origenes":[{"origen","comandos","perdidas","mediaUs","maxUs"}]}
+     *
+     * @return Cadena JSON para el comando GET_COLA_COMANDOS
+     *
+     * @note Solo desde loop() (GET_COLA_COMANDOS llega como CMD_CONSULTA):
+     *       las sumas de 64 bits no se pueden leer enteras desde otra tarea
+     *
+     * @since v2.2
+     * @author Julian Salas Bartolomé
+     */
+    String COLA_COMANDOS::GetEstadoJSON(void) {
+        JsonDocument doc;
+        doc["tam"] = Config::ColaComandos::TAM_COLA;
+        JsonArray origenes = doc.createNestedArray("origenes");
+        for (uint8_t i = 0; i < NUM_ORIGENES; ++i) {
+            Latencia latencia = this->_aLatencia[i];
+            JsonObject origen = origenes.createNestedObject();
+            origen["origen"] = NOMBRES_ORIGEN[i];
+            origen["comandos"] = latencia.nComandos;
+            origen["perdidas"] = this->_aPerdidas[i].load(std::memory_order_relaxed);
+            origen["mediaUs"] = latencia.nComandos ? (uint32_t)(latencia.nSumaUs / latencia.nComandos) : 0;
+            origen["maxUs"] = latencia.nMaxUs;
+        }
+        String json;
+        serializeJson(doc, json);
+        return json;
+    }
@@ -0,0 +1,174 @@
+/**
+ * @file ColaComandos.h
+ * @brief Órdenes de las tareas de comunicaciones hacia loop(), sin cerrojos
+ *
+ * @details El servidor web (tarea async_tcp) y el DialCampanario (tarea I2C)
+ *          no tocan el estado del campanario: presentan una orden tipada en
+ *          esta cola y loop(), dueño único de Campanario, la ejecuta en su
+ *          siguiente vuelta. Así la calefacción, la calibración de campanas o
+ *          la recarga de secuencias nunca se cruzan con
+ *          ActualizarSecuenciaCampanadas() en el otro núcleo. Lo mismo con
+ *          AlarmScheduler: sus ediciones y consultas web se hacen entre dos
+ *          check() y nunca liberan un texto que otra tarea está leyendo.
+ *
+ *          **ÓRDENES:**
+ *          - CMD_CALEFACCION_ON / CMD_CALEFACCION_OFF
+ *          - CMD_PULSO_CAMPANA, CMD_PROBAR_CAMPANA, CMD_RESET_JITTER
+ *          - CMD_CARGA_SECUENCIAS: Secuencias.json subido por /upload
+ *          - CMD_I2C: orden del DialCampanario (Config::States y parámetro)
+ *          - CMD_ALARMA_ADD / EDIT / DELETE / HABILITA: alarmas personalizables
+ *          - CMD_EXCEPCION_ADD / DELETE: excepciones por fecha
+ *          - CMD_ALARMA_CONSULTA: listados de alarmas, excepciones y agenda
+ *          - CMD_CONSULTA: estado del árbitro, de la cola, del jitter, de las
+ *            campanas y de la biblioteca de secuencias
+ *
+ *          **DATOS:**
+ *          - Las órdenes de alarma que no caben en parámetro/valor llevan en
+ *            pDatos un OrdenAlarma o ExcepcionAlarma reservado con new
+ *          - La cola se queda con él: lo libera tras ejecutarlo o si está llena
+ *          - cliente es el id del WebSocket que espera la respuesta (0 = todos)
+ *
+ *          **LATENCIA:**
+ *          - Cada orden lleva el instante en que se encoló (esp_timer_get_time)
+ *          - Atiende() acumula por origen órdenes, perdidas, media y máximo
+ *          - GET_COLA_COMANDOS las devuelve en JSON
+ *
+ * @note **TOQUES:** Las peticiones de toque siguen pasando por Arbitro.Solicita(),
+ *       que usa la misma ColaMPSC como buffer de entrada
+ * @note **ALARMAS:** Sus acciones ya se ejecutan dentro de check(); solo pasan
+ *       por la cola las órdenes web que editan o consultan el planificador
+ *
+ * @author Julian Salas Bartolomé
+ * @date 2025-10-17
+ * @version 1.0
+ *
+ * @see ColaMPSC.h - Cola sin cerrojos utilizada
+ * @see Arbitro.h - Árbitro de las peticiones de toque
+ * @see Configuracion.h - Config::ColaComandos::TAM_COLA
+ */
+#ifndef COLACOMANDOS_H
+	#define COLACOMANDOS_H
+
+        #include <Arduino.h>
+        #include "Configuracion.h"
+        #include "Debug.h"
+        #include "ColaMPSC.h"
+        #include "Alarmas.h"
+
+        /**
+         * @brief Orden para loop()
+         */
+        enum TipoComando : uint8_t {
+            CMD_CALEFACCION_ON = 0,                                         //!< Enciende la calefacción (parámetro = minutos)
+            CMD_CALEFACCION_OFF,                                            //!< Apaga la calefacción
+            CMD_PULSO_CAMPANA,                                              //!< Pulso de una campana (parámetro = campana, valor = ms)
+            CMD_PROBAR_CAMPANA,                                             //!< Toque de prueba (parámetro = campana)
+            CMD_RESET_JITTER,                                               //!< Reinicia el histograma de retraso
+            CMD_CARGA_SECUENCIAS,                                           //!< Relee Secuencias.json
+            CMD_I2C,                                                        //!< Orden del DialCampanario (parámetro = Config::States, valor = parámetro I2C)
+            CMD_ALARMA_ADD,                                                 //!< Crea una personalizable (pDatos = OrdenAlarma)
+            CMD_ALARMA_EDIT,                                                //!< Modifica una personalizable (pDatos = OrdenAlarma con idWeb)
+            CMD_ALARMA_DELETE,                                              //!< Elimina una personalizable (valor = idWeb)
+            CMD_ALARMA_HABILITA,                                            //!< Habilita o deshabilita (parámetro = 0/1, valor = idWeb)
+            CMD_ALARMA_CONSULTA,                                            //!< Listado para un cliente (parámetro = ConsultaAlarma, valor = días de agenda)
+            CMD_EXCEPCION_ADD,                                              //!< Crea o sustituye una excepción (pDatos = ExcepcionAlarma)
+            CMD_EXCEPCION_DELETE,                                           //!< Elimina una excepción (pDatos = ExcepcionAlarma con idWeb y fecha)
+            CMD_CONSULTA                                                    //!< Estado de loop() para un cliente (parámetro = ConsultaEstado)
+        };
+
+        /**
+         * @brief Estado pedido con CMD_CONSULTA (lo modifica loop(): se lee allí)
+         */
+        enum ConsultaEstado : uint8_t {
+            CONSULTA_COLA_COMANDOS = 0,                                     //!< COLA_COMANDOS: latencia de esta cola
+            CONSULTA_ARBITRO,                                               //!< ARBITRO: toque en curso, cola y registro
+            CONSULTA_JITTER,                                                //!< JITTER_CAMPANARIO: histograma de retraso
+            CONSULTA_CAMPANAS,                                              //!< CAMPANAS: calibración
+            CONSULTA_SECUENCIAS                                             //!< SECUENCIAS: biblioteca cargada
+        };
+
+        /**
+         * @brief Listado pedido con CMD_ALARMA_CONSULTA
+         */
+        enum ConsultaAlarma : uint8_t {
+            CONSULTA_ALARMAS = 0,                                           //!< ALARMAS_WEB: personalizables
+            CONSULTA_ESTADISTICAS,                                          //!< STATS_ALARMAS_WEB
+            CONSULTA_EXCEPCIONES,                                           //!< EXCEPCIONES_ALARMA_WEB
+            CONSULTA_AGENDA                                                 //!< AGENDA: toques previstos
+        };
+
+        /**
+         * @brief Alarma personalizable ya validada por el servidor (CMD_ALARMA_ADD / EDIT)
+         */
+        struct OrdenAlarma {
+            int idWeb;                                                      //!< Solo EDIT
+            char nombre[ALARMA_TAM_NOMBRE];
+            char descripcion[ALARMA_TAM_DESCRIPCION];
+            char tipo[ALARMA_TAM_TIPO];                                     //!< Acción web ("MISA", secuencia...)
+            char cron[CRON_MAX_TEXTO];                                      //!< "" = por día/hora/minuto
+            void (*accion)(uint16_t);                                       //!< Resuelta con ResuelveAccionAlarma()
+            uint16_t parametro;
+            uint8_t mascaraDias;
+            uint8_t hora;
+            uint8_t minuto;
+            bool habilitada;
+            uint8_t fiesta;                                                 //!< FiestaLiturgica
+            int16_t desplazamientoDias;
+            uint8_t recuperacion;
+            uint8_t margenRecuperacion;
+        };
+
+        /**
+         * @brief Tarea que presentó la orden
+         */
+        enum OrigenComando : uint8_t {
+            ORIGEN_WEB = 0,                                                 //!< WebSocket y HTTP (tarea async_tcp)
+            ORIGEN_I2C,                                                     //!< DialCampanario (callback de Wire)
+            NUM_ORIGENES                                                    //!< Número de orígenes (no es un origen)
+        };
+
+        /**
+         * @brief Orden en tránsito
+         */
+        struct Comando {
+            TipoComando tipo;                                               //!< Qué hacer
+            OrigenComando origen;                                           //!< Quién lo pidió
+            uint16_t parametro;                                             //!< Según el tipo
+            uint32_t valor;                                                 //!< Según el tipo
+            void* pDatos;                                                   //!< OrdenAlarma o ExcepcionAlarma (propiedad de la cola) o nullptr
+            uint32_t cliente;                                               //!< Id del WebSocket que espera respuesta (0 = todos)
+            int64_t tEncoladoUs;                                            //!< esp_timer_get_time() al encolar
+        };
+
+        class COLA_COMANDOS
+        {
+            public:
+
+                bool Encola (TipoComando tipo, OrigenComando origen, uint16_t nParametro = 0, uint32_t nValor = 0,
+                             void* pDatos = nullptr, uint32_t nCliente = 0);  //!< Presenta una orden (cualquier tarea)
+                void Atiende (void);                                        //!< Ejecuta las órdenes pendientes (desde loop)
+                String GetEstadoJSON (void);                                //!< Órdenes, perdidas y latencia por origen en JSON
+
+            private:
+
+                void _Ejecuta (const Comando& comando);                     //!< Ejecuta una orden en loop()
+                void _EjecutaI2C (uint8_t nOrden, uint8_t nParametro);      //!< Ejecuta una orden del DialCampanario
+                static void _LiberaDatos (const Comando& comando);          //!< Libera pDatos según el tipo
+
+                /**
+                 * @brief Estadísticas de un origen
+                 */
+                struct Latencia {
+                    uint32_t nComandos;                                     //!< Órdenes ejecutadas
+                    uint32_t nMaxUs;                                        //!< Mayor espera en la cola
+                    uint64_t nSumaUs;                                       //!< Suma de esperas para la media
+                };
+
+                ColaMPSC<Comando, Config::ColaComandos::TAM_COLA> _cola;    //!< Órdenes entre tareas
+                Latencia _aLatencia[NUM_ORIGENES] = {};                     //!< Solo las escribe loop()
+                std::atomic<uint32_t> _aPerdidas[NUM_ORIGENES];             //!< Órdenes rechazadas con la cola llena
+        };
+
+        extern COLA_COMANDOS ColaComandos;                                  //!< Cola única hacia loop()
+
+#endif
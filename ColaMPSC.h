@@ -0,0 +1,99 @@
+/**
+ * @file ColaMPSC.h
+ * @brief Cola circular sin cerrojos para varios productores y un consumidor
+ *
+ * @details Cola acotada de Dmitry Vyukov: cada celda lleva un número de
+ *          secuencia que indica si está libre para el productor de esa vuelta
+ *          o lista para el consumidor. Los productores reservan su posición con
+ *          un compare_exchange sobre el índice de escritura y publican el dato
+ *          con una escritura release de la secuencia de la celda.
+ *
+ *          **USO EN EL CAMPANARIO:**
+ *          - Productores: tarea async_tcp (WebSocket), tarea I2C, loop()
+ *          - Consumidor único: loop(), que es quien toca el campanario
+ *          - Ninguna operación bloquea ni desactiva interrupciones
+ *
+ * @note **TAMAÑO:** N debe ser potencia de 2 (el índice se enmascara)
+ * @note **LLENA:** Encola() devuelve false; el productor decide si lo contabiliza
+ *
+ * @warning **CONSUMIDOR:** Saca() solo desde una tarea; no es segura entre consumidores
+ *
+ * @author Julian Salas Bartolomé
+ * @date 2025-10-17
+ * @version 1.0
+ *
+ * @see Arbitro.h - Buffer de entrada de las peticiones de toque
+ * @see ColaComandos.h - Órdenes de las tareas de comunicaciones para loop()
+ */
+#ifndef COLAMPSC_H
+	#define COLAMPSC_H
+
+        #include <stdint.h>
+        #include <atomic>
+
+        template <typename T, uint16_t N>
+        class ColaMPSC
+        {
+            static_assert(N >= 2 && (N & (N - 1)) == 0, "El tamaño de la cola debe ser potencia de 2");
+
+            public:
+
+                ColaMPSC() : _nEscritura(0) {
+                    for (uint16_t i = 0; i < N; ++i) {
+                        this->_aCeldas[i].secuencia.store(i, std::memory_order_relaxed);
+                    }
+                }
+
+                /**
+                 * @brief Añade un elemento (cualquier tarea)
+                 *
+                 * @return false si la cola está llena
+                 */
+                bool Encola(const T& dato) {
+                    uint32_t nPos = this->_nEscritura.load(std::memory_order_relaxed);
+                    for (;;) {
+                        Celda& celda = this->_aCeldas[nPos & (N - 1)];
+                        int32_t nDif = (int32_t)(celda.secuencia.load(std::memory_order_acquire) - nPos);
+                        if (nDif == 0) {                                    // Celda libre en esta vuelta: intenta reservarla
+                            if (this->_nEscritura.compare_exchange_weak(nPos, nPos + 1, std::memory_order_relaxed)) {
+                                celda.dato = dato;
+                                celda.secuencia.store(nPos + 1, std::memory_order_release);  // Publica el dato al consumidor
+                                return true;
+                            }
+                        } else if (nDif < 0) {                              // El consumidor aún no ha liberado la celda
+                            return false;
+                        } else {                                            // Otro productor se adelantó
+                            nPos = this->_nEscritura.load(std::memory_order_relaxed);
+                        }
+                    }
+                }
+
+                /**
+                 * @brief Saca el elemento más antiguo (solo el consumidor)
+                 *
+                 * @return false si no hay ninguno publicado
+                 */
+                bool Saca(T& dato) {
+                    Celda& celda = this->_aCeldas[this->_nLectura & (N - 1)];
+                    if ((int32_t)(celda.secuencia.load(std::memory_order_acquire) - (this->_nLectura + 1)) < 0) {
+                        return false;                                       // Vacía o aún a medio escribir
+                    }
+                    dato = celda.dato;
+                    celda.secuencia.store(this->_nLectura + N, std::memory_order_release);  // Libre para la siguiente vuelta
+                    this->_nLectura++;
+                    return true;
+                }
+
+            private:
+
+                struct Celda {
+                    std::atomic<uint32_t> secuencia;                        //!< Posición para la que la celda está libre o publicada
+                    T dato;
+                };
+
+                Celda _aCeldas[N];                                          //!< Celdas de la cola
+                std::atomic<uint32_t> _nEscritura;                          //!< Siguiente posición a reservar por los productores
+                uint32_t _nLectura = 0;                                     //!< Siguiente posición a leer (solo el consumidor)
+        };
+
+#endif
@@ -20,6 +20,9 @@
             constexpr uint8_t SLAVE_ADDR = 0x12;
             constexpr int SDA_PIN        = 21;
             constexpr int SCL_PIN        = 22;
+            constexpr int EXPANSOR_SDA_PIN = 16;                // Bus maestro (Wire1) de los expansores de relés
+            constexpr int EXPANSOR_SCL_PIN = 17;
+            constexpr uint32_t EXPANSOR_FRECUENCIA = 400000;    // 400 kHz: una escritura PCF8574 en ~50 us
         }
 
         // ==================== TIMING ====================
@@ -56,6 +59,9 @@
 
             // Timeouts
             constexpr unsigned long WIFI_CONNECT_TIMEOUT_MS = 10000;  // 10 segundos
+
+            // Sin comprobaciones de red (TestInternet, OTA) si una alarma vence antes de este margen
+            constexpr int32_t MARGEN_PROXIMA_ALARMA_S = (int32_t)(WIFI_CONNECT_TIMEOUT_MS / 1000UL) + 5;
         }
 
         namespace Telegram {
@@ -150,7 +156,8 @@
                 FIN                         = 13,
                 FECHA_HORA_O_TEMPORIZACION  = 14,
                 TEMPORIZACION               = 15,
-                SECUENCIA_ACTIVA            = 16
+                SECUENCIA_ACTIVA            = 16,
+                SECUENCIA_REGISTRADA        = 17        // Parámetro: índice en la biblioteca de secuencias
             };
 
             // Bits de estado
@@ -190,11 +197,107 @@
         }
         // ==================== CAMPANARIO ====================
         namespace Campanario {
-            constexpr int MAX_CAMPANAS = 2;  // Número máximo de campanas en el campanario
+            constexpr int MAX_CAMPANAS = 8;  // Número máximo de campanas en el campanario (un bit por campana en la máscara de toque)
+
+            // Banco de campanas: cada entrada es una campana, en el orden de sus índices (campana 1 = entrada 0)
+            constexpr uint8_t SIN_EXPANSOR = 0xFF;  // La campana usa un pin GPIO propio
+            constexpr uint8_t ROL_HORAS    = 0x01;  // Toca las horas
+            constexpr uint8_t ROL_CUARTOS  = 0x02;  // Toca cuartos y medias
+            struct DefCampana {
+                int8_t   pin;                       // Pin GPIO o -1 si va en un expansor
+                uint8_t  expansor;                  // Índice en DIRECCIONES_EXPANSOR o SIN_EXPANSOR
+                uint8_t  canal;                     // Canal 0-7 del expansor
+                uint16_t pulsoMs;                   // Duración del pulso del badajo
+                uint16_t reposoMs;                  // Tiempo mínimo entre dos toques de la campana
+                uint8_t  roles;                     // ROL_HORAS | ROL_CUARTOS
+            };
+            constexpr DefCampana BANCO_CAMPANAS[] = {
+                { Pins::CAMPANA1, SIN_EXPANSOR, 0, 200, 0, ROL_HORAS },
+                { Pins::CAMPANA2, SIN_EXPANSOR, 0, 200, 0, ROL_CUARTOS },
+                // { -1, 0, 0, 250, 1500, 0 },    // Ejemplo: relé 0 del primer expansor
+            };
+            constexpr int NUM_CAMPANAS_BANCO = sizeof(BANCO_CAMPANAS) / sizeof(BANCO_CAMPANAS[0]);
+            static_assert(NUM_CAMPANAS_BANCO <= MAX_CAMPANAS, "BANCO_CAMPANAS supera MAX_CAMPANAS");
+
+            // Expansores I2C PCF8574 de las placas de relés (en Wire1)
+            constexpr uint8_t DIRECCIONES_EXPANSOR[] = { 0x20 };
+            constexpr int NUM_EXPANSORES = sizeof(DIRECCIONES_EXPANSOR);
+            constexpr bool EXPANSOR_ACTIVO_BAJO = true;  // Las placas de relés PCF8574 activan el relé con 0
+
+            constexpr uint16_t PULSO_MIN_MS = 20;           // Pulso mínimo ajustable desde la web
+            constexpr uint16_t PULSO_MAX_MS = 1000;         // Pulso máximo ajustable desde la web (protege la bobina)
+            constexpr uint32_t INTERVALO_MAX_MS = 3600000;  // Intervalo máximo de un paso de Secuencias.json (1 h)
+            constexpr uint8_t MAX_TOQUES_DIFERIDOS = 4;     // Toques en espera por campana mientras está en reposo
+            constexpr int MAX_BUCLES_ANIDADOS = 4;  // Profundidad máxima de saltos con repetición en un programa de toques
+            constexpr int MAX_SECUENCIAS = 16;      // Secuencias con nombre admitidas en Secuencias.json
+            constexpr int MAX_INSTRUCCIONES = 512;  // Instrucciones totales del pool de secuencias (incluye un OP_FIN por secuencia; 12 bytes cada una)
+            constexpr int MAX_NOMBRE_SECUENCIA = 20; // Longitud máxima del nombre de una secuencia (con terminador)
+            constexpr int TAM_TABLA_SECUENCIAS = 32; // Huecos de la tabla hash de secuencias (potencia de 2, mayor que MAX_SECUENCIAS)
+            constexpr uint16_t ID_SECUENCIA_BASE = 0x8000; // Bit que marca un ID de secuencia registrada (no choca con Config::States)
+            constexpr int NUM_CUBETAS_JITTER = 8;   // Cubetas del histograma de retraso de toques
+            constexpr uint32_t LIMITES_JITTER_US[NUM_CUBETAS_JITTER - 1] = { 250, 500, 1000, 2000, 5000, 10000, 50000 };  // Límite superior de cada cubeta (la última es abierta)
+        }
+        // ==================== ÁRBITRO DE TOQUES ====================
+        namespace Arbitro {
+            constexpr int TAM_ENTRADA  = 8;                     // Peticiones en tránsito entre tareas hasta el siguiente loop() (potencia de 2)
+            constexpr int TAM_COLA     = 8;                     // Peticiones esperando a que el campanario quede libre
+            constexpr int TAM_REGISTRO = 32;                    // Decisiones guardadas en el registro circular
+            constexpr uint32_t PLAZO_RELOJ_MS      = 5UL * 60 * 1000;   // Una hora tocada más tarde ya no da la hora
+            constexpr uint32_t PLAZO_ALARMA_MS     = 20UL * 60 * 1000;  // Un aviso de misa aún sirve si el toque anterior se alarga
+            constexpr uint32_t PLAZO_MANUAL_MS     = 2UL * 60 * 1000;   // Quien pulsa espera poco a que suene
+            constexpr uint32_t PLAZO_EMERGENCIA_MS = 10UL * 60 * 1000;  // El rebato se toca aunque haya que esperar a otro rebato
+        }
+        namespace ColaComandos {
+            constexpr uint16_t TAM_COLA = 16;                   // Órdenes en tránsito de WebSocket e I2C hasta el siguiente loop() (potencia de 2)
+        }
+        namespace WebSocket {
+            constexpr uint16_t TAM_TABLA_COMANDOS = 128;        // Tabla hash de comandos (potencia de 2, al menos el doble de comandos)
+            constexpr uint8_t  MAX_CLIENTES = 8;                // Clientes con contadores de tráfico (DEFAULT_MAX_WS_CLIENTS)
+            constexpr uint8_t  PROTOCOLO_BINARIO = 1;           // Versión más alta de las tramas binarias de estado (0 = solo texto)
+        }
+        // ==================== RECURSOS WEB ====================
+        namespace Web {
+            constexpr uint8_t  MAX_ESTATICOS = 24;              // Entradas de /estaticos.json (html, js y css de data/)
+            constexpr uint8_t  TAM_RUTA = 32;                   // Nombre máximo en SPIFFS, con la barra y el terminador
+            constexpr uint8_t  TAM_ETAG = 17;                   // 16 hexadecimales del hash del .gz y terminador
+            constexpr const char* MANIFIESTO = "/estaticos.json";                       // Lo genera build-release.py
+            constexpr const char* CACHE_INMUTABLE = "public, max-age=31536000, immutable";  // Nombres con hash de contenido
+            constexpr const char* CACHE_REVALIDAR = "no-cache";                         // Páginas HTML: se revalidan con el ETag
+        }
+        // ==================== CALENDARIO LITÚRGICO ====================
+        namespace Calendario {
+            constexpr int PATRON_MES = 8;                       // Mes de la fiesta patronal (1-12), ajustar a cada parroquia
+            constexpr int PATRON_DIA = 16;                      // Día de la fiesta patronal (San Roque por defecto)
         }
         // ==================== ALARMAS ====================
         namespace Alarmas {
-            constexpr int MAX_ALARMAS = 5;  // Número máximo de alarmas
+            constexpr uint16_t MAX_ALARMAS      = 512;             // Alarmas a la vez, sistema + personalizables (~90 bytes de RAM estática cada una)
+            constexpr uint32_t UMBRAL_HUECO_S    = 120;             // Sin check() durante más tiempo = hueco (NTP perdido, bucle bloqueado)
+            constexpr uint32_t HUECO_MAXIMO_S    = 24UL * 3600;     // Solo se recuperan alarmas de las últimas 24 h
+            constexpr uint32_t PERIODO_ESTADO_S  = 600;             // Cada cuánto se guarda la última revisión en flash (desgaste)
+            constexpr uint8_t  MARGEN_RECUPERACION_MIN = 15;        // Retraso máximo por defecto de una alarma recuperada
+            constexpr uint8_t  MAX_PASOS_RECUPERACION  = 64;        // Disparos recorridos como mucho por alarma al buscar el último perdido
+            constexpr uint32_t RETARDO_GUARDADO_MS     = 3000;      // Cambios web agrupados: se guardan tras 3 s sin más cambios
+            constexpr uint32_t RETARDO_MAXIMO_MS       = 30000;     // ... o como mucho 30 s después del primero
+            constexpr uint32_t REGISTRO_MINIMO_BYTES   = 8192;      // El registro de cambios se compacta al superar esto y el tamaño de la instantánea
+            constexpr uint8_t  MAX_EXCEPCIONES         = 32;        // Excepciones por fecha (omitir, sustituir, desplazar) a la vez
+            constexpr int16_t  DESPLAZAMIENTO_MAXIMO_MIN = 720;     // Una excepción mueve el toque como mucho ±12 h
+            constexpr uint8_t  DIAS_AGENDA             = 7;         // Días de GET_AGENDA si no se indican
+            constexpr uint8_t  DIAS_AGENDA_MAX         = 31;        // ... y como mucho
+            constexpr uint16_t MAX_EVENTOS_AGENDA      = 600;       // Eventos por respuesta de GET_AGENDA (~30 B cada uno en JSON, ~18 KB)
+
+            // Cambio de hora (POSIX_TZ de RTC.h): qué hacer con una hora local que se repite o que no existe
+            enum HoraAmbigua : uint8_t {
+                AMBIGUA_PRIMERA = 0,                                // Solo la primera vez (horario de verano)
+                AMBIGUA_SEGUNDA,                                    // Solo la segunda vez (horario de invierno)
+                AMBIGUA_AMBAS                                       // Las dos veces
+            };
+            enum HoraInexistente : uint8_t {
+                INEXISTENTE_AL_CAMBIO = 0,                          // En el instante del salto (02:30 suena a las 03:00)
+                INEXISTENTE_OMITIR                                  // Ese día no suena
+            };
+            constexpr HoraAmbigua     HORA_AMBIGUA     = AMBIGUA_PRIMERA;        // Octubre: los toques de 02:xx suenan una vez
+            constexpr HoraInexistente HORA_INEXISTENTE = INEXISTENTE_AL_CAMBIO;  // Marzo: los toques de 02:xx no se pierden
         }
     }
 
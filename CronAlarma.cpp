@@ -0,0 +1,225 @@
+#include "CronAlarma.h"
+#include "HoraLocal.h"
+
+static constexpr int CRON_MAX_DIAS_BUSQUEDA = 4 * 366 + 31;               // Cubre un 29 de febrero y cualquier combinación de mes
+
+    /**
+     * @brief Número de días del mes de una fecha normalizada
+     */
+    static int _DiasDelMes(int nAno, int nMes) {
+        static const uint8_t aDias[12] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+        if (nMes == 1) {
+            int a = nAno + 1900;
+            bool lBisiesto = (a % 4 == 0 && a % 100 != 0) || (a % 400 == 0);
+            return lBisiesto ? 29 : 28;
+        }
+        return aDias[nMes];
+    }
+
+    /**
+     * @brief Lee un entero sin signo y avanza el puntero
+     *
+     * @return -1 si no hay dígitos
+     */
+    static int _LeeNumero(const char*& p) {
+        if (*p < '0' || *p > '9') return -1;
+        int n = 0;
+        while (*p >= '0' && *p <= '9') {
+            n = n * 10 + (*p - '0');
+            if (n > 1000) return -1;
+            ++p;
+        }
+        return n;
+    }
+
+    /**
+     * @brief Compila un campo de la expresión a una máscara de bits
+     *
+     * @param p Puntero al inicio del campo; queda tras el campo
+     * @param nMin Valor mínimo admitido
+     * @param nMax Valor máximo admitido
+     * @param nMascara Máscara resultante (bit v = valor v)
+     * @param lLibre true si el campo es exactamente "*"
+     * @param pSemanas Si no es nullptr, admite "#n"/"#L" y acumula las semanas
+     * @return true si el campo es válido
+     */
+    static bool _CompilaCampo(const char*& p, int nMin, int nMax, uint64_t& nMascara, bool& lLibre, uint8_t* pSemanas) {
+        nMascara = 0;
+        lLibre = (p[0] == '*' && (p[1] == ' ' || p[1] == '\0'));
+        for (;;) {
+            int nIni, nFin, nPaso = 1;
+            if (*p == '*') {
+                nIni = nMin;
+                nFin = nMax;
+                ++p;
+            } else {
+                nIni = _LeeNumero(p);
+                if (nIni < 0) return false;
+                nFin = nIni;
+                if (*p == '-') {
+                    ++p;
+                    nFin = _LeeNumero(p);
+                    if (nFin < 0) return false;
+                }
+            }
+            if (*p == '/') {
+                ++p;
+                nPaso = _LeeNumero(p);
+                if (nPaso <= 0) return false;
+                if (nIni == nFin) nFin = nMax;                              // "a/n" equivale a "a-max/n"
+            }
+            if (*p == '#') {
+                if (pSemanas == nullptr || nIni != nFin) return false;
+                ++p;
+                if (*p == 'L') {
+                    *pSemanas |= CRON_SEMANA_ULTIMA;
+                    ++p;
+                } else {
+                    int nSemana = _LeeNumero(p);
+                    if (nSemana < 1 || nSemana > 5) return false;
+                    *pSemanas |= (uint8_t)(1 << (nSemana - 1));
+                }
+            }
+            if (nIni < nMin || nFin > nMax || nIni > nFin) return false;
+            for (int v = nIni; v <= nFin; v += nPaso) {
+                nMascara |= (1ULL << v);
+            }
+            if (*p != ',') break;
+            ++p;
+        }
+        if (*p != ' ' && *p != '\0') return false;
+        while (*p == ' ') ++p;
+        return nMascara != 0;
+    }
+
+    /**
+     * @brief Compila una expresión cron de 5 campos
+     *
+     * @details **EJEMPLOS:**
+     *          - "0 12 * * 0#1": primer domingo de mes a las 12:00
+     *          - "0,30 9-21 * * 1-5": laborables de 9 a 21 cada media hora
+     *          - "0 0 1 1 *": 1 de enero a medianoche
+     *
+     * @param sTexto Expresión "minuto hora día-mes mes día-semana"
+     * @param cron Estructura que recibe la expresión compilada
+     * @return true si la expresión es válida; cron no se modifica si no lo es
+     *
+     * @since v1.0
+     * @author Julian Salas Bartolomé
+     */
+    bool CompilaCron(const char* sTexto, CronAlarma& cron) {
+        if (sTexto == nullptr || strlen(sTexto) >= (size_t)CRON_MAX_TEXTO) return false;
+        const char* p = sTexto;
+        while (*p == ' ') ++p;
+
+        CronAlarma nuevo;
+        uint64_t nMascara;
+        bool lLibre;
+        if (!_CompilaCampo(p, 0, 59, nMascara, lLibre, nullptr)) return false;
+        nuevo.minutos = nMascara;
+        if (!_CompilaCampo(p, 0, 23, nMascara, lLibre, nullptr)) return false;
+        nuevo.horas = (uint32_t)nMascara;
+        if (!_CompilaCampo(p, 1, 31, nMascara, lLibre, nullptr)) return false;
+        nuevo.diasMes = (uint32_t)nMascara;
+        if (lLibre) nuevo.flags |= CRON_DIA_MES_LIBRE;
+        if (!_CompilaCampo(p, 1, 12, nMascara, lLibre, nullptr)) return false;
+        nuevo.meses = (uint16_t)nMascara;
+        if (!_CompilaCampo(p, 0, 7, nMascara, lLibre, &nuevo.semanasMes)) return false;
+        if (nMascara & (1ULL << 7)) nMascara |= 1;                          // 7 = domingo
+        nuevo.diasSemana = (uint8_t)(nMascara & 0x7F);
+        if (lLibre) nuevo.flags |= CRON_DIA_SEMANA_LIBRE;
+        if (*p != '\0') return false;                                       // Sobran campos
+
+        cron = nuevo;
+        return true;
+    }
+
+    /**
+     * @brief Comprueba si un día cumple mes, día del mes y día de la semana
+     *
+     * @param cron Expresión compilada
+     * @param dia Fecha normalizada (tm_mon, tm_mday, tm_wday, tm_year válidos)
+     * @return true si en ese día hay algún minuto candidato
+     *
+     * @since v1.0
+     * @author Julian Salas Bartolomé
+     */
+    bool CoincideDiaCron(const CronAlarma& cron, const struct tm& dia) {
+        if (!(cron.meses & (1 << (dia.tm_mon + 1)))) return false;
+
+        bool lDiaMes = (cron.diasMes & (1UL << dia.tm_mday)) != 0;
+        bool lDiaSemana = (cron.diasSemana & (1 << dia.tm_wday)) != 0;
+        if (lDiaSemana && cron.semanasMes != 0) {
+            bool lSemana = (cron.semanasMes & (1 << ((dia.tm_mday - 1) / 7))) != 0;
+            bool lUltima = (cron.semanasMes & CRON_SEMANA_ULTIMA) &&
+                           (dia.tm_mday + 7 > _DiasDelMes(dia.tm_year, dia.tm_mon));
+            lDiaSemana = lSemana || lUltima;
+        }
+
+        bool lMesLibre = cron.flags & CRON_DIA_MES_LIBRE;
+        bool lSemanaLibre = cron.flags & CRON_DIA_SEMANA_LIBRE;
+        if (lMesLibre && lSemanaLibre) return true;
+        if (lMesLibre) return lDiaSemana;
+        if (lSemanaLibre) return lDiaMes;
+        return lDiaMes || lDiaSemana;
+    }
+
+    /**
+     * @brief Calcula el primer minuto que cumple la expresión
+     *
+     * @details **BÚSQUEDA:**
+     *          1. Si el mes no está permitido salta al día 1 del mes siguiente
+     *          2. Si el día no coincide pasa al día siguiente a las 00:00
+     *          3. En un día válido toma la primera hora y el primer minuto
+     *             permitidos con máscaras de bits y los convierte con EpochLocal()
+     *
+     * @param cron Expresión compilada
+     * @param tDesde Epoch alineado a minuto desde el que buscar (incluido)
+     * @return Epoch del primer minuto válido, o 0 si no hay en ~4 años (p.ej. 30 de febrero)
+     *
+     * @note **CAMBIO DE HORA:** Horas repetidas o inexistentes según EpochLocal() (HoraLocal.h)
+     *
+     * @since v1.0
+     * @author Julian Salas Bartolomé
+     */
+    time_t SiguienteCron(const CronAlarma& cron, time_t tDesde) {
+        struct tm dia;
+        localtime_r(&tDesde, &dia);
+        dia.tm_sec = 0;
+
+        for (int nDias = 0; nDias < CRON_MAX_DIAS_BUSQUEDA; ) {
+            dia.tm_isdst = -1;
+            if (mktime(&dia) == (time_t)-1) return 0;                       // Normaliza y calcula tm_wday
+
+            if (!(cron.meses & (1 << (dia.tm_mon + 1)))) {                  // Mes no permitido: al día 1 del siguiente
+                int nSalto = _DiasDelMes(dia.tm_year, dia.tm_mon) - dia.tm_mday + 1;
+                dia.tm_mday += nSalto;
+                dia.tm_hour = 0;
+                dia.tm_min = 0;
+                nDias += nSalto;
+                continue;
+            }
+
+            if (CoincideDiaCron(cron, dia)) {
+                uint32_t nHoras = cron.horas & (0xFFFFFFFFUL << dia.tm_hour);
+                while (nHoras) {
+                    int h = __builtin_ctz(nHoras);
+                    nHoras &= nHoras - 1;
+                    int nMinDesde = (h == dia.tm_hour) ? dia.tm_min : 0;
+                    uint64_t nMinutos = cron.minutos & (~0ULL << nMinDesde);
+                    if (!nMinutos) continue;
+                    struct tm candidato = dia;
+                    candidato.tm_hour = h;
+                    candidato.tm_min = __builtin_ctzll(nMinutos);
+                    time_t tCandidato = EpochLocal(candidato, tDesde);     // Aplica las reglas del cambio de hora
+                    if (tCandidato != (time_t)-1) return tCandidato;
+                }
+            }
+
+            dia.tm_mday += 1;                                               // Día siguiente a las 00:00
+            dia.tm_hour = 0;
+            dia.tm_min = 0;
+            nDias++;
+        }
+        return 0;
+    }
@@ -0,0 +1,59 @@
+/**
+ * @file CronAlarma.h
+ * @brief Expresiones de recurrencia tipo cron compiladas a bitsets
+ *
+ * @details Permite que una sola alarma exprese recurrencias que con día de
+ *          la semana + hora/minuto necesitarían varias ranuras, por ejemplo:
+ *          - "0,30 * * * 1-5": laborables a en punto y a y media
+ *          - "*\/15 9-21 * * *": cada 15 minutos entre las 9 y las 21
+ *          - "0 12 * * 0#1": el primer domingo de cada mes a las 12:00
+ *
+ *          **FORMATO (5 campos separados por espacios):**
+ *          - minuto (0-59) hora (0-23) día-mes (1-31) mes (1-12) día-semana (0-7, 0 y 7 = domingo)
+ *          - Cada campo admite "*", "a", "a-b", listas con "," y paso con "/n"
+ *          - Día de la semana admite "d#n" (n-ésimo del mes, 1-5) y "d#L" (último)
+ *          - Si día-mes y día-semana están restringidos basta con que coincida uno (como cron)
+ *
+ *          **REPRESENTACIÓN COMPILADA:**
+ *          - Un bit por valor permitido en cada campo (18 bytes en total)
+ *          - SiguienteCron() salta meses enteros y busca hora y minuto con
+ *            operaciones de bits, sin recorrer minuto a minuto
+ *
+ * @note **SEMANAS:** Los "#n" se aplican a todos los días de la semana del campo
+ * @note **HORA LOCAL:** Respeta zona y horario de verano; el cambio de hora lo resuelve EpochLocal()
+ *
+ * @author Julian Salas Bartolomé
+ * @date 2025-10-17
+ * @version 1.0
+ *
+ * @see Alarmas.h - Alarm::cron y AlarmScheduler::_calculaProximo()
+ */
+#ifndef CRONALARMA_H
+	#define CRONALARMA_H
+
+        #include <Arduino.h>
+        #include <time.h>
+
+        constexpr uint8_t CRON_DIA_MES_LIBRE    = 0x01;                     //!< El campo día-mes es "*"
+        constexpr uint8_t CRON_DIA_SEMANA_LIBRE = 0x02;                     //!< El campo día-semana es "*"
+        constexpr uint8_t CRON_SEMANA_ULTIMA    = 0x20;                     //!< Bit de semanasMes para "#L"
+        constexpr int     CRON_MAX_TEXTO        = 32;                       //!< Longitud máxima de la expresión (con terminador)
+
+        /**
+         * @brief Expresión cron compilada
+         */
+        struct CronAlarma {
+            uint64_t minutos    = 0;                                        //!< Bit m = minuto m (0-59)
+            uint32_t horas      = 0;                                        //!< Bit h = hora h (0-23)
+            uint32_t diasMes    = 0;                                        //!< Bit d = día d del mes (1-31)
+            uint16_t meses      = 0;                                        //!< Bit m = mes m (1-12)
+            uint8_t  diasSemana = 0;                                        //!< Bit d = día d (0 = domingo), igual que DOW_*
+            uint8_t  semanasMes = 0;                                        //!< Bits 0-4: semana 1-5 del mes, CRON_SEMANA_ULTIMA; 0 = todas
+            uint8_t  flags      = 0;                                        //!< CRON_DIA_MES_LIBRE | CRON_DIA_SEMANA_LIBRE
+        };
+
+        bool   CompilaCron (const char* sTexto, CronAlarma& cron);          //!< Compila una expresión de 5 campos
+        bool   CoincideDiaCron (const CronAlarma& cron, const struct tm& dia);  //!< El día (mes, día-mes, día-semana) cumple la expresión
+        time_t SiguienteCron (const CronAlarma& cron, time_t tDesde);       //!< Primer minuto >= tDesde que cumple la expresión (0 si ninguno)
+
+#endif
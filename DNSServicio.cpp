@@ -80,7 +80,7 @@
         #endif
         http1.begin(serverUrl1);                                    // Iniciar conexión al servidor DNS 1
         http1.setAuthorization(cDominio, userPassword);             // Configurar autenticación 
-        int httRespuesta1 = http1.GET();                            // Enviar petición GET
+        [[maybe_unused]] int httRespuesta1 = http1.GET();                            // Enviar petición GET
         #ifdef DEBUGDNS
           if (httRespuesta1 > 0) {                                  // Verificar éxito de la respuesta
             DBG_DNS_PRINT("[DNS1] HTTP Codigo: ");
@@ -101,7 +101,7 @@
         #endif
         http2.begin(serverUrl2);                                    // Iniciar conexión al servidor DNS 2
         http2.setAuthorization(cDominio, userPassword);             // Configurar autenticación  
-        int httRespuesta2 = http2.GET();
+        [[maybe_unused]] int httRespuesta2 = http2.GET();
         #ifdef DEBUGDNS
           if (httRespuesta2 > 0) {
             DBG_DNS_PRINT("[DNS2] HTTP Codigo: ");
@@ -122,7 +122,7 @@
         #endif
         http3.begin(serverUrl3);                                    // Iniciar conexión al servidor DNS 3
         http3.setAuthorization(cDominio, userPassword);             // Configurar autenticación  
-        int httRespuesta3 = http3.GET();
+        [[maybe_unused]] int httRespuesta3 = http3.GET();
         #ifdef DEBUGDNS
           if (httRespuesta3 > 0) {
             DBG_DNS_PRINT("[DNS3] HTTP Codigo: ");
@@ -143,7 +143,7 @@
         #endif
         http4.begin(serverUrl4);                                    // Iniciar conexión al servidor DNS 4
         http4.setAuthorization(cDominio, userPassword);             // Configurar autenticación  
-        int httRespuesta4 = http4.GET();
+        [[maybe_unused]] int httRespuesta4 = http4.GET();
         #ifdef DEBUGDNS
           if (httRespuesta4 > 0) {
             DBG_DNS_PRINT("[DNS4] HTTP Codigo: ");
@@ -30,6 +30,8 @@
 //#define DEBUGAP                   // Debug del modo AP
 //#define DEBUGCALEFACCION          // Debug del sistema de calefacción
 //#define DEBUGCAMPANA              // Debug del sistema de campanas
+//#define DEBUGARBITRO              // Debug de las decisiones del árbitro de toques
+//#define DEBUGCOLA                 // Debug de la cola de órdenes hacia loop()
 //#define DEBUGTELEGRAM             // Debug del servicio Telegram
 //#define DBG_ALARMS_ENABLED        // Habilita macros de debug para alarmas personalizadas
 #define DEBUGOTA                  // Debug del servicio OTA
@@ -209,6 +211,24 @@
     #define DBG_CAMPANA_PRINTF(fmt, ...)
 #endif
 
+//Macros para debug del árbitro de toques
+#ifdef DEBUGARBITRO
+    #define DBG_ARB(msg) Serial.println(String("[ARBITRO] ") + msg)
+    #define DBG_ARB_PRINTF(fmt, ...) Serial.printf("[ARBITRO] " fmt "\n", ##__VA_ARGS__)
+#else
+    #define DBG_ARB(msg)
+    #define DBG_ARB_PRINTF(fmt, ...)
+#endif
+
+//Macros para debug de la cola de órdenes
+#ifdef DEBUGCOLA
+    #define DBG_COLA(msg) Serial.println(String("[COLA] ") + msg)
+    #define DBG_COLA_PRINTF(fmt, ...) Serial.printf("[COLA] " fmt "\n", ##__VA_ARGS__)
+#else
+    #define DBG_COLA(msg)
+    #define DBG_COLA_PRINTF(fmt, ...)
+#endif
+
 #ifdef DEBUGTELEGRAM
     #define DBG_TELEGRAM(msg) Serial.println(String("[TELEGRAM] ") + msg)
     #define DBG_TELEGRAM_PRINT(msg) Serial.print(String("[TELEGRAM] ") + msg)
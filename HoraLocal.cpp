@@ -0,0 +1,119 @@
+#include "HoraLocal.h"
+
+    /**
+     * @brief Días desde el 1 de enero de 1970 de una fecha civil
+     *
+     * @details Aritmética entera sin tablas ni zona horaria (algoritmo de días
+     *          civiles de H. Hinnant), válida para cualquier año gregoriano.
+     */
+    static int64_t _DiasCivil(int64_t nAno, int nMes, int nDia) {
+        nAno -= (nMes <= 2);
+        int64_t nEra = (nAno >= 0 ? nAno : nAno - 399) / 400;
+        int64_t nAnoEra = nAno - nEra * 400;                                // 0-399
+        int64_t nDiaAno = (153 * (nMes + (nMes > 2 ? -3 : 9)) + 2) / 5 + nDia - 1;
+        int64_t nDiaEra = nAnoEra * 365 + nAnoEra / 4 - nAnoEra / 100 + nDiaAno;
+        return nEra * 146097 + nDiaEra - 719468;
+    }
+
+    /**
+     * @brief Minutos de reloj de pared desde 1970 de una hora local sin normalizar
+     *
+     * @details Admite tm_mday, tm_hour o tm_min fuera de rango (p.ej. tm_mday + n)
+     *          sin pasar por mktime(), que movería una hora inexistente.
+     */
+    static int64_t _MinutosPared(const struct tm& local) {
+        int64_t nAno = local.tm_year + 1900 + local.tm_mon / 12;
+        int nMes = local.tm_mon % 12;
+        if (nMes < 0) {
+            nMes += 12;
+            nAno--;
+        }
+        int64_t nDias = _DiasCivil(nAno, nMes + 1, 1) + local.tm_mday - 1;
+        return nDias * 1440 + (int64_t)local.tm_hour * 60 + local.tm_min;
+    }
+
+    /**
+     * @brief Desfase de la zona (segundos, hora local - UTC) en un instante
+     */
+    static int64_t _Desfase(time_t tEpoch) {
+        struct tm local;
+        localtime_r(&tEpoch, &local);
+        return _MinutosPared(local) * 60 + local.tm_sec - (int64_t)tEpoch;
+    }
+
+    /**
+     * @brief Convierte una hora local en el epoch en que suena
+     *
+     * @details **PROCESO:**
+     *          1. Toma la hora pedida como si fuera UTC (reloj de pared)
+     *          2. Lee el desfase de la zona un día antes y un día después: son
+     *             los únicos posibles, no hay dos cambios de hora tan juntos
+     *          3. Cada desfase da un epoch candidato que vale si localtime_r()
+     *             devuelve la misma hora de pared
+     *          4. Dos válidos: hora ambigua (octubre) -> HORA_AMBIGUA
+     *          5. Ninguno: hora inexistente (marzo) -> HORA_INEXISTENTE, con el
+     *             instante del salto buscado por bisección entre ambos candidatos
+     *
+     * @param local Hora local; se usan año, mes, día, hora y minuto (pueden estar sin normalizar)
+     * @param tDesde Epoch mínimo aceptado
+     * @return Epoch alineado a minuto >= tDesde, o -1 si esa hora local no suena a partir de tDesde
+     *
+     * @note **EJEMPLO:** Con AMBIGUA_PRIMERA y tDesde en la segunda pasada de las
+     *       02:30 de octubre devuelve -1: la hora ya sonó en horario de verano
+     *
+     * @since v2.2
+     * @author Julian Salas Bartolomé
+     */
+    time_t EpochLocal(const struct tm& local, time_t tDesde) {
+        int64_t tPared = _MinutosPared(local) * 60;
+        int64_t nAntes = _Desfase((time_t)(tPared - 86400));
+        int64_t nDespues = _Desfase((time_t)(tPared + 86400));
+
+        int64_t tPrimero = -1;
+        int64_t tSegundo = -1;
+        int64_t aDesfases[2] = { nAntes, nDespues };
+        for (uint8_t i = 0; i < (nAntes == nDespues ? 1 : 2); ++i) {
+            int64_t tCandidato = tPared - aDesfases[i];
+            if (_Desfase((time_t)tCandidato) != aDesfases[i]) continue;
+            if (tPrimero < 0) {
+                tPrimero = tCandidato;
+            } else if (tCandidato < tPrimero) {
+                tSegundo = tPrimero;
+                tPrimero = tCandidato;
+            } else {
+                tSegundo = tCandidato;
+            }
+        }
+
+        if (tSegundo >= 0) {                                                // Hora repetida
+            switch (Config::Alarmas::HORA_AMBIGUA) {
+                case Config::Alarmas::AMBIGUA_PRIMERA:
+                    return (tPrimero >= tDesde) ? (time_t)tPrimero : (time_t)-1;
+                case Config::Alarmas::AMBIGUA_SEGUNDA:
+                    return (tSegundo >= tDesde) ? (time_t)tSegundo : (time_t)-1;
+                default:
+                    if (tPrimero >= tDesde) return (time_t)tPrimero;
+                    return (tSegundo >= tDesde) ? (time_t)tSegundo : (time_t)-1;
+            }
+        }
+        if (tPrimero >= 0) {
+            return (tPrimero >= tDesde) ? (time_t)tPrimero : (time_t)-1;
+        }
+
+        if (nAntes == nDespues || Config::Alarmas::HORA_INEXISTENTE == Config::Alarmas::INEXISTENTE_OMITIR) {
+            return (time_t)-1;
+        }
+        int64_t tAntes = tPared - nAntes;                                   // Hora inexistente: el salto está entre los dos candidatos
+        int64_t tDespues = tPared - nDespues;
+        int64_t tBajo = (tAntes < tDespues) ? tAntes : tDespues;            // Aún con el desfase anterior
+        int64_t tAlto = (tAntes < tDespues) ? tDespues : tAntes;            // Ya con el desfase nuevo
+        while (tAlto - tBajo > 60) {
+            int64_t tMedio = tBajo + ((tAlto - tBajo) / 120) * 60;
+            if (_Desfase((time_t)tMedio) == nAntes) {
+                tBajo = tMedio;
+            } else {
+                tAlto = tMedio;
+            }
+        }
+        return (tAlto >= tDesde) ? (time_t)tAlto : (time_t)-1;
+    }
@@ -0,0 +1,41 @@
+/**
+ * @file HoraLocal.h
+ * @brief Conversión de hora local a epoch UTC con reglas explícitas para el cambio de hora
+ *
+ * @details Las alarmas se programan en hora local (día, hora, minuto) pero el
+ *          índice de AlarmScheduler trabaja en epoch UTC. Con la zona POSIX_TZ
+ *          de RTC.h hay dos días al año en que esa conversión no es única:
+ *
+ *          **OCTUBRE (HORA AMBIGUA):**
+ *          - De 02:00 a 02:59 se repite: cada minuto local tiene dos epoch
+ *          - Config::Alarmas::HORA_AMBIGUA elige la primera, la segunda o ambas
+ *
+ *          **MARZO (HORA INEXISTENTE):**
+ *          - De 02:00 a 02:59 no existe: el reloj salta de 01:59 a 03:00
+ *          - Config::Alarmas::HORA_INEXISTENTE dispara en el instante del salto u omite
+ *
+ *          La conversión no usa mktime() con tm_isdst = -1, cuyo resultado en
+ *          esos casos depende de la libc: prueba los dos desfases de la zona
+ *          alrededor de la fecha y comprueba con localtime_r() cuáles dan la
+ *          hora pedida.
+ *
+ * @note **USO:** _buscaMinuto(), SiguienteCron() y CALENDARIO::Siguiente() pasan por aquí
+ * @note **COSTE:** Cuatro localtime_r() por candidato; unas pocas más solo en el salto de marzo
+ *
+ * @author Julian Salas Bartolomé
+ * @date 2025-10-17
+ * @version 1.0
+ *
+ * @see Configuracion.h - Config::Alarmas::HORA_AMBIGUA y HORA_INEXISTENTE
+ * @see RTC.h - POSIX_TZ con las reglas del horario de verano
+ */
+#ifndef HORALOCAL_H
+	#define HORALOCAL_H
+
+        #include <Arduino.h>
+        #include <time.h>
+        #include "Configuracion.h"
+
+        time_t EpochLocal (const struct tm& local, time_t tDesde);          //!< Epoch >= tDesde de una hora local (año, mes, día, hora, minuto), o -1
+
+#endif
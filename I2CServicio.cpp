@@ -6,11 +6,10 @@
 #include "Auxiliar.h"        // Para acceder a Campanario y variables globales
 #include "RTC.h"             // Para getLocalTime() y RTC::isNtpSync()
 #include "Debug.h"
+#include "ColaComandos.h"    // Las órdenes se ejecutan en loop()
 
 // Variables I2C (definiciones únicas)
-volatile uint8_t secuenciaI2C = 0;
 uint8_t requestI2C = 0;
-uint8_t ParametroI2C = 0;
 
     /**
      * @brief Inicializa la comunicación I2C como dispositivo esclavo
@@ -59,8 +58,8 @@ uint8_t ParametroI2C = 0;
  *          1. Lee primer byte como comando/secuencia principal
  *          2. Si numBytes == 2, lee segundo byte como parámetro
  *          3. Analiza si es solicitud de información (vs comando directo)
- *          4. Para solicitudes: guarda en requestI2C y resetea secuenciaI2C
- *          5. Para comandos: mantiene en secuenciaI2C para procesamiento en loop
+ *          4. Para solicitudes: guarda en requestI2C
+ *          5. Para comandos: los presenta en ColaComandos (CMD_I2C) para loop()
  * 
  * @param numBytes Número de bytes enviados por el maestro (1 o 2 típicamente)
  * 
@@ -74,9 +73,8 @@ uint8_t ParametroI2C = 0;
  * @warning **WIRE.READ():** Solo leer bytes mientras Wire.available() sea true
  * 
  * @see Wire.onReceive() - Función que registra este callback
- * @see secuenciaI2C - Variable modificada para comandos directos
+ * @see COLA_COMANDOS::Encola() - Cola sin cerrojos hacia loop() para comandos directos
  * @see requestI2C - Variable modificada para solicitudes de información
- * @see ParametroI2C - Variable modificada cuando numBytes == 2
  * @see Config::States - Constantes utilizadas para identificar tipos
  * 
  * @since v1.0 - Recepción básica de comandos
@@ -86,7 +84,8 @@ uint8_t ParametroI2C = 0;
  */
 void recibirSecuencia(int numBytes) {
     if (Wire.available()) { 
-        secuenciaI2C = Wire.read();
+        uint8_t secuenciaI2C = Wire.read();
+        uint8_t ParametroI2C = 0;
         if (numBytes == 2) {
             ParametroI2C = Wire.read(); // Lee el segundo byte como parámetro
         }
@@ -95,9 +94,9 @@ void recibirSecuencia(int numBytes) {
         if (secuenciaI2C == Config::States::CAMPANARIO || secuenciaI2C == Config::States::HORA || 
         secuenciaI2C == Config::States::FECHA_HORA || secuenciaI2C == Config::States::FECHA_HORA_O_TEMPORIZACION) {
             requestI2C = secuenciaI2C;
-            secuenciaI2C = 0;                       // Resetea para evitar ejecución como comando
             DBG_I2C_REQ("I2CServicio -> Solicitud request: " + String(requestI2C));
-        }else{
+        }else if (secuenciaI2C > 0){
+            ColaComandos.Encola(CMD_I2C, ORIGEN_I2C, secuenciaI2C, ParametroI2C);    // Orden y parámetro viajan juntos hasta loop()
             DBG_I2C_SEQ("I2CServicio -> Secuencia recibida por I2C: " + String(secuenciaI2C));
             if (numBytes == 2) {
                 DBG_I2C_SEQ("I2CServicio -> Parametro recibido por I2C: " + String(ParametroI2C));
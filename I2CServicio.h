@@ -77,9 +77,7 @@
 
 
     // Variables I2C globales (extern para usar desde otros módulos)
-    extern volatile uint8_t secuenciaI2C;               // Secuencia de comando recibida por I2C (volatile por interrupciones)      
-    extern uint8_t requestI2C;                          // Solicitud de información 
-    extern uint8_t ParametroI2C;                        // Parámetro adicional para ciertos comandos (opcional)
+    extern uint8_t requestI2C;                          // Solicitud de información (las órdenes van a ColaComandos)
 
     // Funciones de inicialización I2C
     void initI2C();
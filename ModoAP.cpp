@@ -297,13 +297,13 @@ const char* htmlForm = R"rawliteral(
               request->send(400, "text/html", "<h2>IP inválida (cada octeto 0-255).</h2>");
               return;
             }
-            // Copiamos strings (se truncarán automáticamente si exceden tamaño del buffer destino).
-            strncpy(configWiFi.ssid, request->getParam("ssid", true)->value().c_str(), sizeof(configWiFi.ssid));
-            strncpy(configWiFi.password, request->getParam("password", true)->value().c_str(), sizeof(configWiFi.password));
+            // Copiamos strings (se truncan al tamaño del buffer destino y quedan siempre terminadas).
+            snprintf(configWiFi.ssid, sizeof(configWiFi.ssid), "%s", request->getParam("ssid", true)->value().c_str());
+            snprintf(configWiFi.password, sizeof(configWiFi.password), "%s", request->getParam("password", true)->value().c_str());
             snprintf(configWiFi.ip, sizeof(configWiFi.ip), "%d.%d.%d.%d", ip1, ip2, ip3, ip4);
-            strncpy(configWiFi.dominio, request->getParam("dominio", true)->value().c_str(), sizeof(configWiFi.dominio));
-            strncpy(configWiFi.usuario, request->getParam("usuario", true)->value().c_str(), sizeof(configWiFi.usuario));
-            strncpy(configWiFi.clave, request->getParam("clave", true)->value().c_str(), sizeof(configWiFi.clave));
+            snprintf(configWiFi.dominio, sizeof(configWiFi.dominio), "%s", request->getParam("dominio", true)->value().c_str());
+            snprintf(configWiFi.usuario, sizeof(configWiFi.usuario), "%s", request->getParam("usuario", true)->value().c_str());
+            snprintf(configWiFi.clave, sizeof(configWiFi.clave), "%s", request->getParam("clave", true)->value().c_str());
             guardarConfigWiFi();
             request->send(200, "text/html", "<h2>Configuración guardada. Reinicie el dispositivo.</h2>");
           } else {
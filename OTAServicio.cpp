@@ -281,7 +281,7 @@ bool OTAServicio::updateFirmware(const String& url, size_t expectedSize) {
     }
     
     size_t contentLength = http.getSize();
-    DBG_OTA_PRINTF("Tamano firmware: %d bytes", contentLength);
+    DBG_OTA_PRINTF("Tamano firmware: %u bytes", (unsigned)contentLength);
     
     if (contentLength <= 0 || contentLength > Config::OTA::MAX_FIRMWARE_SIZE) {
         setError("Tamano de firmware invalido");
@@ -305,7 +305,7 @@ bool OTAServicio::updateFirmware(const String& url, size_t expectedSize) {
         size_t available = stream->available();
         if (available) {
             int bytesRead = stream->readBytes(buffer, min(available, sizeof(buffer)));
-            if (Update.write(buffer, bytesRead) != bytesRead) {
+            if (Update.write(buffer, bytesRead) != (size_t)bytesRead) {
                 setError("Error escribiendo firmware");
                 Update.abort();
                 http.end();
@@ -362,7 +362,7 @@ bool OTAServicio::updateSPIFFS(const String& url, size_t expectedSize) {
     }
     
     size_t contentLength = http.getSize();
-    DBG_OTA_PRINTF("Tamano SPIFFS: %d bytes", contentLength);
+    DBG_OTA_PRINTF("Tamano SPIFFS: %u bytes", (unsigned)contentLength);
     
     if (contentLength <= 0 || contentLength > Config::OTA::MAX_SPIFFS_SIZE) {
         setError("Tamano de SPIFFS invalido");
@@ -384,7 +384,7 @@ bool OTAServicio::updateSPIFFS(const String& url, size_t expectedSize) {
         size_t available = stream->available();
         if (available) {
             int bytesRead = stream->readBytes(buffer, min(available, sizeof(buffer)));
-            if (Update.write(buffer, bytesRead) != bytesRead) {
+            if (Update.write(buffer, bytesRead) != (size_t)bytesRead) {
                 setError("Error escribiendo SPIFFS");
                 Update.abort();
                 http.end();
@@ -0,0 +1,79 @@
+/**
+ * @file Reloj.h
+ * @brief Punto único de lectura de la hora para la lógica de toques
+ *
+ * @details Alarmas, toques de reloj, protección de campanadas y calefacción
+ *          leen la hora a través de estas funciones en lugar de llamar
+ *          directamente a getLocalTime() y time(). Así la lógica del
+ *          campanario solo depende de tres funciones que se pueden sustituir.
+ *
+ *          **MODOS:**
+ *          - Normal: hora del sistema ESP32 sincronizada por NTP (RTC)
+ *          - RELOJ_VIRTUAL: hora fijada y avanzada a mano con Fija() y Avanza(),
+ *            para simular días de toques sin esperar al reloj real
+ *          - RELOJ_HOST: solo declaraciones; las implementa el reloj virtual
+ *            de la compilación en el PC (host/stubs/RelojVirtual.h)
+ *
+ *          **FUNCIONES:**
+ *          - HoraLocal(): hora local desglosada (equivale a getLocalTime)
+ *          - Epoch(): segundos UTC desde 1970 (equivale a time(nullptr))
+ *          - Sincronizado(): hay una hora válida con la que programar
+ *
+ * @note **CABECERA:** Funciones inline, sin unidad de traducción propia
+ * @note **ALCANCE:** RTC, Telegram y el DialCampanario siguen mostrando la hora real
+ *
+ * @warning **RELOJ_VIRTUAL:** Solo para simulación; las alarmas ignoran el NTP
+ *
+ * @author Julian Salas Bartolomé
+ * @date 2025-10-17
+ * @version 1.0
+ *
+ * @see RTC.h - Sincronización NTP del reloj real
+ * @see Alarmas.h - AlarmScheduler::check() programa con esta hora
+ */
+#ifndef RELOJ_H
+	#define RELOJ_H
+
+        #include <Arduino.h>
+        #include <time.h>
+        #include "RTC.h"
+
+        //#define RELOJ_VIRTUAL                     // Descomentar para simular el calendario con un reloj fijado a mano
+
+        namespace Reloj {
+
+        #if defined(RELOJ_HOST)
+
+            bool Sincronizado(void);
+            time_t Epoch(void);
+            bool HoraLocal(struct tm* pInfo);
+
+        #elif defined(RELOJ_VIRTUAL)
+
+            inline time_t& _EpochVirtual() {
+                static time_t tEpoch = 0;           // 0 = reloj virtual aún sin fijar
+                return tEpoch;
+            }
+
+            inline void Fija(time_t tEpoch)        { _EpochVirtual() = tEpoch; }       //!< Fija la hora virtual (epoch UTC)
+            inline void Avanza(uint32_t nSegundos) { _EpochVirtual() += nSegundos; }   //!< Adelanta la hora virtual
+            inline bool Sincronizado(void)         { return _EpochVirtual() != 0; }
+            inline time_t Epoch(void)              { return _EpochVirtual(); }
+            inline bool HoraLocal(struct tm* pInfo) {
+                if (!Sincronizado()) return false;
+                time_t tEpoch = _EpochVirtual();
+                localtime_r(&tEpoch, pInfo);        // Respeta la TZ configurada por configTime()
+                return true;
+            }
+
+        #else
+
+            inline bool Sincronizado(void)          { return RTC::isNtpSync(); }
+            inline time_t Epoch(void)               { return time(nullptr); }
+            inline bool HoraLocal(struct tm* pInfo) { return getLocalTime(pInfo); }
+
+        #endif
+
+        }
+
+#endif
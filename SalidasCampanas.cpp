@@ -0,0 +1,201 @@
+#include "SalidasCampanas.h"
+#include <Wire.h>
+#include <soc/gpio_reg.h>
+
+SALIDASCAMPANAS Salidas;
+
+    /**
+     * @brief Constructor de la capa de salida
+     *
+     * @details Deja la transacción vacía y todos los expansores en reposo. No
+     *          toca el hardware: el bus se inicia en Inicia() desde setup().
+     *
+     * @since v1.0
+     * @author Julian Salas Bartolomé
+     */
+    SALIDASCAMPANAS::SALIDASCAMPANAS() {
+        for (int i = 0; i < Config::Campanario::NUM_EXPANSORES; ++i) {
+            this->_aActivar[i] = 0;
+            this->_aLiberar[i] = 0;
+            this->_aLatch[i] = 0;
+        }
+    }
+
+    /**
+     * @brief Inicia el bus de expansores si alguna campana lo necesita
+     *
+     * @details Recorre Config::Campanario::BANCO_CAMPANAS y, si alguna campana
+     *          está en un expansor, inicia Wire1 como maestro y escribe el
+     *          estado de reposo en todos los expansores configurados.
+     *
+     * @return true si no hace falta bus o todos los expansores responden
+     *
+     * @note **ORDEN:** Llamar antes de crear las campanas del banco
+     *
+     * @since v1.0
+     * @author Julian Salas Bartolomé
+     */
+    bool SALIDASCAMPANAS::Inicia(void) {
+        bool lNecesitaBus = false;
+        for (const auto& def : Config::Campanario::BANCO_CAMPANAS) {
+            if (def.expansor != Config::Campanario::SIN_EXPANSOR) lNecesitaBus = true;
+        }
+        if (this->_hMutex == nullptr) {
+            this->_hMutex = xSemaphoreCreateMutex();
+        }
+        if (!lNecesitaBus || this->_lBusIniciado) {
+            return true;
+        }
+        Wire1.begin(Config::I2C::EXPANSOR_SDA_PIN, Config::I2C::EXPANSOR_SCL_PIN, Config::I2C::EXPANSOR_FRECUENCIA);
+        this->_lBusIniciado = true;
+        bool lOk = true;
+        for (uint8_t i = 0; i < Config::Campanario::NUM_EXPANSORES; ++i) {
+            xSemaphoreTake(this->_hMutex, portMAX_DELAY);
+            if (!this->_EscribeExpansor(i)) {
+                DBG_CAMPANA_PRINTF("[SALIDAS] ERROR: Expansor 0x%02X no responde", Config::Campanario::DIRECCIONES_EXPANSOR[i]);
+                lOk = false;
+            }
+            xSemaphoreGive(this->_hMutex);
+        }
+        return lOk;
+    }
+
+    /**
+     * @brief Configura una salida y la deja en reposo
+     *
+     * @param salida Dirección física del badajo
+     *
+     * @since v1.0
+     * @author Julian Salas Bartolomé
+     */
+    void SALIDASCAMPANAS::ConfiguraSalida(const SalidaCampana& salida) {
+        if (salida.pin >= 0) {
+            pinMode(salida.pin, OUTPUT);
+            digitalWrite(salida.pin, LOW);
+        } else {
+            this->Escribe(salida, false);
+        }
+    }
+
+    /**
+     * @brief Acumula un cambio de salida en la transacción en curso
+     *
+     * @details No escribe nada: solo marca el pin o el canal en las palabras
+     *          de la transacción. Un mismo tick puede preparar varias campanas
+     *          y escribirlas después con una sola llamada a Aplica().
+     *
+     * @param salida Dirección física del badajo
+     * @param lActiva true para activar el badajo, false para liberarlo
+     *
+     * @warning **TAREA ÚNICA:** La transacción solo se prepara desde loop()
+     *
+     * @since v1.0
+     * @author Julian Salas Bartolomé
+     */
+    void SALIDASCAMPANAS::Prepara(const SalidaCampana& salida, bool lActiva) {
+        if (salida.pin >= 0) {
+            if (salida.pin < 32) {
+                (lActiva ? this->_nSetBajo : this->_nClrBajo) |= (1UL << salida.pin);
+            } else {
+                (lActiva ? this->_nSetAlto : this->_nClrAlto) |= (1UL << (salida.pin - 32));
+            }
+        } else if (salida.expansor < Config::Campanario::NUM_EXPANSORES && salida.canal < 8) {
+            (lActiva ? this->_aActivar : this->_aLiberar)[salida.expansor] |= (uint8_t)(1 << salida.canal);
+        }
+    }
+
+    /**
+     * @brief Escribe de una vez todos los cambios acumulados
+     *
+     * @details **ESCRITURAS REALIZADAS:**
+     *          - GPIO_OUT_W1TS_REG / GPIO_OUT1_W1TS_REG con los pines a activar
+     *          - GPIO_OUT_W1TC_REG / GPIO_OUT1_W1TC_REG con los pines a liberar
+     *          - Una transacción I2C por cada expansor con algún canal cambiado
+     *
+     *          Después vacía la transacción para el siguiente tick.
+     *
+     * @note **SIMULTANEIDAD:** Los pines GPIO de un banco cambian en el mismo ciclo de bus
+     *
+     * @since v1.0
+     * @author Julian Salas Bartolomé
+     */
+    void SALIDASCAMPANAS::Aplica(void) {
+        if (this->_nSetBajo) REG_WRITE(GPIO_OUT_W1TS_REG, this->_nSetBajo);
+        if (this->_nSetAlto) REG_WRITE(GPIO_OUT1_W1TS_REG, this->_nSetAlto);
+        if (this->_nClrBajo) REG_WRITE(GPIO_OUT_W1TC_REG, this->_nClrBajo);
+        if (this->_nClrAlto) REG_WRITE(GPIO_OUT1_W1TC_REG, this->_nClrAlto);
+        this->_nSetBajo = this->_nSetAlto = this->_nClrBajo = this->_nClrAlto = 0;
+
+        for (uint8_t i = 0; i < Config::Campanario::NUM_EXPANSORES; ++i) {
+            if ((this->_aActivar[i] | this->_aLiberar[i]) == 0) continue;
+            if (this->_lBusIniciado && this->_hMutex != nullptr) {
+                xSemaphoreTake(this->_hMutex, portMAX_DELAY);
+                this->_aLatch[i] = (this->_aLatch[i] & ~this->_aLiberar[i]) | this->_aActivar[i];
+                this->_EscribeExpansor(i);
+                xSemaphoreGive(this->_hMutex);
+            }
+            this->_aActivar[i] = 0;
+            this->_aLiberar[i] = 0;
+        }
+    }
+
+    /**
+     * @brief Escribe una salida de inmediato, fuera de la transacción
+     *
+     * @details Camino de las liberaciones desde el esp_timer de cada campana
+     *          y de los toques sueltos. No altera la transacción en curso.
+     *
+     * @param salida Dirección física del badajo
+     * @param lActiva true para activar el badajo, false para liberarlo
+     *
+     * @since v1.0
+     * @author Julian Salas Bartolomé
+     */
+    void SALIDASCAMPANAS::Escribe(const SalidaCampana& salida, bool lActiva) {
+        if (salida.pin >= 0) {
+            if (salida.pin < 32) {
+                REG_WRITE(lActiva ? GPIO_OUT_W1TS_REG : GPIO_OUT_W1TC_REG, 1UL << salida.pin);
+            } else {
+                REG_WRITE(lActiva ? GPIO_OUT1_W1TS_REG : GPIO_OUT1_W1TC_REG, 1UL << (salida.pin - 32));
+            }
+            return;
+        }
+        if (salida.expansor >= Config::Campanario::NUM_EXPANSORES || salida.canal >= 8) return;
+        if (!this->_lBusIniciado || this->_hMutex == nullptr) return;
+        xSemaphoreTake(this->_hMutex, portMAX_DELAY);
+        if (lActiva) this->_aLatch[salida.expansor] |= (uint8_t)(1 << salida.canal);
+        else         this->_aLatch[salida.expansor] &= (uint8_t)~(1 << salida.canal);
+        this->_EscribeExpansor(salida.expansor);
+        xSemaphoreGive(this->_hMutex);
+    }
+
+    /**
+     * @brief Devuelve el número de transacciones I2C realizadas
+     *
+     * @since v1.0
+     * @author Julian Salas Bartolomé
+     */
+    uint32_t SALIDASCAMPANAS::GetTransaccionesI2C(void) {
+        return this->_nTransaccionesI2C;
+    }
+
+    /**
+     * @brief Envía el latch de un expansor en una transacción I2C
+     *
+     * @param nExpansor Índice en DIRECCIONES_EXPANSOR
+     * @return true si el expansor confirmó la escritura
+     *
+     * @note **POLARIDAD:** Con EXPANSOR_ACTIVO_BAJO el byte se invierte (relés activos a 0)
+     * @warning **MUTEX:** El llamador debe tener tomado _hMutex
+     *
+     * @since v1.0
+     * @author Julian Salas Bartolomé
+     */
+    bool SALIDASCAMPANAS::_EscribeExpansor(uint8_t nExpansor) {
+        uint8_t nByte = this->_aLatch[nExpansor];
+        if (Config::Campanario::EXPANSOR_ACTIVO_BAJO) nByte = (uint8_t)~nByte;
+        Wire1.beginTransmission(Config::Campanario::DIRECCIONES_EXPANSOR[nExpansor]);
+        Wire1.write(nByte);
+        this->_nTransaccionesI2C++;
+        return Wire1.endTransmission() == 0;
+    }
@@ -0,0 +1,79 @@
+/**
+ * @file SalidasCampanas.h
+ * @brief Capa de salida agrupada para los badajos del banco de campanas
+ *
+ * @details Este módulo centraliza la escritura física de los badajos, tanto
+ *          en pines GPIO propios del ESP32 como en canales de expansores I2C
+ *          PCF8574 que gobiernan placas de relés.
+ *
+ *          **FUNCIONALIDADES PRINCIPALES:**
+ *          - Transacciones: Prepara() acumula los cambios de un mismo tick y
+ *            Aplica() los escribe de una vez
+ *          - GPIO: una escritura W1TS/W1TC por banco de registros (0-31, 32-39)
+ *          - Expansores: una única transacción I2C por expansor modificado
+ *          - Escritura inmediata con Escribe() para liberaciones individuales
+ *
+ *          **BUS DE EXPANSORES:**
+ *          - Usa Wire1 como maestro; Wire queda como esclavo del DialCampanario
+ *          - Solo se inicia si alguna campana de BANCO_CAMPANAS usa expansor
+ *          - Mantiene una copia (latch) del último byte escrito en cada expansor
+ *
+ * @note **ATÓMICO GPIO:** W1TS/W1TC no necesitan bloqueo entre tareas
+ * @note **MUTEX I2C:** El latch y el bus se protegen con un mutex FreeRTOS
+ *
+ * @warning **CONTEXTO:** No llamar desde ISR; los esp_timer usan ESP_TIMER_TASK
+ *
+ * @author Julian Salas Bartolomé
+ * @date 2025-10-16
+ * @version 1.0
+ *
+ * @see Campana.h - Cada campana escribe su badajo a través de esta capa
+ * @see Campanario.h - Disparo agrupado de una máscara de campanas
+ * @see Configuracion.h - Config::Campanario::BANCO_CAMPANAS y Config::I2C
+ */
+#ifndef SALIDASCAMPANAS_H
+	#define SALIDASCAMPANAS_H
+
+        #include <Arduino.h>
+        #include <freertos/FreeRTOS.h>
+        #include <freertos/semphr.h>
+        #include "Debug.h"
+        #include "Configuracion.h"
+
+        /**
+         * @brief Dirección física del badajo de una campana
+         */
+        struct SalidaCampana {
+            int8_t pin;                                                     //!< Pin GPIO (-1 si la campana está en un expansor)
+            uint8_t expansor;                                               //!< Índice en DIRECCIONES_EXPANSOR o SIN_EXPANSOR
+            uint8_t canal;                                                  //!< Canal 0-7 dentro del expansor
+        };
+
+        class SALIDASCAMPANAS
+        {
+            public:
+
+                SALIDASCAMPANAS();                                          //!< Constructor: transacción vacía y expansores en reposo
+                bool Inicia (void);                                         //!< Inicia el bus de expansores si el banco lo necesita
+                void ConfiguraSalida (const SalidaCampana& salida);         //!< Configura la salida y la deja en reposo
+                void Prepara (const SalidaCampana& salida, bool lActiva);   //!< Acumula un cambio en la transacción en curso
+                void Aplica (void);                                         //!< Escribe todos los cambios acumulados de una vez
+                void Escribe (const SalidaCampana& salida, bool lActiva);   //!< Escribe una salida de inmediato (liberaciones)
+                uint32_t GetTransaccionesI2C (void);                        //!< Transacciones I2C realizadas desde el arranque
+            private:
+                bool _EscribeExpansor (uint8_t nExpansor);                  //!< Envía el latch de un expansor (con el mutex tomado)
+                uint32_t _nSetBajo = 0;                                     //!< Pines 0-31 a activar en la transacción
+                uint32_t _nSetAlto = 0;                                     //!< Pines 32-39 a activar en la transacción
+                uint32_t _nClrBajo = 0;                                     //!< Pines 0-31 a liberar en la transacción
+                uint32_t _nClrAlto = 0;                                     //!< Pines 32-39 a liberar en la transacción
+                uint8_t _aActivar[Config::Campanario::NUM_EXPANSORES];      //!< Canales a activar por expansor en la transacción
+                uint8_t _aLiberar[Config::Campanario::NUM_EXPANSORES];      //!< Canales a liberar por expansor en la transacción
+                uint8_t _aLatch[Config::Campanario::NUM_EXPANSORES];        //!< Canales activos en cada expansor (lógica positiva)
+                SemaphoreHandle_t _hMutex = nullptr;                        //!< Protege latch y bus entre loop y esp_timer
+                bool _lBusIniciado = false;                                 //!< Wire1 iniciado como maestro
+                volatile uint32_t _nTransaccionesI2C = 0;                   //!< Contador de transacciones I2C
+        };
+
+        extern SALIDASCAMPANAS Salidas;                                     //!< Capa de salida única del campanario
+
+#endif
@@ -8,6 +8,103 @@
 
 
 
+  // ============================================================================
+  // RECURSOS ESTÁTICOS (GZIP + ETAG)
+  // ============================================================================
+  // build-release.py sube a SPIFFS solo el .gz de cada html/js/css y escribe
+  // /estaticos.json con su ETag. Los js/css llevan un hash en el nombre y se
+  // sirven como immutable; las páginas HTML se revalidan con If-None-Match.
+  // La tabla se carga una vez en ServidorOn() y después solo se lee.
+
+    struct RecursoEstatico {
+        char ruta[Config::Web::TAM_RUTA];                                   // Ruta sin ".gz" (p.ej. "/idiomas.0b0a4371.js")
+        char etag[Config::Web::TAM_ETAG];                                   // Hash del .gz, sin comillas
+        bool lInmutable;                                                    // Nombre con hash de contenido
+    };
+
+    static RecursoEstatico aEstaticos[Config::Web::MAX_ESTATICOS];
+    static uint8_t nEstaticos = 0;
+
+    /**
+     * @brief Carga el manifiesto de recursos generado por build-release.py
+     *
+     * @details Sin manifiesto (data/ subido desde el IDE) la tabla queda vacía
+     *          y los archivos se sirven tal cual, sin caché.
+     */
+    static void cargaEstaticos(void) {
+        nEstaticos = 0;
+        File file = SPIFFS.open(Config::Web::MANIFIESTO, "r");
+        if (!file) {
+            DBG_SRV("📦 Sin manifiesto de recursos: se sirven sin comprimir ni caché");
+            return;
+        }
+        JsonDocument doc;
+        DeserializationError error = deserializeJson(doc, file);
+        file.close();
+        if (error) {
+            DBG_SRV_PRINTF("❌ Error al leer %s: %s", Config::Web::MANIFIESTO, error.c_str());
+            return;
+        }
+        for (JsonObject recurso : doc.as<JsonArray>()) {
+            if (nEstaticos >= Config::Web::MAX_ESTATICOS) break;
+            RecursoEstatico& estatico = aEstaticos[nEstaticos];
+            strlcpy(estatico.ruta, recurso["ruta"] | "", sizeof(estatico.ruta));
+            strlcpy(estatico.etag, recurso["etag"] | "", sizeof(estatico.etag));
+            estatico.lInmutable = recurso["inmutable"] | false;
+            if (estatico.ruta[0] != '\0' && estatico.etag[0] != '\0') nEstaticos++;
+        }
+        DBG_SRV_PRINTF("📦 %u recursos estáticos con ETag", nEstaticos);
+    }
+
+    static const RecursoEstatico* buscaEstatico(const String& ruta) {
+        for (uint8_t i = 0; i < nEstaticos; ++i) {
+            if (ruta.equals(aEstaticos[i].ruta)) return &aEstaticos[i];
+        }
+        return nullptr;
+    }
+
+    /**
+     * @brief Envía un archivo web de SPIFFS con gzip y ETag
+     *
+     * @details **RESPUESTA:**
+     *          - Recurso del manifiesto: "ruta.gz" con Content-Encoding: gzip
+     *            (lo añade AsyncFileResponse), ETag fuerte y Cache-Control
+     *            immutable (nombre con hash) o no-cache (páginas HTML)
+     *          - If-None-Match igual al ETag: 304 sin abrir el archivo
+     *          - Fuera del manifiesto: el archivo tal cual, o 404
+     *
+     * @param request Petición GET (ya autenticada si la ruta lo exige)
+     * @param ruta Ruta en SPIFFS sin ".gz"
+     *
+     * @since v2.2
+     * @author Julian Salas Bartolomé
+     */
+    static void enviaEstatico(AsyncWebServerRequest *request, const String& ruta) {
+        const RecursoEstatico* pEstatico = buscaEstatico(ruta);
+        if (pEstatico == nullptr) {
+            if (!SPIFFS.exists(ruta) && !SPIFFS.exists(ruta + ".gz")) {
+                request->send(404, "text/plain", "Archivo no encontrado");
+                return;
+            }
+            request->send(SPIFFS, ruta, String());                          // Tipo por extensión; usa el .gz si es lo único que hay
+            return;
+        }
+
+        String etag = String("\"") + pEstatico->etag + "\"";
+        const char* sCache = pEstatico->lInmutable ? Config::Web::CACHE_INMUTABLE : Config::Web::CACHE_REVALIDAR;
+        const AsyncWebHeader* pPrevio = request->getHeader("If-None-Match");
+        AsyncWebServerResponse *response;
+        if (pPrevio != nullptr && pPrevio->value() == etag) {
+            response = request->beginResponse(304);                         // El navegador ya tiene esta versión
+        } else {
+            response = request->beginResponse(SPIFFS, ruta, String());      // Solo existe ruta.gz: añade Content-Encoding
+        }
+        response->addHeader("ETag", etag);
+        response->addHeader("Cache-Control", sCache);
+        request->send(response);
+    }
+
+
   /**
    * @brief Inicializa el servidor HTTP y WebSocket con autenticación
    * 
@@ -15,7 +112,7 @@
    *          
    *          **PROCESO DE INICIALIZACIÓN:**
    *          1. Configuración del servidor HTTP en puerto especificado
-   *          2. Configuración de rutas para archivos SPIFFS
+   *          2. Configuración de rutas para archivos SPIFFS (gzip y ETag, ver enviaEstatico())
    *          3. Inicialización del WebSocket con callback onEvent()
    *          4. Configuración de autenticación HTTP Basic
    *          5. Inicio del servidor y establecimiento de servidorIniciado = true
@@ -55,11 +152,13 @@
             
             // ✅ CARGAR CONFIGURACIÓN DE TELEGRAM AL INICIO
             cargarConfigTelegramDesdeSPIFFS();
+            cargaEstaticos();                                                                       // Manifiesto de recursos web comprimidos
             DBG_SRV_PRINTF("📱 Configuración de Telegram cargada: %s (%s)", 
                           Config::Telegram::CAMPANARIO_NOMBRE.c_str(),
                           Config::Telegram::CAMPANARIO_UBICACION.c_str());
         }        
         if (!servidorIniciado) {                                                                  // Si el servidor no ha sido iniciado
+            registraComandosWebSocket();                                                            // Tabla hash de comandos antes de recibir mensajes
             ws.onEvent(onEvent);                                                                    // Configura el manejador de eventos del WebSocket          
             server.addHandler(&ws);                                                                 // Añade el manejador de WebSocket al servidor HTTP
 
@@ -67,22 +166,21 @@
               if(!request->authenticate(usuario, clave)) {
                 return request->requestAuthentication();
               }
-              request->send(SPIFFS, "/index.html", "text/html");
-              nToque = 0; // Resetea la secuencia a 0 al cargar la página principal
+              enviaEstatico(request, "/index.html");
             });
 
             server.on("/Campanas.html", HTTP_GET, [usuario, clave](AsyncWebServerRequest *request){
               if(!request->authenticate(usuario, clave)) {
                 return request->requestAuthentication();
               }
-              request->send(SPIFFS, "/Campanas.html", "text/html");
+              enviaEstatico(request, "/Campanas.html");
             });
 
             server.on("/alarmas.html", HTTP_GET, [usuario, clave](AsyncWebServerRequest *request){
               if(!request->authenticate(usuario, clave)) {
                 return request->requestAuthentication();
               }
-              request->send(SPIFFS, "/alarmas.html", "text/html");
+              enviaEstatico(request, "/alarmas.html");
             });
 
             // ✅ ENDPOINT PARA DESCARGAR ARCHIVOS DE SPIFFS
@@ -111,6 +209,14 @@
                 return;
               }
               
+              // Las alarmas se guardan en binario: el JSON se genera desde memoria
+              if (filename == "alarmas_personalizadas.json") {
+                AsyncWebServerResponse *response = request->beginResponse(200, "application/json", Alarmas.exportarJSON());
+                response->addHeader("Content-Disposition", "attachment; filename=\"" + filename + "\"");
+                request->send(response);
+                return;
+              }
+              
               String filepath = "/" + filename;
               
               if (!SPIFFS.exists(filepath)) {
@@ -171,7 +277,7 @@
               if (uploadFile) {
                 size_t written = uploadFile.write(data, len);
                 if (written != len) {
-                  DBG_SRV_PRINTF("⚠️  Escritura parcial: %d de %d bytes", written, len);
+                  DBG_SRV_PRINTF("⚠️  Escritura parcial: %u de %u bytes", (unsigned)written, (unsigned)len);
                 }
               }
               
@@ -180,7 +286,7 @@
                 if (uploadFile) {
                   uploadFile.flush();  // Forzar escritura a SPIFFS
                   uploadFile.close();
-                  DBG_SRV_PRINTF("✅ Upload completado: %s (%d bytes)", filename.c_str(), index + len);
+                  DBG_SRV_PRINTF("✅ Upload completado: %s (%u bytes)", filename.c_str(), (unsigned)(index + len));
                   
                   // Si es telegram_config.json, recargar configuración
                   if (filename == "telegram_config.json") {
@@ -190,13 +296,13 @@
                   
                   // Si es alarmas_personalizadas.json, recargar alarmas
                   if (filename == "alarmas_personalizadas.json") {
-                    // Aquí podrías llamar a una función para recargar alarmas si existe
+                    Alarmas.solicitarImportacion();                      // loop() llama a IniciaAlarmas()
                     DBG_SRV("🔄 Alarmas recargadas desde archivo subido");
                   }
                   
                   // Si es Secuencias.json, recargar secuencias
                   if (filename == "Secuencias.json") {
-                    Campanario.CargarSecuencias();
+                    ColaComandos.Encola(CMD_CARGA_SECUENCIAS, ORIGEN_WEB);  // loop() la relee sin cruzarse con la secuencia en curso
                     DBG_SRV("🔄 Secuencias de campanadas recargadas desde archivo subido");
                   }
                 }
@@ -225,7 +331,12 @@
               request->send(200, "text/plain", output);
             });
 
-            server.serveStatic("/", SPIFFS, "/");
+            server.onNotFound([](AsyncWebServerRequest *request){                                  // Resto de archivos de SPIFFS (sustituye a serveStatic)
+              if (request->method() != HTTP_GET) {
+                return request->send(404, "text/plain", "Not found");
+              }
+              enviaEstatico(request, request->url());
+            });
             // Iniciar el servidor
             server.begin();
             DBG_SRV("Servidor HTTP iniciado en el puerto 80.");
@@ -235,6 +346,231 @@
     }
 
 
+  // ============================================================================
+  // RESPUESTAS Y TRÁFICO POR CLIENTE
+  // ============================================================================
+  // Las consultas y los errores se responden solo a quien los pidió; los
+  // cambios de estado se difunden a todos. La tabla de clientes se edita en
+  // la tarea async_tcp (onEvent) y se lee también desde loop() al notificar
+  // los toques, por eso va protegida con muxTrafico.
+
+    struct TraficoCliente {
+        uint32_t id;                                                        // ID de AsyncWebSocketClient (0 = hueco libre)
+        uint32_t nBytes;                                                    // Bytes enviados al cliente (texto y binario)
+        uint32_t nMensajes;                                                 // Mensajes enviados al cliente
+        uint8_t nProtocolo;                                                 // Versión binaria negociada (0 = solo texto)
+    };
+
+    static TraficoCliente aTrafico[Config::WebSocket::MAX_CLIENTES];
+    static portMUX_TYPE muxTrafico = portMUX_INITIALIZER_UNLOCKED;
+
+    static TraficoCliente* traficoDe(uint32_t nId) {                        // Con muxTrafico tomado
+        for (uint8_t i = 0; i < Config::WebSocket::MAX_CLIENTES; ++i) {
+            if (aTrafico[i].id == nId) return &aTrafico[i];
+        }
+        return nullptr;
+    }
+
+    static void sumaTrafico(uint32_t nId, size_t nBytes) {
+        portENTER_CRITICAL(&muxTrafico);
+        TraficoCliente* pTrafico = traficoDe(nId);
+        if (pTrafico != nullptr) {
+            pTrafico->nBytes += nBytes;
+            pTrafico->nMensajes++;
+        }
+        portEXIT_CRITICAL(&muxTrafico);
+    }
+
+    /**
+     * @brief Reserva contadores para un cliente recién conectado
+     *
+     * @note Si la tabla está llena el cliente funciona igual, pero no se contabiliza
+     */
+    static void altaTrafico(uint32_t nId) {
+        portENTER_CRITICAL(&muxTrafico);
+        TraficoCliente* pTrafico = traficoDe(0);
+        if (pTrafico != nullptr) {
+            pTrafico->id = nId;
+            pTrafico->nBytes = 0;
+            pTrafico->nMensajes = 0;
+            pTrafico->nProtocolo = 0;
+        }
+        portEXIT_CRITICAL(&muxTrafico);
+        if (pTrafico == nullptr) DBG_SRV_PRINTF("Tabla de tráfico llena: cliente #%u sin contadores\n", nId);
+    }
+
+    static void bajaTrafico(uint32_t nId) {
+        TraficoCliente trafico = {};
+        portENTER_CRITICAL(&muxTrafico);
+        TraficoCliente* pTrafico = traficoDe(nId);
+        if (pTrafico != nullptr) {
+            trafico = *pTrafico;
+            pTrafico->id = 0;
+        }
+        portEXIT_CRITICAL(&muxTrafico);
+        if (trafico.id != 0) DBG_SRV_PRINTF("Cliente #%u: %u mensajes, %u bytes enviados\n", nId, trafico.nMensajes, trafico.nBytes);
+    }
+
+    /**
+     * @brief Envía un mensaje a todos los clientes y lo suma a sus contadores
+     */
+    static void enviaTodos(const String& mensaje) {
+        ws.textAll(mensaje);
+        portENTER_CRITICAL(&muxTrafico);
+        for (uint8_t i = 0; i < Config::WebSocket::MAX_CLIENTES; ++i) {
+            if (aTrafico[i].id == 0) continue;
+            aTrafico[i].nBytes += mensaje.length();
+            aTrafico[i].nMensajes++;
+        }
+        portEXIT_CRITICAL(&muxTrafico);
+    }
+
+    /**
+     * @brief Responde solo al cliente que envió el comando
+     *
+     * @param client Cliente que pidió la respuesta; si es nullptr se difunde a todos
+     * @param mensaje Texto de la respuesta
+     */
+    static void enviaCliente(AsyncWebSocketClient* client, const String& mensaje) {
+        if (client == nullptr) {
+            enviaTodos(mensaje);
+            return;
+        }
+        client->text(mensaje);
+        sumaTrafico(client->id(), mensaje.length());
+    }
+
+    /**
+     * @brief Encola una orden de alarmas para loop()
+     *
+     * @param client Cliente que espera la respuesta (nullptr = todos)
+     * @param pDatos OrdenAlarma o ExcepcionAlarma reservado con new; la cola se queda con él
+     */
+    static void encolaOrdenAlarma(AsyncWebSocketClient* client, TipoComando tipo, uint16_t nParametro, uint32_t nValor = 0, void* pDatos = nullptr) {
+        if (!ColaComandos.Encola(tipo, ORIGEN_WEB, nParametro, nValor, pDatos, client ? client->id() : 0)) {
+            enviaCliente(client, "ERROR_ALARMA_WEB:Sistema ocupado, inténtalo de nuevo");
+        }
+    }
+
+    /**
+     * @brief Pide a loop() una consulta de estado; la respuesta sale de ejecutaConsulta()
+     *
+     * @details El árbitro, la cola, el jitter y la calibración los modifica
+     *          loop(): leerlos desde async_tcp cruzaría con sus escrituras.
+     *          Con la cola llena la consulta se pierde (cuenta en "perdidas").
+     */
+    static void encolaConsulta(AsyncWebSocketClient* client, ConsultaEstado consulta) {
+        ColaComandos.Encola(CMD_CONSULTA, ORIGEN_WEB, consulta, 0, nullptr, client ? client->id() : 0);
+    }
+
+    /**
+     * @brief Cliente que espera la respuesta de una orden sacada de la cola
+     *
+     * @param comando Orden en ejecución en loop()
+     * @param client Cliente (nullptr si la respuesta es para todos o ya no está)
+     * @return false si lo pidió un cliente que se ha desconectado mientras esperaba
+     */
+    static bool clienteDeOrden(const Comando& comando, AsyncWebSocketClient*& client) {
+        client = nullptr;
+        if (comando.cliente == 0) return true;
+        client = ws.client(comando.cliente);
+        if (client == nullptr) DBG_SRV_PRINTF("Cliente #%u desconectado: sin respuesta a la orden %u", comando.cliente, comando.tipo);
+        return client != nullptr;
+    }
+
+  // ============================================================================
+  // PROTOCOLO BINARIO
+  // ============================================================================
+  // Los clientes que negocian "PROTOCOLO:1" reciben el estado y cada tiempo
+  // de la secuencia como una TramaEstado de 16 bytes en lugar de texto. Las
+  // tramas se rellenan en buffers estáticos, uno por tarea, sin String.
+
+    static TramaEstado tramaToque;                                          // Solo desde loop() (notificaToque)
+    static TramaEstado tramaConsulta;                                       // Solo desde la tarea async_tcp (GET_CAMPANARIO)
+
+    static uint8_t protocoloDe(AsyncWebSocketClient* client) {
+        if (client == nullptr) return 0;
+        portENTER_CRITICAL(&muxTrafico);
+        TraficoCliente* pTrafico = traficoDe(client->id());
+        uint8_t nProtocolo = pTrafico ? pTrafico->nProtocolo : 0;
+        portEXIT_CRITICAL(&muxTrafico);
+        return nProtocolo;
+    }
+
+    /**
+     * @brief Rellena una trama con el estado actual del campanario
+     *
+     * @param trama Buffer preasignado de la tarea que llama
+     * @param nTipo TRAMA_ESTADO o TRAMA_TOQUE
+     * @param nMascara Campanas del tiempo que se notifica (0 en TRAMA_ESTADO)
+     */
+    static void preparaTrama(TramaEstado& trama, TipoTrama nTipo, uint8_t nMascara) {
+        double nCalefaccion = Campanario.GetSegundosCalefaccion();          // -1 si no hay calefacción
+        trama.version = Config::WebSocket::PROTOCOLO_BINARIO;
+        trama.tipo = nTipo;
+        trama.estado = (uint8_t)Campanario.GetEstadoCampanario();
+        trama.campanas = nMascara;
+        trama.secuencia = Campanario.GetSecuenciaActiva();
+        trama.reservado = 0;
+        trama.toque = Campanario.GetIndiceToque();
+        trama.calefaccion = (nCalefaccion > 0) ? (uint32_t)nCalefaccion : 0;
+        trama.hora = (uint32_t)time(nullptr);
+    }
+
+    /**
+     * @brief Notifica a los clientes un tiempo de la secuencia en curso
+     *
+     * @details Los clientes binarios reciben una TRAMA_TOQUE; los de texto,
+     *          un "CAMPANA:n" por campana formado en la pila. Si ningún
+     *          cliente ha negociado el binario se usa textAll() como antes.
+     *
+     * @param nMascara Campanas del tiempo (bit 0 = campana 1)
+     *
+     * @note Se llama desde loop() a través de TestCampanadas()
+     *
+     * @since v2.2
+     * @author Julian Salas Bartolomé
+     */
+    void notificaToque(uint8_t nMascara) {
+        uint32_t aBinarios[Config::WebSocket::MAX_CLIENTES];
+        uint32_t aTexto[Config::WebSocket::MAX_CLIENTES];
+        uint8_t nBinarios = 0;
+        uint8_t nTexto = 0;
+        portENTER_CRITICAL(&muxTrafico);
+        for (uint8_t i = 0; i < Config::WebSocket::MAX_CLIENTES; ++i) {
+            if (aTrafico[i].id == 0) continue;
+            if (aTrafico[i].nProtocolo > 0) aBinarios[nBinarios++] = aTrafico[i].id;
+            else aTexto[nTexto++] = aTrafico[i].id;
+        }
+        portEXIT_CRITICAL(&muxTrafico);
+
+        if (nBinarios > 0) {
+            preparaTrama(tramaToque, TRAMA_TOQUE, nMascara);
+            for (uint8_t n = 0; n < nBinarios; ++n) {
+                AsyncWebSocketClient* pCliente = ws.client(aBinarios[n]);
+                if (pCliente == nullptr) continue;                          // Desconectado entre la copia y el envío
+                pCliente->binary((const uint8_t*)&tramaToque, sizeof(tramaToque));
+                sumaTrafico(aBinarios[n], sizeof(tramaToque));
+            }
+        }
+
+        char sMensaje[12];                                                  // "CAMPANA:" y hasta tres dígitos
+        for (int i = 0; i < Config::Campanario::MAX_CAMPANAS; ++i) {        // Una notificación de texto por campana del mismo tiempo
+            if (!(nMascara & MascaraCampana(i))) continue;
+            int nLen = snprintf(sMensaje, sizeof(sMensaje), "CAMPANA:%d", i + 1);
+            if (nBinarios == 0) {
+                ws.textAll(sMensaje);                                       // Incluye clientes sin hueco en la tabla
+                for (uint8_t n = 0; n < nTexto; ++n) sumaTrafico(aTexto[n], nLen);
+            } else {
+                for (uint8_t n = 0; n < nTexto; ++n) {
+                    ws.text(aTexto[n], sMensaje);
+                    sumaTrafico(aTexto[n], nLen);
+                }
+            }
+        }
+    }
+
+
   /**
    * @brief Callback principal para eventos de WebSocket
    * 
@@ -305,19 +641,21 @@
               DBG_SRV("OnEvent->WS_EVT_CONNECT: ");
               DBG_SRV_PRINTF("WebSocket client #%u connected from %s\n", client->id(), client->remoteIP().toString().c_str());
               DBG_SRV(" ");
+              altaTrafico(client->id());
               break;
           case WS_EVT_DISCONNECT:
               DBG_SRV(" ");
               DBG_SRV("OnEvent->WS_EVT_DISCONNECT: ");
               DBG_SRV_PRINTF("WebSocket client #%u disconnected\n", client->id());
               DBG_SRV(" ");
+              bajaTrafico(client->id());
               break;
           case WS_EVT_DATA:
               DBG_SRV(" ");
               DBG_SRV("OnEvent->WS_EVT_DATA: ");
-              DBG_SRV_PRINTF("Message received: %s\n", (char*)data);
+              DBG_SRV_PRINTF("Message received: %.*s\n", (int)len, (char*)data);
               DBG_SRV(" ");
-              procesaMensajeWebSocket(arg, data, len);
+              procesaMensajeWebSocket(client, arg, data, len);
               break;
           case WS_EVT_PONG:
           case WS_EVT_ERROR:
@@ -325,477 +663,852 @@
         }
       
     }
+  // ============================================================================
+  // COMANDOS WEBSOCKET
+  // ============================================================================
+  // Cada comando es "<TOKEN>" o "<TOKEN>:<datos>". El token se busca en una
+  // tabla hash (FNV-1a, como la de secuencias de CAMPANARIO) y los datos se
+  // pasan a su manejador como puntero y longitud dentro del buffer recibido.
+
+    struct ComandoWebSocket {
+        const char* nombre;                                                 // Token antes de ':'
+        ManejadorComando manejador;
+    };
+
+    static uint8_t aTablaComandos[Config::WebSocket::TAM_TABLA_COMANDOS];  // Índice en COMANDOS_WS más uno (0 = hueco libre)
+
+    /**
+     * @brief Hash FNV-1a de 32 bits de un token (distingue mayúsculas)
+     */
+    static uint32_t hashComando(const char* p, size_t n) {
+        uint32_t h = 2166136261u;                                           // Base FNV-1a
+        for (size_t i = 0; i < n; ++i) {
+            h ^= (uint8_t)p[i];
+            h *= 16777619u;                                                 // Primo FNV
+        }
+        return h;
+    }
+
+    /**
+     * @brief Lee un entero con signo de los datos de un comando
+     *
+     * @return Valor leído (0 si no hay dígitos, como String::toInt())
+     */
+    static long leeEntero(const char* p, size_t n) {
+        size_t i = 0;
+        while (i < n && p[i] == ' ') ++i;
+        bool lNegativo = (i < n && p[i] == '-');
+        if (i < n && (p[i] == '-' || p[i] == '+')) ++i;
+        long nValor = 0;
+        for (; i < n && p[i] >= '0' && p[i] <= '9'; ++i) {
+            nValor = nValor * 10 + (p[i] - '0');
+            if (nValor > 1000000000L) break;
+        }
+        return lNegativo ? -nValor : nValor;
+    }
+
+    /**
+     * @brief ID de una secuencia de la biblioteca a partir de los datos de un comando
+     *
+     * @return ID, o 0 si el nombre no cabe (ninguna secuencia tiene ID 0)
+     */
+    static uint16_t idSecuenciaComando(const char* pDatos, size_t nDatos) {
+        char sNombre[Config::Campanario::MAX_NOMBRE_SECUENCIA];
+        if (nDatos == 0 || nDatos >= sizeof(sNombre)) return 0;
+        memcpy(sNombre, pDatos, nDatos);
+        sNombre[nDatos] = '\0';
+        return CAMPANARIO::IdSecuencia(sNombre);
+    }
+
+    // === Control del campanario ===
+
+    static void comandoDifuntos(AsyncWebSocketClient* client, const char* pDatos, size_t nDatos) {
+        Arbitro.Solicita(TOQUE_SECUENCIA, PRIO_MANUAL, Config::States::DIFUNTOS, Config::Telegram::METODO_ACTIVACION_WEB);  // El árbitro decide si suena, espera o interrumpe
+        enviaTodos("REDIRECT:/Campanas.html");                              // Indica a los clientes que deben redirigir a la pantalla de presentacion de las campanas
+        DBG_SRV("Procesando mensaje: TocaDifuntos");
+    }
+
+    static void comandoMisa(AsyncWebSocketClient* client, const char* pDatos, size_t nDatos) {
+        Arbitro.Solicita(TOQUE_SECUENCIA, PRIO_MANUAL, Config::States::MISA, Config::Telegram::METODO_ACTIVACION_WEB);
+        enviaTodos("REDIRECT:/Campanas.html");
+        DBG_SRV("Procesando mensaje: TocaMisa");
+    }
+
+    static void comandoFiesta(AsyncWebSocketClient* client, const char* pDatos, size_t nDatos) {
+        Arbitro.Solicita(TOQUE_SECUENCIA, PRIO_MANUAL, Config::States::FIESTA, Config::Telegram::METODO_ACTIVACION_WEB);
+        enviaTodos("REDIRECT:/Campanas.html");
+        DBG_SRV("Procesando mensaje: TocaFiesta");
+    }
+
+    static void comandoParar(AsyncWebSocketClient* client, const char* pDatos, size_t nDatos) {
+        Arbitro.Solicita(TOQUE_PARAR, PRIO_EMERGENCIA, 0, Config::Telegram::METODO_ACTIVACION_WEB);  // Se para desde loop(), no desde la tarea del servidor
+        DBG_SRV("Procesando mensaje: Parar");
+    }
+
+    static void comandoEmergencia(AsyncWebSocketClient* client, const char* pDatos, size_t nDatos) {     // "EMERGENCIA:<nombre>"
+        uint16_t nId = idSecuenciaComando(pDatos, nDatos);                  // ID de la secuencia en la biblioteca
+        if (nId != 0 && Campanario.BuscaSecuencia(nId) >= 0) {
+            Arbitro.Solicita(TOQUE_SECUENCIA, PRIO_EMERGENCIA, nId, Config::Telegram::METODO_ACTIVACION_WEB);  // Interrumpe cualquier otro toque
+            DBG_SRV_PRINTF("Procesando mensaje: Emergencia %.*s\n", (int)nDatos, pDatos);
+        } else {
+            DBG_SRV_PRINTF("Secuencia no cargada: %.*s\n", (int)nDatos, pDatos);
+        }
+    }
+
+    static void comandoSecuencia(AsyncWebSocketClient* client, const char* pDatos, size_t nDatos) {      // "SECUENCIA:<nombre>"
+        uint16_t nId = idSecuenciaComando(pDatos, nDatos);
+        if (nId != 0 && Campanario.BuscaSecuencia(nId) >= 0) {
+            Arbitro.Solicita(TOQUE_SECUENCIA, PRIO_MANUAL, nId, Config::Telegram::METODO_ACTIVACION_WEB);  // Se toca desde loop() a través del árbitro
+            enviaTodos("REDIRECT:/Campanas.html");
+            DBG_SRV_PRINTF("Procesando mensaje: Secuencia %.*s\n", (int)nDatos, pDatos);
+        } else {
+            DBG_SRV_PRINTF("Secuencia no cargada: %.*s\n", (int)nDatos, pDatos);
+        }
+    }
+
+    static void comandoCalefaccionOn(AsyncWebSocketClient* client, const char* pDatos, size_t nDatos) {  // "CALEFACCION_ON:<minutos>"
+        long minutos = leeEntero(pDatos, nDatos);
+        if (minutos < 0 || minutos > Config::Heating::MAX_MINUTES) {        // Validación del rango de minutos
+            DBG_SRV_PRINTF("Minutos fuera de rango, establecido a 0. Valor recibido: %.*s\n", (int)nDatos, pDatos);
+            minutos = 0;
+        }
+        ColaComandos.Encola(CMD_CALEFACCION_ON, ORIGEN_WEB, (uint16_t)minutos);  // La enciende loop()
+        enviaTodos("CALEFACCION:ON:" + String(minutos));                    // Envía el estado con los minutos programados
+        DBG_SRV_PRINTF("Procesando mensaje: Calefacción ON por %ld minutos\n", minutos);
+        if (telegramBot.isEnabled() && Config::Telegram::NOTIFICACION_CALEFACCION_ON) {
+            telegramBot.sendCalefaccionOnNotification(Config::Telegram::METODO_ACTIVACION_WEB);
+        }
+    }
+
+    static void comandoCalefaccionOff(AsyncWebSocketClient* client, const char* pDatos, size_t nDatos) {
+        ColaComandos.Encola(CMD_CALEFACCION_OFF, ORIGEN_WEB);               // La apaga loop()
+        enviaTodos("CALEFACCION:OFF");
+        DBG_SRV("Procesando mensaje: Calefacción OFF");
+        if (telegramBot.isEnabled() && Config::Telegram::NOTIFICACION_CALEFACCION_OFF) {
+            telegramBot.sendCalefaccionOffNotification(Config::Telegram::METODO_ACTIVACION_WEB);
+        }
+    }
+
+    // === Estado del sistema ===
+
+    static void comandoGetColaComandos(AsyncWebSocketClient* client, const char* pDatos, size_t nDatos) {
+        encolaConsulta(client, CONSULTA_COLA_COMANDOS);                     // Latencia de las órdenes hacia loop()
+    }
+
+    static void comandoGetArbitro(AsyncWebSocketClient* client, const char* pDatos, size_t nDatos) {
+        encolaConsulta(client, CONSULTA_ARBITRO);                           // El toque en curso, la cola y el registro de decisiones
+    }
+
+    static void comandoGetAgenda(AsyncWebSocketClient* client, const char* pDatos, size_t nDatos) {      // "GET_AGENDA[:<días>]"
+        long nDias = (nDatos > 0) ? leeEntero(pDatos, nDatos) : Config::Alarmas::DIAS_AGENDA;
+        if (nDias < 1 || nDias > Config::Alarmas::DIAS_AGENDA_MAX) nDias = Config::Alarmas::DIAS_AGENDA;
+        encolaOrdenAlarma(client, CMD_ALARMA_CONSULTA, CONSULTA_AGENDA, (uint32_t)nDias);  // loop() la calcula y responde "AGENDA:"
+    }
+
+    static void comandoGetCalefaccion(AsyncWebSocketClient* client, const char* pDatos, size_t nDatos) {
+        const char* estadoCalefaccion = Campanario.GetEstadoCalefaccion() ? "ON" : "OFF";
+        enviaCliente(client, String("ESTADO_CALEFACCION:") + estadoCalefaccion); // Solo al cliente que lo pidió
+        DBG_SRV_PRINTF("Estado de la calefacción enviado: %s\n", estadoCalefaccion);
+    }
+
+    static void comandoGetTiempoCalefaccion(AsyncWebSocketClient* client, const char* pDatos, size_t nDatos) {
+        enviaCliente(client, "TIEMPO_CALEFACCION:" + String(Campanario.GetSegundosCalefaccion()));  // Sin apagarla: eso lo hace loop()
+    }
+
+    static void comandoGetCampanario(AsyncWebSocketClient* client, const char* pDatos, size_t nDatos) {
+        if (protocoloDe(client) > 0) {                                      // Estado, secuencia y calefacción en una trama
+            preparaTrama(tramaConsulta, TRAMA_ESTADO, 0);
+            client->binary((const uint8_t*)&tramaConsulta, sizeof(tramaConsulta));
+            sumaTrafico(client->id(), sizeof(tramaConsulta));
+            return;
+        }
+        enviaCliente(client, "ESTADO_CAMPANARIO:" + String(Campanario.GetEstadoCampanario()));
+    }
+
+    static void comandoProtocolo(AsyncWebSocketClient* client, const char* pDatos, size_t nDatos) {  // "PROTOCOLO:<versión del cliente>"
+        long nPedido = leeEntero(pDatos, nDatos);
+        uint8_t nProtocolo = (uint8_t)constrain(nPedido, 0L, (long)Config::WebSocket::PROTOCOLO_BINARIO);
+        portENTER_CRITICAL(&muxTrafico);
+        TraficoCliente* pTrafico = traficoDe(client->id());
+        if (pTrafico != nullptr) pTrafico->nProtocolo = nProtocolo;
+        else nProtocolo = 0;                                                // Sin hueco en la tabla no se le envían tramas
+        portEXIT_CRITICAL(&muxTrafico);
+        enviaCliente(client, "PROTOCOLO:" + String(nProtocolo));            // Versión aceptada (0 = solo texto)
+        DBG_SRV_PRINTF("Cliente #%u: protocolo %u\n", client->id(), nProtocolo);
+    }
+
+    static void comandoGetJitter(AsyncWebSocketClient* client, const char* pDatos, size_t nDatos) {
+        encolaConsulta(client, CONSULTA_JITTER);                            // El histograma de retraso de los toques
+    }
+
+    static void comandoResetJitter(AsyncWebSocketClient* client, const char* pDatos, size_t nDatos) {
+        ColaComandos.Encola(CMD_RESET_JITTER, ORIGEN_WEB);                  // loop() lo reinicia y envía el histograma vacío
+    }
+
+    static void comandoGetCampanas(AsyncWebSocketClient* client, const char* pDatos, size_t nDatos) {
+        encolaConsulta(client, CONSULTA_CAMPANAS);                          // La calibración de las campanas
+    }
+
+    static void comandoGetSecuencias(AsyncWebSocketClient* client, const char* pDatos, size_t nDatos) {
+        encolaConsulta(client, CONSULTA_SECUENCIAS);                        // La biblioteca de secuencias (CMD_CARGA_SECUENCIAS la recarga en loop())
+    }
+
+    static void comandoGetSecuenciaActiva(AsyncWebSocketClient* client, const char* pDatos, size_t nDatos) {
+        enviaCliente(client, "SECUENCIAACTIVA:" + String(Campanario.GetSecuenciaActiva())); // ---- NO UTILIZADO EN ESTA VERSION ----
+    }
+
+    static void comandoGetTraficoWs(AsyncWebSocketClient* client, const char* pDatos, size_t nDatos) {  // [{"id","bytes","mensajes","protocolo"}]
+        TraficoCliente aCopia[Config::WebSocket::MAX_CLIENTES];
+        portENTER_CRITICAL(&muxTrafico);
+        memcpy(aCopia, aTrafico, sizeof(aCopia));
+        portEXIT_CRITICAL(&muxTrafico);
+        String json = "[";
+        for (uint8_t i = 0; i < Config::WebSocket::MAX_CLIENTES; ++i) {
+            if (aCopia[i].id == 0) continue;
+            if (json.length() > 1) json += ',';
+            json += "{\"id\":" + String(aCopia[i].id) + ",\"bytes\":" + String(aCopia[i].nBytes) +
+                    ",\"mensajes\":" + String(aCopia[i].nMensajes) + ",\"protocolo\":" + String(aCopia[i].nProtocolo) + "}";
+        }
+        json += "]";
+        enviaCliente(client, "TRAFICO_WS:" + json);
+    }
+
+    // === Calibración de campanas ===
+
+    static void comandoSetPulsoCampana(AsyncWebSocketClient* client, const char* pDatos, size_t nDatos) {  // "SET_PULSO_CAMPANA:<campana>:<ms>"
+        const char* pSeparador = (const char*)memchr(pDatos, ':', nDatos);
+        size_t nCampanaLen = pSeparador ? (size_t)(pSeparador - pDatos) : nDatos;
+        int nCampana = (int)leeEntero(pDatos, nCampanaLen);
+        long nPulso = pSeparador ? leeEntero(pSeparador + 1, nDatos - nCampanaLen - 1) : 0;
+        ColaComandos.Encola(CMD_PULSO_CAMPANA, ORIGEN_WEB, (uint16_t)constrain(nCampana, 0, 255), (uint32_t)constrain(nPulso, 0L, 65535L));  // loop() lo aplica y envía CAMPANAS:
+        DBG_SRV_PRINTF("Procesando mensaje: Pulso campana %d -> %ld ms\n", nCampana, nPulso);
+    }
+
+    static void comandoProbarCampana(AsyncWebSocketClient* client, const char* pDatos, size_t nDatos) {  // "PROBAR_CAMPANA:<campana>"
+        int nCampana = (int)leeEntero(pDatos, nDatos);
+        ColaComandos.Encola(CMD_PROBAR_CAMPANA, ORIGEN_WEB, (uint16_t)constrain(nCampana, 0, 255));  // Se toca desde loop()
+    }
+
+    // === Alarmas personalizables ===
+    // Los comandos solo leen y validan el JSON: la edición o la consulta se
+    // encola en ColaComandos y la hace loop() con ejecutaOrdenAlarma(), entre
+    // dos check() y guardarPendientes(). Las respuestas salen desde allí.
+
+    /**
+     * @brief Lee y valida los campos comunes de ADD_ALARMA_WEB y EDIT_ALARMA_WEB
+     *
+     * @details Resuelve el callback con ResuelveAccionAlarma() (MISA, DIFUNTOS,
+     *          FIESTA, CALEFACCION o el nombre de cualquier secuencia de
+     *          Secuencias.json), valida "cron", "fiesta" + "desplazamiento" y
+     *          "recuperacion" + "margenRecuperacion", y copia el resto a una
+     *          OrdenAlarma nueva.
+     *
+     * @param client Cliente al que se envía el error
+     * @param doc Mensaje ya deserializado
+     * @param lExigeAccion true: un tipo de acción desconocido es un error (EDIT);
+     *                     false: se ignora la orden sin responder (ADD)
+     * @return Orden reservada con new, o nullptr si no hay nada que encolar
+     */
+    static OrdenAlarma* leeOrdenAlarma(AsyncWebSocketClient* client, JsonDocument& doc, bool lExigeAccion) {
+        const char* tipoAccion = doc["accion"] | "MISA";
+        void (*callback)(uint16_t) = nullptr;
+        uint16_t parametro = 0;
+
+        if (ResuelveAccionAlarma(tipoAccion, doc["duracion"] | 30, callback, parametro)) {  // CALEFACCION: 30 min por defecto
+            DBG_SRV_PRINTF("🔔 Configurando callback %s (parámetro %u)", tipoAccion, parametro);
+        }
+        if (callback == nullptr && lExigeAccion) {
+            DBG_SRV_PRINTF("❌ ERROR: Callback es NULL para tipo '%s'", tipoAccion);
+            enviaCliente(client, "ERROR_ALARMA_WEB:Tipo de acción no válido");
+            return nullptr;
+        }
+
+        const char* cron = doc["cron"] | "";
+        CronAlarma cronCompilado;
+        if (cron[0] != '\0' && !CompilaCron(cron, cronCompilado)) {
+            enviaCliente(client, "ERROR_ALARMA_WEB:Expresión cron no válida");
+            return nullptr;
+        }
+        const char* nombreFiesta = doc["fiesta"] | "";
+        FiestaLiturgica fiesta = CALENDARIO::DesdeNombre(nombreFiesta);
+        int desplazamiento = doc["desplazamiento"] | 0;
+        if ((nombreFiesta[0] != '\0' && fiesta == FIESTA_NINGUNA) || desplazamiento < -366 || desplazamiento > 366) {
+            enviaCliente(client, "ERROR_ALARMA_WEB:Fiesta no válida");
+            return nullptr;
+        }
+        uint8_t recuperacion = AlarmScheduler::recuperacionDesdeNombre(doc["recuperacion"] | "TARDE");
+        int margenRecuperacion = doc["margenRecuperacion"] | (int)Config::Alarmas::MARGEN_RECUPERACION_MIN;
+        if (recuperacion > RECUP_ULTIMA || margenRecuperacion < 0 || margenRecuperacion > 255) {
+            enviaCliente(client, "ERROR_ALARMA_WEB:Recuperación no válida");
+            return nullptr;
+        }
+        if (callback == nullptr) return nullptr;
+
+        OrdenAlarma* pOrden = new OrdenAlarma();
+        pOrden->idWeb = doc["id"] | -1;
+        strlcpy(pOrden->nombre, doc["nombre"] | "", sizeof(pOrden->nombre));
+        strlcpy(pOrden->descripcion, doc["descripcion"] | "", sizeof(pOrden->descripcion));
+        strlcpy(pOrden->tipo, tipoAccion, sizeof(pOrden->tipo));
+        strlcpy(pOrden->cron, cron, sizeof(pOrden->cron));                  // Ya validada: cabe en CRON_MAX_TEXTO
+        pOrden->accion = callback;
+        pOrden->parametro = parametro;
+        pOrden->mascaraDias = convertirDiaAMascara(doc["dia"] | 0);
+        pOrden->hora = doc["hora"] | 0;
+        pOrden->minuto = doc["minuto"] | 0;
+        pOrden->habilitada = doc["habilitada"] | true;
+        pOrden->fiesta = fiesta;
+        pOrden->desplazamientoDias = (int16_t)desplazamiento;
+        pOrden->recuperacion = recuperacion;
+        pOrden->margenRecuperacion = (uint8_t)margenRecuperacion;
+        return pOrden;
+    }
+
+    /**
+    * @brief Crea una alarma personalizable desde la web ("ADD_ALARMA_WEB:<json>")
+    * 
+    * @details **PROCESO DE CREACIÓN:**
+    *          1. Deserializa los datos JSON en el propio buffer del mensaje
+    *          2. Valida los campos y resuelve la acción con leeOrdenAlarma()
+    *          3. Encola CMD_ALARMA_ADD; loop() llama a Alarmas.addPersonalizable()
+    *          4. Desde loop() se envía la confirmación o el error
+    * 
+    * @note La confirmación va a todos los clientes (enviaTodos); los errores, solo a quien la pidió
+    * 
+    * @see AlarmScheduler::addPersonalizable() - Método para crear alarmas
+    * @see convertirDiaAMascara() - Función auxiliar para conversión de días
+    * 
+    * @since v2.1 - Sistema de alarmas personalizables vía web
+    * @author Julian Salas Bartolomé
+    */
+    static void comandoAddAlarma(AsyncWebSocketClient* client, const char* pDatos, size_t nDatos) {
+        JsonDocument doc;
+        deserializeJson(doc, pDatos, nDatos);                               // Sin copiar el mensaje a un String
+        OrdenAlarma* pOrden = leeOrdenAlarma(client, doc, false);
+        if (pOrden) encolaOrdenAlarma(client, CMD_ALARMA_ADD, 0, 0, pOrden);
+    }
+
+    /**
+    * @brief Modifica una alarma personalizable ("EDIT_ALARMA_WEB:<json>")
+    * 
+    * @details Mismos campos y validaciones que ADD_ALARMA_WEB más "id". El
+    *          callback se vuelve a resolver a partir del tipo de acción.
+    * 
+    * @see AlarmScheduler::modificarPersonalizable() - Método para modificar alarmas
+    * 
+    * @since v2.1 - Sistema de alarmas personalizables vía web
+    * @author Julian Salas Bartolomé
+    */
+    static void comandoEditAlarma(AsyncWebSocketClient* client, const char* pDatos, size_t nDatos) {
+        JsonDocument doc;
+        deserializeJson(doc, pDatos, nDatos);
+        OrdenAlarma* pOrden = leeOrdenAlarma(client, doc, true);
+        if (pOrden) encolaOrdenAlarma(client, CMD_ALARMA_EDIT, 0, 0, pOrden);
+    }
+
+    static void comandoDeleteAlarma(AsyncWebSocketClient* client, const char* pDatos, size_t nDatos) {   // "DELETE_ALARMA_WEB:{"id"}"
+        JsonDocument doc;
+        deserializeJson(doc, pDatos, nDatos);
+        int id = doc["id"] | -1;
+        encolaOrdenAlarma(client, CMD_ALARMA_DELETE, 0, (uint32_t)id);
+    }
+
+    static void comandoToggleAlarma(AsyncWebSocketClient* client, const char* pDatos, size_t nDatos) {   // "TOGGLE_ALARMA_WEB:{"id","habilitada"}"
+        JsonDocument doc;
+        deserializeJson(doc, pDatos, nDatos);
+        int id = doc["id"] | -1;
+        bool estado = doc["habilitada"] | false;
+        encolaOrdenAlarma(client, CMD_ALARMA_HABILITA, estado ? 1 : 0, (uint32_t)id);
+    }
+
+    static void comandoGetAlarmas(AsyncWebSocketClient* client, const char* pDatos, size_t nDatos) {
+        encolaOrdenAlarma(client, CMD_ALARMA_CONSULTA, CONSULTA_ALARMAS);
+    }
+
+    static void comandoGetStatsAlarmas(AsyncWebSocketClient* client, const char* pDatos, size_t nDatos) {
+        encolaOrdenAlarma(client, CMD_ALARMA_CONSULTA, CONSULTA_ESTADISTICAS);
+    }
+
+    /**
+    * @brief Omite, sustituye o desplaza una alarma en una fecha ("ADD_EXCEPCION_ALARMA_WEB:<json>")
+    * 
+    * @details {"id", "fecha":"AAAA-MM-DD", "tipo":"OMITIR|SUSTITUIR|DESPLAZAR",
+    *          "accion", "duracion", "desplazamiento" (minutos)}
+    * 
+    * @see AlarmScheduler::addExcepcion()
+    * 
+    * @since v2.2
+    * @author Julian Salas Bartolomé
+    */
+    static void comandoAddExcepcion(AsyncWebSocketClient* client, const char* pDatos, size_t nDatos) {
+        JsonDocument doc;
+        deserializeJson(doc, pDatos, nDatos);
+        ExcepcionAlarma excepcion;
+        excepcion.idWeb = doc["id"] | -1;
+        excepcion.fecha = AlarmScheduler::fechaDesdeTexto(doc["fecha"] | "");
+        excepcion.tipo = AlarmScheduler::excepcionDesdeNombre(doc["tipo"] | "OMITIR");
+        excepcion.desplazamientoMin = doc["desplazamiento"] | 0;
+        if (excepcion.fecha == 0 || excepcion.tipo > EXCEPCION_DESPLAZAR) {
+            enviaCliente(client, "ERROR_ALARMA_WEB:Excepción no válida");
+            return;
+        }
+        if (excepcion.tipo == EXCEPCION_SUSTITUIR) {
+            strlcpy(excepcion.accion, doc["accion"] | "", sizeof(excepcion.accion));
+            if (!ResuelveAccionAlarma(excepcion.accion, doc["duracion"] | 30, excepcion.accionExt, excepcion.parametro)) {
+                enviaCliente(client, "ERROR_ALARMA_WEB:Tipo de acción no válido");
+                return;
+            }
+        }
+        encolaOrdenAlarma(client, CMD_EXCEPCION_ADD, 0, 0, new ExcepcionAlarma(excepcion));
+    }
+
+    static void comandoDeleteExcepcion(AsyncWebSocketClient* client, const char* pDatos, size_t nDatos) {  // "DELETE_EXCEPCION_ALARMA_WEB:{"id","fecha"}"
+        JsonDocument doc;
+        deserializeJson(doc, pDatos, nDatos);
+        ExcepcionAlarma* pExcepcion = new ExcepcionAlarma();
+        pExcepcion->idWeb = doc["id"] | -1;
+        pExcepcion->fecha = AlarmScheduler::fechaDesdeTexto(doc["fecha"] | "");
+        encolaOrdenAlarma(client, CMD_EXCEPCION_DELETE, 0, 0, pExcepcion);
+    }
+
+    static void comandoGetExcepciones(AsyncWebSocketClient* client, const char* pDatos, size_t nDatos) {
+        encolaOrdenAlarma(client, CMD_ALARMA_CONSULTA, CONSULTA_EXCEPCIONES);
+    }
+
+    /**
+    * @brief Aplica una orden web de alarmas y responde (desde loop())
+    * 
+    * @details Lo llama ColaComandos::Atiende() para las órdenes CMD_ALARMA_* y
+    *          CMD_EXCEPCION_* que encolan los comandos de arriba. Las
+    *          confirmaciones van a todos los clientes; los errores y las
+    *          consultas, solo al cliente que las pidió si sigue conectado.
+    * 
+    * @param comando Orden sacada de la cola; pDatos lo libera la cola después
+    * 
+    * @warning **LOOP:** Solo desde loop(); es la única tarea que toca Alarmas
+    * 
+    * @since v2.2
+    * @author Julian Salas Bartolomé
+    */
+    void ejecutaOrdenAlarma(const Comando& comando) {
+        AsyncWebSocketClient* client;
+        bool lHayCliente = clienteDeOrden(comando, client);                 // Sin cliente la orden se aplica igual
+        auto responde = [&](const String& mensaje) {                        // Errores y consultas: solo a quien la pidió
+            if (lHayCliente) enviaCliente(client, mensaje);
+        };
+        const OrdenAlarma* pOrden = static_cast<const OrdenAlarma*>(comando.pDatos);
+        const ExcepcionAlarma* pExcepcion = static_cast<const ExcepcionAlarma*>(comando.pDatos);
+        int id = (int)comando.valor;
+
+        switch (comando.tipo) {
+            case CMD_ALARMA_ADD: {
+                uint16_t idx = Alarmas.addPersonalizable(pOrden->nombre, pOrden->descripcion, pOrden->mascaraDias,
+                                                        pOrden->hora, pOrden->minuto, pOrden->tipo, pOrden->parametro,
+                                                        pOrden->accion, pOrden->habilitada, pOrden->cron, pOrden->fiesta,
+                                                        pOrden->desplazamientoDias, pOrden->recuperacion, pOrden->margenRecuperacion);
+                if (idx < AlarmScheduler::MAX_ALARMAS) {
+                    enviaTodos("ALARMA_CREADA_WEB:" + String(Alarmas.get(idx)->idWeb));
+                } else {
+                    responde("ERROR_ALARMA_WEB:Máximo de alarmas alcanzado");
+                }
+                break;
+            }
+            case CMD_ALARMA_EDIT:
+                if (Alarmas.modificarPersonalizable(pOrden->idWeb, pOrden->nombre, pOrden->descripcion, pOrden->mascaraDias,
+                                                    pOrden->hora, pOrden->minuto, pOrden->tipo, pOrden->habilitada,
+                                                    pOrden->accion, pOrden->parametro, pOrden->cron, pOrden->fiesta,
+                                                    pOrden->desplazamientoDias, pOrden->recuperacion, pOrden->margenRecuperacion)) {
+                    enviaTodos("ALARMA_MODIFICADA_WEB:" + String(pOrden->idWeb));
+                    DBG_SRV("✅ Alarma modificada con callback reasignado");
+                } else {
+                    responde("ERROR_ALARMA_WEB:No se pudo modificar");
+                }
+                break;
+            case CMD_ALARMA_DELETE:
+                if (Alarmas.eliminarPersonalizable(id)) {
+                    enviaTodos("ALARMA_ELIMINADA_WEB:" + String(id));
+                } else {
+                    responde("ERROR_ALARMA_WEB:No se pudo eliminar");
+                }
+                break;
+            case CMD_ALARMA_HABILITA:
+                if (Alarmas.habilitarPersonalizable(id, comando.parametro != 0)) {
+                    enviaTodos("ALARMA_TOGGLED_WEB:" + String(id) + ":" + (comando.parametro ? "true" : "false"));
+                }
+                break;
+            case CMD_EXCEPCION_ADD:
+                if (Alarmas.addExcepcion(*pExcepcion)) {
+                    enviaTodos("EXCEPCION_CREADA_WEB:" + String(pExcepcion->idWeb));
+                } else {
+                    responde("ERROR_ALARMA_WEB:No se pudo crear la excepción");
+                }
+                break;
+            case CMD_EXCEPCION_DELETE:
+                if (Alarmas.eliminarExcepcion(pExcepcion->idWeb, pExcepcion->fecha)) {
+                    enviaTodos("EXCEPCION_ELIMINADA_WEB:" + String(pExcepcion->idWeb));
+                } else {
+                    responde("ERROR_ALARMA_WEB:No se pudo eliminar la excepción");
+                }
+                break;
+            case CMD_ALARMA_CONSULTA:
+                if (!lHayCliente) break;                                    // Nadie espera el listado: no se calcula
+                switch (comando.parametro) {
+                    case CONSULTA_ALARMAS:      responde("ALARMAS_WEB:" + Alarmas.obtenerPersonalizablesJSON()); break;
+                    case CONSULTA_ESTADISTICAS: responde("STATS_ALARMAS_WEB:" + Alarmas.obtenerEstadisticasJSON()); break;
+                    case CONSULTA_EXCEPCIONES:  responde("EXCEPCIONES_ALARMA_WEB:" + Alarmas.obtenerExcepcionesJSON()); break;
+                    case CONSULTA_AGENDA:       responde("AGENDA:" + Alarmas.obtenerAgendaJSON((uint8_t)comando.valor)); break;  // Toques previstos, con excepciones y conflictos
+                }
+                break;
+            default:
+                break;
+        }
+    }
+
+    /**
+    * @brief Responde a una consulta de estado (CMD_CONSULTA) desde loop()
+    * 
+    * @details El estado se lee en la misma tarea que lo modifica, entre dos
+    *          vueltas de loop(). Si el cliente ya no está no se calcula.
+    * 
+    * @param comando Orden sacada de la cola (parámetro = ConsultaEstado)
+    * 
+    * @warning **LOOP:** Solo desde ColaComandos::Atiende()
+    * 
+    * @since v2.2
+    * @author Julian Salas Bartolomé
+    */
+    void ejecutaConsulta(const Comando& comando) {
+        AsyncWebSocketClient* client;
+        if (!clienteDeOrden(comando, client)) return;
+        switch (comando.parametro) {
+            case CONSULTA_COLA_COMANDOS: enviaCliente(client, "COLA_COMANDOS:" + ColaComandos.GetEstadoJSON()); break;
+            case CONSULTA_ARBITRO:       enviaCliente(client, "ARBITRO:" + Arbitro.GetEstadoJSON()); break;
+            case CONSULTA_JITTER:        enviaCliente(client, "JITTER_CAMPANARIO:" + Campanario.GetJitterJSON()); break;
+            case CONSULTA_CAMPANAS:      enviaCliente(client, "CAMPANAS:" + Campanario.GetCampanasJSON()); break;
+            case CONSULTA_SECUENCIAS:    enviaCliente(client, "SECUENCIAS:" + Campanario.GetSecuenciasJSON()); break;
+        }
+    }
+
+    // === Configuración ===
+
+    static void comandoSetIdioma(AsyncWebSocketClient* client, const char* pDatos, size_t nDatos) {      // "SET_IDIOMA:<ca|es>"
+        DBG_SRV_PRINTF("🌍 Cambiando idioma a: %.*s", (int)nDatos, pDatos);
+        if (nDatos == 2 && (memcmp(pDatos, "ca", 2) == 0 || memcmp(pDatos, "es", 2) == 0)) {
+            String nuevoIdioma(pDatos, 2);
+            if (guardarIdiomaEnConfig(nuevoIdioma)) {
+                enviaTodos("IDIOMA_CAMBIADO:" + nuevoIdioma);                // Notificar a todos los clientes conectados
+                DBG_SRV("✅ Idioma guardado y notificado a todos los clientes");
+            } else {
+                enviaCliente(client, "ERROR_IDIOMA:No se pudo guardar");
+            }
+        } else {
+            enviaCliente(client, "ERROR_IDIOMA:Idioma no soportado");
+        }
+    }
+
+    static void comandoGetConfig(AsyncWebSocketClient* client, const char* pDatos, size_t nDatos) {
+        DBG_SRV("📋 Enviando configuración actual");
+        enviaCliente(client, "CONFIG_ACTUAL:" + obtenerConfiguracionJSON());
+    }
+
+    static void comandoGetIdioma(AsyncWebSocketClient* client, const char* pDatos, size_t nDatos) {
+        String idioma = cargarIdiomaDesdeConfig();
+        enviaCliente(client, "IDIOMA_ACTUAL:" + idioma);
+        DBG_SRV_PRINTF("📤 Enviando idioma actual: %s", idioma.c_str());
+    }
+
+    static void comandoSaveConfigTelegram(AsyncWebSocketClient* client, const char* pDatos, size_t nDatos) {  // "SAVE_CONFIG_TELEGRAM:<json>"
+        DBG_SRV_PRINTF("📱 Guardando configuración de Telegram: %.*s", (int)nDatos, pDatos);
+        if (guardarConfigTelegramEnSPIFFS(String(pDatos, nDatos))) {
+            enviaTodos("CONFIG_TELEGRAM_OK");
+            DBG_SRV("✅ Configuración de Telegram guardada correctamente");
+        } else {
+            enviaCliente(client, "CONFIG_TELEGRAM_ERROR");
+            DBG_SRV("❌ Error al guardar configuración de Telegram");
+        }
+    }
+
+    static void comandoGetConfigTelegram(AsyncWebSocketClient* client, const char* pDatos, size_t nDatos) {
+        String config = cargarConfigTelegramDesdeSPIFFS();
+        enviaCliente(client, "CONFIG_TELEGRAM:" + config);
+        DBG_SRV_PRINTF("📤 Enviando configuración de Telegram: %s", config.c_str());
+    }
+
+    static void comandoVerifyPin(AsyncWebSocketClient* client, const char* pDatos, size_t nDatos) {      // "VERIFY_PIN:<pin>"
+        DBG_SRV_PRINTF("🔐 Verificando PIN recibido: %.*s", (int)nDatos, pDatos);
+        if (verificarPinAcceso(String(pDatos, nDatos))) {
+            enviaCliente(client, "PIN_OK");
+            DBG_SRV("✅ PIN correcto");
+        } else {
+            enviaCliente(client, "PIN_ERROR");
+            DBG_SRV("❌ PIN incorrecto");
+        }
+    }
+
+    // === Actualización OTA y sistema ===
+
+    static void comandoGetVersionOTA(AsyncWebSocketClient* client, const char* pDatos, size_t nDatos) {
+        enviaCliente(client, "VERSION_OTA:" + String(Config::OTA::FIRMWARE_VERSION)); // Enviar versión actual del firmware
+        DBG_SRV_PRINTF("📤 Versión actual enviada: %s", Config::OTA::FIRMWARE_VERSION.c_str());
+    }
+
+    static void comandoCheckUpdateOTA(AsyncWebSocketClient* client, const char* pDatos, size_t nDatos) {
+        DBG_SRV("🔍 Comprobando actualizaciones OTA...");
+        VersionInfo versionInfo = OTA.checkForUpdates();
+
+        if (versionInfo.newVersionAvailable) {
+            String respuesta = "UPDATE_AVAILABLE:" +                         // Enviar información de actualización disponible
+                             versionInfo.latestVersion + ":" +
+                             versionInfo.firmwareUrl + ":" +
+                             versionInfo.spiffsUrl + ":" +
+                             versionInfo.releaseNotes;
+            enviaCliente(client, respuesta);
+            DBG_SRV_PRINTF("✅ Nueva versión disponible: %s", versionInfo.latestVersion.c_str());
+        } else {
+            enviaCliente(client, "NO_UPDATE");
+            DBG_SRV("ℹ️ No hay actualizaciones disponibles");
+        }
+    }
+
+    enum TipoActualizacion : uint8_t { ACTUALIZA_FIRMWARE, ACTUALIZA_SPIFFS, ACTUALIZA_COMPLETA };
+
+    /**
+     * @brief Inicia una actualización OTA pedida desde la web
+     *
+     * @param client Cliente que la pidió (recibe el error si no hay versión nueva)
+     * @param tipo Firmware, SPIFFS o completa (asíncrona)
+     */
+    static void iniciaActualizacionOTA(AsyncWebSocketClient* client, TipoActualizacion tipo) {
+        DBG_SRV_PRINTF("🚀 Iniciando actualización OTA: %u", tipo);
+
+        VersionInfo versionInfo = OTA.checkForUpdates();                    // Primero comprobar qué versión hay disponible
+        if (!versionInfo.newVersionAvailable) {
+            enviaCliente(client, "OTA_ERROR:No hay actualizaciones disponibles");
+            DBG_SRV("❌ No hay actualizaciones para instalar");
+            return;
+        }
+
+        // Configurar callbacks antes de actualizar
+        OTA.setProgressCallback([](int progress, const char* message) {
+            String msg = "OTA_PROGRESS:" + String(progress) + ":" + String(message ? message : "");
+            ws.textAll(msg);
+            DBG_OTA_PRINTF("📊 Progreso: %d%% - %s", progress, message ? message : "");
+        });
+
+        OTA.setErrorCallback([](const char* error) {
+            String msg = "OTA_ERROR:" + String(error ? error : "Error desconocido");
+            ws.textAll(msg);
+            DBG_OTA_PRINTF("❌ Error: %s", error ? error : "Error desconocido");
+        });
+
+        OTA.setSuccessCallback([](const char* version) {
+            String msg = "OTA_SUCCESS:" + String(version ? version : "");
+            ws.textAll(msg);
+            DBG_OTA_PRINTF("✅ Actualización completada: %s", version ? version : "");
+        });
+
+        bool resultado = false;
+
+        if (tipo == ACTUALIZA_FIRMWARE) {
+            enviaTodos("OTA_PROGRESS:0:Descargando firmware...");
+            resultado = OTA.updateFirmware(versionInfo.firmwareUrl, versionInfo.firmwareSize);
+            if (resultado) {
+                enviaTodos("OTA_SUCCESS:" + versionInfo.latestVersion);      // Enviar éxito ANTES de reiniciar
+                DBG_SRV_PRINTF("✅ Firmware actualizado a v%s. Reiniciando...", versionInfo.latestVersion.c_str());
+                delay(2000);                                                // Dar tiempo para que el mensaje llegue al cliente
+                ESP.restart();
+            }
+        } else if (tipo == ACTUALIZA_SPIFFS) {
+            enviaTodos("OTA_PROGRESS:0:Descargando SPIFFS...");
+            resultado = OTA.updateSPIFFS(versionInfo.spiffsUrl, versionInfo.spiffsSize);
+            if (resultado) {
+                enviaTodos("OTA_SUCCESS:" + versionInfo.latestVersion);
+                DBG_SRV("✅ SPIFFS actualizado. Reiniciando...");
+                delay(2000);
+                ESP.restart();
+            }
+        } else {
+            enviaTodos("OTA_PROGRESS:0:Iniciando actualización completa...");  // Asíncrona: no bloquea el WebSocket
+            OTA.performFullUpdateAsync(versionInfo);
+            resultado = true;                                               // La tarea se ejecuta en segundo plano
+        }
+
+        if (resultado) {
+            DBG_SRV("✅ Actualización iniciada correctamente");
+        } else {
+            enviaTodos("OTA_ERROR:Error al iniciar la actualización");
+            DBG_SRV("❌ Error al iniciar actualización OTA");
+        }
+    }
+
+    static void comandoUpdateFirmware(AsyncWebSocketClient* client, const char* pDatos, size_t nDatos) { iniciaActualizacionOTA(client, ACTUALIZA_FIRMWARE); }
+    static void comandoUpdateSpiffs(AsyncWebSocketClient* client, const char* pDatos, size_t nDatos)   { iniciaActualizacionOTA(client, ACTUALIZA_SPIFFS); }
+    static void comandoUpdateCompleta(AsyncWebSocketClient* client, const char* pDatos, size_t nDatos) { iniciaActualizacionOTA(client, ACTUALIZA_COMPLETA); }
+
+    static void comandoResetSystem(AsyncWebSocketClient* client, const char* pDatos, size_t nDatos) {
+        DBG_SRV("🔄 Reinicio del sistema solicitado por el usuario");
+        enviaTodos("RESET_OK");
+        delay(500);                                                         // Dar tiempo para enviar la respuesta
+        ESP.restart();
+    }
+
+    // Registro de comandos: para añadir uno basta una línea aquí
+    static const ComandoWebSocket COMANDOS_WS[] = {
+        { "Difuntos",                    comandoDifuntos },
+        { "Misa",                        comandoMisa },
+        { "Fiesta",                      comandoFiesta },
+        { "PARAR",                       comandoParar },
+        { "EMERGENCIA",                  comandoEmergencia },
+        { "SECUENCIA",                   comandoSecuencia },
+        { "CALEFACCION_ON",              comandoCalefaccionOn },
+        { "CALEFACCION_OFF",             comandoCalefaccionOff },
+        { "GET_ARBITRO",                 comandoGetArbitro },
+        { "GET_COLA_COMANDOS",           comandoGetColaComandos },
+        { "GET_AGENDA",                  comandoGetAgenda },
+        { "GET_CALEFACCION",             comandoGetCalefaccion },
+        { "GET_TIEMPOCALEFACCION",       comandoGetTiempoCalefaccion },
+        { "GET_CAMPANARIO",              comandoGetCampanario },
+        { "GET_JITTER_CAMPANARIO",       comandoGetJitter },
+        { "RESET_JITTER_CAMPANARIO",     comandoResetJitter },
+        { "GET_CAMPANAS",                comandoGetCampanas },
+        { "GET_SECUENCIAS",              comandoGetSecuencias },
+        { "GET_SECUENCIA_ACTIVA",        comandoGetSecuenciaActiva },
+        { "GET_TRAFICO_WS",              comandoGetTraficoWs },
+        { "PROTOCOLO",                   comandoProtocolo },
+        { "SET_PULSO_CAMPANA",           comandoSetPulsoCampana },
+        { "PROBAR_CAMPANA",              comandoProbarCampana },
+        { "ADD_ALARMA_WEB",              comandoAddAlarma },
+        { "EDIT_ALARMA_WEB",             comandoEditAlarma },
+        { "DELETE_ALARMA_WEB",           comandoDeleteAlarma },
+        { "TOGGLE_ALARMA_WEB",           comandoToggleAlarma },
+        { "GET_ALARMAS_WEB",             comandoGetAlarmas },
+        { "GET_STATS_ALARMAS_WEB",       comandoGetStatsAlarmas },
+        { "ADD_EXCEPCION_ALARMA_WEB",    comandoAddExcepcion },
+        { "DELETE_EXCEPCION_ALARMA_WEB", comandoDeleteExcepcion },
+        { "GET_EXCEPCIONES_ALARMA_WEB",  comandoGetExcepciones },
+        { "SET_IDIOMA",                  comandoSetIdioma },
+        { "GET_CONFIG",                  comandoGetConfig },
+        { "GET_IDIOMA",                  comandoGetIdioma },
+        { "SAVE_CONFIG_TELEGRAM",        comandoSaveConfigTelegram },
+        { "GET_CONFIG_TELEGRAM",         comandoGetConfigTelegram },
+        { "VERIFY_PIN",                  comandoVerifyPin },
+        { "GET_VERSION_OTA",             comandoGetVersionOTA },
+        { "CHECK_UPDATE_OTA",            comandoCheckUpdateOTA },
+        { "START_UPDATE_FIRMWARE",       comandoUpdateFirmware },
+        { "START_UPDATE_SPIFFS",         comandoUpdateSpiffs },
+        { "START_UPDATE_COMPLETE",       comandoUpdateCompleta },
+        { "RESET_SYSTEM",                comandoResetSystem },
+    };
+    static constexpr uint8_t NUM_COMANDOS_WS = sizeof(COMANDOS_WS) / sizeof(COMANDOS_WS[0]);
+    static_assert(NUM_COMANDOS_WS * 2 <= Config::WebSocket::TAM_TABLA_COMANDOS, "La tabla de comandos debe quedar al menos a medias");
+
+  /**
+   * @brief Construye la tabla hash de comandos WebSocket
+   * 
+   * @details Direccionamiento abierto con sondeo lineal sobre
+   *          aTablaComandos, igual que la tabla de secuencias del campanario.
+   *          Se llama una vez desde ServidorOn(), antes de registrar onEvent().
+   * 
+   * @since v2.2
+   * @author Julian Salas Bartolomé
+   */
+    void registraComandosWebSocket(void) {
+        constexpr uint16_t MASCARA = Config::WebSocket::TAM_TABLA_COMANDOS - 1;
+        memset(aTablaComandos, 0, sizeof(aTablaComandos));
+        for (uint8_t n = 0; n < NUM_COMANDOS_WS; ++n) {
+            uint16_t h = hashComando(COMANDOS_WS[n].nombre, strlen(COMANDOS_WS[n].nombre)) & MASCARA;
+            while (aTablaComandos[h] != 0) h = (h + 1) & MASCARA;           // Nunca se llena (static_assert)
+            aTablaComandos[h] = n + 1;
+        }
+        DBG_SRV_PRINTF("Comandos WebSocket registrados: %u", NUM_COMANDOS_WS);
+    }
+
+  /**
+   * @brief Busca el manejador de un token de comando
+   * 
+   * @param pToken Token (sin terminador)
+   * @param nToken Longitud del token
+   * @return Manejador, o nullptr si el comando no existe
+   * 
+   * @note **O(1):** Un hash y, casi siempre, una sola comparación de nombre
+   * 
+   * @since v2.2
+   * @author Julian Salas Bartolomé
+   */
+    ManejadorComando buscaComando(const char* pToken, size_t nToken) {
+        constexpr uint16_t MASCARA = Config::WebSocket::TAM_TABLA_COMANDOS - 1;
+        for (uint16_t i = 0, h = hashComando(pToken, nToken) & MASCARA; i < Config::WebSocket::TAM_TABLA_COMANDOS; ++i, h = (h + 1) & MASCARA) {
+            uint8_t n = aTablaComandos[h];
+            if (n == 0) return nullptr;
+            const char* nombre = COMANDOS_WS[n - 1].nombre;
+            if (strncmp(nombre, pToken, nToken) == 0 && nombre[nToken] == '\0') return COMANDOS_WS[n - 1].manejador;
+        }
+        return nullptr;
+    }
+
   /**
    * @brief Procesa mensajes recibidos por WebSocket
    * 
-   * @details Función especializada que analiza y ejecuta los comandos
-   *          recibidos a través del WebSocket desde clientes web.
+   * @details Separa el token del comando (hasta el primer ':') y llama a su
+   *          manejador a través de la tabla hash de comandos. Los datos se
+   *          pasan como puntero y longitud dentro de data, sin copiarlos.
    *          
    *          **COMANDOS PROCESADOS:**
-   *          - Comandos de control del campanario
-   *                - "Difuntos": Inicia la secuencia de campanadas para difuntos y redirige a los clientes a la pantalla de campanas.
-   *                - "Misa": Inicia la secuencia de campanadas para misa y redirige a los clientes a la pantalla de campanas.
-   *                - "PARAR": Detiene cualquier secuencia de campanadas en curso y redirige a los clientes a la pantalla principal.
-   *                - "CALEFACCION_ON": Enciende la calefacción y notifica a los clientes el nuevo estado.
+   *          - Comandos de control del campanario (los toques se presentan al árbitro con prioridad manual)
+   *                - "Difuntos", "Misa", "Fiesta": Inicia la secuencia y redirige a los clientes a la pantalla de campanas.
+   *                - "PARAR": Pide al árbitro la parada de la secuencia en curso y de las peticiones en espera.
+   *                - "EMERGENCIA:<nombre>": Toca una secuencia de la biblioteca con prioridad de emergencia (rebato).
+   *                - "CALEFACCION_ON:<minutos>": Enciende la calefacción y notifica a los clientes el nuevo estado.
    *                - "CALEFACCION_OFF": Apaga la calefacción y notifica a los clientes el nuevo estado.
    *          - Solicitudes de estado del sistema
-   *                - "GET_CALEFACCION": Envía a los clientes el estado actual de la calefacción.
-   *                - "GET_CAMPANARIO": Envía a los clientes el estado actual del campanario.
-   *          - Configuración de parámetros
+   *                - "GET_CALEFACCION": Envía al cliente el estado actual de la calefacción.
+   *                - "GET_CAMPANARIO": Envía al cliente el estado actual del campanario (TRAMA_ESTADO si ha negociado el binario).
+   *                - "GET_JITTER_CAMPANARIO" / "RESET_JITTER_CAMPANARIO": Histograma de retraso de los toques.
+   *                - "GET_SECUENCIAS": Envía la biblioteca de secuencias cargadas desde Secuencias.json.
+   *                - "GET_CAMPANAS": Envía pulso, reposo y último pulso medido de cada campana.
+   *                - "GET_ARBITRO": Envía el toque en curso, la cola de espera y el registro de decisiones del árbitro.
+   *                - "GET_COLA_COMANDOS": Envía órdenes, perdidas y latencia de la cola hacia loop() por origen.
+   *                - "GET_AGENDA[:<días>]": Envía los toques previstos (alarmas, horas y medias) de los próximos días.
+   *                - "GET_TRAFICO_WS": Envía los bytes y mensajes enviados a cada cliente conectado.
+   *                - "PROTOCOLO:<v>": Negocia las tramas binarias de estado (TramaEstado); responde "PROTOCOLO:<v aceptada>".
+   *          - Calibración de campanas
+   *                - "SET_PULSO_CAMPANA:<n>:<ms>": Ajusta en caliente el pulso de la campana n.
+   *                - "PROBAR_CAMPANA:<n>": Toque de prueba de la campana n (fuera de secuencias).
+   *          - Alarmas personalizables: "*_ALARMA_WEB" y "*_EXCEPCION_ALARMA_WEB"
+   *          - Configuración, idioma, Telegram, PIN, OTA y reinicio
    *          - Ejecución de secuencias de toques
+   *                - "SECUENCIA:<nombre>": Inicia cualquier secuencia de la biblioteca por su nombre.
    * 
+   * @param client Cliente que envió el mensaje (recibe las respuestas a consultas y los errores)
    * @param arg Argumento adicional del mensaje WebSocket
    * @param data Puntero a los datos del mensaje recibido
    * @param len Longitud en bytes de los datos del mensaje
    * 
    * @note Llamada automáticamente por onEvent() cuando type == WS_EVT_DATA
-   * @note Interpreta datos como texto JSON o comandos de texto plano
-   * @note Ejecuta acciones sobre el objeto Campanario según el comando
-   * @note Envía respuestas de confirmación a todos los clientes conectados
+   * @note Las consultas se responden solo a client; los cambios de estado van a todos
+   * @note Para añadir un comando: un manejador y una línea en COMANDOS_WS
    * 
-   * @warning Valida todas las entradas antes de ejecutar comandos
-   * @warning Los datos recibidos pueden no estar null-terminated
+   * @warning Los datos recibidos pueden no estar null-terminated: los manejadores usan la longitud
    * 
    * @see onEvent() - Función que llama a esta cuando hay datos
-   * @see Campanario - Objeto utilizado para ejecutar comandos
-   * @see ws.textAll() - Para enviar respuestas a todos los clientes
+   * @see registraComandosWebSocket() - Construye la tabla de comandos
    * 
    * @since v2.0
    * @author Julian Salas Bartolomé
    */
-    void procesaMensajeWebSocket(void *arg, uint8_t *data, size_t len)
+    void procesaMensajeWebSocket(AsyncWebSocketClient *client, void *arg, uint8_t *data, size_t len)
     {
-        String mensaje = String((const char*)data).substring(0, len);       // Convierte los datos a String
-        DBG_SRV(" ");
-        DBG_SRV_PRINTF("procesaMensajeWebSocket -> Mensaje recibido: %s\n", mensaje);
-        DBG_SRV(" ");
-        //switch para procesar el mensaje recibido
-        if (mensaje == "Difuntos") {                                        // Si el mensaje es "Difuntos"
-            nToque = Config::States::DIFUNTOS;                              // Establece la secuencia a EstadoDifuntos para tocar difuntos
-            ws.textAll("REDIRECT:/Campanas.html");                          // Indica a los clientes que deben redirigir a la pantalla de presentacion de las campanas
-            DBG_SRV("Procesando mensaje: TocaDifuntos");
-/*
-            if (telegramBot.isEnabled() && Config::Telegram::NOTIFICACION_DIFUNTOS) {
-                telegramBot.sendSequenceNotification("Difuntos", Config::Telegram::METODO_ACTIVACION_WEB);
-            }
-*/
-        } else if (mensaje == "Misa") {                                     // Si el mensaje es "Misa"
-            nToque = Config::States::MISA;                                  // Establece la secuencia a Misa para tocar misa
-            ws.textAll("REDIRECT:/Campanas.html");                          // Indica a los clientes que deben redirigir a la pantalla de presentacion de las campanas
-            DBG_SRV("Procesando mensaje: TocaMisa");
-/*
-            if (telegramBot.isEnabled() && Config::Telegram::NOTIFICACION_MISA) {
-                telegramBot.sendSequenceNotification("Misa", Config::Telegram::METODO_ACTIVACION_WEB);
-            }   
-*/
-        } else if (mensaje == "Fiesta") {                                   // Si el mensaje es "Fiesta"
-            nToque = Config::States::FIESTA;                                // Establece la secuencia a Fiesta para tocar fiesta
-            ws.textAll("REDIRECT:/Campanas.html");                          // Indica a los clientes que deben redirigir a la pantalla de presentacion de las campanas
-            DBG_SRV("Procesando mensaje: TocaFiesta");
-/*
-
-                telegramBot.sendSequenceNotification("Fiesta", Config::Telegram::METODO_ACTIVACION_WEB);
-            }
-*/
-        } else if (mensaje == "PARAR") {                                    // Si el mensaje es "PARAR"  
-            nToque = 0;                                                     // Parada la secuencia de toques
-            Campanario.ParaSecuencia();                                     // Detiene la secuencia de campanadas
-            ws.textAll("REDIRECT:/index.html");                             // Indica a los clientes que deben redirigir
-            DBG_SRV("Procesando mensaje: Parar");
-            if (telegramBot.isEnabled() && Config::Telegram::NOTIFICACION_STOP) {
-                telegramBot.sendStopNotification(Config::Telegram::METODO_ACTIVACION_WEB);
-            }
-        } else if (mensaje.startsWith("CALEFACCION_ON:")) {                 // Si el mensaje comienza con "CALEFACCION_ON:"
-            String minutosStr = mensaje.substring(15);                      // Extrae los minutos después de "CALEFACCION_ON:"
-            int minutos = minutosStr.toInt();                               // Convierte la cadena de minutos a entero
-            if (minutos < 0 || minutos >  Config::Heating::MAX_MINUTES) {   // Validación del rango de minutos
-                minutos = 0;                                                // Si está fuera del rango, establece a 0
-                DBG_SRV_PRINTF("Minutos fuera de rango, establecido a 0. Valor recibido: %s\n", minutosStr.c_str());
-            }
-            Campanario.EnciendeCalefaccion(minutos);                        // Enciende la calefacción
-            ws.textAll("CALEFACCION:ON:" + String(minutos));                // Envía el estado con los minutos programados
-            DBG_SRV_PRINTF("Procesando mensaje: Calefacción ON por %d minutos\n", minutos);
-            if (telegramBot.isEnabled() && Config::Telegram::NOTIFICACION_CALEFACCION_ON) {
-                telegramBot.sendCalefaccionOnNotification(Config::Telegram::METODO_ACTIVACION_WEB);
-            }
+        const char* pMensaje = (const char*)data;
+        const char* pSeparador = (const char*)memchr(pMensaje, ':', len);
+        size_t nToken = pSeparador ? (size_t)(pSeparador - pMensaje) : len;
+        DBG_SRV_PRINTF("procesaMensajeWebSocket -> Mensaje recibido: %.*s\n", (int)len, pMensaje);
 
-            
-        } else if (mensaje == "CALEFACCION_OFF") {                          // Si el mensaje es "CALEFACCION_OFF"
-            Campanario.ApagaCalefaccion();                                  // Apaga la calefacción
-            ws.textAll("CALEFACCION:OFF");                                  // Envía el estado de la calefacción a todos los clientes conectados
-            DBG_SRV("Procesando mensaje: Calefacción OFF");
-            if (telegramBot.isEnabled() && Config::Telegram::NOTIFICACION_CALEFACCION_OFF) {
-                telegramBot.sendCalefaccionOffNotification(Config::Telegram::METODO_ACTIVACION_WEB);
-            }
-        } else if (mensaje == "GET_CALEFACCION") {                          // Si el mensaje es "GET_CALEFACCION"
-            String estadoCalefaccion = Campanario.GetEstadoCalefaccion() ? "ON" : "OFF"; // Enviar el estado de la calefacción a todos los clientes conectados
-            ws.textAll("ESTADO_CALEFACCION:" + estadoCalefaccion);          // Envía el estado de la calefacción a todos los clientes conectados
-            DBG_SRV_PRINTF("Estado de la calefacción enviado: %s\n", estadoCalefaccion.c_str());
-        } else if (mensaje == "GET_TIEMPOCALEFACCION") {                    // Si el mensaje es "GET_TIEMPOCALEFACCION"
-            String tiempoCalefaccion = String(Campanario.TestTemporizacionCalefaccion());
-            ws.textAll("TIEMPO_CALEFACCION:" + tiempoCalefaccion);          // Envía el tiempo de calefacción al cliente que lo pidió
-        } else if (mensaje == "GET_CAMPANARIO") {                           // Si el mensaje es "GET_CAMPANARIO"  
-            String EstadoCampanario = String(Campanario.GetEstadoCampanario()); // Obtiene el estado del campanario 
-            ws.textAll("ESTADO_CAMPANARIO:" + EstadoCampanario);            // Envía el estado al cliente que lo pidió
-        }else if (mensaje== "GET_SECUENCIA_ACTIVA") {                       // Si el mensaje es "GET_SECUENCIA"  
-            String secuenciaActiva = String(Campanario.GetSecuenciaActiva());  // Obtiene la secuencia actual
-            ws.textAll("SECUENCIAACTIVA:" + secuenciaActiva);               // Envía la secuencia al cliente que lo pidió    ---- NO UTILIZADO EN ESTA VERSION ----
-        }else if (mensaje.startsWith("ADD_ALARMA_WEB:") || 
-         mensaje.startsWith("EDIT_ALARMA_WEB:") || 
-         mensaje.startsWith("DELETE_ALARMA_WEB:") || 
-         mensaje.startsWith("TOGGLE_ALARMA_WEB:") || 
-         mensaje == "GET_ALARMAS_WEB" || 
-         mensaje == "GET_STATS_ALARMAS_WEB") {
-        // Separar comando y datos
-            int separador = mensaje.indexOf(':');
-            String comando = (separador > 0) ? mensaje.substring(0, separador) : mensaje;
-            String datos = (separador > 0) ? mensaje.substring(separador + 1) : "{}";
-            procesarComandoAlarma(nullptr, comando, datos);
-        } else if (mensaje.startsWith("SET_IDIOMA:")) {
-            String nuevoIdioma = mensaje.substring(11);
-            DBG_SRV_PRINTF("🌍 Cambiando idioma a: %s", nuevoIdioma.c_str());
-
-            if (nuevoIdioma == "ca" || nuevoIdioma == "es") {
-                if (guardarIdiomaEnConfig(nuevoIdioma)) {
-                    // Notificar a todos los clientes conectados
-                    ws.textAll("IDIOMA_CAMBIADO:" + nuevoIdioma);
-                    DBG_SRV("✅ Idioma guardado y notificado a todos los clientes");
-                } else {
-                    ws.textAll("ERROR_IDIOMA:No se pudo guardar");
-                }
-            } else {
-                ws.textAll("ERROR_IDIOMA:Idioma no soportado");
-            }
-
-        } else if (mensaje == "GET_CONFIG") {
-            DBG_SRV("📋 Enviando configuración actual");
-            String config = obtenerConfiguracionJSON();
-            ws.textAll("CONFIG_ACTUAL:" + config);
-
-        } else if (mensaje == "GET_IDIOMA") {
-            String idioma = cargarIdiomaDesdeConfig();
-            ws.textAll("IDIOMA_ACTUAL:" + idioma);
-            DBG_SRV_PRINTF("📤 Enviando idioma actual: %s", idioma.c_str());
-        
-        } else if (mensaje.startsWith("SAVE_CONFIG_TELEGRAM:")) {
-            String jsonConfig = mensaje.substring(21); // Extraer JSON después de "SAVE_CONFIG_TELEGRAM:"
-            DBG_SRV_PRINTF("📱 Guardando configuración de Telegram: %s", jsonConfig.c_str());
-            
-            if (guardarConfigTelegramEnSPIFFS(jsonConfig)) {
-                ws.textAll("CONFIG_TELEGRAM_OK");
-                DBG_SRV("✅ Configuración de Telegram guardada correctamente");
-            } else {
-                ws.textAll("CONFIG_TELEGRAM_ERROR");
-                DBG_SRV("❌ Error al guardar configuración de Telegram");
-            }
-        
-        } else if (mensaje == "GET_CONFIG_TELEGRAM") {
-            String config = cargarConfigTelegramDesdeSPIFFS();
-            ws.textAll("CONFIG_TELEGRAM:" + config);
-            DBG_SRV_PRINTF("📤 Enviando configuración de Telegram: %s", config.c_str());
-        
-        } else if (mensaje.startsWith("VERIFY_PIN:")) {
-            String pin = mensaje.substring(11); // Extraer PIN después de "VERIFY_PIN:"
-            DBG_SRV_PRINTF("🔐 Verificando PIN recibido: %s", pin.c_str());
-            
-            if (verificarPinAcceso(pin)) {
-                ws.textAll("PIN_OK");
-                DBG_SRV("✅ PIN correcto");
-            } else {
-                ws.textAll("PIN_ERROR");
-                DBG_SRV("❌ PIN incorrecto");
-            }
-        
-        } else if (mensaje == "GET_VERSION_OTA") {
-            // Enviar versión actual del firmware
-            ws.textAll("VERSION_OTA:" + String(Config::OTA::FIRMWARE_VERSION));
-            DBG_SRV_PRINTF("📤 Versión actual enviada: %s", Config::OTA::FIRMWARE_VERSION);
-        
-        } else if (mensaje == "CHECK_UPDATE_OTA") {
-            // Comprobar si hay actualizaciones disponibles
-            DBG_SRV("🔍 Comprobando actualizaciones OTA...");
-            
-            VersionInfo versionInfo = OTA.checkForUpdates();
-            
-            if (versionInfo.newVersionAvailable) {
-                // Enviar información de actualización disponible
-                String respuesta = "UPDATE_AVAILABLE:" + 
-                                 versionInfo.latestVersion + ":" +
-                                 versionInfo.firmwareUrl + ":" +
-                                 versionInfo.spiffsUrl + ":" +
-                                 versionInfo.releaseNotes;
-                ws.textAll(respuesta);
-                DBG_SRV_PRINTF("✅ Nueva versión disponible: %s", versionInfo.latestVersion.c_str());
-            } else {
-                ws.textAll("NO_UPDATE");
-                DBG_SRV("ℹ️ No hay actualizaciones disponibles");
-            }
-        
-        } else if (mensaje == "START_UPDATE_FIRMWARE" || mensaje == "START_UPDATE_SPIFFS" || mensaje == "START_UPDATE_COMPLETE") {
-            // Iniciar proceso de actualización OTA
-            DBG_SRV_PRINTF("🚀 Iniciando actualización OTA: %s", mensaje.c_str());
-            
-            // Primero comprobar qué versión hay disponible
-            VersionInfo versionInfo = OTA.checkForUpdates();
-            
-            if (!versionInfo.newVersionAvailable) {
-                ws.textAll("OTA_ERROR:No hay actualizaciones disponibles");
-                DBG_SRV("❌ No hay actualizaciones para instalar");
-            } else {
-                // Configurar callbacks antes de actualizar
-                OTA.setProgressCallback([](int progress, const char* message) {
-                    String msg = "OTA_PROGRESS:" + String(progress) + ":" + String(message ? message : "");
-                    ws.textAll(msg);
-                    DBG_OTA_PRINTF("📊 Progreso: %d%% - %s", progress, message ? message : "");
-                });
-                
-                OTA.setErrorCallback([](const char* error) {
-                    String msg = "OTA_ERROR:" + String(error ? error : "Error desconocido");
-                    ws.textAll(msg);
-                    DBG_OTA_PRINTF("❌ Error: %s", error ? error : "Error desconocido");
-                });
-                
-                OTA.setSuccessCallback([](const char* version) {
-                    String msg = "OTA_SUCCESS:" + String(version ? version : "");
-                    ws.textAll(msg);
-                    DBG_OTA_PRINTF("✅ Actualización completada: %s", version ? version : "");
-                });
-                
-                bool resultado = false;
-                
-                if (mensaje == "START_UPDATE_FIRMWARE") {
-                    // Solo actualizar firmware
-                    ws.textAll("OTA_PROGRESS:0:Descargando firmware...");
-                    resultado = OTA.updateFirmware(versionInfo.firmwareUrl, versionInfo.firmwareSize);
-                    
-                    if (resultado) {
-                        // Enviar éxito ANTES de reiniciar
-                        ws.textAll("OTA_SUCCESS:" + versionInfo.latestVersion);
-                        DBG_SRV_PRINTF("✅ Firmware actualizado a v%s. Reiniciando...", versionInfo.latestVersion.c_str());
-                        
-                        // Dar tiempo para que el mensaje llegue al cliente
-                        delay(2000);
-                        
-                        // Reiniciar ESP32
-                        ESP.restart();
-                    }
-                    
-                } else if (mensaje == "START_UPDATE_SPIFFS") {
-                    // Solo actualizar SPIFFS
-                    ws.textAll("OTA_PROGRESS:0:Descargando SPIFFS...");
-                    resultado = OTA.updateSPIFFS(versionInfo.spiffsUrl, versionInfo.spiffsSize);
-                    
-                    if (resultado) {
-                        // Enviar éxito ANTES de reiniciar
-                        ws.textAll("OTA_SUCCESS:" + versionInfo.latestVersion);
-                        DBG_SRV("✅ SPIFFS actualizado. Reiniciando...");
-                        
-                        // Dar tiempo para que el mensaje llegue al cliente
-                        delay(2000);
-                        
-                        // Reiniciar ESP32
-                        ESP.restart();
-                    }
-                    
-                } else if (mensaje == "START_UPDATE_COMPLETE") {
-                    // Actualización completa asíncrona (no bloquea WebSocket)
-                    ws.textAll("OTA_PROGRESS:0:Iniciando actualización completa...");
-                    OTA.performFullUpdateAsync(versionInfo);
-                    resultado = true;  // La tarea se ejecuta en segundo plano
-                }
-                
-                if (resultado) {
-                    DBG_SRV("✅ Actualización iniciada correctamente");
-                } else {
-                    ws.textAll("OTA_ERROR:Error al iniciar la actualización");
-                    DBG_SRV("❌ Error al iniciar actualización OTA");
-                }
-            }
-        
-        } else if (mensaje == "RESET_SYSTEM") {
-            // Reiniciar el sistema
-            DBG_SRV("🔄 Reinicio del sistema solicitado por el usuario");
-            ws.textAll("RESET_OK");
-            
-            // Dar tiempo para enviar la respuesta
-            delay(500);
-            
-            // Reiniciar ESP32
-            ESP.restart();
-        
+        ManejadorComando manejador = buscaComando(pMensaje, nToken);
+        if (manejador) {
+            manejador(client, pMensaje + nToken + (pSeparador ? 1 : 0), len - nToken - (pSeparador ? 1 : 0));
         } else {
-            nToque = 0; // Resetea la secuencia si el mensaje no es reconocido
-            DBG_SRV("Mensaje no reconocido, reseteando secuencia.");
+            DBG_SRV("Mensaje no reconocido.");
         }
     }    
-    /**
-    * @brief Procesa comandos específicos de gestión de alarmas personalizables
-    * 
-    * @details Función especializada que maneja todos los comandos relacionados
-    *          con alarmas personalizables recibidos a través del WebSocket.
-    *          
-    *          **COMANDOS PROCESADOS:**
-    *          - ADD_ALARMA_WEB: Crea nueva alarma personalizable con callback automático
-    *          - EDIT_ALARMA_WEB: Modifica alarma existente manteniendo callback original
-    *          - DELETE_ALARMA_WEB: Elimina alarma personalizable del sistema
-    *          - TOGGLE_ALARMA_WEB: Habilita/deshabilita alarma específica
-    *          - GET_ALARMAS_WEB: Obtiene listado completo de alarmas personalizables
-    *          - GET_STATS_ALARMAS_WEB: Obtiene estadísticas del sistema de alarmas
-    *          
-    *          **TIPOS DE ACCIÓN SOPORTADOS:**
-    *          - MISA: Configura callback accionSecuencia con parámetro MISA
-    *          - DIFUNTOS: Configura callback accionSecuencia con parámetro DIFUNTOS  
-    *          - FIESTA: Configura callback accionSecuencia con parámetro personalizado
-    *          
-    *          **PROCESO DE CREACIÓN:**
-    *          1. Deserializa datos JSON del comando
-    *          2. Determina callback y parámetro según tipo de acción
-    *          3. Convierte día web (0-7) a máscara de días del sistema
-    *          4. Llama a Alarmas.addPersonalizable() con parámetros procesados
-    *          5. Envía confirmación o error a todos los clientes WebSocket
-    * 
-    * @param client Puntero al cliente WebSocket que envió el comando (puede ser nullptr)
-    * @param comando String con el comando a procesar (ADD_ALARMA_WEB, EDIT_ALARMA_WEB, etc.)
-    * @param datos String con datos JSON del comando a procesar
-    * 
-    * @note Llamada automáticamente por procesaMensajeWebSocket() para comandos de alarmas
-    * @note Utiliza deserializeJson() para procesar datos de entrada
-    * @note Configura callbacks automáticamente según el tipo de acción
-    * @note Envía respuestas a TODOS los clientes conectados vía ws.textAll()
-    * 
-    * @warning Valida todos los datos JSON antes de procesar comandos
-    * @warning Los callbacks son configurados automáticamente, no personalizables por comando
-    * @warning Comando EDIT no modifica callbacks existentes por seguridad
-    * 
-    * @see procesaMensajeWebSocket() - Función que delega comandos de alarmas
-    * @see AlarmScheduler::addPersonalizable() - Método para crear alarmas
-    * @see AlarmScheduler::modificarPersonalizable() - Método para modificar alarmas
-    * @see AlarmScheduler::eliminarPersonalizable() - Método para eliminar alarmas
-    * @see convertirDiaAMascara() - Función auxiliar para conversión de días
-    * @see accionSecuencia() - Callback configurado automáticamente
-    * 
-    * @since v2.1 - Sistema de alarmas personalizables vía web
-    * @author Julian Salas Bartolomé
-    */
-    void procesarComandoAlarma(AsyncWebSocketClient *client, const String& comando, const String& datos) {
-        JsonDocument doc;
-        deserializeJson(doc, datos);
-           
-            if (comando == "ADD_ALARMA_WEB") {
-               // Determinar callback y parámetro según el tipo
-               String tipoAccion = doc["accion"] | "MISA";
-               void (*callback)(uint16_t) = nullptr;
-               uint16_t parametro = 0;
-
-               if (tipoAccion == "MISA") {
-                   callback = accionSecuencia;
-                   parametro = Config::States::I2CState::MISA;
-                   DBG_SRV("🔔 Configurando callback MISA");
-               } else if (tipoAccion == "DIFUNTOS") {
-                   callback = accionSecuencia;
-                   parametro = Config::States::I2CState::DIFUNTOS;
-                   DBG_SRV("🔔 Configurando callback DIFUNTOS");
-               } else if (tipoAccion == "FIESTA") {
-                   callback = accionSecuencia;
-                   parametro = Config::States::I2CState::FIESTA;
-                   DBG_SRV("🔔 Configurando callback FIESTA");
-               } else if (tipoAccion == "CALEFACCION") {
-                   callback = accionEnciendeCalefaccion;
-                   parametro = doc["duracion"] | 30;  // Duración en minutos (por defecto 30)
-                   DBG_SRV_PRINTF("🔥 Configurando callback CALEFACCION con %d minutos", parametro);
-               }
-
-               if (callback) {
-                   uint8_t idx = Alarmas.addPersonalizable(
-                       doc["nombre"] | "",
-                       doc["descripcion"] | "",
-                       convertirDiaAMascara(doc["dia"] | 0),
-                       doc["hora"] | 0,
-                       doc["minuto"] | 0,
-                       tipoAccion.c_str(),
-                       parametro,
-                       callback,
-                       doc["habilitada"] | true
-                   );
-
-                   if (idx < AlarmScheduler::MAX_ALARMAS) {
-                       ws.textAll("ALARMA_CREADA_WEB:" + String(Alarmas.get(idx)->idWeb));
-                   } else {
-                       ws.textAll("ERROR_ALARMA_WEB:Máximo de alarmas alcanzado");
-                   }
-               }   
-            } else if (comando == "EDIT_ALARMA_WEB") {
-                
-                String tipoAccion = doc["accion"] | "MISA";
-                void (*callback)(uint16_t) = nullptr;
-                uint16_t parametro = 0;
-            
-                if (tipoAccion == "MISA") {
-                    callback = accionSecuencia;
-                    parametro = Config::States::I2CState::MISA;
-                    DBG_SRV("🔧 Configurando callback MISA para edición");
-                } else if (tipoAccion == "DIFUNTOS") {
-                    callback = accionSecuencia;
-                    parametro = Config::States::I2CState::DIFUNTOS;
-                    DBG_SRV("🔧 Configurando callback DIFUNTOS para edición");
-                } else if (tipoAccion == "FIESTA") {
-                    callback = accionSecuencia;
-                    parametro = Config::States::I2CState::FIESTA;
-                    DBG_SRV("🔧 Configurando callback FIESTA para edición");
-                } else if (tipoAccion == "CALEFACCION") {
-                    callback = accionEnciendeCalefaccion;
-                    parametro = doc["duracion"] | 30;  // Duración en minutos (por defecto 30)
-                    DBG_SRV_PRINTF("🔥 Configurando callback CALEFACCION para edición con %d minutos", parametro);
-                }
-            
-                // ✅ VERIFICAR callback válido
-                if (callback == nullptr) {
-                    DBG_SRV_PRINTF("❌ ERROR: Callback es NULL para tipo '%s'", tipoAccion.c_str());
-                    ws.textAll("ERROR_ALARMA_WEB:Tipo de acción no válido");
-                    return;
-                }
-            
-                // ✅ LLAMAR con callback y parámetro (igual que ADD_ALARMA_WEB)
-                bool resultado = Alarmas.modificarPersonalizable(
-                    doc["id"] | -1,
-                    doc["nombre"] | "",
-                    doc["descripcion"] | "",
-                    convertirDiaAMascara(doc["dia"] | 0),
-                    doc["hora"] | 0,
-                    doc["minuto"] | 0,
-                    tipoAccion.c_str(),
-                    doc["habilitada"] | true,
-                    callback,      // ✅ PASAR CALLBACK
-                    parametro      // ✅ PASAR PARÁMETRO
-                );
-            
-                if (resultado) {
-                    ws.textAll("ALARMA_MODIFICADA_WEB:" + String(doc["id"] | -1));
-                    DBG_SRV("✅ Alarma modificada con callback reasignado");
-                } else {
-                    ws.textAll("ERROR_ALARMA_WEB:No se pudo modificar");
-                }
-            } else if (comando == "DELETE_ALARMA_WEB") {
-               int id = doc["id"] | -1;
-               if (Alarmas.eliminarPersonalizable(id)) {
-                   ws.textAll("ALARMA_ELIMINADA_WEB:" + String(id));
-               } else {
-                   ws.textAll("ERROR_ALARMA_WEB:No se pudo eliminar");
-               }
-           } else if (comando == "TOGGLE_ALARMA_WEB") {
-               int id = doc["id"] | -1;
-               bool estado = doc["habilitada"] | false;
-               if (Alarmas.habilitarPersonalizable(id, estado)) {
-                   ws.textAll("ALARMA_TOGGLED_WEB:" + String(id) + ":" + (estado ? "true" : "false"));
-               }
-           } else if (comando == "GET_ALARMAS_WEB") {
-               String jsonAlarmas = Alarmas.obtenerPersonalizablesJSON();
-               ws.textAll("ALARMAS_WEB:" + jsonAlarmas);
-           } else if (comando == "GET_STATS_ALARMAS_WEB") {
-               String jsonStats = Alarmas.obtenerEstadisticasJSON();
-               ws.textAll("STATS_ALARMAS_WEB:" + jsonStats);
-           }
-    }
     /**
      * @brief Convierte día web (0-7) a máscara de días del sistema de alarmas
      * 
@@ -822,14 +1535,14 @@
      * @retval uint8_t Máscara de bits compatible con sistema de alarmas
      * @retval DOW_TODOS Si día está fuera del rango válido (0-7)
      * 
-     * @note Utilizada internamente por procesarComandoAlarma()
+     * @note Utilizada internamente por comandoAddAlarma() y comandoEditAlarma()
      * @note Compatible con constantes DOW_* definidas en el sistema
      * @note Domingo se considera día 1 (no 0) en la numeración web
      * 
      * @warning Valores inválidos se convierten automáticamente a DOW_TODOS
      * @warning La numeración web difiere del estándar ISO (lunes = día 1)
      * 
-     * @see procesarComandoAlarma() - Función principal que utiliza esta conversión
+     * @see comandoAddAlarma() - Función principal que utiliza esta conversión
      * @see DOW_TODOS, DOW_DOMINGO, DOW_LUNES, etc. - Constantes del sistema
      * @see AlarmScheduler::addPersonalizable() - Recibe máscara convertida
      * 
@@ -59,7 +59,12 @@
  *       - **CONTROL:** TOGGLE_ALARMA_WEB, GET_ALARMAS_WEB, GET_STATS_ALARMAS_WEB
  *       - **CONFIGURACIÓN:** SET_IDIOMA, GET_CONFIG, GET_IDIOMA
  *       - **CAMPANARIO:** Comandos de control directo del sistema (heredados)
- *       - **RESPUESTAS:** Confirmaciones automáticas a todos los clientes conectados
+ *       - **RESPUESTAS:** Consultas y errores solo al cliente que las pide; cambios de estado a todos
+ *       - **TRÁFICO:** GET_TRAFICO_WS con los bytes enviados a cada cliente
+ *       - **BINARIO:** PROTOCOLO:<v> activa las tramas TramaEstado para estado y toques
+ * 
+ * @note **RECURSOS WEB:** html/js/css en .gz con ETag fuerte según /estaticos.json
+ *       (build-release.py); js/css con hash en el nombre y Cache-Control immutable
  * 
  * @note **ESTRUCTURA DE DATOS JSON:**
  *       - **Alarmas:** {"id", "nombre", "descripcion", "dia", "hora", "minuto", "accion", "habilitada"}
@@ -179,6 +184,8 @@
     
     #include "Campanario.h"
     #include "Alarmas.h" 
+    #include "Arbitro.h"
+    #include "ColaComandos.h"
     #include <ArduinoJson.h>
 
 
@@ -193,10 +200,36 @@
 
     extern CAMPANARIO Campanario;
 
+    // Trama binaria de estado (protocolo WebSocket v1, little-endian, 16 bytes).
+    // El cliente la pide con "PROTOCOLO:<versión>"; sin negociar recibe los mensajes de texto.
+    enum TipoTrama : uint8_t {
+        TRAMA_ESTADO = 1,                                                   // Respuesta a GET_CAMPANARIO
+        TRAMA_TOQUE  = 2                                                    // Un tiempo de la secuencia (sustituye a "CAMPANA:n")
+    };
+
+    struct __attribute__((packed)) TramaEstado {
+        uint8_t  version;                                                   // Versión del protocolo (Config::WebSocket::PROTOCOLO_BINARIO)
+        uint8_t  tipo;                                                      // TipoTrama
+        uint8_t  estado;                                                    // Bits de GetEstadoCampanario() (Config::States::BIT_*)
+        uint8_t  campanas;                                                  // Campanas del último tiempo (bit 0 = campana 1)
+        uint8_t  secuencia;                                                 // GetSecuenciaActiva() (Config::Secuencia)
+        uint8_t  reservado;
+        uint16_t toque;                                                     // Tiempos tocados desde el inicio de la secuencia
+        uint32_t calefaccion;                                               // Segundos restantes de calefacción (0 = apagada)
+        uint32_t hora;                                                      // Epoch UTC
+    };
+    static_assert(sizeof(TramaEstado) == 16, "El cliente JavaScript lee la trama con desplazamientos fijos");
+
+    typedef void (*ManejadorComando)(AsyncWebSocketClient* client, const char* pDatos, size_t nDatos);   // Datos sin terminador '\0'
+
     void ServidorOn(const char* usuario, const char* clave);                                                                        // Función para iniciar el servidor HTTP y WebSocket
     void onEvent(AsyncWebSocket *server, AsyncWebSocketClient *client, AwsEventType type, void *arg, uint8_t *data, size_t len);    // Callback para manejar eventos del WebSocket
-    void procesaMensajeWebSocket(void *arg, uint8_t *data, size_t len);                                                             // Procesa los mensajes recibidos por WebSocket
-    void procesarComandoAlarma(AsyncWebSocketClient *client, const String& comando, const String& datos);                                                              // Procesa comandos relacionados con las alarmas personalizables
+    void procesaMensajeWebSocket(AsyncWebSocketClient *client, void *arg, uint8_t *data, size_t len);                               // Procesa los mensajes recibidos por WebSocket
+    void registraComandosWebSocket(void);                                                                                           // Construye la tabla hash de comandos WebSocket
+    ManejadorComando buscaComando(const char* pToken, size_t nToken);                                                               // Manejador de un token de comando (nullptr si no existe)
+    void notificaToque(uint8_t nMascara);                                                                                           // Notifica un tiempo de la secuencia (trama binaria o "CAMPANA:n")
+    void ejecutaOrdenAlarma(const Comando& comando);                                                                                // Aplica una orden web de alarmas desde loop() y responde
+    void ejecutaConsulta(const Comando& comando);                                                                                   // Responde desde loop() a una consulta de estado (CMD_CONSULTA)
     uint8_t convertirDiaAMascara(int dia);
     String cargarIdiomaDesdeConfig(void);
     String obtenerConfiguracionJSON(void);
@@ -83,7 +83,7 @@ void TelegramServicio::sendNotification(const String& message) {
 
 String TelegramServicio::urlEncode(const String& str) {
     String encoded = "";
-    for (int i = 0; i < str.length(); i++) {
+    for (unsigned int i = 0; i < str.length(); i++) {
         char c = str.charAt(i);
         if (c == ' ') {
             encoded += '+';
@@ -4,6 +4,7 @@ Script para compilar y generar release de Campanarios para OTA.
 
 Funcionalidades:
 - Compila el proyecto ESP32 con arduino-cli
+- Minifica y comprime con gzip los recursos web de data/
 - Genera firmware.bin y spiffs.bin
 - Prepara archivos para OTA
 - Opcionalmente sube a GitHub Releases
@@ -11,18 +12,22 @@ Funcionalidades:
 Uso:
     python build-release.py --version 1.0.0
     python build-release.py --version 1.0.1 --upload-to-github
+    python build-release.py --version 1.0.1 --web-only
 """
 
 import argparse
+import gzip
+import hashlib
 import json
 import os
 import platform
+import re
 import shutil
 import subprocess
 import sys
 from datetime import datetime
 from pathlib import Path
-from typing import Dict, Optional
+from typing import Dict, List, Optional
 
 # ============================================================================
 # CONFIGURACIÓN
@@ -35,6 +40,12 @@ PROJECT_NAME = "Campanarios"
 BUILD_DIR = "build/esp32.esp32.esp32"
 DATA_DIR = "data"
 
+# Recursos web: se minifican y se guardan solo comprimidos (.gz) en WEB_BUILD_DIR
+WEB_BUILD_DIR = "build/data"
+WEB_EXTENSIONS = ('.html', '.js', '.css')
+HASHED_EXTENSIONS = ('.js', '.css')     # Nombre con hash: el navegador los guarda como immutable
+WEB_MANIFEST = "estaticos.json"         # Rutas servidas, ETag y si son inmutables (Servidor.cpp)
+
 # Tamaño SPIFFS para esquema 'default' = 1441792 bytes (0x160000)
 SPIFFS_SIZE = 1441792
 SPIFFS_BLOCK_SIZE = 4096
@@ -194,12 +205,146 @@ def compile_firmware() -> Path:
     
     return firmware_path
 
-def generate_spiffs(mkspiffs_path: Path) -> Path:
+def minify_js(text: str) -> str:
+    """
+    Minificación conservadora de JavaScript, línea a línea.
+    
+    Quita sangrías, líneas vacías y comentarios de línea completa. Conserva los
+    saltos de línea (los scripts dependen de la inserción automática de ';') y
+    no toca las líneas dentro de plantillas `...` de varias líneas.
+    
+    Args:
+        text: Código fuente
+        
+    Returns:
+        Código minificado
+    """
+    lines = []
+    in_template = False
+    in_comment = False
+    for line in text.splitlines():
+        if in_template:
+            lines.append(line)
+            in_template = (len(re.findall(r'(?<!\\)`', line)) % 2 == 0)
+            continue
+        stripped = line.strip()
+        if in_comment:
+            if '*/' in stripped:
+                in_comment = False
+                stripped = stripped.split('*/', 1)[1].strip()
+            else:
+                continue
+        if stripped.startswith('/*'):
+            if '*/' not in stripped:
+                in_comment = True
+                continue
+            stripped = stripped.split('*/', 1)[1].strip()
+        if not stripped or stripped.startswith('//'):
+            continue
+        lines.append(stripped)
+        in_template = (len(re.findall(r'(?<!\\)`', stripped)) % 2 == 1)
+    return '\n'.join(lines) + '\n'
+
+def minify_css(text: str) -> str:
     """
-    Genera el archivo SPIFFS.bin desde la carpeta data/.
+    Minifica CSS quitando comentarios, sangrías y líneas vacías.
+    
+    Args:
+        text: Hoja de estilos
+        
+    Returns:
+        Hoja de estilos minificada
+    """
+    text = re.sub(r'/\*.*?\*/', '', text, flags=re.S)
+    return '\n'.join(l.strip() for l in text.splitlines() if l.strip()) + '\n'
+
+def minify_html(text: str) -> str:
+    """
+    Minifica HTML quitando comentarios <!-- -->, sangrías y líneas vacías.
+    
+    Los <script> y <style> en línea pasan por minify_js() y minify_css().
+    
+    Args:
+        text: Página HTML
+        
+    Returns:
+        Página minificada
+    """
+    text = re.sub(r'<!--.*?-->', '', text, flags=re.S)
+    text = re.sub(r'(<script>)(.*?)(</script>)',
+                  lambda m: m.group(1) + '\n' + minify_js(m.group(2)) + m.group(3), text, flags=re.S)
+    text = re.sub(r'(<style>)(.*?)(</style>)',
+                  lambda m: m.group(1) + '\n' + minify_css(m.group(2)) + m.group(3), text, flags=re.S)
+    return '\n'.join(l.strip() for l in text.splitlines() if l.strip()) + '\n'
+
+def prepare_web_assets() -> Path:
+    """
+    Prepara data/ para la imagen SPIFFS en WEB_BUILD_DIR.
+    
+    - Minifica .html, .js y .css
+    - Renombra .js y .css con un hash de su contenido (idiomas.1a2b3c4d.js)
+      y actualiza las referencias de las páginas HTML
+    - Guarda solo la versión gzip (nombre.gz); el servidor la envía con
+      Content-Encoding: gzip
+    - Escribe WEB_MANIFEST con la ruta, el ETag (hash del .gz) y si es inmutable
+    - El resto de archivos (config.json...) se copian sin cambios
+    
+    Returns:
+        Path a la carpeta que se empaqueta en SPIFFS
+    """
+    print_step(f"Preparando recursos web de '{DATA_DIR}' en '{WEB_BUILD_DIR}'...")
+    
+    out_dir = Path(WEB_BUILD_DIR)
+    if out_dir.exists():
+        shutil.rmtree(out_dir)
+    out_dir.mkdir(parents=True)
+    
+    minifiers = {'.html': minify_html, '.js': minify_js, '.css': minify_css}
+    sources = sorted(p for p in Path(DATA_DIR).iterdir() if p.is_file())
+    
+    # Primero los .js/.css: sus nombres con hash se sustituyen luego en el HTML
+    contents = {}
+    renamed = {}
+    for src in sources:
+        if src.suffix not in WEB_EXTENSIONS:
+            shutil.copy2(src, out_dir / src.name)
+            continue
+        contents[src.name] = minifiers[src.suffix](src.read_text(encoding='utf-8'))
+        if src.suffix in HASHED_EXTENSIONS:
+            digest = hashlib.sha256(contents[src.name].encode('utf-8')).hexdigest()[:8]
+            renamed[src.name] = f"{src.stem}.{digest}{src.suffix}"
+    
+    manifest: List[Dict] = []
+    before = after = 0
+    for name, text in contents.items():
+        if name.endswith('.html'):
+            for old, new in renamed.items():
+                text = re.sub(r'((?:src|href)="/?)' + re.escape(old) + '"', r'\g<1>' + new + '"', text)
+        served = renamed.get(name, name)
+        data = gzip.compress(text.encode('utf-8'), compresslevel=9, mtime=0)
+        (out_dir / f"{served}.gz").write_bytes(data)
+        manifest.append({
+            "ruta": f"/{served}",
+            "etag": hashlib.sha256(data).hexdigest()[:16],
+            "inmutable": served != name
+        })
+        before += (Path(DATA_DIR) / name).stat().st_size
+        after += len(data)
+    
+    manifest_path = out_dir / WEB_MANIFEST
+    manifest_path.write_text(json.dumps(manifest, separators=(',', ':')), encoding='utf-8')
+    
+    print_success(f"{len(manifest)} recursos web: {format_size(before)} -> {format_size(after)} (gzip)")
+    
+    return out_dir
+
+def generate_spiffs(mkspiffs_path: Path, data_dir: Path) -> Path:
+    """
+    Genera el archivo SPIFFS.bin desde la carpeta de recursos preparada.
     
     Args:
         mkspiffs_path: Path al ejecutable mkspiffs
+        data_dir: Carpeta devuelta por prepare_web_assets()
         
     Returns:
         Path al spiffs.bin generado
@@ -207,13 +352,13 @@ def generate_spiffs(mkspiffs_path: Path) -> Path:
     Raises:
         RuntimeError: Si falla la generación
     """
-    print_step(f"Generando SPIFFS.bin desde carpeta '{DATA_DIR}'...")
+    print_step(f"Generando SPIFFS.bin desde carpeta '{data_dir}'...")
     
     spiffs_path = Path(BUILD_DIR) / f"{PROJECT_NAME}.spiffs.bin"
     
     cmd = [
         str(mkspiffs_path),
-        "-c", DATA_DIR,
+        "-c", str(data_dir),
         "-b", str(SPIFFS_BLOCK_SIZE),
         "-p", str(SPIFFS_PAGE_SIZE),
         "-s", str(SPIFFS_SIZE),
@@ -398,6 +543,7 @@ def main():
 Ejemplos de uso:
   python build-release.py --version 1.0.0
   python build-release.py --version 1.0.1 --upload-to-github
+  python build-release.py --version 1.0.1 --web-only
         """
     )
     
@@ -411,6 +557,11 @@ Ejemplos de uso:
         action='store_true',
         help='Subir automáticamente a GitHub Releases'
     )
+    parser.add_argument(
+        '--web-only',
+        action='store_true',
+        help=f'Solo preparar los recursos web en {WEB_BUILD_DIR} (sin compilar)'
+    )
     
     args = parser.parse_args()
     
@@ -422,6 +573,11 @@ Ejemplos de uso:
         print_error(f"No se encuentra la carpeta '{DATA_DIR}'")
         return 1
     
+    # Recursos web minificados y comprimidos
+    if args.web_only:
+        prepare_web_assets()
+        return 0
+    
     # Verificar mkspiffs
     mkspiffs_path = find_mkspiffs()
     if not mkspiffs_path:
@@ -434,8 +590,9 @@ Ejemplos de uso:
         firmware_path = compile_firmware()
         firmware_size = firmware_path.stat().st_size
         
-        # PASO 2: Generar SPIFFS
-        spiffs_path = generate_spiffs(mkspiffs_path)
+        # PASO 2: Generar SPIFFS con los recursos web comprimidos
+        web_dir = prepare_web_assets()
+        spiffs_path = generate_spiffs(mkspiffs_path, web_dir)
         spiffs_size = spiffs_path.stat().st_size
         
         # PASO 3: Crear directorio de release
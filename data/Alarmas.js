@@ -158,7 +158,8 @@ class AlarmManager {
             const jsonData = message.substring(12);
             try {
                 const data = JSON.parse(jsonData);
-                this.alarmas = data.alarmas || [];
+                // Orden por ID: al eliminar, la última alarma ocupa el hueco en el servidor
+                this.alarmas = (data.alarmas || []).sort((a, b) => a.id - b.id);
                 console.log(`✅ ${this.alarmas.length} alarmas cargadas`);
                 
                 // Esperar un poco para asegurar que el sistema de idiomas esté listo
@@ -473,7 +474,11 @@ renderStatsBasico() {
         div.innerHTML = `
             <div class="alarm-info">
                 <h4>${alarm.nombre}</h4>
-                <p><strong><span data-i18n="${alarm.diaNombre}">${diaTraducido}</span></strong> a las <strong>${alarm.horaTexto}</strong></p>
+                ${alarm.cron
+                    ? `<p>Cron: <strong><code>${alarm.cron}</code></strong></p>`
+                    : alarm.fiesta
+                    ? `<p><strong>${this.tr('fiesta_' + alarm.fiesta, alarm.fiesta)}${alarm.desplazamiento ? ` ${alarm.desplazamiento > 0 ? '+' : ''}${alarm.desplazamiento}d` : ''}</strong> a las <strong>${alarm.horaTexto}</strong></p>`
+                    : `<p><strong><span data-i18n="${alarm.diaNombre}">${diaTraducido}</span></strong> a las <strong>${alarm.horaTexto}</strong></p>`}
                 <p><span data-i18n="Acción">${textoAccion}</span>: <strong>${textoTipoCompleto}</strong></p>
                 ${alarm.descripcion ? `<p><em>${alarm.descripcion}</em></p>` : ''}
             </div>
@@ -539,6 +544,11 @@ renderStatsBasico() {
             hora: parseInt(document.getElementById('hora').value),
             minuto: parseInt(document.getElementById('minuto').value),
             segundo: 0,
+            cron: document.getElementById('cron').value.trim(),   // "" = usar día/hora/minuto
+            fiesta: document.getElementById('fiesta').value,      // "" = usar día de la semana
+            desplazamiento: parseInt(document.getElementById('desplazamiento').value) || 0,
+            recuperacion: document.getElementById('recuperacion').value,
+            margenRecuperacion: parseInt(document.getElementById('margenRecuperacion').value) || 15,
             accion: document.getElementById('accion').value,
             parametro:  0,
             habilitada: true,
@@ -555,6 +565,14 @@ renderStatsBasico() {
             return false;
         }
         
+        if (data.cron) {
+            if (data.cron.split(/\s+/).length !== 5) {
+                this.showStatus(`❌ ${this.tr('cron_cinco_campos', 'La expresión cron debe tener 5 campos')}`, "error");
+                return false;
+            }
+            return true;   // El servidor valida el resto de la expresión
+        }
+        
         if (data.hora < 0 || data.hora > 23) {
             this.showStatus(`❌ ${this.tr('hora_entre_0_23', 'La hora debe estar entre 0 y 23')}`, "error");
             return false;
@@ -606,6 +624,13 @@ renderStatsBasico() {
             document.getElementById('hora').value = alarm.hora;
             document.getElementById('minuto').value = alarm.minuto;
             document.getElementById('accion').value = alarm.accion;
+            document.getElementById('cron').value = alarm.cron || '';
+            document.getElementById('fiesta').value = alarm.fiesta || '';
+            document.getElementById('desplazamiento').value = alarm.desplazamiento || 0;
+            document.getElementById('recuperacion').value = alarm.recuperacion || 'TARDE';
+            document.getElementById('margenRecuperacion').value = alarm.margenRecuperacion || 15;
+            actualizarModoHorario();
+            actualizarModoRecuperacion();
             
             const duracionSelect = document.getElementById('duracion');
             if (duracionSelect && alarm.duracion) {
@@ -671,6 +696,8 @@ renderStatsBasico() {
         if (this.editingId === null) {
             form.reset();
             mostrarDuracionSiEsCalefaccion(); // Ocultar campo duración al resetear
+            actualizarModoHorario();             // Volver a día/hora/minuto
+            actualizarModoRecuperacion();        // Margen activo con TARDE
             console.log("✅ Formulario reseteado");
         }
         
@@ -691,6 +718,7 @@ renderStatsBasico() {
             setTimeout(() => {
                 form.reset();
                 mostrarDuracionSiEsCalefaccion(); // Ocultar campo duración al limpiar tras edición
+                actualizarModoRecuperacion();
                 
                 const submitBtn = form.querySelector('button[type="submit"]');
                 if (submitBtn) {
@@ -906,6 +934,42 @@ if (document.readyState !== 'loading') {
     }, 500); // Aumentado de 200ms a 500ms
 } 
 
+/**
+ * Con expresión cron, día/hora/minuto y fiesta no se usan; con fiesta, el día de la semana no se usa.
+ * Los campos que no se usan se desactivan y dejan de ser obligatorios.
+ */
+function actualizarModoHorario() {
+    const cronInput = document.getElementById('cron');
+    const fiestaSelect = document.getElementById('fiesta');
+    const conCron = !!(cronInput && cronInput.value.trim());
+    const conFiesta = !conCron && !!(fiestaSelect && fiestaSelect.value);
+    const desactivar = {
+        dia: conCron || conFiesta,
+        hora: conCron,
+        minuto: conCron,
+        fiesta: conCron,
+        desplazamiento: conCron || !conFiesta
+    };
+    Object.keys(desactivar).forEach(id => {
+        const campo = document.getElementById(id);
+        if (campo) {
+            campo.disabled = desactivar[id];
+            if (id !== 'fiesta' && id !== 'desplazamiento') campo.required = !desactivar[id];
+        }
+    });
+}
+
+/**
+ * El margen solo se usa con la política TARDE (tocar si el retraso no lo supera).
+ */
+function actualizarModoRecuperacion() {
+    const recuperacionSelect = document.getElementById('recuperacion');
+    const margenInput = document.getElementById('margenRecuperacion');
+    if (recuperacionSelect && margenInput) {
+        margenInput.disabled = recuperacionSelect.value !== 'TARDE';
+    }
+}
+
 /**
  * Mostrar/ocultar campo duración según la acción seleccionada
  */
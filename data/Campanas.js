@@ -8,6 +8,7 @@ const CampanarioStates = {
     FIESTA: "Fiesta",
     STOP: "PARAR",
     GET_CAMPANARIO: "GET_CAMPANARIO",
+    GET_JITTER_CAMPANARIO: "GET_JITTER_CAMPANARIO",
     GET_TIEMPO_CALEFACCION: "GET_TIEMPOCALEFACCION",
     GET_SECUENCIA_ACTIVA: "GET_SECUENCIA_ACTIVA",
 
@@ -22,10 +23,21 @@ const CampanarioStates = {
     BIT_PROTECCION_CAMPANADAS: 0x80
 };
 
+// ============================================================================
+// PROTOCOLO BINARIO - Sincronizado con TramaEstado en Servidor.h
+// ============================================================================
+const ProtocoloBinario = {
+    VERSION: 1,                 // Versión más alta que entiende esta página
+    TAM_TRAMA: 16,
+    TRAMA_ESTADO: 1,            // Respuesta a GET_CAMPANARIO
+    TRAMA_TOQUE: 2              // Un tiempo de la secuencia (sustituye a "CAMPANA:n")
+};
+
 var gateway = `ws://${window.location.hostname}:8080/ws`;
 var websocket;
 
 let lCampanas = false;
+let nProtocoloBinario = 0;     // Versión aceptada por el servidor (0 = solo texto)
 
 window.addEventListener('load', onload);
 
@@ -36,6 +48,7 @@ function onload(event) {
 
 function initWebSocket() {
     websocket = new WebSocket(gateway);
+    websocket.binaryType = "arraybuffer";
     websocket.onmessage = onMessageDatos;
     websocket.onopen = onOpenDatos;
     websocket.onclose = onCloseDatos;
@@ -44,6 +57,8 @@ function initWebSocket() {
 function onOpenDatos(event) {
     const path = window.location.pathname;
     console.log("Conexión WebSocket abierta en Datos");
+    nProtocoloBinario = 0;
+    websocket.send("PROTOCOLO:" + ProtocoloBinario.VERSION);   // Un firmware antiguo lo ignora y seguimos en texto
     if (path === "/" || path.endsWith("index.html")) {
         websocket.send("GET_CAMPANARIO");
     }
@@ -55,14 +70,27 @@ function onCloseDatos(event) {
 }
 
 function onMessageDatos(event) {
+    if (event.data instanceof ArrayBuffer) {
+        procesarTramaEstado(event.data);
+        return;
+    }
     console.log("Mensaje recibido: " + event.data);
 
+    if (event.data.startsWith("PROTOCOLO:")) {
+        nProtocoloBinario = parseInt(event.data.substring(10)) || 0;
+        console.log("Protocolo binario negociado: " + nProtocoloBinario);
+    }
+
     if (event.data.startsWith("REDIRECT:")) {
         var url = event.data.substring(9);
         console.log("Redirigiendo a: " + url);
         window.location.href = url;
     }
     
+    if (event.data.startsWith("JITTER_CAMPANARIO:")) {
+        console.log("Histograma de retraso de toques:", JSON.parse(event.data.substring(18)));
+    }
+    
     if (event.data.startsWith("CAMPANA:")) {
         console.log("Activando campana con ID: " + event.data);
         let idx = parseInt(event.data.split(":")[1]);
@@ -79,7 +107,7 @@ function onMessageDatos(event) {
     }
     
     // ✅ DELEGAR MENSAJES DE CONFIGURACIÓN (PIN, CONFIG_TELEGRAM)
-    if (event.data === "PIN_OK" || event.data === "PIN_ERROR" || event.data.startsWith("CONFIG_TELEGRAM:")) {
+    if (event.data === "PIN_OK" || event.data === "PIN_ERROR" || event.data.startsWith("CONFIG_TELEGRAM:") || event.data.startsWith("CAMPANAS:")) {
         if (typeof procesarMensajeConfiguracion === 'function') {
             procesarMensajeConfiguracion(event.data);
         } else {
@@ -146,98 +174,135 @@ function onMessageDatos(event) {
     
     if (event.data.startsWith("ESTADO_CAMPANARIO:")) {
         console.log("Comprobando estado de campanario: " + event.data);
-        let EstadoCampanario = parseInt(event.data.split(":")[1]);
+        aplicarEstadoCampanario(parseInt(event.data.split(":")[1]));
         
-        if ((EstadoCampanario & CampanarioStates.BIT_SECUENCIA)) {
-            lCampanas = true;
-            window.location.href = "/Campanas.html";
-        } else {
-            lCampanas = false;
+        if (event.data.startsWith("GET_SECUENCIA_ACTIVA:")) {
+            console.log("Recibido número de secuencia activa: " + event.data);
         }
-        
-        // ✅ DELEGAR ESTADO DE CALEFACCIÓN AL MÓDULO CORRESPONDIENTE
-        if (EstadoCampanario & CampanarioStates.BIT_CALEFACCION) {
-            // ✅ CALEFACCIÓN ENCENDIDA: Delegar actualización completa
-            if (typeof window.Calefaccion !== 'undefined') {
-                window.Calefaccion.estado = true;
+    }
+}
+
+// Lee una TramaEstado (little-endian): versión, tipo, estado, campanas,
+// secuencia, reservado, toque (u16), calefacción en segundos (u32), hora (u32)
+function procesarTramaEstado(buffer) {
+    if (buffer.byteLength < ProtocoloBinario.TAM_TRAMA) {
+        console.warn("⚠️ Trama binaria demasiado corta: " + buffer.byteLength + " bytes");
+        return;
+    }
+    const vista = new DataView(buffer);
+    const trama = {
+        version: vista.getUint8(0),
+        tipo: vista.getUint8(1),
+        estado: vista.getUint8(2),
+        campanas: vista.getUint8(3),
+        secuencia: vista.getUint8(4),
+        toque: vista.getUint16(6, true),
+        calefaccion: vista.getUint32(8, true),
+        hora: vista.getUint32(12, true)
+    };
+    if (trama.version !== nProtocoloBinario) {
+        console.warn("⚠️ Trama de versión " + trama.version + " no negociada");
+        return;
+    }
+
+    if (trama.tipo === ProtocoloBinario.TRAMA_TOQUE) {
+        for (let i = 0; i < 8; i++) {                           // Varias campanas si el tiempo es polifónico
+            if (trama.campanas & (1 << i)) {
+                activarCampana(i + 1);
             }
-            
-            // ✅ ACTUALIZAR INTERFAZ COMPLETA si la función está disponible
-            if (typeof actualizarEstadoCalefaccion === 'function') {
-                actualizarEstadoCalefaccion();
-            } else {
-                // Fallback: Solo actualizar icono si la función no está disponible
-                const icono = document.getElementById("iconoCalefaccion");
-                if (icono) {
-                    icono.setAttribute("stroke", "red");
-                }
+        }
+    } else if (trama.tipo === ProtocoloBinario.TRAMA_ESTADO) {
+        console.log("Estado de campanario (binario):", trama);
+        aplicarEstadoCampanario(trama.estado, trama.calefaccion);
+    }
+}
+
+// segundosCalefaccion llega en la trama binaria; con texto se pide con GET_TIEMPOCALEFACCION
+function aplicarEstadoCampanario(EstadoCampanario, segundosCalefaccion) {
+    if ((EstadoCampanario & CampanarioStates.BIT_SECUENCIA)) {
+        lCampanas = true;
+        window.location.href = "/Campanas.html";
+    } else {
+        lCampanas = false;
+    }
+    
+    // ✅ DELEGAR ESTADO DE CALEFACCIÓN AL MÓDULO CORRESPONDIENTE
+    if (EstadoCampanario & CampanarioStates.BIT_CALEFACCION) {
+        // ✅ CALEFACCIÓN ENCENDIDA: Delegar actualización completa
+        if (typeof window.Calefaccion !== 'undefined') {
+            window.Calefaccion.estado = true;
+        }
+        
+        // ✅ ACTUALIZAR INTERFAZ COMPLETA si la función está disponible
+        if (typeof actualizarEstadoCalefaccion === 'function') {
+            actualizarEstadoCalefaccion();
+        } else {
+            // Fallback: Solo actualizar icono si la función no está disponible
+            const icono = document.getElementById("iconoCalefaccion");
+            if (icono) {
+                icono.setAttribute("stroke", "red");
             }
-            
-            // Solicitar tiempo restante
+        }
+        
+        // Tiempo restante: incluido en la trama binaria o solicitado aparte
+        if (segundosCalefaccion !== undefined && typeof procesarMensajeCalefaccion === 'function') {
+            procesarMensajeCalefaccion("TIEMPO_CALEFACCION:" + segundosCalefaccion);
+        } else {
             websocket.send("GET_TIEMPOCALEFACCION");
-            console.log("🔥 Calefacción detectada como ENCENDIDA - Solicitando tiempo restante");
+        }
+        console.log("🔥 Calefacción detectada como ENCENDIDA - Tiempo restante actualizado");
+        
+    } else {
+        // ✅ CALEFACCIÓN APAGADA: Delegar actualización completa
+        if (typeof window.Calefaccion !== 'undefined') {
+            window.Calefaccion.estado = false;
+        }
+        
+        // ✅ ACTUALIZAR INTERFAZ COMPLETA si la función está disponible
+        if (typeof actualizarEstadoCalefaccion === 'function') {
+            actualizarEstadoCalefaccion();
             
-        } else {
-            // ✅ CALEFACCIÓN APAGADA: Delegar actualización completa
-            if (typeof window.Calefaccion !== 'undefined') {
-                window.Calefaccion.estado = false;
+            // ✅ TAMBIÉN: Detener cuenta regresiva si existe
+            if (typeof detenerCuentaRegresiva === 'function') {
+                detenerCuentaRegresiva();
             }
             
-            // ✅ ACTUALIZAR INTERFAZ COMPLETA si la función está disponible
-            if (typeof actualizarEstadoCalefaccion === 'function') {
-                actualizarEstadoCalefaccion();
-                
-                // ✅ TAMBIÉN: Detener cuenta regresiva si existe
-                if (typeof detenerCuentaRegresiva === 'function') {
-                    detenerCuentaRegresiva();
-                }
-                
-                // ✅ Y: Actualizar display de minutos si existe
-                if (typeof actualizarDisplayMinutos === 'function') {
-                    actualizarDisplayMinutos();
-                }
-            } else {
-                // Fallback: Solo actualizar icono si la función no está disponible
-                const icono = document.getElementById("iconoCalefaccion");
-                if (icono) {
-                    icono.setAttribute("stroke", "orange");
-                }
+            // ✅ Y: Actualizar display de minutos si existe
+            if (typeof actualizarDisplayMinutos === 'function') {
+                actualizarDisplayMinutos();
             }
-            
-            console.log("🔥 Calefacción detectada como APAGADA - Interfaz actualizada");
-        }
-        
-        // Verificar el bit de protección de campanadas
-        if (EstadoCampanario & CampanarioStates.BIT_PROTECCION_CAMPANADAS) {
-            habilitarBotonesCampanadas(false);
-            console.log("Protección de campanadas activa");
         } else {
-            habilitarBotonesCampanadas(true);
-            console.log("Protección de campanadas inactiva");
+            // Fallback: Solo actualizar icono si la función no está disponible
+            const icono = document.getElementById("iconoCalefaccion");
+            if (icono) {
+                icono.setAttribute("stroke", "orange");
+            }
         }
         
-        if (event.data.startsWith("GET_SECUENCIA_ACTIVA:")) {
-            console.log("Recibido número de secuencia activa: " + event.data);
-        }
+        console.log("🔥 Calefacción detectada como APAGADA - Interfaz actualizada");
+    }
+    
+    // Verificar el bit de protección de campanadas
+    if (EstadoCampanario & CampanarioStates.BIT_PROTECCION_CAMPANADAS) {
+        habilitarBotonesCampanadas(false);
+        console.log("Protección de campanadas activa");
+    } else {
+        habilitarBotonesCampanadas(true);
+        console.log("Protección de campanadas inactiva");
     }
 }
 
 function activarCampana(num) {
-    // Desactiva todas
-    document.getElementById("campana0").classList.remove("activa");
-    document.getElementById("campana1").classList.remove("activa");
-    
-    // Activa la correspondiente (números desde 1)
-    if (num === 1) {
-        document.getElementById("campana0").classList.add("activa");
-    } else if (num === 2) {
-        document.getElementById("campana1").classList.add("activa");
+    // Activa la correspondiente (números desde 1); admite cualquier número de campanas del banco
+    const campana = document.getElementById("campana" + (num - 1));
+    if (!campana) {
+        return;
     }
+    campana.classList.add("activa");
     
     // Desactivar la animación después de un tiempo
     setTimeout(() => {
-        document.getElementById("campana0").classList.remove("activa");
-        document.getElementById("campana1").classList.remove("activa");
+        campana.classList.remove("activa");
     }, 400);
 }
 
@@ -264,6 +264,64 @@ function cerrarModalBackup() {
     modal.style.display = 'none';
 }
 
+function abrirModalCalibracion() {
+    console.log("🔔 Abriendo modal de calibración de campanas");
+    cerrarModalConfiguracion();
+    
+    const modal = document.getElementById('modalCalibracion');
+    modal.style.display = 'block';
+    
+    if (typeof websocket !== 'undefined' && websocket.readyState === WebSocket.OPEN) {
+        websocket.send('GET_CAMPANAS');
+    }
+}
+
+function cerrarModalCalibracion() {
+    const modal = document.getElementById('modalCalibracion');
+    modal.style.display = 'none';
+}
+
+function pintarCalibracion(datos) {
+    const lista = document.getElementById('listaCalibracion');
+    if (!lista) {
+        return;
+    }
+    const textoCampana = typeof t === 'function' ? t('calibracion_campana') : 'Campana';
+    const textoProbar = typeof t === 'function' ? t('calibracion_probar') : 'Provar';
+    lista.innerHTML = '';
+    datos.campanas.forEach(c => {
+        const item = document.createElement('div');
+        item.className = 'backup-item';
+        item.innerHTML = `
+            <div class="backup-info">
+                <strong>${textoCampana} ${c.campana}</strong>
+                <small>${(c.medidoUs / 1000).toFixed(1)} ms · reposo ${c.reposo} ms</small>
+            </div>
+            <div class="backup-acciones">
+                <input type="number" min="20" max="1000" step="10" value="${c.pulso}"
+                       onchange="enviarPulsoCampana(${c.campana}, this.value)" style="width: 80px;">
+                <button class="btn-info btn-small" onclick="probarCampana(${c.campana})">${textoProbar}</button>
+            </div>`;
+        lista.appendChild(item);
+    });
+}
+
+function enviarPulsoCampana(campana, pulso) {
+    if (typeof websocket !== 'undefined' && websocket.readyState === WebSocket.OPEN) {
+        websocket.send(`SET_PULSO_CAMPANA:${campana}:${parseInt(pulso)}`);
+        console.log(`📤 Pulso campana ${campana}: ${pulso} ms`);
+    }
+}
+
+function probarCampana(campana) {
+    if (typeof websocket !== 'undefined' && websocket.readyState === WebSocket.OPEN) {
+        websocket.send(`PROBAR_CAMPANA:${campana}`);
+        console.log(`🔔 Toque de prueba campana ${campana}`);
+        // Refrescar el pulso medido tras el toque
+        setTimeout(() => websocket.send('GET_CAMPANAS'), 1500);
+    }
+}
+
 function descargarArchivo(filename) {
     console.log(`📥 Descargando archivo: ${filename}`);
     
@@ -505,6 +563,12 @@ function procesarMensajeConfiguracion(mensaje) {
         } catch (e) {
             console.error("❌ Error al parsear configuración:", e);
         }
+    } else if (mensaje.startsWith("CAMPANAS:")) {
+        try {
+            pintarCalibracion(JSON.parse(mensaje.substring(9)));
+        } catch (e) {
+            console.error("❌ Error al parsear calibración de campanas:", e);
+        }
     } else if (mensaje.startsWith("VERSION_OTA:")) {
         // VERSION_OTA:1.0.4
         const version = mensaje.substring(12);
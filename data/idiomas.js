@@ -164,6 +164,30 @@ const IDIOMAS = {
         'nombre_obligatorio': 'El nom és obligatori',
         'hora_entre_0_23': 'L\'hora ha d\'estar entre 0 i 23',
         'minutos_entre_0_59': 'Els minuts han d\'estar entre 0 i 59',
+        'cron_cinco_campos': 'L\'expressió cron ha de tenir 5 camps',
+        'cron_placeholder': 'Cron opcional (ex: 0 12 * * 0#1)',
+        'fiesta_ninguna': 'Sense festa (dia de la setmana)',
+        'fiesta_CENIZA': 'Dimecres de Cendra',
+        'fiesta_RAMOS': 'Diumenge de Rams',
+        'fiesta_JUEVES_SANTO': 'Dijous Sant',
+        'fiesta_VIERNES_SANTO': 'Divendres Sant',
+        'fiesta_PASCUA': 'Pasqua',
+        'fiesta_ASCENSION': 'Ascensió',
+        'fiesta_PENTECOSTES': 'Pentecosta',
+        'fiesta_TRINIDAD': 'Santíssima Trinitat',
+        'fiesta_CORPUS': 'Corpus Christi',
+        'fiesta_EPIFANIA': 'Epifania',
+        'fiesta_SAN_JOSE': 'Sant Josep',
+        'fiesta_ASUNCION': 'Assumpció',
+        'fiesta_TODOS_SANTOS': 'Tots Sants',
+        'fiesta_INMACULADA': 'Immaculada',
+        'fiesta_NAVIDAD': 'Nadal',
+        'fiesta_PATRON': 'Festa patronal',
+        'desplazamiento_dias': 'Dies des de la festa',
+        'recuperacion_tarde': 'Si es perd: tocar tard dins del marge',
+        'recuperacion_ultima': "Si es perd: tocar l'última en tornar",
+        'recuperacion_omitir': 'Si es perd: no tocar',
+        'margen_recuperacion': 'Marge (minuts)',
         'cambiando_estado': 'Canviant estat',
         'procesando': 'Processant',
         'actualizando': 'Actualitzant',
@@ -230,6 +254,11 @@ const IDIOMAS = {
         'config_sistema_desc': 'Ajustos generals',
         'config_reset': 'Reset',
         'config_reset_desc': 'Reiniciar el sistema',
+        'config_campanas': 'Campanes',
+        'config_campanas_desc': 'Pols i prova de cada campana',
+        'calibracion_descripcion': 'Ajusta el pols de cada campana (ms) i prova-la:',
+        'calibracion_campana': 'Campana',
+        'calibracion_probar': 'Provar',
         'reset_titulo': 'Reiniciar el Sistema',
         'reset_confirmacion': 'Estàs segur que vols reiniciar el sistema?',
         'reset_descripcion': 'El sistema es reiniciarà i es perdrà la connexió temporalment.',
@@ -476,6 +505,30 @@ const IDIOMAS = {
         'nombre_obligatorio': 'El nombre es obligatorio',
         'hora_entre_0_23': 'La hora debe estar entre 0 y 23',
         'minutos_entre_0_59': 'Los minutos deben estar entre 0 y 59',
+        'cron_cinco_campos': 'La expresión cron debe tener 5 campos',
+        'cron_placeholder': 'Cron opcional (ej: 0 12 * * 0#1)',
+        'fiesta_ninguna': 'Sin fiesta (día de la semana)',
+        'fiesta_CENIZA': 'Miércoles de Ceniza',
+        'fiesta_RAMOS': 'Domingo de Ramos',
+        'fiesta_JUEVES_SANTO': 'Jueves Santo',
+        'fiesta_VIERNES_SANTO': 'Viernes Santo',
+        'fiesta_PASCUA': 'Pascua',
+        'fiesta_ASCENSION': 'Ascensión',
+        'fiesta_PENTECOSTES': 'Pentecostés',
+        'fiesta_TRINIDAD': 'Santísima Trinidad',
+        'fiesta_CORPUS': 'Corpus Christi',
+        'fiesta_EPIFANIA': 'Epifanía',
+        'fiesta_SAN_JOSE': 'San José',
+        'fiesta_ASUNCION': 'Asunción',
+        'fiesta_TODOS_SANTOS': 'Todos los Santos',
+        'fiesta_INMACULADA': 'Inmaculada',
+        'fiesta_NAVIDAD': 'Navidad',
+        'fiesta_PATRON': 'Fiesta patronal',
+        'desplazamiento_dias': 'Días desde la fiesta',
+        'recuperacion_tarde': 'Si se pierde: tocar tarde dentro del margen',
+        'recuperacion_ultima': 'Si se pierde: tocar la última al volver',
+        'recuperacion_omitir': 'Si se pierde: no tocar',
+        'margen_recuperacion': 'Margen (minutos)',
         'cambiando_estado': 'Cambiando estado',
         'procesando': 'Procesando',
         'actualizando': 'Actualizando',
@@ -542,6 +595,11 @@ const IDIOMAS = {
         'config_sistema_desc': 'Ajustes generales',
         'config_reset': 'Reset',
         'config_reset_desc': 'Reiniciar el sistema',
+        'config_campanas': 'Campanas',
+        'config_campanas_desc': 'Pulso y prueba de cada campana',
+        'calibracion_descripcion': 'Ajusta el pulso de cada campana (ms) y pruébala:',
+        'calibracion_campana': 'Campana',
+        'calibracion_probar': 'Probar',
         'reset_titulo': 'Reiniciar el Sistema',
         'reset_confirmacion': '¿Estás seguro que quieres reiniciar el sistema?',
         'reset_descripcion': 'El sistema se reiniciará y se perderá la conexión temporalmente.',
@@ -0,0 +1,2 @@
+// El sketch como unidad de compilación normal: setup() y loop() para las pruebas
+#include "../Campanarios.ino"
@@ -0,0 +1,56 @@
+/**
+ * @file Memoria.h
+ * @brief Contabilidad de new/delete para los bancos de rendimiento de host/
+ *
+ * @details Sustituye los operadores globales new y delete del ejecutable y
+ *          lleva los bytes vivos y el pico desde el último ReiniciaPico().
+ *          String, std::vector y las copias del JSON pasan por aquí; malloc()
+ *          directo (los FILE* del SPIFFS simulado) no.
+ *
+ * @warning Incluir desde un solo .cpp por ejecutable: define los operadores
+ *
+ * @author Julian Salas Bartolomé
+ * @date 2025-10-17
+ * @version 1.0
+ */
+#ifndef MEMORIA_H
+	#define MEMORIA_H
+
+        #include <cstdlib>
+        #include <new>
+
+        namespace Memoria {
+
+            static size_t nActual = 0;                                      // Bytes pedidos con new y aún no liberados
+            static size_t nPico = 0;                                        // Máximo de nActual desde ReiniciaPico()
+
+            inline void ReiniciaPico(void) { nPico = nActual; }
+            inline size_t Actual(void) { return nActual; }
+            inline size_t Pico(void) { return nPico; }
+
+            inline void* Reserva(size_t n) {
+                size_t* p = (size_t*)malloc(n + 16);                        // Cabecera de 16 bytes: conserva la alineación
+                if (!p) throw std::bad_alloc();
+                *p = n;
+                nActual += n;
+                if (nActual > nPico) nPico = nActual;
+                return (char*)p + 16;
+            }
+
+            inline void Libera(void* pDatos) {
+                if (!pDatos) return;
+                size_t* p = (size_t*)((char*)pDatos - 16);
+                nActual -= *p;
+                free(p);
+            }
+
+        }
+
+        void* operator new(size_t n) { return Memoria::Reserva(n); }
+        void* operator new[](size_t n) { return Memoria::Reserva(n); }
+        void operator delete(void* p) noexcept { Memoria::Libera(p); }
+        void operator delete[](void* p) noexcept { Memoria::Libera(p); }
+        void operator delete(void* p, size_t) noexcept { Memoria::Libera(p); }
+        void operator delete[](void* p, size_t) noexcept { Memoria::Libera(p); }
+
+#endif
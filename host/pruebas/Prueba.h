@@ -0,0 +1,72 @@
+/**
+ * @file Prueba.h
+ * @brief Utilidades comunes de las pruebas de host/
+ *
+ * @details Cada prueba es un ejecutable que arranca el sketch con setup()
+ *          sobre una partición SPIFFS propia y mueve el reloj virtual.
+ *          COMPRUEBA() anota el fallo y sigue; Prueba::Fin() da el código
+ *          de salida para ctest.
+ *
+ * @author Julian Salas Bartolomé
+ * @date 2025-10-17
+ * @version 1.0
+ */
+#ifndef PRUEBA_H
+	#define PRUEBA_H
+
+        #include <Arduino.h>
+        #include <SPIFFS.h>
+        #include <string>
+        #include "RelojVirtual.h"
+        #include "HostGPIO.h"
+        #include "RTC.h"
+
+        void setup();
+        void loop();
+
+        namespace Prueba {
+
+            inline int& Fallos(void) {
+                static int nFallos = 0;
+                return nFallos;
+            }
+
+            inline void Comprueba(bool lOk, const char* sExpresion, const char* sArchivo, int nLinea, const char* sMensaje) {
+                if (lOk) return;
+                Fallos()++;
+                fprintf(stderr, "%s:%d: FALLO %s (%s)\n", sArchivo, nLinea, sMensaje, sExpresion);
+            }
+
+            /**
+             * @brief Partición SPIFFS vacía para la prueba
+             * @details Usa CAMPANARIOS_SPIFFS (lo fija ctest) o ./spiffs_<nombre>
+             */
+            inline void Particion(const char* sNombre) {
+                const char* sRaiz = getenv("CAMPANARIOS_SPIFFS");
+                std::string sDirectorio = sRaiz ? sRaiz : std::string("./spiffs_") + sNombre;
+                HostSPIFFS::Raiz(sDirectorio.c_str());
+                HostSPIFFS::Vacia();
+            }
+
+            /**
+             * @brief Arranca el sketch con la hora NTP ya disponible
+             * @param tEpoch Epoch UTC que devolverá el reloj al terminar la sincronización
+             */
+            inline void Arranca(time_t tEpoch) {
+                RelojVirtual::Zona(POSIX_TZ);
+                RelojVirtual::Fija(tEpoch);
+                setup();
+                HostGPIO::Limpia();
+            }
+
+            inline int Fin(const char* sNombre) {
+                if (Fallos()) fprintf(stderr, "%s: %d fallos\n", sNombre, Fallos());
+                else printf("%s: OK\n", sNombre);
+                return Fallos() ? 1 : 0;
+            }
+
+        }
+
+        #define COMPRUEBA(condicion, mensaje) Prueba::Comprueba((condicion), #condicion, __FILE__, __LINE__, (mensaje))
+
+#endif
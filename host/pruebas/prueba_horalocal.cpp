@@ -0,0 +1,150 @@
+/**
+ * @file prueba_horalocal.cpp
+ * @brief EpochLocal() y AlarmScheduler en los dos cambios de hora de 2025
+ *
+ * @details Con la zona POSIX_TZ de RTC.h:
+ *          - 30/03/2025: de 01:59:59 CET se pasa a 03:00:00 CEST (01:00 UTC);
+ *            las 02:xx locales no existen
+ *          - 26/10/2025: de 02:59:59 CEST se vuelve a 02:00:00 CET (01:00 UTC);
+ *            las 02:xx locales se repiten
+ *
+ *          Lo esperado depende de Config::Alarmas::HORA_AMBIGUA y
+ *          HORA_INEXISTENTE; la prueba lo calcula a partir de ellas.
+ *
+ *          **COMPRUEBA:**
+ *          - EpochLocal() de una hora normal coincide con mktime()
+ *          - EpochLocal() de 02:30 en octubre y en marzo según la política
+ *          - Una noche de cada cambio moviendo el reloj segundo a segundo:
+ *            cuántas veces dispara una alarma cada hora en punto y una a las
+ *            02:30, y en qué instante UTC lo hace esta última
+ */
+#include "Prueba.h"
+#include "Alarmas.h"
+#include "HoraLocal.h"
+#include <vector>
+
+extern AlarmScheduler Alarmas;
+
+static uint32_t nHoras = 0;
+static std::vector<time_t> aDisparos0230;
+
+static void _CuentaHora(void) { nHoras++; }
+static void _Anota0230(void) { aDisparos0230.push_back(RelojVirtual::Epoch()); }
+
+static time_t _Utc(int nAno, int nMes, int nDia, int nHora, int nMinuto) {
+    struct tm info = {};
+    info.tm_year = nAno - 1900;
+    info.tm_mon = nMes - 1;
+    info.tm_mday = nDia;
+    info.tm_hour = nHora;
+    info.tm_min = nMinuto;
+    return timegm(&info);
+}
+
+static struct tm _Local(int nAno, int nMes, int nDia, int nHora, int nMinuto) {
+    struct tm info = {};
+    info.tm_year = nAno - 1900;
+    info.tm_mon = nMes - 1;
+    info.tm_mday = nDia;
+    info.tm_hour = nHora;
+    info.tm_min = nMinuto;
+    return info;
+}
+
+// ============================================================================
+// EPOCHLOCAL
+// ============================================================================
+
+    static void _PruebaConversion(void) {
+        COMPRUEBA(EpochLocal(_Local(2025, 10, 20, 10, 30), 0) == RelojVirtual::EpochLocal(2025, 10, 20, 10, 30, 0),
+                  "hora normal distinta de mktime()");
+        COMPRUEBA(EpochLocal(_Local(2025, 10, 26, 3, 30), 0) == _Utc(2025, 10, 26, 2, 30), "03:30 CET de octubre");
+        COMPRUEBA(EpochLocal(_Local(2025, 3, 30, 1, 30), 0) == _Utc(2025, 3, 30, 0, 30), "01:30 CET de marzo");
+        COMPRUEBA(EpochLocal(_Local(2025, 3, 29, 24 + 3, 0), 0) == _Utc(2025, 3, 30, 1, 0), "día sin normalizar");
+
+        time_t tVerano = _Utc(2025, 10, 26, 0, 30);                         // 02:30 CEST
+        time_t tInvierno = _Utc(2025, 10, 26, 1, 30);                       // 02:30 CET
+        struct tm octubre = _Local(2025, 10, 26, 2, 30);
+        switch (Config::Alarmas::HORA_AMBIGUA) {
+            case Config::Alarmas::AMBIGUA_PRIMERA:
+                COMPRUEBA(EpochLocal(octubre, 0) == tVerano, "02:30 de octubre no es la primera");
+                COMPRUEBA(EpochLocal(octubre, tVerano + 60) == -1, "02:30 de octubre vuelve a sonar");
+                break;
+            case Config::Alarmas::AMBIGUA_SEGUNDA:
+                COMPRUEBA(EpochLocal(octubre, 0) == tInvierno, "02:30 de octubre no es la segunda");
+                COMPRUEBA(EpochLocal(octubre, tInvierno + 60) == -1, "02:30 de octubre vuelve a sonar");
+                break;
+            default:
+                COMPRUEBA(EpochLocal(octubre, 0) == tVerano, "02:30 de octubre no empieza por la primera");
+                COMPRUEBA(EpochLocal(octubre, tVerano + 60) == tInvierno, "02:30 de octubre sin segunda");
+                break;
+        }
+
+        time_t tSalto = _Utc(2025, 3, 30, 1, 0);                            // 03:00 CEST
+        struct tm marzo = _Local(2025, 3, 30, 2, 30);
+        if (Config::Alarmas::HORA_INEXISTENTE == Config::Alarmas::INEXISTENTE_AL_CAMBIO) {
+            COMPRUEBA(EpochLocal(marzo, 0) == tSalto, "02:30 de marzo no suena en el salto");
+            COMPRUEBA(EpochLocal(marzo, tSalto + 60) == -1, "02:30 de marzo suena después del salto");
+        } else {
+            COMPRUEBA(EpochLocal(marzo, 0) == -1, "02:30 de marzo suena aunque se omite");
+        }
+    }
+
+// ============================================================================
+// NOCHE DEL CAMBIO
+// ============================================================================
+
+    /**
+     * @brief Mueve el reloj segundo a segundo de 22:00:30 a 06:00:30 locales
+     * @return Disparos de la alarma de cada hora en punto
+     */
+    static uint32_t _Noche(int nAno, int nMes, int nDiaAnterior) {
+        time_t tInicio = RelojVirtual::EpochLocal(nAno, nMes, nDiaAnterior, 22, 0, 30);
+        time_t tFin = RelojVirtual::EpochLocal(nAno, nMes, nDiaAnterior + 1, 6, 0, 30);
+        RelojVirtual::Fija(tInicio);
+        Alarmas.clear();
+        Alarmas.addExternal0(DOW_TODOS, ALARMA_WILDCARD, 0, 0, _CuentaHora, true);
+        Alarmas.addExternal0(DOW_TODOS, 2, 30, 0, _Anota0230, true);
+        Alarmas.check();
+
+        nHoras = 0;
+        aDisparos0230.clear();
+        while (RelojVirtual::Epoch() < tFin) {
+            RelojVirtual::Avanza(1000000);
+            Alarmas.check();
+        }
+        return nHoras;
+    }
+
+    static void _PruebaOctubre(void) {
+        uint32_t nDisparos = _Noche(2025, 10, 25);                          // 23, 0, 1, 2, (2), 3, 4, 5, 6
+        bool lAmbas = (Config::Alarmas::HORA_AMBIGUA == Config::Alarmas::AMBIGUA_AMBAS);
+        printf("Octubre: %u horas en punto, %u veces las 02:30\n", nDisparos, (unsigned)aDisparos0230.size());
+        COMPRUEBA(nDisparos == (lAmbas ? 9u : 8u), "horas en punto de la noche de octubre");
+        COMPRUEBA(aDisparos0230.size() == (lAmbas ? 2u : 1u), "veces que suenan las 02:30 en octubre");
+        if (!aDisparos0230.empty()) {
+            time_t tEsperado = (Config::Alarmas::HORA_AMBIGUA == Config::Alarmas::AMBIGUA_SEGUNDA)
+                             ? _Utc(2025, 10, 26, 1, 30) : _Utc(2025, 10, 26, 0, 30);
+            COMPRUEBA(aDisparos0230[0] == tEsperado, "instante de las 02:30 de octubre");
+        }
+    }
+
+    static void _PruebaMarzo(void) {
+        uint32_t nDisparos = _Noche(2025, 3, 29);                           // 23, 0, 1, 3, 4, 5, 6 (las 02:00 no existen)
+        bool lAlCambio = (Config::Alarmas::HORA_INEXISTENTE == Config::Alarmas::INEXISTENTE_AL_CAMBIO);
+        printf("Marzo: %u horas en punto, %u veces las 02:30\n", nDisparos, (unsigned)aDisparos0230.size());
+        COMPRUEBA(nDisparos == 7u, "horas en punto de la noche de marzo");
+        COMPRUEBA(aDisparos0230.size() == (lAlCambio ? 1u : 0u), "veces que suenan las 02:30 en marzo");
+        if (lAlCambio && !aDisparos0230.empty()) {
+            COMPRUEBA(aDisparos0230[0] == _Utc(2025, 3, 30, 1, 0), "las 02:30 de marzo no suenan en el salto");
+        }
+    }
+
+int main() {
+    Prueba::Particion("prueba_horalocal");
+    Prueba::Arranca(RelojVirtual::EpochLocal(2025, 3, 29, 21, 0, 0));
+    _PruebaConversion();
+    _PruebaMarzo();
+    _PruebaOctubre();
+    return Prueba::Fin("prueba_horalocal");
+}
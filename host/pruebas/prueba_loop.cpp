@@ -0,0 +1,86 @@
+/**
+ * @file prueba_loop.cpp
+ * @brief loop() nunca se queda bloqueado más de 1 ms
+ *
+ * @details Arranca el sketch el lunes 20/10/2025 a las 10:59:30 y ejecuta
+ *          loop() hasta las 12:01 mientras suenan la hora, las medias y
+ *          secuencias pedidas por WebSocket e I2C, con la calefacción
+ *          encendida. Cada llamada a loop() se mide en el reloj virtual: solo
+ *          avanza si algo dentro de loop() espera (delay(), vTaskDelay()...).
+ *
+ *          **COMPRUEBA:**
+ *          - Ninguna llamada a loop() consume 1 ms o más
+ *          - Han sonado las dos campanas y alguna secuencia (la prueba no es vacía)
+ */
+#include "Prueba.h"
+#include "Auxiliar.h"
+#include <ESPAsyncWebServer.h>
+#include <Wire.h>
+
+extern AsyncWebSocket ws;
+
+struct OrdenProgramada {
+    int nMinuto;                                                            // Minuto de las 11
+    int nSegundo;
+    const char* sMensajeWs;                                                 // nullptr: orden I2C
+    uint8_t nI2C;
+};
+
+static const OrdenProgramada ORDENES[] = {
+    {  5,  0, "Difuntos",          0 },
+    {  8,  0, "CALEFACCION_ON:2",  0 },
+    { 15,  0, nullptr,             Config::States::MISA },
+    { 17,  0, nullptr,             Config::States::STOP },
+    { 20,  0, "Fiesta",            0 },
+    { 20, 20, "PARAR",             0 },
+    { 40,  0, "SECUENCIA:Misa",    0 },
+    { 45,  0, "GET_AGENDA:7",      0 },
+};
+
+int main() {
+    Prueba::Particion("prueba_loop");
+    RelojVirtual::Zona(POSIX_TZ);
+    Prueba::Arranca(RelojVirtual::EpochLocal(2025, 10, 20, 10, 59, 30));
+    time_t tFin = RelojVirtual::EpochLocal(2025, 10, 20, 12, 1, 0);
+    AsyncWebSocketClient* pCliente = ws.HostConecta();
+
+    size_t nOrden = 0;
+    uint64_t nMaxUs = 0;
+    uint32_t nLlamadas = 0;
+    uint32_t nConSecuencia = 0;
+    while (RelojVirtual::Epoch() < tFin) {
+        struct tm local;
+        getLocalTime(&local);
+        const size_t nOrdenes = sizeof(ORDENES) / sizeof(ORDENES[0]);
+        while (nOrden < nOrdenes && local.tm_hour == 11 &&
+               (local.tm_min > ORDENES[nOrden].nMinuto ||
+                (local.tm_min == ORDENES[nOrden].nMinuto && local.tm_sec >= ORDENES[nOrden].nSegundo))) {
+            if (ORDENES[nOrden].sMensajeWs) ws.HostRecibe(pCliente, ORDENES[nOrden].sMensajeWs);
+            else HostI2C::Recibe({ ORDENES[nOrden].nI2C });
+            nOrden++;
+        }
+
+        uint64_t nAntes = RelojVirtual::Micros();
+        loop();
+        uint64_t nDuracion = RelojVirtual::Micros() - nAntes;
+        if (nDuracion > nMaxUs) nMaxUs = nDuracion;
+        nLlamadas++;
+
+        if (Campanario.GetEstadoSecuencia()) {
+            nConSecuencia++;
+            RelojVirtual::Avanza(1000);
+        } else {
+            RelojVirtual::Avanza(100000);
+        }
+    }
+
+    printf("%u llamadas a loop() (%u con secuencia), la más larga %llu us\n",
+           nLlamadas, nConSecuencia, (unsigned long long)nMaxUs);
+    COMPRUEBA(nOrden == sizeof(ORDENES) / sizeof(ORDENES[0]), "todas las órdenes entregadas");
+    COMPRUEBA(nMaxUs < 1000, "loop() bloqueado 1 ms o más");
+    COMPRUEBA(nConSecuencia > 0, "ninguna secuencia en curso");
+    COMPRUEBA(HostGPIO::Subidas(Config::Pins::CAMPANA1) > 0, "la campana de horas no ha sonado");
+    COMPRUEBA(HostGPIO::Subidas(Config::Pins::CAMPANA2) > 0, "la campana de cuartos no ha sonado");
+
+    return Prueba::Fin("prueba_loop");
+}
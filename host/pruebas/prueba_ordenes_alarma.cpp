@@ -0,0 +1,155 @@
+/**
+ * @file prueba_ordenes_alarma.cpp
+ * @brief Las órdenes web de alarmas y las consultas de estado se atienden en loop(),
+ *        no en la tarea del WebSocket
+ *
+ * @details Dos clientes conectados; uno envía los comandos *_ALARMA_WEB,
+ *          GET_AGENDA y las consultas del árbitro, la cola, el jitter, las
+ *          campanas y las secuencias. Cada comando se entrega como lo haría
+ *          async_tcp y después se ejecuta una vuelta de loop().
+ *
+ *          **COMPRUEBA:**
+ *          - Tras entregar ADD/TOGGLE/DELETE_ALARMA_WEB el planificador no ha
+ *            cambiado; tras loop() sí
+ *          - Las confirmaciones llegan a los dos clientes; los errores y los
+ *            listados, solo al que los pidió
+ *          - Las excepciones se crean y eliminan igual
+ *          - Las consultas de estado solo se responden desde loop() y solo a
+ *            quien las pidió
+ *          - La agenda de 31 días se corta en MAX_EVENTOS_AGENDA, marcada
+ *            "truncada" y con JSON válido
+ *          - Un listado pedido por un cliente que se desconecta antes de
+ *            loop() se descarta sin más
+ */
+#include "Prueba.h"
+#include "Alarmas.h"
+#include <ESPAsyncWebServer.h>
+#include <ArduinoJson.h>
+
+extern AsyncWebSocket ws;
+extern AlarmScheduler Alarmas;
+
+static AsyncWebSocketClient* pPide = nullptr;
+static AsyncWebSocketClient* pOtro = nullptr;
+
+static uint16_t _CuentaPersonalizables(void) {
+    uint16_t n = 0;
+    for (uint16_t i = 0; i < Alarmas.count(); ++i) {
+        if (Alarmas.get(i)->esPersonalizable) n++;
+    }
+    return n;
+}
+
+static bool _Habilitada(int idWeb) {
+    for (uint16_t i = 0; i < Alarmas.count(); ++i) {
+        if (Alarmas.get(i)->idWeb == idWeb) return Alarmas.get(i)->habilitada;
+    }
+    return false;
+}
+
+/**
+ * @brief Último mensaje de un cliente que empieza por sPrefijo ("" si no hay)
+ */
+static String _Recibido(AsyncWebSocketClient* pCliente, const char* sPrefijo) {
+    for (auto it = pCliente->aTextos.rbegin(); it != pCliente->aTextos.rend(); ++it) {
+        if (it->startsWith(sPrefijo)) return *it;
+    }
+    return "";
+}
+
+static void _Envia(const char* sMensaje) {
+    pPide->aTextos.clear();
+    pOtro->aTextos.clear();
+    ws.HostRecibe(pPide, sMensaje);
+}
+
+int main() {
+    Prueba::Particion("prueba_ordenes_alarma");
+    Prueba::Arranca(RelojVirtual::EpochLocal(2025, 10, 21, 15, 0, 0));
+    pPide = ws.HostConecta();
+    pOtro = ws.HostConecta();
+    loop();
+    uint16_t nInicial = _CuentaPersonalizables();
+
+    _Envia("ADD_ALARMA_WEB:{\"nombre\":\"Misa\",\"dia\":1,\"hora\":12,\"minuto\":0,\"accion\":\"MISA\"}");
+    COMPRUEBA(_CuentaPersonalizables() == nInicial, "ADD_ALARMA_WEB aplicado fuera de loop()");
+    COMPRUEBA(_Recibido(pPide, "ALARMA_CREADA_WEB:") == "", "confirmación antes de aplicar la orden");
+    loop();
+    COMPRUEBA(_CuentaPersonalizables() == nInicial + 1, "ADD_ALARMA_WEB no aplicado en loop()");
+    String sCreada = _Recibido(pPide, "ALARMA_CREADA_WEB:");
+    COMPRUEBA(sCreada != "" && _Recibido(pOtro, "ALARMA_CREADA_WEB:") == sCreada, "ALARMA_CREADA_WEB no llega a todos");
+    int idWeb = sCreada.substring(strlen("ALARMA_CREADA_WEB:")).toInt();
+
+    char sMensaje[96];
+    snprintf(sMensaje, sizeof(sMensaje), "TOGGLE_ALARMA_WEB:{\"id\":%d,\"habilitada\":false}", idWeb);
+    _Envia(sMensaje);
+    COMPRUEBA(_Habilitada(idWeb), "TOGGLE_ALARMA_WEB aplicado fuera de loop()");
+    loop();
+    COMPRUEBA(!_Habilitada(idWeb), "TOGGLE_ALARMA_WEB no aplicado en loop()");
+    COMPRUEBA(_Recibido(pOtro, "ALARMA_TOGGLED_WEB:").endsWith(":false"), "ALARMA_TOGGLED_WEB no llega a todos");
+
+    snprintf(sMensaje, sizeof(sMensaje), "ADD_EXCEPCION_ALARMA_WEB:{\"id\":%d,\"fecha\":\"2025-10-26\",\"tipo\":\"OMITIR\"}", idWeb);
+    _Envia(sMensaje);
+    COMPRUEBA(Alarmas.countExcepciones() == 0, "ADD_EXCEPCION_ALARMA_WEB aplicado fuera de loop()");
+    loop();
+    COMPRUEBA(Alarmas.countExcepciones() == 1, "ADD_EXCEPCION_ALARMA_WEB no aplicado en loop()");
+    COMPRUEBA(_Recibido(pOtro, "EXCEPCION_CREADA_WEB:") != "", "EXCEPCION_CREADA_WEB no llega a todos");
+
+    _Envia("GET_EXCEPCIONES_ALARMA_WEB");
+    loop();
+    COMPRUEBA(_Recibido(pPide, "EXCEPCIONES_ALARMA_WEB:").indexOf("2025-10-26") >= 0, "listado de excepciones");
+    COMPRUEBA(_Recibido(pOtro, "EXCEPCIONES_ALARMA_WEB:") == "", "el listado llega a quien no lo pidió");
+
+    snprintf(sMensaje, sizeof(sMensaje), "DELETE_EXCEPCION_ALARMA_WEB:{\"id\":%d,\"fecha\":\"2025-10-26\"}", idWeb);
+    _Envia(sMensaje);
+    loop();
+    COMPRUEBA(Alarmas.countExcepciones() == 0, "DELETE_EXCEPCION_ALARMA_WEB no aplicado en loop()");
+
+    snprintf(sMensaje, sizeof(sMensaje), "DELETE_ALARMA_WEB:{\"id\":%d}", idWeb);
+    _Envia(sMensaje);
+    COMPRUEBA(_CuentaPersonalizables() == nInicial + 1, "DELETE_ALARMA_WEB aplicado fuera de loop()");
+    loop();
+    COMPRUEBA(_CuentaPersonalizables() == nInicial, "DELETE_ALARMA_WEB no aplicado en loop()");
+    COMPRUEBA(_Recibido(pOtro, "ALARMA_ELIMINADA_WEB:") != "", "ALARMA_ELIMINADA_WEB no llega a todos");
+
+    _Envia(sMensaje);                                                       // Ya no existe
+    loop();
+    COMPRUEBA(_Recibido(pPide, "ERROR_ALARMA_WEB:") != "", "sin error al eliminar una alarma inexistente");
+    COMPRUEBA(_Recibido(pOtro, "ERROR_ALARMA_WEB:") == "", "el error llega a quien no lo pidió");
+
+    _Envia("GET_AGENDA:7");
+    COMPRUEBA(_Recibido(pPide, "AGENDA:") == "", "agenda calculada fuera de loop()");
+    loop();
+    COMPRUEBA(_Recibido(pPide, "AGENDA:") != "", "agenda no enviada desde loop()");
+    COMPRUEBA(_Recibido(pOtro, "AGENDA:") == "", "la agenda llega a quien no la pidió");
+
+    _Envia("GET_AGENDA:31");                                                // Más toques que MAX_EVENTOS_AGENDA
+    loop();
+    JsonDocument agenda;
+    COMPRUEBA(!deserializeJson(agenda, _Recibido(pPide, "AGENDA:").substring(strlen("AGENDA:"))), "agenda truncada sin JSON válido");
+    COMPRUEBA(agenda["truncada"] | false, "agenda de 31 días sin marcar truncada");
+    COMPRUEBA(agenda["eventos"].size() == Config::Alarmas::MAX_EVENTOS_AGENDA, "agenda truncada sin MAX_EVENTOS_AGENDA eventos");
+
+    static const char* const CONSULTAS[][2] = {                             // Comando y prefijo de la respuesta
+        { "GET_ARBITRO", "ARBITRO:" },
+        { "GET_COLA_COMANDOS", "COLA_COMANDOS:" },
+        { "GET_JITTER_CAMPANARIO", "JITTER_CAMPANARIO:" },
+        { "GET_CAMPANAS", "CAMPANAS:" },
+        { "GET_SECUENCIAS", "SECUENCIAS:" },
+    };
+    for (const auto& consulta : CONSULTAS) {
+        _Envia(consulta[0]);
+        COMPRUEBA(_Recibido(pPide, consulta[1]) == "", "consulta de estado respondida fuera de loop()");
+        loop();
+        COMPRUEBA(_Recibido(pPide, consulta[1]) != "", "consulta de estado sin respuesta desde loop()");
+        COMPRUEBA(_Recibido(pOtro, consulta[1]) == "", "la consulta de estado llega a quien no la pidió");
+    }
+
+    _Envia("GET_ALARMAS_WEB");
+    ws.HostDesconecta(pPide);                                               // Se va antes de que loop() atienda la orden
+    pOtro->aTextos.clear();
+    loop();
+    COMPRUEBA(_Recibido(pOtro, "ALARMAS_WEB:") == "", "el listado de un cliente desconectado llega a otro");
+
+    return Prueba::Fin("prueba_ordenes_alarma");
+}
@@ -0,0 +1,60 @@
+/**
+ * @file prueba_semana.cpp
+ * @brief Una semana de campanario en el reloj virtual, con el cambio de hora de octubre
+ *
+ * @details Arranca el sketch el lunes 20/10/2025 a las 00:00 y ejecuta loop()
+ *          hasta el lunes siguiente. Con secuencia en curso el reloj avanza de
+ *          1 ms en 1 ms (como el loop() real); en reposo, de segundo en segundo.
+ *
+ *          **COMPRUEBA:**
+ *          - Cada día suenan las horas de 8 a 22 (105 golpes) y sus medias (15)
+ *          - Ningún golpe en horario nocturno, tampoco en la hora repetida del domingo
+ */
+#include "Prueba.h"
+#include "Auxiliar.h"
+
+static const uint64_t SEGUNDO_US = 1000000ULL;
+
+int main() {
+    Prueba::Particion("prueba_semana");
+    RelojVirtual::Zona(POSIX_TZ);
+    time_t tInicio = RelojVirtual::EpochLocal(2025, 10, 20, 0, 0, 0);
+    time_t tFin = RelojVirtual::EpochLocal(2025, 10, 27, 0, 0, 0);
+
+    Prueba::Arranca(tInicio);
+    uint64_t nMicrosInicio = RelojVirtual::Micros();
+    time_t tEpochInicio = RelojVirtual::Epoch();
+    uint64_t nMicrosFin = nMicrosInicio + (uint64_t)(tFin - tEpochInicio) * SEGUNDO_US;
+
+    while (RelojVirtual::Micros() < nMicrosFin) {
+        loop();
+        if (Campanario.GetEstadoSecuencia()) {
+            RelojVirtual::Avanza(1000);
+        } else {
+            RelojVirtual::Avanza(SEGUNDO_US - RelojVirtual::Micros() % SEGUNDO_US);
+        }
+    }
+
+    int aHoras[7] = {};
+    int aMedias[7] = {};
+    int nNocturnos = 0;
+    for (const HostGPIO::Cambio& cambio : HostGPIO::Cambios()) {
+        if (!cambio.lAlto) continue;
+        time_t tGolpe = tEpochInicio + (time_t)((cambio.nMicros - nMicrosInicio) / SEGUNDO_US);
+        struct tm local;
+        localtime_r(&tGolpe, &local);
+        int nDia = (local.tm_wday + 6) % 7;                                 // 0 = lunes
+        if (local.tm_hour >= Config::Time::NOCHE_INICIO_HORA || local.tm_hour < Config::Time::NOCHE_FIN_HORA) nNocturnos++;
+        if (cambio.pin == Config::Pins::CAMPANA1) aHoras[nDia]++;
+        if (cambio.pin == Config::Pins::CAMPANA2) aMedias[nDia]++;
+    }
+
+    for (int nDia = 0; nDia < 7; ++nDia) {
+        printf("dia %d: %d golpes de hora, %d de media\n", nDia, aHoras[nDia], aMedias[nDia]);
+        COMPRUEBA(aHoras[nDia] == 105, "golpes de hora de 8 a 22");
+        COMPRUEBA(aMedias[nDia] == 15, "medias de 8:30 a 22:30");
+    }
+    COMPRUEBA(nNocturnos == 0, "golpes en horario nocturno");
+
+    return Prueba::Fin("prueba_semana");
+}
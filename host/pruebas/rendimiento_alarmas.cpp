@@ -0,0 +1,69 @@
+/**
+ * @file rendimiento_alarmas.cpp
+ * @brief Coste por pasada de loop() de AlarmScheduler::check() con 16 y 500 alarmas
+ *
+ * @details Registra N alarmas horarias repartidas por los minutos y llama a
+ *          check() cada milisegundo virtual durante una hora, como haría
+ *          loop(). Se mide el tiempo del PC de cada llamada y se separan
+ *          las pasadas sin disparo (camino rápido, sin mirar las alarmas) de
+ *          las que disparan y recalculan las alarmas vencidas. Sirve para
+ *          comparar tamaños, no como cifra del ESP32.
+ *
+ *          **COMPRUEBA:**
+ *          - Cada alarma dispara exactamente una vez en la hora
+ *          - segundosHastaProximo() coincide con el próximo minuto programado
+ */
+#include "Prueba.h"
+#include "Alarmas.h"
+#include <chrono>
+
+extern AlarmScheduler Alarmas;
+
+static const uint16_t TAMANOS[2] = { 16, 500 };
+static_assert(500 <= AlarmScheduler::MAX_ALARMAS, "El caso grande no cabe en el planificador");
+static uint32_t nDisparos = 0;
+
+static void _Cuenta(void) { nDisparos++; }
+
+static void _Mide(uint16_t nAlarmas, time_t tInicio) {
+    Alarmas.clear();
+    for (uint16_t i = 0; i < nAlarmas; ++i) {                                // Minutos 1..59 repartidos: 0 queda libre para la prueba de segundosHastaProximo
+        Alarmas.addExternal0(DOW_TODOS, ALARMA_WILDCARD, (uint8_t)(1 + (i * 7) % 59), 0, _Cuenta, true);
+    }
+    RelojVirtual::Fija(tInicio);
+    Alarmas.check();                                                        // Construye el índice
+    COMPRUEBA(Alarmas.segundosHastaProximo() == 60, "el próximo disparo no es el minuto 1");
+
+    nDisparos = 0;
+    uint64_t nSumaNs = 0;
+    uint64_t nSumaDisparoNs = 0;
+    uint32_t nLlamadas = 0;
+    uint32_t nConDisparo = 0;
+    while (RelojVirtual::Epoch() < tInicio + 3600) {
+        RelojVirtual::Avanza(1000);
+        uint32_t nAntes = nDisparos;
+        auto t0 = std::chrono::steady_clock::now();
+        Alarmas.check();
+        uint64_t nNs = (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - t0).count();
+        if (nDisparos != nAntes) {
+            nSumaDisparoNs += nNs;
+            nConDisparo++;
+        } else {
+            nSumaNs += nNs;
+            nLlamadas++;
+        }
+    }
+
+    printf("%3u alarmas: %u pasadas sin disparo, media %llu ns; %u con disparo, media %llu ns; %u disparos\n",
+           nAlarmas, nLlamadas, (unsigned long long)(nSumaNs / nLlamadas),
+           nConDisparo, (unsigned long long)(nConDisparo ? nSumaDisparoNs / nConDisparo : 0), nDisparos);
+    COMPRUEBA(nDisparos == nAlarmas, "alguna alarma no ha disparado una sola vez");
+}
+
+int main() {
+    Prueba::Particion("rendimiento_alarmas");
+    time_t tInicio = RelojVirtual::EpochLocal(2025, 10, 21, 15, 0, 0);     // Martes por la tarde, fuera del horario nocturno
+    Prueba::Arranca(tInicio - 60);
+    for (int k = 0; k < 2; ++k) _Mide(TAMANOS[k], tInicio + k * 3600);   // Una hora cada uno, sin retroceder el reloj
+    return Prueba::Fin("rendimiento_alarmas");
+}
@@ -0,0 +1,101 @@
+/**
+ * @file rendimiento_arranque.cpp
+ * @brief Arranque de las alarmas desde la instantánea binaria frente al JSON
+ *
+ * @details Con 100 alarmas personalizables compara lo que hacía el arranque
+ *          antes de /alarmas.bin (readString() y deserializeJson() de
+ *          alarmas_personalizadas.json, y restaurar los callbacks) con
+ *          IniciaAlarmas() completo desde la instantánea, que además carga el
+ *          estado, las excepciones y las alarmas de sistema.
+ *
+ *          El tiempo es el del PC (mejor de REPETICIONES arranques) y el JSON
+ *          pasa por el ArduinoJson de host/stubs, no por la biblioteca real.
+ *          Sirve para comparar, no como cifra del ESP32. No se mide el heap:
+ *          los textos de la instantánea se reservan con malloc() y Memoria.h
+ *          solo ve new/delete.
+ *
+ *          **COMPRUEBA:**
+ *          - Sin instantánea el arranque lee el JSON y deja escrita la instantánea
+ *          - El siguiente arranque lee la instantánea y obtiene las mismas alarmas
+ *          - Todas las personalizables recuperan su callback
+ *          - Las alarmas de sistema no heredan datos de una personalizable
+ */
+#include "Prueba.h"
+#include "Alarmas.h"
+#include "Auxiliar.h"
+#include <chrono>
+
+extern AlarmScheduler Alarmas;
+
+static const int REPETICIONES = 50;
+static const uint16_t PERSONALIZABLES = 100;
+
+static void _Nada(uint16_t) {}
+
+static uint16_t _CuentaPersonalizables(bool lConCallback) {
+    uint16_t n = 0;
+    for (uint16_t i = 0; i < Alarmas.count(); ++i) {
+        const Alarm* pAlarma = Alarmas.get(i);
+        if (pAlarma->esPersonalizable && (!lConCallback || pAlarma->accionExt)) n++;
+    }
+    return n;
+}
+
+static bool _DesdeInstantanea(void) {
+    return Alarmas.obtenerEstadisticasJSON().indexOf("\"origen\":\"instantanea\"") >= 0;
+}
+
+static uint64_t _Ahora(void) {
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+int main() {
+    Prueba::Particion("rendimiento_arranque");
+    Prueba::Arranca(RelojVirtual::EpochLocal(2025, 10, 21, 15, 0, 0));
+
+    for (uint16_t n = _CuentaPersonalizables(false); n < PERSONALIZABLES; ++n) {
+        char sNombre[16];
+        snprintf(sNombre, sizeof(sNombre), "Misa %u", n);
+        Alarmas.addPersonalizable(sNombre, "Prueba de arranque", DOW_DOMINGO, (uint8_t)(8 + n % 12), (uint8_t)(n % 60),
+                                  "MISA", 0, _Nada, true);
+    }
+    IniciaAlarmas();                                                        // Vuelca los cambios web al registro
+    Alarmas.guardarPersonalizablesEnJSON();
+    String sExportado = Alarmas.exportarJSON();
+
+    SPIFFS.remove("/alarmas.bin");                                          // Como el primer arranque tras actualizar
+    SPIFFS.remove("/alarmas.bin.tmp");
+    SPIFFS.remove("/alarmas_cambios.log");
+    IniciaAlarmas();
+    COMPRUEBA(!_DesdeInstantanea(), "sin instantánea no se ha leído el JSON");
+    COMPRUEBA(SPIFFS.exists("/alarmas.bin"), "el arranque desde JSON no escribe la instantánea");
+    COMPRUEBA(_CuentaPersonalizables(false) == PERSONALIZABLES, "alarmas leídas del JSON (¿sistema marcadas como personalizables?)");
+
+    IniciaAlarmas();
+    COMPRUEBA(_DesdeInstantanea(), "el segundo arranque no lee la instantánea");
+    COMPRUEBA(_CuentaPersonalizables(true) == PERSONALIZABLES, "personalizables sin callback tras la instantánea");
+    COMPRUEBA(Alarmas.exportarJSON() == sExportado, "la instantánea no reproduce las alarmas");
+
+    uint64_t nMejorJson = UINT64_MAX;
+    uint64_t nMejorBinario = UINT64_MAX;
+    for (int r = 0; r < REPETICIONES; ++r) {
+        Alarmas.clear();
+        uint64_t t0 = _Ahora();
+        Alarmas.cargarPersonalizablesDesdeJSON();                           // Arranque anterior
+        RestaurarCallbacksAlarmas();
+        nMejorJson = std::min(nMejorJson, _Ahora() - t0);
+
+        Alarmas.clear();
+        t0 = _Ahora();
+        IniciaAlarmas();                                                    // Arranque actual
+        nMejorBinario = std::min(nMejorBinario, _Ahora() - t0);
+    }
+
+    printf("%u alarmas, JSON de %u bytes\n", PERSONALIZABLES, sExportado.length());
+    printf("JSON (antes):        %6llu us\n", (unsigned long long)(nMejorJson / 1000));
+    printf("Instantánea (ahora): %6llu us\n", (unsigned long long)(nMejorBinario / 1000));
+    COMPRUEBA(_DesdeInstantanea(), "la medida no ha arrancado desde la instantánea");
+
+    return Prueba::Fin("rendimiento_arranque");
+}
@@ -0,0 +1,168 @@
+/**
+ * @file rendimiento_comandos.cpp
+ * @brief Coste de despachar un comando WebSocket: tabla hash frente a la cadena de if
+ *
+ * @details Mide solo la elección del manejador, sin ejecutarlo:
+ *          - Ahora: separar el token en el primer ':' (memchr) y buscaComando()
+ *            sobre la tabla que construye registraComandosWebSocket()
+ *          - Antes: procesaMensajeWebSocket() tal como era, reproducido aquí sin
+ *            las acciones: copia del mensaje a un String y ~40 comparaciones
+ *            == / startsWith() en orden, más la segunda cadena de
+ *            procesarComandoAlarma() para los *_ALARMA_WEB
+ *
+ *          El tiempo es el del PC (mejor de RONDAS de REPETICIONES llamadas);
+ *          sirve para comparar, no como cifra del ESP32.
+ *
+ *          **COMPRUEBA:**
+ *          - Todos los comandos de la cadena anterior tienen manejador en la tabla
+ *          - Un token desconocido o que solo es prefijo de otro no tiene manejador
+ */
+#include "Prueba.h"
+#include "Servidor.h"
+#include <chrono>
+
+static const int RONDAS = 5;
+static const int REPETICIONES = 200000;
+
+static const char* const MENSAJES[] = {
+    "Misa",
+    "GET_ARBITRO",
+    "CALEFACCION_ON:30",
+    "ADD_ALARMA_WEB:{\"nombre\":\"Misa\",\"dia\":1,\"hora\":12,\"minuto\":0,\"accion\":\"MISA\"}",
+    "RESET_SYSTEM",
+    "NO_EXISTE",
+};
+
+// ============================================================================
+// CADENA ANTERIOR (referencia)
+// ============================================================================
+
+    static int _ComandoAlarmaAnterior(const String& comando) {
+        if (comando == "ADD_ALARMA_WEB") return 100;
+        else if (comando == "EDIT_ALARMA_WEB") return 101;
+        else if (comando == "DELETE_ALARMA_WEB") return 102;
+        else if (comando == "TOGGLE_ALARMA_WEB") return 103;
+        else if (comando == "GET_ALARMAS_WEB") return 104;
+        else if (comando == "GET_STATS_ALARMAS_WEB") return 105;
+        else if (comando == "ADD_EXCEPCION_ALARMA_WEB") return 106;
+        else if (comando == "DELETE_EXCEPCION_ALARMA_WEB") return 107;
+        else if (comando == "GET_EXCEPCIONES_ALARMA_WEB") return 108;
+        return 0;
+    }
+
+    /**
+     * @return Rama elegida (> 0) o 0 si el mensaje no se reconoce
+     */
+    static int DespachoAnterior(const uint8_t* data, size_t len) {
+        String mensaje = String((const char*)data).substring(0, len);
+        if (mensaje == "Difuntos") return 1;
+        else if (mensaje == "Misa") return 2;
+        else if (mensaje == "Fiesta") return 3;
+        else if (mensaje == "PARAR") return 4;
+        else if (mensaje.startsWith("EMERGENCIA:")) return 5;
+        else if (mensaje == "GET_ARBITRO") return 6;
+        else if (mensaje == "GET_AGENDA" || mensaje.startsWith("GET_AGENDA:")) return 7;
+        else if (mensaje.startsWith("CALEFACCION_ON:")) return 8;
+        else if (mensaje == "CALEFACCION_OFF") return 9;
+        else if (mensaje == "GET_CALEFACCION") return 10;
+        else if (mensaje == "GET_TIEMPOCALEFACCION") return 11;
+        else if (mensaje == "GET_CAMPANARIO") return 12;
+        else if (mensaje == "GET_JITTER_CAMPANARIO") return 13;
+        else if (mensaje == "RESET_JITTER_CAMPANARIO") return 14;
+        else if (mensaje == "GET_CAMPANAS") return 15;
+        else if (mensaje.startsWith("SET_PULSO_CAMPANA:")) return 16;
+        else if (mensaje.startsWith("PROBAR_CAMPANA:")) return 17;
+        else if (mensaje == "GET_SECUENCIAS") return 18;
+        else if (mensaje.startsWith("SECUENCIA:")) return 19;
+        else if (mensaje == "GET_SECUENCIA_ACTIVA") return 20;
+        else if (mensaje.startsWith("ADD_ALARMA_WEB:") ||
+                 mensaje.startsWith("EDIT_ALARMA_WEB:") ||
+                 mensaje.startsWith("DELETE_ALARMA_WEB:") ||
+                 mensaje.startsWith("TOGGLE_ALARMA_WEB:") ||
+                 mensaje.startsWith("ADD_EXCEPCION_ALARMA_WEB:") ||
+                 mensaje.startsWith("DELETE_EXCEPCION_ALARMA_WEB:") ||
+                 mensaje == "GET_EXCEPCIONES_ALARMA_WEB" ||
+                 mensaje == "GET_ALARMAS_WEB" ||
+                 mensaje == "GET_STATS_ALARMAS_WEB") {
+            int separador = mensaje.indexOf(':');
+            String comando = (separador > 0) ? mensaje.substring(0, separador) : mensaje;
+            String datos = (separador > 0) ? mensaje.substring(separador + 1) : "{}";
+            return _ComandoAlarmaAnterior(comando);
+        }
+        else if (mensaje.startsWith("SET_IDIOMA:")) return 21;
+        else if (mensaje == "GET_CONFIG") return 22;
+        else if (mensaje == "GET_IDIOMA") return 23;
+        else if (mensaje.startsWith("SAVE_CONFIG_TELEGRAM:")) return 24;
+        else if (mensaje == "GET_CONFIG_TELEGRAM") return 25;
+        else if (mensaje.startsWith("VERIFY_PIN:")) return 26;
+        else if (mensaje == "GET_VERSION_OTA") return 27;
+        else if (mensaje == "CHECK_UPDATE_OTA") return 28;
+        else if (mensaje == "START_UPDATE_FIRMWARE" || mensaje == "START_UPDATE_SPIFFS" || mensaje == "START_UPDATE_COMPLETE") return 29;
+        else if (mensaje == "RESET_SYSTEM") return 30;
+        return 0;
+    }
+
+// ============================================================================
+// TABLA HASH (ahora)
+// ============================================================================
+
+    static ManejadorComando DespachoActual(const uint8_t* data, size_t len) {
+        const char* pMensaje = (const char*)data;
+        const char* pSeparador = (const char*)memchr(pMensaje, ':', len);
+        size_t nToken = pSeparador ? (size_t)(pSeparador - pMensaje) : len;
+        return buscaComando(pMensaje, nToken);
+    }
+
+// ============================================================================
+
+template <typename F>
+static uint64_t _MejorNs(F despacho) {
+    uint64_t nMejor = UINT64_MAX;
+    for (int r = 0; r < RONDAS; ++r) {
+        auto t0 = std::chrono::steady_clock::now();
+        for (int i = 0; i < REPETICIONES; ++i) despacho();
+        uint64_t nNs = (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - t0).count();
+        nMejor = std::min(nMejor, nNs / REPETICIONES);
+    }
+    return nMejor;
+}
+
+int main() {
+    registraComandosWebSocket();
+
+    static const char* const COMANDOS_ANTERIORES[] = {                      // Tokens que reconocía la cadena anterior
+        "Difuntos", "Misa", "Fiesta", "PARAR", "EMERGENCIA", "GET_ARBITRO", "GET_AGENDA",
+        "CALEFACCION_ON", "CALEFACCION_OFF", "GET_CALEFACCION", "GET_TIEMPOCALEFACCION",
+        "GET_CAMPANARIO", "GET_JITTER_CAMPANARIO", "RESET_JITTER_CAMPANARIO", "GET_CAMPANAS",
+        "SET_PULSO_CAMPANA", "PROBAR_CAMPANA", "GET_SECUENCIAS", "SECUENCIA", "GET_SECUENCIA_ACTIVA",
+        "ADD_ALARMA_WEB", "EDIT_ALARMA_WEB", "DELETE_ALARMA_WEB", "TOGGLE_ALARMA_WEB",
+        "GET_ALARMAS_WEB", "GET_STATS_ALARMAS_WEB", "ADD_EXCEPCION_ALARMA_WEB",
+        "DELETE_EXCEPCION_ALARMA_WEB", "GET_EXCEPCIONES_ALARMA_WEB", "SET_IDIOMA", "GET_CONFIG",
+        "GET_IDIOMA", "SAVE_CONFIG_TELEGRAM", "GET_CONFIG_TELEGRAM", "VERIFY_PIN", "GET_VERSION_OTA",
+        "CHECK_UPDATE_OTA", "START_UPDATE_FIRMWARE", "START_UPDATE_SPIFFS", "START_UPDATE_COMPLETE",
+        "RESET_SYSTEM",
+    };
+    for (const char* sComando : COMANDOS_ANTERIORES) {
+        if (!buscaComando(sComando, strlen(sComando))) {
+            fprintf(stderr, "Sin manejador: %s\n", sComando);
+            COMPRUEBA(false, "un comando de la cadena anterior no está en la tabla");
+        }
+    }
+    COMPRUEBA(buscaComando("NO_EXISTE", 9) == nullptr, "token desconocido con manejador");
+    COMPRUEBA(buscaComando("GET_", 4) == nullptr, "un prefijo encuentra manejador");
+    COMPRUEBA(buscaComando("Misa", 3) == nullptr, "\"Mis\" encuentra manejador");
+
+    printf("%-24s %10s %10s\n", "Mensaje", "antes ns", "ahora ns");
+    for (const char* sMensaje : MENSAJES) {
+        const uint8_t* pDatos = (const uint8_t*)sMensaje;
+        size_t nDatos = strlen(sMensaje);
+        volatile int nRama = 0;
+        volatile ManejadorComando pManejador = nullptr;
+        uint64_t nAntes = _MejorNs([&] { nRama = DespachoAnterior(pDatos, nDatos); });
+        uint64_t nAhora = _MejorNs([&] { pManejador = DespachoActual(pDatos, nDatos); });
+        printf("%-24.24s %10llu %10llu\n", sMensaje, (unsigned long long)nAntes, (unsigned long long)nAhora);
+        COMPRUEBA((nRama != 0) == (pManejador != nullptr), "la tabla y la cadena anterior no coinciden");
+    }
+
+    return Prueba::Fin("rendimiento_comandos");
+}
@@ -0,0 +1,169 @@
+/**
+ * @file rendimiento_secuencias.cpp
+ * @brief Pico de heap y tiempo de carga de un Secuencias.json de 500 pasos
+ *
+ * @details Compara CAMPANARIO::CargarSecuencias() (_ParseaSecuencias, por
+ *          bloques sobre el pool fijo) con el analizador anterior, reproducido
+ *          aquí tal cual era: readString() del archivo entero y tres pasadas
+ *          de indexOf()/substring() con un String por paso y por campo.
+ *
+ *          El archivo tiene difuntos (200 pasos), misa (150) y fiesta (150).
+ *          El tiempo es el del PC (mejor de REPETICIONES cargas); sirve para
+ *          comparar, no como cifra del ESP32. El heap cuenta new/delete.
+ *
+ *          **COMPRUEBA:**
+ *          - Los dos cargan los 500 pasos
+ *          - El pico de heap del analizador por bloques es menor que el anterior
+ */
+#include "Prueba.h"
+#include "Memoria.h"
+#include "Campanario.h"
+#include <ArduinoJson.h>
+#include <chrono>
+
+static const int REPETICIONES = 200;
+static const int PASOS[3] = { 200, 150, 150 };
+static const char* NOMBRES[3] = { "difuntos", "misa", "fiesta" };
+
+// ============================================================================
+// ANALIZADOR ANTERIOR (referencia)
+// ============================================================================
+
+    static long _LeeCampoPaso(const String& obj, const char* clave, long nDefecto) {
+        int idx = obj.indexOf(String("\"") + clave + "\"");
+        if (idx < 0) return nDefecto;
+        int valStart = obj.indexOf(":", idx) + 1;
+        return obj.substring(valStart).toInt();
+    }
+
+    static int _FinArray(const String& texto, int inicio) {
+        if (inicio < 0) return -1;
+        int nNivel = 0;
+        for (int i = inicio; i < (int)texto.length(); ++i) {
+            if (texto[i] == '[') nNivel++;
+            else if (texto[i] == ']' && --nNivel == 0) return i;
+        }
+        return -1;
+    }
+
+    static int CargaAnterior(InstruccionToque* aSecuencias[3]) {
+        File file = SPIFFS.open("/Secuencias.json", "r");
+        String jsonContent = file.readString();
+        file.close();
+        int nTotal = 0;
+        for (int s = 0; s < 3; ++s) {                                       // Una pasada por secuencia, como las tres copias originales
+            int start = jsonContent.indexOf(String("\"") + NOMBRES[s] + "\"");
+            if (start <= 0) continue;
+            int startPasos = jsonContent.indexOf("\"pasos\"", start);
+            int startArray = jsonContent.indexOf("[", startPasos);
+            int endArray = _FinArray(jsonContent, startArray);
+            if (startArray <= 0 || endArray <= startArray) continue;
+            String pasosStr = jsonContent.substring(startArray + 1, endArray);
+            int count = 0;
+            for (unsigned i = 0; i < pasosStr.length(); i++) if (pasosStr[i] == '{') count++;
+            aSecuencias[s] = new InstruccionToque[count + 1];
+            int currentPaso = 0;
+            int pos = 0;
+            while (currentPaso < count && pos < (int)pasosStr.length()) {
+                int objStart = pasosStr.indexOf("{", pos);
+                int objEnd = pasosStr.indexOf("}", objStart);
+                if (objStart < 0 || objEnd < 0) break;
+                String obj = pasosStr.substring(objStart, objEnd + 1);
+                InstruccionToque& ins = aSecuencias[s][currentPaso];
+                ins = { OP_TOQUE, 0, 0, 0, 0, 0 };
+                int campanaIdx = obj.indexOf("\"campana\"");
+                if (campanaIdx >= 0) ins.mascaraCampanas = MascaraCampana((int)obj.substring(obj.indexOf(":", campanaIdx) + 1).toInt());
+                ins.repeticiones = (uint16_t)_LeeCampoPaso(obj, "repeticiones", 1);
+                ins.intervaloMs = (uint32_t)_LeeCampoPaso(obj, "intervalo", 0);
+                ins.pulsoMs = (uint16_t)_LeeCampoPaso(obj, "pulso", 0);
+                currentPaso++;
+                pos = objEnd + 1;
+            }
+            aSecuencias[s][currentPaso] = { OP_FIN, 0, 0, 0, 0, 0 };
+            nTotal += currentPaso;
+        }
+        return nTotal;
+    }
+
+// ============================================================================
+// BANCO
+// ============================================================================
+
+    static void EscribeArchivo(void) {
+        File file = SPIFFS.open("/Secuencias.json", "w");
+        file.print("{\n");
+        for (int s = 0; s < 3; ++s) {
+            file.printf("  \"%s\": {\n    \"pasos\": [\n", NOMBRES[s]);
+            for (int p = 0; p < PASOS[s]; ++p) {
+                file.printf("      {\"campana\": %d, \"repeticiones\": %d, \"intervalo\": %d, \"pulso\": %d}%s\n",
+                            p % 2, 1 + p % 5, 1000 + 250 * (p % 8), 150, p + 1 < PASOS[s] ? "," : "");
+            }
+            file.printf("    ]\n  }%s\n", s < 2 ? "," : "");
+        }
+        file.print("}\n");
+    }
+
+    static int PasosCargados(CAMPANARIO& campanario) {
+        JsonDocument doc;
+        deserializeJson(doc, campanario.GetSecuenciasJSON());
+        int nPasos = 0;
+        for (JsonObject sec : doc["secuencias"].as<JsonArray>()) nPasos += sec["pasos"] | 0;
+        return nPasos;
+    }
+
+    struct Medida {
+        double nMejorUs = 1e30;
+        size_t nPicoBytes = 0;
+        int nPasos = 0;
+    };
+
+    template <typename Carga>
+    static Medida Mide(Carga carga) {
+        Medida medida;
+        for (int n = 0; n < REPETICIONES; ++n) {
+            Memoria::ReiniciaPico();
+            size_t nBase = Memoria::Actual();
+            auto tInicio = std::chrono::steady_clock::now();
+            medida.nPasos = carga();
+            auto tFin = std::chrono::steady_clock::now();
+            double nUs = std::chrono::duration<double, std::micro>(tFin - tInicio).count();
+            if (nUs < medida.nMejorUs) medida.nMejorUs = nUs;
+            medida.nPicoBytes = Memoria::Pico() - nBase;
+        }
+        return medida;
+    }
+
+int main() {
+    Prueba::Particion("rendimiento_secuencias");
+    SPIFFS.begin(true);
+    EscribeArchivo();
+    File file = SPIFFS.open("/Secuencias.json", "r");
+    size_t nBytes = file.size();
+    file.close();
+
+    Medida anterior = Mide([]() {
+        InstruccionToque* aSecuencias[3] = {};
+        int nPasos = CargaAnterior(aSecuencias);
+        for (InstruccionToque* p : aSecuencias) delete[] p;
+        return nPasos;
+    });
+
+    CAMPANARIO campanario;
+    int nPasosPorBloques = 0;
+    Medida porBloques = Mide([&]() {
+        campanario.CargarSecuencias();
+        return 0;
+    });
+    nPasosPorBloques = PasosCargados(campanario);
+
+    printf("Secuencias.json: %zu bytes, 500 pasos\n", nBytes);
+    printf("  anterior (String + indexOf):   %8.1f us  pico heap %7zu B  %d pasos\n", anterior.nMejorUs, anterior.nPicoBytes, anterior.nPasos);
+    printf("  _ParseaSecuencias (bloques):   %8.1f us  pico heap %7zu B  %d pasos\n", porBloques.nMejorUs, porBloques.nPicoBytes, nPasosPorBloques);
+
+    COMPRUEBA(anterior.nPasos == 500, "el analizador anterior carga los 500 pasos");
+    COMPRUEBA(nPasosPorBloques == 500, "_ParseaSecuencias carga los 500 pasos");
+    COMPRUEBA(campanario.GetNumSecuencias() == 3, "tres secuencias registradas");
+    COMPRUEBA(porBloques.nPicoBytes < anterior.nPicoBytes, "menos heap que el analizador anterior");
+
+    return Prueba::Fin("rendimiento_secuencias");
+}
@@ -0,0 +1,333 @@
+#include "Arduino.h"
+#include <cstdarg>
+#include <map>
+#include <soc/gpio_reg.h>
+#include <esp_rom_crc.h>
+#include "RelojVirtual.h"
+#include "HostGPIO.h"
+#include "Reloj.h"
+
+HardwareSerial Serial;
+EspClass ESP;
+
+// ============================================================================
+// STRING
+// ============================================================================
+
+    std::string String::_Entero(long long v, unsigned char base) {
+        if (base == DEC || v >= 0) {
+            return (base == DEC) ? std::to_string(v) : _Entero((unsigned long long)v, base);
+        }
+        return _Entero((unsigned long long)v, base);                        // Arduino muestra el complemento a dos
+    }
+
+    std::string String::_Entero(unsigned long long v, unsigned char base) {
+        if (base < 2 || base > 36) base = DEC;
+        std::string s;
+        do {
+            unsigned d = (unsigned)(v % base);
+            s.insert(s.begin(), (char)(d < 10 ? '0' + d : 'A' + d - 10));
+            v /= base;
+        } while (v);
+        return s;
+    }
+
+    std::string String::_Real(double v, unsigned int decimales) {
+        char buf[64];
+        snprintf(buf, sizeof(buf), "%.*f", (int)decimales, v);
+        return buf;
+    }
+
+    bool String::equalsIgnoreCase(const String& s) const {
+        if (size() != s.size()) return false;
+        for (size_t i = 0; i < size(); ++i) {
+            if (tolower((unsigned char)(*this)[i]) != tolower((unsigned char)s[i])) return false;
+        }
+        return true;
+    }
+
+    String String::substring(unsigned int desde, unsigned int hasta) const {
+        if (desde > hasta) std::swap(desde, hasta);
+        if (desde >= size()) return String();
+        if (hasta > size()) hasta = (unsigned int)size();
+        return String(substr(desde, hasta - desde));
+    }
+
+    void String::toUpperCase() {
+        for (char& c : *this) c = (char)toupper((unsigned char)c);
+    }
+
+    void String::toLowerCase() {
+        for (char& c : *this) c = (char)tolower((unsigned char)c);
+    }
+
+    void String::trim() {
+        size_t nIni = find_first_not_of(" \t\r\n");
+        if (nIni == npos) { clear(); return; }
+        size_t nFin = find_last_not_of(" \t\r\n");
+        *this = String(substr(nIni, nFin - nIni + 1));
+    }
+
+    void String::replace(char antes, char despues) {
+        for (char& c : *this) if (c == antes) c = despues;
+    }
+
+    void String::replace(const String& antes, const String& despues) {
+        if (antes.empty()) return;
+        size_t n = 0;
+        while ((n = find(antes, n)) != npos) {
+            std::string::replace(n, antes.size(), despues);
+            n += despues.size();
+        }
+    }
+
+// ============================================================================
+// SERIE
+// ============================================================================
+
+    static bool _SerieActiva(void) {
+        static int nActiva = -1;
+        if (nActiva < 0) nActiva = getenv("CAMPANARIOS_SERIAL") != nullptr;
+        return nActiva == 1;
+    }
+
+    size_t HardwareSerial::printf(const char* formato, ...) {
+        char buf[512];
+        va_list args;
+        va_start(args, formato);
+        int n = vsnprintf(buf, sizeof(buf), formato, args);
+        va_end(args);
+        if (_SerieActiva()) fputs(buf, stdout);
+        return n < 0 ? 0 : (size_t)n;
+    }
+
+    size_t HardwareSerial::print(const String& s) {
+        if (_SerieActiva()) fputs(s.c_str(), stdout);
+        return s.length();
+    }
+
+    void EspClass::restart() {
+        Serial.println("[HOST] ESP.restart() ignorado");
+    }
+
+// ============================================================================
+// RELOJ VIRTUAL Y ESP_TIMER
+// ============================================================================
+
+    struct esp_timer {
+        esp_timer_cb_t callback;
+        void* arg;
+        bool lActivo;
+        uint64_t nVenceUs;
+    };
+
+    static uint64_t _nMicros = 0;                                           // Desde el arranque
+    static time_t _tEpochBase = 0;                                          // Epoch en _nMicrosBase (0 = sin NTP)
+    static uint64_t _nMicrosBase = 0;
+    static std::vector<esp_timer*>& _Temporizadores(void) {
+        static std::vector<esp_timer*> aTemporizadores;
+        return aTemporizadores;
+    }
+
+    namespace RelojVirtual {
+
+        void Fija(time_t tEpoch) {
+            _tEpochBase = tEpoch;
+            _nMicrosBase = _nMicros;
+        }
+
+        time_t Epoch(void) {
+            if (_tEpochBase == 0) return 0;
+            return _tEpochBase + (time_t)((_nMicros - _nMicrosBase) / 1000000ULL);
+        }
+
+        uint64_t Micros(void) {
+            return _nMicros;
+        }
+
+        uint64_t ProximoTemporizador(void) {
+            uint64_t nProximo = UINT64_MAX;
+            for (esp_timer* t : _Temporizadores()) {
+                if (t->lActivo && t->nVenceUs < nProximo) nProximo = t->nVenceUs;
+            }
+            return nProximo;
+        }
+
+        void AvanzaHasta(uint64_t nDestino) {
+            for (;;) {
+                uint64_t nProximo = ProximoTemporizador();
+                if (nProximo > nDestino) break;
+                if (nProximo > _nMicros) _nMicros = nProximo;
+                for (esp_timer* t : _Temporizadores()) {                    // Un callback puede rearmar otro temporizador
+                    if (t->lActivo && t->nVenceUs <= _nMicros) {
+                        t->lActivo = false;
+                        t->callback(t->arg);
+                        break;
+                    }
+                }
+            }
+            if (nDestino > _nMicros) _nMicros = nDestino;
+        }
+
+        void Avanza(uint64_t nMicros) {
+            AvanzaHasta(_nMicros + nMicros);
+        }
+
+        void Zona(const char* sTz) {
+            setenv("TZ", sTz, 1);
+            tzset();
+        }
+
+        time_t EpochLocal(int nAno, int nMes, int nDia, int nHora, int nMinuto, int nSegundo) {
+            struct tm info = {};
+            info.tm_year = nAno - 1900;
+            info.tm_mon = nMes - 1;
+            info.tm_mday = nDia;
+            info.tm_hour = nHora;
+            info.tm_min = nMinuto;
+            info.tm_sec = nSegundo;
+            info.tm_isdst = -1;
+            return mktime(&info);
+        }
+
+    }
+
+    int64_t esp_timer_get_time(void) {
+        return (int64_t)_nMicros;
+    }
+
+    esp_err_t esp_timer_create(const esp_timer_create_args_t* args, esp_timer_handle_t* pHandle) {
+        esp_timer* t = new esp_timer{ args->callback, args->arg, false, 0 };
+        _Temporizadores().push_back(t);
+        *pHandle = t;
+        return ESP_OK;
+    }
+
+    esp_err_t esp_timer_start_once(esp_timer_handle_t t, uint64_t nTimeoutUs) {
+        if (t->lActivo) return ESP_ERR_INVALID_STATE;
+        t->lActivo = true;
+        t->nVenceUs = _nMicros + nTimeoutUs;
+        return ESP_OK;
+    }
+
+    esp_err_t esp_timer_stop(esp_timer_handle_t t) {
+        if (!t->lActivo) return ESP_ERR_INVALID_STATE;
+        t->lActivo = false;
+        return ESP_OK;
+    }
+
+    esp_err_t esp_timer_delete(esp_timer_handle_t t) {
+        std::vector<esp_timer*>& aTemporizadores = _Temporizadores();
+        aTemporizadores.erase(std::remove(aTemporizadores.begin(), aTemporizadores.end(), t), aTemporizadores.end());
+        delete t;
+        return ESP_OK;
+    }
+
+    bool esp_timer_is_active(esp_timer_handle_t t) {
+        return t->lActivo;
+    }
+
+    unsigned long millis(void) { return (unsigned long)(_nMicros / 1000ULL); }
+    unsigned long micros(void) { return (unsigned long)_nMicros; }
+    void delay(uint32_t ms) { RelojVirtual::Avanza((uint64_t)ms * 1000ULL); }
+    void delayMicroseconds(uint32_t us) { RelojVirtual::Avanza(us); }
+    void yield(void) {}
+    void vTaskDelay(TickType_t nTicks) { delay(nTicks); }
+    TickType_t xTaskGetTickCount(void) { return (TickType_t)millis(); }
+
+    bool getLocalTime(struct tm* info, uint32_t) {
+        time_t tEpoch = RelojVirtual::Epoch();
+        if (tEpoch == 0) return false;
+        localtime_r(&tEpoch, info);
+        return true;
+    }
+
+    void configTime(long gmtOffset, int daylightOffset, const char*, const char*, const char*) {
+        char sTz[32];                                                       // Misma conversión que el core: signo POSIX invertido
+        snprintf(sTz, sizeof(sTz), "UTC%+ld", -(gmtOffset + daylightOffset) / 3600);
+        RelojVirtual::Zona(sTz);
+    }
+
+    void configTzTime(const char* tz, const char*, const char*, const char*) {
+        RelojVirtual::Zona(tz);
+    }
+
+    namespace Reloj {                                                       // Implementación RELOJ_HOST del punto de lectura de la hora
+
+        bool Sincronizado(void) { return RelojVirtual::Epoch() != 0; }
+        time_t Epoch(void) { return RelojVirtual::Epoch(); }
+        bool HoraLocal(struct tm* pInfo) { return getLocalTime(pInfo); }
+
+    }
+
+// ============================================================================
+// GPIO
+// ============================================================================
+
+    static uint64_t _nSalidas = 0;                                          // Bit n = nivel del pin n
+    static uint64_t _nEntradasBajas = 0;                                    // Entradas forzadas a LOW (por defecto HIGH: pull-up)
+    static std::vector<HostGPIO::Cambio> _aCambios;
+
+    static void _EscribeSalidas(uint64_t nNuevas) {
+        uint64_t nDiferencia = nNuevas ^ _nSalidas;
+        _nSalidas = nNuevas;
+        while (nDiferencia) {
+            uint8_t nPin = (uint8_t)__builtin_ctzll(nDiferencia);
+            nDiferencia &= nDiferencia - 1;
+            _aCambios.push_back({ nPin, ((_nSalidas >> nPin) & 1) != 0, _nMicros });
+        }
+    }
+
+    void HostEscribeRegistro(uint32_t nRegistro, uint32_t nValor) {
+        switch (nRegistro) {
+            case GPIO_OUT_W1TS_REG:  _EscribeSalidas(_nSalidas | nValor); break;
+            case GPIO_OUT_W1TC_REG:  _EscribeSalidas(_nSalidas & ~(uint64_t)nValor); break;
+            case GPIO_OUT1_W1TS_REG: _EscribeSalidas(_nSalidas | ((uint64_t)nValor << 32)); break;
+            case GPIO_OUT1_W1TC_REG: _EscribeSalidas(_nSalidas & ~((uint64_t)nValor << 32)); break;
+        }
+    }
+
+    void pinMode(uint8_t, uint8_t) {}
+
+    void digitalWrite(uint8_t nPin, uint8_t nValor) {
+        uint64_t nBit = 1ULL << nPin;
+        _EscribeSalidas(nValor ? (_nSalidas | nBit) : (_nSalidas & ~nBit));
+    }
+
+    int digitalRead(uint8_t nPin) {
+        if (_nEntradasBajas & (1ULL << nPin)) return LOW;
+        return HIGH;
+    }
+
+    namespace HostGPIO {
+
+        bool Nivel(uint8_t nPin) { return (_nSalidas >> nPin) & 1; }
+
+        uint32_t Subidas(uint8_t nPin) {
+            uint32_t n = 0;
+            for (const Cambio& c : _aCambios) if (c.pin == nPin && c.lAlto) n++;
+            return n;
+        }
+
+        const std::vector<Cambio>& Cambios(void) { return _aCambios; }
+        void Limpia(void) { _aCambios.clear(); }
+
+        void FijaEntrada(uint8_t nPin, bool lAlto) {
+            if (lAlto) _nEntradasBajas &= ~(1ULL << nPin);
+            else _nEntradasBajas |= (1ULL << nPin);
+        }
+
+    }
+
+// ============================================================================
+// CRC
+// ============================================================================
+
+    uint32_t esp_rom_crc32_le(uint32_t nCrc, const uint8_t* pDatos, uint32_t nLongitud) {
+        nCrc = ~nCrc;
+        while (nLongitud--) {
+            nCrc ^= *pDatos++;
+            for (int k = 0; k < 8; ++k) nCrc = (nCrc >> 1) ^ (0xEDB88320U & (0U - (nCrc & 1U)));
+        }
+        return ~nCrc;
+    }
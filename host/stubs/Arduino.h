@@ -0,0 +1,200 @@
+/**
+ * @file Arduino.h
+ * @brief Núcleo Arduino-ESP32 mínimo para compilar el campanario en el PC
+ *
+ * @details Sustituye a la cabecera del core solo en la compilación de host/.
+ *          Lo que afecta a la lógica es funcional; el resto no hace nada.
+ *
+ *          **FUNCIONAL:**
+ *          - String sobre std::string con los métodos que usa el proyecto
+ *          - millis(), micros(), delay(), getLocalTime(): reloj virtual (RelojVirtual.h)
+ *          - pinMode(), digitalWrite(), digitalRead(): registro de salidas (HostGPIO)
+ *          - Serial: solo escribe si CAMPANARIOS_SERIAL está definida en el entorno
+ *
+ *          **SIN EFECTO:**
+ *          - portMUX y semáforos (todo corre en un único hilo)
+ *          - Tareas FreeRTOS (no se crean; xTaskCreate devuelve pdFAIL)
+ *
+ * @author Julian Salas Bartolomé
+ * @date 2025-10-17
+ * @version 1.0
+ *
+ * @see RelojVirtual.h - Reloj que mueven las pruebas
+ */
+#ifndef ARDUINO_H
+	#define ARDUINO_H
+
+        #include <cstdint>
+        #include <cstring>
+        #include <cstdio>
+        #include <cstdlib>
+        #include <cmath>
+        #include <ctime>
+        #include <string>
+        #include <algorithm>
+
+        using std::min;
+        using std::max;
+
+        #define HEX 16
+        #define DEC 10
+        #define OUTPUT 0x03
+        #define INPUT 0x01
+        #define INPUT_PULLUP 0x05
+        #define HIGH 0x1
+        #define LOW 0x0
+        #define IRAM_ATTR
+        #define PROGMEM
+        #define F(s) (s)
+
+        // ==================== STRING ====================
+
+        class String : public std::string {
+            public:
+                String() {}
+                String(const char* s) : std::string(s ? s : "") {}
+                String(const char* s, unsigned int n) : std::string(s, n) {}
+                String(const std::string& s) : std::string(s) {}
+                String(char c) : std::string(1, c) {}
+                String(unsigned char v, unsigned char base = DEC) : std::string(_Entero(v, base)) {}
+                String(int v, unsigned char base = DEC) : std::string(_Entero(v, base)) {}
+                String(unsigned int v, unsigned char base = DEC) : std::string(_Entero(v, base)) {}
+                String(long v, unsigned char base = DEC) : std::string(_Entero(v, base)) {}
+                String(unsigned long v, unsigned char base = DEC) : std::string(_Entero(v, base)) {}
+                String(long long v, unsigned char base = DEC) : std::string(_Entero(v, base)) {}
+                String(unsigned long long v, unsigned char base = DEC) : std::string(_Entero(v, base)) {}
+                String(float v, unsigned int decimales = 2) : std::string(_Real(v, decimales)) {}
+                String(double v, unsigned int decimales = 2) : std::string(_Real(v, decimales)) {}
+
+                unsigned int length() const { return (unsigned int)size(); }
+                bool isEmpty() const { return empty(); }
+                bool reserve(unsigned int n) { std::string::reserve(n); return true; }
+                char charAt(unsigned int i) const { return i < size() ? (*this)[i] : 0; }
+                void setCharAt(unsigned int i, char c) { if (i < size()) (*this)[i] = c; }
+                bool concat(const String& s) { append(s); return true; }
+
+                bool equals(const String& s) const { return compare(s) == 0; }
+                bool equals(const char* s) const { return compare(s ? s : "") == 0; }
+                bool equalsIgnoreCase(const String& s) const;
+                bool startsWith(const String& s) const { return compare(0, s.size(), s) == 0; }
+                bool startsWith(const String& s, unsigned int desde) const { return desde <= size() && compare(desde, s.size(), s) == 0; }
+                bool endsWith(const String& s) const { return size() >= s.size() && compare(size() - s.size(), s.size(), s) == 0; }
+
+                int indexOf(char c, unsigned int desde = 0) const { return _Posicion(find(c, desde)); }
+                int indexOf(const String& s, unsigned int desde = 0) const { return _Posicion(find(s, desde)); }
+                int indexOf(const char* s, unsigned int desde = 0) const { return _Posicion(find(s, desde)); }
+                int lastIndexOf(char c) const { return _Posicion(rfind(c)); }
+                int lastIndexOf(const String& s) const { return _Posicion(rfind(s)); }
+
+                String substring(unsigned int desde) const { return desde < size() ? String(substr(desde)) : String(); }
+                String substring(unsigned int desde, unsigned int hasta) const;
+
+                void toUpperCase();
+                void toLowerCase();
+                void trim();
+                void replace(char antes, char despues);
+                void replace(const String& antes, const String& despues);
+                void remove(unsigned int desde) { if (desde < size()) erase(desde); }
+                void remove(unsigned int desde, unsigned int n) { if (desde < size()) erase(desde, n); }
+
+                long toInt() const { return atol(c_str()); }
+                float toFloat() const { return (float)atof(c_str()); }
+                double toDouble() const { return atof(c_str()); }
+                void toCharArray(char* buf, unsigned int n) const { if (n) { strncpy(buf, c_str(), n - 1); buf[n - 1] = '\0'; } }
+                void getBytes(unsigned char* buf, unsigned int n) const { toCharArray((char*)buf, n); }
+
+                String& operator+=(const String& s) { append(s); return *this; }
+                String& operator+=(const char* s) { if (s) append(s); return *this; }
+                String& operator+=(char c) { push_back(c); return *this; }
+                template <typename T> String& operator+=(T v) { append(String(v)); return *this; }
+
+            private:
+                static int _Posicion(size_t n) { return n == npos ? -1 : (int)n; }
+                static std::string _Entero(long long v, unsigned char base);
+                static std::string _Entero(unsigned long long v, unsigned char base);
+                static std::string _Entero(int v, unsigned char base) { return _Entero((long long)v, base); }
+                static std::string _Entero(long v, unsigned char base) { return _Entero((long long)v, base); }
+                static std::string _Entero(unsigned char v, unsigned char base) { return _Entero((unsigned long long)v, base); }
+                static std::string _Entero(unsigned int v, unsigned char base) { return _Entero((unsigned long long)v, base); }
+                static std::string _Entero(unsigned long v, unsigned char base) { return _Entero((unsigned long long)v, base); }
+                static std::string _Real(double v, unsigned int decimales);
+        };
+
+        inline String operator+(const String& a, const String& b) { String r(a); r.append(b); return r; }
+        inline String operator+(const String& a, const char* b) { String r(a); if (b) r.append(b); return r; }
+        inline String operator+(const char* a, const String& b) { String r(a); r.append(b); return r; }
+        inline String operator+(const String& a, char b) { String r(a); r.push_back(b); return r; }
+        template <typename T> inline String operator+(const String& a, T b) { return a + String(b); }
+
+        // ==================== SERIE ====================
+
+        class HardwareSerial {
+            public:
+                void begin(unsigned long) {}
+                void end() {}
+                void flush() { fflush(stdout); }
+                int available() { return 0; }
+                int read() { return -1; }
+                String readStringUntil(char) { return String(); }
+                size_t printf(const char* formato, ...) __attribute__((format(printf, 2, 3)));
+                size_t print(const String& s);
+                size_t print(const char* s) { return print(String(s)); }
+                size_t print(char c) { return print(String(c)); }
+                template <typename T> size_t print(T v) { return print(String(v)); }
+                template <typename T> size_t print(T v, int base) { return print(String(v, base)); }
+                size_t println() { return print("\n"); }
+                template <typename T> size_t println(T v) { return print(v) + println(); }
+                template <typename T> size_t println(T v, int base) { return print(v, base) + println(); }
+                size_t write(uint8_t c) { return print((char)c); }
+        };
+        extern HardwareSerial Serial;
+
+        // ==================== TIEMPO (RELOJ VIRTUAL) ====================
+
+        unsigned long millis(void);
+        unsigned long micros(void);
+        void delay(uint32_t ms);
+        void delayMicroseconds(uint32_t us);
+        void yield(void);
+        bool getLocalTime(struct tm* info, uint32_t ms = 5000);
+        void configTime(long gmtOffset, int daylightOffset, const char* server1, const char* server2 = nullptr, const char* server3 = nullptr);
+        void configTzTime(const char* tz, const char* server1, const char* server2 = nullptr, const char* server3 = nullptr);
+
+        // ==================== GPIO ====================
+
+        void pinMode(uint8_t pin, uint8_t modo);
+        void digitalWrite(uint8_t pin, uint8_t valor);
+        int digitalRead(uint8_t pin);
+        inline int analogRead(uint8_t) { return 0; }
+
+        // ==================== VARIOS ====================
+
+        inline long random(long hasta) { return hasta > 0 ? ::random() % hasta : 0; }
+        inline long random(long desde, long hasta) { return hasta > desde ? desde + ::random() % (hasta - desde) : desde; }
+        inline void randomSeed(unsigned long semilla) { srandom(semilla); }
+        template <class T, class L, class H> inline T constrain(T x, L bajo, H alto) { return x < bajo ? bajo : (x > alto ? alto : x); }
+        inline long map(long x, long a, long b, long c, long d) { return (x - a) * (d - c) / (b - a) + c; }
+        inline size_t strlcpy(char* destino, const char* origen, size_t n) {
+            size_t l = strlen(origen);
+            if (n) { size_t c = (l < n - 1) ? l : n - 1; memcpy(destino, origen, c); destino[c] = '\0'; }
+            return l;
+        }
+
+        class EspClass {
+            public:
+                uint32_t getFreeHeap() { return 200000; }
+                uint32_t getMinFreeHeap() { return 150000; }
+                uint32_t getMaxAllocHeap() { return 110000; }
+                uint32_t getHeapSize() { return 300000; }
+                uint32_t getCpuFreqMHz() { return 240; }
+                uint32_t getFlashChipSize() { return 4 * 1024 * 1024; }
+                uint64_t getEfuseMac() { return 0x0000A0B1C2D3E4F5ULL; }
+                const char* getSdkVersion() { return "host"; }
+                void restart();
+        };
+        extern EspClass ESP;
+
+        #include "freertos/FreeRTOS.h"
+        #include "esp_timer.h"
+
+#endif
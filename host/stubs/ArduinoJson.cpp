@@ -0,0 +1,552 @@
+#include "ArduinoJson.h"
+
+using ArduinoJsonHost::Nodo;
+using ArduinoJsonHost::PNodo;
+
+// ============================================================================
+// NODOS
+// ============================================================================
+
+    namespace ArduinoJsonHost {
+
+        PNodo Nodo::Busca(const char* sClave) const {
+            if (tipo != OBJETO || !sClave) return nullptr;
+            for (const auto& miembro : miembros) {
+                if (miembro.first == sClave) return miembro.second;
+            }
+            return nullptr;
+        }
+
+        static void _Copia(Nodo& destino, const Nodo& origen) {
+            if (&destino == &origen) return;
+            Nodo copia;                                                     // Por si origen cuelga de destino
+            copia.tipo = origen.tipo;
+            copia.b = origen.b;
+            copia.i = origen.i;
+            copia.d = origen.d;
+            copia.s = origen.s;
+            for (const PNodo& p : origen.elementos) {
+                copia.elementos.push_back(std::make_shared<Nodo>());
+                _Copia(*copia.elementos.back(), *p);
+            }
+            for (const auto& miembro : origen.miembros) {
+                copia.miembros.emplace_back(miembro.first, std::make_shared<Nodo>());
+                _Copia(*copia.miembros.back().second, *miembro.second);
+            }
+            destino = std::move(copia);
+        }
+
+        static void _EscribeTexto(const std::string& s, std::string& salida) {
+            salida.push_back('"');
+            for (unsigned char c : s) {
+                switch (c) {
+                    case '"':  salida += "\\\""; break;
+                    case '\\': salida += "\\\\"; break;
+                    case '\n': salida += "\\n"; break;
+                    case '\r': salida += "\\r"; break;
+                    case '\t': salida += "\\t"; break;
+                    case '\b': salida += "\\b"; break;
+                    case '\f': salida += "\\f"; break;
+                    default:
+                        if (c < 0x20) {
+                            char buf[8];
+                            snprintf(buf, sizeof(buf), "\\u%04x", c);
+                            salida += buf;
+                        } else {
+                            salida.push_back((char)c);
+                        }
+                }
+            }
+            salida.push_back('"');
+        }
+
+        void Escribe(const Nodo* pNodo, std::string& salida) {
+            if (!pNodo) { salida += "null"; return; }
+            switch (pNodo->tipo) {
+                case Nodo::NULO:     salida += "null"; break;
+                case Nodo::BOOLEANO: salida += pNodo->b ? "true" : "false"; break;
+                case Nodo::ENTERO:   salida += std::to_string(pNodo->i); break;
+                case Nodo::REAL: {
+                    char buf[32];
+                    snprintf(buf, sizeof(buf), "%.9g", pNodo->d);
+                    salida += buf;
+                    break;
+                }
+                case Nodo::TEXTO:    _EscribeTexto(pNodo->s, salida); break;
+                case Nodo::LISTA:
+                    salida.push_back('[');
+                    for (size_t n = 0; n < pNodo->elementos.size(); ++n) {
+                        if (n) salida.push_back(',');
+                        Escribe(pNodo->elementos[n].get(), salida);
+                    }
+                    salida.push_back(']');
+                    break;
+                case Nodo::OBJETO:
+                    salida.push_back('{');
+                    for (size_t n = 0; n < pNodo->miembros.size(); ++n) {
+                        if (n) salida.push_back(',');
+                        _EscribeTexto(pNodo->miembros[n].first, salida);
+                        salida.push_back(':');
+                        Escribe(pNodo->miembros[n].second.get(), salida);
+                    }
+                    salida.push_back('}');
+                    break;
+            }
+        }
+
+        // ==================== ANALIZADOR ====================
+
+        class Analizador {
+            public:
+                Analizador(const char* p, size_t n) : _p(p), _fin(p + n) {}
+
+                bool Valor(Nodo& nodo, int nProfundidad) {
+                    if (nProfundidad > 64) return false;
+                    _Espacios();
+                    if (_p >= _fin) return false;
+                    switch (*_p) {
+                        case '{': return _Objeto(nodo, nProfundidad);
+                        case '[': return _Lista(nodo, nProfundidad);
+                        case '"': nodo.tipo = Nodo::TEXTO; return _Texto(nodo.s);
+                        case 't': nodo.tipo = Nodo::BOOLEANO; nodo.b = true; return _Literal("true");
+                        case 'f': nodo.tipo = Nodo::BOOLEANO; nodo.b = false; return _Literal("false");
+                        case 'n': nodo.tipo = Nodo::NULO; return _Literal("null");
+                        default:  return _Numero(nodo);
+                    }
+                }
+
+                bool Final(void) { _Espacios(); return true; }
+
+            private:
+                void _Espacios(void) {
+                    while (_p < _fin && (*_p == ' ' || *_p == '\t' || *_p == '\r' || *_p == '\n')) ++_p;
+                }
+
+                bool _Literal(const char* s) {
+                    size_t n = strlen(s);
+                    if ((size_t)(_fin - _p) < n || strncmp(_p, s, n) != 0) return false;
+                    _p += n;
+                    return true;
+                }
+
+                bool _Numero(Nodo& nodo) {
+                    const char* pIni = _p;
+                    bool lReal = false;
+                    if (_p < _fin && (*_p == '-' || *_p == '+')) ++_p;
+                    while (_p < _fin && (isdigit((unsigned char)*_p) || *_p == '.' || *_p == 'e' || *_p == 'E' || *_p == '-' || *_p == '+')) {
+                        if (*_p == '.' || *_p == 'e' || *_p == 'E') lReal = true;
+                        ++_p;
+                    }
+                    if (_p == pIni) return false;
+                    std::string sNumero(pIni, _p);
+                    if (lReal) {
+                        nodo.tipo = Nodo::REAL;
+                        nodo.d = strtod(sNumero.c_str(), nullptr);
+                    } else {
+                        nodo.tipo = Nodo::ENTERO;
+                        nodo.i = strtoll(sNumero.c_str(), nullptr, 10);
+                    }
+                    return true;
+                }
+
+                static void _Utf8(uint32_t c, std::string& s) {
+                    if (c < 0x80) {
+                        s.push_back((char)c);
+                    } else if (c < 0x800) {
+                        s.push_back((char)(0xC0 | (c >> 6)));
+                        s.push_back((char)(0x80 | (c & 0x3F)));
+                    } else if (c < 0x10000) {
+                        s.push_back((char)(0xE0 | (c >> 12)));
+                        s.push_back((char)(0x80 | ((c >> 6) & 0x3F)));
+                        s.push_back((char)(0x80 | (c & 0x3F)));
+                    } else {
+                        s.push_back((char)(0xF0 | (c >> 18)));
+                        s.push_back((char)(0x80 | ((c >> 12) & 0x3F)));
+                        s.push_back((char)(0x80 | ((c >> 6) & 0x3F)));
+                        s.push_back((char)(0x80 | (c & 0x3F)));
+                    }
+                }
+
+                bool _Hex4(uint32_t& c) {
+                    if (_fin - _p < 4) return false;
+                    c = 0;
+                    for (int k = 0; k < 4; ++k) {
+                        char h = *_p++;
+                        c <<= 4;
+                        if (h >= '0' && h <= '9') c |= (uint32_t)(h - '0');
+                        else if (h >= 'a' && h <= 'f') c |= (uint32_t)(h - 'a' + 10);
+                        else if (h >= 'A' && h <= 'F') c |= (uint32_t)(h - 'A' + 10);
+                        else return false;
+                    }
+                    return true;
+                }
+
+                bool _Texto(std::string& s) {
+                    ++_p;                                                   // Comilla inicial
+                    s.clear();
+                    while (_p < _fin && *_p != '"') {
+                        char c = *_p++;
+                        if (c != '\\') { s.push_back(c); continue; }
+                        if (_p >= _fin) return false;
+                        char e = *_p++;
+                        switch (e) {
+                            case 'n': s.push_back('\n'); break;
+                            case 'r': s.push_back('\r'); break;
+                            case 't': s.push_back('\t'); break;
+                            case 'b': s.push_back('\b'); break;
+                            case 'f': s.push_back('\f'); break;
+                            case 'u': {
+                                uint32_t cp;
+                                if (!_Hex4(cp)) return false;
+                                if (cp >= 0xD800 && cp < 0xDC00 && _fin - _p >= 6 && _p[0] == '\\' && _p[1] == 'u') {
+                                    uint32_t bajo;
+                                    _p += 2;
+                                    if (!_Hex4(bajo)) return false;
+                                    cp = 0x10000 + ((cp - 0xD800) << 10) + (bajo - 0xDC00);
+                                }
+                                _Utf8(cp, s);
+                                break;
+                            }
+                            default: s.push_back(e);
+                        }
+                    }
+                    if (_p >= _fin) return false;
+                    ++_p;                                                   // Comilla final
+                    return true;
+                }
+
+                bool _Lista(Nodo& nodo, int nProfundidad) {
+                    ++_p;
+                    nodo.tipo = Nodo::LISTA;
+                    _Espacios();
+                    if (_p < _fin && *_p == ']') { ++_p; return true; }
+                    for (;;) {
+                        nodo.elementos.push_back(std::make_shared<Nodo>());
+                        if (!Valor(*nodo.elementos.back(), nProfundidad + 1)) return false;
+                        _Espacios();
+                        if (_p >= _fin) return false;
+                        if (*_p == ',') { ++_p; continue; }
+                        if (*_p == ']') { ++_p; return true; }
+                        return false;
+                    }
+                }
+
+                bool _Objeto(Nodo& nodo, int nProfundidad) {
+                    ++_p;
+                    nodo.tipo = Nodo::OBJETO;
+                    _Espacios();
+                    if (_p < _fin && *_p == '}') { ++_p; return true; }
+                    for (;;) {
+                        _Espacios();
+                        if (_p >= _fin || *_p != '"') return false;
+                        std::string sClave;
+                        if (!_Texto(sClave)) return false;
+                        _Espacios();
+                        if (_p >= _fin || *_p != ':') return false;
+                        ++_p;
+                        PNodo pValor = std::make_shared<Nodo>();
+                        if (!Valor(*pValor, nProfundidad + 1)) return false;
+                        nodo.miembros.emplace_back(std::move(sClave), pValor);
+                        _Espacios();
+                        if (_p >= _fin) return false;
+                        if (*_p == ',') { ++_p; continue; }
+                        if (*_p == '}') { ++_p; return true; }
+                        return false;
+                    }
+                }
+
+                const char* _p;
+                const char* _fin;
+        };
+
+        bool Analiza(const char* pTexto, size_t nTexto, Nodo& raiz) {
+            Analizador analizador(pTexto, nTexto);
+            return analizador.Valor(raiz, 0);
+        }
+
+    }
+
+// ============================================================================
+// JSONVARIANT
+// ============================================================================
+
+    PNodo JsonVariant::_Resuelve() const {
+        if (_pNodo) return _pNodo;
+        if (!_pPadre) return nullptr;
+        PNodo pPadre = _pPadre->_Resuelve();
+        if (!pPadre) return nullptr;
+        if (_nIndice >= 0) {
+            if (pPadre->tipo != Nodo::LISTA || (size_t)_nIndice >= pPadre->elementos.size()) return nullptr;
+            return pPadre->elementos[_nIndice];
+        }
+        return pPadre->Busca(_sClave.c_str());
+    }
+
+    PNodo JsonVariant::_Crea() const {
+        if (_pNodo) return _pNodo;
+        if (!_pPadre) {                                                     // Variante suelta: nodo propio
+            _pNodo = std::make_shared<Nodo>();
+            return _pNodo;
+        }
+        PNodo pPadre = _pPadre->_Crea();
+        if (_nIndice >= 0) {
+            if (pPadre->tipo != Nodo::LISTA) { pPadre->Limpia(); pPadre->tipo = Nodo::LISTA; }
+            while (pPadre->elementos.size() <= (size_t)_nIndice) pPadre->elementos.push_back(std::make_shared<Nodo>());
+            _pNodo = pPadre->elementos[_nIndice];
+            return _pNodo;
+        }
+        if (pPadre->tipo != Nodo::OBJETO) { pPadre->Limpia(); pPadre->tipo = Nodo::OBJETO; }
+        PNodo pNodo = pPadre->Busca(_sClave.c_str());
+        if (!pNodo) {
+            pNodo = std::make_shared<Nodo>();
+            pPadre->miembros.emplace_back(_sClave, pNodo);
+        }
+        _pNodo = pNodo;
+        return _pNodo;
+    }
+
+    JsonVariant JsonVariant::operator[](const char* sClave) const {
+        JsonVariant hijo;
+        PNodo pPropio = _Resuelve();
+        if (pPropio) hijo._pNodo = pPropio->Busca(sClave);
+        if (!hijo._pNodo) {
+            hijo._pPadre = std::make_shared<JsonVariant>(*this);
+            hijo._sClave = sClave ? sClave : "";
+        }
+        return hijo;
+    }
+
+    JsonVariant JsonVariant::operator[](int nIndice) const {
+        JsonVariant hijo;
+        PNodo pPropio = _Resuelve();
+        if (pPropio && pPropio->tipo == Nodo::LISTA && nIndice >= 0 && (size_t)nIndice < pPropio->elementos.size()) {
+            hijo._pNodo = pPropio->elementos[nIndice];
+        } else {
+            hijo._pPadre = std::make_shared<JsonVariant>(*this);
+            hijo._nIndice = nIndice;
+        }
+        return hijo;
+    }
+
+    JsonVariant& JsonVariant::operator=(const JsonVariant& otro) {
+        if (!_pNodo && !_pPadre) {                                          // Sin enlazar: se convierte en referencia
+            _Enlaza(otro);
+            return *this;
+        }
+        PNodo pOrigen = otro._Resuelve();
+        PNodo pDestino = _Crea();
+        if (pOrigen) ArduinoJsonHost::_Copia(*pDestino, *pOrigen);
+        else pDestino->Limpia();
+        return *this;
+    }
+
+    const char* JsonVariant::operator|(const char* sDefecto) const {
+        PNodo p = _Resuelve();
+        return (p && p->tipo == Nodo::TEXTO) ? p->s.c_str() : sDefecto;
+    }
+
+    bool JsonVariant::operator|(bool lDefecto) const {
+        PNodo p = _Resuelve();
+        return (p && p->tipo == Nodo::BOOLEANO) ? p->b : lDefecto;
+    }
+
+    size_t JsonVariant::size() const {
+        PNodo p = _Resuelve();
+        if (!p) return 0;
+        if (p->tipo == Nodo::LISTA) return p->elementos.size();
+        if (p->tipo == Nodo::OBJETO) return p->miembros.size();
+        return 0;
+    }
+
+    void JsonVariant::remove(const char* sClave) {
+        PNodo p = _Resuelve();
+        if (!p || p->tipo != Nodo::OBJETO) return;
+        for (auto it = p->miembros.begin(); it != p->miembros.end(); ++it) {
+            if (it->first == sClave) { p->miembros.erase(it); return; }
+        }
+    }
+
+    JsonArray JsonVariant::createNestedArray(const char* sClave) const {
+        return (*this)[sClave].to<JsonArray>();
+    }
+
+    JsonArray JsonVariant::createNestedArray(const String& sClave) const {
+        return createNestedArray(sClave.c_str());
+    }
+
+    JsonObject JsonVariant::createNestedObject(const char* sClave) const {
+        return (*this)[sClave].to<JsonObject>();
+    }
+
+    JsonObject JsonVariant::createNestedObject(const String& sClave) const {
+        return createNestedObject(sClave.c_str());
+    }
+
+    JsonArray JsonVariant::createNestedArray() const {
+        PNodo p = _Crea();
+        if (p->tipo != Nodo::LISTA) { p->Limpia(); p->tipo = Nodo::LISTA; }
+        p->elementos.push_back(std::make_shared<Nodo>());
+        return JsonVariant(p->elementos.back()).to<JsonArray>();
+    }
+
+    JsonObject JsonVariant::createNestedObject() const {
+        PNodo p = _Crea();
+        if (p->tipo != Nodo::LISTA) { p->Limpia(); p->tipo = Nodo::LISTA; }
+        p->elementos.push_back(std::make_shared<Nodo>());
+        return JsonVariant(p->elementos.back()).to<JsonObject>();
+    }
+
+    bool JsonVariant::add(const char* s) const {
+        PNodo p = _Crea();
+        if (p->tipo != Nodo::LISTA) { p->Limpia(); p->tipo = Nodo::LISTA; }
+        p->elementos.push_back(std::make_shared<Nodo>());
+        JsonVariant(p->elementos.back()) = s;
+        return true;
+    }
+
+    const char* JsonVariant::_Texto() const {
+        PNodo p = _Resuelve();
+        return (p && p->tipo == Nodo::TEXTO) ? p->s.c_str() : nullptr;
+    }
+
+    String JsonVariant::_Cadena() const {
+        PNodo p = _Resuelve();
+        if (p && p->tipo == Nodo::TEXTO) return String(p->s);
+        std::string s;
+        ArduinoJsonHost::Escribe(p.get(), s);
+        return String(s);
+    }
+
+    template <> const char* JsonVariant::as<const char*>() const { return _Texto(); }
+    template <> String JsonVariant::as<String>() const { return _Cadena(); }
+
+    template <> JsonArray JsonVariant::as<JsonArray>() const {
+        PNodo p = _Resuelve();
+        return (p && p->tipo == Nodo::LISTA) ? JsonArray(JsonVariant(p)) : JsonArray();
+    }
+
+    template <> JsonObject JsonVariant::as<JsonObject>() const {
+        PNodo p = _Resuelve();
+        return (p && p->tipo == Nodo::OBJETO) ? JsonObject(JsonVariant(p)) : JsonObject();
+    }
+
+    template <> JsonVariant JsonVariant::as<JsonVariant>() const {
+        return *this;
+    }
+
+    template <> bool JsonVariant::is<const char*>() const {
+        PNodo p = _Resuelve();
+        return p && p->tipo == Nodo::TEXTO;
+    }
+
+    template <> bool JsonVariant::is<String>() const {
+        return is<const char*>();
+    }
+
+    template <> bool JsonVariant::is<JsonArray>() const {
+        PNodo p = _Resuelve();
+        return p && p->tipo == Nodo::LISTA;
+    }
+
+    template <> bool JsonVariant::is<JsonObject>() const {
+        PNodo p = _Resuelve();
+        return p && p->tipo == Nodo::OBJETO;
+    }
+
+// ============================================================================
+// JSONARRAY, JSONOBJECT, JSONDOCUMENT
+// ============================================================================
+
+    void JsonArray::_AsegurarTipo() {
+        PNodo p = _Resuelve();
+        if (p && p->tipo != Nodo::LISTA && p->tipo != Nodo::NULO) {         // Otro tipo: referencia nula
+            _pNodo.reset();
+            _pPadre.reset();
+        }
+    }
+
+    JsonArray::iterator JsonArray::begin() const {
+        PNodo p = _Resuelve();
+        if (!p || p->tipo != Nodo::LISTA) return iterator(nullptr, 0);
+        return iterator(p, 0);
+    }
+
+    JsonArray::iterator JsonArray::end() const {
+        PNodo p = _Resuelve();
+        if (!p || p->tipo != Nodo::LISTA) return iterator(nullptr, 0);
+        return iterator(p, p->elementos.size());
+    }
+
+    void JsonObject::_AsegurarTipo() {
+        PNodo p = _Resuelve();
+        if (p && p->tipo != Nodo::OBJETO && p->tipo != Nodo::NULO) {
+            _pNodo.reset();
+            _pPadre.reset();
+        }
+    }
+
+    JsonDocument::JsonDocument(const JsonDocument& otro) : JsonDocument() {
+        ArduinoJsonHost::_Copia(*_pNodo, *otro._pNodo);
+    }
+
+    JsonDocument& JsonDocument::operator=(const JsonDocument& otro) {
+        ArduinoJsonHost::_Copia(*_pNodo, *otro._pNodo);
+        return *this;
+    }
+
+// ============================================================================
+// SERIALIZACIÓN
+// ============================================================================
+
+    const char* DeserializationError::c_str() const {
+        switch (_codigo) {
+            case Ok:              return "Ok";
+            case EmptyInput:      return "EmptyInput";
+            case IncompleteInput: return "IncompleteInput";
+            case InvalidInput:    return "InvalidInput";
+            case NoMemory:        return "NoMemory";
+        }
+        return "?";
+    }
+
+    DeserializationError deserializeJson(JsonDocument& doc, const char* pTexto, size_t nTexto) {
+        PNodo pRaiz = doc._Crea();
+        pRaiz->Limpia();
+        size_t n = 0;
+        while (pTexto && n < nTexto && isspace((unsigned char)pTexto[n])) ++n;
+        if (!pTexto || n == nTexto) return DeserializationError::EmptyInput;
+        if (!ArduinoJsonHost::Analiza(pTexto, nTexto, *pRaiz)) {
+            pRaiz->Limpia();
+            return DeserializationError::InvalidInput;
+        }
+        return DeserializationError::Ok;
+    }
+
+    size_t serializeJson(const JsonVariant& v, std::string& salida) {
+        salida.clear();
+        PNodo p = v._Resuelve();
+        ArduinoJsonHost::Escribe(p.get(), salida);
+        return salida.size();
+    }
+
+    size_t serializeJson(const JsonVariant& v, String& salida) {
+        std::string texto;
+        serializeJson(v, texto);
+        salida = String(texto);
+        return salida.length();
+    }
+
+    size_t serializeJson(const JsonVariant& v, char* pBuffer, size_t nBuffer) {
+        std::string texto;
+        serializeJson(v, texto);
+        if (!nBuffer) return 0;
+        size_t n = std::min(texto.size(), nBuffer - 1);
+        memcpy(pBuffer, texto.data(), n);
+        pBuffer[n] = '\0';
+        return n;
+    }
+
+    size_t measureJson(const JsonVariant& v) {
+        std::string texto;
+        return serializeJson(v, texto);
+    }
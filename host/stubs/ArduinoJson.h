@@ -0,0 +1,267 @@
+/**
+ * @file ArduinoJson.h
+ * @brief Subconjunto funcional de ArduinoJson para la compilación de host/
+ *
+ * @details Solo la parte de la API que usa el campanario, sobre un árbol de
+ *          nodos con memoria dinámica. Sirve para ejecutar la lógica en el PC;
+ *          no reproduce los límites de memoria ni el formato exacto de los
+ *          números reales de la librería original.
+ *
+ *          **SOPORTADO:**
+ *          - JsonDocument, JsonVariant, JsonObject, JsonArray
+ *          - doc["k"] = v, doc["a"]["b"] = v (crea los niveles al escribir)
+ *          - v | valorPorDefecto, as<T>(), is<T>(), containsKey(), size()
+ *          - createNestedArray/createNestedObject, add(), recorrido con for
+ *          - serializeJson/measureJson y deserializeJson desde texto o File
+ */
+#ifndef ARDUINOJSON_H
+	#define ARDUINOJSON_H
+
+        #include <Arduino.h>
+        #include <memory>
+        #include <vector>
+        #include <utility>
+        #include <type_traits>
+
+        namespace ArduinoJsonHost {
+
+            struct Nodo;
+            typedef std::shared_ptr<Nodo> PNodo;
+
+            struct Nodo {
+                enum Tipo { NULO, BOOLEANO, ENTERO, REAL, TEXTO, LISTA, OBJETO } tipo = NULO;
+                bool b = false;
+                long long i = 0;
+                double d = 0;
+                std::string s;
+                std::vector<PNodo> elementos;
+                std::vector<std::pair<std::string, PNodo>> miembros;
+
+                PNodo Busca(const char* sClave) const;
+                void Limpia(void) { tipo = NULO; s.clear(); elementos.clear(); miembros.clear(); }
+            };
+
+            void Escribe(const Nodo* pNodo, std::string& salida);
+            bool Analiza(const char* pTexto, size_t nTexto, Nodo& raiz);
+
+        }
+
+        class JsonArray;
+        class JsonObject;
+
+        class JsonVariant {
+            public:
+                JsonVariant() {}
+                explicit JsonVariant(ArduinoJsonHost::PNodo pNodo) : _pNodo(pNodo) {}
+
+                JsonVariant operator[](const char* sClave) const;
+                JsonVariant operator[](const String& sClave) const { return (*this)[sClave.c_str()]; }
+                JsonVariant operator[](int nIndice) const;
+
+                JsonVariant& operator=(const JsonVariant& otro);
+                JsonVariant& operator=(const char* s) { if (!s) return _Nulo(); auto p = _Crea(); p->Limpia(); p->tipo = ArduinoJsonHost::Nodo::TEXTO; p->s = s; return *this; }
+                JsonVariant& operator=(char* s) { return *this = (const char*)s; }
+                JsonVariant& operator=(const String& s) { return *this = s.c_str(); }
+                JsonVariant& operator=(std::nullptr_t) { return _Nulo(); }
+                JsonVariant& operator=(bool v) { auto p = _Crea(); p->Limpia(); p->tipo = ArduinoJsonHost::Nodo::BOOLEANO; p->b = v; return *this; }
+                template <typename T>
+                typename std::enable_if<std::is_integral<T>::value, JsonVariant&>::type operator=(T v) { auto p = _Crea(); p->Limpia(); p->tipo = ArduinoJsonHost::Nodo::ENTERO; p->i = (long long)v; return *this; }
+                template <typename T>
+                typename std::enable_if<std::is_floating_point<T>::value, JsonVariant&>::type operator=(T v) { auto p = _Crea(); p->Limpia(); p->tipo = ArduinoJsonHost::Nodo::REAL; p->d = (double)v; return *this; }
+                template <typename T>
+                typename std::enable_if<std::is_enum<T>::value, JsonVariant&>::type operator=(T v) { return *this = (long long)v; }
+
+                const char* operator|(const char* sDefecto) const;
+                String operator|(const String& sDefecto) const { const char* s = *this | (const char*)nullptr; return s ? String(s) : sDefecto; }
+                bool operator|(bool lDefecto) const;
+                template <typename T>
+                typename std::enable_if<std::is_arithmetic<T>::value && !std::is_same<T, bool>::value, T>::type operator|(T nDefecto) const {
+                    ArduinoJsonHost::PNodo p = _Resuelve();
+                    if (!p) return nDefecto;
+                    if (p->tipo == ArduinoJsonHost::Nodo::ENTERO) return (T)p->i;
+                    if (p->tipo == ArduinoJsonHost::Nodo::REAL) return (T)p->d;
+                    return nDefecto;
+                }
+
+                template <typename T> T as() const;
+                template <typename T> bool is() const;
+                template <typename T, typename = typename std::enable_if<std::is_arithmetic<T>::value>::type>
+                operator T() const { return as<T>(); }
+                operator const char*() const { return _Texto(); }
+                operator String() const { return _Cadena(); }
+
+                bool operator==(const char* s) const { const char* p = _Texto(); return p && s && strcmp(p, s) == 0; }
+                bool operator!=(const char* s) const { return !(*this == s); }
+                bool operator==(const String& s) const { return *this == s.c_str(); }
+                bool operator!=(const String& s) const { return !(*this == s.c_str()); }
+                template <typename T>
+                typename std::enable_if<std::is_arithmetic<T>::value, bool>::type operator==(T v) const { return as<T>() == v; }
+                template <typename T>
+                typename std::enable_if<std::is_arithmetic<T>::value, bool>::type operator!=(T v) const { return as<T>() != v; }
+
+                bool isNull() const { return !_Resuelve() || _Resuelve()->tipo == ArduinoJsonHost::Nodo::NULO; }
+                size_t size() const;
+                bool containsKey(const char* sClave) const { ArduinoJsonHost::PNodo p = _Resuelve(); return p && p->Busca(sClave); }
+                bool containsKey(const String& sClave) const { return containsKey(sClave.c_str()); }
+                void remove(const char* sClave);
+                void remove(const String& sClave) { remove(sClave.c_str()); }
+                void clear() { ArduinoJsonHost::PNodo p = _Resuelve(); if (p) p->Limpia(); }
+
+                JsonArray createNestedArray(const char* sClave) const;
+                JsonArray createNestedArray(const String& sClave) const;
+                JsonObject createNestedObject(const char* sClave) const;
+                JsonObject createNestedObject(const String& sClave) const;
+                JsonArray createNestedArray() const;
+                JsonObject createNestedObject() const;
+                template <typename T> T to() const;
+                template <typename T> bool add(const T& v) const;
+                bool add(const char* s) const;
+
+                const char* _Texto() const;                                 //!< Texto del nodo o nullptr
+                String _Cadena() const;                                     //!< Texto del nodo o el nodo serializado
+                ArduinoJsonHost::PNodo _Resuelve() const;                   //!< Nodo existente o nullptr, sin crear nada
+                ArduinoJsonHost::PNodo _Crea() const;                       //!< Nodo existente o creado en el padre
+
+            protected:
+                void _Enlaza(const JsonVariant& otro) { _pNodo = otro._pNodo; _pPadre = otro._pPadre; _sClave = otro._sClave; _nIndice = otro._nIndice; }
+                JsonVariant& _Nulo() { auto p = _Crea(); p->Limpia(); return *this; }
+
+                mutable ArduinoJsonHost::PNodo _pNodo;                      //!< Nodo ya resuelto
+                std::shared_ptr<JsonVariant> _pPadre;                       //!< Contenedor si el nodo aún no existe
+                std::string _sClave;                                        //!< Clave en el padre (objeto)
+                int _nIndice = -1;                                          //!< Índice en el padre (lista)
+        };
+
+        class JsonArray : public JsonVariant {
+            public:
+                JsonArray() {}
+                JsonArray(const JsonVariant& v) : JsonVariant(v) { _AsegurarTipo(); }
+                JsonArray(const JsonArray& otra) : JsonVariant(otra) {}
+                JsonArray& operator=(const JsonArray& otra) { _Enlaza(otra); return *this; }  // Referencia, como en ArduinoJson
+
+                class iterator {
+                    public:
+                        iterator(ArduinoJsonHost::PNodo pLista, size_t n) : _pLista(pLista), _n(n) {}
+                        bool operator!=(const iterator& otro) const { return _n != otro._n; }
+                        iterator& operator++() { ++_n; return *this; }
+                        JsonVariant operator*() const { return JsonVariant(_pLista->elementos[_n]); }
+                    private:
+                        ArduinoJsonHost::PNodo _pLista;
+                        size_t _n;
+                };
+                iterator begin() const;
+                iterator end() const;
+
+            private:
+                void _AsegurarTipo();
+        };
+
+        class JsonObject : public JsonVariant {
+            public:
+                JsonObject() {}
+                JsonObject(const JsonVariant& v) : JsonVariant(v) { _AsegurarTipo(); }
+                JsonObject(const JsonObject& otro) : JsonVariant(otro) {}
+                JsonObject& operator=(const JsonObject& otro) { _Enlaza(otro); return *this; }
+            private:
+                void _AsegurarTipo();
+        };
+
+        class JsonDocument : public JsonVariant {
+            public:
+                JsonDocument() : JsonVariant(std::make_shared<ArduinoJsonHost::Nodo>()) {}
+                explicit JsonDocument(size_t) : JsonDocument() {}
+                JsonDocument(const JsonDocument& otro);
+                JsonDocument& operator=(const JsonDocument& otro);
+                using JsonVariant::operator=;
+
+                size_t memoryUsage() const { return 0; }
+                bool overflowed() const { return false; }
+        };
+
+        typedef JsonDocument DynamicJsonDocument;
+        template <size_t N> class StaticJsonDocument : public JsonDocument {};
+
+        class DeserializationError {
+            public:
+                enum Code { Ok, EmptyInput, IncompleteInput, InvalidInput, NoMemory };
+                DeserializationError(Code c = Ok) : _codigo(c) {}
+                explicit operator bool() const { return _codigo != Ok; }
+                bool operator==(Code c) const { return _codigo == c; }
+                bool operator!=(Code c) const { return _codigo != c; }
+                Code code() const { return _codigo; }
+                const char* c_str() const;
+            private:
+                Code _codigo;
+        };
+
+        DeserializationError deserializeJson(JsonDocument& doc, const char* pTexto, size_t nTexto);
+        inline DeserializationError deserializeJson(JsonDocument& doc, const char* pTexto) { return deserializeJson(doc, pTexto, pTexto ? strlen(pTexto) : 0); }
+        inline DeserializationError deserializeJson(JsonDocument& doc, char* pTexto) { return deserializeJson(doc, (const char*)pTexto); }
+        inline DeserializationError deserializeJson(JsonDocument& doc, const String& texto) { return deserializeJson(doc, texto.c_str(), texto.length()); }
+        inline DeserializationError deserializeJson(JsonDocument& doc, const std::string& texto) { return deserializeJson(doc, texto.c_str(), texto.size()); }
+        inline DeserializationError deserializeJson(JsonDocument& doc, const uint8_t* pTexto, size_t nTexto) { return deserializeJson(doc, (const char*)pTexto, nTexto); }
+        template <typename Stream, typename = typename std::enable_if<!std::is_base_of<std::string, Stream>::value>::type>
+        DeserializationError deserializeJson(JsonDocument& doc, Stream& entrada) {          // File y otros flujos con read()
+            std::string texto;
+            int c;
+            while ((c = entrada.read()) >= 0) texto.push_back((char)c);
+            return deserializeJson(doc, texto.c_str(), texto.size());
+        }
+
+        size_t serializeJson(const JsonVariant& v, String& salida);
+        size_t serializeJson(const JsonVariant& v, std::string& salida);
+        size_t serializeJson(const JsonVariant& v, char* pBuffer, size_t nBuffer);
+        template <typename Print>
+        size_t serializeJson(const JsonVariant& v, Print& salida) {                       // File y otros destinos con write()
+            std::string texto;
+            serializeJson(v, texto);
+            return salida.write((const uint8_t*)texto.data(), texto.size());
+        }
+        inline size_t serializeJsonPretty(const JsonVariant& v, String& salida) { return serializeJson(v, salida); }
+        size_t measureJson(const JsonVariant& v);
+
+        // ==================== PLANTILLAS ====================
+
+        template <typename T> T JsonVariant::as() const {
+            ArduinoJsonHost::PNodo p = _Resuelve();
+            if (!p) return T();
+            if (p->tipo == ArduinoJsonHost::Nodo::ENTERO) return (T)p->i;
+            if (p->tipo == ArduinoJsonHost::Nodo::REAL) return (T)p->d;
+            if (p->tipo == ArduinoJsonHost::Nodo::BOOLEANO) return (T)p->b;
+            return T();
+        }
+        template <> const char* JsonVariant::as<const char*>() const;
+        template <> String JsonVariant::as<String>() const;
+        template <> JsonArray JsonVariant::as<JsonArray>() const;
+        template <> JsonObject JsonVariant::as<JsonObject>() const;
+        template <> JsonVariant JsonVariant::as<JsonVariant>() const;
+
+        template <typename T> bool JsonVariant::is() const {
+            ArduinoJsonHost::PNodo p = _Resuelve();
+            if (!p) return false;
+            if (std::is_same<T, bool>::value) return p->tipo == ArduinoJsonHost::Nodo::BOOLEANO;
+            if (std::is_integral<T>::value) return p->tipo == ArduinoJsonHost::Nodo::ENTERO;
+            if (std::is_floating_point<T>::value) return p->tipo == ArduinoJsonHost::Nodo::ENTERO || p->tipo == ArduinoJsonHost::Nodo::REAL;
+            return false;
+        }
+        template <> bool JsonVariant::is<const char*>() const;
+        template <> bool JsonVariant::is<String>() const;
+        template <> bool JsonVariant::is<JsonArray>() const;
+        template <> bool JsonVariant::is<JsonObject>() const;
+
+        template <typename T> bool JsonVariant::add(const T& v) const {
+            JsonArray lista = *this;
+            ArduinoJsonHost::PNodo p = lista._Crea();
+            p->elementos.push_back(std::make_shared<ArduinoJsonHost::Nodo>());
+            JsonVariant(p->elementos.back()) = v;
+            return true;
+        }
+
+        template <typename T> T JsonVariant::to() const {
+            ArduinoJsonHost::PNodo p = _Crea();
+            p->Limpia();
+            p->tipo = std::is_same<T, JsonArray>::value ? ArduinoJsonHost::Nodo::LISTA : ArduinoJsonHost::Nodo::OBJETO;
+            return T(JsonVariant(p));
+        }
+
+#endif
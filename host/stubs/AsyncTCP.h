@@ -0,0 +1,6 @@
+#ifndef ASYNCTCP_H
+	#define ASYNCTCP_H
+
+        #include <Arduino.h>
+
+#endif
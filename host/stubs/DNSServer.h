@@ -0,0 +1,13 @@
+#ifndef DNSSERVER_H
+	#define DNSSERVER_H
+
+        #include <WiFi.h>
+
+        class DNSServer {
+            public:
+                bool start(uint16_t, const String&, const IPAddress&) { return true; }
+                void processNextRequest() {}
+                void stop() {}
+        };
+
+#endif
@@ -0,0 +1,20 @@
+#ifndef EEPROM_H
+	#define EEPROM_H
+
+        #include <Arduino.h>
+
+        class EEPROMClass {                                             // En memoria; las pruebas pueden escribir la configuración antes de setup()
+            public:
+                bool begin(size_t) { return true; }
+                bool commit() { return true; }
+                void end() {}
+                uint8_t read(int n) { return _aDatos[n]; }
+                void write(int n, uint8_t v) { _aDatos[n] = v; }
+                template <typename T> T& get(int n, T& t) { memcpy(&t, _aDatos + n, sizeof(T)); return t; }
+                template <typename T> const T& put(int n, const T& t) { memcpy(_aDatos + n, &t, sizeof(T)); return t; }
+            private:
+                uint8_t _aDatos[4096] = {};
+        };
+        extern EEPROMClass EEPROM;
+
+#endif
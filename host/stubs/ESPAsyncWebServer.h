@@ -0,0 +1,165 @@
+/**
+ * @file ESPAsyncWebServer.h
+ * @brief Servidor HTTP y WebSocket asíncronos para la compilación de host/
+ *
+ * @details El servidor HTTP solo guarda las rutas. El WebSocket es funcional
+ *          para las pruebas: HostConecta() da de alta un cliente y dispara
+ *          WS_EVT_CONNECT, HostRecibe() entrega un mensaje de texto como
+ *          WS_EVT_DATA y cada cliente guarda lo que el servidor le envía.
+ */
+#ifndef ESPASYNCWEBSERVER_H
+	#define ESPASYNCWEBSERVER_H
+
+        #include <Arduino.h>
+        #include <FS.h>
+        #include <WiFi.h>
+        #include <functional>
+        #include <memory>
+        #include <vector>
+
+        enum WebRequestMethod { HTTP_GET = 1, HTTP_POST = 2, HTTP_DELETE = 4, HTTP_PUT = 8, HTTP_ANY = 0xFF };
+        typedef int WebRequestMethodComposite;
+
+        class AsyncWebParameter {
+            public:
+                AsyncWebParameter(const String& sNombre, const String& sValor) : _sNombre(sNombre), _sValor(sValor) {}
+                const String& name() const { return _sNombre; }
+                const String& value() const { return _sValor; }
+            private:
+                String _sNombre;
+                String _sValor;
+        };
+
+        class AsyncWebHeader {
+            public:
+                AsyncWebHeader(const String& sNombre, const String& sValor) : _sNombre(sNombre), _sValor(sValor) {}
+                const String& name() const { return _sNombre; }
+                const String& value() const { return _sValor; }
+            private:
+                String _sNombre;
+                String _sValor;
+        };
+
+        class AsyncWebServerResponse {
+            public:
+                explicit AsyncWebServerResponse(int nCodigo) : nCodigo(nCodigo) {}
+                void addHeader(const String& sNombre, const String& sValor) { aCabeceras.emplace_back(sNombre, sValor); }
+                void setCode(int n) { nCodigo = n; }
+                int nCodigo;
+                std::vector<AsyncWebHeader> aCabeceras;
+        };
+
+        class AsyncWebServerRequest {
+            public:
+                WebRequestMethodComposite method() const { return _nMetodo; }
+                const String& url() const { return _sUrl; }
+                bool authenticate(const char*, const char*) { return true; }
+                bool authenticate(const String&, const String&) { return true; }
+                void requestAuthentication() { _nCodigo = 401; }
+                bool hasParam(const String& sNombre, bool = false, bool = false) const;
+                const AsyncWebParameter* getParam(const String& sNombre, bool = false, bool = false) const;
+                const AsyncWebHeader* getHeader(const String& sNombre) const;
+                AsyncWebServerResponse* beginResponse(int nCodigo, const String& = String(), const String& = String());
+                AsyncWebServerResponse* beginResponse(fs::FS&, const String&, const String& = String(), bool = false);
+                void send(AsyncWebServerResponse* pRespuesta);
+                void send(int nCodigo, const String& = String(), const String& = String()) { _nCodigo = nCodigo; }
+                void send(fs::FS&, const String&, const String& = String(), bool = false) { _nCodigo = 200; }
+                void redirect(const String&) { _nCodigo = 302; }
+                int Codigo() const { return _nCodigo; }                     //!< Código con el que se ha respondido (pruebas)
+
+                WebRequestMethodComposite _nMetodo = HTTP_GET;
+                String _sUrl;
+                std::vector<AsyncWebParameter> _aParametros;
+                std::vector<AsyncWebHeader> _aCabeceras;
+            private:
+                int _nCodigo = 0;
+                std::unique_ptr<AsyncWebServerResponse> _pRespuesta;
+        };
+
+        typedef std::function<void(AsyncWebServerRequest*)> ArRequestHandlerFunction;
+        typedef std::function<void(AsyncWebServerRequest*, String, size_t, uint8_t*, size_t, bool)> ArUploadHandlerFunction;
+        typedef std::function<void(AsyncWebServerRequest*, uint8_t*, size_t, size_t, size_t)> ArBodyHandlerFunction;
+
+        class AsyncWebHandler {
+            public:
+                virtual ~AsyncWebHandler() {}
+        };
+
+        // ==================== WEBSOCKET ====================
+
+        enum AwsEventType { WS_EVT_CONNECT, WS_EVT_DISCONNECT, WS_EVT_PONG, WS_EVT_ERROR, WS_EVT_DATA };
+        enum AwsFrameType { WS_CONTINUATION, WS_TEXT, WS_BINARY, WS_DISCONNECT = 0x08, WS_PING, WS_PONG };
+
+        typedef struct {
+            uint8_t message_opcode;
+            uint32_t num;
+            uint8_t final;
+            uint8_t masked;
+            uint8_t opcode;
+            uint64_t len;
+            uint8_t mask[4];
+            uint64_t index;
+        } AwsFrameInfo;
+
+        class AsyncWebSocket;
+
+        class AsyncWebSocketClient {
+            public:
+                AsyncWebSocketClient(AsyncWebSocket* pServidor, uint32_t nId) : _pServidor(pServidor), _nId(nId) {}
+                uint32_t id() const { return _nId; }
+                IPAddress remoteIP() const { return IPAddress(192, 168, 1, 100); }
+                AsyncWebSocket* server() { return _pServidor; }
+                bool canSend() const { return true; }
+                void text(const String& s) { aTextos.push_back(s); }
+                void text(const char* s) { aTextos.push_back(String(s)); }
+                void binary(const uint8_t* p, size_t n) { aBinarios.emplace_back((const char*)p, n); }
+                void close() {}
+
+                std::vector<String> aTextos;                                //!< Mensajes de texto recibidos (pruebas)
+                std::vector<std::string> aBinarios;                         //!< Tramas binarias recibidas (pruebas)
+            private:
+                AsyncWebSocket* _pServidor;
+                uint32_t _nId;
+        };
+
+        typedef void (*AwsEventHandler)(AsyncWebSocket*, AsyncWebSocketClient*, AwsEventType, void*, uint8_t*, size_t);
+
+        class AsyncWebSocket : public AsyncWebHandler {
+            public:
+                explicit AsyncWebSocket(const String& sRuta) : _sRuta(sRuta) {}
+                void onEvent(AwsEventHandler pManejador) { _pManejador = pManejador; }
+                void textAll(const String& s) { for (auto& c : _aClientes) c->text(s); }
+                void textAll(const char* s) { textAll(String(s)); }
+                void binaryAll(const uint8_t* p, size_t n) { for (auto& c : _aClientes) c->binary(p, n); }
+                void text(uint32_t nId, const String& s) { AsyncWebSocketClient* c = client(nId); if (c) c->text(s); }
+                AsyncWebSocketClient* client(uint32_t nId);
+                size_t count() const { return _aClientes.size(); }
+                void cleanupClients(uint16_t = 8) {}
+                bool availableForWriteAll() { return true; }
+
+                AsyncWebSocketClient* HostConecta(void);                   //!< Alta de un cliente y WS_EVT_CONNECT
+                void HostDesconecta(AsyncWebSocketClient* pCliente);       //!< WS_EVT_DISCONNECT y baja
+                void HostRecibe(AsyncWebSocketClient* pCliente, const char* sMensaje);   //!< Trama de texto completa como WS_EVT_DATA
+            private:
+                String _sRuta;
+                AwsEventHandler _pManejador = nullptr;
+                uint32_t _nSiguienteId = 1;
+                std::vector<std::unique_ptr<AsyncWebSocketClient>> _aClientes;
+        };
+
+        // ==================== SERVIDOR HTTP ====================
+
+        class AsyncWebServer {
+            public:
+                explicit AsyncWebServer(uint16_t) {}
+                void begin() {}
+                void end() {}
+                void addHandler(AsyncWebHandler*) {}
+                void on(const char*, WebRequestMethodComposite, ArRequestHandlerFunction) {}
+                void on(const char*, WebRequestMethodComposite, ArRequestHandlerFunction, ArUploadHandlerFunction) {}
+                void on(const char*, WebRequestMethodComposite, ArRequestHandlerFunction, ArUploadHandlerFunction, ArBodyHandlerFunction) {}
+                void onNotFound(ArRequestHandlerFunction) {}
+                void serveStatic(const char*, fs::FS&, const char*) {}
+        };
+
+#endif
@@ -0,0 +1,77 @@
+/**
+ * @file FS.h
+ * @brief Sistema de archivos del core ESP32 sobre un directorio del PC
+ *
+ * @details Cada archivo de SPIFFS es un archivo de HostSPIFFS::Raiz(). File es
+ *          un manejador compartido (como en el core) sobre un FILE* de C.
+ *          SPIFFS es plano: "/dir/archivo" se guarda como "dir/archivo".
+ */
+#ifndef FS_H
+	#define FS_H
+
+        #include <Arduino.h>
+        #include <memory>
+
+        namespace fs {
+
+            class File {
+                public:
+                    File() {}
+                    File(const String& sRuta, const char* sModo);           //!< Abre un archivo (sModo "r", "w", "a")
+                    static File Directorio(const String& sRuta);            //!< Manejador para listar la raíz
+
+                    explicit operator bool() const { return (bool)_pEstado; }
+                    size_t write(uint8_t c) { return write(&c, 1); }
+                    size_t write(const uint8_t* pDatos, size_t n);
+                    size_t print(const String& s) { return write((const uint8_t*)s.c_str(), s.length()); }
+                    size_t print(const char* s) { return print(String(s)); }
+                    template <typename T> size_t print(T v) { return print(String(v)); }
+                    size_t println(void) { return print("\n"); }
+                    template <typename T> size_t println(T v) { return print(v) + println(); }
+                    size_t printf(const char* formato, ...) __attribute__((format(printf, 2, 3)));
+                    void flush(void);
+
+                    int read(void);
+                    size_t read(uint8_t* pDatos, size_t n);
+                    size_t readBytes(char* pDatos, size_t n) { return read((uint8_t*)pDatos, n); }
+                    int peek(void);
+                    int available(void);
+                    String readString(void);
+                    String readStringUntil(char cFin);
+                    bool seek(uint32_t nPos);
+                    size_t position(void) const;
+                    size_t size(void) const;
+
+                    const char* name(void) const;
+                    const char* path(void) const;
+                    bool isDirectory(void) const;
+                    File openNextFile(void);
+                    void close(void) { _pEstado.reset(); }
+
+                private:
+                    struct Estado;
+                    std::shared_ptr<Estado> _pEstado;
+            };
+
+            class FS {
+                public:
+                    File open(const String& sRuta, const char* sModo = "r");
+                    bool exists(const String& sRuta);
+                    bool remove(const String& sRuta);
+                    bool rename(const String& sDesde, const String& sHasta);
+            };
+
+        }
+
+        using fs::File;
+
+        namespace HostSPIFFS {
+
+            void Raiz(const char* sDirectorio);                         //!< Directorio que hace de partición (se crea si no existe)
+            const char* Raiz(void);                                     //!< Directorio actual (por defecto "./spiffs")
+            void Vacia(void);                                           //!< Borra todos los archivos de la partición
+            String Ruta(const String& sRuta);                           //!< Ruta del PC para una ruta de SPIFFS
+
+        }
+
+#endif
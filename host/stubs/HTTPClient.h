@@ -0,0 +1,39 @@
+/**
+ * @file HTTPClient.h
+ * @brief Cliente HTTP para la compilación de host/: toda petición falla sin conectar
+ */
+#ifndef HTTPCLIENT_H
+	#define HTTPCLIENT_H
+
+        #include <WiFi.h>
+
+        #define HTTP_CODE_OK 200
+        #define HTTPC_ERROR_CONNECTION_REFUSED (-1)
+
+        enum followRedirects_t { HTTPC_DISABLE_FOLLOW_REDIRECTS, HTTPC_STRICT_FOLLOW_REDIRECTS, HTTPC_FORCE_FOLLOW_REDIRECTS };
+
+        class HTTPClient {
+            public:
+                bool begin(const String&) { return true; }
+                bool begin(WiFiClient&, const String&) { return true; }
+                void end() {}
+                void setTimeout(uint16_t) {}
+                void setConnectTimeout(int32_t) {}
+                void setFollowRedirects(followRedirects_t) {}
+                void setReuse(bool) {}
+                void addHeader(const String&, const String&) {}
+                void setAuthorization(const char*, const char* = nullptr) {}
+                int GET() { return HTTPC_ERROR_CONNECTION_REFUSED; }
+                int POST(const String&) { return HTTPC_ERROR_CONNECTION_REFUSED; }
+                int PUT(const String&) { return HTTPC_ERROR_CONNECTION_REFUSED; }
+                String getString() { return String(); }
+                int getSize() { return -1; }
+                bool connected() { return false; }
+                WiFiClient* getStreamPtr() { return &_cliente; }
+                WiFiClient& getStream() { return _cliente; }
+                static String errorToString(int) { return String("sin red (host)"); }
+            private:
+                WiFiClient _cliente;
+        };
+
+#endif
@@ -0,0 +1,31 @@
+/**
+ * @file HostGPIO.h
+ * @brief Registro de las salidas GPIO en la compilación de host/
+ *
+ * @details digitalWrite() y REG_WRITE(GPIO_OUT_W1TS/W1TC) actualizan el mismo
+ *          estado de 40 pines. Cada cambio de nivel se anota con el instante
+ *          del reloj virtual para que las pruebas cuenten golpes y pulsos.
+ */
+#ifndef HOSTGPIO_H
+	#define HOSTGPIO_H
+
+        #include <stdint.h>
+        #include <vector>
+
+        namespace HostGPIO {
+
+            struct Cambio {
+                uint8_t pin;                            //!< Pin GPIO
+                bool lAlto;                             //!< Nivel tras el cambio
+                uint64_t nMicros;                       //!< Instante del reloj virtual
+            };
+
+            bool Nivel(uint8_t nPin);                   //!< Nivel actual de un pin
+            uint32_t Subidas(uint8_t nPin);             //!< Flancos de subida desde Limpia()
+            const std::vector<Cambio>& Cambios(void);   //!< Cambios de nivel desde Limpia()
+            void Limpia(void);                          //!< Vacía el registro (mantiene los niveles)
+            void FijaEntrada(uint8_t nPin, bool lAlto); //!< Nivel que devuelve digitalRead()
+
+        }
+
+#endif
@@ -0,0 +1,96 @@
+#include <WiFi.h>
+#include <Update.h>
+#include <EEPROM.h>
+#include <Wire.h>
+#include <ESPAsyncWebServer.h>
+
+WiFiClass WiFi;
+UpdateClass Update;
+EEPROMClass EEPROM;
+TwoWire Wire;
+TwoWire Wire1;
+
+// ============================================================================
+// I2C
+// ============================================================================
+
+    namespace HostI2C {
+
+        void Recibe(const std::vector<uint8_t>& aBytes) {
+            Wire._aEntrada = aBytes;
+            Wire._nLeidos = 0;
+            if (Wire._pRecibe) Wire._pRecibe((int)aBytes.size());
+        }
+
+        std::vector<uint8_t> Pide(void) {
+            Wire._aSalida.clear();
+            if (Wire._pPide) Wire._pPide();
+            return Wire._aSalida;
+        }
+
+    }
+
+// ============================================================================
+// PETICIONES HTTP
+// ============================================================================
+
+    bool AsyncWebServerRequest::hasParam(const String& sNombre, bool, bool) const {
+        return getParam(sNombre) != nullptr;
+    }
+
+    const AsyncWebParameter* AsyncWebServerRequest::getParam(const String& sNombre, bool, bool) const {
+        for (const AsyncWebParameter& p : _aParametros) if (p.name() == sNombre) return &p;
+        return nullptr;
+    }
+
+    const AsyncWebHeader* AsyncWebServerRequest::getHeader(const String& sNombre) const {
+        for (const AsyncWebHeader& h : _aCabeceras) if (h.name().equalsIgnoreCase(sNombre)) return &h;
+        return nullptr;
+    }
+
+    AsyncWebServerResponse* AsyncWebServerRequest::beginResponse(int nCodigo, const String&, const String&) {
+        return new AsyncWebServerResponse(nCodigo);
+    }
+
+    AsyncWebServerResponse* AsyncWebServerRequest::beginResponse(fs::FS& sistema, const String& sRuta, const String&, bool) {
+        return new AsyncWebServerResponse(sistema.exists(sRuta) ? 200 : 404);
+    }
+
+    void AsyncWebServerRequest::send(AsyncWebServerResponse* pRespuesta) {
+        _nCodigo = pRespuesta->nCodigo;
+        _pRespuesta.reset(pRespuesta);
+    }
+
+// ============================================================================
+// WEBSOCKET
+// ============================================================================
+
+    AsyncWebSocketClient* AsyncWebSocket::client(uint32_t nId) {
+        for (auto& c : _aClientes) if (c->id() == nId) return c.get();
+        return nullptr;
+    }
+
+    AsyncWebSocketClient* AsyncWebSocket::HostConecta(void) {
+        _aClientes.emplace_back(new AsyncWebSocketClient(this, _nSiguienteId++));
+        AsyncWebSocketClient* pCliente = _aClientes.back().get();
+        if (_pManejador) _pManejador(this, pCliente, WS_EVT_CONNECT, nullptr, nullptr, 0);
+        return pCliente;
+    }
+
+    void AsyncWebSocket::HostDesconecta(AsyncWebSocketClient* pCliente) {
+        if (_pManejador) _pManejador(this, pCliente, WS_EVT_DISCONNECT, nullptr, nullptr, 0);
+        for (auto it = _aClientes.begin(); it != _aClientes.end(); ++it) {
+            if (it->get() == pCliente) { _aClientes.erase(it); return; }
+        }
+    }
+
+    void AsyncWebSocket::HostRecibe(AsyncWebSocketClient* pCliente, const char* sMensaje) {
+        size_t n = strlen(sMensaje);
+        AwsFrameInfo info = {};
+        info.message_opcode = WS_TEXT;
+        info.opcode = WS_TEXT;
+        info.final = 1;
+        info.len = n;
+        std::string sCopia(sMensaje, n);                                    // Sin '\0' garantizado, como en la librería
+        if (_pManejador) _pManejador(this, pCliente, WS_EVT_DATA, &info, (uint8_t*)&sCopia[0], n);
+    }
@@ -0,0 +1,38 @@
+/**
+ * @file RelojVirtual.h
+ * @brief Reloj simulado que mueven las pruebas de host/
+ *
+ * @details Una sola cuenta de microsegundos desde el arranque alimenta
+ *          millis(), micros(), esp_timer_get_time() y, sumada a la hora
+ *          fijada con Fija(), getLocalTime() y las funciones de Reloj.h
+ *          (RELOJ_HOST). delay() avanza el reloj en lugar de esperar.
+ *
+ *          **TEMPORIZADORES:**
+ *          - Avanza() se detiene en cada esp_timer que vence y ejecuta su
+ *            callback con el reloj en ese instante, como la tarea esp_timer
+ *
+ *          **NTP:**
+ *          - Sin Fija() (o con Fija(0)) no hay hora: getLocalTime() devuelve
+ *            false y Reloj::Sincronizado() también
+ *          - configTzTime() aplica la zona POSIX con setenv("TZ") + tzset()
+ */
+#ifndef RELOJVIRTUAL_H
+	#define RELOJVIRTUAL_H
+
+        #include <stdint.h>
+        #include <time.h>
+
+        namespace RelojVirtual {
+
+            void Fija(time_t tEpoch);                   //!< Hora UTC en este instante (0 = sin NTP)
+            time_t Epoch(void);                         //!< Hora UTC actual (0 si no se ha fijado)
+            uint64_t Micros(void);                      //!< Microsegundos desde el arranque
+            void Avanza(uint64_t nMicros);              //!< Adelanta el reloj disparando los esp_timer vencidos
+            void AvanzaHasta(uint64_t nMicros);         //!< Adelanta hasta un instante absoluto (desde el arranque)
+            uint64_t ProximoTemporizador(void);         //!< Instante del próximo esp_timer armado (UINT64_MAX si ninguno)
+            void Zona(const char* sTz);                 //!< Aplica una zona POSIX (p.ej. Config::Time::POSIX_TZ)
+            time_t EpochLocal(int nAno, int nMes, int nDia, int nHora, int nMinuto, int nSegundo = 0);  //!< mktime() con la zona actual
+
+        }
+
+#endif
@@ -0,0 +1,192 @@
+#include "SPIFFS.h"
+#include <cstdarg>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+fs::SPIFFSFS SPIFFS;
+
+static std::string _sRaiz = "./spiffs";
+
+    namespace HostSPIFFS {
+
+        void Raiz(const char* sDirectorio) {
+            _sRaiz = sDirectorio;
+            mkdir(_sRaiz.c_str(), 0755);
+        }
+
+        const char* Raiz(void) {
+            return _sRaiz.c_str();
+        }
+
+        String Ruta(const String& sRuta) {
+            std::string sNombre = sRuta.c_str();
+            while (!sNombre.empty() && sNombre[0] == '/') sNombre.erase(0, 1);
+            return String(_sRaiz + "/" + sNombre);
+        }
+
+        void Vacia(void) {
+            DIR* pDir = opendir(_sRaiz.c_str());
+            if (!pDir) return;
+            while (dirent* pEntrada = readdir(pDir)) {
+                if (pEntrada->d_name[0] == '.') continue;
+                unlink((_sRaiz + "/" + std::string(pEntrada->d_name)).c_str());
+            }
+            closedir(pDir);
+        }
+
+    }
+
+    namespace fs {
+
+        struct File::Estado {
+            FILE* pArchivo = nullptr;
+            std::string sRuta;                                              // Ruta de SPIFFS ("/config.json")
+            std::string sNombre;                                            // Sin la barra inicial, como file.name() del core
+            bool lDirectorio = false;
+            std::vector<std::string> aEntradas;                             // Solo directorios: nombres pendientes de listar
+            ~Estado() { if (pArchivo) fclose(pArchivo); }
+        };
+
+        File::File(const String& sRuta, const char* sModo) {
+            std::string sModoC = (sModo[0] == 'w') ? "wb" : (sModo[0] == 'a') ? "ab" : "rb";
+            FILE* pArchivo = fopen(HostSPIFFS::Ruta(sRuta).c_str(), sModoC.c_str());
+            if (!pArchivo) return;
+            _pEstado = std::make_shared<Estado>();
+            _pEstado->pArchivo = pArchivo;
+            _pEstado->sRuta = sRuta.startsWith("/") ? sRuta.c_str() : ("/" + sRuta).c_str();
+            _pEstado->sNombre = _pEstado->sRuta.substr(1);
+        }
+
+        File File::Directorio(const String& sRuta) {
+            File dir;
+            DIR* pDir = opendir(HostSPIFFS::Raiz());
+            if (!pDir) return dir;
+            dir._pEstado = std::make_shared<Estado>();
+            dir._pEstado->lDirectorio = true;
+            dir._pEstado->sRuta = sRuta.c_str();
+            while (dirent* pEntrada = readdir(pDir)) {
+                if (pEntrada->d_name[0] != '.') dir._pEstado->aEntradas.push_back(pEntrada->d_name);
+            }
+            closedir(pDir);
+            std::sort(dir._pEstado->aEntradas.begin(), dir._pEstado->aEntradas.end());
+            return dir;
+        }
+
+        size_t File::write(const uint8_t* pDatos, size_t n) {
+            if (!_pEstado || !_pEstado->pArchivo) return 0;
+            return fwrite(pDatos, 1, n, _pEstado->pArchivo);
+        }
+
+        size_t File::printf(const char* formato, ...) {
+            va_list args;
+            va_start(args, formato);
+            char* pTexto = nullptr;
+            int n = vasprintf(&pTexto, formato, args);
+            va_end(args);
+            if (n < 0) return 0;
+            size_t nEscritos = write((const uint8_t*)pTexto, (size_t)n);
+            free(pTexto);
+            return nEscritos;
+        }
+
+        void File::flush(void) {
+            if (_pEstado && _pEstado->pArchivo) fflush(_pEstado->pArchivo);
+        }
+
+        int File::read(void) {
+            if (!_pEstado || !_pEstado->pArchivo) return -1;
+            int c = fgetc(_pEstado->pArchivo);
+            return (c == EOF) ? -1 : c;
+        }
+
+        size_t File::read(uint8_t* pDatos, size_t n) {
+            if (!_pEstado || !_pEstado->pArchivo) return 0;
+            return fread(pDatos, 1, n, _pEstado->pArchivo);
+        }
+
+        int File::peek(void) {
+            int c = read();
+            if (c >= 0) ungetc(c, _pEstado->pArchivo);
+            return c;
+        }
+
+        int File::available(void) {
+            if (!_pEstado || !_pEstado->pArchivo) return 0;
+            return (int)(size() - position());
+        }
+
+        String File::readString(void) {
+            String s;
+            int c;
+            while ((c = read()) >= 0) s += (char)c;
+            return s;
+        }
+
+        String File::readStringUntil(char cFin) {
+            String s;
+            int c;
+            while ((c = read()) >= 0 && c != cFin) s += (char)c;
+            return s;
+        }
+
+        bool File::seek(uint32_t nPos) {
+            return _pEstado && _pEstado->pArchivo && fseek(_pEstado->pArchivo, nPos, SEEK_SET) == 0;
+        }
+
+        size_t File::position(void) const {
+            if (!_pEstado || !_pEstado->pArchivo) return 0;
+            return (size_t)ftell(_pEstado->pArchivo);
+        }
+
+        size_t File::size(void) const {
+            if (!_pEstado || !_pEstado->pArchivo) return 0;
+            fflush(_pEstado->pArchivo);
+            struct stat info;
+            if (fstat(fileno(_pEstado->pArchivo), &info) != 0) return 0;
+            return (size_t)info.st_size;
+        }
+
+        const char* File::name(void) const { return _pEstado ? _pEstado->sNombre.c_str() : ""; }
+        const char* File::path(void) const { return _pEstado ? _pEstado->sRuta.c_str() : ""; }
+        bool File::isDirectory(void) const { return _pEstado && _pEstado->lDirectorio; }
+
+        File File::openNextFile(void) {
+            if (!isDirectory() || _pEstado->aEntradas.empty()) return File();
+            std::string sNombre = _pEstado->aEntradas.front();
+            _pEstado->aEntradas.erase(_pEstado->aEntradas.begin());
+            return File(String("/" + sNombre), "r");
+        }
+
+        File FS::open(const String& sRuta, const char* sModo) {
+            if (sRuta == "/" || sRuta.isEmpty()) return File::Directorio("/");
+            return File(sRuta, sModo);
+        }
+
+        bool FS::exists(const String& sRuta) {
+            struct stat info;
+            return stat(HostSPIFFS::Ruta(sRuta).c_str(), &info) == 0;
+        }
+
+        bool FS::remove(const String& sRuta) {
+            return unlink(HostSPIFFS::Ruta(sRuta).c_str()) == 0;
+        }
+
+        bool FS::rename(const String& sDesde, const String& sHasta) {
+            return ::rename(HostSPIFFS::Ruta(sDesde).c_str(), HostSPIFFS::Ruta(sHasta).c_str()) == 0;
+        }
+
+        bool SPIFFSFS::begin(bool, const char*, uint8_t, const char*) {
+            mkdir(HostSPIFFS::Raiz(), 0755);
+            return true;
+        }
+
+        size_t SPIFFSFS::usedBytes(void) {
+            size_t nTotal = 0;
+            File dir = File::Directorio("/");
+            for (File f = dir.openNextFile(); f; f = dir.openNextFile()) nTotal += f.size();
+            return nTotal;
+        }
+
+    }
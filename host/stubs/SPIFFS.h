@@ -0,0 +1,21 @@
+#ifndef SPIFFS_H
+	#define SPIFFS_H
+
+        #include "FS.h"
+
+        namespace fs {
+
+            class SPIFFSFS : public FS {
+                public:
+                    bool begin(bool lFormatear = false, const char* = "/spiffs", uint8_t = 10, const char* = nullptr);
+                    void end(void) {}
+                    bool format(void) { HostSPIFFS::Vacia(); return true; }
+                    size_t totalBytes(void) { return 1441792; }
+                    size_t usedBytes(void);
+            };
+
+        }
+
+        extern fs::SPIFFSFS SPIFFS;
+
+#endif
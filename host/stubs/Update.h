@@ -0,0 +1,22 @@
+#ifndef UPDATE_H
+	#define UPDATE_H
+
+        #include <Arduino.h>
+
+        #define U_FLASH 0
+        #define U_SPIFFS 100
+        #define UPDATE_SIZE_UNKNOWN 0xFFFFFFFF
+
+        class UpdateClass {                                             // Nunca acepta una imagen en el PC
+            public:
+                bool begin(size_t = UPDATE_SIZE_UNKNOWN, int = U_FLASH) { return false; }
+                size_t write(uint8_t*, size_t) { return 0; }
+                bool end(bool = false) { return false; }
+                void abort() {}
+                bool hasError() { return true; }
+                const char* errorString() { return "no disponible en host"; }
+                void printError(HardwareSerial&) {}
+        };
+        extern UpdateClass Update;
+
+#endif
@@ -0,0 +1,57 @@
+/**
+ * @file WiFi.h
+ * @brief WiFi del ESP32 para la compilación de host/: siempre conectado, sin red real
+ */
+#ifndef WIFI_H
+	#define WIFI_H
+
+        #include <Arduino.h>
+
+        #define WL_CONNECTED 3
+        #define WL_DISCONNECTED 6
+        #define WIFI_AP 2
+        #define WIFI_STA 1
+        #define WIFI_AP_STA 3
+
+        class IPAddress {
+            public:
+                IPAddress() : _n{0, 0, 0, 0} {}
+                IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) : _n{a, b, c, d} {}
+                uint8_t operator[](int i) const { return _n[i]; }
+                String toString() const { char buf[16]; snprintf(buf, sizeof(buf), "%u.%u.%u.%u", _n[0], _n[1], _n[2], _n[3]); return String(buf); }
+                bool operator==(const IPAddress& o) const { return memcmp(_n, o._n, 4) == 0; }
+            private:
+                uint8_t _n[4];
+        };
+
+        class WiFiClient {
+            public:
+                virtual ~WiFiClient() {}
+                int available() { return 0; }
+                int read() { return -1; }
+                size_t readBytes(uint8_t*, size_t) { return 0; }
+                size_t readBytes(char*, size_t) { return 0; }
+                size_t write(const uint8_t*, size_t n) { return n; }
+                bool connected() { return false; }
+                void stop() {}
+                void setTimeout(uint32_t) {}
+        };
+
+        class WiFiClass {
+            public:
+                int status() { return lConectado ? WL_CONNECTED : WL_DISCONNECTED; }
+                int begin(const char*, const char* = nullptr) { return status(); }
+                bool config(IPAddress, IPAddress, IPAddress, IPAddress = IPAddress(), IPAddress = IPAddress()) { return true; }
+                bool mode(int) { return true; }
+                bool softAP(const char*, const char* = nullptr) { return true; }
+                IPAddress softAPIP() { return IPAddress(192, 168, 4, 1); }
+                IPAddress localIP() { return IPAddress(192, 168, 1, 50); }
+                IPAddress gatewayIP() { return IPAddress(192, 168, 1, 1); }
+                int RSSI() { return -50; }
+                bool disconnect(bool = false) { return true; }
+                bool reconnect() { return true; }
+                bool lConectado = true;                                 //!< Lo cambian las pruebas para simular caídas
+        };
+        extern WiFiClass WiFi;
+
+#endif
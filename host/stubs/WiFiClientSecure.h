@@ -0,0 +1,12 @@
+#ifndef WIFICLIENTSECURE_H
+	#define WIFICLIENTSECURE_H
+
+        #include <WiFi.h>
+
+        class WiFiClientSecure : public WiFiClient {
+            public:
+                void setInsecure() {}
+                void setCACert(const char*) {}
+        };
+
+#endif
@@ -0,0 +1,44 @@
+/**
+ * @file Wire.h
+ * @brief I2C esclavo para la compilación de host/
+ *
+ * @details Las pruebas entregan bytes con HostI2C::Recibe() (dispara onReceive)
+ *          y leen la respuesta con HostI2C::Pide() (dispara onRequest y
+ *          devuelve lo escrito con write()).
+ */
+#ifndef WIRE_H
+	#define WIRE_H
+
+        #include <Arduino.h>
+        #include <vector>
+
+        class TwoWire {
+            public:
+                bool begin(uint8_t) { return true; }
+                bool begin(int = -1, int = -1, uint32_t = 0) { return true; }
+                void onReceive(void (*pFuncion)(int)) { _pRecibe = pFuncion; }
+                void onRequest(void (*pFuncion)(void)) { _pPide = pFuncion; }
+                int available() { return (int)(_aEntrada.size() - _nLeidos); }
+                int read() { return _nLeidos < _aEntrada.size() ? _aEntrada[_nLeidos++] : -1; }
+                size_t write(uint8_t c) { _aSalida.push_back(c); return 1; }
+                size_t write(const uint8_t* p, size_t n) { _aSalida.insert(_aSalida.end(), p, p + n); return n; }
+                void beginTransmission(uint8_t) {}
+                uint8_t endTransmission(bool = true) { return 0; }     // Los expansores de relés siempre responden
+                uint8_t requestFrom(uint8_t, uint8_t) { return 0; }
+                void setClock(uint32_t) {}
+
+                void (*_pRecibe)(int) = nullptr;
+                void (*_pPide)(void) = nullptr;
+                std::vector<uint8_t> _aEntrada;
+                size_t _nLeidos = 0;
+                std::vector<uint8_t> _aSalida;
+        };
+        extern TwoWire Wire;
+        extern TwoWire Wire1;
+
+        namespace HostI2C {
+            void Recibe(const std::vector<uint8_t>& aBytes);                    //!< El maestro escribe aBytes
+            std::vector<uint8_t> Pide(void);                                    //!< El maestro lee; devuelve lo que escribió onRequest
+        }
+
+#endif
@@ -0,0 +1,8 @@
+#ifndef ESP_ROM_CRC_H
+	#define ESP_ROM_CRC_H
+
+        #include <stdint.h>
+
+        uint32_t esp_rom_crc32_le(uint32_t nCrc, const uint8_t* pDatos, uint32_t nLongitud);  //!< CRC-32 IEEE como la ROM del ESP32
+
+#endif
@@ -0,0 +1,38 @@
+/**
+ * @file esp_timer.h
+ * @brief esp_timer sobre el reloj virtual de host/
+ *
+ * @details esp_timer_get_time() devuelve los microsegundos del reloj virtual.
+ *          Los temporizadores one-shot se disparan dentro de RelojVirtual::Avanza()
+ *          en el instante exacto en que vencen, como la tarea esp_timer.
+ */
+#ifndef ESP_TIMER_H
+	#define ESP_TIMER_H
+
+        #include <stdint.h>
+
+        typedef int esp_err_t;
+        #define ESP_OK 0
+        #define ESP_FAIL -1
+        #define ESP_ERR_INVALID_STATE 0x103
+
+        typedef struct esp_timer* esp_timer_handle_t;
+        typedef void (*esp_timer_cb_t)(void* arg);
+        typedef enum { ESP_TIMER_TASK, ESP_TIMER_ISR } esp_timer_dispatch_t;
+
+        typedef struct {
+            esp_timer_cb_t callback;
+            void* arg;
+            esp_timer_dispatch_t dispatch_method;
+            const char* name;
+            bool skip_unhandled_events;
+        } esp_timer_create_args_t;
+
+        int64_t esp_timer_get_time(void);
+        esp_err_t esp_timer_create(const esp_timer_create_args_t* args, esp_timer_handle_t* pHandle);
+        esp_err_t esp_timer_start_once(esp_timer_handle_t handle, uint64_t nTimeoutUs);
+        esp_err_t esp_timer_stop(esp_timer_handle_t handle);
+        esp_err_t esp_timer_delete(esp_timer_handle_t handle);
+        bool esp_timer_is_active(esp_timer_handle_t handle);
+
+#endif
@@ -0,0 +1,47 @@
+/**
+ * @file FreeRTOS.h
+ * @brief FreeRTOS mínimo para la compilación de host/
+ *
+ * @details El campanario se prueba en un único hilo: las secciones críticas y
+ *          los semáforos no hacen nada y no se crean tareas. Los callbacks de
+ *          esp_timer los ejecuta RelojVirtual::Avanza() entre vueltas de loop().
+ */
+#ifndef FREERTOS_H
+	#define FREERTOS_H
+
+        #include <stdint.h>
+
+        typedef int BaseType_t;
+        typedef unsigned int UBaseType_t;
+        typedef uint32_t TickType_t;
+        typedef void* TaskHandle_t;
+        typedef void* SemaphoreHandle_t;
+        typedef void* QueueHandle_t;
+        typedef void (*TaskFunction_t)(void*);
+
+        #define pdTRUE 1
+        #define pdFALSE 0
+        #define pdPASS 1
+        #define pdFAIL 0
+        #define portMAX_DELAY 0xFFFFFFFFUL
+        #define portTICK_PERIOD_MS 1
+        #define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
+
+        typedef struct { int nAnidado; } portMUX_TYPE;
+        #define portMUX_INITIALIZER_UNLOCKED { 0 }
+        #define portENTER_CRITICAL(mux) ((void)(mux))
+        #define portEXIT_CRITICAL(mux) ((void)(mux))
+        #define portENTER_CRITICAL_ISR(mux) ((void)(mux))
+        #define portEXIT_CRITICAL_ISR(mux) ((void)(mux))
+
+        inline SemaphoreHandle_t xSemaphoreCreateMutex(void) { static int nMutex; return &nMutex; }
+        inline BaseType_t xSemaphoreTake(SemaphoreHandle_t, TickType_t) { return pdTRUE; }
+        inline BaseType_t xSemaphoreGive(SemaphoreHandle_t) { return pdTRUE; }
+
+        inline BaseType_t xTaskCreatePinnedToCore(TaskFunction_t, const char*, uint32_t, void*, UBaseType_t, TaskHandle_t*, BaseType_t) { return pdFAIL; }
+        inline BaseType_t xTaskCreate(TaskFunction_t, const char*, uint32_t, void*, UBaseType_t, TaskHandle_t*) { return pdFAIL; }
+        void vTaskDelay(TickType_t nTicks);
+        inline void vTaskDelete(TaskHandle_t) {}
+        TickType_t xTaskGetTickCount(void);
+
+#endif
@@ -0,0 +1,6 @@
+#ifndef SEMPHR_H
+	#define SEMPHR_H
+
+        #include "FreeRTOS.h"
+
+#endif
@@ -0,0 +1,18 @@
+/**
+ * @file gpio_reg.h
+ * @brief Registros de salida GPIO del ESP32 sobre HostGPIO
+ */
+#ifndef GPIO_REG_H
+	#define GPIO_REG_H
+
+        #include <stdint.h>
+
+        #define GPIO_OUT_W1TS_REG  0x3FF44008
+        #define GPIO_OUT_W1TC_REG  0x3FF4400C
+        #define GPIO_OUT1_W1TS_REG 0x3FF44014
+        #define GPIO_OUT1_W1TC_REG 0x3FF44018
+
+        void HostEscribeRegistro(uint32_t nRegistro, uint32_t nValor);         //!< Aplica un W1TS/W1TC en HostGPIO
+        #define REG_WRITE(reg, valor) HostEscribeRegistro((reg), (valor))
+
+#endif